@@ -0,0 +1,22 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Commandlets/Commandlet.h"
+#include "JsonReaderBenchmarkCommandlet.generated.h"
+
+/**
+ * Parses the same Json with TJsonReader, FJsonUtf8Reader and FJsonArenaDocument and reports the throughput and number of
+ * allocations of each.
+ */
+UCLASS()
+class UJsonReaderBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
@@ -0,0 +1,22 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Commandlets/Commandlet.h"
+#include "JsonWriterBenchmarkCommandlet.generated.h"
+
+/**
+ * Writes the same structs to Json with FJsonObjectConverter::UStructToJsonObjectString and UStructToJsonUtf8 and reports
+ * the throughput and number of allocations of each.
+ */
+UCLASS()
+class UJsonWriterBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
@@ -0,0 +1,252 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	JsonReaderBenchmarkCommandlet.cpp: Commandlet used for comparing the
+	speed and allocations of the Json readers.
+=============================================================================*/
+
+#include "Commandlets/JsonReaderBenchmarkCommandlet.h"
+#include "Dom/JsonArenaDocument.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "MallocCountingProxy.h"
+#include "Misc/Parse.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonUtf8Reader.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogJsonReaderBenchmark, Log, All);
+
+/**
+ * UJsonReaderBenchmarkCommandlet
+ *
+ * Usage:
+ *	JsonReaderBenchmark [-File=<UTF-8 Json file>]
+ *
+ * Optional parameters:
+ *	-MB=N: Size of the Json made up when no file is given (default 16)
+ *	-Runs=N: Number of times each reader parses the Json, the fastest run is reported (default 5)
+ *
+ * TJsonReader reads the Json converted to an FString up front, the conversion isn't timed. Allocations are counted by
+ * putting a counting proxy in front of GMalloc while a reader runs, which also counts allocations other threads make
+ * at the same time, and isn't possible on platforms with a fixed GMalloc class.
+ */
+
+UJsonReaderBenchmarkCommandlet::UJsonReaderBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+namespace JsonReaderBenchmark
+{
+	/** Result of one reader over the Json, Values is checked against the other readers */
+	struct FResult
+	{
+		double Seconds;
+		int64 NumAllocations;
+		int32 Values;
+	};
+
+	/** Counts the values in a Json value the way the pull readers count notations */
+	static int32 CountValues(const TSharedPtr<FJsonValue>& Value)
+	{
+		int32 Values = 1;
+		if (Value->Type == EJson::Object)
+		{
+			for (const TPair<FString, TSharedPtr<FJsonValue>>& Member : Value->AsObject()->Values)
+			{
+				Values += CountValues(Member.Value);
+			}
+		}
+		else if (Value->Type == EJson::Array)
+		{
+			for (const TSharedPtr<FJsonValue>& Element : Value->AsArray())
+			{
+				Values += CountValues(Element);
+			}
+		}
+		return Values;
+	}
+
+	static int32 CountValues(const FJsonArenaValue& Value)
+	{
+		int32 Values = 1;
+		for (FJsonArenaValue Child = Value.GetFirstChild(); Child.IsValid(); Child = Child.GetNextSibling())
+		{
+			Values += CountValues(Child);
+		}
+		return Values;
+	}
+
+	/** Reads every value with a pull reader and returns how many there were, or -1 on error */
+	template<typename ReaderType>
+	static int32 PullAll(ReaderType& Reader)
+	{
+		int32 Values = 0;
+		EJsonNotation Notation;
+		while (Reader.ReadNext(Notation))
+		{
+			if (Notation == EJsonNotation::Error)
+			{
+				return -1;
+			}
+			if (Notation != EJsonNotation::ObjectEnd && Notation != EJsonNotation::ArrayEnd)
+			{
+				++Values;
+			}
+		}
+		return Values;
+	}
+
+	/** Runs Parse Runs times, returns the fastest run and how many allocations it made */
+	static FResult Measure(int32 Runs, TFunctionRef<int32()> Parse)
+	{
+		FResult Best = { MAX_dbl, 0, 0 };
+		for (int32 Run = 0; Run < Runs; ++Run)
+		{
+#if !PLATFORM_USES_FIXED_GMalloc_CLASS
+			FMallocCountingProxy CountingMalloc(GMalloc);
+			GMalloc = &CountingMalloc;
+#endif
+
+			const double StartTime = FPlatformTime::Seconds();
+			const int32 Values = Parse();
+			const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+#if !PLATFORM_USES_FIXED_GMalloc_CLASS
+			GMalloc = CountingMalloc.UsedMalloc;
+			const int64 NumAllocations = CountingMalloc.NumAllocations;
+#else
+			const int64 NumAllocations = -1;
+#endif
+
+			if (Seconds < Best.Seconds)
+			{
+				Best = { Seconds, NumAllocations, Values };
+			}
+		}
+		return Best;
+	}
+
+	/** Makes up Json of about Size bytes with a mix of objects, arrays, strings, escapes, numbers and literals */
+	static FString MakeJson(int64 Size)
+	{
+		FString Json = TEXT("[");
+		for (int32 Index = 0; Json.Len() < Size; ++Index)
+		{
+			Json += FString::Printf(
+				TEXT("%s\n\t{\"Id\": %d, \"Name\": \"Item_%d\", \"Path\": \"/Game/Items/Item_%d.Item_%d\", \"Description\": \"Line one\\nLine \\\"two\\\" \\u00e9\",")
+				TEXT(" \"Position\": [%d.25, -%d.5, 1.5e3], \"Tags\": [\"a\", \"b\", \"c\"], \"Enabled\": %s, \"Parent\": null, \"Stats\": {\"Health\": %d, \"Speed\": 0.%d}}"),
+				Index ? TEXT(",") : TEXT(""), Index, Index, Index, Index, Index, Index, (Index & 1) ? TEXT("true") : TEXT("false"), Index % 100, Index % 1000);
+		}
+		Json += TEXT("\n]");
+		return Json;
+	}
+}
+
+int32 UJsonReaderBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace JsonReaderBenchmark;
+
+	const TCHAR* ParamStr = *Params;
+
+	FString Filename;
+	int32 MegaBytes = 16;
+	int32 Runs = 5;
+	FParse::Value(ParamStr, TEXT("File="), Filename);
+	FParse::Value(ParamStr, TEXT("MB="), MegaBytes);
+	FParse::Value(ParamStr, TEXT("Runs="), Runs);
+	Runs = FMath::Max(Runs, 1);
+
+	TArray<uint8> Utf8;
+	FString Json;
+	if (!Filename.IsEmpty())
+	{
+		if (!FFileHelper::LoadFileToArray(Utf8, *Filename))
+		{
+			UE_LOG(LogJsonReaderBenchmark, Error, TEXT("Usage: JsonReaderBenchmark [-File=<UTF-8 Json file>] [-MB=N] [-Runs=N]"));
+			return 1;
+		}
+		FFileHelper::BufferToString(Json, Utf8.GetData(), Utf8.Num());
+	}
+	else
+	{
+		Json = MakeJson((int64)FMath::Max(MegaBytes, 1) * 1024 * 1024);
+		FTCHARToUTF8 Converted(*Json);
+		Utf8.Append((const uint8*)Converted.Get(), Converted.Length());
+	}
+
+	const double InputMegaBytes = Utf8.Num() / (1024.0 * 1024.0);
+	UE_LOG(LogJsonReaderBenchmark, Display, TEXT("%s: %.2f MB, %d runs"), Filename.IsEmpty() ? TEXT("Generated Json") : *Filename, InputMegaBytes, Runs);
+
+	struct FReader
+	{
+		const TCHAR* Name;
+		TFunction<int32()> Parse;
+	};
+	TArray<FReader> Readers;
+
+	Readers.Add({ TEXT("TJsonReader DOM"), [&Json]()
+	{
+		TSharedPtr<FJsonValue> Root;
+		return FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Root) ? CountValues(Root) : -1;
+	}});
+
+	Readers.Add({ TEXT("TJsonReader pull"), [&Json]()
+	{
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+		return PullAll(Reader.Get());
+	}});
+
+	Readers.Add({ TEXT("FJsonUtf8Reader DOM"), [&Utf8]()
+	{
+		FJsonUtf8Reader Reader(Utf8);
+		EJsonNotation Notation;
+		if (!Reader.ReadNext(Notation))
+		{
+			return -1;
+		}
+		TSharedPtr<FJsonValue> Root = Reader.ReadValueAsJsonValue(Notation);
+		return Root.IsValid() && !Reader.ReadNext(Notation) ? CountValues(Root) : -1;
+	}});
+
+	Readers.Add({ TEXT("FJsonUtf8Reader pull"), [&Utf8]()
+	{
+		FJsonUtf8Reader Reader(Utf8);
+		return PullAll(Reader);
+	}});
+
+	Readers.Add({ TEXT("FJsonArenaDocument"), [&Utf8]()
+	{
+		FJsonArenaDocument Document;
+		return Document.Parse(Utf8) ? CountValues(Document.GetRoot()) : -1;
+	}});
+
+	int32 ExpectedValues = INDEX_NONE;
+	double BaselineSeconds = 0.0;
+	bool bAllMatched = true;
+	for (const FReader& Reader : Readers)
+	{
+		const FResult Result = Measure(Runs, Reader.Parse);
+		if (ExpectedValues == INDEX_NONE)
+		{
+			ExpectedValues = Result.Values;
+			BaselineSeconds = Result.Seconds;
+		}
+
+		UE_LOG(LogJsonReaderBenchmark, Display, TEXT("%-22s %8.3f ms %8.1f MB/s %6.2fx %10lld allocations %9d values"),
+			Reader.Name, Result.Seconds * 1000.0, InputMegaBytes / FMath::Max(Result.Seconds, SMALL_NUMBER), BaselineSeconds / FMath::Max(Result.Seconds, SMALL_NUMBER), Result.NumAllocations, Result.Values);
+
+		if (Result.Values != ExpectedValues || Result.Values < 0)
+		{
+			UE_LOG(LogJsonReaderBenchmark, Error, TEXT("%s read %d values instead of %d"), Reader.Name, Result.Values, ExpectedValues);
+			bAllMatched = false;
+		}
+	}
+
+	return bAllMatched ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	JsonWriterBenchmarkCommandlet.cpp: Commandlet used for comparing the
+	speed and allocations of the ways structs are written to Json.
+=============================================================================*/
+
+#include "Commandlets/JsonWriterBenchmarkCommandlet.h"
+#include "HAL/PlatformTime.h"
+#include "JsonObjectConverter.h"
+#include "MallocCountingProxy.h"
+#include "Misc/Parse.h"
+#include "Serialization/JsonUtf8Reader.h"
+#include "UObject/TextProperty.h"
+#include "UObject/UnrealType.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogJsonWriterBenchmark, Log, All);
+
+/**
+ * UJsonWriterBenchmarkCommandlet
+ *
+ * Usage:
+ *	JsonWriterBenchmark [-Struct=<native struct name>]
+ *
+ * Optional parameters:
+ *	-Struct=Name: Struct written to Json (default HitResult)
+ *	-Count=N: Number of structs written in each run (default 10000)
+ *	-Runs=N: Number of times the structs are written, the fastest run is reported (default 5)
+ *
+ * The members of the struct are set to made up values first, so strings and names aren't all empty. The converter
+ * writes an FString that is converted to UTF-8 in the timed part, since UTF-8 is what's sent or saved in the end.
+ * Allocations are counted by putting a counting proxy in front of GMalloc while the structs are written.
+ */
+
+UJsonWriterBenchmarkCommandlet::UJsonWriterBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+namespace JsonWriterBenchmark
+{
+	struct FResult
+	{
+		double Seconds;
+		int64 NumAllocations;
+	};
+
+	/** Runs Write Runs times, returns the fastest run and how many allocations it made */
+	static FResult Measure(int32 Runs, TFunctionRef<void()> Write)
+	{
+		FResult Best = { MAX_dbl, 0 };
+		for (int32 Run = 0; Run < Runs; ++Run)
+		{
+#if !PLATFORM_USES_FIXED_GMalloc_CLASS
+			FMallocCountingProxy CountingMalloc(GMalloc);
+			GMalloc = &CountingMalloc;
+#endif
+
+			const double StartTime = FPlatformTime::Seconds();
+			Write();
+			const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+#if !PLATFORM_USES_FIXED_GMalloc_CLASS
+			GMalloc = CountingMalloc.UsedMalloc;
+			const int64 NumAllocations = CountingMalloc.NumAllocations;
+#else
+			const int64 NumAllocations = -1;
+#endif
+
+			if (Seconds < Best.Seconds)
+			{
+				Best = { Seconds, NumAllocations };
+			}
+		}
+		return Best;
+	}
+
+	/** Sets the numbers, strings and names directly in the struct to made up values */
+	static void FillStruct(const UScriptStruct* Struct, void* Data)
+	{
+		int32 Index = 0;
+		for (TFieldIterator<UProperty> It(Struct); It; ++It, ++Index)
+		{
+			UProperty* Property = *It;
+			void* Value = Property->ContainerPtrToValuePtr<void>(Data);
+			if (UNumericProperty* NumericProperty = Cast<UNumericProperty>(Property))
+			{
+				if (NumericProperty->IsFloatingPoint())
+				{
+					NumericProperty->SetFloatingPointPropertyValue(Value, Index * 1.25 + 0.1);
+				}
+				else if (!NumericProperty->IsEnum())
+				{
+					NumericProperty->SetIntPropertyValue(Value, (int64)Index * 37);
+				}
+			}
+			else if (UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
+			{
+				BoolProperty->SetPropertyValue(Value, (Index & 1) != 0);
+			}
+			else if (UStrProperty* StrProperty = Cast<UStrProperty>(Property))
+			{
+				StrProperty->SetPropertyValue(Value, FString::Printf(TEXT("Value \"%d\"\n\u00e9"), Index));
+			}
+			else if (UNameProperty* NameProperty = Cast<UNameProperty>(Property))
+			{
+				NameProperty->SetPropertyValue(Value, FName(TEXT("Name"), Index));
+			}
+			else if (UTextProperty* TextProperty = Cast<UTextProperty>(Property))
+			{
+				TextProperty->SetPropertyValue(Value, FText::AsCultureInvariant(FString::Printf(TEXT("Text %d"), Index)));
+			}
+		}
+	}
+}
+
+int32 UJsonWriterBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace JsonWriterBenchmark;
+
+	const TCHAR* ParamStr = *Params;
+
+	FString StructName = TEXT("HitResult");
+	int32 Count = 10000;
+	int32 Runs = 5;
+	FParse::Value(ParamStr, TEXT("Struct="), StructName);
+	FParse::Value(ParamStr, TEXT("Count="), Count);
+	FParse::Value(ParamStr, TEXT("Runs="), Runs);
+	Count = FMath::Max(Count, 1);
+	Runs = FMath::Max(Runs, 1);
+
+	UScriptStruct* Struct = FindObject<UScriptStruct>(ANY_PACKAGE, *StructName);
+	if (!Struct)
+	{
+		UE_LOG(LogJsonWriterBenchmark, Error, TEXT("Usage: JsonWriterBenchmark [-Struct=<native struct name>] [-Count=N] [-Runs=N]"));
+		return 1;
+	}
+
+	TArray<uint8, TAlignedHeapAllocator<16>> StructData;
+	StructData.AddZeroed(FMath::Max(Struct->GetStructureSize(), 1));
+	Struct->InitializeStruct(StructData.GetData());
+	FillStruct(Struct, StructData.GetData());
+
+	// Written once before timing so both start from warm caches, and the plan of the struct is made
+	FString ExpectedString;
+	FJsonObjectConverter::UStructToJsonObjectString(Struct, StructData.GetData(), ExpectedString, 0, 0, 0, nullptr, false);
+	FTCHARToUTF8 Expected(*ExpectedString);
+
+	TArray<uint8> Utf8;
+	if (!FJsonObjectConverter::UStructToJsonUtf8(Struct, StructData.GetData(), Utf8))
+	{
+		UE_LOG(LogJsonWriterBenchmark, Error, TEXT("UStructToJsonUtf8 failed to write %s"), *Struct->GetName());
+		Struct->DestroyStruct(StructData.GetData());
+		return 1;
+	}
+
+	const bool bMatched = Utf8.Num() == Expected.Length() && FMemory::Memcmp(Utf8.GetData(), Expected.Get(), Utf8.Num()) == 0;
+	if (!bMatched)
+	{
+		UE_LOG(LogJsonWriterBenchmark, Error, TEXT("UStructToJsonUtf8 wrote different Json than UStructToJsonObjectString:\n%s\n%s"), *FJsonUtf8Reader::Utf8ToString(FAnsiStringView((const ANSICHAR*)Utf8.GetData(), Utf8.Num())), *ExpectedString);
+	}
+
+	const double MegaBytes = (double)Expected.Length() * Count / (1024.0 * 1024.0);
+	UE_LOG(LogJsonWriterBenchmark, Display, TEXT("%s: %d bytes of Json, %d structs, %d runs"), *Struct->GetName(), Expected.Length(), Count, Runs);
+
+	const FResult Converter = Measure(Runs, [Struct, &StructData, Count]()
+	{
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			FString JsonString;
+			FJsonObjectConverter::UStructToJsonObjectString(Struct, StructData.GetData(), JsonString, 0, 0, 0, nullptr, false);
+			FTCHARToUTF8 Converted(*JsonString);
+		}
+	});
+
+	const FResult Writer = Measure(Runs, [Struct, &StructData, &Utf8, Count]()
+	{
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Utf8.Reset();
+			FJsonObjectConverter::UStructToJsonUtf8(Struct, StructData.GetData(), Utf8);
+		}
+	});
+
+	const TPair<const TCHAR*, FResult> Results[] =
+	{
+		{ TEXT("UStructToJsonObjectString"), Converter },
+		{ TEXT("UStructToJsonUtf8"), Writer },
+	};
+	for (const TPair<const TCHAR*, FResult>& Result : Results)
+	{
+		const double Seconds = FMath::Max(Result.Value.Seconds, SMALL_NUMBER);
+		UE_LOG(LogJsonWriterBenchmark, Display, TEXT("%-26s %8.3f ms %8.1f MB/s %10.0f structs/s %6.2fx %10lld allocations"),
+			Result.Key, Seconds * 1000.0, MegaBytes / Seconds, Count / Seconds, Converter.Seconds / Seconds, Result.Value.NumAllocations);
+	}
+
+	Struct->DestroyStruct(StructData.GetData());
+	return bMatched ? 0 : 1;
+}
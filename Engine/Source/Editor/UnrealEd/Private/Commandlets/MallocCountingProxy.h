@@ -0,0 +1,64 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+#include "Templates/Atomic.h"
+
+/**
+ * Counts the allocations made through the malloc it forwards to. The benchmark commandlets put one in front of GMalloc
+ * while the code they measure runs, which isn't possible on platforms with a fixed GMalloc class.
+ */
+class FMallocCountingProxy : public FMalloc
+{
+public:
+	explicit FMallocCountingProxy(FMalloc* InMalloc)
+		: UsedMalloc(InMalloc)
+		, NumAllocations(0)
+	{
+	}
+
+	virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+	{
+		++NumAllocations;
+		return UsedMalloc->Malloc(Size, Alignment);
+	}
+
+	virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		if (NewSize > 0)
+		{
+			++NumAllocations;
+		}
+		return UsedMalloc->Realloc(Ptr, NewSize, Alignment);
+	}
+
+	virtual void Free(void* Ptr) override
+	{
+		UsedMalloc->Free(Ptr);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return UsedMalloc->QuantizeSize(Count, Alignment);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return UsedMalloc->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return UsedMalloc->IsInternallyThreadSafe();
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return UsedMalloc->GetDescriptiveName();
+	}
+
+	FMalloc* UsedMalloc;
+	TAtomic<int64> NumAllocations;
+};
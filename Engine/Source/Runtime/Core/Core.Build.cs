@@ -144,6 +144,18 @@ public class Core : ModuleRules
         }
         PublicDefinitions.Add("UE_ENABLE_ICU=" + (Target.bCompileICU ? "1" : "0")); // Enable/disable (=1/=0) ICU usage in the codebase. NOTE: This flag is for use while integrating ICU and will be removed afterward.
 
+		// Zstd and LZ4 are built into FCompression on desktop platforms, elsewhere NAME_Zstd and NAME_LZ4 are looked up as ICompressionFormat plugins like any other format
+		bool bCompileZstdAndLZ4 = Target.Platform == UnrealTargetPlatform.Win64 || Target.Platform == UnrealTargetPlatform.Mac || Target.IsInPlatformGroup(UnrealPlatformGroup.Unix);
+		if (bCompileZstdAndLZ4)
+		{
+			AddEngineThirdPartyPrivateStaticDependencies(Target,
+				"zstd",
+				"LZ4"
+				);
+		}
+		PublicDefinitions.Add("WITH_ZSTD=" + (bCompileZstdAndLZ4 ? "1" : "0"));
+		PublicDefinitions.Add("WITH_LZ4=" + (bCompileZstdAndLZ4 ? "1" : "0"));
+
         // If we're compiling with the engine, then add Core's engine dependencies
 		if (Target.bCompileAgainstEngine == true)
 		{
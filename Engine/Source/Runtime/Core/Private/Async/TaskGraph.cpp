@@ -17,12 +17,15 @@
 #include "Misc/NoopCounter.h"
 #include "Misc/ScopeLock.h"
 #include "Containers/LockFreeList.h"
+#include "Containers/WorkStealingQueue.h"
 #include "Templates/Function.h"
 #include "Stats/Stats.h"
 #include "Misc/CoreStats.h"
 #include "Math/RandomStream.h"
 #include "HAL/IConsoleManager.h"
 #include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 #include "Containers/LockFreeFixedSizeAllocator.h"
 #include "Async/TaskGraphInterfaces.h"
 #include "HAL/LowLevelMemTracker.h"
@@ -76,6 +79,15 @@ static FAutoConsoleVariableRef CVarEnablePowerSavingThreadPriorityReduction(
 	TEXT("If 1, then high pri thread tasks which are marked EPowerSavingEligibility::Eligible can be dropped to normal priority.")
 );
 
+static int32 GTaskGraphUseWorkStealing = 0;
+static FAutoConsoleVariableRef CVarTaskGraphUseWorkStealing(
+	TEXT("TaskGraph.UseWorkStealing"),
+	GTaskGraphUseWorkStealing,
+	TEXT("If 1, worker threads keep per-thread work stealing deques for tasks they spawn and steal from each other when idle, instead of only sharing the per-priority queues.\n")
+	TEXT("Only read when the task graph starts up, can also be enabled with -TaskGraphWorkStealing or disabled with -NoTaskGraphWorkStealing."),
+	ECVF_ReadOnly
+);
+
 #if CREATE_HIPRI_TASK_THREADS || CREATE_BACKGROUND_TASK_THREADS
 	static void ThreadSwitchForABTest(const TArray<FString>& Args)
 	{
@@ -840,6 +852,7 @@ class FTaskThreadAnyThread : public FTaskThreadBase
 public:
 	FTaskThreadAnyThread(int32 InPriorityIndex)
 		: PriorityIndex(InPriorityIndex)
+		, StealRandomState(0)
 	{
 	}
 	virtual void ProcessTasksUntilQuit(int32 QueueIndex) override
@@ -915,6 +928,65 @@ public:
 		return !!Queue.RecursionGuard;
 	}
 
+	// Work stealing API, only used when TaskGraph.UseWorkStealing is enabled.
+
+	/**
+	*	Queue a task into this thread's local deque. Must be called from this thread.
+	*	@param Task; Task to queue.
+	*	@return false if the local deque is full and the task must go to the shared queue instead.
+	**/
+	FORCEINLINE bool EnqueueLocal(FBaseGraphTask* Task)
+	{
+		if (LocalQueue.Push(Task))
+		{
+			++WorkStealingStats.LocalPushes;
+			return true;
+		}
+		return false;
+	}
+
+	/** Pops the most recently queued local task. Must be called from this thread. **/
+	FORCEINLINE FBaseGraphTask* PopLocal()
+	{
+		FBaseGraphTask* Task = LocalQueue.Pop();
+		if (Task)
+		{
+			++WorkStealingStats.LocalPops;
+		}
+		return Task;
+	}
+
+	/** Steals the oldest task from this thread's local deque. May be called from any thread. **/
+	FORCEINLINE FBaseGraphTask* StealLocal()
+	{
+		return LocalQueue.Steal();
+	}
+
+	/** Returns a pseudo random number used to pick steal victims. Must be called from this thread. **/
+	FORCEINLINE uint32 NextStealRandom()
+	{
+		// xorshift32, seeded lazily so that each thread gets a different sequence
+		uint32 X = StealRandomState ? StealRandomState : (uint32(ThreadId) * 2654435761u) | 1u;
+		X ^= X << 13;
+		X ^= X >> 17;
+		X ^= X << 5;
+		StealRandomState = X;
+		return X;
+	}
+
+	/** Counters for the work stealing backend, only written by this thread. **/
+	struct FWorkStealingStats
+	{
+		uint64 LocalPushes = 0;
+		uint64 LocalPops = 0;
+		uint64 SharedPops = 0;
+		uint64 Steals = 0;
+		uint64 FailedStealPasses = 0;
+		uint64 Stalls = 0;
+	};
+
+	FWorkStealingStats WorkStealingStats;
+
 #if UE_EXTERNAL_PROFILING_ENABLED
 	virtual uint32 Run() override
 	{
@@ -999,6 +1071,7 @@ private:
 				if (FPlatformProcess::SupportsMultithreading())
 				{
 					FScopeCycleCounter Scope(StallStatId);
+					++WorkStealingStats.Stalls;
 					Queue.StallRestartEvent->Wait(MAX_uint32, bCountAsStall);
 					bDidStall = true;
 				}
@@ -1090,6 +1163,12 @@ private:
 	FThreadTaskQueue Queue;
 
 	int32 PriorityIndex;
+
+	/** Tasks spawned by this thread when work stealing is enabled. Popped LIFO by this thread, stolen FIFO by others. **/
+	TWorkStealingQueue<FBaseGraphTask> LocalQueue;
+
+	/** State for picking steal victims. **/
+	uint32 StealRandomState;
 };
 
 
@@ -1170,6 +1249,22 @@ public:
 		
 		NumNamedThreads = LastExternalThread + 1;
 
+		bUseWorkStealing = !!GTaskGraphUseWorkStealing;
+		if (FParse::Param(FCommandLine::Get(), TEXT("TaskGraphWorkStealing")))
+		{
+			bUseWorkStealing = true;
+		}
+		else if (FParse::Param(FCommandLine::Get(), TEXT("NoTaskGraphWorkStealing")))
+		{
+			bUseWorkStealing = false;
+		}
+		bUseWorkStealing = bUseWorkStealing && FPlatformProcess::SupportsMultithreading();
+		GTaskGraphUseWorkStealing = bUseWorkStealing;
+		for (int32 Priority = 0; Priority < MAX_THREAD_PRIORITIES; Priority++)
+		{
+			IdleThreadMask[Priority].Store(0, EMemoryOrder::Relaxed);
+		}
+
 		NumTaskThreadSets = 1 + bCreatedHiPriorityThreads + bCreatedBackgroundPriorityThreads;
 
 		// if we don't have enough threads to allow all of the sets asked for, then we can't create what was asked for.
@@ -1184,7 +1279,7 @@ public:
 		NumTaskThreadsPerSet = (NumThreads - NumNamedThreads) / NumTaskThreadSets;
 		check((NumThreads - NumNamedThreads) % NumTaskThreadSets == 0); // should be equal numbers of threads per priority set
 
-		UE_LOG(LogTaskGraph, Log, TEXT("Started task graph with %d named threads and %d total threads with %d sets of task threads."), NumNamedThreads, NumThreads, NumTaskThreadSets);
+		UE_LOG(LogTaskGraph, Log, TEXT("Started task graph with %d named threads and %d total threads with %d sets of task threads%s."), NumNamedThreads, NumThreads, NumTaskThreadSets, bUseWorkStealing ? TEXT(" using work stealing") : TEXT(""));
 		check(NumThreads - NumNamedThreads >= 1);  // need at least one pure worker thread
 		check(NumThreads <= MAX_THREADS);
 		check(!ReentrancyCheck.GetValue()); // reentrant?
@@ -1319,6 +1414,11 @@ public:
 				}
 				uint32 PriIndex = TaskPriority ? 0 : 1;
 				check(Priority >= 0 && Priority < MAX_THREAD_PRIORITIES);
+				if (bUseWorkStealing)
+				{
+					QueueTaskWorkStealing(Task, Priority, PriIndex);
+					return;
+				}
 				{
 					TASKGRAPH_SCOPE_CYCLE_COUNTER(4, STAT_TaskGraph_QueueTask_IncomingAnyThreadTasks_Push);
 					int32 IndexToStart = IncomingAnyThreadTasks[Priority].Push(Task, PriIndex);
@@ -1551,9 +1651,133 @@ public:
 			MyIndex < (PLATFORM_64BITS ? 63 : 32) &&
 			Priority >= 0 && Priority < ENamedThreads::NumThreadPriorities);
 
+		if (bUseWorkStealing)
+		{
+			return FindWorkStealing(MyIndex, Priority);
+		}
 		return IncomingAnyThreadTasks[Priority].Pop(MyIndex, true);
 	}
 
+	// Work stealing backend
+
+	/**
+	 *	Queues an any thread task when work stealing is enabled.
+	 *	Tasks queued from a worker of the same priority set go LIFO into that worker's local deque, so subsequents run while their inputs are still in cache.
+	 *	High priority tasks and tasks from other threads go to the shared queue. Either way one idle worker is woken up if there is one.
+	 *	@param	Task; the task to queue
+	 *	@param	Priority; thread priority set to run the task on
+	 *	@param	PriIndex; index into the shared queue, 0 for high task priority
+	**/
+	void QueueTaskWorkStealing(FBaseGraphTask* Task, int32 Priority, uint32 PriIndex)
+	{
+		FTaskThreadAnyThread* CurrentWorker = PriIndex ? GetCurrentAnyThread(Priority) : nullptr;
+		if (!CurrentWorker || !CurrentWorker->EnqueueLocal(Task))
+		{
+			TASKGRAPH_SCOPE_CYCLE_COUNTER(4, STAT_TaskGraph_QueueTask_IncomingAnyThreadTasks_Push);
+			// nobody stalls on the shared queue in this mode, so it never asks us to start a thread
+			verify(IncomingAnyThreadTasks[Priority].Push(Task, PriIndex) < 0);
+		}
+		WakeIdleThread(Priority);
+	}
+
+	/**
+	 *	Finds work for a worker when work stealing is enabled: local deque first, then the shared queue, then the other workers of the same priority set.
+	 *	If nothing is found, the worker is marked idle before a final check so that a racing QueueTaskWorkStealing either sees the idle bit or the worker sees the task.
+	 *	@return	Task to run or nullptr if the worker should wait on its stall event.
+	**/
+	FBaseGraphTask* FindWorkStealing(int32 MyIndex, int32 Priority)
+	{
+		FTaskThreadAnyThread& Worker = AnyThread(Priority, MyIndex);
+		const uint64 MyBit = uint64(1) << MyIndex;
+
+		// we might have been woken up by something other than WakeIdleThread, so we are not idle anymore
+		if (IdleThreadMask[Priority].Load(EMemoryOrder::Relaxed) & MyBit)
+		{
+			IdleThreadMask[Priority].AndExchange(~MyBit);
+		}
+
+		FBaseGraphTask* Task = Worker.PopLocal();
+		if (!Task)
+		{
+			Task = FindSharedOrStolenWork(Worker, MyIndex, Priority);
+		}
+		if (!Task)
+		{
+			IdleThreadMask[Priority].OrExchange(MyBit);
+			Task = FindSharedOrStolenWork(Worker, MyIndex, Priority);
+			if (Task)
+			{
+				IdleThreadMask[Priority].AndExchange(~MyBit);
+			}
+		}
+		return Task;
+	}
+
+	FBaseGraphTask* FindSharedOrStolenWork(FTaskThreadAnyThread& Worker, int32 MyIndex, int32 Priority)
+	{
+		FBaseGraphTask* Task = IncomingAnyThreadTasks[Priority].Pop(MyIndex, false);
+		if (Task)
+		{
+			++Worker.WorkStealingStats.SharedPops;
+			return Task;
+		}
+		const int32 NumVictims = NumTaskThreadsPerSet;
+		const int32 FirstVictim = int32(Worker.NextStealRandom() % uint32(NumVictims));
+		for (int32 Offset = 0; Offset < NumVictims; Offset++)
+		{
+			int32 Victim = (FirstVictim + Offset) % NumVictims;
+			if (Victim != MyIndex)
+			{
+				Task = AnyThread(Priority, Victim).StealLocal();
+				if (Task)
+				{
+					++Worker.WorkStealingStats.Steals;
+					return Task;
+				}
+			}
+		}
+		++Worker.WorkStealingStats.FailedStealPasses;
+		return nullptr;
+	}
+
+	/** Wakes up one idle worker of the given priority set, if any. **/
+	void WakeIdleThread(int32 Priority)
+	{
+		uint64 LocalMask = IdleThreadMask[Priority].Load();
+		while (LocalMask)
+		{
+			int32 IndexToStart = int32(FMath::CountTrailingZeros64(LocalMask));
+			if (IdleThreadMask[Priority].CompareExchange(LocalMask, LocalMask & ~(uint64(1) << IndexToStart)))
+			{
+				StartTaskThread(Priority, IndexToStart);
+				return;
+			}
+		}
+	}
+
+	bool IsUsingWorkStealing() const
+	{
+		return bUseWorkStealing;
+	}
+
+	/** Sums the work stealing counters of all normal priority workers. These are read without synchronization and are only approximate while tasks are running. **/
+	FTaskThreadAnyThread::FWorkStealingStats GetWorkStealingStats()
+	{
+		FTaskThreadAnyThread::FWorkStealingStats Result;
+		const int32 Priority = ENamedThreads::NormalThreadPriority >> ENamedThreads::ThreadPriorityShift;
+		for (int32 Index = 0; Index < NumTaskThreadsPerSet; Index++)
+		{
+			const FTaskThreadAnyThread::FWorkStealingStats& Stats = AnyThread(Priority, Index).WorkStealingStats;
+			Result.LocalPushes += Stats.LocalPushes;
+			Result.LocalPops += Stats.LocalPops;
+			Result.SharedPops += Stats.SharedPops;
+			Result.Steals += Stats.Steals;
+			Result.FailedStealPasses += Stats.FailedStealPasses;
+			Result.Stalls += Stats.Stalls;
+		}
+		return Result;
+	}
+
 	void StallForTuning(int32 Index, bool Stall)
 	{
 		for (int32 Priority = 0; Priority < ENamedThreads::NumThreadPriorities; Priority++)
@@ -1616,6 +1840,30 @@ private:
 		return CurrentThreadIfKnown;
 	}
 
+	/** Returns the worker with the given index in a priority set. **/
+	FORCEINLINE FTaskThreadAnyThread& AnyThread(int32 Priority, int32 Index)
+	{
+		return (FTaskThreadAnyThread&)Thread(Index + Priority * NumTaskThreadsPerSet + NumNamedThreads);
+	}
+
+	/**
+	 *	Examines the TLS to determine if the current thread is a worker of the given priority set.
+	 *	@return	The current worker or nullptr if this thread is a named thread, an unknown thread or a worker of another priority set.
+	**/
+	FTaskThreadAnyThread* GetCurrentAnyThread(int32 Priority)
+	{
+		FWorkerThread* TLSPointer = (FWorkerThread*)FPlatformTLS::GetTlsValue(PerThreadIDTLSSlot);
+		if (TLSPointer)
+		{
+			int32 ThreadIndex = TLSPointer - WorkerThreads;
+			if (ThreadIndex >= NumNamedThreads && ThreadIndexToPriorityIndex(ThreadIndex) == Priority)
+			{
+				return (FTaskThreadAnyThread*)TLSPointer->TaskGraphWorker;
+			}
+		}
+		return nullptr;
+	}
+
 	int32 ThreadIndexToPriorityIndex(int32 ThreadIndex)
 	{
 		check(ThreadIndex >= NumNamedThreads && ThreadIndex < NumThreads);
@@ -1659,6 +1907,11 @@ private:
 	TArray<TFunction<void()> > ShutdownCallbacks;
 
 	FStallingTaskQueue<FBaseGraphTask, PLATFORM_CACHE_LINE_SIZE, 2>	IncomingAnyThreadTasks[MAX_THREAD_PRIORITIES];
+
+	/** If true, workers use their local deques and steal from each other, selected at startup with TaskGraph.UseWorkStealing. **/
+	bool				bUseWorkStealing;
+	/** With work stealing, one bit per worker of each priority set that is about to wait or waiting on its stall event. **/
+	TAtomic<uint64>		IdleThreadMask[MAX_THREAD_PRIORITIES];
 };
 
 
@@ -2469,6 +2722,203 @@ static FAutoConsoleCommand TaskGraphBenchmarkCmd(
 	FConsoleCommandWithArgsDelegate::CreateStatic(&TaskGraphBenchmark)
 	);
 
+class FFanOutGraphTask : public FCustomStatIDGraphTaskBase
+{
+public:
+	FORCEINLINE FFanOutGraphTask(FThreadSafeCounter& InCounter, FThreadSafeCounter& InCycles, int32 InNumChildren, int32 InWork)
+		: FCustomStatIDGraphTaskBase(TStatId())
+		, Counter(InCounter)
+		, Cycles(InCycles)
+		, NumChildren(InNumChildren)
+		, Work(InWork)
+	{
+	}
+	static FORCEINLINE ENamedThreads::Type GetDesiredThread()
+	{
+		return ENamedThreads::AnyThread;
+	}
+
+	static FORCEINLINE ESubsequentsMode::Type GetSubsequentsMode() { return ESubsequentsMode::TrackSubsequents; }
+	void DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+	{
+		FGraphEventArray Children;
+		Children.Reserve(NumChildren);
+		for (int32 Index = 0; Index < NumChildren; Index++)
+		{
+			Children.Emplace(TGraphTask<FIncGraphTaskSub>::CreateTask(nullptr, CurrentThread).ConstructAndDispatchWhenReady(Counter, Cycles, Work));
+		}
+		MyCompletionGraphEvent->DontCompleteUntil(TGraphTask<FNullGraphTask>::CreateTask(&Children, CurrentThread).ConstructAndDispatchWhenReady(TStatId(), ENamedThreads::AnyThread));
+	}
+private:
+	FThreadSafeCounter& Counter;
+	FThreadSafeCounter& Cycles;
+	int32 NumChildren;
+	int32 Work;
+};
+
+class FWakeUpLatencyGraphTask : public FCustomStatIDGraphTaskBase
+{
+public:
+	FORCEINLINE FWakeUpLatencyGraphTask(uint64* InStartCycles)
+		: FCustomStatIDGraphTaskBase(TStatId())
+		, StartCycles(InStartCycles)
+	{
+	}
+	static FORCEINLINE ENamedThreads::Type GetDesiredThread()
+	{
+		return ENamedThreads::AnyThread;
+	}
+	static FORCEINLINE ESubsequentsMode::Type GetSubsequentsMode() { return ESubsequentsMode::TrackSubsequents; }
+	void FORCEINLINE DoTask(ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+	{
+		*StartCycles = FPlatformTime::Cycles64();
+	}
+private:
+	uint64* StartCycles;
+};
+
+static void PrintWorkStealingStats(const FTaskThreadAnyThread::FWorkStealingStats& Before, const TCHAR* Message)
+{
+	FTaskThreadAnyThread::FWorkStealingStats After = FTaskGraphImplementation::Get().GetWorkStealingStats();
+	UE_LOG(LogConsoleResponse, Display, TEXT("        %8llu local pushes   %8llu local pops   %8llu shared pops   %8llu steals   %8llu failed steal passes   %8llu stalls   : %s")
+		, After.LocalPushes - Before.LocalPushes
+		, After.LocalPops - Before.LocalPops
+		, After.SharedPops - Before.SharedPops
+		, After.Steals - Before.Steals
+		, After.FailedStealPasses - Before.FailedStealPasses
+		, After.Stalls - Before.Stalls
+		, Message
+		);
+}
+
+/**
+ * Compares the shared queue backend with the work stealing backend. Run it once with and once without -TaskGraphWorkStealing.
+ * Optional argument: number of iterations of each scenario, defaults to 10.
+ */
+static void TaskGraphSchedulerBenchmark(const TArray<FString>& Args)
+{
+	FSlowHeartBeatScope SuspendHeartBeat;
+	TGuardValue<int32> ReentrantGuard(GPrintBroadcastWarnings, 0);
+
+	if (!FPlatformProcess::SupportsMultithreading())
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("WARNING: TaskGraphSchedulerBenchmark disabled for non multi-threading platforms"));
+		return;
+	}
+
+	const int32 NumIterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10;
+	const int32 NumWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads();
+	UE_LOG(LogConsoleResponse, Display, TEXT("TaskGraph scheduler benchmark: %s backend, %d workers per priority set, %d iterations"),
+		FTaskGraphImplementation::Get().IsUsingWorkStealing() ? TEXT("work stealing") : TEXT("shared queue"), NumWorkers, NumIterations);
+
+	double StartTime, QueueTime, EndTime, JoinTime;
+	FThreadSafeCounter Counter;
+	FThreadSafeCounter Cycles;
+	FTaskThreadAnyThread::FWorkStealingStats Stats;
+
+	for (int32 Work : {0, 100})
+	{
+		// fan-out/fan-in: a few roots on the workers each spawn many tiny children and a join
+		Stats = FTaskGraphImplementation::Get().GetWorkStealingStats();
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+		{
+			FGraphEventArray Roots;
+			for (int32 Index = 0; Index < 8; Index++)
+			{
+				Roots.Emplace(TGraphTask<FFanOutGraphTask>::CreateTask(nullptr, ENamedThreads::GameThread).ConstructAndDispatchWhenReady(Counter, Cycles, 500, Work));
+			}
+			QueueTime = FPlatformTime::Seconds();
+			FGraphEventRef Join = TGraphTask<FNullGraphTask>::CreateTask(&Roots, ENamedThreads::GameThread).ConstructAndDispatchWhenReady(TStatId(), ENamedThreads::AnyThread);
+			JoinTime = FPlatformTime::Seconds();
+			FTaskGraphInterface::Get().WaitUntilTaskCompletes(Join, ENamedThreads::GameThread_Local);
+		}
+		EndTime = FPlatformTime::Seconds();
+		check(Counter.GetValue() == NumIterations * 8 * 500);
+		PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, Work ? TEXT("fan-out/fan-in 8x500, with work") : TEXT("fan-out/fan-in 8x500"));
+		PrintWorkStealingStats(Stats, TEXT("fan-out/fan-in"));
+
+		// long dependency chains: one chain per worker, each link only becomes ready when the previous one completes
+		Stats = FTaskGraphImplementation::Get().GetWorkStealingStats();
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+		{
+			FGraphEventArray Tails;
+			TArray<FGraphEventRef> Heads;
+			for (int32 Chain = 0; Chain < NumWorkers; Chain++)
+			{
+				// hold the head so the whole chain is built before any of it runs
+				FGraphEventRef Head = FGraphEvent::CreateGraphEvent();
+				Heads.Add(Head);
+				FGraphEventRef Link = Head;
+				for (int32 Index = 0; Index < 1000; Index++)
+				{
+					FGraphEventArray Prereqs;
+					Prereqs.Add(Link);
+					Link = TGraphTask<FIncGraphTaskSub>::CreateTask(&Prereqs, ENamedThreads::GameThread).ConstructAndDispatchWhenReady(Counter, Cycles, Work);
+				}
+				Tails.Add(Link);
+			}
+			QueueTime = FPlatformTime::Seconds();
+			TArray<FBaseGraphTask*> NewTasks;
+			for (FGraphEventRef& Head : Heads)
+			{
+				Head->DispatchSubsequents(NewTasks, ENamedThreads::GameThread);
+			}
+			FGraphEventRef Join = TGraphTask<FNullGraphTask>::CreateTask(&Tails, ENamedThreads::GameThread).ConstructAndDispatchWhenReady(TStatId(), ENamedThreads::AnyThread);
+			JoinTime = FPlatformTime::Seconds();
+			FTaskGraphInterface::Get().WaitUntilTaskCompletes(Join, ENamedThreads::GameThread_Local);
+		}
+		EndTime = FPlatformTime::Seconds();
+		check(Counter.GetValue() == NumIterations * NumWorkers * 1000);
+		PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, Work ? TEXT("dependency chains 1000 long, with work") : TEXT("dependency chains 1000 long"));
+		PrintWorkStealingStats(Stats, TEXT("dependency chains"));
+
+		// ParallelFor bursts, many small ones back to back like a frame of tick and animation work
+		Stats = FTaskGraphImplementation::Get().GetWorkStealingStats();
+		StartTime = FPlatformTime::Seconds();
+		QueueTime = StartTime;
+		JoinTime = StartTime;
+		for (int32 Iteration = 0; Iteration < NumIterations * 10; Iteration++)
+		{
+			ParallelFor(256,
+				[&Counter, &Cycles, Work](int32 Index)
+				{
+					DoWork(&Counter, Counter, Cycles, Work);
+				}
+			);
+		}
+		EndTime = FPlatformTime::Seconds();
+		PrintResult(StartTime, QueueTime, EndTime, JoinTime, Counter, Cycles, Work ? TEXT("ParallelFor bursts 256 elements, with work") : TEXT("ParallelFor bursts 256 elements"));
+		PrintWorkStealingStats(Stats, TEXT("ParallelFor bursts"));
+	}
+
+	// wake-up latency: let the workers go idle, then time how long it takes for a single task to start running
+	{
+		double TotalLatency = 0.0;
+		double MaxLatency = 0.0;
+		const int32 NumSamples = NumIterations * 10;
+		for (int32 Sample = 0; Sample < NumSamples; Sample++)
+		{
+			FPlatformProcess::Sleep(0.002f);
+			uint64 TaskStartCycles = 0;
+			const uint64 QueueCycles = FPlatformTime::Cycles64();
+			FGraphEventRef Task = TGraphTask<FWakeUpLatencyGraphTask>::CreateTask(nullptr, ENamedThreads::GameThread).ConstructAndDispatchWhenReady(&TaskStartCycles);
+			FTaskGraphInterface::Get().WaitUntilTaskCompletes(Task, ENamedThreads::GameThread_Local);
+			const double Latency = FPlatformTime::ToMilliseconds64(TaskStartCycles - QueueCycles);
+			TotalLatency += Latency;
+			MaxLatency = FMath::Max(MaxLatency, Latency);
+		}
+		UE_LOG(LogConsoleResponse, Display, TEXT("Wake-up latency %6.4fms average   %6.4fms max   over %d samples"), TotalLatency / NumSamples, MaxLatency, NumSamples);
+	}
+}
+
+static FAutoConsoleCommand TaskGraphSchedulerBenchmarkCmd(
+	TEXT("TaskGraph.SchedulerBenchmark"),
+	TEXT("Times fan-out/fan-in, dependency chain, ParallelFor burst and wake-up latency scenarios for the active any thread backend (see TaskGraph.UseWorkStealing)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&TaskGraphSchedulerBenchmark)
+	);
+
 
 struct FTestStruct
 {
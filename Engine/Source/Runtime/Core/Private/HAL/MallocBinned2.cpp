@@ -64,6 +64,16 @@ TAtomic<int64> AllocatedLargePoolMemoryWAlignment(0); // when we allocate at OS
 int64 Binned2PoolInfoMemory = 0;
 int64 Binned2HashMemory = 0;
 int64 Binned2TLSMemory = 0;
+
+TAtomic<int64> Binned2RemoteFrees(0); // blocks the freeing thread could not cache, parked in the size class inboxes
+TAtomic<int64> Binned2RemoteFreesAdopted(0); // blocks taken from the inboxes by allocating threads without the lock
+TAtomic<int64> Binned2RemoteFreeDrains(0); // number of times an inbox was returned to the pool tables under the lock
+TAtomic<int64> Binned2RemoteFreePendingMemory(0); // memory currently parked in the inboxes
+
+DECLARE_MEMORY_STAT(TEXT("Binned2 Remote Free Pending"), STAT_Binned2_RemoteFreePending, STATGROUP_Memory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Binned2 Remote Frees"), STAT_Binned2_RemoteFrees, STATGROUP_Memory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Binned2 Remote Frees Adopted"), STAT_Binned2_RemoteFreesAdopted, STATGROUP_Memory);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Binned2 Remote Free Drains"), STAT_Binned2_RemoteFreeDrains, STATGROUP_Memory);
 #endif
 
 #if BINNED2_ALLOCATOR_STATS_VALIDATION
@@ -479,9 +489,101 @@ struct FMallocBinned2::Private
 
 	static FGlobalRecycler GGlobalRecycler;
 
-	static void FreeBundles(FMallocBinned2& Allocator, FBundleNode* BundlesToRecycle, uint32 InBlockSize, uint32 InPoolIndex)
+	/**
+	 * Per size class inboxes for blocks that the freeing thread could not keep, either because it has no
+	 * TLS cache or because the global recycler was full. Any thread pushes, allocating threads take the whole
+	 * list at once and adopt it into their cache, so neither side needs the allocator mutex. The list is only
+	 * returned to the pool tables under the mutex when it grows past a threshold or when trimming.
+	 */
+	struct FRemoteFreeInbox
+	{
+		// returns the approximate number of blocks waiting in the inbox after the push
+		uint32 Push(uint32 InPoolIndex, FBundleNode* InBundle, uint32 InNumBlocks)
+		{
+			FPaddedInbox& Inbox = Inboxes[InPoolIndex];
+			for (;;)
+			{
+				FBundleNode* LocalHead = Inbox.Head;
+				InBundle->NextBundle = LocalHead;
+				if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Inbox.Head, InBundle, LocalHead) == LocalHead)
+				{
+					break;
+				}
+			}
+			return uint32(FPlatformAtomics::InterlockedAdd(&Inbox.NumBlocks, int32(InNumBlocks)) + int32(InNumBlocks));
+		}
+
+		// puts back bundles linked through NextBundle that were taken with PopAll
+		void PushList(uint32 InPoolIndex, FBundleNode* InBundles)
+		{
+			FPaddedInbox& Inbox = Inboxes[InPoolIndex];
+			uint32 NumBlocks = 0;
+			FBundleNode* LastBundle = InBundles;
+			for (FBundleNode* Bundle = InBundles; Bundle; Bundle = Bundle->NextBundle)
+			{
+				for (FBundleNode* Node = Bundle; Node; Node = Node->NextNodeInCurrentBundle)
+				{
+					++NumBlocks;
+				}
+				LastBundle = Bundle;
+			}
+			for (;;)
+			{
+				FBundleNode* LocalHead = Inbox.Head;
+				LastBundle->NextBundle = LocalHead;
+				if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&Inbox.Head, InBundles, LocalHead) == LocalHead)
+				{
+					break;
+				}
+			}
+			FPlatformAtomics::InterlockedAdd(&Inbox.NumBlocks, int32(NumBlocks));
+		}
+
+		// takes every bundle in the inbox, they are linked through NextBundle
+		FBundleNode* PopAll(uint32 InPoolIndex)
+		{
+			FPaddedInbox& Inbox = Inboxes[InPoolIndex];
+			if (!Inbox.Head)
+			{
+				return nullptr;
+			}
+			FBundleNode* Result = (FBundleNode*)FPlatformAtomics::InterlockedExchangePtr((void**)&Inbox.Head, nullptr);
+			// the count is only a hint for draining, a racing push may be counted before or after this reset
+			FPlatformAtomics::InterlockedExchange(&Inbox.NumBlocks, 0);
+			return Result;
+		}
+
+		// the number of blocks past which the pusher returns the inbox to the pool tables
+		static uint32 GetDrainThreshold(uint32 InBlockSize)
+		{
+			const uint32 MaxBytes = (uint32)GMallocBinned2BundleSize * BINNED2_MAX_GMallocBinned2MaxBundlesBeforeRecycle;
+			return FMath::Max<uint32>(FMath::Min<uint32>((uint32)GMallocBinned2BundleCount * BINNED2_MAX_GMallocBinned2MaxBundlesBeforeRecycle, MaxBytes / InBlockSize), 1);
+		}
+
+	private:
+		struct FPaddedInbox
+		{
+			FBundleNode* volatile Head;
+			volatile int32 NumBlocks;
+			uint8 Padding[PLATFORM_CACHE_LINE_SIZE - sizeof(FBundleNode*) - sizeof(int32)];
+
+			FPaddedInbox()
+				: Head(nullptr)
+				, NumBlocks(0)
+			{
+			}
+		};
+		static_assert(sizeof(FPaddedInbox) == PLATFORM_CACHE_LINE_SIZE, "FPaddedInbox should be the same size as a cache line");
+		MS_ALIGN(PLATFORM_CACHE_LINE_SIZE) FPaddedInbox Inboxes[BINNED2_SMALL_POOL_COUNT] GCC_ALIGN(PLATFORM_CACHE_LINE_SIZE);
+	};
+
+	static FRemoteFreeInbox GRemoteFreeInbox;
+
+	// returns the number of blocks freed
+	static uint32 FreeBundles(FMallocBinned2& Allocator, FBundleNode* BundlesToRecycle, uint32 InBlockSize, uint32 InPoolIndex)
 	{
 		FPoolTable& Table = Allocator.SmallPoolTables[InPoolIndex];
+		uint32 NumFreed = 0;
 
 		FBundleNode* Bundle = BundlesToRecycle;
 		while (Bundle)
@@ -533,11 +635,28 @@ struct FMallocBinned2::Private
 #endif
 				}
 
+				++NumFreed;
 				Node = NextNode;
 			} while (Node);
 
 			Bundle = NextBundle;
 		}
+
+		return NumFreed;
+	}
+
+	static void DrainRemoteFreeInbox(FMallocBinned2& Allocator, uint32 InPoolIndex)
+	{
+		FBundleNode* Bundles = GRemoteFreeInbox.PopAll(InPoolIndex);
+		if (Bundles)
+		{
+			const uint32 BlockSize = Allocator.PoolIndexToBlockSize(InPoolIndex);
+			const uint32 NumFreed = FreeBundles(Allocator, Bundles, BlockSize, InPoolIndex);
+#if BINNED2_ALLOCATOR_STATS
+			++Binned2RemoteFreeDrains;
+			Binned2RemoteFreePendingMemory -= int64(NumFreed) * BlockSize;
+#endif
+		}
 	}
 
 
@@ -579,6 +698,7 @@ struct FMallocBinned2::Private
 };
 
 FMallocBinned2::Private::FGlobalRecycler FMallocBinned2::Private::GGlobalRecycler;
+FMallocBinned2::Private::FRemoteFreeInbox FMallocBinned2::Private::GRemoteFreeInbox;
 
 #if BINNED2_ALLOCATOR_STATS
 int64 FMallocBinned2::FPerThreadFreeBlockLists::ConsolidatedMemory = 0;
@@ -722,7 +842,27 @@ void* FMallocBinned2::MallocExternalSmall(SIZE_T Size, uint32 Alignment)
 	FPerThreadFreeBlockLists* Lists = GMallocBinned2PerThreadCaches ? FPerThreadFreeBlockLists::Get() : nullptr;
 	if (Lists)
 	{
-		if (Lists->ObtainRecycledPartial(PoolIndex))
+		bool bHasBlocks = Lists->ObtainRecycledPartial(PoolIndex);
+		if (!bHasBlocks)
+		{
+			// take whatever other threads could not cache before falling back to the locked pool tables
+			if (FBundleNode* RemoteBundles = Private::GRemoteFreeInbox.PopAll(PoolIndex))
+			{
+				FBundleNode* LeftoverBundles = nullptr;
+				const uint32 NumAdopted = Lists->AdoptRemoteBundles(PoolIndex, PoolIndexToBlockSize(PoolIndex), RemoteBundles, LeftoverBundles);
+				if (LeftoverBundles)
+				{
+					// they are drained to the pool tables like any other remote free once enough pile up
+					Private::GRemoteFreeInbox.PushList(PoolIndex, LeftoverBundles);
+				}
+				bHasBlocks = true;
+#if BINNED2_ALLOCATOR_STATS
+				Binned2RemoteFreesAdopted += NumAdopted;
+				Binned2RemoteFreePendingMemory -= int64(NumAdopted) * PoolIndexToBlockSize(PoolIndex);
+#endif
+			}
+		}
+		if (bHasBlocks)
 		{
 			if (void* Result = Lists->Malloc(PoolIndex))
 			{
@@ -920,10 +1060,11 @@ void FMallocBinned2::FreeExternal(void* Ptr)
 		uint32 PoolIndex = BasePtr->PoolIndex;
 
 		FBundleNode* BundlesToRecycle = nullptr;
+		uint32 NumBlocksToRecycle = 0;
 		FPerThreadFreeBlockLists* Lists = GMallocBinned2PerThreadCaches ? FPerThreadFreeBlockLists::Get() : nullptr;
 		if (Lists)
 		{
-			BundlesToRecycle = Lists->RecycleFullBundle(BasePtr->PoolIndex);
+			BundlesToRecycle = Lists->RecycleFullBundle(BasePtr->PoolIndex, NumBlocksToRecycle);
 			bool bPushed = Lists->Free(Ptr, PoolIndex, BlockSize);
 			check(bPushed);
 #if BINNED2_ALLOCATOR_STATS
@@ -934,19 +1075,26 @@ void FMallocBinned2::FreeExternal(void* Ptr)
 		{
 			BundlesToRecycle = (FBundleNode*)Ptr;
 			BundlesToRecycle->NextNodeInCurrentBundle = nullptr;
+			NumBlocksToRecycle = 1;
+#if BINNED2_ALLOCATOR_STATS
+			// lists track their own stat track them instead in the global stat if we don't have lists
+			AllocatedSmallPoolMemory -= ((int64)(BlockSize));
+#endif
 		}
 		if (BundlesToRecycle)
 		{
-			BundlesToRecycle->NextBundle = nullptr;
-			FScopeLock Lock(&Mutex);
-			Private::FreeBundles(*this, BundlesToRecycle, BlockSize, PoolIndex);
+			// Rather than taking the mutex for every block or bundle we can't cache, park them in the size class inbox
+			// where allocating threads adopt them lock-free. Only return them to the pool tables once enough have piled up.
+			const uint32 NumWaiting = Private::GRemoteFreeInbox.Push(PoolIndex, BundlesToRecycle, NumBlocksToRecycle);
 #if BINNED2_ALLOCATOR_STATS
-			if (!Lists)
+			Binned2RemoteFrees += NumBlocksToRecycle;
+			Binned2RemoteFreePendingMemory += int64(NumBlocksToRecycle) * BlockSize;
+#endif
+			if (NumWaiting >= Private::FRemoteFreeInbox::GetDrainThreshold(BlockSize))
 			{
-				// lists track their own stat track them instead in the global stat if we don't have lists
-				AllocatedSmallPoolMemory -= ((int64)(BlockSize));
+				FScopeLock Lock(&Mutex);
+				Private::DrainRemoteFreeInbox(*this, PoolIndex);
 			}
-#endif
 		}
 	}
 	else if (Ptr)
@@ -1110,6 +1258,11 @@ void FMallocBinned2::Trim(bool bTrimThreadCaches)
 	{
 		//double StartTime = FPlatformTime::Seconds();
 		FScopeLock Lock(&Mutex);
+		// return parked remote frees first so that pools they empty can be released below
+		for (uint32 PoolIndex = 0; PoolIndex != BINNED2_SMALL_POOL_COUNT; ++PoolIndex)
+		{
+			Private::DrainRemoteFreeInbox(*this, PoolIndex);
+		}
 		CachedOSPageAllocator.FreeAll();
 		//UE_LOG(LogTemp, Display, TEXT("Trim CachedOSPageAllocator = %6.2fms"), 1000.0f * float(FPlatformTime::Seconds() - StartTime));
 	}
@@ -1153,9 +1306,10 @@ bool FMallocBinned2::FFreeBlockList::ObtainPartial(uint32 InPoolIndex)
 	return true;
 }
 
-FMallocBinned2::FBundleNode* FMallocBinned2::FFreeBlockList::RecyleFull(uint32 InPoolIndex)
+FMallocBinned2::FBundleNode* FMallocBinned2::FFreeBlockList::RecyleFull(uint32 InPoolIndex, uint32& OutNumBlocks)
 {
 	FMallocBinned2::FBundleNode* Result = nullptr;
+	OutNumBlocks = 0;
 	if (FullBundle.Head)
 	{
 		FullBundle.Head->Count = FullBundle.Count;
@@ -1163,14 +1317,63 @@ FMallocBinned2::FBundleNode* FMallocBinned2::FFreeBlockList::RecyleFull(uint32 I
 		{
 			Result = FullBundle.Head;
 			Result->NextBundle = nullptr;
+			OutNumBlocks = FullBundle.Count;
+
+			// This thread frees more of this size class than others allocate. Hand off fewer, larger bundles,
+			// GMallocBinned2BundleSize still bounds how much memory a bundle can hold.
+			BundleCountLimit = FMath::Min<uint32>(BundleCountLimit * 2, BINNED2_MAX_ADAPTIVE_BUNDLE_COUNT);
 		}
 		FullBundle.Reset();
 	}
 	return Result;
 }
 
+uint32 FMallocBinned2::FFreeBlockList::AdoptBundles(FBundleNode* InBundles, uint32 InPoolIndex, uint32 InBlockSize, FBundleNode*& OutLeftoverBundles)
+{
+	uint32 NumAdopted = 0;
+	OutLeftoverBundles = nullptr;
+
+	FBundleNode* Bundle = InBundles;
+	while (Bundle)
+	{
+		FBundleNode* NextBundle = Bundle->NextBundle;
+		FBundleNode* Node = Bundle;
+		do
+		{
+			// same limits as PushToFront, a full partial bundle becomes the full bundle and the previous one goes to the recycler
+			if (PartialBundle.Count >= BundleCountLimit || PartialBundle.Count * InBlockSize >= (uint32)GMallocBinned2BundleSize)
+			{
+				if (FullBundle.Head)
+				{
+					FullBundle.Head->Count = FullBundle.Count;
+					if (!FMallocBinned2::Private::GGlobalRecycler.PushBundle(InPoolIndex, FullBundle.Head))
+					{
+						// the recycler is full too, the rest of this bundle and the following ones stay remote
+						Node->NextBundle = NextBundle;
+						OutLeftoverBundles = Node;
+						return NumAdopted;
+					}
+					FullBundle.Reset();
+				}
+				FullBundle = PartialBundle;
+				PartialBundle.Reset();
+			}
+
+			FBundleNode* NextNode = Node->NextNodeInCurrentBundle;
+			PartialBundle.PushHead(Node);
+			++NumAdopted;
+			Node = NextNode;
+		} while (Node);
+		Bundle = NextBundle;
+	}
+	return NumAdopted;
+}
+
 FMallocBinned2::FBundleNode* FMallocBinned2::FFreeBlockList::PopBundles(uint32 InPoolIndex)
 {
+	// the cache is being flushed, start over with the default bundle size
+	BundleCountLimit = (uint32)GMallocBinned2BundleCount;
+
 	FBundleNode* Partial = PartialBundle.Head;
 	if (Partial)
 	{
@@ -1268,10 +1471,56 @@ void FMallocBinned2::GetAllocatorStats( FGenericMemoryStats& OutStats )
 
 	OutStats.Add(TEXT("TotalAllocated"), TotalAllocated);
 	OutStats.Add(TEXT("TotalOSAllocated"), TotalOSAllocated);
+
+	OutStats.Add(TEXT("RemoteFrees"), Binned2RemoteFrees.Load(EMemoryOrder::Relaxed));
+	OutStats.Add(TEXT("RemoteFreesAdopted"), Binned2RemoteFreesAdopted.Load(EMemoryOrder::Relaxed));
+	OutStats.Add(TEXT("RemoteFreeDrains"), Binned2RemoteFreeDrains.Load(EMemoryOrder::Relaxed));
+	OutStats.Add(TEXT("RemoteFreePendingMemory"), Binned2RemoteFreePendingMemory.Load(EMemoryOrder::Relaxed));
 #endif
 	FMalloc::GetAllocatorStats(OutStats);
 }
 
+void FMallocBinned2::InitializeStatsMetadata()
+{
+	FMalloc::InitializeStatsMetadata();
+
+#if BINNED2_ALLOCATOR_STATS
+	// Initialize stats metadata here instead of UpdateStats.
+	// Mostly to avoid dead-lock when stats malloc profiler is enabled.
+	GET_STATFNAME(STAT_Binned2_RemoteFreePending);
+	GET_STATFNAME(STAT_Binned2_RemoteFrees);
+	GET_STATFNAME(STAT_Binned2_RemoteFreesAdopted);
+	GET_STATFNAME(STAT_Binned2_RemoteFreeDrains);
+#endif
+}
+
+void FMallocBinned2::UpdateStats()
+{
+	FMalloc::UpdateStats();
+
+#if BINNED2_ALLOCATOR_STATS
+	// the counters are totals, report how much they moved since the last frame
+	static int64 LastRemoteFrees = 0;
+	static int64 LastRemoteFreesAdopted = 0;
+	static int64 LastRemoteFreeDrains = 0;
+
+	const int64 LocalRemoteFrees = Binned2RemoteFrees.Load(EMemoryOrder::Relaxed);
+	const int64 LocalRemoteFreesAdopted = Binned2RemoteFreesAdopted.Load(EMemoryOrder::Relaxed);
+	const int64 LocalRemoteFreeDrains = Binned2RemoteFreeDrains.Load(EMemoryOrder::Relaxed);
+	const int64 LocalRemoteFreePendingMemory = Binned2RemoteFreePendingMemory.Load(EMemoryOrder::Relaxed);
+
+	SET_MEMORY_STAT(STAT_Binned2_RemoteFreePending, LocalRemoteFreePendingMemory);
+	SET_DWORD_STAT(STAT_Binned2_RemoteFrees, LocalRemoteFrees - LastRemoteFrees);
+	SET_DWORD_STAT(STAT_Binned2_RemoteFreesAdopted, LocalRemoteFreesAdopted - LastRemoteFreesAdopted);
+	SET_DWORD_STAT(STAT_Binned2_RemoteFreeDrains, LocalRemoteFreeDrains - LastRemoteFreeDrains);
+	LLM(FLowLevelMemTracker::Get().SetTagAmountForTracker(ELLMTracker::Platform, ELLMTag::FMallocRemoteFree, LocalRemoteFreePendingMemory, false));
+
+	LastRemoteFrees = LocalRemoteFrees;
+	LastRemoteFreesAdopted = LocalRemoteFreesAdopted;
+	LastRemoteFreeDrains = LocalRemoteFreeDrains;
+#endif
+}
+
 void FMallocBinned2::DumpAllocatorStats(class FOutputDevice& Ar)
 {
 #if BINNED2_ALLOCATOR_STATS
@@ -1298,6 +1547,8 @@ void FMallocBinned2::DumpAllocatorStats(class FOutputDevice& Ar)
 			AllocatedOSSmallPoolMemory + AllocatedLargePoolMemoryWAlignment + Binned2PoolInfoMemory + Binned2HashMemory + Binned2TLSMemory
 			) / (1024.0f * 1024.0f));
 	Ar.Logf(TEXT("Cached free OS pages: %fmb"), ((double)OSPageAllocatorCachedFreeSize) / (1024.0f * 1024.0f));
+	Ar.Logf(TEXT("Remote frees: %lld blocks, %lld adopted by allocating threads, %lld inbox drains"), Binned2RemoteFrees.Load(EMemoryOrder::Relaxed), Binned2RemoteFreesAdopted.Load(EMemoryOrder::Relaxed), Binned2RemoteFreeDrains.Load(EMemoryOrder::Relaxed));
+	Ar.Logf(TEXT("Remote frees pending: %fmb"), ((double)Binned2RemoteFreePendingMemory.Load(EMemoryOrder::Relaxed)) / (1024.0f * 1024.0f));
 #else
 	Ar.Logf(TEXT("Allocator Stats for binned2 are not in this build set BINNED2_ALLOCATOR_STATS 1 in MallocBinned2.cpp"));
 #endif
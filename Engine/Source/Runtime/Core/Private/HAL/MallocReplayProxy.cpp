@@ -11,6 +11,16 @@
 
 #include "Misc/CString.h"
 #include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/IConsoleManager.h"
+#include "CoreGlobals.h"
+#include "Containers/UnrealString.h"
+#include "Containers/StringConv.h"
+#include "Containers/Map.h"
+#include "Containers/Queue.h"
+#include "Async/Async.h"
+#include "Templates/Atomic.h"
+#include "Logging/LogMacros.h"
 
 struct FMallocReplayProxyCloserOnExit
 {
@@ -167,4 +177,354 @@ void FMallocReplayProxy::ClearAndDisableTLSCachesOnCurrentThread()
 	UsedMalloc->ClearAndDisableTLSCachesOnCurrentThread();
 }
 
+namespace MallocReplay
+{
+	/** A recorded operation with the pointers replaced by slot indices, so the replay does no lookups. */
+	struct FOperation
+	{
+		enum EType : uint8
+		{
+			Malloc,
+			Realloc,
+			Free
+		};
+
+		enum
+		{
+			NoSlot = MAX_uint32
+		};
+
+		EType	Type;
+		uint32	Alignment;
+		uint32	InSlot;
+		uint32	OutSlot;
+		uint64	Size;
+	};
+
+	struct FHistory
+	{
+		TArray<FOperation> Operations;
+		uint32 NumSlots = 0;
+		int64 NumSkipped = 0;
+	};
+
+	static bool LoadHistory(const TCHAR* Filename, FHistory& OutHistory)
+	{
+		FILE* File = fopen(TCHAR_TO_UTF8(Filename), "rb");
+		if (!File)
+		{
+			return false;
+		}
+
+		// pointers that are live at this point of the history, and slots that can be handed out again
+		TMap<uint64, uint32> LiveSlots;
+		TArray<uint32> FreeSlots;
+
+		auto AllocateSlot = [&OutHistory, &LiveSlots, &FreeSlots](uint64 Pointer)
+		{
+			const uint32 Slot = FreeSlots.Num() ? FreeSlots.Pop(false) : OutHistory.NumSlots++;
+			// frees are recorded after they happened, so another thread may have been handed the pointer already
+			if (LiveSlots.Contains(Pointer))
+			{
+				++OutHistory.NumSkipped;
+			}
+			LiveSlots.Add(Pointer, Slot);
+			return Slot;
+		};
+
+		auto ReleaseSlot = [&LiveSlots, &FreeSlots](uint64 Pointer)
+		{
+			uint32 Slot = FOperation::NoSlot;
+			if (LiveSlots.RemoveAndCopyValue(Pointer, Slot))
+			{
+				FreeSlots.Add(Slot);
+			}
+			return Slot;
+		};
+
+		char Line[256];
+		while (fgets(Line, sizeof(Line), File))
+		{
+			char Operation[32];
+			unsigned long long PointerOut = 0, PointerIn = 0, Size = 0;
+			unsigned int Alignment = 0;
+			if (sscanf(Line, "%31s %llu %llu %llu %u", Operation, &PointerOut, &PointerIn, &Size, &Alignment) != 5)
+			{
+				// header, the closing line or a truncated entry
+				continue;
+			}
+
+			FOperation Op;
+			Op.Alignment = Alignment;
+			Op.Size = Size;
+			Op.InSlot = FOperation::NoSlot;
+			Op.OutSlot = FOperation::NoSlot;
+
+			if (FCStringAnsi::Strcmp(Operation, "Malloc") == 0)
+			{
+				Op.Type = FOperation::Malloc;
+				Op.OutSlot = AllocateSlot(PointerOut);
+			}
+			else if (FCStringAnsi::Strcmp(Operation, "Realloc") == 0)
+			{
+				Op.Type = FOperation::Realloc;
+				if (PointerIn)
+				{
+					// reallocating something allocated before recording started becomes a plain allocation
+					Op.InSlot = ReleaseSlot(PointerIn);
+				}
+				if (PointerOut)
+				{
+					Op.OutSlot = AllocateSlot(PointerOut);
+				}
+			}
+			else if (FCStringAnsi::Strcmp(Operation, "Free") == 0)
+			{
+				Op.Type = FOperation::Free;
+				Op.InSlot = ReleaseSlot(PointerIn);
+				if (Op.InSlot == FOperation::NoSlot)
+				{
+					// allocated before recording started
+					++OutHistory.NumSkipped;
+					continue;
+				}
+			}
+			else
+			{
+				continue;
+			}
+
+			OutHistory.Operations.Add(Op);
+		}
+
+		fclose(File);
+		return true;
+	}
+
+	/** Collects frees from the replaying threads and performs them on a thread of its own. */
+	class FRemoteFreer
+	{
+	public:
+		enum
+		{
+			BatchSize = 1024
+		};
+
+		typedef TArray<void*> FBatch;
+
+		void Enqueue(FBatch* Batch)
+		{
+			Batches.Enqueue(Batch);
+		}
+
+		void Run(TAtomic<int32>& NumProducersRunning)
+		{
+			for (;;)
+			{
+				FBatch* Batch = nullptr;
+				if (Batches.Dequeue(Batch))
+				{
+					for (void* Ptr : *Batch)
+					{
+						FMemory::Free(Ptr);
+					}
+					delete Batch;
+				}
+				else if (NumProducersRunning.Load() == 0)
+				{
+					// producers enqueue before they stop running, so one more look catches their last batches
+					if (Batches.IsEmpty())
+					{
+						break;
+					}
+				}
+				else
+				{
+					FPlatformProcess::Yield();
+				}
+			}
+		}
+
+	private:
+		TQueue<FBatch*, EQueueMode::Mpsc> Batches;
+	};
+
+	static void Replay(const FHistory& History, FRemoteFreer* RemoteFreer)
+	{
+		TArray<void*> Slots;
+		Slots.SetNumZeroed(History.NumSlots);
+
+		FRemoteFreer::FBatch* Batch = nullptr;
+		auto FreePointer = [RemoteFreer, &Batch](void* Ptr)
+		{
+			if (!RemoteFreer)
+			{
+				FMemory::Free(Ptr);
+				return;
+			}
+			if (!Batch)
+			{
+				Batch = new FRemoteFreer::FBatch();
+				Batch->Reserve(FRemoteFreer::BatchSize);
+			}
+			Batch->Add(Ptr);
+			if (Batch->Num() == FRemoteFreer::BatchSize)
+			{
+				RemoteFreer->Enqueue(Batch);
+				Batch = nullptr;
+			}
+		};
+
+		for (const FOperation& Op : History.Operations)
+		{
+			switch (Op.Type)
+			{
+			case FOperation::Malloc:
+			{
+				if (void* Stale = Slots[Op.OutSlot])
+				{
+					FreePointer(Stale);
+				}
+				void* Result = FMemory::Malloc(Op.Size, Op.Alignment);
+				if (Op.Size)
+				{
+					// touch the memory like the recorded program did
+					*(uint8*)Result = 0;
+				}
+				Slots[Op.OutSlot] = Result;
+				break;
+			}
+			case FOperation::Realloc:
+			{
+				void* Original = nullptr;
+				if (Op.InSlot != FOperation::NoSlot)
+				{
+					Original = Slots[Op.InSlot];
+					Slots[Op.InSlot] = nullptr;
+				}
+				void* Result = FMemory::Realloc(Original, Op.Size, Op.Alignment);
+				if (Op.OutSlot != FOperation::NoSlot)
+				{
+					if (void* Stale = Slots[Op.OutSlot])
+					{
+						FreePointer(Stale);
+					}
+					Slots[Op.OutSlot] = Result;
+				}
+				else if (Result)
+				{
+					FreePointer(Result);
+				}
+				break;
+			}
+			case FOperation::Free:
+			{
+				if (void* Ptr = Slots[Op.InSlot])
+				{
+					FreePointer(Ptr);
+					Slots[Op.InSlot] = nullptr;
+				}
+				break;
+			}
+			}
+		}
+
+		// whatever was still allocated when the recording stopped
+		for (void* Ptr : Slots)
+		{
+			if (Ptr)
+			{
+				FreePointer(Ptr);
+			}
+		}
+		if (Batch)
+		{
+			RemoteFreer->Enqueue(Batch);
+		}
+	}
+}
+
+bool FMallocReplayProxy::ReplayHistory(const TCHAR* Filename, int32 NumThreads, bool bFreeOnOtherThread)
+{
+	using namespace MallocReplay;
+
+	FHistory History;
+	const double LoadStartTime = FPlatformTime::Seconds();
+	if (!LoadHistory(Filename, History))
+	{
+		UE_LOG(LogMemory, Error, TEXT("Malloc replay: could not open %s"), Filename);
+		return false;
+	}
+	UE_LOG(LogMemory, Display, TEXT("Malloc replay: loaded %d operations from %s in %.2fs (%lld skipped, %u slots)"),
+		History.Operations.Num(), Filename, FPlatformTime::Seconds() - LoadStartTime, History.NumSkipped, History.NumSlots);
+
+	NumThreads = FMath::Max(NumThreads, 1);
+	FRemoteFreer RemoteFreer;
+	TAtomic<int32> NumProducersRunning(NumThreads);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<TFuture<void>> Futures;
+	for (int32 Thread = 0; Thread < NumThreads; ++Thread)
+	{
+		Futures.Add(Async(EAsyncExecution::Thread, [&History, &RemoteFreer, &NumProducersRunning, bFreeOnOtherThread]()
+		{
+			// replay like a task graph worker would run
+			FMemory::SetupTLSCachesOnCurrentThread();
+			Replay(History, bFreeOnOtherThread ? &RemoteFreer : nullptr);
+			FMemory::ClearAndDisableTLSCachesOnCurrentThread();
+			--NumProducersRunning;
+		}));
+	}
+	if (bFreeOnOtherThread)
+	{
+		Futures.Add(Async(EAsyncExecution::Thread, [&RemoteFreer, &NumProducersRunning]()
+		{
+			RemoteFreer.Run(NumProducersRunning);
+		}));
+	}
+	for (TFuture<void>& Future : Futures)
+	{
+		Future.Wait();
+	}
+
+	const double Seconds = FPlatformTime::Seconds() - StartTime;
+	const double NumOperations = double(History.Operations.Num()) * NumThreads;
+	UE_LOG(LogMemory, Display, TEXT("Malloc replay: %s, %d thread(s)%s, %.3fs, %.1f Mops/s"),
+		GMalloc->GetDescriptiveName(), NumThreads, bFreeOnOtherThread ? TEXT(", frees on another thread") : TEXT(""),
+		Seconds, NumOperations / FMath::Max(Seconds, 1e-9) / 1e6);
+
+	return true;
+}
+
+static void MallocReplayCommand(const TArray<FString>& Args)
+{
+	if (Args.Num() < 1)
+	{
+		UE_LOG(LogMemory, Display, TEXT("Usage: Malloc.Replay <HistoryFile> [-threads=N] [-crossthread]"));
+		return;
+	}
+
+	int32 NumThreads = 1;
+	bool bFreeOnOtherThread = false;
+	for (int32 Index = 1; Index < Args.Num(); ++Index)
+	{
+		if (Args[Index].StartsWith(TEXT("-threads=")))
+		{
+			NumThreads = FCString::Atoi(*Args[Index] + 9);
+		}
+		else if (Args[Index] == TEXT("-crossthread"))
+		{
+			bFreeOnOtherThread = true;
+		}
+	}
+
+	FMallocReplayProxy::ReplayHistory(*Args[0], NumThreads, bFreeOnOtherThread);
+}
+
+static FAutoConsoleCommand MallocReplayConsoleCommand(
+	TEXT("Malloc.Replay"),
+	TEXT("Replays a -mallocsavereplay history through the current allocator and logs the throughput. Usage: Malloc.Replay <HistoryFile> [-threads=N] [-crossthread]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&MallocReplayCommand));
+
 #endif // UE_USE_MALLOC_REPLAY_PROXY
@@ -13,6 +13,7 @@
 #include "Misc/StringBuilder.h"
 #include "Memory/MemoryArena.h"
 #include "Misc/LazySingleton.h"
+#include "Templates/AlignmentTemplates.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogIoDispatch, Log, All);
 
@@ -29,6 +30,7 @@ const TCHAR* GetIoErrorText(EIoErrorCode ErrorCode)
 		TEXT("Write Error"),
 		TEXT("Not Found"),
 		TEXT("Corrupt Toc"),
+		TEXT("Invalid Parameter"),
 	};
 
 	return ErrorCodeText[static_cast<uint32>(ErrorCode)];
@@ -199,6 +201,12 @@ FIoBuffer::BufCore::BufCore(const uint8* InData, uint64 InSize, const BufCore* I
 	SetDataAndSize(InData, InSize);
 }
 
+FIoBuffer::BufCore::BufCore(const uint8* InData, uint64 InSize, const FRefCountBase* InMemoryOwner)
+:	MemoryOwner(InMemoryOwner)
+{
+	SetDataAndSize(InData, InSize);
+}
+
 FIoBuffer::BufCore::BufCore(uint64 InSize)
 {
 	uint8* NewBuffer = reinterpret_cast<uint8*>(FMemory::Malloc(InSize));
@@ -276,6 +284,11 @@ FIoBuffer::FIoBuffer(FIoBuffer::EWrapTag, const void* Data, uint64 InSize)
 {
 }
 
+FIoBuffer::FIoBuffer(FIoBuffer::EWrapTag, const void* Data, uint64 InSize, const FRefCountBase* Owner)
+:	CorePtr(new BufCore((uint8*)Data, InSize, Owner))
+{
+}
+
 FIoBuffer::FIoBuffer(FIoBuffer::EAssumeOwnershipTag, const void* Data, uint64 InSize)
 :	CorePtr(new BufCore((uint8*)Data, InSize, /* ownership */ true))
 {
@@ -296,6 +309,9 @@ FIoBuffer::MakeOwned() const
 
 static const char TocMagicImg[] = "-==--==--==--==-";
 
+/** Alignment of chunks in the container, so the summary and bulk data in them can be used in place once mapped */
+static constexpr int64 IoStoreChunkAlignment = 16;
+
 struct FIoStoreTocHeader
 {
 	uint8	TocMagic[16];
@@ -476,6 +492,21 @@ FCompactString::Assign(const CharT* InChars)
 
 //////////////////////////////////////////////////////////////////////////
 
+/** Memory mapped container file, kept alive by the buffers FIoStoreReaderImpl::Lookup returns so it outlives unmounting */
+class FIoStoreMappedContainer : public FRefCountBase
+{
+public:
+	TUniquePtr<IMappedFileHandle>	MappedFileHandle;
+	TUniquePtr<IMappedFileRegion>	MappedRegion;
+
+	virtual ~FIoStoreMappedContainer()
+	{
+		// The region has to be unmapped before the file is closed
+		MappedRegion.Reset();
+		MappedFileHandle.Reset();
+	}
+};
+
 class FIoStoreReaderImpl
 {
 public:
@@ -495,7 +526,8 @@ public:
 			return FIoStatus(EIoErrorCode::NotFound);
 		}
 
-		return FIoBuffer(FIoBuffer::Wrap, MappedRegion->GetMappedPtr() + Entry->GetOffset(), Entry->GetLength());
+		// Views of the container buffer keep the mapping alive, so callers may hold on to them after the container is unmounted
+		return FIoBuffer(ContainerBuffer.Data() + Entry->GetOffset(), Entry->GetLength(), ContainerBuffer);
 	}
 
 private:
@@ -503,8 +535,7 @@ private:
 	FCompactString						UniqueId;
 	TMap<FIoChunkId, FIoStoreTocEntry>	Toc;
 	TUniquePtr<IFileHandle>				ContainerFileHandle;
-	TUniquePtr<IMappedFileHandle>		ContainerMappedFileHandle;
-	TUniquePtr<IMappedFileRegion>		MappedRegion;
+	FIoBuffer							ContainerBuffer;
 };
 
 FIoStatus FIoStoreReaderImpl::Open(FStringView InUniqueId)
@@ -542,14 +573,20 @@ FIoStatus FIoStoreReaderImpl::Open(FStringView InUniqueId)
 
 	const uint64 ContainerSize = ContainerFileHandle->Size();
 
-	ContainerMappedFileHandle.Reset(Ipf.OpenMapped(*ContainerFilePath));
-	MappedRegion.Reset(ContainerMappedFileHandle->MapRegion());
+	TRefCountPtr<FIoStoreMappedContainer> MappedContainer = new FIoStoreMappedContainer;
+	MappedContainer->MappedFileHandle.Reset(Ipf.OpenMapped(*ContainerFilePath));
+	if (MappedContainer->MappedFileHandle)
+	{
+		MappedContainer->MappedRegion.Reset(MappedContainer->MappedFileHandle->MapRegion());
+	}
 
-	if (!ContainerMappedFileHandle)
+	if (!MappedContainer->MappedRegion)
 	{
 		return FIoStatusBuilder(EIoErrorCode::FileOpenFailed) << TEXT("Failed to memory map IoStore container file '") << *ContainerFilePath << TEXT("'");
 	}
 
+	ContainerBuffer = FIoBuffer(FIoBuffer::Wrap, MappedContainer->MappedRegion->GetMappedPtr(), MappedContainer->MappedRegion->GetMappedSize(), MappedContainer);
+
 	// Parse TOC
 	//
 	// This should ultimately be a read-in-place operation but it looks like this for now
@@ -669,6 +706,17 @@ public:
 			return FIoStatus(EIoErrorCode::FileNotOpen, TEXT("No container file to append to"));
 		}
 
+		// Chunks start aligned so they can be used in place, see IoStoreChunkAlignment
+		const int64 Padding = Align(ContainerFileHandle->Tell(), IoStoreChunkAlignment) - ContainerFileHandle->Tell();
+		if (Padding > 0)
+		{
+			static const uint8 Zeros[IoStoreChunkAlignment] = {};
+			if (!ContainerFileHandle->Write(Zeros, Padding))
+			{
+				return FIoStatus(EIoErrorCode::WriteError, TEXT("Append failed"));
+			}
+		}
+
 		FIoStoreTocEntry TocEntry;
 
 		TocEntry.SetOffset(ContainerFileHandle->Tell());
@@ -1024,6 +1072,28 @@ public:
 		}
 	}
 
+	/** Narrows a resolved chunk to the requested range and copies it to the caller's target if there is one */
+	static TIoStatusOr<FIoBuffer> ApplyReadOptions(const FIoBuffer& Chunk, const FIoReadOptions& Options)
+	{
+		const uint64 Offset = Options.GetOffset();
+		if (Offset > Chunk.DataSize())
+		{
+			return FIoStatus(EIoErrorCode::InvalidParameter, TEXT("Read offset is past the end of the chunk"));
+		}
+		const uint64 Size = FMath::Min<uint64>(Options.GetSize(), Chunk.DataSize() - Offset);
+
+		if (void* Target = Options.GetTargetVa())
+		{
+			FMemory::Memcpy(Target, Chunk.Data() + Offset, Size);
+			return FIoBuffer(FIoBuffer::Wrap, Target, Size);
+		}
+		if (Offset == 0 && Size == Chunk.DataSize())
+		{
+			return Chunk;
+		}
+		return FIoBuffer(Chunk.Data() + Offset, Size, Chunk);
+	}
+
 	void IssueBatch(const uint32 BatchId)
 	{
 		// At this point the batch is immutable and we should start
@@ -1032,7 +1102,14 @@ public:
 		IterateBatch(BatchId, [this](FIoRequestImpl& Request) {
 			TIoStatusOr<FIoBuffer> Resolved = IoStore->Resolve(Request.ChunkId);
 
-			Request.Result = Resolved;
+			if (Resolved.IsOk())
+			{
+				Request.Result = ApplyReadOptions(Resolved.ValueOrDie(), Request.Options);
+			}
+			else
+			{
+				Request.Result = Resolved;
+			}
 
 			return true;
 		});
@@ -13,9 +13,19 @@
 #include "Misc/ICompressionFormat.h"
 
 #include "Misc/MemoryReadStream.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/SharedPointer.h"
 // #include "TargetPlatformBase.h"
 THIRD_PARTY_INCLUDES_START
 #include "ThirdParty/zlib/zlib-1.2.5/Inc/zlib.h"
+#if WITH_ZSTD
+	#include "zstd.h"
+	#include "zdict.h"
+#endif
+#if WITH_LZ4
+	#include "lz4.h"
+	#include "lz4hc.h"
+#endif
 THIRD_PARTY_INCLUDES_END
 
 DECLARE_LOG_CATEGORY_EXTERN(LogCompression, Log, All);
@@ -280,6 +290,206 @@ bool appUncompressMemoryStreamZLIB(void* UncompressedBuffer, int32 UncompressedS
 	return bOperationSucceeded;
 }
 
+#if WITH_ZSTD
+
+/** Zstd compression levels for COMPRESS_BiasSpeed, no bias and COMPRESS_BiasMemory */
+static const int32 GZstdLevelBiasSpeed = 1;
+static const int32 GZstdLevelDefault = 3;
+static const int32 GZstdLevelBiasMemory = 19;
+
+static int32 GetZstdCompressionLevel(ECompressionFlags Flags)
+{
+	return (Flags & COMPRESS_BiasSpeed) ? GZstdLevelBiasSpeed : (Flags & COMPRESS_BiasMemory) ? GZstdLevelBiasMemory : GZstdLevelDefault;
+}
+
+/** Zstd contexts are expensive to create and hold all the working memory, each thread keeps its own */
+struct FZstdContexts
+{
+	ZSTD_CCtx* CompressContext = nullptr;
+	ZSTD_DCtx* DecompressContext = nullptr;
+
+	~FZstdContexts()
+	{
+		ZSTD_freeCCtx(CompressContext);
+		ZSTD_freeDCtx(DecompressContext);
+	}
+
+	static ZSTD_CCtx* GetCompressContext()
+	{
+		FZstdContexts& Contexts = Get();
+		if (!Contexts.CompressContext)
+		{
+			Contexts.CompressContext = ZSTD_createCCtx();
+		}
+		return Contexts.CompressContext;
+	}
+
+	static ZSTD_DCtx* GetDecompressContext()
+	{
+		FZstdContexts& Contexts = Get();
+		if (!Contexts.DecompressContext)
+		{
+			Contexts.DecompressContext = ZSTD_createDCtx();
+		}
+		return Contexts.DecompressContext;
+	}
+
+private:
+	static FZstdContexts& Get()
+	{
+		static thread_local FZstdContexts Contexts;
+		return Contexts;
+	}
+};
+
+/** A dictionary registered with FCompression::RegisterZstdDictionary, digested for both directions */
+struct FZstdDictionary
+{
+	TArray<uint8> Data;
+	ZSTD_CDict* CompressDictionary = nullptr;
+	ZSTD_DDict* DecompressDictionary = nullptr;
+
+	~FZstdDictionary()
+	{
+		ZSTD_freeCDict(CompressDictionary);
+		ZSTD_freeDDict(DecompressDictionary);
+	}
+};
+
+typedef TSharedPtr<const FZstdDictionary, ESPMode::ThreadSafe> FZstdDictionaryPtr;
+
+/** Registered dictionaries by format name, shared so replacing one doesn't pull it from under threads still using it */
+static TMap<FName, FZstdDictionaryPtr> GZstdDictionaries;
+static FRWLock GZstdDictionariesLock;
+
+static FZstdDictionaryPtr FindZstdDictionary(FName FormatName)
+{
+	FRWScopeLock Lock(GZstdDictionariesLock, SLT_ReadOnly);
+	const FZstdDictionaryPtr* Dictionary = GZstdDictionaries.Find(FormatName);
+	return Dictionary ? *Dictionary : FZstdDictionaryPtr();
+}
+
+static const uint32 appZSTDVersion()
+{
+	return uint32(ZSTD_versionNumber());
+}
+
+/**
+ * Thread-safe Zstd compression, optionally with a registered dictionary.
+ *
+ * @param	Dictionary					Dictionary to compress with, nullptr for plain Zstd
+ * @param	Flags						COMPRESS_BiasSpeed and COMPRESS_BiasMemory select the compression level
+ * @return true if compression succeeds, false if CompressedBuffer was too small
+ */
+static bool appCompressMemoryZSTD(void* CompressedBuffer, int32& CompressedSize, const void* UncompressedBuffer, int32 UncompressedSize, const FZstdDictionary* Dictionary, ECompressionFlags Flags)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Compress Memory ZSTD"), STAT_appCompressMemoryZSTD, STATGROUP_Compression);
+
+	ZSTD_CCtx* Context = FZstdContexts::GetCompressContext();
+	size_t Result;
+	if (!Dictionary)
+	{
+		Result = ZSTD_compressCCtx(Context, CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize, GetZstdCompressionLevel(Flags));
+	}
+	else if (Flags & COMPRESS_BiasMemory)
+	{
+		// The digested dictionary is tied to the default level, slower levels load the raw dictionary each time
+		Result = ZSTD_compress_usingDict(Context, CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize, Dictionary->Data.GetData(), Dictionary->Data.Num(), GZstdLevelBiasMemory);
+	}
+	else
+	{
+		Result = ZSTD_compress_usingCDict(Context, CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize, Dictionary->CompressDictionary);
+	}
+
+	if (ZSTD_isError(Result))
+	{
+		UE_CLOG(ZSTD_getErrorCode(Result) != ZSTD_error_dstSize_tooSmall, LogCompression, Warning, TEXT("appCompressMemoryZSTD failed: %s"), ANSI_TO_TCHAR(ZSTD_getErrorName(Result)));
+		return false;
+	}
+	CompressedSize = (int32)Result;
+	return true;
+}
+
+static bool appUncompressMemoryZSTD(void* UncompressedBuffer, int32 UncompressedSize, const void* CompressedBuffer, int32 CompressedSize, const FZstdDictionary* Dictionary)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Uncompress Memory ZSTD"), STAT_appUncompressMemoryZSTD, STATGROUP_Compression);
+
+	ZSTD_DCtx* Context = FZstdContexts::GetDecompressContext();
+	const size_t Result = Dictionary
+		? ZSTD_decompress_usingDDict(Context, UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize, Dictionary->DecompressDictionary)
+		: ZSTD_decompressDCtx(Context, UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize);
+
+	if (ZSTD_isError(Result))
+	{
+		UE_LOG(LogCompression, Warning, TEXT("appUncompressMemoryZSTD failed: %s"), ANSI_TO_TCHAR(ZSTD_getErrorName(Result)));
+		return false;
+	}
+	if (Result != (size_t)UncompressedSize)
+	{
+		UE_LOG(LogCompression, Warning, TEXT("appUncompressMemoryZSTD failed: Mismatched uncompressed size. Expected: %d, Got:%d"), UncompressedSize, (int32)Result);
+		return false;
+	}
+	return true;
+}
+
+#endif // WITH_ZSTD
+
+#if WITH_LZ4
+
+/** LZ4 acceleration for COMPRESS_BiasSpeed, each step trades about 3% of ratio for speed */
+static const int32 GLZ4AccelerationBiasSpeed = 8;
+
+static const uint32 appLZ4Version()
+{
+	return uint32(LZ4_versionNumber());
+}
+
+/**
+ * Thread-safe LZ4 compression. COMPRESS_BiasMemory compresses with LZ4HC, which is much slower to compress but produces
+ * regular LZ4 data that uncompresses just as fast.
+ */
+static bool appCompressMemoryLZ4(void* CompressedBuffer, int32& CompressedSize, const void* UncompressedBuffer, int32 UncompressedSize, ECompressionFlags Flags)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Compress Memory LZ4"), STAT_appCompressMemoryLZ4, STATGROUP_Compression);
+
+	int32 Result;
+	if (Flags & COMPRESS_BiasMemory)
+	{
+		Result = LZ4_compress_HC((const char*)UncompressedBuffer, (char*)CompressedBuffer, UncompressedSize, CompressedSize, LZ4HC_CLEVEL_DEFAULT);
+	}
+	else if (Flags & COMPRESS_BiasSpeed)
+	{
+		Result = LZ4_compress_fast((const char*)UncompressedBuffer, (char*)CompressedBuffer, UncompressedSize, CompressedSize, GLZ4AccelerationBiasSpeed);
+	}
+	else
+	{
+		Result = LZ4_compress_default((const char*)UncompressedBuffer, (char*)CompressedBuffer, UncompressedSize, CompressedSize);
+	}
+
+	// LZ4 returns 0 when the output doesn't fit
+	if (Result <= 0)
+	{
+		return false;
+	}
+	CompressedSize = Result;
+	return true;
+}
+
+static bool appUncompressMemoryLZ4(void* UncompressedBuffer, int32 UncompressedSize, const void* CompressedBuffer, int32 CompressedSize)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Uncompress Memory LZ4"), STAT_appUncompressMemoryLZ4, STATGROUP_Compression);
+
+	const int32 Result = LZ4_decompress_safe((const char*)CompressedBuffer, (char*)UncompressedBuffer, CompressedSize, UncompressedSize);
+	if (Result != UncompressedSize)
+	{
+		UE_LOG(LogCompression, Warning, TEXT("appUncompressMemoryLZ4 failed: %s. Expected: %d, Got:%d"), Result < 0 ? TEXT("input data was corrupted or incomplete") : TEXT("Mismatched uncompressed size"), UncompressedSize, Result);
+		return false;
+	}
+	return true;
+}
+
+#endif // WITH_LZ4
+
 /** Time spent compressing data in cycles. */
 TAtomic<uint64> FCompression::CompressorTimeCycles(0);
 /** Number of bytes before compression.		*/
@@ -324,6 +534,18 @@ uint32 FCompression::GetCompressorVersion(FName FormatName)
 	{
 		return appZLIBVersion();
 	}
+#if WITH_ZSTD
+	else if (FormatName == NAME_Zstd || FindZstdDictionary(FormatName).IsValid())
+	{
+		return appZSTDVersion();
+	}
+#endif
+#if WITH_LZ4
+	else if (FormatName == NAME_LZ4)
+	{
+		return appLZ4Version();
+	}
+#endif
 	else
 	{
 		// let the format module compress it
@@ -412,6 +634,18 @@ int32 FCompression::CompressMemoryBound(FName FormatName, int32 UncompressedSize
 		// CompressionBound = deflateBound(&gzipstream, gzipstream.avail_in) + GzipHeaderLength;
 		UE_LOG(LogCompression, Fatal, TEXT("FCompression::CompressMemoryBound - GZip is not supported yet"));
 	}
+#if WITH_ZSTD
+	else if (FormatName == NAME_Zstd || FindZstdDictionary(FormatName).IsValid())
+	{
+		CompressionBound = (int32)ZSTD_compressBound(UncompressedSize);
+	}
+#endif
+#if WITH_LZ4
+	else if (FormatName == NAME_LZ4)
+	{
+		CompressionBound = LZ4_compressBound(UncompressedSize);
+	}
+#endif
 	else
 	{
 		ICompressionFormat* Format = GetCompressionFormat(FormatName);
@@ -443,13 +677,36 @@ bool FCompression::CompressMemory(FName FormatName, void* CompressedBuffer, int3
 		// hardcoded gzip
 		bCompressSucceeded = appCompressMemoryGZIP(CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize);
 	}
+#if WITH_ZSTD
+	else if (FormatName == NAME_Zstd)
+	{
+		// hardcoded zstd, CompressionData is ignored as callers pass the zlib bit window in it
+		bCompressSucceeded = appCompressMemoryZSTD(CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize, nullptr, Flags);
+	}
+#endif
+#if WITH_LZ4
+	else if (FormatName == NAME_LZ4)
+	{
+		// hardcoded lz4
+		bCompressSucceeded = appCompressMemoryLZ4(CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize, Flags);
+	}
+#endif
 	else
 	{
-		// let the format module compress it
-		ICompressionFormat* Format = GetCompressionFormat(FormatName);
-		if (Format)
+#if WITH_ZSTD
+		if (FZstdDictionaryPtr Dictionary = FindZstdDictionary(FormatName))
 		{
-			bCompressSucceeded = Format->Compress(CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize, CompressionData);
+			bCompressSucceeded = appCompressMemoryZSTD(CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize, Dictionary.Get(), Flags);
+		}
+		else
+#endif
+		{
+			// let the format module compress it
+			ICompressionFormat* Format = GetCompressionFormat(FormatName);
+			if (Format)
+			{
+				bCompressSucceeded = Format->Compress(CompressedBuffer, CompressedSize, UncompressedBuffer, UncompressedSize, CompressionData);
+			}
 		}
 	}
 
@@ -466,6 +723,8 @@ bool FCompression::CompressMemory(FName FormatName, void* CompressedBuffer, int3
 
 #define ZLIB_DERIVEDDATA_VER TEXT("9810EC9C5D34401CBD57AA3852417A6C")
 #define GZIP_DERIVEDDATA_VER TEXT("FB2181277DF44305ABBE03FD1751CBDE")
+#define ZSTD_DERIVEDDATA_VER TEXT("5C1E0B3AF5A1497C9D40B1E2A6C8F217")
+#define LZ4_DERIVEDDATA_VER TEXT("A3D6E2F4B8C14E5F9B7D0C2E8F613A49")
 
 
 FString FCompression::GetCompressorDDCSuffix(FName FormatName)
@@ -478,10 +737,23 @@ FString FCompression::GetCompressorDDCSuffix(FName FormatName)
 		// hardcoded zlib
 		DDCSuffix += ZLIB_DERIVEDDATA_VER;
 	}
-	if (FormatName == NAME_Gzip)
+	else if (FormatName == NAME_Gzip)
 	{
 		DDCSuffix += GZIP_DERIVEDDATA_VER;
 	}
+#if WITH_ZSTD
+	else if (FormatName == NAME_Zstd || FindZstdDictionary(FormatName).IsValid())
+	{
+		// dictionary formats are told apart by their name at the start of the suffix
+		DDCSuffix += ZSTD_DERIVEDDATA_VER;
+	}
+#endif
+#if WITH_LZ4
+	else if (FormatName == NAME_LZ4)
+	{
+		DDCSuffix += LZ4_DERIVEDDATA_VER;
+	}
+#endif
 	else
 	{
 		// let the format module compress it
@@ -514,13 +786,36 @@ bool FCompression::UncompressMemory(FName FormatName, void* UncompressedBuffer,
 	{
 		// @todo buh?
 	}
+#if WITH_ZSTD
+	else if (FormatName == NAME_Zstd)
+	{
+		// hardcoded zstd
+		bUncompressSucceeded = appUncompressMemoryZSTD(UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize, nullptr);
+	}
+#endif
+#if WITH_LZ4
+	else if (FormatName == NAME_LZ4)
+	{
+		// hardcoded lz4
+		bUncompressSucceeded = appUncompressMemoryLZ4(UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize);
+	}
+#endif
 	else
 	{
-		// let the format module compress it
-		ICompressionFormat* Format = GetCompressionFormat(FormatName);
-		if (Format)
+#if WITH_ZSTD
+		if (FZstdDictionaryPtr Dictionary = FindZstdDictionary(FormatName))
 		{
-			bUncompressSucceeded = Format->Uncompress(UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize, CompressionData);
+			bUncompressSucceeded = appUncompressMemoryZSTD(UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize, Dictionary.Get());
+		}
+		else
+#endif
+		{
+			// let the format module compress it
+			ICompressionFormat* Format = GetCompressionFormat(FormatName);
+			if (Format)
+			{
+				bUncompressSucceeded = Format->Uncompress(UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize, CompressionData);
+			}
 		}
 	}
 
@@ -772,6 +1067,18 @@ bool FCompression::IsFormatValid(FName FormatName)
 	{
 		return true;
 	}
+#if WITH_ZSTD
+	if (FormatName == NAME_Zstd || FindZstdDictionary(FormatName).IsValid())
+	{
+		return true;
+	}
+#endif
+#if WITH_LZ4
+	if (FormatName == NAME_LZ4)
+	{
+		return true;
+	}
+#endif
 
 	// otherwise, if we can get the format class, we are good!
 	return GetCompressionFormat(FormatName, false) != nullptr;
@@ -788,6 +1095,61 @@ bool FCompression::VerifyCompressionFlagsValid(int32 InCompressionFlags)
 	return true;
 }
 
+bool FCompression::RegisterZstdDictionary(FName FormatName, const void* Dictionary, int32 DictionarySize)
+{
+#if WITH_ZSTD
+	if (FormatName == NAME_Zlib || FormatName == NAME_Gzip || FormatName == NAME_Zstd || FormatName == NAME_LZ4 || FormatName == NAME_None)
+	{
+		UE_LOG(LogCompression, Error, TEXT("FCompression::RegisterZstdDictionary - %s is a built in format"), *FormatName.ToString());
+		return false;
+	}
+
+	TSharedPtr<FZstdDictionary, ESPMode::ThreadSafe> NewDictionary = MakeShared<FZstdDictionary, ESPMode::ThreadSafe>();
+	NewDictionary->Data.Append((const uint8*)Dictionary, DictionarySize);
+	NewDictionary->CompressDictionary = ZSTD_createCDict(NewDictionary->Data.GetData(), NewDictionary->Data.Num(), GZstdLevelDefault);
+	NewDictionary->DecompressDictionary = ZSTD_createDDict(NewDictionary->Data.GetData(), NewDictionary->Data.Num());
+	if (!NewDictionary->CompressDictionary || !NewDictionary->DecompressDictionary)
+	{
+		UE_LOG(LogCompression, Error, TEXT("FCompression::RegisterZstdDictionary - Invalid dictionary for %s"), *FormatName.ToString());
+		return false;
+	}
+
+	FRWScopeLock Lock(GZstdDictionariesLock, SLT_Write);
+	GZstdDictionaries.Add(FormatName, NewDictionary);
+	return true;
+#else
+	UE_LOG(LogCompression, Error, TEXT("FCompression::RegisterZstdDictionary - Zstd is not built in on this platform"));
+	return false;
+#endif
+}
+
+bool FCompression::TrainZstdDictionary(TArray<uint8>& OutDictionary, const TArray<TArray<uint8>>& Samples, int32 MaxDictionarySize)
+{
+#if WITH_ZSTD
+	// ZDICT wants the samples back to back
+	TArray<uint8> SampleData;
+	TArray<size_t> SampleSizes;
+	for (const TArray<uint8>& Sample : Samples)
+	{
+		SampleData.Append(Sample);
+		SampleSizes.Add(Sample.Num());
+	}
+
+	OutDictionary.SetNumUninitialized(MaxDictionarySize);
+	const size_t Result = ZDICT_trainFromBuffer(OutDictionary.GetData(), OutDictionary.Num(), SampleData.GetData(), SampleSizes.GetData(), SampleSizes.Num());
+	if (ZDICT_isError(Result))
+	{
+		UE_LOG(LogCompression, Warning, TEXT("FCompression::TrainZstdDictionary failed: %s"), ANSI_TO_TCHAR(ZDICT_getErrorName(Result)));
+		OutDictionary.Reset();
+		return false;
+	}
+	OutDictionary.SetNum((int32)Result);
+	return true;
+#else
+	return false;
+#endif
+}
+
 
 
 /***********************
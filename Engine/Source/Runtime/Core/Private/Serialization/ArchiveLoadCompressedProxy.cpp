@@ -4,6 +4,58 @@
 #include "Math/UnrealMathUtility.h"
 #include "HAL/UnrealMemory.h"
 #include "Containers/Array.h"
+#include "Async/AsyncWork.h"
+#include "HAL/PlatformProperties.h"
+#include "Serialization/CompressedChunkInfo.h"
+#include "UObject/ObjectVersion.h"
+
+extern CORE_API int32 GCompressedProxyChunksInFlight;
+
+/** Uncompresses one chunk written by FArchive::SerializeCompressed on the thread pool */
+class FUncompressProxyChunkTask : public FNonAbandonableTask
+{
+public:
+	/** Compressed data following the chunk infos, in the proxy's array.	*/
+	const uint8* CompressedBuffer;
+	/** Compressed and uncompressed size of each part of the data.			*/
+	TArray<FCompressedChunkInfo, TInlineAllocator<1>> ChunkInfos;
+	/** Uncompressed data, swapped with the proxy's temporary buffer.		*/
+	uint8* UncompressedBuffer;
+	/** Format to uncompress with.											*/
+	FName CompressionFormat;
+	/** Whether all parts were uncompressed.								*/
+	bool bSucceeded;
+
+	FUncompressProxyChunkTask()
+		: CompressedBuffer(nullptr)
+		, UncompressedBuffer(nullptr)
+		, bSucceeded(false)
+	{
+	}
+
+	~FUncompressProxyChunkTask()
+	{
+		FMemory::Free(UncompressedBuffer);
+	}
+
+	void DoWork()
+	{
+		const uint8* Src = CompressedBuffer;
+		uint8* Dest = UncompressedBuffer;
+		bSucceeded = true;
+		for (const FCompressedChunkInfo& ChunkInfo : ChunkInfos)
+		{
+			bSucceeded &= FCompression::UncompressMemory(CompressionFormat, Dest, ChunkInfo.UncompressedSize, Src, ChunkInfo.CompressedSize, COMPRESS_NoFlags);
+			Src += ChunkInfo.CompressedSize;
+			Dest += ChunkInfo.UncompressedSize;
+		}
+	}
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FUncompressProxyChunkTask, STATGROUP_ThreadPoolAsyncTasks);
+	}
+};
 
 /*----------------------------------------------------------------------------
 	FArchiveLoadCompressedProxy
@@ -25,15 +77,33 @@ FArchiveLoadCompressedProxy::FArchiveLoadCompressedProxy(const TArray<uint8>& In
 	bShouldSerializeFromArray			= false;
 	RawBytesSerialized					= 0;
 	CurrentIndex						= 0;
+	OldestAsyncChunk					= 0;
+	NumPendingAsyncChunks				= 0;
 
 	// Allocate temporary memory.
 	TmpDataStart	= (uint8*) FMemory::Malloc(LOADING_COMPRESSION_CHUNK_SIZE);
 	TmpDataEnd		= TmpDataStart + LOADING_COMPRESSION_CHUNK_SIZE;
 	TmpData			= TmpDataEnd;
+
+	if (GThreadPool && FPlatformProcess::SupportsMultithreading())
+	{
+		for (int32 Index = 0; Index < GCompressedProxyChunksInFlight; ++Index)
+		{
+			AsyncChunks.Add(MakeUnique<FAsyncTask<FUncompressProxyChunkTask>>());
+		}
+	}
 }
 
 FArchiveLoadCompressedProxy::~FArchiveLoadCompressedProxy()
 {
+	// Chunks read ahead but never asked for still write to their buffers
+	for (; NumPendingAsyncChunks > 0; NumPendingAsyncChunks--)
+	{
+		AsyncChunks[OldestAsyncChunk]->EnsureCompletion();
+		OldestAsyncChunk = (OldestAsyncChunk + 1) % AsyncChunks.Num();
+	}
+	AsyncChunks.Empty();
+
 	// Free temporary memory allocated.
 	FMemory::Free( TmpDataStart );
 	TmpDataStart	= NULL;
@@ -46,6 +116,30 @@ FArchiveLoadCompressedProxy::~FArchiveLoadCompressedProxy()
  */
 void FArchiveLoadCompressedProxy::DecompressMoreData()
 {
+	if (AsyncChunks.Num() > 0)
+	{
+		StartAsyncChunks();
+		if (NumPendingAsyncChunks > 0)
+		{
+			FAsyncTask<FUncompressProxyChunkTask>& AsyncChunk = *AsyncChunks[OldestAsyncChunk];
+			// This does the work on this thread if it hasn't been started yet
+			AsyncChunk.EnsureCompletion();
+
+			FUncompressProxyChunkTask& Task = AsyncChunk.GetTask();
+			verifyf(Task.bSucceeded, TEXT("Failed to uncompress data in %s. Check log for details."), *GetArchiveName());
+
+			// Read from the task's buffer and give it ours for a later chunk
+			Swap(Task.UncompressedBuffer, TmpDataStart);
+			TmpDataEnd	= TmpDataStart + LOADING_COMPRESSION_CHUNK_SIZE;
+			TmpData		= TmpDataStart;
+
+			OldestAsyncChunk = (OldestAsyncChunk + 1) % AsyncChunks.Num();
+			NumPendingAsyncChunks--;
+			StartAsyncChunks();
+			return;
+		}
+	}
+
 	// This will call Serialize so we need to indicate that we want to serialize from array.
 	bShouldSerializeFromArray = true;
 	SerializeCompressed( TmpDataStart, LOADING_COMPRESSION_CHUNK_SIZE /** it's ignored, but that's how much we serialize */, CompressionFormat, CompressionFlags);
@@ -54,6 +148,75 @@ void FArchiveLoadCompressedProxy::DecompressMoreData()
 	TmpData = TmpDataStart;
 }
 
+void FArchiveLoadCompressedProxy::StartAsyncChunks()
+{
+	FName ChunkCompressionFormat = CompressionFormat;
+	if (ChunkCompressionFormat == NAME_Zlib && FPlatformProperties::GetZlibReplacementFormat() != nullptr)
+	{
+		// use this platform's replacement format in case it's not zlib, as SerializeCompressed does
+		ChunkCompressionFormat = FPlatformProperties::GetZlibReplacementFormat();
+	}
+
+	// Chunk headers are read the way SerializeCompressed reads them. Anything unexpected stops reading ahead and is
+	// left for SerializeCompressed to report once the chunks before it have been read.
+	const int64 ChunkInfoSize = sizeof(FCompressedChunkInfo);
+	while (NumPendingAsyncChunks < AsyncChunks.Num() && !IsByteSwapping())
+	{
+		const int64 HeaderOffset = CurrentIndex;
+		if (HeaderOffset + 2 * ChunkInfoSize > CompressedData.Num())
+		{
+			break;
+		}
+		FCompressedChunkInfo PackageFileTag;
+		FCompressedChunkInfo Summary;
+		FMemory::Memcpy(&PackageFileTag, CompressedData.GetData() + HeaderOffset, ChunkInfoSize);
+		FMemory::Memcpy(&Summary, CompressedData.GetData() + HeaderOffset + ChunkInfoSize, ChunkInfoSize);
+		const int64 LoadingCompressionChunkSize = PackageFileTag.UncompressedSize == PACKAGE_FILE_TAG ? LOADING_COMPRESSION_CHUNK_SIZE : PackageFileTag.UncompressedSize;
+		if (PackageFileTag.CompressedSize != PACKAGE_FILE_TAG || LoadingCompressionChunkSize <= 0 || Summary.UncompressedSize < 0 || Summary.UncompressedSize > LOADING_COMPRESSION_CHUNK_SIZE)
+		{
+			break;
+		}
+
+		const int64 TotalChunkCount = (Summary.UncompressedSize + LoadingCompressionChunkSize - 1) / LoadingCompressionChunkSize;
+		const int64 ChunkInfosOffset = HeaderOffset + 2 * ChunkInfoSize;
+		const int64 CompressedOffset = ChunkInfosOffset + TotalChunkCount * ChunkInfoSize;
+		if (CompressedOffset > CompressedData.Num())
+		{
+			break;
+		}
+
+		FAsyncTask<FUncompressProxyChunkTask>& AsyncChunk = *AsyncChunks[(OldestAsyncChunk + NumPendingAsyncChunks) % AsyncChunks.Num()];
+		FUncompressProxyChunkTask& Task = AsyncChunk.GetTask();
+		Task.ChunkInfos.SetNumUninitialized((int32)TotalChunkCount);
+		FMemory::Memcpy(Task.ChunkInfos.GetData(), CompressedData.GetData() + ChunkInfosOffset, TotalChunkCount * ChunkInfoSize);
+
+		int64 NextHeaderOffset = CompressedOffset;
+		int64 UncompressedSize = 0;
+		bool bChunkInfosValid = true;
+		for (const FCompressedChunkInfo& ChunkInfo : Task.ChunkInfos)
+		{
+			bChunkInfosValid &= ChunkInfo.CompressedSize >= 0 && ChunkInfo.UncompressedSize >= 0;
+			NextHeaderOffset += ChunkInfo.CompressedSize;
+			UncompressedSize += ChunkInfo.UncompressedSize;
+		}
+		if (!bChunkInfosValid || NextHeaderOffset > CompressedData.Num() || UncompressedSize > LOADING_COMPRESSION_CHUNK_SIZE)
+		{
+			break;
+		}
+
+		if (Task.UncompressedBuffer == nullptr)
+		{
+			Task.UncompressedBuffer = (uint8*) FMemory::Malloc(LOADING_COMPRESSION_CHUNK_SIZE);
+		}
+		Task.CompressedBuffer = CompressedData.GetData() + CompressedOffset;
+		Task.CompressionFormat = ChunkCompressionFormat;
+		AsyncChunk.StartBackgroundTask();
+
+		CurrentIndex = (int32)NextHeaderOffset;
+		NumPendingAsyncChunks++;
+	}
+}
+
 /**
  * Serializes data from archive. This function is called recursively and determines where to serialize
  * from and how to do so based on internal state.
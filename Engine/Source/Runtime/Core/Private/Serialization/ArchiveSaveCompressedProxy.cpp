@@ -5,6 +5,94 @@
 #include "HAL/UnrealMemory.h"
 #include "Logging/LogMacros.h"
 #include "CoreGlobals.h"
+#include "Async/AsyncWork.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/CompressedChunkInfo.h"
+#include "UObject/ObjectVersion.h"
+
+CORE_API int32 GCompressedProxyChunksInFlight = 8;
+static FAutoConsoleVariableRef CVarCompressedProxyChunksInFlight(
+	TEXT("Compression.ProxyChunksInFlight"),
+	GCompressedProxyChunksInFlight,
+	TEXT("Number of chunks FArchiveSaveCompressedProxy and FArchiveLoadCompressedProxy compress or uncompress on the thread pool ahead of serialization,\n")
+	TEXT("0 does all the work on the serializing thread. Each chunk in flight holds up to 384 KB while saving and 128 KB while loading.\n")
+	TEXT("Applies to proxies created afterwards."),
+	ECVF_Default
+	);
+
+/**
+ * Compresses Length bytes into the same layout FArchive::SerializeCompressed writes: the package file tag, a summary,
+ * one FCompressedChunkInfo per GSavingCompressionChunkSize chunk and then the compressed chunks.
+ */
+static void CompressBlock(TArray<uint8>& OutBlock, const uint8* Src, int64 Length, FName CompressionFormat, ECompressionFlags CompressionFlags)
+{
+	const int64 ChunkSize = GSavingCompressionChunkSize;
+	const int32 NumChunks = (int32)((Length + ChunkSize - 1) / ChunkSize);
+
+	// FCompressedChunkInfo is serialized in its memory layout, so the header can be written out in one go
+	TArray<FCompressedChunkInfo, TInlineAllocator<4>> Header;
+	Header.SetNumUninitialized(NumChunks + 2);
+	Header[0].CompressedSize = PACKAGE_FILE_TAG;
+	Header[0].UncompressedSize = ChunkSize;
+	Header[1].CompressedSize = 0;
+	Header[1].UncompressedSize = Length;
+
+	const int32 HeaderSize = Header.Num() * sizeof(FCompressedChunkInfo);
+	OutBlock.Reset();
+	OutBlock.AddUninitialized(HeaderSize);
+	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+	{
+		const int32 UncompressedSize = (int32)FMath::Min(ChunkSize, Length - ChunkIndex * ChunkSize);
+		// 2 times the uncompressed size should be more than enough, as in SerializeCompressed
+		int32 CompressedSize = (int32)(2 * ChunkSize);
+		const int32 CompressedOffset = OutBlock.AddUninitialized(CompressedSize);
+		verify(FCompression::CompressMemory(CompressionFormat, OutBlock.GetData() + CompressedOffset, CompressedSize, Src + ChunkIndex * ChunkSize, UncompressedSize, CompressionFlags));
+		OutBlock.SetNum(CompressedOffset + CompressedSize, false);
+
+		Header[ChunkIndex + 2].CompressedSize = CompressedSize;
+		Header[ChunkIndex + 2].UncompressedSize = UncompressedSize;
+		Header[1].CompressedSize += CompressedSize;
+	}
+	FMemory::Memcpy(OutBlock.GetData(), Header.GetData(), HeaderSize);
+}
+
+/** Compresses one filled temporary buffer of FArchiveSaveCompressedProxy on the thread pool */
+class FCompressProxyChunkTask : public FNonAbandonableTask
+{
+public:
+	/** Uncompressed data, swapped with the proxy's temporary buffer.	*/
+	uint8* UncompressedBuffer;
+	/** Size of uncompressed data in bytes.								*/
+	int64 UncompressedSize;
+	/** Compressed block as it is written to the array.					*/
+	TArray<uint8> CompressedBlock;
+	/** Format to compress with.										*/
+	FName CompressionFormat;
+	/** Flags to control compression.									*/
+	ECompressionFlags CompressionFlags;
+
+	FCompressProxyChunkTask()
+		: UncompressedBuffer(nullptr)
+		, UncompressedSize(0)
+		, CompressionFlags(COMPRESS_NoFlags)
+	{
+	}
+
+	~FCompressProxyChunkTask()
+	{
+		FMemory::Free(UncompressedBuffer);
+	}
+
+	void DoWork()
+	{
+		CompressBlock(CompressedBlock, UncompressedBuffer, UncompressedSize, CompressionFormat, CompressionFlags);
+	}
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FCompressProxyChunkTask, STATGROUP_ThreadPoolAsyncTasks);
+	}
+};
 
 /*----------------------------------------------------------------------------
 	FArchiveSaveCompressedProxy
@@ -25,11 +113,21 @@ FArchiveSaveCompressedProxy::FArchiveSaveCompressedProxy(TArray<uint8>& InCompre
 	bShouldSerializeToArray				= false;
 	RawBytesSerialized					= 0;
 	CurrentIndex						= 0;
+	OldestAsyncChunk					= 0;
+	NumPendingAsyncChunks				= 0;
 
 	// Allocate temporary memory.
 	TmpDataStart	= (uint8*) FMemory::Malloc(LOADING_COMPRESSION_CHUNK_SIZE);
 	TmpDataEnd		= TmpDataStart + LOADING_COMPRESSION_CHUNK_SIZE;
 	TmpData			= TmpDataStart;
+
+	if (GThreadPool && FPlatformProcess::SupportsMultithreading())
+	{
+		for (int32 Index = 0; Index < GCompressedProxyChunksInFlight; ++Index)
+		{
+			AsyncChunks.Add(MakeUnique<FAsyncTask<FCompressProxyChunkTask>>());
+		}
+	}
 }
 
 /** Destructor, flushing array if needed. Also frees temporary memory. */
@@ -49,8 +147,50 @@ FArchiveSaveCompressedProxy::~FArchiveSaveCompressedProxy()
  */
 void FArchiveSaveCompressedProxy::Flush()
 {
-	if( TmpData - TmpDataStart > 0 )
+	CompressTmpData();
+	while (NumPendingAsyncChunks > 0)
 	{
+		RetireOldestChunk();
+	}
+}
+
+void FArchiveSaveCompressedProxy::CompressTmpData()
+{
+	const int64 TmpDataSize = TmpData - TmpDataStart;
+	// Byte swapping and zlib replacement formats of cooking targets are left to SerializeCompressed
+	const bool bCompressInBackground = AsyncChunks.Num() > 0 && !IsByteSwapping() && CookingTarget() == nullptr;
+	if (TmpDataSize > 0 && bCompressInBackground)
+	{
+		// Chunks are reused round robin, wait for the one that was started longest ago if all are busy
+		if (NumPendingAsyncChunks == AsyncChunks.Num())
+		{
+			RetireOldestChunk();
+		}
+		FAsyncTask<FCompressProxyChunkTask>& AsyncChunk = *AsyncChunks[(OldestAsyncChunk + NumPendingAsyncChunks) % AsyncChunks.Num()];
+		FCompressProxyChunkTask& Task = AsyncChunk.GetTask();
+
+		// Hand the filled buffer to the task and carry on in the one it used last time
+		Swap(Task.UncompressedBuffer, TmpDataStart);
+		if (TmpDataStart == nullptr)
+		{
+			TmpDataStart = (uint8*) FMemory::Malloc(LOADING_COMPRESSION_CHUNK_SIZE);
+		}
+		TmpDataEnd	= TmpDataStart + LOADING_COMPRESSION_CHUNK_SIZE;
+		TmpData		= TmpDataStart;
+
+		Task.UncompressedSize	= TmpDataSize;
+		Task.CompressionFormat	= CompressionFormat;
+		Task.CompressionFlags	= CompressionFlags;
+		AsyncChunk.StartBackgroundTask();
+		NumPendingAsyncChunks++;
+	}
+	else if( TmpDataSize > 0 )
+	{
+		// Chunks go to the array in order
+		while (NumPendingAsyncChunks > 0)
+		{
+			RetireOldestChunk();
+		}
 		// This will call Serialize so we need to indicate that we want to serialize to array.
 		bShouldSerializeToArray = true;
 		SerializeCompressed( TmpDataStart, TmpData - TmpDataStart, CompressionFormat, CompressionFlags);
@@ -60,6 +200,23 @@ void FArchiveSaveCompressedProxy::Flush()
 	}
 }
 
+void FArchiveSaveCompressedProxy::RetireOldestChunk()
+{
+	check(NumPendingAsyncChunks > 0);
+	FAsyncTask<FCompressProxyChunkTask>& AsyncChunk = *AsyncChunks[OldestAsyncChunk];
+	// This does the work on this thread if it hasn't been started yet
+	AsyncChunk.EnsureCompletion();
+
+	FCompressProxyChunkTask& Task = AsyncChunk.GetTask();
+	bShouldSerializeToArray = true;
+	Serialize(Task.CompressedBlock.GetData(), Task.CompressedBlock.Num());
+	bShouldSerializeToArray = false;
+	Task.UncompressedSize = 0;
+
+	OldestAsyncChunk = (OldestAsyncChunk + 1) % AsyncChunks.Num();
+	NumPendingAsyncChunks--;
+}
+
 /**
  * Serializes data to archive. This function is called recursively and determines where to serialize
  * to and how to do so based on internal state.
@@ -101,9 +258,9 @@ void FArchiveSaveCompressedProxy::Serialize( void* InData, int64 Count )
 			// Tmp buffer fully exhausted, compress it.
 			else
 			{
-				// Flush existing data to array after compressing it. This will call Serialize again 
-				// so we need to handle recursion.
-				Flush();
+				// Flush existing data to array after compressing it, or start compressing it in the background.
+				// This will call Serialize again so we need to handle recursion.
+				CompressTmpData();
 			}
 		}
 	}
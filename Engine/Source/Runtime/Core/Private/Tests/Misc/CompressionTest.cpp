@@ -0,0 +1,204 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+#include "Misc/Compression.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/ArchiveLoadCompressedProxy.h"
+#include "Serialization/ArchiveSaveCompressedProxy.h"
+
+extern CORE_API int32 GCompressedProxyChunksInFlight;
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CompressionTest
+{
+	/** Text-like data with enough repetition to compress, different for each seed */
+	static TArray<uint8> MakeTestData(int32 Size, uint32 Seed)
+	{
+		static const char* const Words[] = { "Actor", "Component", "Transform", "Material", "Texture2D", "StaticMesh", "Blueprint", "Package", " ", "/Game/", "." };
+
+		TArray<uint8> Data;
+		Data.Reserve(Size);
+		while (Data.Num() < Size)
+		{
+			Seed = Seed * 196314165 + 907633515;
+			const char* Word = Words[(Seed >> 16) % ARRAY_COUNT(Words)];
+			for (; *Word && Data.Num() < Size; ++Word)
+			{
+				Data.Add((uint8)*Word);
+			}
+			Data.Add((uint8)(Seed >> 28));
+		}
+		Data.SetNum(Size);
+		return Data;
+	}
+
+	static bool RoundTrip(FAutomationTestBase& Test, FName FormatName, const TArray<uint8>& Data, ECompressionFlags Flags)
+	{
+		const FString What = FString::Printf(TEXT("%s (flags %d, %d bytes)"), *FormatName.ToString(), (int32)Flags, Data.Num());
+
+		TArray<uint8> Compressed;
+		int32 CompressedSize = FCompression::CompressMemoryBound(FormatName, Data.Num(), Flags);
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (!Test.TestTrue(FString::Printf(TEXT("Compress %s"), *What), FCompression::CompressMemory(FormatName, Compressed.GetData(), CompressedSize, Data.GetData(), Data.Num(), Flags)))
+		{
+			return false;
+		}
+		Test.TestTrue(FString::Printf(TEXT("Compressed size of %s is within the bound"), *What), CompressedSize <= Compressed.Num());
+
+		TArray<uint8> Uncompressed;
+		Uncompressed.SetNumZeroed(Data.Num());
+		if (!Test.TestTrue(FString::Printf(TEXT("Uncompress %s"), *What), FCompression::UncompressMemory(FormatName, Uncompressed.GetData(), Uncompressed.Num(), Compressed.GetData(), CompressedSize, Flags)))
+		{
+			return false;
+		}
+		return Test.TestTrue(FString::Printf(TEXT("Round trip of %s"), *What), Uncompressed == Data);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCompressionFormatsTest, "System.Core.Misc.Compression.Formats", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FCompressionFormatsTest::RunTest(const FString& Parameters)
+{
+	TArray<FName> FormatNames;
+	FormatNames.Add(NAME_Zlib);
+#if WITH_ZSTD
+	FormatNames.Add(NAME_Zstd);
+#endif
+#if WITH_LZ4
+	FormatNames.Add(NAME_LZ4);
+#endif
+
+	const ECompressionFlags AllFlags[] = { COMPRESS_NoFlags, COMPRESS_BiasSpeed, COMPRESS_BiasMemory };
+	const int32 Sizes[] = { 1, 1000, 64 * 1024, LOADING_COMPRESSION_CHUNK_SIZE };
+	for (FName FormatName : FormatNames)
+	{
+		TestTrue(FString::Printf(TEXT("%s is valid"), *FormatName.ToString()), FCompression::IsFormatValid(FormatName));
+		for (ECompressionFlags Flags : AllFlags)
+		{
+			for (int32 Size : Sizes)
+			{
+				CompressionTest::RoundTrip(*this, FormatName, CompressionTest::MakeTestData(Size, Size), Flags);
+			}
+		}
+	}
+
+#if WITH_ZSTD
+	// Too small an output buffer must fail rather than write past it
+	{
+		TArray<uint8> Data = CompressionTest::MakeTestData(64 * 1024, 1);
+		TArray<uint8> Compressed;
+		Compressed.SetNumUninitialized(16);
+		int32 CompressedSize = Compressed.Num();
+		TestFalse(TEXT("Compressing Zstd into too small a buffer fails"), FCompression::CompressMemory(NAME_Zstd, Compressed.GetData(), CompressedSize, Data.GetData(), Data.Num()));
+	}
+#endif
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCompressionProxyTest, "System.Core.Misc.Compression.Proxy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FCompressionProxyTest::RunTest(const FString& Parameters)
+{
+	// Several chunks with a short one at the end, written in pieces that straddle chunk boundaries
+	TArray<uint8> Data = CompressionTest::MakeTestData(5 * LOADING_COMPRESSION_CHUNK_SIZE + 1234, 7);
+	const int32 PieceSize = 10000;
+
+	const int32 PreviousChunksInFlight = GCompressedProxyChunksInFlight;
+	TArray<uint8> SerialCompressedData;
+	for (int32 ChunksInFlight : { 0, 1, 3 })
+	{
+		GCompressedProxyChunksInFlight = ChunksInFlight;
+
+		TArray<uint8> CompressedData;
+		{
+			FArchiveSaveCompressedProxy SaveProxy(CompressedData, NAME_Zlib);
+			for (int32 Offset = 0; Offset < Data.Num(); Offset += PieceSize)
+			{
+				SaveProxy.Serialize(Data.GetData() + Offset, FMath::Min(PieceSize, Data.Num() - Offset));
+			}
+			TestEqual(FString::Printf(TEXT("Tell after saving, %d chunks in flight"), ChunksInFlight), SaveProxy.Tell(), (int64)Data.Num());
+		}
+		if (ChunksInFlight == 0)
+		{
+			SerialCompressedData = CompressedData;
+		}
+		else
+		{
+			TestTrue(FString::Printf(TEXT("Compressed data with %d chunks in flight matches compressing on the calling thread"), ChunksInFlight), CompressedData == SerialCompressedData);
+		}
+
+		TArray<uint8> Uncompressed;
+		Uncompressed.SetNumZeroed(Data.Num());
+		{
+			FArchiveLoadCompressedProxy LoadProxy(CompressedData, NAME_Zlib);
+			for (int32 Offset = 0; Offset < Data.Num(); Offset += PieceSize)
+			{
+				LoadProxy.Serialize(Uncompressed.GetData() + Offset, FMath::Min(PieceSize, Data.Num() - Offset));
+			}
+		}
+		TestTrue(FString::Printf(TEXT("Round trip with %d chunks in flight"), ChunksInFlight), Uncompressed == Data);
+
+		// Loading stops part way through with chunks read ahead
+		{
+			FArchiveLoadCompressedProxy LoadProxy(CompressedData, NAME_Zlib);
+			LoadProxy.Seek(LOADING_COMPRESSION_CHUNK_SIZE + 10);
+			uint8 Byte = 0;
+			LoadProxy << Byte;
+			TestEqual(FString::Printf(TEXT("Seek with %d chunks in flight"), ChunksInFlight), Byte, Data[LOADING_COMPRESSION_CHUNK_SIZE + 10]);
+		}
+	}
+	GCompressedProxyChunksInFlight = PreviousChunksInFlight;
+
+	return true;
+}
+
+#if WITH_ZSTD
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCompressionZstdDictionaryTest, "System.Core.Misc.Compression.ZstdDictionary", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FCompressionZstdDictionaryTest::RunTest(const FString& Parameters)
+{
+	TArray<TArray<uint8>> Samples;
+	for (int32 Index = 0; Index < 1000; ++Index)
+	{
+		Samples.Add(CompressionTest::MakeTestData(1024, Index));
+	}
+
+	TArray<uint8> Dictionary;
+	if (!TestTrue(TEXT("Train a dictionary"), FCompression::TrainZstdDictionary(Dictionary, Samples, 16 * 1024)))
+	{
+		return false;
+	}
+	TestTrue(TEXT("Dictionary size is within the maximum"), Dictionary.Num() > 0 && Dictionary.Num() <= 16 * 1024);
+
+	const FName FormatName(TEXT("Zstd_CompressionTest"));
+	TestFalse(TEXT("Built in formats can't be replaced by a dictionary"), FCompression::RegisterZstdDictionary(NAME_Zstd, Dictionary.GetData(), Dictionary.Num()));
+	if (!TestTrue(TEXT("Register the dictionary"), FCompression::RegisterZstdDictionary(FormatName, Dictionary.GetData(), Dictionary.Num())))
+	{
+		return false;
+	}
+	TestTrue(TEXT("Dictionary format is valid"), FCompression::IsFormatValid(FormatName));
+
+	const TArray<uint8> Data = CompressionTest::MakeTestData(1024, 5000);
+	CompressionTest::RoundTrip(*this, FormatName, Data, COMPRESS_NoFlags);
+	CompressionTest::RoundTrip(*this, FormatName, Data, COMPRESS_BiasMemory);
+
+	// Small buffers are what dictionaries are for
+	int32 PlainSize = FCompression::CompressMemoryBound(NAME_Zstd, Data.Num());
+	int32 DictionarySize = PlainSize;
+	TArray<uint8> Compressed;
+	Compressed.SetNumUninitialized(PlainSize);
+	FCompression::CompressMemory(NAME_Zstd, Compressed.GetData(), PlainSize, Data.GetData(), Data.Num());
+	FCompression::CompressMemory(FormatName, Compressed.GetData(), DictionarySize, Data.GetData(), Data.Num());
+	TestTrue(FString::Printf(TEXT("Dictionary compresses a small buffer better (%d vs %d bytes)"), DictionarySize, PlainSize), DictionarySize < PlainSize);
+
+	return true;
+}
+
+#endif // WITH_ZSTD
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,243 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+#include "Containers/Map.h"
+#include "Containers/FlatMap.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlatMapTest, "System.Core.Misc.FlatMap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FFlatMapTest::RunTest(const FString& Parameters)
+{
+	// empty map
+	{
+		TFlatMap<int32, int32> Map;
+
+		TestEqual(TEXT("Newly created maps must have zero elements"), Map.Num(), 0);
+		TestNull(TEXT("Find must fail on an empty map"), Map.Find(42));
+		TestEqual(TEXT("Remove must fail on an empty map"), Map.Remove(42), 0);
+		TestTrue(TEXT("Iterating an empty map must visit nothing"), !Map.CreateConstIterator());
+	}
+
+	// add, replace and find
+	{
+		TFlatMap<int32, FString> Map;
+
+		Map.Add(1, TEXT("One"));
+		Map.Add(2, TEXT("Two"));
+		TestEqual(TEXT("Adding distinct keys must add elements"), Map.Num(), 2);
+
+		Map.Add(1, TEXT("Uno"));
+		TestEqual(TEXT("Adding an existing key must not add an element"), Map.Num(), 2);
+		TestEqual(TEXT("Adding an existing key must replace the value"), Map.FindRef(1), FString(TEXT("Uno")));
+
+		FString& Added = Map.FindOrAdd(3);
+		TestTrue(TEXT("FindOrAdd must default construct new values"), Added.IsEmpty());
+		Added = TEXT("Three");
+		TestEqual(TEXT("FindOrAdd must return existing values"), Map.FindOrAdd(3), FString(TEXT("Three")));
+		TestEqual(TEXT("FindOrAdd on an existing key must not add an element"), Map.Num(), 3);
+
+		TestTrue(TEXT("Contains must find added keys"), Map.Contains(2));
+		TestFalse(TEXT("Contains must not find missing keys"), Map.Contains(4));
+		TestEqual(TEXT("FindChecked must return the value"), Map.FindChecked(2), FString(TEXT("Two")));
+	}
+
+	// growth, removal and tombstone reuse across many elements
+	{
+		const int32 NumElements = 10000;
+		TFlatMap<int32, int32> Map;
+
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			Map.Add(Index, Index * 3);
+		}
+		TestEqual(TEXT("All elements must be added"), Map.Num(), NumElements);
+
+		bool bAllFound = true;
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			const int32* Value = Map.Find(Index);
+			bAllFound &= Value && *Value == Index * 3;
+		}
+		TestTrue(TEXT("All elements must be found with their values"), bAllFound);
+
+		for (int32 Index = 0; Index < NumElements; Index += 2)
+		{
+			Map.Remove(Index);
+		}
+		TestEqual(TEXT("Removing half the elements must halve the count"), Map.Num(), NumElements / 2);
+
+		bool bRemovedCorrectly = true;
+		for (int32 Index = 0; Index < NumElements; ++Index)
+		{
+			bRemovedCorrectly &= Map.Contains(Index) == ((Index & 1) != 0);
+		}
+		TestTrue(TEXT("Only the removed elements must be missing"), bRemovedCorrectly);
+
+		// churn through tombstones without growing the element count
+		const uint32 AllocatedSizeBefore = Map.GetAllocatedSize();
+		for (int32 Round = 0; Round < 8; ++Round)
+		{
+			for (int32 Index = 0; Index < NumElements; Index += 2)
+			{
+				Map.Add(Index + NumElements * (Round + 1), Round);
+				Map.Remove(Index + NumElements * (Round + 1));
+			}
+		}
+		TestEqual(TEXT("Churn must not change the element count"), Map.Num(), NumElements / 2);
+		TestEqual(TEXT("Churn must reuse deleted slots instead of growing"), Map.GetAllocatedSize(), AllocatedSizeBefore);
+
+		int32 Visited = 0;
+		int64 KeySum = 0;
+		for (const TPair<int32, int32>& Pair : Map)
+		{
+			++Visited;
+			KeySum += Pair.Key;
+		}
+		TestEqual(TEXT("Iteration must visit every element once"), Visited, NumElements / 2);
+		TestEqual(TEXT("Iteration must visit the right elements"), KeySum, (int64)(NumElements / 2) * (NumElements / 2));
+
+		for (TFlatMap<int32, int32>::TIterator It = Map.CreateIterator(); It; ++It)
+		{
+			if (It.Key() % 3 == 0)
+			{
+				It.RemoveCurrent();
+			}
+		}
+		bool bNoMultiplesOfThree = true;
+		for (const TPair<int32, int32>& Pair : Map)
+		{
+			bNoMultiplesOfThree &= Pair.Key % 3 != 0;
+		}
+		TestTrue(TEXT("RemoveCurrent must remove elements while iterating"), bNoMultiplesOfThree);
+	}
+
+	// copy, move and conversion from TMap
+	{
+		TMap<FString, int32> Source;
+		Source.Add(TEXT("A"), 1);
+		Source.Add(TEXT("B"), 2);
+
+		TFlatMap<FString, int32> Map(Source);
+		TestEqual(TEXT("Converting from TMap must copy all pairs"), Map.Num(), 2);
+		TestEqual(TEXT("Converting from TMap must copy the values"), Map.FindRef(TEXT("B")), 2);
+
+		TFlatMap<FString, int32> Copy = Map;
+		Copy.Add(TEXT("C"), 3);
+		TestEqual(TEXT("Copies must be independent"), Map.Num(), 2);
+
+		TFlatMap<FString, int32> Moved = MoveTemp(Copy);
+		TestEqual(TEXT("Moving must take all pairs"), Moved.Num(), 3);
+		TestEqual(TEXT("Moving must leave the source empty"), Copy.Num(), 0);
+
+		int32 Removed = 0;
+		TestTrue(TEXT("RemoveAndCopyValue must find the key"), Moved.RemoveAndCopyValue(TEXT("C"), Removed));
+		TestEqual(TEXT("RemoveAndCopyValue must return the value"), Removed, 3);
+		TestFalse(TEXT("RemoveAndCopyValue must remove the key"), Moved.Contains(TEXT("C")));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlatMapBenchmark, "System.Core.Misc.FlatMapBenchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+namespace FlatMapBenchmark_Private
+{
+	struct FTimings
+	{
+		double Insert = 0.0;
+		double FindHit = 0.0;
+		double FindMiss = 0.0;
+		double Iterate = 0.0;
+		double Erase = 0.0;
+	};
+
+	template <typename MapType>
+	FTimings Run(const TArray<uint64>& Keys, const TArray<uint64>& MissingKeys, uint64& OutChecksum)
+	{
+		FTimings Timings;
+		MapType Map;
+
+		double StartTime = FPlatformTime::Seconds();
+		for (uint64 Key : Keys)
+		{
+			Map.Add(Key, Key);
+		}
+		Timings.Insert = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (uint64 Key : Keys)
+		{
+			OutChecksum += *Map.Find(Key);
+		}
+		Timings.FindHit = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (uint64 Key : MissingKeys)
+		{
+			OutChecksum += Map.Find(Key) != nullptr;
+		}
+		Timings.FindMiss = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (const auto& Pair : Map)
+		{
+			OutChecksum += Pair.Value;
+		}
+		Timings.Iterate = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (uint64 Key : Keys)
+		{
+			Map.Remove(Key);
+		}
+		Timings.Erase = FPlatformTime::Seconds() - StartTime;
+
+		return Timings;
+	}
+}
+
+bool FFlatMapBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace FlatMapBenchmark_Private;
+
+	const int32 Sizes[] = { 1000, 10000, 100000, 1000000, 10000000 };
+
+	for (int32 Size : Sizes)
+	{
+		FRandomStream Random(Size);
+		TArray<uint64> Keys;
+		TArray<uint64> MissingKeys;
+		Keys.Reserve(Size);
+		MissingKeys.Reserve(Size);
+		for (int32 Index = 0; Index < Size; ++Index)
+		{
+			// odd keys are present, even keys are missing
+			const uint64 Key = ((uint64)Random.GetUnsignedInt() << 32) | Random.GetUnsignedInt();
+			Keys.Add(Key | 1);
+			MissingKeys.Add(Key & ~1ull);
+		}
+
+		uint64 Checksum = 0;
+		const FTimings SetTimings = Run<TMap<uint64, uint64>>(Keys, MissingKeys, Checksum);
+		const FTimings FlatTimings = Run<TFlatMap<uint64, uint64>>(Keys, MissingKeys, Checksum);
+
+		const double ToNs = 1.0e9 / Size;
+		AddInfo(FString::Printf(TEXT("%9d elements, ns/op TMap vs TFlatMap: insert %6.1f / %6.1f, find hit %6.1f / %6.1f, find miss %6.1f / %6.1f, iterate %6.1f / %6.1f, erase %6.1f / %6.1f (checksum %llu)"),
+			Size,
+			SetTimings.Insert * ToNs, FlatTimings.Insert * ToNs,
+			SetTimings.FindHit * ToNs, FlatTimings.FindHit * ToNs,
+			SetTimings.FindMiss * ToNs, FlatTimings.FindMiss * ToNs,
+			SetTimings.Iterate * ToNs, FlatTimings.Iterate * ToNs,
+			SetTimings.Erase * ToNs, FlatTimings.Erase * ToNs,
+			Checksum));
+	}
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -23,6 +23,12 @@
 #include "HAL/IConsoleManager.h"
 #include "HAL/LowLevelMemTracker.h"
 #include "Hash/CityHash.h"
+#include "Containers/ArrayView.h"
+#include "Misc/StringView.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
 
 // Page protection to catch FNameEntry stomps
 #ifndef FNAME_WRITE_PROTECT_PAGES
@@ -248,6 +254,20 @@ struct FNameSlot
 	bool operator==(FNameSlot Rhs) const { return IdAndHash == Rhs.IdAndHash; }
 
 	bool Used() const { return !!IdAndHash;  }
+
+	/** Slots are written under the shard lock but read without it, see FNamePoolShard::Find() */
+	static FNameSlot LoadAcquire(const FNameSlot& Slot)
+	{
+		FNameSlot Out;
+		Out.IdAndHash = static_cast<uint32>(FPlatformAtomics::AtomicRead(reinterpret_cast<volatile const int32*>(&Slot.IdAndHash)));
+		return Out;
+	}
+
+	void StoreRelease(FNameSlot NewValue)
+	{
+		FPlatformAtomics::AtomicStore(reinterpret_cast<volatile int32*>(&IdAndHash), static_cast<int32>(NewValue.IdAndHash));
+	}
+
 private:
 	uint32 IdAndHash = 0;
 };
@@ -511,6 +531,33 @@ FORCENOINLINE FNameHash HashLowerCase(const CharType* Str, uint32 Len)
 	return FNameHash(LowerStr, Len);
 }
 
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+/** Lowercases 16 characters at a time, same result as TChar<ANSICHAR>::ToLower() */
+template<>
+FORCENOINLINE FNameHash HashLowerCase(const ANSICHAR* Str, uint32 Len)
+{
+	alignas(16) ANSICHAR LowerStr[NAME_SIZE];
+
+	// Characters >= 0x80 are negative and never match the A-Z range
+	const __m128i BeforeA = _mm_set1_epi8('A' - 1);
+	const __m128i AfterZ = _mm_set1_epi8('Z' + 1);
+	const __m128i CaseBit = _mm_set1_epi8('a' - 'A');
+
+	uint32 I = 0;
+	for (; I + 16 <= Len; I += 16)
+	{
+		__m128i Chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Str + I));
+		__m128i IsUpper = _mm_and_si128(_mm_cmpgt_epi8(Chars, BeforeA), _mm_cmplt_epi8(Chars, AfterZ));
+		_mm_store_si128(reinterpret_cast<__m128i*>(LowerStr + I), _mm_or_si128(Chars, _mm_and_si128(IsUpper, CaseBit)));
+	}
+	for (; I < Len; ++I)
+	{
+		LowerStr[I] = TChar<ANSICHAR>::ToLower(Str[I]);
+	}
+	return FNameHash(LowerStr, Len);
+}
+#endif
+
 template<ENameCase Sensitivity>
 FNameHash HashName(FNameStringView Name);
 
@@ -552,32 +599,45 @@ public:
 		LLM_SCOPE(ELLMTag::FName);
 		Entries = &InEntries;
 
-		Slots = (FNameSlot*)FMemory::Malloc(FNamePoolInitialSlotsPerShard * sizeof(FNameSlot), alignof(FNameSlot));
-		memset(Slots, 0, FNamePoolInitialSlotsPerShard * sizeof(FNameSlot));
-		CapacityMask = FNamePoolInitialSlotsPerShard - 1;
+		FNameSlot* InitialSlots = (FNameSlot*)FMemory::Malloc(FNamePoolInitialSlotsPerShard * sizeof(FNameSlot), alignof(FNameSlot));
+		memset(InitialSlots, 0, FNamePoolInitialSlotsPerShard * sizeof(FNameSlot));
+		Slots.Store(InitialSlots);
+		CapacityMask.Store(FNamePoolInitialSlotsPerShard - 1);
 	}
 
 	// This and ~FNamePool() is not called during normal shutdown
 	// but only via explicit FName::TearDown() call
 	~FNamePoolShardBase()
 	{
-		FMemory::Free(Slots);
+		FMemory::Free(Slots.Load());
+		for (FNameSlot* Retired : RetiredSlots)
+		{
+			FMemory::Free(Retired);
+		}
+		RetiredSlots.Empty();
 		UsedSlots = 0;
-		CapacityMask = 0;
-		Slots = nullptr;
+		CapacityMask.Store(0);
+		Slots.Store(nullptr);
 	}
 
-	uint32 Capacity() const { return CapacityMask + 1; }
+	uint32 Capacity() const { return CapacityMask.Load(EMemoryOrder::Relaxed) + 1; }
 
 protected:
 	enum { LoadFactorQuotient = 9, LoadFactorDivisor = 10 }; // I.e. realloc slots when 90% full
 
+	/** Only taken by writers, Find() probes without it */
 	mutable FRWLock Lock;
 	uint32 UsedSlots = 0;
-	uint32 CapacityMask = 0;
-	FNameSlot* Slots = nullptr;
+	TAtomic<uint32> CapacityMask { 0 };
+	TAtomic<FNameSlot*> Slots { nullptr };
 	FNameEntryAllocator* Entries = nullptr;
 
+	/**
+	 * Slot arrays replaced by Grow(). Lock-free readers may still be probing them, so they are kept
+	 * until the pool is torn down. Since capacity doubles, this at most doubles slot memory.
+	 */
+	TArray<FNameSlot*> RetiredSlots;
+
 
 	template<ENameCase Sensitivity>
 	FORCEINLINE static bool EntryEqualsValue(const FNameEntry& Entry, const FNameValue<Sensitivity>& Value)
@@ -590,15 +650,38 @@ template<ENameCase Sensitivity>
 class FNamePoolShard : public FNamePoolShardBase
 {
 public:
+	/**
+	 * Finds an existing entry without taking the lock.
+	 *
+	 * Slots are published after their entry has been written and replaced slot arrays stay alive,
+	 * so a reader racing with Insert() or Grow() either sees a complete entry or nothing.
+	 */
 	FNameEntryId Find(const FNameValue<Sensitivity>& Value) const
 	{
-		FRWScopeLock _(Lock, FRWScopeLockType::SLT_ReadOnly);
-
-		return Probe(Value).GetId();
+		// Grow() publishes new slots before the new mask, so loading the mask first never lets us
+		// index past the end of the slots we load. A mask that changed while probing means we may
+		// have probed new slots from the wrong start index, in which case a miss is retried.
+		uint32 Mask = CapacityMask.Load();
+		while (true)
+		{
+			const FNameSlot Slot = ProbeLockFree(Slots.Load(), Mask, Value);
+			const uint32 NewMask = CapacityMask.Load();
+			if (Slot.Used() || NewMask == Mask)
+			{
+				return Slot.GetId();
+			}
+			Mask = NewMask;
+		}
 	}
 
 	FNameEntryId Insert(const FNameValue<Sensitivity>& Value, bool& bCreatedNewEntry)
 	{
+		// Most names already exist, avoid the write lock for them
+		if (FNameEntryId Existing = Find(Value))
+		{
+			return Existing;
+		}
+
 		FRWScopeLock _(Lock, FRWScopeLockType::SLT_Write);
 
 		FNameSlot& Slot = Probe(Value);
@@ -617,6 +700,56 @@ public:
 		return NewEntryId;
 	}
 
+	/**
+	 * Inserts values that all belong to this shard, taking the lock at most once.
+	 *
+	 * @param Values			Array of values indexed by Indices
+	 * @param Indices			Indices of the values to insert
+	 * @param Num				Number of indices
+	 * @param OutIds			Receives the entry id of each value, indexed like Values
+	 * @param OutCreatedNewEntry Set for each value that created a new entry, indexed like Values
+	 */
+	void InsertBatch(const FNameValue<Sensitivity>* Values, const int32* Indices, int32 Num, FNameEntryId* OutIds, bool* OutCreatedNewEntry)
+	{
+		bool bAllFound = true;
+		for (int32 I = 0; I < Num; ++I)
+		{
+			const int32 Index = Indices[I];
+			OutIds[Index] = Find(Values[Index]);
+			bAllFound &= !!OutIds[Index];
+		}
+
+		if (bAllFound)
+		{
+			return;
+		}
+
+		FRWScopeLock _(Lock, FRWScopeLockType::SLT_Write);
+
+		for (int32 I = 0; I < Num; ++I)
+		{
+			const int32 Index = Indices[I];
+			if (OutIds[Index])
+			{
+				continue;
+			}
+
+			const FNameValue<Sensitivity>& Value = Values[Index];
+			FNameSlot& Slot = Probe(Value);
+			if (Slot.Used())
+			{
+				// Inserted concurrently, by an earlier duplicate in this batch or "None"
+				OutIds[Index] = Slot.GetId();
+				continue;
+			}
+
+			FNameEntryId NewEntryId = Entries->Create(Value.Name, Value.ComparisonId, Value.Hash.EntryProbeHeader);
+			ClaimSlot(Slot, FNameSlot(NewEntryId, Value.Hash.SlotProbeHash));
+			OutIds[Index] = NewEntryId;
+			OutCreatedNewEntry[Index] = true;
+		}
+	}
+
 	void InsertExistingEntry(FNameHash Hash, FNameEntryId ExistingId)
 	{
 		FNameSlot NewLookup(ExistingId, Hash.SlotProbeHash);
@@ -633,7 +766,7 @@ public:
 private:
 	void ClaimSlot(FNameSlot& UnusedSlot, FNameSlot NewValue)
 	{
-		UnusedSlot = NewValue;
+		UnusedSlot.StoreRelease(NewValue);
 
 		++UsedSlots;
 		if (UsedSlots * LoadFactorDivisor >= LoadFactorQuotient * Capacity())
@@ -645,32 +778,36 @@ private:
 	void Grow()
 	{
 		LLM_SCOPE(ELLMTag::FName);
-		FNameSlot* const OldSlots = Slots;
+		FNameSlot* const OldSlots = Slots.Load(EMemoryOrder::Relaxed);
 		const uint32 OldUsedSlots = UsedSlots;
 		const uint32 OldCapacity = Capacity();
 		const uint32 NewCapacity = OldCapacity * 2;
+		const uint32 NewMask = NewCapacity - 1;
 
-		Slots = (FNameSlot*)FMemory::Malloc(NewCapacity * sizeof(FNameSlot), alignof(FNameSlot));
-		memset(Slots, 0, NewCapacity * sizeof(FNameSlot));
-		UsedSlots = 0;
-		CapacityMask = NewCapacity - 1;
-
+		FNameSlot* const NewSlots = (FNameSlot*)FMemory::Malloc(NewCapacity * sizeof(FNameSlot), alignof(FNameSlot));
+		memset(NewSlots, 0, NewCapacity * sizeof(FNameSlot));
+		uint32 NewUsedSlots = 0;
 
+		// Fill the new slots before publishing them to lock-free readers
 		for (uint32 OldIdx = 0; OldIdx < OldCapacity; ++OldIdx)
 		{
 			const FNameSlot& OldSlot = OldSlots[OldIdx];
 			if (OldSlot.Used())
 			{
 				FNameHash Hash = Rehash(OldSlot.GetId());
-				FNameSlot& NewSlot = Probe(Hash.UnmaskedSlotIndex, [](FNameSlot Slot) { return false; });
+				FNameSlot& NewSlot = Probe(NewSlots, NewMask, Hash.UnmaskedSlotIndex, [](FNameSlot Slot) { return false; });
 				NewSlot = OldSlot;
-				++UsedSlots;
+				++NewUsedSlots;
 			}
 		}
 
-		check(OldUsedSlots == UsedSlots);
+		check(OldUsedSlots == NewUsedSlots);
 
-		FMemory::Free(OldSlots);
+		// Publish slots before mask, see Find()
+		Slots.Store(NewSlots);
+		CapacityMask.Store(NewMask);
+
+		RetiredSlots.Add(OldSlots);
 	}
 
 	/** Find slot containing value or the first free slot that should be used to store it  */
@@ -685,10 +822,15 @@ private:
 	template<class PredicateFn>
 	FNameSlot& Probe(uint32 UnmaskedSlotIndex, PredicateFn Predicate) const
 	{
-		const uint32 Mask = CapacityMask;
+		return Probe(Slots.Load(EMemoryOrder::Relaxed), CapacityMask.Load(EMemoryOrder::Relaxed), UnmaskedSlotIndex, Predicate);
+	}
+
+	template<class PredicateFn>
+	static FNameSlot& Probe(FNameSlot* InSlots, uint32 Mask, uint32 UnmaskedSlotIndex, PredicateFn Predicate)
+	{
 		for (uint32 I = FNameHash::GetProbeStart(UnmaskedSlotIndex, Mask); true; I = (I + 1) & Mask)
 		{
-			FNameSlot& Slot = Slots[I];
+			FNameSlot& Slot = InSlots[I];
 			if (!Slot.Used() || Predicate(Slot))
 			{
 				return Slot;
@@ -696,6 +838,20 @@ private:
 		}
 	}
 
+	/** Same as Probe(Value) but safe to run concurrently with writers, returns a copy of the slot */
+	FNameSlot ProbeLockFree(const FNameSlot* InSlots, uint32 Mask, const FNameValue<Sensitivity>& Value) const
+	{
+		for (uint32 I = Value.Hash.GetProbeStart(Mask); true; I = (I + 1) & Mask)
+		{
+			const FNameSlot Slot = FNameSlot::LoadAcquire(InSlots[I]);
+			if (!Slot.Used() || (Slot.GetProbeHash() == Value.Hash.SlotProbeHash && 
+								 EntryEqualsValue<Sensitivity>(Entries->Resolve(Slot.GetId()), Value)))
+			{
+				return Slot;
+			}
+		}
+	}
+
 	OUTLINE_DECODE_BUFFER FNameHash Rehash(FNameEntryId EntryId)
 	{
 		const FNameEntry& Entry = Entries->Resolve(EntryId);
@@ -711,6 +867,7 @@ public:
 	FNamePool();
 
 	FNameEntryId	Store(FNameStringView View);
+	void			StoreBatch(TArrayView<const FNameStringView> Names, TArrayView<FNameEntryId> OutIds);
 	FNameEntryId	Find(FNameStringView View) const;
 	FNameEntryId	Find(EName Ename) const;
 	const EName*	FindEName(FNameEntryId Id) const;
@@ -733,6 +890,10 @@ public:
 private:
 	enum { MaxENames = 512 };
 
+#if WITH_CASE_PRESERVING_NAME
+	FNameEntryId	StoreDisplay(FNameDisplayValue& DisplayValue, FNameEntryId ComparisonId, bool bAddedComparison);
+#endif
+
 	FNameEntryAllocator Entries;
 	TAtomic<uint32> AnsiCount;
 	TAtomic<uint32> WideCount;
@@ -848,24 +1009,130 @@ FNameEntryId FNamePool::Store(FNameStringView Name)
 	EntryCount += bAdded;
 
 #if WITH_CASE_PRESERVING_NAME
+	return StoreDisplay(DisplayValue, ComparisonId, bAdded);
+#else
+	return ComparisonId;
+#endif
+}
+
+#if WITH_CASE_PRESERVING_NAME
+FNameEntryId FNamePool::StoreDisplay(FNameDisplayValue& DisplayValue, FNameEntryId ComparisonId, bool bAddedComparison)
+{
+	FNamePoolShard<ENameCase::CaseSensitive>& DisplayShard = DisplayShards[DisplayValue.Hash.ShardIndex];
+
 	// Check if ComparisonId can be used as DisplayId
-	if (bAdded || EqualsSameDimensions<ENameCase::CaseSensitive>(Resolve(ComparisonId), Name))
+	if (bAddedComparison || EqualsSameDimensions<ENameCase::CaseSensitive>(Resolve(ComparisonId), DisplayValue.Name))
 	{
 		DisplayShard.InsertExistingEntry(DisplayValue.Hash, ComparisonId);
 		return ComparisonId;
 	}
 	else
 	{
-		bAdded = false;
+		bool bAdded = false;
 		DisplayValue.ComparisonId = ComparisonId;
 		FNameEntryId DisplayId = DisplayShard.Insert(DisplayValue, bAdded);
-		EntryCount += bAdded;
+		(DisplayValue.Name.IsAnsi() ? AnsiCount : WideCount) += bAdded;
 
 		return DisplayId;
 	}
+}
+#endif
+
+void FNamePool::StoreBatch(TArrayView<const FNameStringView> Names, TArrayView<FNameEntryId> OutIds)
+{
+	check(Names.Num() == OutIds.Num());
+
+	// Indices of names that need to go through the comparison shards
+	TArray<int32> Pending;
+	Pending.Reserve(Names.Num());
+
+#if WITH_CASE_PRESERVING_NAME
+	TArray<FNameDisplayValue> DisplayValues;
+	DisplayValues.Reserve(Names.Num());
+	for (int32 Index = 0; Index < Names.Num(); ++Index)
+	{
+		const FNameDisplayValue& DisplayValue = DisplayValues.Emplace_GetRef(Names[Index]);
+		OutIds[Index] = DisplayShards[DisplayValue.Hash.ShardIndex].Find(DisplayValue);
+		if (!OutIds[Index])
+		{
+			Pending.Add(Index);
+		}
+	}
 #else
-	return ComparisonId;
+	for (int32 Index = 0; Index < Names.Num(); ++Index)
+	{
+		Pending.Add(Index);
+	}
 #endif
+
+	// Hash everything before touching any shard
+	TArray<FNameComparisonValue> ComparisonValues;
+	ComparisonValues.Reserve(Pending.Num());
+	for (int32 Index : Pending)
+	{
+		ComparisonValues.Emplace(Names[Index]);
+	}
+
+	// Counting sort by shard so every shard is visited once
+	TArray<int32> ShardEnds;
+	ShardEnds.SetNumZeroed(FNamePoolShards + 1);
+	for (const FNameComparisonValue& Value : ComparisonValues)
+	{
+		++ShardEnds[Value.Hash.ShardIndex + 1];
+	}
+	for (int32 Shard = 1; Shard <= FNamePoolShards; ++Shard)
+	{
+		ShardEnds[Shard] += ShardEnds[Shard - 1];
+	}
+
+	TArray<int32> Order;
+	Order.SetNumUninitialized(ComparisonValues.Num());
+	{
+		TArray<int32> Cursors(ShardEnds.GetData(), FNamePoolShards);
+		for (int32 ValueIndex = 0; ValueIndex < ComparisonValues.Num(); ++ValueIndex)
+		{
+			Order[Cursors[ComparisonValues[ValueIndex].Hash.ShardIndex]++] = ValueIndex;
+		}
+	}
+
+	TArray<FNameEntryId> ComparisonIds;
+	TArray<bool> Added;
+	ComparisonIds.SetNumZeroed(ComparisonValues.Num());
+	Added.SetNumZeroed(ComparisonValues.Num());
+
+	for (int32 Shard = 0; Shard < FNamePoolShards; ++Shard)
+	{
+		const int32 Begin = ShardEnds[Shard];
+		const int32 Num = ShardEnds[Shard + 1] - Begin;
+		if (Num > 0)
+		{
+			ComparisonShards[Shard].InsertBatch(ComparisonValues.GetData(), Order.GetData() + Begin, Num, ComparisonIds.GetData(), Added.GetData());
+		}
+	}
+
+	uint32 NumAnsiAdded = 0;
+	uint32 NumWideAdded = 0;
+	for (int32 ValueIndex = 0; ValueIndex < Pending.Num(); ++ValueIndex)
+	{
+		const int32 Index = Pending[ValueIndex];
+		if (Names[Index].IsAnsi())
+		{
+			NumAnsiAdded += Added[ValueIndex];
+		}
+		else
+		{
+			NumWideAdded += Added[ValueIndex];
+		}
+
+#if WITH_CASE_PRESERVING_NAME
+		OutIds[Index] = StoreDisplay(DisplayValues[Index], ComparisonIds[ValueIndex], Added[ValueIndex]);
+#else
+		OutIds[Index] = ComparisonIds[ValueIndex];
+#endif
+	}
+
+	AnsiCount += NumAnsiAdded;
+	WideCount += NumWideAdded;
 }
 
 uint32 FNamePool::NumSlots() const
@@ -1533,8 +1800,12 @@ struct FNameHelper
 			if (Digits == 1 || *FirstDigit != '0')
 			{
 				// Attempt to convert what's following it to a number
-				// This relies on Name being null-terminated
-				int64 Number = TCString<CharType>::Atoi64(Name + Len - Digits);
+				// Accumulate the digits ourselves so Name need not be null-terminated
+				int64 Number = 0;
+				for (const CharType* It = FirstDigit; It < Name + Len && Number < MAX_int32; ++It)
+				{
+					Number = Number * 10 + (*It - '0');
+				}
 				if (Number < MAX_int32)
 				{
 					InOutLen -= 1 + Digits;
@@ -1721,6 +1992,84 @@ FName::FName(const FNameEntrySerialized& LoadedEntry)
 	: FName(FNameHelper::MakeFromLoaded(LoadedEntry))
 {}
 
+void FName::CreateBatch(TArrayView<const FStringView> Strings, TArrayView<FName> OutNames)
+{
+	check(Strings.Num() == OutNames.Num());
+
+	int32 NumChars = 0;
+	for (const FStringView& String : Strings)
+	{
+		NumChars += String.Len();
+	}
+
+	// Narrowed copies of pure ansi strings, reserved up front so views into it stay valid
+	TArray<ANSICHAR> AnsiChars;
+	AnsiChars.Reserve(NumChars);
+
+	TArray<FNameStringView> Views;
+	TArray<int32> ViewToName;
+	TArray<uint32> Numbers;
+	Views.Reserve(Strings.Num());
+	ViewToName.Reserve(Strings.Num());
+	Numbers.Reserve(Strings.Num());
+
+	for (int32 Index = 0; Index < Strings.Num(); ++Index)
+	{
+		const FStringView& String = Strings[Index];
+		int32 Len = String.Len();
+		checkf(Len < NAME_SIZE, TEXT("FName's %d max length exceeded. Got %d characters."), NAME_SIZE - 1, Len);
+
+		// Same semantics as MakeDetectNumber() and MakeWithNumber(), empty strings become None, and so do
+		// strings that are only a number suffix like "_1"
+		if (Len == 0)
+		{
+			OutNames[Index] = FName();
+			continue;
+		}
+
+		const uint32 Number = FNameHelper::ParseNumber(String.Data(), Len);
+		if (Len == 0)
+		{
+			OutNames[Index] = FName();
+			continue;
+		}
+
+		Numbers.Add(Number);
+
+		if (IsWide(String.Data(), Len))
+		{
+			Views.Add(FNameStringView(String.Data(), Len));
+		}
+		else
+		{
+			ANSICHAR* AnsiName = AnsiChars.GetData() + AnsiChars.AddUninitialized(Len);
+			for (int32 I = 0; I < Len; ++I)
+			{
+				AnsiName[I] = static_cast<ANSICHAR>(String[I]);
+			}
+			Views.Add(FNameStringView(AnsiName, Len));
+		}
+		ViewToName.Add(Index);
+	}
+
+	TArray<FNameEntryId> DisplayIds;
+	DisplayIds.SetNumUninitialized(Views.Num());
+
+	FNamePool& Pool = GetNamePool();
+	Pool.StoreBatch(Views, DisplayIds);
+
+	for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ++ViewIndex)
+	{
+		const FNameEntryId DisplayId = DisplayIds[ViewIndex];
+#if WITH_CASE_PRESERVING_NAME
+		const FNameEntryId ComparisonId = Pool.Resolve(DisplayId).ComparisonId;
+#else
+		const FNameEntryId ComparisonId = DisplayId;
+#endif
+		OutNames[ViewToName[ViewIndex]] = FName(ComparisonId, DisplayId, Numbers[ViewIndex]);
+	}
+}
+
 bool FName::operator==(const ANSICHAR* Str) const
 {
 	return FNameHelper::EqualsString(*this, Str);
@@ -2008,6 +2357,27 @@ void FName::AutoTest()
 	FString WideLong = FString::ChrN(1000, 60000);
 	check(FName(*WideLong).GetPlainNameString() == WideLong);
 
+	// Test batch creation matches single creation, including unterminated views, numbers, duplicates and wide strings
+	{
+		const TCHAR* Unterminated = TEXT("BatchName_12BatchName_12");
+		const FStringView BatchStrings[] = { FStringView(Unterminated, 12), TEXT("batchname_12"), TEXT("BatchName_012"), TEXT(""), TEXT("None"), *Wide, TEXT("BatchName_12"), TEXT("NewBatchName"), TEXT("_1"), TEXT("_0") };
+		FName BatchNames[UE_ARRAY_COUNT(BatchStrings)];
+		FName::CreateBatch(MakeArrayView(BatchStrings, UE_ARRAY_COUNT(BatchStrings)), MakeArrayView(BatchNames, UE_ARRAY_COUNT(BatchNames)));
+
+		for (int32 Index = 0; Index < UE_ARRAY_COUNT(BatchStrings); ++Index)
+		{
+			const FName Single(BatchStrings[Index].Len(), BatchStrings[Index].Data());
+			check(BatchNames[Index] == Single);
+			check(BatchNames[Index].GetNumber() == Single.GetNumber());
+#if WITH_CASE_PRESERVING_NAME
+			check(BatchNames[Index].GetDisplayIndex() == Single.GetDisplayIndex());
+#endif
+		}
+		check(BatchNames[0] == FName("BatchName", NAME_EXTERNAL_TO_INTERNAL(12)));
+		check(BatchNames[3].IsNone() && BatchNames[4].IsNone());
+		check(BatchNames[8].IsNone() && BatchNames[8].GetNumber() == NAME_NO_NUMBER_INTERNAL && BatchNames[9].IsNone());
+	}
+
 
 	// Check that FNAME_Find doesn't add entries
 	static bool Once = true;
@@ -2313,6 +2683,7 @@ bool operator==(const FLazyName& A, const FLazyName& B)
 #if !UE_BUILD_SHIPPING && !UE_BUILD_TEST
 
 #include "Containers/StackTracker.h"
+#include "Async/ParallelFor.h"
 static TAutoConsoleVariable<int32> CVarLogGameThreadFNameChurn(
 	TEXT("LogGameThreadFNameChurn.Enable"),
 	0,
@@ -2413,10 +2784,90 @@ struct FSampleFNameChurn
 		GGameThreadFNameChurnTracker.DumpStackTraces(CVarLogGameThreadFNameChurn_Threshhold.GetValueOnGameThread(), *Log, SampleAndFrameCorrection);
 		GGameThreadFNameChurnTracker.ResetTracking();
 	}
+
+	/**
+	 * Measures how fast many threads can create new and look up existing names,
+	 * one at a time and through FName::CreateBatch().
+	 *
+	 * Args: [NumThreads] [NamesPerThread]
+	 */
+	static void RunThroughputBenchmark(const TArray<FString>& Args)
+	{
+		const int32 NumThreads = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+		const int32 NamesPerThread = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 100000;
+		const int32 NumNames = NumThreads * NamesPerThread;
+		enum { BatchSize = 256 };
+
+		// Unique names per run so the first pass of each path really creates names.
+		// End them in a letter so no number is split off and every string is a distinct entry.
+		static int32 RunCounter = 0;
+		const int32 Run = RunCounter++;
+
+		TArray<FString> SingleStrings;
+		TArray<FString> BatchStrings;
+		SingleStrings.Reserve(NumNames);
+		BatchStrings.Reserve(NumNames);
+		for (int32 Index = 0; Index < NumNames; ++Index)
+		{
+			SingleStrings.Add(FString::Printf(TEXT("FNameChurnSingle_%d_%dx"), Run, Index));
+			BatchStrings.Add(FString::Printf(TEXT("FNameChurnBatch_%d_%dx"), Run, Index));
+		}
+
+		TArray<FStringView> BatchViews;
+		BatchViews.Reserve(NumNames);
+		for (const FString& String : BatchStrings)
+		{
+			BatchViews.Add(FStringView(String));
+		}
+
+		auto RunSingle = [&]()
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			ParallelFor(NumThreads, [&](int32 Thread)
+			{
+				for (int32 Index = Thread * NamesPerThread, End = Index + NamesPerThread; Index < End; ++Index)
+				{
+					FName Name(SingleStrings[Index].Len(), *SingleStrings[Index]);
+				}
+			});
+			return FPlatformTime::Seconds() - StartTime;
+		};
+
+		auto RunBatch = [&]()
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			ParallelFor(NumThreads, [&](int32 Thread)
+			{
+				TArray<FName, TInlineAllocator<BatchSize>> Names;
+				Names.SetNum(BatchSize);
+				for (int32 Begin = Thread * NamesPerThread, End = Begin + NamesPerThread; Begin < End; Begin += BatchSize)
+				{
+					const int32 Num = FMath::Min<int32>(BatchSize, End - Begin);
+					FName::CreateBatch(MakeArrayView(BatchViews.GetData() + Begin, Num), MakeArrayView(Names.GetData(), Num));
+				}
+			});
+			return FPlatformTime::Seconds() - StartTime;
+		};
+
+		const double SingleNew = RunSingle();
+		const double SingleExisting = RunSingle();
+		const double BatchNew = RunBatch();
+		const double BatchExisting = RunBatch();
+
+		auto MNamesPerSecond = [NumNames](double Seconds) { return Seconds > 0.0 ? NumNames / Seconds / 1000000.0 : 0.0; };
+		UE_LOG(LogUnrealNames, Display, TEXT("FName churn benchmark, %d threads x %d names (Mnames/s):"), NumThreads, NamesPerThread);
+		UE_LOG(LogUnrealNames, Display, TEXT("  single new %.2f, single existing %.2f"), MNamesPerSecond(SingleNew), MNamesPerSecond(SingleExisting));
+		UE_LOG(LogUnrealNames, Display, TEXT("  batch  new %.2f, batch  existing %.2f (batches of %d)"), MNamesPerSecond(BatchNew), MNamesPerSecond(BatchExisting), (int32)BatchSize);
+	}
 };
 
 FSampleFNameChurn GGameThreadFNameChurnTracker;
 
+static FAutoConsoleCommand FNameChurnBenchmarkCommand(
+	TEXT("FName.ChurnBenchmark"),
+	TEXT("Measures multi-threaded FName creation throughput of the single and batch paths. Usage: FName.ChurnBenchmark [NumThreads] [NamesPerThread]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FSampleFNameChurn::RunThroughputBenchmark));
+
 void CallNameCreationHook()
 {
 	if (GIsRunning && IsInGameThread())
@@ -0,0 +1,1009 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "UnixAsyncIO.h"
+#include "Async/AsyncFileHandle.h"
+#include "Containers/Array.h"
+#include "Containers/StringConv.h"
+#include "Containers/UnrealString.h"
+#include "HAL/Event.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Logging/LogMacros.h"
+#include "Misc/ScopeLock.h"
+
+#if PLATFORM_LINUX
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+DEFINE_LOG_CATEGORY_STATIC(LogUnixAsyncIO, Log, All);
+
+static int32 GUnixUseIoUring = 1;
+static FAutoConsoleVariableRef CVarUnixUseIoUring(
+	TEXT("unix.IoUring"),
+	GUnixUseIoUring,
+	TEXT("If non-zero, async file handles opened from then on read through io_uring when the kernel supports it.\n")
+	TEXT("Otherwise they use the generic thread pool implementation."),
+	ECVF_Default
+);
+
+static int32 GUnixIoUringQueueDepth = 256;
+static FAutoConsoleVariableRef CVarUnixIoUringQueueDepth(
+	TEXT("unix.IoUring.QueueDepth"),
+	GUnixIoUringQueueDepth,
+	TEXT("Number of submission queue entries of the io_uring, rounded up to a power of two. Up to twice as many reads are kept in flight.\n")
+	TEXT("Read when the ring is set up by the first async file handle."),
+	ECVF_Default
+);
+
+static int32 GUnixIoUringRegisteredBuffers = 0;
+static FAutoConsoleVariableRef CVarUnixIoUringRegisteredBuffers(
+	TEXT("unix.IoUring.RegisteredBuffers"),
+	GUnixIoUringRegisteredBuffers,
+	TEXT("Number of buffers registered with the io_uring. Reads that fit go through a registered buffer, which saves the kernel pinning\n")
+	TEXT("the destination pages for every read at the cost of a copy. 0 reads straight into the destination memory.\n")
+	TEXT("Read when the ring is set up by the first async file handle."),
+	ECVF_Default
+);
+
+static int32 GUnixIoUringRegisteredBufferSizeKB = 256;
+static FAutoConsoleVariableRef CVarUnixIoUringRegisteredBufferSizeKB(
+	TEXT("unix.IoUring.RegisteredBufferSizeKB"),
+	GUnixIoUringRegisteredBufferSizeKB,
+	TEXT("Size of each buffer registered with the io_uring in KB, see unix.IoUring.RegisteredBuffers."),
+	ECVF_Default
+);
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup		425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter		426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register	427
+#endif
+
+/** The io_uring kernel interface, declared here as the system headers we build against can predate it */
+namespace IoUringABI
+{
+	struct FSubmissionQueueEntry
+	{
+		uint8 Opcode;
+		uint8 Flags;
+		uint16 IoPriority;
+		int32 FileDescriptor;
+		uint64 Offset;
+		uint64 Address;
+		uint32 Length;
+		uint32 ReadWriteFlags;
+		uint64 UserData;
+		uint16 BufferIndex;
+		uint16 Personality;
+		int32 SpliceFileDescriptorIn;
+		uint64 Padding[2];
+	};
+	static_assert(sizeof(FSubmissionQueueEntry) == 64, "FSubmissionQueueEntry must match struct io_uring_sqe");
+
+	struct FCompletionQueueEntry
+	{
+		uint64 UserData;
+		int32 Result;
+		uint32 Flags;
+	};
+	static_assert(sizeof(FCompletionQueueEntry) == 16, "FCompletionQueueEntry must match struct io_uring_cqe");
+
+	struct FSubmissionRingOffsets
+	{
+		uint32 Head;
+		uint32 Tail;
+		uint32 RingMask;
+		uint32 RingEntries;
+		uint32 Flags;
+		uint32 Dropped;
+		uint32 Array;
+		uint32 Reserved1;
+		uint64 Reserved2;
+	};
+
+	struct FCompletionRingOffsets
+	{
+		uint32 Head;
+		uint32 Tail;
+		uint32 RingMask;
+		uint32 RingEntries;
+		uint32 Overflow;
+		uint32 Cqes;
+		uint32 Flags;
+		uint32 Reserved1;
+		uint64 Reserved2;
+	};
+
+	struct FParams
+	{
+		uint32 SqEntries;
+		uint32 CqEntries;
+		uint32 Flags;
+		uint32 SqThreadCpu;
+		uint32 SqThreadIdle;
+		uint32 Features;
+		uint32 WqFileDescriptor;
+		uint32 Reserved[3];
+		FSubmissionRingOffsets SqOffsets;
+		FCompletionRingOffsets CqOffsets;
+	};
+	static_assert(sizeof(FParams) == 120, "FParams must match struct io_uring_params");
+
+	enum EOpcode : uint8
+	{
+		OpReadv = 1,
+		OpReadFixed = 4,
+	};
+
+	static const uint64 OffsetSqRing = 0;
+	static const uint64 OffsetSqes = 0x10000000ULL;
+	static const uint32 EnterGetEvents = 1 << 0;
+	static const uint32 FeatureSingleMmap = 1 << 0;
+	static const uint32 FeatureNoDrop = 1 << 1;
+	static const uint32 RegisterBuffers = 0;
+	static const uint16 IoPriorityClassBestEffort = 2 << 13;
+
+	FORCEINLINE uint32 LoadAcquire(const uint32* Value)
+	{
+		return __atomic_load_n(Value, __ATOMIC_ACQUIRE);
+	}
+
+	FORCEINLINE void StoreRelease(uint32* Value, uint32 NewValue)
+	{
+		__atomic_store_n(Value, NewValue, __ATOMIC_RELEASE);
+	}
+}
+
+class FUnixIoUringReadRequest;
+
+/** The ring shared by all io_uring async read handles, set up on first use and kept for the lifetime of the process */
+class FUnixIoUring final : public FRunnable
+{
+public:
+	/** Returns nullptr if io_uring can't be used */
+	static FUnixIoUring* Get();
+
+	/**
+	 * Queues the next read of a request and submits it. Reads issued on the completion thread, i.e. from completion
+	 * callbacks, are deferred until the callbacks are done and there is room for them, see SubmitDeferred.
+	 *
+	 * @param bResubmit	True when the request already has a read in flight accounted for, e.g. it continues after a short read
+	 */
+	void Submit(FUnixIoUringReadRequest* Request, bool bResubmit);
+
+	/** Returns the index of a free registered buffer if Size fits, otherwise INDEX_NONE */
+	int32 AllocRegisteredBuffer(int64 Size);
+	void FreeRegisteredBuffer(int32 BufferIndex);
+
+	FORCEINLINE uint8* GetRegisteredBuffer(int32 BufferIndex) const
+	{
+		return RegisteredBufferMemory + (SIZE_T)BufferIndex * RegisteredBufferSize;
+	}
+
+	//~ Begin FRunnable Interface
+	virtual uint32 Run() override;
+	//~ End FRunnable Interface
+
+private:
+	FUnixIoUring();
+	virtual ~FUnixIoUring();
+
+	bool Initialize();
+	void RegisterBuffers();
+
+	/** Counts a new read as in flight unless MaxInFlight has been reached */
+	FORCEINLINE bool TryReserveInFlight()
+	{
+		if (NumInFlight.Increment() > MaxInFlight)
+		{
+			NumInFlight.Decrement();
+			return false;
+		}
+		return true;
+	}
+
+	/** Writes the request's next read to the submission queue, waiting for room if it is full */
+	void QueueSubmission(FUnixIoUringReadRequest* Request);
+
+	/** Submits the queued entries unless another thread is already doing it, in which case that thread picks them up */
+	void FlushSubmissions();
+
+	/** Called by the completion thread after reaping, submits deferred reads as long as they fit in MaxInFlight */
+	void SubmitDeferred();
+
+	/**
+	 * Makes progress while the kernel is out of resources. The completion thread is the only one reaping completions,
+	 * so it has to reap them itself rather than wait for a full completion queue to drain.
+	 */
+	void WaitForKernelResources();
+
+	/** Submits the queued entries, returns false if the kernel is out of resources and this should be retried later */
+	bool SubmitQueued();
+
+	FORCEINLINE uint32 GetNumQueued() const
+	{
+		return IoUringABI::LoadAcquire(SqTail) - IoUringABI::LoadAcquire(SqHead);
+	}
+
+	void ReapCompletions();
+
+	int32 RingFileDescriptor;
+	uint8* RingMemory;
+	SIZE_T RingMemorySize;
+	IoUringABI::FSubmissionQueueEntry* Sqes;
+	SIZE_T SqesSize;
+
+	uint32* SqHead;
+	uint32* SqTail;
+	uint32* SqArray;
+	uint32 SqMask;
+	uint32 SqEntries;
+
+	uint32* CqHead;
+	uint32* CqTail;
+	IoUringABI::FCompletionQueueEntry* Cqes;
+	uint32 CqMask;
+
+	/** Guards writing submission queue entries */
+	FCriticalSection SubmissionCritical;
+	/** Held by the thread that enters the kernel to submit */
+	FCriticalSection EnterCritical;
+
+	/** Reads in flight, including deferred ones, are kept below the completion queue size so it never overflows */
+	FThreadSafeCounter NumInFlight;
+	int32 MaxInFlight;
+
+	struct FDeferredSubmission
+	{
+		FUnixIoUringReadRequest* Request;
+		bool bResubmit;
+	};
+	/** Reads issued on the completion thread that haven't been submitted yet, only accessed by the completion thread */
+	TArray<FDeferredSubmission> DeferredSubmissions;
+
+	FRunnableThread* CompletionThread;
+	uint32 CompletionThreadId;
+
+	uint8* RegisteredBufferMemory;
+	SIZE_T RegisteredBufferSize;
+	int32 NumRegisteredBuffers;
+	TArray<int32> FreeRegisteredBuffers;
+	FCriticalSection RegisteredBuffersCritical;
+};
+
+class FUnixIoUringAsyncReadFileHandle;
+
+/** Reads are split so each one fits the 32 bit length of a submission queue entry */
+static const int64 GUnixIoUringMaxReadLength = 1 << 30;
+
+class FUnixIoUringReadRequest : public IAsyncReadRequest
+{
+	FUnixIoUringAsyncReadFileHandle* Owner;
+	int64 Offset;
+	int64 BytesToRead;
+	int64 BytesRead;
+	EAsyncIOPriorityAndFlags PriorityAndFlags;
+	int32 RegisteredBufferIndex;
+	FEvent* CompletionEvent;
+	struct iovec IoVector;
+
+public:
+	FUnixIoUringReadRequest(FUnixIoUringAsyncReadFileHandle* InOwner, FAsyncFileCallBack* CompleteCallback, uint8* UserSuppliedMemory, int64 InOffset, int64 InBytesToRead, EAsyncIOPriorityAndFlags InPriorityAndFlags);
+	virtual ~FUnixIoUringReadRequest();
+
+	/** Fills in the submission queue entry of the next read, called by the ring with the submission queue locked */
+	void PrepareSubmission(IoUringABI::FSubmissionQueueEntry& Sqe);
+
+	/**
+	 * Called from the completion thread for each completed read.
+	 *
+	 * @return true if the request is complete, after which it must not be touched as the owner may delete it right away
+	 */
+	bool OnReadCompleted(int32 Result);
+
+	uint8* GetContainedSubblock(uint8* UserSuppliedMemory, int64 InOffset, int64 InBytesToRead)
+	{
+		if (InOffset >= Offset && InOffset + InBytesToRead <= Offset + BytesToRead &&
+			this->PollCompletion() && Memory)
+		{
+			check(Memory);
+			if (!UserSuppliedMemory)
+			{
+				UserSuppliedMemory = (uint8*)FMemory::Malloc(InBytesToRead);
+				INC_MEMORY_STAT_BY(STAT_AsyncFileMemory, InBytesToRead);
+			}
+			FMemory::Memcpy(UserSuppliedMemory, Memory + InOffset - Offset, InBytesToRead);
+			return UserSuppliedMemory;
+		}
+		return nullptr;
+	}
+
+protected:
+	virtual void WaitCompletionImpl(float TimeLimitSeconds) override;
+	virtual void CancelImpl() override
+	{
+		// Reads in flight can't be abandoned since the kernel writes to the memory, the request completes as canceled instead
+	}
+
+private:
+	bool CheckForPrecache();
+	bool ReadRemainingSynchronously();
+	void FinishRead(bool bSucceeded);
+};
+
+class FUnixIoUringSizeRequest : public IAsyncReadRequest
+{
+public:
+	FUnixIoUringSizeRequest(FAsyncFileCallBack* CompleteCallback, int64 InFileSize)
+		: IAsyncReadRequest(CompleteCallback, true, nullptr)
+	{
+		Size = InFileSize;
+		SetComplete();
+	}
+
+protected:
+	virtual void WaitCompletionImpl(float TimeLimitSeconds) override
+	{
+	}
+	virtual void CancelImpl() override
+	{
+	}
+};
+
+class FUnixIoUringAsyncReadFileHandle final : public IAsyncReadFileHandle
+{
+public:
+	FUnixIoUring& Ring;
+	int32 FileDescriptor;
+	int64 FileSize;
+	FString Filename;
+
+private:
+	TArray<FUnixIoUringReadRequest*> LiveRequests; // linear searches could be improved
+	FCriticalSection LiveRequestsCritical;
+
+public:
+	FUnixIoUringAsyncReadFileHandle(FUnixIoUring& InRing, int32 InFileDescriptor, const TCHAR* InFilename)
+		: Ring(InRing)
+		, FileDescriptor(InFileDescriptor)
+		, FileSize(-1)
+		, Filename(InFilename)
+	{
+		struct stat FileInfo;
+		if (fstat(FileDescriptor, &FileInfo) == 0 && !S_ISDIR(FileInfo.st_mode))
+		{
+			FileSize = FileInfo.st_size;
+		}
+	}
+
+	~FUnixIoUringAsyncReadFileHandle()
+	{
+#if DO_CHECK
+		FScopeLock Lock(&LiveRequestsCritical);
+		check(!LiveRequests.Num()); // must delete all requests before you delete the handle
+#endif
+		close(FileDescriptor);
+	}
+
+	void RemoveRequest(FUnixIoUringReadRequest* Req)
+	{
+		FScopeLock Lock(&LiveRequestsCritical);
+		verify(LiveRequests.Remove(Req) == 1);
+	}
+
+	uint8* GetPrecachedBlock(uint8* UserSuppliedMemory, int64 InOffset, int64 InBytesToRead)
+	{
+		FScopeLock Lock(&LiveRequestsCritical);
+		uint8* Result = nullptr;
+		for (FUnixIoUringReadRequest* Req : LiveRequests)
+		{
+			Result = Req->GetContainedSubblock(UserSuppliedMemory, InOffset, InBytesToRead);
+			if (Result)
+			{
+				break;
+			}
+		}
+		return Result;
+	}
+
+	virtual IAsyncReadRequest* SizeRequest(FAsyncFileCallBack* CompleteCallback = nullptr) override
+	{
+		return new FUnixIoUringSizeRequest(CompleteCallback, FileSize);
+	}
+
+	virtual IAsyncReadRequest* ReadRequest(int64 Offset, int64 BytesToRead, EAsyncIOPriorityAndFlags PriorityAndFlags = AIOP_Normal, FAsyncFileCallBack* CompleteCallback = nullptr, uint8* UserSuppliedMemory = nullptr) override
+	{
+		FUnixIoUringReadRequest* Result = new FUnixIoUringReadRequest(this, CompleteCallback, UserSuppliedMemory, Offset, BytesToRead, PriorityAndFlags);
+		if (PriorityAndFlags & AIOP_FLAG_PRECACHE) // only precache requests are tracked for possible reuse
+		{
+			FScopeLock Lock(&LiveRequestsCritical);
+			LiveRequests.Add(Result);
+		}
+		return Result;
+	}
+};
+
+FUnixIoUringReadRequest::FUnixIoUringReadRequest(FUnixIoUringAsyncReadFileHandle* InOwner, FAsyncFileCallBack* CompleteCallback, uint8* UserSuppliedMemory, int64 InOffset, int64 InBytesToRead, EAsyncIOPriorityAndFlags InPriorityAndFlags)
+	: IAsyncReadRequest(CompleteCallback, false, UserSuppliedMemory)
+	, Owner(InOwner)
+	, Offset(InOffset)
+	, BytesToRead(InBytesToRead)
+	, BytesRead(0)
+	, PriorityAndFlags(InPriorityAndFlags)
+	, RegisteredBufferIndex(INDEX_NONE)
+	, CompletionEvent(nullptr)
+{
+	check(Offset >= 0 && BytesToRead > 0);
+	if (BytesToRead == MAX_int64)
+	{
+		BytesToRead = Owner->FileSize - Offset;
+		check(BytesToRead > 0);
+	}
+
+	if (CheckForPrecache())
+	{
+		SetComplete();
+		return;
+	}
+
+	LLM_SCOPE(ELLMTag::FileSystem);
+	if (!bUserSuppliedMemory)
+	{
+		check(!Memory);
+		Memory = (uint8*)FMemory::Malloc(BytesToRead);
+		INC_MEMORY_STAT_BY(STAT_AsyncFileMemory, BytesToRead);
+	}
+	RegisteredBufferIndex = Owner->Ring.AllocRegisteredBuffer(BytesToRead);
+	CompletionEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	Owner->Ring.Submit(this, false);
+}
+
+FUnixIoUringReadRequest::~FUnixIoUringReadRequest()
+{
+	if (Memory)
+	{
+		// this can happen with a race on cancel, it is ok, they didn't take the memory, free it now
+		if (!bUserSuppliedMemory)
+		{
+			DEC_MEMORY_STAT_BY(STAT_AsyncFileMemory, BytesToRead);
+			FMemory::Free(Memory);
+		}
+		Memory = nullptr;
+	}
+	if (PriorityAndFlags & AIOP_FLAG_PRECACHE) // only precache requests are tracked for possible reuse
+	{
+		Owner->RemoveRequest(this);
+	}
+	if (CompletionEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(CompletionEvent);
+		CompletionEvent = nullptr;
+	}
+	Owner = nullptr;
+}
+
+bool FUnixIoUringReadRequest::CheckForPrecache()
+{
+	if ((PriorityAndFlags & AIOP_FLAG_PRECACHE) == 0)  // only non-precache requests check for existing blocks to copy from
+	{
+		check(!Memory || bUserSuppliedMemory);
+		uint8* Result = Owner->GetPrecachedBlock(Memory, Offset, BytesToRead);
+		if (Result)
+		{
+			check(!bUserSuppliedMemory || Memory == Result);
+			Memory = Result;
+			return true;
+		}
+	}
+	return false;
+}
+
+void FUnixIoUringReadRequest::PrepareSubmission(IoUringABI::FSubmissionQueueEntry& Sqe)
+{
+	FMemory::Memzero(Sqe);
+	const uint32 Length = (uint32)FMath::Min(BytesToRead - BytesRead, GUnixIoUringMaxReadLength);
+	Sqe.FileDescriptor = Owner->FileDescriptor;
+	Sqe.Offset = (uint64)(Offset + BytesRead);
+	// Only matters to I/O schedulers that support priorities, best effort level 0 is the highest
+	Sqe.IoPriority = IoUringABI::IoPriorityClassBestEffort | (uint16)(AIOP_MAX - FMath::Clamp<int32>(PriorityAndFlags & AIOP_PRIORITY_MASK, AIOP_MIN, AIOP_MAX));
+	if (RegisteredBufferIndex != INDEX_NONE)
+	{
+		Sqe.Opcode = IoUringABI::OpReadFixed;
+		Sqe.Address = (uint64)(UPTRINT)(Owner->Ring.GetRegisteredBuffer(RegisteredBufferIndex) + BytesRead);
+		Sqe.Length = Length;
+		Sqe.BufferIndex = (uint16)RegisteredBufferIndex;
+	}
+	else
+	{
+		IoVector.iov_base = Memory + BytesRead;
+		IoVector.iov_len = Length;
+		Sqe.Opcode = IoUringABI::OpReadv;
+		Sqe.Address = (uint64)(UPTRINT)&IoVector;
+		Sqe.Length = 1;
+	}
+	Sqe.UserData = (uint64)(UPTRINT)this;
+}
+
+bool FUnixIoUringReadRequest::OnReadCompleted(int32 Result)
+{
+	if (Result == -EINTR || Result == -EAGAIN)
+	{
+		Owner->Ring.Submit(this, true);
+		return false;
+	}
+
+	bool bSucceeded = true;
+	if (Result < 0)
+	{
+		UE_LOG(LogUnixAsyncIO, Warning, TEXT("io_uring read failed: errno=%d (%s), Offset = %lld Size = %lld File = %s, retrying synchronously"),
+			-Result, UTF8_TO_TCHAR(strerror(-Result)), Offset + BytesRead, BytesToRead - BytesRead, *Owner->Filename);
+		bSucceeded = ReadRemainingSynchronously();
+	}
+	else if (Result == 0)
+	{
+		UE_LOG(LogUnixAsyncIO, Error, TEXT("Short read, end of file reached at Offset = %lld while reading %lld bytes at %lld, File = %s"),
+			Offset + BytesRead, BytesToRead, Offset, *Owner->Filename);
+		bSucceeded = false;
+	}
+	else
+	{
+		BytesRead += Result;
+		if (BytesRead < BytesToRead && !bCanceled)
+		{
+			Owner->Ring.Submit(this, true);
+			return false;
+		}
+	}
+
+	FinishRead(bSucceeded);
+	return true;
+}
+
+bool FUnixIoUringReadRequest::ReadRemainingSynchronously()
+{
+	uint8* Destination = RegisteredBufferIndex != INDEX_NONE ? Owner->Ring.GetRegisteredBuffer(RegisteredBufferIndex) : Memory;
+	while (BytesRead < BytesToRead)
+	{
+		const ssize_t Result = pread(Owner->FileDescriptor, Destination + BytesRead, FMath::Min(BytesToRead - BytesRead, GUnixIoUringMaxReadLength), Offset + BytesRead);
+		if (Result < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (Result <= 0)
+		{
+			const int ErrNo = Result < 0 ? errno : 0;
+			UE_LOG(LogUnixAsyncIO, Error, TEXT("Unable to recover from a bad read: errno=%d (%s), Offset = %lld Size = %lld File = %s"),
+				ErrNo, UTF8_TO_TCHAR(strerror(ErrNo)), Offset + BytesRead, BytesToRead - BytesRead, *Owner->Filename);
+			return false;
+		}
+		BytesRead += Result;
+	}
+	return true;
+}
+
+void FUnixIoUringReadRequest::FinishRead(bool bSucceeded)
+{
+	if (RegisteredBufferIndex != INDEX_NONE)
+	{
+		if (bSucceeded && !bCanceled)
+		{
+			FMemory::Memcpy(Memory, Owner->Ring.GetRegisteredBuffer(RegisteredBufferIndex), BytesToRead);
+		}
+		Owner->Ring.FreeRegisteredBuffer(RegisteredBufferIndex);
+		RegisteredBufferIndex = INDEX_NONE;
+	}
+	if (!bSucceeded && !bUserSuppliedMemory)
+	{
+		DEC_MEMORY_STAT_BY(STAT_AsyncFileMemory, BytesToRead);
+		FMemory::Free(Memory);
+		Memory = nullptr;
+	}
+
+	// Waiters wake on the event and then spin until the request is flagged complete, which has to be the last thing
+	// done with the request since the owner may delete it as soon as it sees that
+	SetDataComplete();
+	CompletionEvent->Trigger();
+	SetAllComplete();
+}
+
+void FUnixIoUringReadRequest::WaitCompletionImpl(float TimeLimitSeconds)
+{
+	if (CompletionEvent)
+	{
+		const uint32 WaitTime = TimeLimitSeconds <= 0.0f ? MAX_uint32 : FMath::Max<uint32>((uint32)(TimeLimitSeconds * 1000.0f), 1);
+		if (CompletionEvent->Wait(WaitTime))
+		{
+			while (!PollCompletion())
+			{
+				FPlatformProcess::Sleep(0.0f);
+			}
+		}
+	}
+}
+
+FUnixIoUring* FUnixIoUring::Get()
+{
+	// Function static so it is set up thread safely by the first handle
+	static FUnixIoUring* Instance = []() -> FUnixIoUring*
+	{
+		if (!FPlatformProcess::SupportsMultithreading())
+		{
+			return nullptr;
+		}
+		FUnixIoUring* Ring = new FUnixIoUring;
+		if (!Ring->Initialize())
+		{
+			delete Ring;
+			return nullptr;
+		}
+		return Ring;
+	}();
+	return Instance;
+}
+
+FUnixIoUring::FUnixIoUring()
+	: RingFileDescriptor(-1)
+	, RingMemory(nullptr)
+	, RingMemorySize(0)
+	, Sqes(nullptr)
+	, SqesSize(0)
+	, MaxInFlight(0)
+	, CompletionThread(nullptr)
+	, CompletionThreadId(0)
+	, RegisteredBufferMemory(nullptr)
+	, RegisteredBufferSize(0)
+	, NumRegisteredBuffers(0)
+{
+}
+
+FUnixIoUring::~FUnixIoUring()
+{
+	// Only reached when setting up the ring failed, a working ring lives as long as the process
+	check(!CompletionThread);
+	if (RegisteredBufferMemory)
+	{
+		munmap(RegisteredBufferMemory, RegisteredBufferSize * NumRegisteredBuffers);
+	}
+	if (Sqes)
+	{
+		munmap(Sqes, SqesSize);
+	}
+	if (RingMemory)
+	{
+		munmap(RingMemory, RingMemorySize);
+	}
+	if (RingFileDescriptor != -1)
+	{
+		close(RingFileDescriptor);
+	}
+}
+
+bool FUnixIoUring::Initialize()
+{
+	using namespace IoUringABI;
+
+	FParams Params;
+	FMemory::Memzero(Params);
+	const uint32 QueueDepth = FMath::RoundUpToPowerOfTwo(FMath::Clamp(GUnixIoUringQueueDepth, 8, 4096));
+	RingFileDescriptor = (int32)syscall(__NR_io_uring_setup, QueueDepth, &Params);
+	if (RingFileDescriptor < 0)
+	{
+		const int ErrNo = errno;
+		UE_LOG(LogUnixAsyncIO, Log, TEXT("io_uring is not available: errno=%d (%s), async file reads use the thread pool"), ErrNo, UTF8_TO_TCHAR(strerror(ErrNo)));
+		RingFileDescriptor = -1;
+		return false;
+	}
+
+	// Without IORING_FEAT_NODROP (5.5) completions are lost if the completion queue ever overflows, MaxInFlight is what
+	// keeps it from happening. Every kernel that has it also maps both rings at once (IORING_FEAT_SINGLE_MMAP).
+	if ((Params.Features & (FeatureNoDrop | FeatureSingleMmap)) != (FeatureNoDrop | FeatureSingleMmap))
+	{
+		UE_LOG(LogUnixAsyncIO, Log, TEXT("io_uring of this kernel is too old (features 0x%x), async file reads use the thread pool"), Params.Features);
+		return false;
+	}
+
+	RingMemorySize = FMath::Max<SIZE_T>(Params.SqOffsets.Array + Params.SqEntries * sizeof(uint32), Params.CqOffsets.Cqes + Params.CqEntries * sizeof(FCompletionQueueEntry));
+	void* MappedRing = mmap(nullptr, RingMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFileDescriptor, OffsetSqRing);
+	if (MappedRing == MAP_FAILED)
+	{
+		const int ErrNo = errno;
+		UE_LOG(LogUnixAsyncIO, Warning, TEXT("Unable to map the io_uring: errno=%d (%s), async file reads use the thread pool"), ErrNo, UTF8_TO_TCHAR(strerror(ErrNo)));
+		return false;
+	}
+	RingMemory = (uint8*)MappedRing;
+
+	SqesSize = Params.SqEntries * sizeof(FSubmissionQueueEntry);
+	void* MappedSqes = mmap(nullptr, SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, RingFileDescriptor, OffsetSqes);
+	if (MappedSqes == MAP_FAILED)
+	{
+		const int ErrNo = errno;
+		UE_LOG(LogUnixAsyncIO, Warning, TEXT("Unable to map the io_uring submission queue: errno=%d (%s), async file reads use the thread pool"), ErrNo, UTF8_TO_TCHAR(strerror(ErrNo)));
+		return false;
+	}
+	Sqes = (FSubmissionQueueEntry*)MappedSqes;
+
+	SqHead = (uint32*)(RingMemory + Params.SqOffsets.Head);
+	SqTail = (uint32*)(RingMemory + Params.SqOffsets.Tail);
+	SqArray = (uint32*)(RingMemory + Params.SqOffsets.Array);
+	SqMask = *(uint32*)(RingMemory + Params.SqOffsets.RingMask);
+	SqEntries = *(uint32*)(RingMemory + Params.SqOffsets.RingEntries);
+	CqHead = (uint32*)(RingMemory + Params.CqOffsets.Head);
+	CqTail = (uint32*)(RingMemory + Params.CqOffsets.Tail);
+	Cqes = (FCompletionQueueEntry*)(RingMemory + Params.CqOffsets.Cqes);
+	CqMask = *(uint32*)(RingMemory + Params.CqOffsets.RingMask);
+	MaxInFlight = (int32)Params.CqEntries;
+
+	RegisterBuffers();
+
+	CompletionThread = FRunnableThread::Create(this, TEXT("IoUringCompletions"), 128 * 1024, TPri_AboveNormal);
+	if (!CompletionThread)
+	{
+		UE_LOG(LogUnixAsyncIO, Warning, TEXT("Unable to start the io_uring completion thread, async file reads use the thread pool"));
+		return false;
+	}
+	CompletionThreadId = CompletionThread->GetThreadID();
+
+	UE_LOG(LogUnixAsyncIO, Log, TEXT("Async file reads use io_uring, %u submission queue entries, %u completion queue entries, %d registered buffers of %d KB"),
+		Params.SqEntries, Params.CqEntries, NumRegisteredBuffers, (int32)(RegisteredBufferSize / 1024));
+	return true;
+}
+
+void FUnixIoUring::RegisterBuffers()
+{
+	const int32 NumBuffers = FMath::Clamp(GUnixIoUringRegisteredBuffers, 0, 1024);
+	if (!NumBuffers)
+	{
+		return;
+	}
+
+	const SIZE_T BufferSize = Align((SIZE_T)FMath::Max(GUnixIoUringRegisteredBufferSizeKB, 4) * 1024, FPlatformMemory::GetConstants().PageSize);
+	void* Buffers = mmap(nullptr, BufferSize * NumBuffers, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (Buffers == MAP_FAILED)
+	{
+		const int ErrNo = errno;
+		UE_LOG(LogUnixAsyncIO, Warning, TEXT("Unable to allocate %d io_uring buffers of %d KB: errno=%d (%s)"), NumBuffers, (int32)(BufferSize / 1024), ErrNo, UTF8_TO_TCHAR(strerror(ErrNo)));
+		return;
+	}
+
+	TArray<struct iovec> IoVectors;
+	IoVectors.SetNumUninitialized(NumBuffers);
+	for (int32 BufferIndex = 0; BufferIndex < NumBuffers; ++BufferIndex)
+	{
+		IoVectors[BufferIndex].iov_base = (uint8*)Buffers + BufferIndex * BufferSize;
+		IoVectors[BufferIndex].iov_len = BufferSize;
+	}
+	if (syscall(__NR_io_uring_register, RingFileDescriptor, IoUringABI::RegisterBuffers, IoVectors.GetData(), NumBuffers) < 0)
+	{
+		// Registered buffers are locked in memory and count against RLIMIT_MEMLOCK
+		const int ErrNo = errno;
+		UE_LOG(LogUnixAsyncIO, Warning, TEXT("Unable to register %d io_uring buffers of %d KB: errno=%d (%s)"), NumBuffers, (int32)(BufferSize / 1024), ErrNo, UTF8_TO_TCHAR(strerror(ErrNo)));
+		munmap(Buffers, BufferSize * NumBuffers);
+		return;
+	}
+
+	RegisteredBufferMemory = (uint8*)Buffers;
+	RegisteredBufferSize = BufferSize;
+	NumRegisteredBuffers = NumBuffers;
+	FreeRegisteredBuffers.Reserve(NumBuffers);
+	for (int32 BufferIndex = NumBuffers - 1; BufferIndex >= 0; --BufferIndex)
+	{
+		FreeRegisteredBuffers.Add(BufferIndex);
+	}
+}
+
+int32 FUnixIoUring::AllocRegisteredBuffer(int64 Size)
+{
+	if (Size > (int64)RegisteredBufferSize)
+	{
+		return INDEX_NONE;
+	}
+	FScopeLock Lock(&RegisteredBuffersCritical);
+	return FreeRegisteredBuffers.Num() ? FreeRegisteredBuffers.Pop(false) : INDEX_NONE;
+}
+
+void FUnixIoUring::FreeRegisteredBuffer(int32 BufferIndex)
+{
+	FScopeLock Lock(&RegisteredBuffersCritical);
+	FreeRegisteredBuffers.Add(BufferIndex);
+}
+
+void FUnixIoUring::Submit(FUnixIoUringReadRequest* Request, bool bResubmit)
+{
+	// The completion thread can't wait for room, it is the one making it
+	if (FPlatformTLS::GetCurrentThreadId() == CompletionThreadId)
+	{
+		DeferredSubmissions.Add({ Request, bResubmit });
+		return;
+	}
+
+	if (!bResubmit)
+	{
+		while (!TryReserveInFlight())
+		{
+			FPlatformProcess::Sleep(0.0f);
+		}
+	}
+
+	QueueSubmission(Request);
+	FlushSubmissions();
+}
+
+void FUnixIoUring::QueueSubmission(FUnixIoUringReadRequest* Request)
+{
+	FScopeLock Lock(&SubmissionCritical);
+	while (GetNumQueued() == SqEntries)
+	{
+		// Entries are only left queued while another thread is entering the kernel, or when it is out of resources
+		if (!SubmitQueued())
+		{
+			WaitForKernelResources();
+		}
+	}
+	const uint32 Tail = *SqTail;
+	const uint32 Index = Tail & SqMask;
+	Request->PrepareSubmission(Sqes[Index]);
+	SqArray[Index] = Index;
+	IoUringABI::StoreRelease(SqTail, Tail + 1);
+}
+
+void FUnixIoUring::SubmitDeferred()
+{
+	if (!DeferredSubmissions.Num())
+	{
+		return;
+	}
+
+	// Reaping while waiting for kernel resources may defer more reads, so work on a copy
+	TArray<FDeferredSubmission> Pending = MoveTemp(DeferredSubmissions);
+	TArray<FDeferredSubmission> Throttled;
+	for (const FDeferredSubmission& Deferred : Pending)
+	{
+		// Resubmitted reads already hold their slot and always go, otherwise they could take up all of MaxInFlight
+		// without anything in the kernel left to complete. New reads stay in order once one of them doesn't fit.
+		if (Deferred.bResubmit || (!Throttled.Num() && TryReserveInFlight()))
+		{
+			QueueSubmission(Deferred.Request);
+		}
+		else
+		{
+			Throttled.Add(Deferred);
+		}
+	}
+	Throttled.Append(DeferredSubmissions);
+	DeferredSubmissions = MoveTemp(Throttled);
+
+	FlushSubmissions();
+}
+
+void FUnixIoUring::WaitForKernelResources()
+{
+	if (FPlatformTLS::GetCurrentThreadId() == CompletionThreadId)
+	{
+		ReapCompletions();
+	}
+	else
+	{
+		FPlatformProcess::Sleep(0.0f);
+	}
+}
+
+void FUnixIoUring::FlushSubmissions()
+{
+	// Entries queued while another thread is in the kernel are picked up by its next iteration, which checks again
+	// after releasing the lock so nothing queued in between is left behind
+	while (GetNumQueued() && EnterCritical.TryLock())
+	{
+		const bool bSubmitted = SubmitQueued();
+		EnterCritical.Unlock();
+		if (!bSubmitted)
+		{
+			WaitForKernelResources();
+		}
+	}
+}
+
+bool FUnixIoUring::SubmitQueued()
+{
+	const uint32 NumQueued = GetNumQueued();
+	if (!NumQueued)
+	{
+		return true;
+	}
+	if (syscall(__NR_io_uring_enter, RingFileDescriptor, NumQueued, 0, 0, nullptr, 0) < 0)
+	{
+		const int ErrNo = errno;
+		if (ErrNo != EINTR && ErrNo != EAGAIN && ErrNo != EBUSY)
+		{
+			UE_LOG(LogUnixAsyncIO, Fatal, TEXT("io_uring_enter failed to submit %u reads: errno=%d (%s)"), NumQueued, ErrNo, UTF8_TO_TCHAR(strerror(ErrNo)));
+		}
+		return ErrNo == EINTR;
+	}
+	return true;
+}
+
+uint32 FUnixIoUring::Run()
+{
+	for (;;)
+	{
+		if (syscall(__NR_io_uring_enter, RingFileDescriptor, 0, 1, IoUringABI::EnterGetEvents, nullptr, 0) < 0)
+		{
+			const int ErrNo = errno;
+			if (ErrNo != EINTR && ErrNo != EAGAIN && ErrNo != EBUSY)
+			{
+				UE_LOG(LogUnixAsyncIO, Fatal, TEXT("io_uring_enter failed to wait for completions: errno=%d (%s)"), ErrNo, UTF8_TO_TCHAR(strerror(ErrNo)));
+			}
+		}
+		ReapCompletions();
+		SubmitDeferred();
+	}
+	return 0;
+}
+
+void FUnixIoUring::ReapCompletions()
+{
+	struct FCompletion
+	{
+		FUnixIoUringReadRequest* Request;
+		int32 Result;
+	};
+	TArray<FCompletion, TInlineAllocator<64>> Completions;
+
+	// Empty the completion queue before calling back, so the kernel has room for what the callbacks read next
+	uint32 Head = *CqHead;
+	const uint32 Tail = IoUringABI::LoadAcquire(CqTail);
+	for (; Head != Tail; ++Head)
+	{
+		const IoUringABI::FCompletionQueueEntry& Cqe = Cqes[Head & CqMask];
+		Completions.Add({ (FUnixIoUringReadRequest*)(UPTRINT)Cqe.UserData, Cqe.Result });
+	}
+	IoUringABI::StoreRelease(CqHead, Head);
+
+	for (const FCompletion& Completion : Completions)
+	{
+		if (Completion.Request->OnReadCompleted(Completion.Result))
+		{
+			NumInFlight.Decrement();
+		}
+	}
+}
+
+bool UnixAsyncIO::IsAvailable()
+{
+	return GUnixUseIoUring && FUnixIoUring::Get();
+}
+
+IAsyncReadFileHandle* UnixAsyncIO::CreateAsyncReadFileHandle(int32 FileDescriptor, const TCHAR* Filename)
+{
+	FUnixIoUring* Ring = FUnixIoUring::Get();
+	check(Ring);
+	return new FUnixIoUringAsyncReadFileHandle(*Ring, FileDescriptor, Filename);
+}
+
+#else
+
+bool UnixAsyncIO::IsAvailable()
+{
+	return false;
+}
+
+IAsyncReadFileHandle* UnixAsyncIO::CreateAsyncReadFileHandle(int32 FileDescriptor, const TCHAR* Filename)
+{
+	checkNoEntry();
+	return nullptr;
+}
+
+#endif // PLATFORM_LINUX
@@ -0,0 +1,27 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+
+class IAsyncReadFileHandle;
+
+/**
+ * Async file reads on top of io_uring.
+ *
+ * All handles share one submission and completion ring. Reads are queued as submission queue entries and whichever
+ * thread enters the kernel submits everything queued up to then, so reads issued back to back from several threads go
+ * out in one system call. One completion thread reaps the completion queue and calls the request callbacks, no thread
+ * blocks per request. Small reads can go through buffers registered with the ring, see unix.IoUring.RegisteredBuffers.
+ *
+ * When io_uring is disabled (unix.IoUring 0) or the kernel doesn't support it (before 5.5, or blocked by seccomp),
+ * FUnixPlatformFile::OpenAsyncRead falls back to the generic thread pool implementation.
+ */
+namespace UnixAsyncIO
+{
+	/** True if new async read handles should use io_uring, sets up the ring the first time it is called */
+	bool IsAvailable();
+
+	/** Creates an io_uring async read handle for an open file, which owns the file descriptor from then on. Requires IsAvailable(). */
+	IAsyncReadFileHandle* CreateAsyncReadFileHandle(int32 FileDescriptor, const TCHAR* Filename);
+}
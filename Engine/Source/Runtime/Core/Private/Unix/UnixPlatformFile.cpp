@@ -11,6 +11,7 @@
 
 #include "HAL/PlatformFileCommon.h"
 #include "HAL/PlatformFilemanager.h"
+#include "UnixAsyncIO.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogUnixPlatformFile, Log, All);
 
@@ -924,6 +925,21 @@ IFileHandle* FUnixPlatformFile::OpenRead(const TCHAR* Filename, bool bAllowWrite
 	return GFileRegistry.InitialOpenFile(*NormalizeFilename(Filename, false));
 }
 
+IAsyncReadFileHandle* FUnixPlatformFile::OpenAsyncRead(const TCHAR* Filename)
+{
+	if (UnixAsyncIO::IsAvailable())
+	{
+		FString MappedToName;
+		int32 Handle = GCaseInsensMapper.OpenCaseInsensitiveRead(NormalizeFilename(Filename, false), MappedToName);
+		if (Handle != -1)
+		{
+			return UnixAsyncIO::CreateAsyncReadFileHandle(Handle, *MappedToName);
+		}
+	}
+	// files that can't be opened get a generic handle as well, its requests fail the way callers expect
+	return IPhysicalPlatformFile::OpenAsyncRead(Filename);
+}
+
 IFileHandle* FUnixPlatformFile::OpenWrite(const TCHAR* Filename, bool bAppend, bool bAllowRead)
 {
 	int Flags = O_CREAT | O_CLOEXEC;	// prevent children from inheriting this
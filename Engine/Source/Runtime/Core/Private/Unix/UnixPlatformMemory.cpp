@@ -17,6 +17,7 @@
 #include "HAL/MallocJemalloc.h"
 #include "HAL/MallocBinned.h"
 #include "HAL/MallocBinned2.h"
+#include "HAL/MallocBinned3.h"
 #include "HAL/MallocReplayProxy.h"
 #include "HAL/MallocStomp.h"
 #include "HAL/PlatformMallocCrash.h"
@@ -165,6 +166,14 @@ class FMalloc* FUnixPlatformMemory::BaseAllocator()
 					break;
 				}
 
+#if PLATFORM_64BITS
+				if (FCStringAnsi::Stricmp(Arg, "-binnedmalloc3") == 0)
+				{
+					AllocatorToUse = EMemoryAllocatorToUse::Binned3;
+					break;
+				}
+#endif // PLATFORM_64BITS
+
 				if (FCStringAnsi::Stricmp(Arg, "-fullcrashcallstack") == 0)
 				{
 					GFullCrashCallstack = true;
@@ -265,6 +274,12 @@ class FMalloc* FUnixPlatformMemory::BaseAllocator()
 		Allocator = new FMallocBinned2();
 		break;
 
+#if PLATFORM_64BITS
+	case EMemoryAllocatorToUse::Binned3:
+		Allocator = new FMallocBinned3();
+		break;
+#endif // PLATFORM_64BITS
+
 	default:	// intentional fall-through
 	case EMemoryAllocatorToUse::Binned:
 		Allocator = new FMallocBinned(FPlatformMemory::GetConstants().BinnedPageSize & MAX_uint32, 0x100000000);
@@ -0,0 +1,461 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Containers/Map.h"
+#include "Containers/FlatSet.h"
+
+/**
+ * A map of keys to values implemented as a TFlatSet of key-value pairs.
+ *
+ * It has a mostly identical interface to TMap and takes the same KeyFuncs, so hot maps can be migrated
+ * one at a time. See TFlatSet for the storage layout and for how it differs from TSet; in particular
+ * references to keys and values are only valid until the next change to the map, there is no
+ * equivalent of TMultiMap, and iteration order is unspecified.
+ */
+template <typename KeyType, typename ValueType, typename Allocator /*= FDefaultAllocator*/, typename KeyFuncs /*= TDefaultMapHashableKeyFuncs<KeyType, ValueType, false>*/>
+class TFlatMap
+{
+	template <typename OtherKeyType, typename OtherValueType, typename OtherAllocator, typename OtherKeyFuncs>
+	friend class TFlatMap;
+
+public:
+	typedef typename TTypeTraits<KeyType  >::ConstPointerType KeyConstPointerType;
+	typedef typename TTypeTraits<KeyType  >::ConstInitType    KeyInitType;
+	typedef typename TTypeTraits<ValueType>::ConstInitType    ValueInitType;
+	typedef TPair<KeyType, ValueType> ElementType;
+
+	TFlatMap() = default;
+	TFlatMap(TFlatMap&&) = default;
+	TFlatMap(const TFlatMap&) = default;
+	TFlatMap& operator=(TFlatMap&&) = default;
+	TFlatMap& operator=(const TFlatMap&) = default;
+
+	/** Constructor which gets its elements from a native initializer list */
+	TFlatMap(std::initializer_list<ElementType> InitList)
+	{
+		Reserve((int32)InitList.size());
+		for (const ElementType& Element : InitList)
+		{
+			Add(Element.Key, Element.Value);
+		}
+	}
+
+	/** Copies the pairs of a TMap, which makes migrating existing maps easy to measure. */
+	template<typename OtherSetAllocator, typename OtherKeyFuncs>
+	explicit TFlatMap(const TMap<KeyType, ValueType, OtherSetAllocator, OtherKeyFuncs>& Other)
+	{
+		Reserve(Other.Num());
+		for (const auto& Pair : Other)
+		{
+			Add(Pair.Key, Pair.Value);
+		}
+	}
+
+	/**
+	 * Removes all elements from the map.
+	 *
+	 * @param ExpectedNumElements The number of elements about to be added to the map.
+	 */
+	FORCEINLINE void Empty(int32 ExpectedNumElements = 0)
+	{
+		Pairs.Empty(ExpectedNumElements);
+	}
+
+	/** Efficiently empties out the map but preserves all allocations and capacities */
+	FORCEINLINE void Reset()
+	{
+		Pairs.Reset();
+	}
+
+	/** Shrinks the pair set to avoid slack. */
+	FORCEINLINE void Shrink()
+	{
+		Pairs.Shrink();
+	}
+
+	/** Preallocates enough memory to contain Number elements */
+	FORCEINLINE void Reserve(int32 Number)
+	{
+		Pairs.Reserve(Number);
+	}
+
+	/** @return The number of elements in the map. */
+	FORCEINLINE int32 Num() const
+	{
+		return Pairs.Num();
+	}
+
+	/**
+	 * Helper function to return the amount of memory allocated by this container.
+	 * Only returns the size of allocations made directly by the container, not the elements themselves.
+	 * @return number of bytes allocated by this container
+	 */
+	FORCEINLINE uint32 GetAllocatedSize() const
+	{
+		return Pairs.GetAllocatedSize();
+	}
+
+	/** Tracks the container's memory use through an archive. */
+	FORCEINLINE void CountBytes(FArchive& Ar) const
+	{
+		Pairs.CountBytes(Ar);
+	}
+
+	/**
+	 * Set the value associated with a key.
+	 *
+	 * @param InKey The key to associate the value with.
+	 * @param InValue The value to associate with the key.
+	 * @return A reference to the value as stored in the map. The reference is only valid until the next change to any key in the map.
+	 */
+	FORCEINLINE ValueType& Add(const KeyType&  InKey, const ValueType&  InValue) { return Emplace(                   InKey ,                    InValue ); }
+	FORCEINLINE ValueType& Add(const KeyType&  InKey,       ValueType&& InValue) { return Emplace(                   InKey , MoveTempIfPossible(InValue)); }
+	FORCEINLINE ValueType& Add(      KeyType&& InKey, const ValueType&  InValue) { return Emplace(MoveTempIfPossible(InKey),                    InValue ); }
+	FORCEINLINE ValueType& Add(      KeyType&& InKey,       ValueType&& InValue) { return Emplace(MoveTempIfPossible(InKey), MoveTempIfPossible(InValue)); }
+
+	/**
+	 * Set a default value associated with a key.
+	 *
+	 * @param InKey The key to associate the value with.
+	 * @return A reference to the value as stored in the map. The reference is only valid until the next change to any key in the map.
+	 */
+	FORCEINLINE ValueType& Add(const KeyType&  InKey) { return Emplace(                   InKey ); }
+	FORCEINLINE ValueType& Add(      KeyType&& InKey) { return Emplace(MoveTempIfPossible(InKey)); }
+
+	/**
+	 * Sets the value associated with a key.
+	 *
+	 * @param InKey The key to associate the value with.
+	 * @param InValue The value to associate with the key.
+	 * @return A reference to the value as stored in the map. The reference is only valid until the next change to any key in the map.
+	 */
+	template <typename InitKeyType, typename InitValueType>
+	ValueType& Emplace(InitKeyType&& InKey, InitValueType&& InValue)
+	{
+		return Pairs.Emplace(TPairInitializer<InitKeyType&&, InitValueType&&>(Forward<InitKeyType>(InKey), Forward<InitValueType>(InValue))).Value;
+	}
+
+	/**
+	 * Set a default value associated with a key.
+	 *
+	 * @param InKey The key to associate the value with.
+	 * @return A reference to the value as stored in the map. The reference is only valid until the next change to any key in the map.
+	 */
+	template <typename InitKeyType>
+	ValueType& Emplace(InitKeyType&& InKey)
+	{
+		return Pairs.Emplace(TKeyInitializer<InitKeyType&&>(Forward<InitKeyType>(InKey))).Value;
+	}
+
+	/**
+	 * Remove all value associations for a key.
+	 *
+	 * @param InKey The key to remove associated values for.
+	 * @return The number of values that were associated with the key.
+	 */
+	FORCEINLINE int32 Remove(KeyConstPointerType InKey)
+	{
+		return Pairs.Remove(InKey);
+	}
+
+	/** See Remove() and the ByHash() comment on TMapBase */
+	template<typename ComparableKey>
+	FORCEINLINE int32 RemoveByHash(uint32 KeyHash, const ComparableKey& Key)
+	{
+		return Pairs.RemoveByHash(KeyHash, Key);
+	}
+
+	/**
+	 * Removes the pair with the specified key and copies the value that was removed to the ref parameter
+	 *
+	 * @param Key The key to search for
+	 * @param OutRemovedValue If found, the value that was removed (not modified if the key was not found)
+	 * @return whether or not the key was found
+	 */
+	bool RemoveAndCopyValue(KeyInitType Key, ValueType& OutRemovedValue)
+	{
+		const uint32 KeyHash = KeyFuncs::GetKeyHash(Key);
+		ElementType* Pair = Pairs.FindByHash(KeyHash, Key);
+		if (!Pair)
+		{
+			return false;
+		}
+
+		OutRemovedValue = MoveTempIfPossible(Pair->Value);
+		Pairs.RemoveByHash(KeyHash, Key);
+		return true;
+	}
+
+	/**
+	 * Find a pair with the specified key, removes it from the map, and returns the value part of the pair.
+	 *
+	 * If no pair was found, an exception is thrown.
+	 *
+	 * @param Key the key to search for
+	 * @return whether or not the key was found
+	 */
+	ValueType FindAndRemoveChecked(KeyConstPointerType Key)
+	{
+		const uint32 KeyHash = KeyFuncs::GetKeyHash(Key);
+		ElementType* Pair = Pairs.FindByHash(KeyHash, Key);
+		check(Pair != nullptr);
+		ValueType Result = MoveTempIfPossible(Pair->Value);
+		Pairs.RemoveByHash(KeyHash, Key);
+		return Result;
+	}
+
+	/**
+	 * Find the value associated with a specified key.
+	 *
+	 * @param Key The key to search for.
+	 * @return A pointer to the value associated with the specified key, or nullptr if the key isn't contained in this map.  The pointer
+	 *			is only valid until the next change to any key in the map.
+	 */
+	FORCEINLINE ValueType* Find(KeyConstPointerType Key)
+	{
+		if (ElementType* Pair = Pairs.Find(Key))
+		{
+			return &Pair->Value;
+		}
+
+		return nullptr;
+	}
+	FORCEINLINE const ValueType* Find(KeyConstPointerType Key) const
+	{
+		return const_cast<TFlatMap*>(this)->Find(Key);
+	}
+
+	/** See Find() and the ByHash() comment on TMapBase */
+	template<typename ComparableKey>
+	FORCEINLINE ValueType* FindByHash(uint32 KeyHash, const ComparableKey& Key)
+	{
+		if (ElementType* Pair = Pairs.FindByHash(KeyHash, Key))
+		{
+			return &Pair->Value;
+		}
+
+		return nullptr;
+	}
+	template<typename ComparableKey>
+	FORCEINLINE const ValueType* FindByHash(uint32 KeyHash, const ComparableKey& Key) const
+	{
+		return const_cast<TFlatMap*>(this)->FindByHash(KeyHash, Key);
+	}
+
+private:
+	template <typename InitKeyType>
+	ValueType& FindOrAddImpl(uint32 KeyHash, InitKeyType&& Key)
+	{
+		if (ElementType* Pair = Pairs.FindByHash(KeyHash, Key))
+		{
+			return Pair->Value;
+		}
+
+		return Pairs.EmplaceByHash(KeyHash, TKeyInitializer<InitKeyType&&>(Forward<InitKeyType>(Key))).Value;
+	}
+
+public:
+
+	/**
+	 * Find the value associated with a specified key, or if none exists,
+	 * adds a value using the default constructor.
+	 *
+	 * @param Key The key to search for.
+	 * @return A reference to the value associated with the specified key.
+	 */
+	FORCEINLINE ValueType& FindOrAdd(const KeyType&  Key) { return FindOrAddImpl(KeyFuncs::GetKeyHash(Key),                    Key ); }
+	FORCEINLINE ValueType& FindOrAdd(      KeyType&& Key) { return FindOrAddImpl(KeyFuncs::GetKeyHash(Key), MoveTempIfPossible(Key)); }
+
+	/**
+	 * Find a reference to the value associated with a specified key.
+	 *
+	 * @param Key The key to search for.
+	 * @return The value associated with the specified key, or triggers an assertion if the key does not exist.
+	 */
+	FORCEINLINE const ValueType& FindChecked(KeyConstPointerType Key) const
+	{
+		const ElementType* Pair = Pairs.Find(Key);
+		check(Pair != nullptr);
+		return Pair->Value;
+	}
+	FORCEINLINE ValueType& FindChecked(KeyConstPointerType Key)
+	{
+		ElementType* Pair = Pairs.Find(Key);
+		check(Pair != nullptr);
+		return Pair->Value;
+	}
+
+	/**
+	 * Find the value associated with a specified key.
+	 *
+	 * @param Key The key to search for.
+	 * @return The value associated with the specified key, or the default value for the ValueType if the key isn't contained in this map.
+	 */
+	FORCEINLINE ValueType FindRef(KeyConstPointerType Key) const
+	{
+		if (const ElementType* Pair = Pairs.Find(Key))
+		{
+			return Pair->Value;
+		}
+
+		return ValueType();
+	}
+
+	/**
+	 * Check if map contains the specified key.
+	 *
+	 * @param Key The key to check for.
+	 * @return true if the map contains the key.
+	 */
+	FORCEINLINE bool Contains(KeyConstPointerType Key) const
+	{
+		return Pairs.Contains(Key);
+	}
+
+	/** See Contains() and the ByHash() comment on TMapBase */
+	template<typename ComparableKey>
+	FORCEINLINE bool ContainsByHash(uint32 KeyHash, const ComparableKey& Key) const
+	{
+		return Pairs.ContainsByHash(KeyHash, Key);
+	}
+
+	FORCEINLINE       ValueType& operator[](KeyConstPointerType Key)       { return FindChecked(Key); }
+	FORCEINLINE const ValueType& operator[](KeyConstPointerType Key) const { return FindChecked(Key); }
+
+	/**
+	 * Generate an array from the keys in this map.
+	 *
+	 * @param OutArray Will contain the collection of keys.
+	 */
+	template<typename ArrayAllocator> void GenerateKeyArray(TArray<KeyType, ArrayAllocator>& OutArray) const
+	{
+		OutArray.Empty(Pairs.Num());
+		for (const ElementType& Pair : Pairs)
+		{
+			OutArray.Add(Pair.Key);
+		}
+	}
+
+	/**
+	 * Generate an array from the values in this map.
+	 *
+	 * @param OutArray Will contain the collection of values.
+	 */
+	template<typename ArrayAllocator> void GenerateValueArray(TArray<ValueType, ArrayAllocator>& OutArray) const
+	{
+		OutArray.Empty(Pairs.Num());
+		for (const ElementType& Pair : Pairs)
+		{
+			OutArray.Add(Pair.Value);
+		}
+	}
+
+	/** Serializer. */
+	FORCEINLINE friend FArchive& operator<<(FArchive& Ar, TFlatMap& Map)
+	{
+		Ar << Map.Pairs;
+		return Ar;
+	}
+
+private:
+	typedef TFlatSet<ElementType, KeyFuncs, Allocator> ElementSetType;
+
+	/** The base of TFlatMap iterators. */
+	template<bool bConst>
+	class TBaseIterator
+	{
+	protected:
+		typedef typename TChooseClass<bConst, typename ElementSetType::TConstIterator, typename ElementSetType::TIterator>::Result PairItType;
+		typedef typename TChooseClass<bConst, const TFlatMap, TFlatMap>::Result MapType;
+		typedef typename TChooseClass<bConst, const KeyType, KeyType>::Result ItKeyType;
+		typedef typename TChooseClass<bConst, const ValueType, ValueType>::Result ItValueType;
+		typedef typename TChooseClass<bConst, const typename ElementSetType::ElementType, typename ElementSetType::ElementType>::Result PairType;
+
+	public:
+		FORCEINLINE TBaseIterator(const PairItType& InElementIt)
+			: PairIt(InElementIt)
+		{
+		}
+
+		FORCEINLINE TBaseIterator& operator++()
+		{
+			++PairIt;
+			return *this;
+		}
+
+		/** conversion to "bool" returning true if the iterator is valid. */
+		FORCEINLINE explicit operator bool() const
+		{
+			return !!PairIt;
+		}
+		/** inverse of the "bool" operator */
+		FORCEINLINE bool operator !() const
+		{
+			return !(bool)*this;
+		}
+
+		FORCEINLINE ItKeyType&   Key()   const { return PairIt->Key; }
+		FORCEINLINE ItValueType& Value() const { return PairIt->Value; }
+
+		FORCEINLINE PairType& operator* () const { return  *PairIt; }
+		FORCEINLINE PairType* operator->() const { return &*PairIt; }
+
+	protected:
+		PairItType PairIt;
+	};
+
+public:
+
+	/** Map const iterator. */
+	class TConstIterator : public TBaseIterator<true>
+	{
+	public:
+		FORCEINLINE TConstIterator(const TFlatMap& InMap)
+			: TBaseIterator<true>(InMap.Pairs.CreateConstIterator())
+		{
+		}
+	};
+
+	/** Map iterator. */
+	class TIterator : public TBaseIterator<false>
+	{
+	public:
+		FORCEINLINE TIterator(TFlatMap& InMap)
+			: TBaseIterator<false>(InMap.Pairs.CreateIterator())
+		{
+		}
+
+		/** Removes the current pair from the map. */
+		FORCEINLINE void RemoveCurrent()
+		{
+			this->PairIt.RemoveCurrent();
+		}
+	};
+
+	/** Creates an iterator over all the pairs in this map */
+	FORCEINLINE TIterator CreateIterator()
+	{
+		return TIterator(*this);
+	}
+
+	/** Creates a const iterator over all the pairs in this map */
+	FORCEINLINE TConstIterator CreateConstIterator() const
+	{
+		return TConstIterator(*this);
+	}
+
+	/**
+	 * DO NOT USE DIRECTLY
+	 * STL-like iterators to enable range-based for loop support.
+	 */
+	FORCEINLINE auto begin()       { return Pairs.begin(); }
+	FORCEINLINE auto begin() const { return Pairs.begin(); }
+	FORCEINLINE auto end()         { return Pairs.end(); }
+	FORCEINLINE auto end() const   { return Pairs.end(); }
+
+private:
+	/** A set of the key-value pairs in the map. */
+	ElementSetType Pairs;
+};
@@ -0,0 +1,783 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "HAL/UnrealMemory.h"
+#include "Math/UnrealMathUtility.h"
+#include "Templates/ChooseClass.h"
+#include "Templates/MemoryOps.h"
+#include "Templates/TypeCompatibleBytes.h"
+#include "Templates/UnrealTemplate.h"
+#include "Containers/ContainerAllocationPolicies.h"
+#include "Containers/Array.h"
+#include "Containers/Set.h"
+#include "Serialization/Archive.h"
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	#include <emmintrin.h>
+	#define UE_FLATHASH_SSE2 1
+#else
+	#define UE_FLATHASH_SSE2 0
+#endif
+
+namespace FlatHash_Private
+{
+	/** Control byte values. Full slots store the low 7 bits of the hash, so they never have the top bit set. */
+	enum : int8
+	{
+		CtrlEmpty = -128,
+		CtrlDeleted = -2,
+		CtrlSentinel = -1,
+	};
+
+	/** Number of control bytes probed at once. */
+	enum { GroupWidth = 16 };
+
+	/** A key hash split into the probe start position (H1) and the 7 bits kept in the control byte (H2). */
+	struct FHash
+	{
+		uint32 H1;
+		int8 H2;
+	};
+
+	FORCEINLINE FHash SplitHash(uint32 KeyHash)
+	{
+		// GetTypeHash is the identity for integers, so spread the bits before using them for both the position and the tag
+		const uint64 Mixed = uint64(KeyHash) * 0x9E3779B97F4A7C15ull;
+		FHash Result;
+		Result.H1 = uint32(Mixed >> 32);
+		Result.H2 = int8((Mixed >> 25) & 0x7F);
+		return Result;
+	}
+
+	/** GroupWidth control bytes starting at an arbitrary position, the masks returned have one bit per byte. */
+	struct FGroup
+	{
+#if UE_FLATHASH_SSE2
+		explicit FORCEINLINE FGroup(const int8* Pos)
+			: Ctrl(_mm_loadu_si128((const __m128i*)Pos))
+		{
+		}
+
+		FORCEINLINE uint32 Match(int8 H2) const
+		{
+			return uint32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(H2), Ctrl)));
+		}
+
+		FORCEINLINE uint32 MatchEmpty() const
+		{
+			return Match(CtrlEmpty);
+		}
+
+		FORCEINLINE uint32 MatchEmptyOrDeleted() const
+		{
+			return uint32(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(CtrlSentinel), Ctrl)));
+		}
+
+		__m128i Ctrl;
+#else
+		explicit FORCEINLINE FGroup(const int8* Pos)
+			: Ctrl(Pos)
+		{
+		}
+
+		FORCEINLINE uint32 Match(int8 H2) const
+		{
+			uint32 Result = 0;
+			for (int32 Index = 0; Index < GroupWidth; ++Index)
+			{
+				Result |= uint32(Ctrl[Index] == H2) << Index;
+			}
+			return Result;
+		}
+
+		FORCEINLINE uint32 MatchEmpty() const
+		{
+			return Match(CtrlEmpty);
+		}
+
+		FORCEINLINE uint32 MatchEmptyOrDeleted() const
+		{
+			uint32 Result = 0;
+			for (int32 Index = 0; Index < GroupWidth; ++Index)
+			{
+				Result |= uint32(Ctrl[Index] < CtrlSentinel) << Index;
+			}
+			return Result;
+		}
+
+		const int8* Ctrl;
+#endif
+	};
+
+	/** Number of elements a table of the given capacity holds before it needs to grow (7/8 load factor). */
+	FORCEINLINE int32 CapacityToGrowth(int32 Capacity)
+	{
+		return Capacity - Capacity / 8;
+	}
+
+	/** Smallest power of two capacity that holds the given number of elements. */
+	FORCEINLINE int32 GrowthToCapacity(int32 Growth)
+	{
+		const int32 MinCapacity = Growth + (Growth + 6) / 7;
+		return (int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::Max<int32>(MinCapacity, GroupWidth));
+	}
+}
+
+/**
+ * An open addressing hash set with the same KeyFuncs and allocator customization points as TSet.
+ *
+ * Elements are stored inline in a power of two slot array, next to an array of one byte control
+ * tags holding 7 bits of each element's hash. Lookups compare 16 tags at once (with SSE2 where
+ * available) and only touch the elements whose tag matches, so a hit usually costs one miss on
+ * the tags and one on the element instead of walking TSet's bucket array, hash chain and sparse array.
+ *
+ * Differences with TSet:
+ * - Duplicate keys are not supported.
+ * - There are no stable element ids; pointers and references to elements are invalidated when the set grows or is rehashed.
+ * - Iteration order is unspecified and changes when the set grows. Removing elements does not move other elements.
+ * - The allocator is an array allocator (e.g. FDefaultAllocator or TInlineAllocator), used for both the slots and the control bytes.
+ */
+template<typename InElementType, typename KeyFuncs /*= DefaultKeyFuncs<InElementType>*/, typename Allocator /*= FDefaultAllocator*/>
+class TFlatSet
+{
+	static_assert(!KeyFuncs::bAllowDuplicateKeys, "TFlatSet does not support duplicate keys.");
+
+	typedef TTypeCompatibleBytes<InElementType> FSlot;
+
+public:
+	typedef InElementType ElementType;
+	typedef typename KeyFuncs::KeyInitType     KeyInitType;
+	typedef typename KeyFuncs::ElementInitType ElementInitType;
+
+	/** Initialization constructor. */
+	FORCEINLINE TFlatSet()
+		: NumElements(0)
+		, GrowthLeft(0)
+	{
+	}
+
+	/** Copy constructor. */
+	TFlatSet(const TFlatSet& Copy)
+		: TFlatSet()
+	{
+		*this = Copy;
+	}
+
+	/** Move constructor. */
+	TFlatSet(TFlatSet&& Other)
+		: TFlatSet()
+	{
+		*this = MoveTemp(Other);
+	}
+
+	/** Initializer list constructor. */
+	TFlatSet(std::initializer_list<ElementType> InitList)
+		: TFlatSet()
+	{
+		Reserve((int32)InitList.size());
+		for (const ElementType& Element : InitList)
+		{
+			Add(Element);
+		}
+	}
+
+	/** Destructor. */
+	~TFlatSet()
+	{
+		DestructElements();
+	}
+
+	/** Assignment operator. */
+	TFlatSet& operator=(const TFlatSet& Copy)
+	{
+		if (this != &Copy)
+		{
+			Empty(Copy.Num());
+			for (const ElementType& Element : Copy)
+			{
+				Add(Element);
+			}
+		}
+		return *this;
+	}
+
+	/** Move assignment operator. */
+	TFlatSet& operator=(TFlatSet&& Other)
+	{
+		if (this != &Other)
+		{
+			DestructElements();
+			Control = MoveTemp(Other.Control);
+			Slots = MoveTemp(Other.Slots);
+			NumElements = Other.NumElements;
+			GrowthLeft = Other.GrowthLeft;
+			Other.NumElements = 0;
+			Other.GrowthLeft = 0;
+		}
+		return *this;
+	}
+
+	/**
+	 * Removes all elements from the set, potentially leaving space allocated for an expected number of elements about to be added.
+	 * @param ExpectedNumElements - The number of elements about to be added to the set.
+	 */
+	void Empty(int32 ExpectedNumElements = 0)
+	{
+		DestructElements();
+		Control.Empty();
+		Slots.Empty();
+		NumElements = 0;
+		GrowthLeft = 0;
+		if (ExpectedNumElements > 0)
+		{
+			Rehash(FlatHash_Private::GrowthToCapacity(ExpectedNumElements));
+		}
+	}
+
+	/** Efficiently empties out the set but preserves all allocations and capacities */
+	void Reset()
+	{
+		DestructElements();
+		if (GetCapacity())
+		{
+			FMemory::Memset(Control.GetData(), FlatHash_Private::CtrlEmpty, Control.Num());
+		}
+		NumElements = 0;
+		GrowthLeft = FlatHash_Private::CapacityToGrowth(GetCapacity());
+	}
+
+	/** Preallocates enough memory to contain Number elements */
+	void Reserve(int32 Number)
+	{
+		if (Number > NumElements + GrowthLeft)
+		{
+			Rehash(FMath::Max(GetCapacity(), FlatHash_Private::GrowthToCapacity(Number)));
+		}
+	}
+
+	/** Shrinks the slot array to the smallest power of two that holds the current elements, dropping tombstones. */
+	void Shrink()
+	{
+		if (NumElements == 0)
+		{
+			Empty();
+		}
+		else if (FlatHash_Private::GrowthToCapacity(NumElements) < GetCapacity())
+		{
+			Rehash(FlatHash_Private::GrowthToCapacity(NumElements));
+		}
+	}
+
+	/** @return the number of elements. */
+	FORCEINLINE int32 Num() const
+	{
+		return NumElements;
+	}
+
+	/** @return the number of slots, a power of two or zero. */
+	FORCEINLINE int32 GetCapacity() const
+	{
+		return Slots.Num();
+	}
+
+	/**
+	 * Helper function to return the amount of memory allocated by this container.
+	 * Only returns the size of allocations made directly by the container, not the elements themselves.
+	 * @return number of bytes allocated by this container
+	 */
+	FORCEINLINE uint32 GetAllocatedSize() const
+	{
+		return Control.GetAllocatedSize() + Slots.GetAllocatedSize();
+	}
+
+	/** Tracks the container's memory use through an archive. */
+	FORCEINLINE void CountBytes(FArchive& Ar) const
+	{
+		Control.CountBytes(Ar);
+		Slots.CountBytes(Ar);
+	}
+
+	/**
+	 * Adds an element to the set.
+	 *
+	 * @param	InElement					Element to add to set
+	 * @param	bIsAlreadyInSetPtr	[out]	Optional pointer to bool that will be set depending on whether element is already in set
+	 * @return	A reference to the element in the set, valid until the set is modified.
+	 */
+	FORCEINLINE ElementType& Add(const ElementType&  InElement, bool* bIsAlreadyInSetPtr = nullptr) { return Emplace(InElement, bIsAlreadyInSetPtr); }
+	FORCEINLINE ElementType& Add(      ElementType&& InElement, bool* bIsAlreadyInSetPtr = nullptr) { return Emplace(MoveTempIfPossible(InElement), bIsAlreadyInSetPtr); }
+
+	/**
+	 * Adds an element to the set. If an element with the same key already exists, it is replaced.
+	 *
+	 * @param	Args						The argument(s) to be forwarded to the set element's constructor.
+	 * @param	bIsAlreadyInSetPtr	[out]	Optional pointer to bool that will be set depending on whether element is already in set
+	 * @return	A reference to the element in the set, valid until the set is modified.
+	 */
+	template <typename ArgsType>
+	ElementType& Emplace(ArgsType&& Args, bool* bIsAlreadyInSetPtr = nullptr)
+	{
+		FSlot Temp;
+		ElementType& NewElement = *new ((void*)&Temp) ElementType(Forward<ArgsType>(Args));
+		return AddRelocated(KeyFuncs::GetKeyHash(KeyFuncs::GetSetKey(NewElement)), NewElement, bIsAlreadyInSetPtr);
+	}
+
+	/**
+	 * Adds an element to the set, using a precomputed key hash. See the ByHash comment on TMapBase.
+	 */
+	template <typename ArgsType>
+	ElementType& EmplaceByHash(uint32 KeyHash, ArgsType&& Args, bool* bIsAlreadyInSetPtr = nullptr)
+	{
+		FSlot Temp;
+		ElementType& NewElement = *new ((void*)&Temp) ElementType(Forward<ArgsType>(Args));
+		return AddRelocated(KeyHash, NewElement, bIsAlreadyInSetPtr);
+	}
+
+	/**
+	 * Finds an element with the given key in the set.
+	 * @param Key - The key to search for.
+	 * @return A pointer to an element with the given key.  If no element in the set has the given key, this will return NULL.
+	 */
+	FORCEINLINE ElementType* Find(KeyInitType Key)
+	{
+		const int32 Index = FindIndexByHash(KeyFuncs::GetKeyHash(Key), Key);
+		return Index != INDEX_NONE ? &GetSlot(Index) : nullptr;
+	}
+
+	FORCEINLINE const ElementType* Find(KeyInitType Key) const
+	{
+		return const_cast<TFlatSet*>(this)->Find(Key);
+	}
+
+	/**
+	 * Finds an element with a pre-calculated hash and a key that can be compared to KeyType.
+	 * @see	Class documentation section on ByHash() functions
+	 * @return The element id that matches the key and hash or an invalid element id
+	 */
+	template<typename ComparableKey>
+	FORCEINLINE ElementType* FindByHash(uint32 KeyHash, const ComparableKey& Key)
+	{
+		const int32 Index = FindIndexByHash(KeyHash, Key);
+		return Index != INDEX_NONE ? &GetSlot(Index) : nullptr;
+	}
+
+	template<typename ComparableKey>
+	FORCEINLINE const ElementType* FindByHash(uint32 KeyHash, const ComparableKey& Key) const
+	{
+		return const_cast<TFlatSet*>(this)->FindByHash(KeyHash, Key);
+	}
+
+	/**
+	 * Checks if the element contains an element with the given key.
+	 * @param Key - The key to check for.
+	 * @return true if the set contains an element with the given key.
+	 */
+	FORCEINLINE bool Contains(KeyInitType Key) const
+	{
+		return FindIndexByHash(KeyFuncs::GetKeyHash(Key), Key) != INDEX_NONE;
+	}
+
+	template<typename ComparableKey>
+	FORCEINLINE bool ContainsByHash(uint32 KeyHash, const ComparableKey& Key) const
+	{
+		return FindIndexByHash(KeyHash, Key) != INDEX_NONE;
+	}
+
+	/**
+	 * Removes the element with the given key.
+	 * @param Key - The key of the element to remove.
+	 * @return The number of elements removed.
+	 */
+	int32 Remove(KeyInitType Key)
+	{
+		return RemoveByHash(KeyFuncs::GetKeyHash(Key), Key);
+	}
+
+	template<typename ComparableKey>
+	int32 RemoveByHash(uint32 KeyHash, const ComparableKey& Key)
+	{
+		const int32 Index = FindIndexByHash(KeyHash, Key);
+		if (Index == INDEX_NONE)
+		{
+			return 0;
+		}
+		RemoveAtIndex(Index);
+		return 1;
+	}
+
+	/** @return a TArray of the elements */
+	TArray<ElementType> Array() const
+	{
+		TArray<ElementType> Result;
+		Result.Reserve(Num());
+		for (const ElementType& Element : *this)
+		{
+			Result.Add(Element);
+		}
+		return Result;
+	}
+
+	/** Serializer. */
+	friend FArchive& operator<<(FArchive& Ar, TFlatSet& Set)
+	{
+		Set.CountBytes(Ar);
+
+		int32 SerializeNum = Set.Num();
+		Ar << SerializeNum;
+
+		if (Ar.IsLoading())
+		{
+			if (SerializeNum < 0)
+			{
+				Ar.SetError();
+				return Ar;
+			}
+
+			Set.Empty(SerializeNum);
+			for (int32 Index = 0; Index < SerializeNum; ++Index)
+			{
+				ElementType Element;
+				Ar << Element;
+				Set.Add(MoveTemp(Element));
+			}
+		}
+		else
+		{
+			for (ElementType& Element : Set)
+			{
+				Ar << Element;
+			}
+		}
+		return Ar;
+	}
+
+private:
+
+	/** The base type of iterators */
+	template<bool bConst>
+	class TBaseIterator
+	{
+	protected:
+		typedef typename TChooseClass<bConst, const TFlatSet, TFlatSet>::Result SetType;
+		typedef typename TChooseClass<bConst, const ElementType, ElementType>::Result ItElementType;
+
+	public:
+		explicit FORCEINLINE TBaseIterator(SetType& InSet)
+			: Set(InSet)
+			, Index(-1)
+		{
+			Advance();
+		}
+
+		FORCEINLINE TBaseIterator(SetType& InSet, int32 InIndex)
+			: Set(InSet)
+			, Index(InIndex)
+		{
+		}
+
+		/** Advances the iterator to the next element. */
+		FORCEINLINE TBaseIterator& operator++()
+		{
+			Advance();
+			return *this;
+		}
+
+		/** conversion to "bool" returning true if the iterator is valid. */
+		FORCEINLINE explicit operator bool() const
+		{
+			return Index < Set.GetCapacity();
+		}
+		/** inverse of the "bool" operator */
+		FORCEINLINE bool operator !() const
+		{
+			return !(bool)*this;
+		}
+
+		// Accessors.
+		FORCEINLINE ItElementType& operator*() const
+		{
+			return const_cast<ItElementType&>(Set.GetSlot(Index));
+		}
+		FORCEINLINE ItElementType* operator->() const
+		{
+			return &**this;
+		}
+
+		FORCEINLINE friend bool operator==(const TBaseIterator& Lhs, const TBaseIterator& Rhs) { return &Lhs.Set == &Rhs.Set && Lhs.Index == Rhs.Index; }
+		FORCEINLINE friend bool operator!=(const TBaseIterator& Lhs, const TBaseIterator& Rhs) { return &Lhs.Set != &Rhs.Set || Lhs.Index != Rhs.Index; }
+
+	protected:
+		FORCEINLINE void Advance()
+		{
+			const int32 Capacity = Set.GetCapacity();
+			const int8* Ctrl = Set.Control.GetData();
+			while (++Index < Capacity && Ctrl[Index] < 0)
+			{
+			}
+		}
+
+		SetType& Set;
+		int32 Index;
+	};
+
+public:
+
+	/** Used to iterate over the elements of a const TFlatSet. */
+	class TConstIterator : public TBaseIterator<true>
+	{
+	public:
+		FORCEINLINE explicit TConstIterator(const TFlatSet& InSet)
+			: TBaseIterator<true>(InSet)
+		{
+		}
+	};
+
+	/** Used to iterate over the elements of a TFlatSet. */
+	class TIterator : public TBaseIterator<false>
+	{
+	public:
+		FORCEINLINE explicit TIterator(TFlatSet& InSet)
+			: TBaseIterator<false>(InSet)
+		{
+		}
+
+		/** Removes the current element from the set. Other elements do not move, so iteration can continue. */
+		FORCEINLINE void RemoveCurrent()
+		{
+			this->Set.RemoveAtIndex(this->Index);
+		}
+	};
+
+	/** Creates an iterator for the contents of this set */
+	FORCEINLINE TIterator CreateIterator()
+	{
+		return TIterator(*this);
+	}
+
+	/** Creates a const iterator for the contents of this set */
+	FORCEINLINE TConstIterator CreateConstIterator() const
+	{
+		return TConstIterator(*this);
+	}
+
+	/**
+	 * DO NOT USE DIRECTLY
+	 * STL-like iterators to enable range-based for loop support.
+	 */
+	FORCEINLINE TBaseIterator<false> begin()       { return TBaseIterator<false>(*this); }
+	FORCEINLINE TBaseIterator<true>  begin() const { return TBaseIterator<true>(*this); }
+	FORCEINLINE TBaseIterator<false> end()         { return TBaseIterator<false>(*this, GetCapacity()); }
+	FORCEINLINE TBaseIterator<true>  end() const   { return TBaseIterator<true>(*this, GetCapacity()); }
+
+private:
+
+	FORCEINLINE ElementType& GetSlot(int32 Index)
+	{
+		return *(ElementType*)&Slots.GetData()[Index];
+	}
+
+	FORCEINLINE const ElementType& GetSlot(int32 Index) const
+	{
+		return *(const ElementType*)&Slots.GetData()[Index];
+	}
+
+	/** Sets a control byte, keeping the cloned bytes past the end (used by unaligned group loads that wrap around) in sync. */
+	FORCEINLINE void SetControl(int32 Index, int8 Value)
+	{
+		int8* Ctrl = Control.GetData();
+		Ctrl[Index] = Value;
+		if (Index < FlatHash_Private::GroupWidth)
+		{
+			Ctrl[GetCapacity() + Index] = Value;
+		}
+	}
+
+	template<typename ComparableKey>
+	int32 FindIndexByHash(uint32 KeyHash, const ComparableKey& Key) const
+	{
+		using namespace FlatHash_Private;
+
+		if (NumElements == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		const FHash Hash = SplitHash(KeyHash);
+		const int8* Ctrl = Control.GetData();
+		const uint32 Mask = uint32(GetCapacity()) - 1;
+		uint32 Pos = Hash.H1 & Mask;
+		for (uint32 Step = GroupWidth; ; Step += GroupWidth)
+		{
+			const FGroup Group(Ctrl + Pos);
+			for (uint32 Match = Group.Match(Hash.H2); Match; Match &= Match - 1)
+			{
+				const int32 Index = int32((Pos + FMath::CountTrailingZeros(Match)) & Mask);
+				if (KeyFuncs::Matches(KeyFuncs::GetSetKey(GetSlot(Index)), Key))
+				{
+					return Index;
+				}
+			}
+			if (Group.MatchEmpty())
+			{
+				return INDEX_NONE;
+			}
+			// triangular probing visits every group of a power of two table
+			Pos = (Pos + Step) & Mask;
+		}
+	}
+
+	/** @return the first empty or deleted slot on the probe sequence of H1. */
+	int32 FindFirstNonFull(uint32 H1) const
+	{
+		using namespace FlatHash_Private;
+
+		const int8* Ctrl = Control.GetData();
+		const uint32 Mask = uint32(GetCapacity()) - 1;
+		uint32 Pos = H1 & Mask;
+		for (uint32 Step = GroupWidth; ; Step += GroupWidth)
+		{
+			const uint32 Match = FGroup(Ctrl + Pos).MatchEmptyOrDeleted();
+			if (Match)
+			{
+				return int32((Pos + FMath::CountTrailingZeros(Match)) & Mask);
+			}
+			Pos = (Pos + Step) & Mask;
+		}
+	}
+
+	/** Moves an element constructed by the caller into the set, replacing any element with the same key. */
+	ElementType& AddRelocated(uint32 KeyHash, ElementType& NewElement, bool* bIsAlreadyInSetPtr)
+	{
+		const int32 ExistingIndex = FindIndexByHash(KeyHash, KeyFuncs::GetSetKey(NewElement));
+		if (bIsAlreadyInSetPtr)
+		{
+			*bIsAlreadyInSetPtr = ExistingIndex != INDEX_NONE;
+		}
+		if (ExistingIndex != INDEX_NONE)
+		{
+			// Destruct the existing element and relocate the new one into its place, as TSet does.
+			MoveByRelocate(GetSlot(ExistingIndex), NewElement);
+			return GetSlot(ExistingIndex);
+		}
+
+		const int32 Index = PrepareInsert(FlatHash_Private::SplitHash(KeyHash));
+		RelocateConstructItems<ElementType>((void*)&Slots.GetData()[Index], &NewElement, 1);
+		return GetSlot(Index);
+	}
+
+	/** Claims a slot for a key that is known not to be in the set, growing if needed. */
+	int32 PrepareInsert(const FlatHash_Private::FHash& Hash)
+	{
+		int32 Index = GetCapacity() ? FindFirstNonFull(Hash.H1) : INDEX_NONE;
+		if (Index == INDEX_NONE || (GrowthLeft == 0 && Control[Index] != FlatHash_Private::CtrlDeleted))
+		{
+			RehashForInsert();
+			Index = FindFirstNonFull(Hash.H1);
+		}
+		if (Control[Index] == FlatHash_Private::CtrlEmpty)
+		{
+			--GrowthLeft;
+		}
+		SetControl(Index, Hash.H2);
+		++NumElements;
+		return Index;
+	}
+
+	void RemoveAtIndex(int32 Index)
+	{
+		using namespace FlatHash_Private;
+
+		DestructItem(&GetSlot(Index));
+		--NumElements;
+
+		// If no probe could have seen a full group around this slot, it can go straight back to empty instead of becoming a tombstone.
+		const uint32 Mask = uint32(GetCapacity()) - 1;
+		const uint32 IndexBefore = (uint32(Index) - GroupWidth) & Mask;
+		const uint32 EmptyAfter = FGroup(Control.GetData() + Index).MatchEmpty();
+		const uint32 EmptyBefore = FGroup(Control.GetData() + IndexBefore).MatchEmpty();
+		const bool bWasNeverFull = EmptyBefore && EmptyAfter &&
+			(FMath::CountTrailingZeros(EmptyAfter) + (FMath::CountLeadingZeros(EmptyBefore) - (32 - GroupWidth))) < uint32(GroupWidth);
+
+		SetControl(Index, bWasNeverFull ? int8(CtrlEmpty) : int8(CtrlDeleted));
+		GrowthLeft += bWasNeverFull ? 1 : 0;
+	}
+
+	void RehashForInsert()
+	{
+		const int32 Capacity = GetCapacity();
+		if (Capacity == 0)
+		{
+			Rehash(FlatHash_Private::GroupWidth);
+		}
+		else if (NumElements <= FlatHash_Private::CapacityToGrowth(Capacity) / 2)
+		{
+			// mostly tombstones, clean them up without growing
+			Rehash(Capacity);
+		}
+		else
+		{
+			Rehash(Capacity * 2);
+		}
+	}
+
+	/** Moves all elements into a new table of the given power of two capacity. */
+	void Rehash(int32 NewCapacity)
+	{
+		using namespace FlatHash_Private;
+
+		checkSlow(FMath::IsPowerOfTwo(NewCapacity) && NewCapacity >= GroupWidth);
+		check(NewCapacity >= NumElements);
+
+		TArray<int8, Allocator> OldControl = MoveTemp(Control);
+		TArray<FSlot, Allocator> OldSlots = MoveTemp(Slots);
+		const int32 OldCapacity = OldSlots.Num();
+
+		Control.SetNumUninitialized(NewCapacity + GroupWidth);
+		FMemory::Memset(Control.GetData(), CtrlEmpty, Control.Num());
+		Slots.SetNumUninitialized(NewCapacity);
+
+		for (int32 OldIndex = 0; OldIndex < OldCapacity; ++OldIndex)
+		{
+			if (OldControl[OldIndex] >= 0)
+			{
+				ElementType& Element = *(ElementType*)&OldSlots[OldIndex];
+				const FHash Hash = SplitHash(KeyFuncs::GetKeyHash(KeyFuncs::GetSetKey(Element)));
+				const int32 NewIndex = FindFirstNonFull(Hash.H1);
+				SetControl(NewIndex, Hash.H2);
+				RelocateConstructItems<ElementType>((void*)&Slots.GetData()[NewIndex], &Element, 1);
+			}
+		}
+
+		GrowthLeft = CapacityToGrowth(NewCapacity) - NumElements;
+	}
+
+	void DestructElements()
+	{
+		if (!TIsTriviallyDestructible<ElementType>::Value)
+		{
+			const int32 Capacity = GetCapacity();
+			for (int32 Index = 0; Index < Capacity; ++Index)
+			{
+				if (Control[Index] >= 0)
+				{
+					DestructItem(&GetSlot(Index));
+				}
+			}
+		}
+	}
+
+	/** One tag per slot, followed by GroupWidth clones of the first tags. Empty when the set has never allocated. */
+	TArray<int8, Allocator> Control;
+
+	/** Element storage, constructed only where the matching control byte is full. */
+	TArray<FSlot, Allocator> Slots;
+
+	/** Number of constructed elements. */
+	int32 NumElements;
+
+	/** Number of empty slots that can still be filled before the set has to grow or rehash. */
+	int32 GrowthLeft;
+};
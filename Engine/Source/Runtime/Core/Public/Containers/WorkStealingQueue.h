@@ -0,0 +1,168 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Misc/AssertionMacros.h"
+#include "Math/UnrealMathUtility.h"
+#include "Templates/Atomic.h"
+
+/**
+ * Implements a bounded Chase-Lev work stealing deque of pointers.
+ *
+ * The owning thread pushes and pops at the bottom of the deque (LIFO), which keeps recently produced
+ * work hot in its cache. Any other thread may steal from the top of the deque (FIFO), taking the oldest
+ * and usually largest pieces of work.
+ *
+ * The deque does not grow. Push returns false when it is full, and the caller is expected to fall back
+ * to a shared queue. This avoids having to reclaim the ring buffer while thieves may still be reading it.
+ *
+ * As with TCircularQueue, we use the sequentially consistent model for the indices rather than
+ * fine grained fences; the owner's store to Bottom followed by the load of Top in Pop relies on it.
+ *
+ * @param ElementType The type pointed to by the elements held in the deque.
+ * @param Capacity The maximum number of elements, must be a power of two.
+ */
+template<typename ElementType, uint32 Capacity = 1024>
+class TWorkStealingQueue
+{
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+public:
+
+	TWorkStealingQueue()
+		: Top(0)
+		, Bottom(0)
+	{
+		for (uint32 Index = 0; Index < Capacity; ++Index)
+		{
+			Items[Index].Store(nullptr, EMemoryOrder::Relaxed);
+		}
+	}
+
+	/**
+	 * Adds an item to the bottom of the deque.
+	 *
+	 * @param Item The item to add, must not be null.
+	 * @return true if the item was added, false if the deque was full.
+	 * @note To be called only from the owning thread.
+	 */
+	bool Push(ElementType* Item)
+	{
+		checkSlow(Item);
+		const int64 LocalBottom = Bottom.Load(EMemoryOrder::Relaxed);
+		const int64 LocalTop = Top.Load();
+
+		if (LocalBottom - LocalTop >= (int64)Capacity)
+		{
+			return false;
+		}
+
+		Items[LocalBottom & Mask].Store(Item, EMemoryOrder::Relaxed);
+		Bottom.Store(LocalBottom + 1);
+
+		return true;
+	}
+
+	/**
+	 * Removes the most recently pushed item from the bottom of the deque.
+	 *
+	 * @return The item, or nullptr if the deque was empty or the last item was lost to a thief.
+	 * @note To be called only from the owning thread.
+	 */
+	ElementType* Pop()
+	{
+		const int64 LocalBottom = Bottom.Load(EMemoryOrder::Relaxed) - 1;
+		Bottom.Store(LocalBottom);
+		int64 LocalTop = Top.Load();
+
+		if (LocalTop > LocalBottom)
+		{
+			// empty, restore the canonical state
+			Bottom.Store(LocalBottom + 1);
+			return nullptr;
+		}
+
+		ElementType* Result = Items[LocalBottom & Mask].Load(EMemoryOrder::Relaxed);
+
+		if (LocalTop == LocalBottom)
+		{
+			// last item, race the thieves for it
+			if (!Top.CompareExchange(LocalTop, LocalTop + 1))
+			{
+				Result = nullptr;
+			}
+			Bottom.Store(LocalBottom + 1);
+		}
+
+		return Result;
+	}
+
+	/**
+	 * Removes the oldest item from the top of the deque.
+	 *
+	 * @return The item, or nullptr if the deque was empty or another thread won the race for the item.
+	 * @note Can be called from any thread.
+	 */
+	ElementType* Steal()
+	{
+		int64 LocalTop = Top.Load();
+		const int64 LocalBottom = Bottom.Load();
+
+		if (LocalTop >= LocalBottom)
+		{
+			return nullptr;
+		}
+
+		ElementType* Result = Items[LocalTop & Mask].Load(EMemoryOrder::Relaxed);
+
+		if (!Top.CompareExchange(LocalTop, LocalTop + 1))
+		{
+			return nullptr;
+		}
+
+		return Result;
+	}
+
+	/**
+	 * Checks whether the deque is empty.
+	 *
+	 * Can be called from any thread. The result reflects the calling thread's current
+	 * view. Since no locking is used, different threads may return different results.
+	 *
+	 * @return true if the deque is empty, false otherwise.
+	 */
+	FORCEINLINE bool IsEmpty() const
+	{
+		return Top.Load() >= Bottom.Load();
+	}
+
+	/**
+	 * Gets the number of elements in the deque.
+	 *
+	 * Can be called from any thread, the result is only a hint.
+	 *
+	 * @return Number of queued elements.
+	 */
+	uint32 Num() const
+	{
+		const int64 Count = Bottom.Load() - Top.Load();
+		return Count > 0 ? (uint32)Count : 0;
+	}
+
+private:
+
+	enum { Mask = Capacity - 1 };
+
+	/** Index of the oldest item, advanced by thieves and by the owner when it takes the last item. */
+	TAtomic<int64> Top;
+
+	/** Pad so that the owner and the thieves do not share a cache line. */
+	uint8 PadToAvoidContention[PLATFORM_CACHE_LINE_SIZE - sizeof(int64)];
+
+	/** Index one past the newest item, only written by the owner. */
+	TAtomic<int64> Bottom;
+
+	/** Ring buffer of items. */
+	TAtomic<ElementType*> Items[Capacity];
+};
@@ -208,6 +208,7 @@ enum class ELLMTagSet : uint8
 	macro(VideoStreaming,						"VideoStreaming",				GET_STATFNAME(STAT_VideoStreamingLLM),						GET_STATFNAME(STAT_EngineSummaryLLM),			-1)\
 	macro(PlatformMMIO,							"MMIO",							GET_STATFNAME(STAT_PlatformMMIOLLM),						NAME_None,										-1)\
 	macro(PlatformVM,							"Virtual Memory",				GET_STATFNAME(STAT_PlatformVMLLM),							NAME_None,										-1)\
+	macro(FMallocRemoteFree,					"FMallocRemoteFree",			GET_STATFNAME(STAT_FMallocRemoteFreeLLM),					NAME_None,										-1)\
 
 /*
  * Enum values to be passed in to LLM_SCOPE() macro
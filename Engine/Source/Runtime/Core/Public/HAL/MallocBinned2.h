@@ -35,6 +35,7 @@
 #define DEFAULT_GMallocBinned2BundleCount 64
 #define DEFAULT_GMallocBinned2AllocExtra 32
 #define BINNED2_MAX_GMallocBinned2MaxBundlesBeforeRecycle 8
+#define BINNED2_MAX_ADAPTIVE_BUNDLE_COUNT 512			// Upper bound for a size class bundle count that grew under recycler pressure, the byte limit still applies
 
 #if !defined(AGGRESSIVE_MEMORY_SAVING)
 	#error "AGGRESSIVE_MEMORY_SAVING must be defined"
@@ -308,12 +309,17 @@ class CORE_API FMallocBinned2 final : public FMalloc
 
 	struct FFreeBlockList
 	{
+		FORCEINLINE FFreeBlockList()
+			: BundleCountLimit((uint32)GMallocBinned2BundleCount)
+		{
+		}
+
 		// return true if we actually pushed it
 		FORCEINLINE bool PushToFront(void* InPtr, uint32 InPoolIndex, uint32 InBlockSize)
 		{
 			checkSlow(InPtr);
 
-			if (PartialBundle.Count >= (uint32)GMallocBinned2BundleCount || PartialBundle.Count * InBlockSize >= (uint32)GMallocBinned2BundleSize)
+			if (PartialBundle.Count >= BundleCountLimit || PartialBundle.Count * InBlockSize >= (uint32)GMallocBinned2BundleSize)
 			{
 				if (FullBundle.Head)
 				{
@@ -327,7 +333,7 @@ class CORE_API FMallocBinned2 final : public FMalloc
 		}
 		FORCEINLINE bool CanPushToFront(uint32 InPoolIndex, uint32 InBlockSize)
 		{
-			if (FullBundle.Head && (PartialBundle.Count >= (uint32)GMallocBinned2BundleCount || PartialBundle.Count * InBlockSize >= (uint32)GMallocBinned2BundleSize))
+			if (FullBundle.Head && (PartialBundle.Count >= BundleCountLimit || PartialBundle.Count * InBlockSize >= (uint32)GMallocBinned2BundleSize))
 			{
 				return false;
 			}
@@ -346,13 +352,18 @@ class CORE_API FMallocBinned2 final : public FMalloc
 			return PartialBundle.Head ? PartialBundle.PopHead() : nullptr;
 		}
 
-		// tries to recycle the full bundle, if that fails, it is returned for freeing
-		FBundleNode* RecyleFull(uint32 InPoolIndex);
+		// tries to recycle the full bundle, if that fails, it is returned for freeing along with its block count
+		FBundleNode* RecyleFull(uint32 InPoolIndex, uint32& OutNumBlocks);
 		bool ObtainPartial(uint32 InPoolIndex);
 		FBundleNode* PopBundles(uint32 InPoolIndex);
+		// moves the blocks of a list of bundles into the partial and full bundles, handing full bundles to the global recycler
+		// like PushToFront. Returns the number of blocks taken, blocks that didn't fit are returned in OutLeftoverBundles.
+		uint32 AdoptBundles(FBundleNode* InBundles, uint32 InPoolIndex, uint32 InBlockSize, FBundleNode*& OutLeftoverBundles);
 	private:
 		FBundle PartialBundle;
 		FBundle FullBundle;
+		// max blocks per bundle for this size class, grows when the global recycler can't take our full bundles
+		uint32 BundleCountLimit;
 	};
 
 	struct FPerThreadFreeBlockLists
@@ -385,9 +396,9 @@ class CORE_API FMallocBinned2 final : public FMalloc
 			return FreeLists[InPoolIndex].CanPushToFront(InPoolIndex, InBlockSize);
 		}
 		// returns a bundle that needs to be freed if it can't be recycled
-		FBundleNode* RecycleFullBundle(uint32 InPoolIndex)
+		FBundleNode* RecycleFullBundle(uint32 InPoolIndex, uint32& OutNumBlocks)
 		{
-			return FreeLists[InPoolIndex].RecyleFull(InPoolIndex);
+			return FreeLists[InPoolIndex].RecyleFull(InPoolIndex, OutNumBlocks);
 		}
 		// returns true if we have anything to pop
 		bool ObtainRecycledPartial(uint32 InPoolIndex)
@@ -398,6 +409,11 @@ class CORE_API FMallocBinned2 final : public FMalloc
 		{
 			return FreeLists[InPoolIndex].PopBundles(InPoolIndex);
 		}
+		// takes blocks freed by other threads, returns the number of blocks taken and the bundles that didn't fit
+		uint32 AdoptRemoteBundles(uint32 InPoolIndex, uint32 InBlockSize, FBundleNode* InBundles, FBundleNode*& OutLeftoverBundles)
+		{
+			return FreeLists[InPoolIndex].AdoptBundles(InBundles, InPoolIndex, InBlockSize, OutLeftoverBundles);
+		}
 #if BINNED2_ALLOCATOR_STATS
 	public:
 		int64 AllocatedMemory;
@@ -671,6 +687,8 @@ public:
 	}
 
 	virtual bool ValidateHeap() override;
+	virtual void InitializeStatsMetadata() override;
+	virtual void UpdateStats() override;
 	virtual void Trim(bool bTrimThreadCaches) override;
 	virtual void SetupTLSCachesOnCurrentThread() override;
 	virtual void ClearAndDisableTLSCachesOnCurrentThread() override;
@@ -125,6 +125,17 @@ public:
 
 	// called by destructor or otherwise, idempotent
 	void CloseHistory();
+
+	/**
+	 * Replays a history saved with -mallocsavereplay through FMemory and logs how long it took.
+	 * Start the process with -binnedmalloc2, -binnedmalloc3, -jemalloc or -ansimalloc to compare allocators.
+	 *
+	 * @param Filename				History file written by this proxy
+	 * @param NumThreads			Number of threads each replaying their own copy of the history at the same time
+	 * @param bFreeOnOtherThread	Hand frees to a separate thread without TLS caches, as GC purge and async loading do
+	 * @return false if the history could not be read
+	 */
+	static bool ReplayHistory(const TCHAR* Filename, int32 NumThreads, bool bFreeOnOtherThread);
 };
 
 #endif // UE_USE_MALLOC_REPLAY_PROXY
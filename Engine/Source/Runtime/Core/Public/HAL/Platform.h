@@ -292,6 +292,9 @@
 #ifndef PLATFORM_HAS_BSD_SOCKET_FEATURE_RECVMMSG
 	#define PLATFORM_HAS_BSD_SOCKET_FEATURE_RECVMMSG	0
 #endif
+#ifndef PLATFORM_HAS_BSD_SOCKET_FEATURE_SENDMMSG
+	#define PLATFORM_HAS_BSD_SOCKET_FEATURE_SENDMMSG	0
+#endif
 #ifndef PLATFORM_HAS_BSD_SOCKET_FEATURE_TIMESTAMP
 	#define PLATFORM_HAS_BSD_SOCKET_FEATURE_TIMESTAMP 0
 #endif
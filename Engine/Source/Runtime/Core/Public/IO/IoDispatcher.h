@@ -45,7 +45,8 @@ enum class EIoErrorCode
 	FileNotOpen,
 	WriteError,
 	NotFound,
-	CorruptToc
+	CorruptToc,
+	InvalidParameter
 };
 
 class FIoStatus
@@ -236,6 +237,8 @@ public:
 	CORE_API			FIoBuffer(EAssumeOwnershipTag,	const void* Data, uint64 InSize);
 	CORE_API			FIoBuffer(ECloneTag,			const void* Data, uint64 InSize);
 	CORE_API			FIoBuffer(EWrapTag,				const void* Data, uint64 InSize);
+	/** Wraps memory owned by Owner, e.g. a memory mapped file, which is kept alive as long as the buffer or any view into it is */
+	CORE_API			FIoBuffer(EWrapTag,				const void* Data, uint64 InSize, const FRefCountBase* Owner);
 
 	// Note: we currently rely on implicit move constructor, thus we do not declare any
 	//		 destructor or copy/assignment operators or copy constructors
@@ -266,6 +269,7 @@ private:
 		explicit	BufCore(uint64 InSize);
 					BufCore(const uint8* InData, uint64 InSize, bool InOwnsMemory);
 					BufCore(const uint8* InData, uint64 InSize, const BufCore* InOuter);
+					BufCore(const uint8* InData, uint64 InSize, const FRefCountBase* InMemoryOwner);
 					BufCore(ECloneTag, uint8* InData, uint64 InSize);
 
 					BufCore(const BufCore& Rhs) = delete;
@@ -334,6 +338,9 @@ private:
 		// Ultimately this should probably just be an index into a pool
 		TRefCountPtr<const BufCore>	OuterCore;
 
+		// Owner of wrapped memory that isn't owned by this instance, if any
+		TRefCountPtr<const FRefCountBase>	MemoryOwner;
+
 		// TODO: These two could be packed in the MSB of DataPtr on x64
 		uint8		DataSizeHigh = 0;	// High 8 bits of size (40 bits total)
 		uint8		Flags = 0;
@@ -395,12 +402,17 @@ public:
 	FIoReadOptions() = default;
 	~FIoReadOptions() = default;
 
+	/** Reads Size bytes starting at Offset in the chunk instead of the whole chunk, Size is clamped to the end of the chunk */
 	void SetRange(uint64 Offset, uint32 Size)
 	{
 		RequestedOffset = Offset;
 		RequestedSize	= Size;
 	}
 
+	/**
+	 * Reads into caller provided memory at VaTargetAddress instead of a buffer owned by the dispatcher. The target must be
+	 * big enough for the requested range and stay valid until the request completes, the result then wraps it.
+	 */
 	void SetTargetVa(uint64 VaTargetAddress)
 	{
 		TargetVa = VaTargetAddress;
@@ -411,6 +423,10 @@ public:
 		Flags |= EFlags::GPUMemory;
 	}
 
+	uint64 GetOffset() const	{ return RequestedOffset; }
+	uint32 GetSize() const		{ return RequestedSize; }
+	void* GetTargetVa() const	{ return reinterpret_cast<void*>(TargetVa); }
+
 private:
 	uint64	TargetVa		= 0;
 	uint64	RequestedOffset = 0;
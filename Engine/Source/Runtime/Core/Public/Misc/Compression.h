@@ -100,6 +100,30 @@ struct FCompression
 	 */
 	CORE_API static bool VerifyCompressionFlagsValid(int32 InCompressionFlags);
 
+	/**
+	 * Registers a Zstd dictionary as its own compression format. Data compressed with FormatName is Zstd compressed with
+	 * the dictionary and can only be uncompressed once the same dictionary has been registered under the same name again,
+	 * so register dictionaries before mounting paks or loading anything that uses them. Registering a name again replaces
+	 * the dictionary for everything compressed or uncompressed from then on.
+	 *
+	 * @param	FormatName					Name of the new format, can't be one of the built in formats
+	 * @param	Dictionary					Dictionary, eg from TrainZstdDictionary
+	 * @param	DictionarySize				Size of Dictionary in bytes
+	 * @return true if the dictionary was registered, false if Zstd isn't built in or the dictionary is invalid
+	 */
+	CORE_API static bool RegisterZstdDictionary(FName FormatName, const void* Dictionary, int32 DictionarySize);
+
+	/**
+	 * Trains a Zstd dictionary on samples of the data it will be used for. Dictionaries help most with many small
+	 * buffers that share content, eg the chunks of one kind of asset or save game.
+	 *
+	 * @param	OutDictionary				Trained dictionary
+	 * @param	Samples						Sample buffers, typically thousands of them and about 100 times the dictionary size in total
+	 * @param	MaxDictionarySize			Maximum size of the dictionary in bytes
+	 * @return true if training succeeded
+	 */
+	CORE_API static bool TrainZstdDictionary(TArray<uint8>& OutDictionary, const TArray<TArray<uint8>>& Samples, int32 MaxDictionarySize);
+
 
 
 
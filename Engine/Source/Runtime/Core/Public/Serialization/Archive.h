@@ -17,6 +17,7 @@
 #include "Templates/IsArrayOrRefOfType.h"
 
 class FCustomVersionContainer;
+class FIoBuffer;
 class FLinker;
 class FName;
 class FString;
@@ -893,6 +894,21 @@ public:
 		return this;
 	}
 
+	/**
+	 * Loading archives that read from an FIoBuffer can hand out a view of the next Length bytes instead of copying them,
+	 * so the caller can keep the memory alive by holding on to the view. On success the archive position moves past the
+	 * bytes, on failure nothing is read and the caller should fall back to Serialize.
+	 *
+	 * @param OutView Set to a view of the next Length bytes
+	 * @param Length Number of bytes to view
+	 * @param Alignment Required alignment of the view's data
+	 * @return true if OutView was set
+	 */
+	virtual bool SerializeIoBufferView(FIoBuffer& OutView, int64 Length, uint32 Alignment)
+	{
+		return false;
+	}
+
 	FORCEINLINE bool IsLoading() const
 	{
 		return ArIsLoading;
@@ -6,6 +6,10 @@
 #include "UObject/NameTypes.h"
 #include "Serialization/Archive.h"
 #include "Misc/Compression.h"
+#include "Templates/UniquePtr.h"
+
+template<typename TTask> class FAsyncTask;
+class FUncompressProxyChunkTask;
 
 /*----------------------------------------------------------------------------
 	FArchiveLoadCompressedProxy.
@@ -13,6 +17,9 @@
 
 /**
  * FArchive Proxy to transparently load compressed data from an array.
+ *
+ * The chunks following the one being read are uncompressed on the thread pool ahead of time, up to
+ * Compression.ProxyChunksInFlight of them.
  */
 class CORE_API FArchiveLoadCompressedProxy : public FArchive
 {
@@ -70,6 +77,16 @@ private:
 	 */
 	void DecompressMoreData();
 
+	/** Starts uncompressing the chunks following CurrentIndex in the background until all are busy or the data ends. */
+	void StartAsyncChunks();
+
+	/** Chunks being uncompressed in the background, used round robin so the next one is the oldest. Empty when uncompressing on the calling thread. */
+	TArray<TUniquePtr<FAsyncTask<FUncompressProxyChunkTask>>> AsyncChunks;
+	/** Index of the oldest chunk in AsyncChunks.				*/
+	int32			OldestAsyncChunk;
+	/** Number of chunks being uncompressed in the background.	*/
+	int32			NumPendingAsyncChunks;
+
 	/** Array to write compressed data to.						*/
 	const TArray<uint8>&	CompressedData;
 	/** Current index into compressed data array.				*/
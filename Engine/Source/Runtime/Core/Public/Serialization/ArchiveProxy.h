@@ -264,6 +264,11 @@ public:
 		return InnerArchive.GetCacheableArchive();
 	}
 
+	virtual bool SerializeIoBufferView(FIoBuffer& OutView, int64 Length, uint32 Alignment) override
+	{
+		return InnerArchive.SerializeIoBufferView(OutView, Length, Alignment);
+	}
+
 protected:
 
 	/** Holds the archive that this archive is a proxy to. */
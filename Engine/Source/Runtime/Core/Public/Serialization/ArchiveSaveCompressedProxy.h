@@ -6,6 +6,10 @@
 #include "UObject/NameTypes.h"
 #include "Serialization/Archive.h"
 #include "Misc/Compression.h"
+#include "Templates/UniquePtr.h"
+
+template<typename TTask> class FAsyncTask;
+class FCompressProxyChunkTask;
 
 /*----------------------------------------------------------------------------
 	FArchiveSaveCompressedProxy.
@@ -13,6 +17,10 @@
 
 /**
  * FArchive Proxy to transparently write out compressed data to an array.
+ *
+ * Data is compressed in chunks of LOADING_COMPRESSION_CHUNK_SIZE. Up to Compression.ProxyChunksInFlight chunks are
+ * compressed on the thread pool while serialization carries on, they are appended to the array in order so the data is
+ * the same as when compressing on the calling thread.
  */
 class CORE_API FArchiveSaveCompressedProxy : public FArchive
 {
@@ -70,6 +78,19 @@ public:
 	virtual int64 Tell();
 
 private:
+	/** Compresses the temporary buffer, in the background if chunks are compressed in parallel, and empties it. */
+	void CompressTmpData();
+
+	/** Waits for the oldest chunk being compressed in the background and appends it to the array. */
+	void RetireOldestChunk();
+
+	/** Chunks being compressed in the background, used round robin so the next one is the oldest. Empty when compressing on the calling thread. */
+	TArray<TUniquePtr<FAsyncTask<FCompressProxyChunkTask>>> AsyncChunks;
+	/** Index of the oldest chunk in AsyncChunks.				*/
+	int32			OldestAsyncChunk;
+	/** Number of chunks being compressed in the background.	*/
+	int32			NumPendingAsyncChunks;
+
 	/** Array to write compressed data to.					*/
 	TArray<uint8>&	CompressedData;
 	/** Current index in array.								*/
@@ -28,6 +28,8 @@
 #endif
 
 class FText;
+class FStringView;
+template<typename InElementType> class TArrayView;
 
 /** Maximum size of name. */
 enum {NAME_SIZE	= 1024};
@@ -758,6 +760,17 @@ public:
 	 */
 	FName(const FNameEntrySerialized& LoadedEntry);
 
+	/**
+	 * Creates many FNames at once, with the same results as calling FName(Len, Name) for each string.
+	 *
+	 * All strings are hashed up front and then inserted shard by shard, so each name pool shard lock is
+	 * taken at most once per batch, and not at all when every name already exists.
+	 *
+	 * @param Strings	Strings to create names from, need not be null terminated
+	 * @param OutNames	Receives one name per string, must have the same size as Strings
+	 */
+	static void CreateBatch(TArrayView<const FStringView> Strings, TArrayView<FName> OutNames);
+
 	/**
 	 * Equality operator.
 	 *
@@ -136,6 +136,8 @@ REGISTER_NAME(255,Control)
 REGISTER_NAME(256,Voice)
 REGISTER_NAME(257, Zlib)
 REGISTER_NAME(258, Gzip)
+REGISTER_NAME(259, Zstd)
+REGISTER_NAME(260, LZ4)
 
 // Online
 REGISTER_NAME(280,DGram)
@@ -26,6 +26,7 @@
 #include "Serialization/DeferredMessageLog.h"
 #include "UObject/UObjectThreadContext.h"
 #include "UObject/LinkerManager.h"
+#include "UObject/LinkerImportCache.h"
 #include "Misc/Paths.h"
 #include "Serialization/AsyncLoadingThread.h"
 #include "Misc/ExclusiveLoadPackageTimeTracker.h"
@@ -44,6 +45,8 @@
 #include "UObject/GCScopeLock.h"
 #include "ProfilingDebugging/MiscTrace.h"
 #include "Serialization/LoadTimeTracePrivate.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Async/ParallelFor.h"
 
 #define FIND_MEMORY_STOMPS (1 && (PLATFORM_WINDOWS || PLATFORM_UNIX) && !WITH_EDITORONLY_DATA)
 
@@ -183,6 +186,14 @@ static FAutoConsoleVariableRef CVarEventDrivenLoaderEnabled(
 	ECVF_Default
 );
 
+static int32 GAsyncLoadingSerializeWorkers = 0;
+static FAutoConsoleVariableRef CVarAsyncLoadingSerializeWorkers(
+	TEXT("s.AsyncLoadingSerializeWorkers"),
+	GAsyncLoadingSerializeWorkers,
+	TEXT("[EDL] Number of workers that serialize the ready exports of a package at the same time. Only exports whose class returns true from IsSerializeThreadSafe are serialized on workers, 0 serializes every export on the async loading thread."),
+	ECVF_Default
+	);
+
 int32 GMaxReadyRequestsToStallMB = 30;
 static FAutoConsoleVariableRef CVar_MaxReadyRequestsToStallMB(
 	TEXT("s.MaxReadyRequestsToStallMB"),
@@ -2572,31 +2583,27 @@ void FAsyncPackage::LinkImport(int32 LocalImportIndex)
 				}
 				else
 				{
-					UPackage* ClassPackage = FindObjectFast<UPackage>(NULL, Import.ClassPackage, false, false);
-					if (ClassPackage)
+					UClass* FindClass = FLinkerImportCache::Get().FindClass(Import.ClassPackage, Import.ClassName);
+					if (FindClass)
 					{
-						UClass*	FindClass = FindObjectFast<UClass>(ClassPackage, Import.ClassName, false, false);
-						if (FindClass)
+						UObject* Outer = ImportPackage;
+						if (OuterMostIndex != Import.OuterIndex)
 						{
-							UObject* Outer = ImportPackage;
-							if (OuterMostIndex != Import.OuterIndex)
+							FObjectImport& OuterImport = Linker->Imp(Import.OuterIndex);
+							if (!OuterImport.XObject && !OuterImport.bImportFailed)
 							{
-								FObjectImport& OuterImport = Linker->Imp(Import.OuterIndex);
-								if (!OuterImport.XObject && !OuterImport.bImportFailed)
-								{
-									LinkImport(Import.OuterIndex.ToImport());
-								}
-								if (OuterImport.bImportFailed)
-								{
-									Import.bImportFailed = true;
-									return;
-								}
-								Outer = OuterImport.XObject;
-								UE_CLOG(!Outer, LogStreaming, Fatal, TEXT("Missing outer for import of (%s): %s in %s was not found, but the package exists."), *Desc.NameToLoad.ToString(), *OuterImport.ObjectName.ToString(), *ImportPackage->GetFullName());
+								LinkImport(Import.OuterIndex.ToImport());
+							}
+							if (OuterImport.bImportFailed)
+							{
+								Import.bImportFailed = true;
+								return;
 							}
-							Import.XObject = FLinkerLoad::FindImportFast(FindClass, Outer, Import.ObjectName);
-							UE_CLOG(!Import.XObject, LogStreaming, Fatal, TEXT("Missing import of (%s): %s in %s was not found, but the package exists."), *Desc.NameToLoad.ToString(), *Import.ObjectName.ToString(), *ImportPackage->GetFullName());
+							Outer = OuterImport.XObject;
+							UE_CLOG(!Outer, LogStreaming, Fatal, TEXT("Missing outer for import of (%s): %s in %s was not found, but the package exists."), *Desc.NameToLoad.ToString(), *OuterImport.ObjectName.ToString(), *ImportPackage->GetFullName());
 						}
+						Import.XObject = FLinkerImportCache::Get().FindImport(FindClass, Outer, Import.ObjectName);
+						UE_CLOG(!Import.XObject, LogStreaming, Fatal, TEXT("Missing import of (%s): %s in %s was not found, but the package exists."), *Desc.NameToLoad.ToString(), *Import.ObjectName.ToString(), *ImportPackage->GetFullName());
 					}
 				}
 			}
@@ -2697,6 +2704,7 @@ void FAsyncPackage::DumpDependencies(const TCHAR* Label, FLinkerLoad* DumpLinker
 
 UObject* FAsyncPackage::EventDrivenIndexToObject(FPackageIndex Index, bool bCheckSerialized, FPackageIndex DumpIndex)
 {
+	checkSlow(!FUObjectThreadContext::Get().IsSerializingOnLoaderWorker);
 	UObject* Result = nullptr;
 	if (Index.IsNull())
 	{
@@ -2769,6 +2777,7 @@ UObject* FAsyncPackage::EventDrivenIndexToObject(FPackageIndex Index, bool bChec
 void FAsyncPackage::EventDrivenCreateExport(int32 LocalExportIndex)
 {
 	SCOPED_LOADTIMER(Package_CreateExports);
+	check(!FUObjectThreadContext::Get().IsSerializingOnLoaderWorker);
 	FObjectExport& Export = Linker->ExportMap[LocalExportIndex];
 
 	TRACE_LOADTIME_CREATE_EXPORT_SCOPE(Linker, &Export.Object, Export.SerialOffset, Export.SerialSize, Export.bIsAsset);
@@ -3086,6 +3095,327 @@ void FAsyncPackage::MarkNewObjectForLoadIfItIsAnExport(UObject *Object)
 	}
 }
 
+/**
+ * Reads one export straight from the precache buffer for a loader worker. Resolves names and object references the way
+ * FLinkerLoad does while bForceSimpleIndexToObject is set, but keeps its own position and template so that several
+ * exports of the same linker can be serialized at the same time. Nothing on the linker is written to.
+ */
+class FAsyncExportArchive final : public FArchiveUObject
+{
+public:
+	FAsyncExportArchive(FLinkerLoad& InLinker, int32 InLocalExportIndex, const uint8* InData, UObject* InTemplate, int64 InTotalSize)
+		: Linker(InLinker)
+		, Export(InLinker.ExportMap[InLocalExportIndex])
+		, Data(InData)
+		, Template(InTemplate)
+		, LinkerTotalSize(InTotalSize)
+	{
+		FArchive::operator=(static_cast<FArchive&>(InLinker));
+		SetFilterEditorOnly(InLinker.IsFilterEditorOnly());
+#if DEVIRTUALIZE_FLinkerLoad_Serialize
+		ActiveFPLB->OriginalFastPathLoadBuffer = Data;
+		ActiveFPLB->StartFastPathLoadBuffer = Data;
+		ActiveFPLB->EndFastPathLoadBuffer = Data + Export.SerialSize;
+#endif
+	}
+
+	virtual FString GetArchiveName() const override
+	{
+		return Linker.GetArchiveName();
+	}
+
+	virtual FLinker* GetLinker() override
+	{
+		return &Linker;
+	}
+
+	virtual FUObjectSerializeContext* GetSerializeContext() override
+	{
+		return Linker.GetSerializeContext();
+	}
+
+	virtual UObject* GetArchetypeFromLoader(const UObject* Obj) override
+	{
+		check(Obj == Export.Object);
+		return Template;
+	}
+
+	virtual void Preload(UObject* Object) override
+	{
+		checkf(!Object || !Object->HasAnyFlags(RF_NeedLoad), TEXT("Unable to preload %s while serializing %s on a loader worker."), *Object->GetFullName(), *Export.ObjectName.ToString());
+	}
+
+	virtual void MarkScriptSerializationStart(const UObject* Obj) override
+	{
+		if (Obj == Export.Object)
+		{
+			Export.ScriptSerializationStartOffset = Tell();
+		}
+	}
+
+	virtual void MarkScriptSerializationEnd(const UObject* Obj) override
+	{
+		if (Obj == Export.Object)
+		{
+			Export.ScriptSerializationEndOffset = Tell();
+		}
+	}
+
+	virtual int64 Tell() override
+	{
+		return Export.SerialOffset + GetPos();
+	}
+
+	virtual int64 TotalSize() override
+	{
+		return LinkerTotalSize;
+	}
+
+	virtual void Seek(int64 InPos) override
+	{
+		if (InPos < Export.SerialOffset || InPos > Export.SerialOffset + Export.SerialSize)
+		{
+			UE_LOG(LogStreaming, Error, TEXT("%s: Seek to %lld is outside of export %s (%lld, %lld bytes)"), *GetArchiveName(), InPos, *Export.ObjectName.ToString(), Export.SerialOffset, Export.SerialSize);
+			SetCriticalError();
+			return;
+		}
+		SetPos(InPos - Export.SerialOffset);
+	}
+
+	virtual void Serialize(void* V, int64 Length) override
+	{
+		const int64 Pos = GetPos();
+		if (Length < 0 || Pos + Length > Export.SerialSize)
+		{
+			UE_LOG(LogStreaming, Error, TEXT("%s: Reading %lld bytes at %lld is past the end of export %s (%lld bytes)"), *GetArchiveName(), Length, Export.SerialOffset + Pos, *Export.ObjectName.ToString(), Export.SerialSize);
+			SetCriticalError();
+			if (Length > 0)
+			{
+				FMemory::Memzero(V, Length);
+			}
+			return;
+		}
+		FMemory::Memcpy(V, Data + Pos, Length);
+		SetPos(Pos + Length);
+	}
+
+	using FArchiveUObject::operator<<; // For visibility of the overloads we don't override
+
+	virtual FArchive& operator<<(FName& Name) override
+	{
+		int32 NameIndex;
+		int32 Number = 0;
+		*this << NameIndex << Number;
+
+		if (Linker.ActiveNameMap->IsValidIndex(NameIndex))
+		{
+			Name = FName::CreateFromDisplayId((*Linker.ActiveNameMap)[NameIndex], Number);
+		}
+		else
+		{
+			Name = FName();
+			Linker.BadNameIndexError(NameIndex);
+			SetCriticalError();
+		}
+		return *this;
+	}
+
+	virtual FArchive& operator<<(UObject*& Object) override
+	{
+		FPackageIndex Index;
+		*this << Index;
+
+		if (Index.IsNull())
+		{
+			Object = nullptr;
+		}
+		else if (Index.IsExport() ? !Linker.ExportMap.IsValidIndex(Index.ToExport()) : !Linker.ImportMap.IsValidIndex(Index.ToImport()))
+		{
+			UE_LOG(LogStreaming, Error, TEXT("%s: Bad object index %d in export %s"), *GetArchiveName(), Index.ForDebugging(), *Export.ObjectName.ToString());
+			SetCriticalError();
+			Object = nullptr;
+		}
+		else if (Index.IsExport())
+		{
+			Object = Linker.Exp(Index).Object;
+		}
+		else if (Linker.LocalImportIndices)
+		{
+			check(Linker.GlobalImportObjects);
+			Object = Linker.GlobalImportObjects[Linker.LocalImportIndices[Index.ToImport()]];
+		}
+		else
+		{
+			Object = Linker.Imp(Index).XObject;
+		}
+		return *this;
+	}
+
+	virtual FArchive& operator<<(FLazyObjectPtr& LazyObjectPtr) override
+	{
+		FUniqueObjectGuid ID;
+		*this << ID;
+		LazyObjectPtr = ID;
+		return *this;
+	}
+
+	virtual FArchive& operator<<(FSoftObjectPtr& Value) override
+	{
+		FSoftObjectPath ID;
+		ID.Serialize(*this);
+		Value = ID;
+		return *this;
+	}
+
+private:
+	int64 GetPos() const
+	{
+#if DEVIRTUALIZE_FLinkerLoad_Serialize
+		return ActiveFPLB->StartFastPathLoadBuffer - ActiveFPLB->OriginalFastPathLoadBuffer;
+#else
+		return Pos;
+#endif
+	}
+
+	void SetPos(int64 InPos)
+	{
+#if DEVIRTUALIZE_FLinkerLoad_Serialize
+		ActiveFPLB->StartFastPathLoadBuffer = ActiveFPLB->OriginalFastPathLoadBuffer + InPos;
+#else
+		Pos = InPos;
+#endif
+	}
+
+	void SetCriticalError()
+	{
+		ArIsError = true;
+		ArIsCriticalError = true;
+#if DEVIRTUALIZE_FLinkerLoad_Serialize
+		// Stop the inline fast path from reading any further
+		ActiveFPLB->EndFastPathLoadBuffer = ActiveFPLB->StartFastPathLoadBuffer;
+#endif
+	}
+
+	FLinkerLoad& Linker;
+	FObjectExport& Export;
+	const uint8* Data;
+	UObject* Template;
+	int64 LinkerTotalSize;
+#if !DEVIRTUALIZE_FLinkerLoad_Serialize
+	int64 Pos = 0;
+#endif
+};
+
+bool FAsyncPackage::SerializeExportsOnWorkers()
+{
+	FAsyncArchive* AsyncLoader = Linker->GetAsyncLoader();
+	if (Linker->bDynamicClassLinker || !AsyncLoader || !FApp::ShouldUseThreadingForPerformance())
+	{
+		return false;
+	}
+
+	struct FWorkerExport
+	{
+		int32 LocalExportIndex;
+		const uint8* Data;
+		UObject* Template;
+		int64 SerializedSize;
+	};
+	TArray<FWorkerExport, TInlineAllocator<64>> WorkerExports;
+
+	// Exports that are ready to serialize have no serialize order dependencies left on each other, so the ones whose
+	// Serialize only reads from the archive can all be serialized at once. Structs, CDOs and anything not fully
+	// precached stay with EventDrivenSerializeExport.
+	for (int32 LocalExportIndex : ExportsThatCanBeSerialized)
+	{
+		FObjectExport& Export = Linker->ExportMap[LocalExportIndex];
+		UObject* Object = Export.Object;
+		if (Object && Object->HasAnyFlags(RF_NeedLoad) && !Object->HasAnyFlags(RF_ClassDefaultObject) && !dynamic_cast<UStruct*>(Object) &&
+			Object->IsSerializeThreadSafe() && ExportsInThisBlock.Contains(LocalExportIndex))
+		{
+			if (const uint8* Data = AsyncLoader->GetPrecachedData(Export.SerialOffset, Export.SerialSize))
+			{
+				WorkerExports.Add({ LocalExportIndex, Data, nullptr, 0 });
+			}
+		}
+	}
+	if (WorkerExports.Num() < 2)
+	{
+		return false;
+	}
+
+	SCOPED_LOADTIMER(Package_PreLoadObjects);
+	LastTypeOfWorkPerformed = TEXT("SerializeExportsOnWorkers");
+	LastObjectWorkWasPerformedOn = nullptr;
+
+	FGCScopeGuard GCGuard;
+	for (FWorkerExport& WorkerExport : WorkerExports)
+	{
+		verify(ExportsThatCanBeSerialized.Remove(WorkerExport.LocalExportIndex) == 1);
+		verify(ExportsInThisBlock.Remove(WorkerExport.LocalExportIndex) == 1);
+
+		FObjectExport& Export = Linker->ExportMap[WorkerExport.LocalExportIndex];
+		UObject* Object = Export.Object;
+		check(Object->GetLinker() == Linker);
+		check(Object->GetLinkerIndex() == WorkerExport.LocalExportIndex);
+		AsyncLoader->LogItem(TEXT("SerializeExportsOnWorkers"), Export.SerialOffset, Export.SerialSize);
+
+		// Templates are resolved here, EventDrivenIndexToObject can't run on the workers
+		check(!Export.TemplateIndex.IsNull());
+		WorkerExport.Template = EventDrivenIndexToObject(Export.TemplateIndex, true, FPackageIndex::FromExport(WorkerExport.LocalExportIndex));
+		check(WorkerExport.Template);
+
+		Object->ClearFlags(RF_NeedLoad);
+	}
+	ExportsThatCanBeSerialized.Heapify();
+
+	const int64 LinkerTotalSize = Linker->TotalSize();
+	const int32 NumWorkers = FMath::Min(GAsyncLoadingSerializeWorkers, WorkerExports.Num());
+	FThreadSafeCounter NextExport;
+	ParallelFor(NumWorkers, [this, &WorkerExports, &NextExport, LinkerTotalSize](int32 WorkerIndex)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(AsyncLoadingSerializeWorker);
+		LLM_SCOPE(ELLMTag::UObject);
+		LLM_SCOPED_TAG_WITH_OBJECT_IN_SET(GetLinkerRoot(), ELLMTagSet::Assets);
+		TGuardValue<bool> GuardIsSerializingOnLoaderWorker(FUObjectThreadContext::Get().IsSerializingOnLoaderWorker, true);
+
+		for (int32 Index = NextExport.Increment() - 1; Index < WorkerExports.Num(); Index = NextExport.Increment() - 1)
+		{
+			FWorkerExport& WorkerExport = WorkerExports[Index];
+			UObject* Object = Linker->ExportMap[WorkerExport.LocalExportIndex].Object;
+
+			TRACE_LOADTIME_OBJECT_SCOPE(Object, LoadTimeProfilerObjectEventType_Serialize);
+			FAsyncExportArchive Ar(*Linker, WorkerExport.LocalExportIndex, WorkerExport.Data, WorkerExport.Template, LinkerTotalSize);
+			Object->Serialize(Ar);
+			WorkerExport.SerializedSize = Ar.Tell() - Linker->ExportMap[WorkerExport.LocalExportIndex].SerialOffset;
+		}
+	});
+
+	for (const FWorkerExport& WorkerExport : WorkerExports)
+	{
+		FObjectExport& Export = Linker->ExportMap[WorkerExport.LocalExportIndex];
+		UObject* Object = Export.Object;
+		Object->SetFlags(RF_LoadCompleted);
+
+		if (WorkerExport.SerializedSize != Export.SerialSize)
+		{
+			if (Object->GetClass()->HasAnyClassFlags(CLASS_Deprecated))
+			{
+				UE_LOG(LogStreaming, Warning, TEXT("%s"), *FString::Printf(TEXT("%s: Serial size mismatch: Got %d, Expected %d"), *Object->GetFullName(), (int32)WorkerExport.SerializedSize, Export.SerialSize));
+			}
+			else
+			{
+				UE_LOG(LogStreaming, Fatal, TEXT("%s"), *FString::Printf(TEXT("%s: Serial size mismatch: Got %d, Expected %d"), *Object->GetFullName(), (int32)WorkerExport.SerializedSize, Export.SerialSize));
+			}
+		}
+		RemoveNode(EEventLoadNode::ImportOrExport_Serialize, FPackageIndex::FromExport(WorkerExport.LocalExportIndex));
+	}
+
+	UE_LOG(LogStreaming, Verbose, TEXT("Serialized %d exports of %s on %d workers"), WorkerExports.Num(), *Desc.NameToLoad.ToString(), NumWorkers);
+	LLM_PUSH_STATS_FOR_ASSET_TAGS();
+	return true;
+}
+
 void FAsyncPackage::EventDrivenSerializeExport(int32 LocalExportIndex)
 {
 	SCOPED_LOADTIMER(Package_PreLoadObjects);
@@ -3492,7 +3822,11 @@ EAsyncPackageState::Type FAsyncPackage::ProcessImportsAndExports_Event()
 		{
 			continue; // check time limit, and lets do the creates and new IO requests before the serialize checks
 		}
-		if (ExportsThatCanBeSerialized.Num())
+		if (GAsyncLoadingSerializeWorkers > 0 && ExportsThatCanBeSerialized.Num() > 1 && SerializeExportsOnWorkers())
+		{
+			bDidSomething = true;
+		}
+		else if (ExportsThatCanBeSerialized.Num())
 		{
 			bDidSomething = true;
 			int32 LocalExportIndex = -1;
@@ -703,6 +703,8 @@ public:
 	void EventDrivenCreateExport(int32 LocalExportIndex);
 	void StartPrecacheRequest();
 	void EventDrivenSerializeExport(int32 LocalExportIndex);
+	/** Serializes the ready exports whose classes opt in with IsSerializeThreadSafe on loader workers, returns false if there were too few of them */
+	bool SerializeExportsOnWorkers();
 	int64 PrecacheRequestReady(IAsyncReadRequest * Req);
 	void MakeNextPrecacheRequestCurrent();
 	void FlushPrecacheBuffer();
@@ -65,6 +65,13 @@ public:
 #endif
 	}
 
+	/** Reads from IoBuffer, which must outlive the archive, and can hand out views of it instead of copying */
+	explicit FSimpleArchive(const FIoBuffer& InIoBuffer)
+		: FSimpleArchive(InIoBuffer.Data(), InIoBuffer.DataSize())
+	{
+		IoBuffer = &InIoBuffer;
+	}
+
 	int64 TotalSize() override
 	{
 #if DEVIRTUALIZE_FLinkerLoad_Serialize
@@ -103,6 +110,24 @@ public:
 		ActiveFPLB->StartFastPathLoadBuffer += Length;
 #endif
 	}
+
+	bool SerializeIoBufferView(FIoBuffer& OutView, int64 Length, uint32 Alignment) override
+	{
+#if DEVIRTUALIZE_FLinkerLoad_Serialize
+		if (!IoBuffer || ArIsError || Length <= 0 || ActiveFPLB->StartFastPathLoadBuffer + Length > ActiveFPLB->EndFastPathLoadBuffer || !IsAligned(ActiveFPLB->StartFastPathLoadBuffer, Alignment))
+		{
+			return false;
+		}
+		OutView = FIoBuffer(ActiveFPLB->StartFastPathLoadBuffer, Length, *IoBuffer);
+		ActiveFPLB->StartFastPathLoadBuffer += Length;
+		return true;
+#else
+		return false;
+#endif
+	}
+
+private:
+	const FIoBuffer* IoBuffer = nullptr;
 };
 
 struct FAsyncPackage2;
@@ -994,7 +1019,7 @@ private:
 	uint32 ImportNodeCount = 0;
 	uint32 ExportNodeCount = 0;
 	
-	TUniquePtr<uint8[]> PackageSummaryBuffer;
+	FIoBuffer PackageSummaryBuffer;
 	TArray<FIoBuffer> ExportIoBuffers;
 
 	int32 GlobalImportCount = 0;
@@ -2223,9 +2248,9 @@ EAsyncPackageState::Type FAsyncPackage2::Event_StartImportPackages(FAsyncPackage
 		TRACE_CPUPROFILER_EVENT_SCOPE(SetupSerializedArcs);
 		const TArray<FNameEntryId>* GlobalNameMap = &Package->AsyncLoadingThread.GlobalNameMap.GetNameEntries();
 
-		const FPackageSummary* PackageSummary = reinterpret_cast<const FPackageSummary*>(Package->PackageSummaryBuffer.Get());
+		const FPackageSummary* PackageSummary = reinterpret_cast<const FPackageSummary*>(Package->PackageSummaryBuffer.Data());
 		uint64 ZenHeaderDataSize = PackageSummary->GraphDataSize;
-		const uint8* ZenHeaderData = Package->PackageSummaryBuffer.Get() + PackageSummary->GraphDataOffset;
+		const uint8* ZenHeaderData = Package->PackageSummaryBuffer.Data() + PackageSummary->GraphDataOffset;
 		FSimpleArchive ZenHeaderArchive(ZenHeaderData, ZenHeaderDataSize);
 		int32 InternalArcCount;
 		ZenHeaderArchive << InternalArcCount;
@@ -3031,7 +3056,7 @@ void FAsyncPackage2::EventDrivenSerializeExport(int32 LocalExportIndex)
 		const FPackageFileSummary& Summary = Linker->Summary;
 		const FCustomVersionContainer& SummaryVersions = Summary.GetCustomVersionContainer();
 
-		FSimpleArchive Ar(ExportIoBuffers[LocalExportIndex].Data(), ExportIoBuffers[LocalExportIndex].DataSize());
+		FSimpleArchive Ar(ExportIoBuffers[LocalExportIndex]);
 		Ar.SetUE4Ver(Linker->Summary.GetFileVersionUE4());
 		Ar.SetLicenseeUE4Ver(Linker->Summary.GetFileVersionLicenseeUE4());
 		Ar.SetEngineVer(Linker->Summary.SavedByEngineVersion);
@@ -3236,9 +3261,8 @@ void FAsyncPackage2::ProcessIoRequest(FIoRequest& IoRequest)
 	{
 	case EChunkType::PackageSummary:
 	{
-		FIoBuffer SummaryIoBuffer = IoRequest.GetChunk();
-		PackageSummaryBuffer = MakeUnique<uint8[]>(SummaryIoBuffer.DataSize());
-		FMemory::Memcpy(PackageSummaryBuffer.Get(), SummaryIoBuffer.Data(), SummaryIoBuffer.DataSize());
+		// Kept as is rather than copied, the header and export map are read in place
+		PackageSummaryBuffer = IoRequest.GetChunk();
 		GetNode(EEventLoadNode2::Package_LoadSummary)->ReleaseBarrier();
 		break;
 	}
@@ -4527,7 +4551,7 @@ EAsyncPackageState::Type FAsyncPackage2::FinishLinker()
 	{
 		SCOPED_LOADTIMER(LinkerLoad_FinalizeCreation);
 
-		const FPackageSummary* PackageSummary = reinterpret_cast<const FPackageSummary*>(PackageSummaryBuffer.Get());
+		const FPackageSummary* PackageSummary = reinterpret_cast<const FPackageSummary*>(PackageSummaryBuffer.Data());
 
 		{
 			SCOPED_LOADTIMER(LinkerLoad_SerializePackageFileSummary);
@@ -4566,7 +4590,7 @@ EAsyncPackageState::Type FAsyncPackage2::FinishLinker()
 		if (PackageSummary->ExportCount)
 		{
 			SCOPED_LOADTIMER(LinkerLoad_SerializeExportMap);
-			const FObjectExport* Exports = reinterpret_cast<const FObjectExport*>(PackageSummaryBuffer.Get() + PackageSummary->ExportOffset);
+			const FObjectExport* Exports = reinterpret_cast<const FObjectExport*>(PackageSummaryBuffer.Data() + PackageSummary->ExportOffset);
 
 			Linker->ExportMap.AddUninitialized(PackageSummary->ExportCount);
 			FMemory::Memcpy(Linker->ExportMap.GetData(), Exports, PackageSummary->ExportCount * sizeof(FObjectExport));
@@ -54,6 +54,16 @@ public:
 	IAsyncReadRequest* MakeEventDrivenPrecacheRequest(int64 Offset, int64 BytesToRead, FAsyncFileCallBack* CompleteCallback);
 	void LogItem(const TCHAR* Item, int64 Offset = 0, int64 Size = 0, double StartTime = 0.0);
 
+	/** Returns the precached bytes at [Offset, Offset + Size) without moving the archive, or nullptr if they aren't all in the precache buffer */
+	const uint8* GetPrecachedData(int64 Offset, int64 Size) const
+	{
+		if (!PrecacheBuffer || Size < 0 || Offset < PrecacheStartPos || Offset + Size > PrecacheEndPos)
+		{
+			return nullptr;
+		}
+		return PrecacheBuffer + (Offset - PrecacheStartPos);
+	}
+
 	bool IsCookedForEDLInEditor() const
 	{
 		return bCookedForEDLInEditor;
@@ -17,6 +17,8 @@
 #include "UObject/DebugSerializationFlags.h"
 #include "Serialization/AsyncLoadingPrivate.h"
 #include "Async/MappedFileHandle.h"
+#include "IO/IoDispatcher.h"
+#include "Serialization/BulkDataCache.h"
 #include "HAL/PlatformFilemanager.h"
 #include "UObject/UObjectThreadContext.h"
 #include "ProfilingDebugging/LoadTimeTracker.h"
@@ -155,6 +157,43 @@ void FUntypedBulkData::FAllocatedPtr::UnmapFile()
 	}
 }
 
+/** Mapped region for bulk data that uses part of a memory mapped IoStore container, the view keeps the container mapped even once it's unmounted */
+class FIoBufferMappedRegion final : public IMappedFileRegion
+{
+public:
+	explicit FIoBufferMappedRegion(const FIoBuffer& InView)
+		: IMappedFileRegion(InView.Data(), InView.DataSize(), TEXT("IoBuffer"), 0)
+		, View(InView)
+	{
+	}
+
+private:
+	FIoBuffer View;
+};
+
+void FUntypedBulkData::FAllocatedPtr::MapIoBuffer(const FIoBuffer& View)
+{
+	check(!MappedHandle && !MappedRegion);
+	Deallocate();
+
+	MappedRegion = new FIoBufferMappedRegion(View);
+	Ptr = (void*)(MappedRegion->GetMappedPtr());
+	bAllocated = true;
+}
+
+void FUntypedBulkData::FAllocatedPtr::CopyMapped(int64 Count, int32 Alignment)
+{
+	check(MappedHandle || MappedRegion);
+	void* Copy = Count ? FMemory::Malloc(Count, Alignment) : nullptr;
+	if (Copy)
+	{
+		FMemory::Memcpy(Copy, Ptr, Count);
+	}
+	UnmapFile();
+	Ptr = Copy;
+	bAllocated = true;
+}
+
 /**
  * Constructor, initializing all member variables.
  */
@@ -504,7 +543,9 @@ void FUntypedBulkData::GetCopy( void** Dest, bool bDiscardInternalCopy )
 			// If the internal copy should be discarded and we are still attached to an archive we can
 			// simply "return" the already existing copy and NULL out the internal reference. We can
 			// also do this if the data is single use like e.g. when uploading texture data.
-			if( bDiscardInternalCopy && (CanLoadFromDisk()|| (BulkDataFlags & BULKDATA_SingleUse)) )
+			// Mapped memory isn't ours to give away, it is copied and then discarded instead.
+			const bool bDiscard = bDiscardInternalCopy && (CanLoadFromDisk()|| (BulkDataFlags & BULKDATA_SingleUse));
+			if( bDiscard && !BulkData.IsMapped() )
 			{
 				*Dest = BulkData.ReleaseWithoutDeallocating();
 				ResetAsyncData();
@@ -525,6 +566,12 @@ void FUntypedBulkData::GetCopy( void** Dest, bool bDiscardInternalCopy )
 				{
 					*Dest = nullptr;
 				}
+
+				if( bDiscard )
+				{
+					BulkData.Deallocate();
+					ResetAsyncData();
+				}
 			}
 		}
 		// Data isn't currently loaded so we need to load it from disk.
@@ -564,6 +611,12 @@ void* FUntypedBulkData::Lock( uint32 LockFlags )
 	{
 		LockStatus = LOCKSTATUS_ReadWriteLock;
 
+		// Mapped memory is read only, writers get their own copy
+		if( BulkData.IsMapped() )
+		{
+			BulkData.CopyMapped( GetBulkDataSize(), BulkDataAlignment );
+		}
+
 #if WITH_EDITOR
 		// We need to detach from the archive to not be able to clobber changes by serializing
 		// over them.
@@ -1038,7 +1091,7 @@ void FUntypedBulkData::Serialize( FArchive& Ar, UObject* Owner, int32 Idx, bool
 							// @todo, we really don't want to do this with inline data
 							Ar.Seek(Ar.Tell() + GetBulkDataSize());
 						}
-						else
+						else if (bAttemptFileMapping || !TryAdoptInlinePayload(Ar))
 						{
 							// Force non-lazy loading of inline bulk data to prevent PostLoad spikes.
 							BulkData.Reallocate(GetBulkDataSize(), BulkDataAlignment);
@@ -1133,7 +1186,7 @@ void FUntypedBulkData::Serialize( FArchive& Ar, UObject* Owner, int32 Idx, bool
 				{
 					StartSerializingBulkData(Ar, Owner, Idx, bPayloadInline);
 				}
-				else
+				else if (!bPayloadInline || bAttemptFileMapping || !TryAdoptInlinePayload(Ar))
 				{
 					BulkData.Reallocate( GetBulkDataSize(), BulkDataAlignment );
 
@@ -1474,6 +1527,38 @@ void FUntypedBulkData::SerializeElements(FArchive& Ar, void* Data)
 	}
 }
 
+static int32 GAdoptIoStoreBulkData = 1;
+static FAutoConsoleVariableRef CVarAdoptIoStoreBulkData(
+	TEXT("s.AdoptIoStoreBulkData"),
+	GAdoptIoStoreBulkData,
+	TEXT("If non-zero, inline bulk data loaded from a memory mapped IoStore container uses the container's memory instead of a copy of it."),
+	ECVF_Default
+	);
+
+bool FUntypedBulkData::TryAdoptInlinePayload( FArchive& Ar )
+{
+	const int64 BulkDataSize = GetBulkDataSize();
+	if( !GAdoptIoStoreBulkData
+		|| !Ar.IsLoading()
+		|| BulkDataSize <= 0
+		|| (BulkDataFlags & (BULKDATA_Unused | BULKDATA_SerializeCompressed | BULKDATA_ForceSingleElementSerialization))
+		|| RequiresSingleElementSerialization( Ar ) )
+	{
+		return false;
+	}
+
+	// The payload has to be aligned for its elements and for any alignment asked for explicitly
+	const uint32 Alignment = FMath::Max<uint32>( BulkDataAlignment, FMath::Min<uint32>( FMath::RoundUpToPowerOfTwo( (uint32)GetElementSize() ), 16 ) );
+	FIoBuffer View;
+	if( !Ar.SerializeIoBufferView( View, BulkDataSize, Alignment ) )
+	{
+		return false;
+	}
+
+	BulkData.MapIoBuffer( View );
+	return true;
+}
+
 /**
  * Serialize just the bulk data portion to/ from the passed in memory.
  *
@@ -1747,6 +1832,45 @@ bool FUntypedBulkData::FlushAsyncLoading()
 	return bIsLoadingAsync;
 }
 
+void FUntypedBulkData::PinInCache()
+{
+#if !WITH_EDITOR
+	if (CanLoadFromDisk() && !Filename.IsEmpty())
+	{
+		FBulkDataCache::Get().Pin(GetCacheKey());
+	}
+#endif
+}
+
+void FUntypedBulkData::UnpinInCache()
+{
+#if !WITH_EDITOR
+	if (CanLoadFromDisk() && !Filename.IsEmpty())
+	{
+		FBulkDataCache::Get().Unpin(GetCacheKey());
+	}
+#endif
+}
+
+#if !WITH_EDITOR
+void FUntypedBulkData::RedirectInlinePayloadToExportsFile()
+{
+	if (GEventDrivenLoaderEnabled && (Filename.EndsWith(TEXT(".uasset")) || Filename.EndsWith(TEXT(".umap"))))
+	{
+		BulkDataOffsetInFile -= IFileManager::Get().FileSize(*Filename);
+		check(BulkDataOffsetInFile >= 0);
+		Filename = FPaths::GetBaseFilename(Filename, false) + TEXT(".uexp");
+	}
+}
+
+FBulkDataCacheKey FUntypedBulkData::GetCacheKey()
+{
+	// The key has to be the same before and after the first read from disk redirects the payload
+	RedirectInlinePayloadToExportsFile();
+	return FBulkDataCacheKey(FName(*Filename), BulkDataOffsetInFile, GetBulkDataSize());
+}
+#endif
+
 /**
  * Loads the data from disk into the specified memory block. This requires us still being attached to an
  * archive we can use for serialization.
@@ -1841,6 +1965,14 @@ void FUntypedBulkData::LoadDataIntoMemory( void* Dest )
 		// load from the specied filename when the linker has been cleared
 		checkf( Filename != TEXT(""), TEXT( "Attempted to load bulk data without a proper filename." ) );
 
+		// payloads that were read before may still be cached
+		FBulkDataCache& Cache = FBulkDataCache::Get();
+		const bool bUseCache = Cache.IsEnabled() && GetBulkDataSize() > 0;
+		if (bUseCache && Cache.Find(GetCacheKey(), Dest))
+		{
+			return;
+		}
+
 #if PLATFORM_SUPPORTS_TEXTURE_STREAMING
 		static auto CVarTextureStreamingEnabled = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("r.TextureStreaming"));
 		check(CVarTextureStreamingEnabled);
@@ -1853,12 +1985,7 @@ void FUntypedBulkData::LoadDataIntoMemory( void* Dest )
 		}
 #endif
 
-		if (GEventDrivenLoaderEnabled && (Filename.EndsWith(TEXT(".uasset")) || Filename.EndsWith(TEXT(".umap"))))
-		{
-			BulkDataOffsetInFile -= IFileManager::Get().FileSize(*Filename);
-			check(BulkDataOffsetInFile >= 0);
-			Filename = FPaths::GetBaseFilename(Filename, false) + TEXT(".uexp");
-		}
+		RedirectInlinePayloadToExportsFile();
 
 		FArchive* Ar = IFileManager::Get().CreateFileReader(*Filename, FILEREAD_Silent);
 		checkf( Ar != NULL, TEXT( "Attempted to load bulk data from an invalid filename '%s'." ), *Filename );
@@ -1866,7 +1993,13 @@ void FUntypedBulkData::LoadDataIntoMemory( void* Dest )
 		// Seek to the beginning of the bulk data in the file.
 		Ar->Seek( BulkDataOffsetInFile );
 		SerializeBulkData( *Ar, Dest );
+		const bool bReadFailed = Ar->IsError();
 		delete Ar;
+
+		if (bUseCache && !bReadFailed)
+		{
+			Cache.Add(GetCacheKey(), Dest);
+		}
 	}
 #endif // WITH_EDITOR
 }
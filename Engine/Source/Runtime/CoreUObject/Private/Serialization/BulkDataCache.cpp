@@ -0,0 +1,195 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Serialization/BulkDataCache.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("Bulk Data Cache"), STATGROUP_BulkDataCache, STATCAT_Advanced);
+DECLARE_MEMORY_STAT(TEXT("Cached Payloads"), STAT_BulkDataCache_CachedBytes, STATGROUP_BulkDataCache);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pinned Payloads"), STAT_BulkDataCache_PinnedPayloads, STATGROUP_BulkDataCache);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hits"), STAT_BulkDataCache_Hits, STATGROUP_BulkDataCache);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Misses"), STAT_BulkDataCache_Misses, STATGROUP_BulkDataCache);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Evictions"), STAT_BulkDataCache_Evictions, STATGROUP_BulkDataCache);
+
+CSV_DEFINE_CATEGORY(BulkDataCache, true);
+
+static int32 GBulkDataCacheSizeMB = 0;
+static FAutoConsoleVariableRef CVarBulkDataCacheSizeMB(
+	TEXT("s.BulkDataCacheSizeMB"),
+	GBulkDataCacheSizeMB,
+	TEXT("Budget in MB of the cache of bulk data payloads that are read from disk after load, 0 disables the cache. Payloads over a quarter of the budget aren't cached. Cooked builds only."),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*)
+	{
+		// Start over with the new budget rather than evict to it, payloads are cached again as they are reread
+		FBulkDataCache::Get().Trim();
+	}),
+	ECVF_Default
+	);
+
+/** Most unpinned payloads the cache holds, however small they are */
+static constexpr int32 MaxCachedPayloads = 16384;
+
+FBulkDataCache& FBulkDataCache::Get()
+{
+	static FBulkDataCache Cache;
+	return Cache;
+}
+
+FBulkDataCache::FBulkDataCache()
+	: Unpinned(MaxCachedPayloads)
+	, CachedBytes(0)
+	, TotalHits(0)
+	, TotalMisses(0)
+{
+}
+
+bool FBulkDataCache::IsEnabled() const
+{
+	return GBulkDataCacheSizeMB > 0 && FPlatformProperties::RequiresCookedData();
+}
+
+bool FBulkDataCache::Find(const FBulkDataCacheKey& Key, void* Dest)
+{
+	FPayloadPtr Payload;
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (const FPinnedPayload* PinnedPayload = Pinned.Find(Key))
+		{
+			Payload = PinnedPayload->Payload;
+		}
+		else if (const FPayloadPtr* UnpinnedPayload = Unpinned.FindAndTouch(Key))
+		{
+			Payload = *UnpinnedPayload;
+		}
+		if (Payload.IsValid())
+		{
+			++TotalHits;
+		}
+		else
+		{
+			++TotalMisses;
+		}
+	}
+
+	if (!Payload.IsValid())
+	{
+		INC_DWORD_STAT(STAT_BulkDataCache_Misses);
+		CSV_CUSTOM_STAT(BulkDataCache, Misses, 1, ECsvCustomStatOp::Accumulate);
+		return false;
+	}
+
+	// Payloads are never modified once added, so they can be copied without holding the lock
+	check(Payload->Num() == Key.Size);
+	FMemory::Memcpy(Dest, Payload->GetData(), Key.Size);
+	INC_DWORD_STAT(STAT_BulkDataCache_Hits);
+	CSV_CUSTOM_STAT(BulkDataCache, Hits, 1, ECsvCustomStatOp::Accumulate);
+	return true;
+}
+
+void FBulkDataCache::Add(const FBulkDataCacheKey& Key, const void* Data)
+{
+	const int64 BudgetBytes = (int64)GBulkDataCacheSizeMB * 1024 * 1024;
+	if (Key.Size <= 0 || Key.Size > MAX_int32)
+	{
+		return;
+	}
+
+	// Check before copying the payload, so that payloads that won't be kept aren't copied
+	{
+		FScopeLock Lock(&CriticalSection);
+		const FPinnedPayload* PinnedPayload = Pinned.Find(Key);
+		const bool bWanted = PinnedPayload ? !PinnedPayload->Payload.IsValid() : (Key.Size <= BudgetBytes / 4 && !Unpinned.Contains(Key));
+		if (!bWanted)
+		{
+			return;
+		}
+	}
+
+	FPayloadPtr Payload = MakeShareable(new TArray<uint8>((const uint8*)Data, (int32)Key.Size));
+
+	FScopeLock Lock(&CriticalSection);
+	if (FPinnedPayload* PinnedPayload = Pinned.Find(Key))
+	{
+		if (!PinnedPayload->Payload.IsValid())
+		{
+			PinnedPayload->Payload = MoveTemp(Payload);
+			CachedBytes += Key.Size;
+		}
+	}
+	else if (!Unpinned.Contains(Key))
+	{
+		EvictToBudget(BudgetBytes - Key.Size, MaxCachedPayloads - 1);
+		Unpinned.Add(Key, Payload);
+		CachedBytes += Key.Size;
+	}
+	UpdateStats();
+}
+
+void FBulkDataCache::Pin(const FBulkDataCacheKey& Key)
+{
+	FScopeLock Lock(&CriticalSection);
+	FPinnedPayload& PinnedPayload = Pinned.FindOrAdd(Key);
+	if (PinnedPayload.PinCount++ == 0)
+	{
+		// Out of the LRU list so that it can't be evicted
+		if (const FPayloadPtr* Payload = Unpinned.Find(Key))
+		{
+			PinnedPayload.Payload = *Payload;
+			Unpinned.Remove(Key);
+		}
+	}
+	UpdateStats();
+}
+
+void FBulkDataCache::Unpin(const FBulkDataCacheKey& Key)
+{
+	FScopeLock Lock(&CriticalSection);
+	FPinnedPayload* PinnedPayload = Pinned.Find(Key);
+	if (!ensureMsgf(PinnedPayload, TEXT("Unpinning bulk data payload at %lld in %s that isn't pinned"), Key.Offset, *Key.Filename.ToString()))
+	{
+		return;
+	}
+
+	if (--PinnedPayload->PinCount == 0)
+	{
+		FPayloadPtr Payload = MoveTemp(PinnedPayload->Payload);
+		Pinned.Remove(Key);
+		if (Payload.IsValid())
+		{
+			// Back in the LRU list as the most recently used payload, it is evicted like any other from now on
+			EvictToBudget(MAX_int64, MaxCachedPayloads - 1);
+			Unpinned.Add(Key, Payload);
+			EvictToBudget((int64)GBulkDataCacheSizeMB * 1024 * 1024, MaxCachedPayloads);
+		}
+	}
+	UpdateStats();
+}
+
+void FBulkDataCache::Trim()
+{
+	FScopeLock Lock(&CriticalSection);
+	EvictToBudget(0, 0);
+	UpdateStats();
+
+	UE_LOG(LogSerialization, Log, TEXT("Bulk data cache trimmed, %lld hits and %lld misses so far, %lld bytes left pinned"), TotalHits, TotalMisses, CachedBytes);
+}
+
+void FBulkDataCache::EvictToBudget(int64 BudgetBytes, int32 MaxPayloads)
+{
+	while (Unpinned.Num() > 0 && (CachedBytes > BudgetBytes || Unpinned.Num() > MaxPayloads))
+	{
+		FPayloadPtr Evicted = Unpinned.RemoveLeastRecent();
+		CachedBytes -= Evicted->Num();
+		INC_DWORD_STAT(STAT_BulkDataCache_Evictions);
+		CSV_CUSTOM_STAT(BulkDataCache, Evictions, 1, ECsvCustomStatOp::Accumulate);
+	}
+}
+
+void FBulkDataCache::UpdateStats()
+{
+	SET_MEMORY_STAT(STAT_BulkDataCache_CachedBytes, CachedBytes);
+	SET_DWORD_STAT(STAT_BulkDataCache_PinnedPayloads, Pinned.Num());
+	CSV_CUSTOM_STAT(BulkDataCache, CachedMB, (float)((double)CachedBytes / (1024.0 * 1024.0)), ECsvCustomStatOp::Set);
+}
@@ -16,6 +16,7 @@
 #include "UObject/Object.h"
 #include "UObject/Class.h"
 #include "UObject/UObjectIterator.h"
+#include "UObject/UObjectHash.h"
 #include "UObject/UnrealType.h"
 #include "UObject/LinkerLoad.h"
 #include "UObject/GCObject.h"
@@ -39,6 +40,8 @@
 
 DEFINE_LOG_CATEGORY(LogGarbage);
 
+CSV_DEFINE_CATEGORY(GC, true);
+
 /** Object count during last mark phase																				*/
 FThreadSafeCounter		GObjectCountDuringLastMarkPhase;
 /** Whether incremental object purge is in progress										*/
@@ -155,6 +158,15 @@ static FAutoConsoleVariableRef CVarMinDesiredObjectsPerSubTask(
 	ECVF_Default
 	);
 
+// Maximum number of parallel reachability analysis tasks, 0 means one per worker thread
+static int32 GMaxParallelMarkTasks = 0;
+static FAutoConsoleVariableRef CVarMaxParallelMarkTasks(
+	TEXT("gc.MaxParallelMarkTasks"),
+	GMaxParallelMarkTasks,
+	TEXT("Maximum number of tasks performing parallel reachability analysis, 0 means one per worker thread. Mostly useful for measuring how GC scales."),
+	ECVF_Default
+	);
+
 static int32 GIncrementalBeginDestroyEnabled = 1;
 static FAutoConsoleVariableRef CIncrementalBeginDestroyEnabled(
 	TEXT("gc.IncrementalBeginDestroyEnabled"),
@@ -539,6 +551,11 @@ public:
 		return GMinDesiredObjectsPerSubTask;
 	}
 
+	FORCEINLINE int32 GetMaxParallelTasks() const
+	{
+		return GMaxParallelMarkTasks;
+	}
+
 	void UpdateDetailedStats(UObject* CurrentObject, uint32 DeltaCycles)
 	{
 #if PERF_DETAILED_PER_CLASS_GC_STATS
@@ -998,6 +1015,95 @@ void FReferenceFinder::HandleObjectReference( UObject*& InObject, const UObject*
 	}
 }
 
+// Whether GC sweeps over all objects read the dense GC states four objects at a time
+static int32 GDenseFlagSweeps = 1;
+static FAutoConsoleVariableRef CVarDenseFlagSweeps(
+	TEXT("gc.DenseFlagSweeps"),
+	GDenseFlagSweeps,
+	TEXT("If true, marking objects as unreachable and gathering unreachable objects sweeps over the dense GC state array four objects at a time instead of visiting each object item."),
+	ECVF_Default
+	);
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Mark Sweep Time (ms)"), STAT_GC_MarkSweepTime, STATGROUP_GC);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Gather Sweep Time (ms)"), STAT_GC_GatherSweepTime, STATGROUP_GC);
+
+/**
+ * Helpers for sweeping over GUObjectGCStates four objects at a time. Each 64-bit word holds the states of four consecutive
+ * objects in 16-bit lanes and none of the lane operations below carry from one lane into the next.
+ */
+struct FGCStateSweep
+{
+	static_assert(PLATFORM_LITTLE_ENDIAN, "GC state sweeps expect the state of the first object in the low bits of a word.");
+	static_assert(sizeof(GUObjectGCStates[0]) == sizeof(uint16), "GC state sweeps expect 16-bit GC states.");
+
+	enum { StatesPerWord = 4 };
+
+	/** Replicates a state to all lanes of a word */
+	static constexpr uint64 Lanes(uint16 State)
+	{
+		return uint64(State) * 0x0001000100010001ull;
+	}
+
+	/** Returns the index of the only bit set in State */
+	static constexpr uint32 BitIndex(uint16 State)
+	{
+		return State > 1 ? 1 + BitIndex(State >> 1) : 0;
+	}
+
+	static FORCEINLINE uint64 Load(int32 FirstIndex)
+	{
+		uint64 Word;
+		FMemory::Memcpy(&Word, GUObjectGCStates + FirstIndex, sizeof(Word));
+		return Word;
+	}
+
+	static FORCEINLINE void Store(int32 FirstIndex, uint64 Word)
+	{
+		FMemory::Memcpy(GUObjectGCStates + FirstIndex, &Word, sizeof(Word));
+	}
+
+	/** Returns a word with the lowest bit of each lane set if that lane has State set */
+	static FORCEINLINE uint64 LanesWith(uint64 Word, uint16 State)
+	{
+		return (Word >> BitIndex(State)) & Lanes(1);
+	}
+
+	/**
+	 * Marks plain objects as unreachable: clears ReachableInCluster and sets Unreachable on all allocated objects that aren't
+	 * part of a cluster. Must only be used on words where no object is in the root set, a cluster root or has keep flags.
+	 */
+	static FORCEINLINE uint64 MarkAsUnreachable(uint64 Word)
+	{
+		const uint64 UnreachableLanes = LanesWith(Word, EUObjectGCState::Allocated) & ~LanesWith(Word, EUObjectGCState::ClusterMember);
+		return (Word & ~Lanes(EUObjectGCState::FromFlags(EInternalObjectFlags::ReachableInCluster))) | (UnreachableLanes * EUObjectGCState::FromFlags(EInternalObjectFlags::Unreachable));
+	}
+
+	/** Returns the number of allocated objects in the word */
+	static FORCEINLINE int32 CountAllocated(uint64 Word)
+	{
+		return FMath::CountBits(Word & Lanes(EUObjectGCState::Allocated));
+	}
+
+	/** Clears Flags on all objects in [FirstIndex, LastIndex] */
+	static void ClearFlags(int32 FirstIndex, int32 LastIndex, EInternalObjectFlags Flags)
+	{
+		const uint16 StatesToClear = EUObjectGCState::FromFlags(Flags);
+		int32 Index = FirstIndex;
+		for (; Index + StatesPerWord - 1 <= LastIndex; Index += StatesPerWord)
+		{
+			const uint64 Word = Load(Index);
+			if (Word & Lanes(StatesToClear))
+			{
+				Store(Index, Word & ~Lanes(StatesToClear));
+			}
+		}
+		for (; Index <= LastIndex; ++Index)
+		{
+			GUObjectGCStates[Index] &= ~StatesToClear;
+		}
+	}
+};
+
 /**
  * Implementation of parallel realtime garbage collector using recursive subdivision
  *
@@ -1031,17 +1137,21 @@ public:
 		int32 NumThreads = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
 		int32 NumberOfObjectsPerThread = (MaxNumberOfObjects / NumThreads) + 1;		
 
+		const bool bDenseSweep = !!GDenseFlagSweeps;
+		const double SweepStartTime = FPlatformTime::Seconds();
+
 		// Iterate over all objects. Note that we iterate over the UObjectArray and usually check only internal flags which
 		// are part of the array so we don't suffer from cache misses as much as we would if we were to check ObjectFlags.
-		ParallelFor(NumThreads, [&ObjectsToSerializeList, &ClustersToDissolveList, &KeepClusterRefsList, FastKeepFlags, KeepFlags, NumberOfObjectsPerThread, NumThreads, MaxNumberOfObjects](int32 ThreadIndex)
+		ParallelFor(NumThreads, [&ObjectsToSerializeList, &ClustersToDissolveList, &KeepClusterRefsList, FastKeepFlags, KeepFlags, NumberOfObjectsPerThread, NumThreads, MaxNumberOfObjects, bDenseSweep](int32 ThreadIndex)
 		{
 			// Temporary clamping GUObjectArray.GetFirstGCIndex() is -1 in some rare circumstances UE-76532, until we find a permanent fix
 			int32 FirstObjectIndex = FMath::Max(ThreadIndex * NumberOfObjectsPerThread + GUObjectArray.GetFirstGCIndex(), 0);
 			int32 NumObjects = (ThreadIndex < (NumThreads - 1)) ? NumberOfObjectsPerThread : (MaxNumberOfObjects - (NumThreads - 1) * NumberOfObjectsPerThread);
 			int32 LastObjectIndex = FMath::Min(GUObjectArray.GetObjectArrayNum() - 1, FirstObjectIndex + NumObjects - 1);
 			int32 ObjectCountDuringMarkPhase = 0;
+			bool bClearReachableInCluster = true;
 
-			for (int32 ObjectIndex = FirstObjectIndex; ObjectIndex <= LastObjectIndex; ++ObjectIndex)
+			auto MarkObjectAsUnreachable = [&](int32 ObjectIndex)
 			{
 				FUObjectItem* ObjectItem = &GUObjectArray.GetObjectItemArrayUnsafe()[ObjectIndex];
 				if (ObjectItem->Object)
@@ -1054,7 +1164,10 @@ public:
 					// Keep track of how many objects are around.
 					ObjectCountDuringMarkPhase++;
 					
-					ObjectItem->ClearFlags(EInternalObjectFlags::ReachableInCluster);
+					if (bClearReachableInCluster)
+					{
+						ObjectItem->ClearFlags(EInternalObjectFlags::ReachableInCluster);
+					}
 					// Special case handling for objects that are part of the root set.
 					if (ObjectItem->IsRootSet())
 					{
@@ -1111,10 +1224,49 @@ public:
 						}
 					}
 				}
+			};
+
+			int32 ObjectIndex = FirstObjectIndex;
+			if (bDenseSweep && KeepFlags == RF_NoFlags)
+			{
+				// Words without root set objects, cluster roots or objects with keep flags only need their flags updated, which
+				// is the vast majority of them. Only full words in this thread's range are written to.
+				const uint64 ObjectByObjectStates = FGCStateSweep::Lanes(EUObjectGCState::FromFlags(EInternalObjectFlags::RootSet | EInternalObjectFlags::ClusterRoot | FastKeepFlags));
+				for (; ObjectIndex + FGCStateSweep::StatesPerWord - 1 <= LastObjectIndex; ObjectIndex += FGCStateSweep::StatesPerWord)
+				{
+					const uint64 Word = FGCStateSweep::Load(ObjectIndex);
+					if (Word & ObjectByObjectStates)
+					{
+						for (int32 LaneIndex = 0; LaneIndex < FGCStateSweep::StatesPerWord; ++LaneIndex)
+						{
+							MarkObjectAsUnreachable(ObjectIndex + LaneIndex);
+						}
+					}
+					else
+					{
+						checkSlow(!(Word & FGCStateSweep::Lanes(EUObjectGCState::FromFlags(EInternalObjectFlags::Unreachable))));
+						FGCStateSweep::Store(ObjectIndex, FGCStateSweep::MarkAsUnreachable(Word));
+						ObjectCountDuringMarkPhase += FGCStateSweep::CountAllocated(Word);
+					}
+				}
+			}
+			else if (bDenseSweep)
+			{
+				FGCStateSweep::ClearFlags(FirstObjectIndex, LastObjectIndex, EInternalObjectFlags::ReachableInCluster);
+				bClearReachableInCluster = false;
+			}
+			for (; ObjectIndex <= LastObjectIndex; ++ObjectIndex)
+			{
+				MarkObjectAsUnreachable(ObjectIndex);
 			}
 
 			GObjectCountDuringLastMarkPhase.Add(ObjectCountDuringMarkPhase);
 		}, bForceSingleThreaded);
+
+		const double SweepTime = FPlatformTime::Seconds() - SweepStartTime;
+		INC_FLOAT_STAT_BY(STAT_GC_MarkSweepTime, SweepTime * 1000.0);
+		CSV_CUSTOM_STAT(GC, MarkSweepTime, SweepTime * 1000.0, ECsvCustomStatOp::Set);
+		UE_LOG(LogGarbage, Verbose, TEXT("%f ms for marking objects as unreachable (%s sweep)"), SweepTime * 1000.0, bDenseSweep ? TEXT("dense") : TEXT("per item"));
 		
 		ObjectsToSerializeList.PopAll(ObjectsToSerialize);
 
@@ -1195,16 +1347,19 @@ public:
 		}
 
 		{
+			CSV_SCOPED_TIMING_STAT(GC, MarkObjectsAsUnreachable);
 			const double StartTime = FPlatformTime::Seconds();
 			MarkObjectsAsUnreachable(ObjectsToSerialize, KeepFlags, bForceSingleThreaded);
 			UE_LOG(LogGarbage, Verbose, TEXT("%f ms for Mark Phase (%d Objects To Serialize"), (FPlatformTime::Seconds() - StartTime) * 1000, ObjectsToSerialize.Num());
 		}
 
 		{
+			CSV_SCOPED_TIMING_STAT(GC, ReachabilityAnalysis);
 			const double StartTime = FPlatformTime::Seconds();
 			PerformReachabilityAnalysisOnObjects(ArrayStruct, bForceSingleThreaded);
 			UE_LOG(LogGarbage, Verbose, TEXT("%f ms for Reachability Analysis"), (FPlatformTime::Seconds() - StartTime) * 1000);
 		}
+		CSV_CUSTOM_STAT(GC, NumObjectsMarked, GObjectCountDuringLastMarkPhase.GetValue(), ECsvCustomStatOp::Set);
         
 		// Allowing external systems to add object roots. This can't be done through AddReferencedObjects
 		// because it may require tracing objects (via FGarbageCollectionTracer) multiple times
@@ -1294,145 +1449,1115 @@ struct FConditionalGCLock
 	}
 };
 
-static bool IncrementalDestroyGarbage(bool bUseTimeLimit, float TimeLimit);
+/*-----------------------------------------------------------------------------
+	Incremental reachability analysis.
+-----------------------------------------------------------------------------*/
+
+static int32 GAllowIncrementalReachability = 0;
+static FAutoConsoleVariableRef CVarAllowIncrementalReachability(
+	TEXT("gc.AllowIncrementalReachability"),
+	GAllowIncrementalReachability,
+	TEXT("If enabled, periodic garbage collection spreads reachability analysis over several frames. Native reference writes don't go through GCWriteBarrier, so the final pause traces every reachable object again, on all worker threads, unless gc.IncrementalReachabilityRescan is disabled."),
+	ECVF_Default
+	);
+
+static float GIncrementalReachabilityTimeLimit = 2.0f;
+static FAutoConsoleVariableRef CVarIncrementalReachabilityTimeLimit(
+	TEXT("gc.IncrementalReachabilityTimeLimit"),
+	GIncrementalReachabilityTimeLimit,
+	TEXT("Time in milliseconds incremental reachability analysis is allowed to spend marking objects each frame."),
+	ECVF_Default
+	);
+
+static int32 GIncrementalReachabilityRescan = 1;
+static FAutoConsoleVariableRef CVarIncrementalReachabilityRescan(
+	TEXT("gc.IncrementalReachabilityRescan"),
+	GIncrementalReachabilityRescan,
+	TEXT("If enabled, finishing incremental reachability analysis processes the roots and every object marked so far again, which keeps objects referenced by writes that bypassed GCWriteBarrier alive. Only disable it if all reference writes made during marking go through GCWriteBarrier."),
+	ECVF_Default
+	);
+
+static int32 GVerifyIncrementalReachability = 0;
+static FAutoConsoleVariableRef CVarVerifyIncrementalReachability(
+	TEXT("gc.VerifyIncrementalReachability"),
+	GVerifyIncrementalReachability,
+	TEXT("If enabled, incremental reachability analysis is followed by a full one and any object the incremental analysis missed is reported. The result of the full analysis is used."),
+	ECVF_Default
+	);
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Incremental Mark Time (ms)"), STAT_GC_IncrementalMarkTime, STATGROUP_GC);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Incremental Finish Time (ms)"), STAT_GC_IncrementalFinishTime, STATGROUP_GC);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Write Barrier Time (ms)"), STAT_GC_WriteBarrierTime, STATGROUP_GC);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Write Barrier Hits"), STAT_GC_WriteBarrierHits, STATGROUP_GC);
+
+bool GIsIncrementalReachabilityPending = false;
+bool GIsGCWriteBarrierActive = false;
+/** True while objects created since the last garbage collection are tracked for minor garbage collection */
+static bool GIsTrackingYoungObjects = false;
+
+static void UpdateGCWriteBarrier()
+{
+	GIsGCWriteBarrierActive = GIsIncrementalReachabilityPending;
+}
 
 /**
- * Incrementally purge garbage by deleting all unreferenced objects after routing Destroy.
+ * Incremental reachability analysis.
  *
- * Calling code needs to be EXTREMELY careful when and how to call this function as 
- * RF_Unreachable cannot change on any objects unless any pending purge has completed!
+ * Marking is tracked in a bitmap indexed by object index rather than with EInternalObjectFlags::Unreachable so that
+ * objects which haven't been reached yet still look perfectly valid to the rest of the engine between frames.
+ * Objects are marked as soon as they are discovered and queued (grey) until their references have been processed.
+ * Objects created while the analysis is in progress are considered reachable and are processed once it's finished.
  *
- * @param	bUseTimeLimit	whether the time limit parameter should be used
- * @param	TimeLimit		soft time limit for this function call
+ * Objects are not visited again once processed, so a reference written to them afterwards is only seen if it goes
+ * through GCWriteBarrier, which queues the referenced object unless it has already been marked. Reflected property
+ * writes do, but native UPROPERTY and container assignments, the script VM and serialization don't. That's why
+ * finishing processes the roots and all marked objects again in a single pause (see gc.IncrementalReachabilityRescan),
+ * together with FGCObject references and new objects. Unlike the time sliced frames, that pause traces on all worker
+ * threads like the full analysis does. Everything that is not marked by then is flagged as unreachable and collected
+ * as usual.
  */
-void IncrementalPurgeGarbage(bool bUseTimeLimit, float TimeLimit)
+class FIncrementalReachability : public FUObjectArray::FUObjectCreateListener
 {
-	SCOPED_NAMED_EVENT(IncrementalPurgeGarbage, FColor::Red);
-	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("IncrementalPurgeGarbage"), STAT_IncrementalPurgeGarbage, STATGROUP_GC);
-	CSV_SCOPED_TIMING_STAT_EXCLUSIVE(GarbageCollection);
-
-	if (GExitPurge)
-	{
-		GObjPurgeIsRequired = true;
-		GUObjectArray.DisableDisregardForGC();
-		GObjCurrentPurgeObjectIndexNeedsReset = true;
-	}
-	// Early out if there is nothing to do.
-	if (!GObjPurgeIsRequired)
+	/** Reference processor which marks objects in the bitmap and queues them instead of processing them immediately */
+	class FProcessor : public FSimpleReferenceProcessorBase
 	{
-		return;
-	}
-
-	bool bCompleted = false;
+		FIncrementalReachability& Owner;
+	public:
+		explicit FProcessor(FIncrementalReachability& InOwner)
+			: Owner(InOwner)
+		{
+		}
+		FORCEINLINE void HandleTokenStreamObjectReference(TArray<UObject*>& ObjectsToSerialize, UObject* ReferencingObject, UObject*& Object, const int32 TokenIndex, bool bAllowReferenceElimination)
+		{
+			Owner.MarkReference(Object, bAllowReferenceElimination, Owner.GreyObjects);
+		}
+	};
+	typedef TDefaultReferenceCollector<FProcessor> FCollector;
 
-	struct FResetPurgeProgress
+	/** Reference processor used when finishing, which processes the objects it marks right away and can run on several threads */
+	class FFinishProcessor : public FSimpleReferenceProcessorBase
 	{
-		bool& bCompletedRef;
-		FResetPurgeProgress(bool& bInCompletedRef)
-			: bCompletedRef(bInCompletedRef)
+		FIncrementalReachability& Owner;
+	public:
+		explicit FFinishProcessor(FIncrementalReachability& InOwner)
+			: Owner(InOwner)
 		{
-			// Incremental purge is now in progress.
-			GObjIncrementalPurgeIsInProgress = true;
-			FPlatformMisc::MemoryBarrier();
 		}
-		~FResetPurgeProgress()
+		FORCEINLINE int32 GetMinDesiredObjectsPerSubTask() const
 		{
-			if (bCompletedRef)
-			{
-				GObjIncrementalPurgeIsInProgress = false;
-				FPlatformMisc::MemoryBarrier();
-			}
+			return GMinDesiredObjectsPerSubTask;
 		}
+		FORCEINLINE int32 GetMaxParallelTasks() const
+		{
+			return GMaxParallelMarkTasks;
+		}
+		FORCEINLINE void HandleTokenStreamObjectReference(TArray<UObject*>& ObjectsToSerialize, UObject* ReferencingObject, UObject*& Object, const int32 TokenIndex, bool bAllowReferenceElimination)
+		{
+			Owner.MarkReference(Object, bAllowReferenceElimination, ObjectsToSerialize);
+		}
+	};
+	typedef TDefaultReferenceCollector<FFinishProcessor> FFinishCollector;
 
-	} ResetPurgeProgress(bCompleted);
+	/** Number of grey objects processed between time limit checks */
+	enum { ObjectsPerBatch = 256 };
 
-	// Keep track of start time to enforce time limit unless bForceFullPurge is true;
-	GCStartTime = FPlatformTime::Seconds();
+	/** One bit per object index, set once the object has been reached */
+	TArray<int32> MarkBits;
+	/** Objects that have been marked but whose references haven't been processed yet */
+	TArray<UObject*> GreyObjects;
+	/** Objects passed to the write barrier, possibly from other threads */
+	TLockFreePointerListUnordered<UObject, PLATFORM_CACHE_LINE_SIZE> BarrierObjects;
+	/** Objects created while the analysis is in progress */
+	TLockFreePointerListUnordered<UObject, PLATFORM_CACHE_LINE_SIZE> NewObjects;
+	/** Flags the analysis was started with */
+	EObjectFlags KeepFlags;
+	/** Set once all objects reachable so far have been processed, the rest is done by Finish */
+	bool bReadyToFinish;
+	/** Number of write barrier calls which found an object that hasn't been marked yet, and the time spent on them */
+	TAtomic<int32> BarrierHits;
+	TAtomic<uint32> BarrierCycles;
 
-	bool bTimeLimitReached = false;
-	if (GUnrechableObjectIndex < GUnreachableObjects.Num())
+	FORCEINLINE bool IsMarked(int32 ObjectIndex) const
+	{
+		return (MarkBits[ObjectIndex >> 5] & (1 << (ObjectIndex & 31))) != 0;
+	}
+
+	/** Marks an object, returns false if it had already been marked. Can be called from any thread. */
+	FORCEINLINE bool TrySetMark(int32 ObjectIndex)
+	{
+		const int32 Mask = 1 << (ObjectIndex & 31);
+		return (FPlatformAtomics::InterlockedOr(&MarkBits[ObjectIndex >> 5], Mask) & Mask) == 0;
+	}
+
+	/**
+	 * Marks an object and, depending on its kind, queues it or the clusters it keeps alive to OutGreyObjects.
+	 * Can be called from any thread as long as each thread has its own OutGreyObjects.
+	 */
+	void MarkObject(int32 ObjectIndex, FUObjectItem* ObjectItem, TArray<UObject*>& OutGreyObjects)
 	{
+		if (!TrySetMark(ObjectIndex))
 		{
-			FConditionalGCLock ScopedGCLock;
-			bTimeLimitReached = UnhashUnreachableObjects(bUseTimeLimit, TimeLimit);
+			return;
 		}
-		if (GUnrechableObjectIndex >= GUnreachableObjects.Num())
+		if (ObjectItem->GetOwnerIndex() > 0)
 		{
-			FScopedCBDProfile::DumpProfile();
+			// Clustered objects are never processed, their cluster root accounts for all of their references
+			const int32 OwnerIndex = ObjectItem->GetOwnerIndex();
+			MarkObject(OwnerIndex, GUObjectArray.IndexToObjectUnsafeForGC(OwnerIndex), OutGreyObjects);
+		}
+		else if (ObjectItem->HasAnyFlags(EInternalObjectFlags::ClusterRoot))
+		{
+			// Unlike the full analysis we don't eliminate references to pending kill objects from clusters, they're simply kept alive until the next GC
+			FUObjectCluster& Cluster = GUObjectClusters[ObjectItem->GetClusterIndex()];
+			for (int32 ReferencedClusterIndex : Cluster.ReferencedClusters)
+			{
+				if (ReferencedClusterIndex >= 0)
+				{
+					MarkObject(ReferencedClusterIndex, GUObjectArray.IndexToObjectUnsafeForGC(ReferencedClusterIndex), OutGreyObjects);
+				}
+			}
+			for (int32 MutableObjectIndex : Cluster.MutableObjects)
+			{
+				if (MutableObjectIndex >= 0)
+				{
+					MarkObject(MutableObjectIndex, GUObjectArray.IndexToObjectUnsafeForGC(MutableObjectIndex), OutGreyObjects);
+				}
+			}
+		}
+		else
+		{
+			OutGreyObjects.Add(static_cast<UObject*>(ObjectItem->Object));
 		}
 	}
 
-	if (!bTimeLimitReached)
+	/** Marks an object found by the game thread and queues it to GreyObjects */
+	FORCEINLINE void MarkObject(UObject* Object)
 	{
-		bCompleted = IncrementalDestroyGarbage(bUseTimeLimit, TimeLimit);
+		if (!GUObjectAllocator.ResidesInPermanentPool(Object))
+		{
+			const int32 ObjectIndex = GUObjectArray.ObjectToIndex(Object);
+			MarkObject(ObjectIndex, GUObjectArray.IndexToObjectUnsafeForGC(ObjectIndex), GreyObjects);
+		}
 	}
-}
 
-bool IncrementalDestroyGarbage(bool bUseTimeLimit, float TimeLimit)
-{
-	const bool bMultithreadedPurge = !ShouldForceSingleThreadedGC() && GMultithreadedDestructionEnabled;
-	if (!GAsyncPurge)
+	/** Marks a reference found by one of the processors, or clears it if it's to a pending kill object */
+	FORCEINLINE void MarkReference(UObject*& Object, bool bAllowReferenceElimination, TArray<UObject*>& OutGreyObjects)
 	{
-		GAsyncPurge = new FAsyncPurge(bMultithreadedPurge);
+		if (Object == nullptr || GUObjectAllocator.ResidesInPermanentPool(Object))
+		{
+			return;
+		}
+		const int32 ObjectIndex = GUObjectArray.ObjectToIndex(Object);
+		FUObjectItem* ObjectItem = GUObjectArray.IndexToObjectUnsafeForGC(ObjectIndex);
+		if (bAllowReferenceElimination && ObjectItem->IsPendingKill() && ObjectItem->GetOwnerIndex() <= 0)
+		{
+			Object = nullptr;
+		}
+		else
+		{
+			MarkObject(ObjectIndex, ObjectItem, OutGreyObjects);
+		}
 	}
-	else if (GAsyncPurge->IsMultithreaded() != bMultithreadedPurge)
+
+	/** Marks everything that is kept alive regardless of being referenced. Roots that have already been marked are skipped, see RescanMarkedObjects. */
+	void MarkRoots(bool bForceSingleThreaded)
 	{
-		check(GAsyncPurge->IsFinished());
-		delete GAsyncPurge;
-		GAsyncPurge = new FAsyncPurge(bMultithreadedPurge);
-	}
+		const EInternalObjectFlags FastKeepFlags = EInternalObjectFlags::GarbageCollectionKeepFlags;
+		const EObjectFlags LocalKeepFlags = KeepFlags;
+		TLockFreePointerListUnordered<UObject, PLATFORM_CACHE_LINE_SIZE> RootsList;
 
-	bool bCompleted = false;
-	bool bTimeLimitReached = false;
+		const int32 FirstObjectIndex = FMath::Max(GUObjectArray.GetFirstGCIndex(), 0);
+		const int32 MaxNumberOfObjects = GUObjectArray.GetObjectArrayNum() - FirstObjectIndex;
+		const int32 NumThreads = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+		const int32 NumberOfObjectsPerThread = (MaxNumberOfObjects / NumThreads) + 1;
 
-	// Keep track of time it took to destroy objects for stats
-	double IncrementalDestroyGarbageStartTime = FPlatformTime::Seconds();
+		ParallelFor(NumThreads, [this, &RootsList, FastKeepFlags, LocalKeepFlags, FirstObjectIndex, MaxNumberOfObjects, NumberOfObjectsPerThread](int32 ThreadIndex)
+		{
+			const int32 StartIndex = FirstObjectIndex + ThreadIndex * NumberOfObjectsPerThread;
+			const int32 EndIndex = FMath::Min(StartIndex + NumberOfObjectsPerThread, FirstObjectIndex + MaxNumberOfObjects);
+			for (int32 ObjectIndex = StartIndex; ObjectIndex < EndIndex; ++ObjectIndex)
+			{
+				FUObjectItem* ObjectItem = &GUObjectArray.GetObjectItemArrayUnsafe()[ObjectIndex];
+				if (ObjectItem->Object && !IsMarked(ObjectIndex))
+				{
+					bool bIsRoot = ObjectItem->IsRootSet();
+					if (!bIsRoot && !ObjectItem->IsPendingKill())
+					{
+						bIsRoot = ObjectItem->HasAnyFlags(FastKeepFlags) || (LocalKeepFlags != RF_NoFlags && static_cast<UObject*>(ObjectItem->Object)->HasAnyFlags(LocalKeepFlags));
+					}
+					if (bIsRoot)
+					{
+						RootsList.Push(static_cast<UObject*>(ObjectItem->Object));
+					}
+				}
+			}
+		}, bForceSingleThreaded);
 
-	// Depending on platform FPlatformTime::Seconds might take a noticeable amount of time if called thousands of times so we avoid
-	// enforcing the time limit too often, especially as neither Destroy nor actual deletion should take significant
-	// amounts of time.
-	const int32	TimeLimitEnforcementGranularityForDestroy = 10;
-	const int32	TimeLimitEnforcementGranularityForDeletion = 100;
+		TArray<UObject*> Roots;
+		RootsList.PopAll(Roots);
+		for (UObject* Root : Roots)
+		{
+			MarkObject(Root);
+		}
 
-	// Set 'I'm garbage collecting' flag - might be checked inside UObject::Destroy etc.
-	FGCScopeLock GCLock;
+		// FGCObject references can't be tracked by the write barrier so they're always processed again
+		if (FGCObject::GGCObjectReferencer)
+		{
+			GreyObjects.Add(FGCObject::GGCObjectReferencer);
+		}
+	}
 
-	if( !GObjFinishDestroyHasBeenRoutedToAllObjects && !bTimeLimitReached )
+	/** Queues every marked object again so references written to it without GCWriteBarrier are found as well. Roots are always marked at this point. */
+	void RescanMarkedObjects(bool bForceSingleThreaded)
 	{
-		check(GUnrechableObjectIndex >= GUnreachableObjects.Num());
+		TLockFreePointerListUnordered<UObject, PLATFORM_CACHE_LINE_SIZE> MarkedList;
 
-		// Try to dispatch all FinishDestroy messages to unreachable objects.  We'll iterate over every
-		// single object and destroy any that are ready to be destroyed.  The objects that aren't yet
-		// ready will be added to a list to be processed afterwards.
-		int32 TimeLimitTimePollCounter = 0;
-		int32 FinishDestroyTimePollCounter = 0;
+		const int32 FirstObjectIndex = FMath::Max(GUObjectArray.GetFirstGCIndex(), 0);
+		const int32 MaxNumberOfObjects = GUObjectArray.GetObjectArrayNum() - FirstObjectIndex;
+		const int32 NumThreads = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+		const int32 NumberOfObjectsPerThread = (MaxNumberOfObjects / NumThreads) + 1;
 
-		if (GObjCurrentPurgeObjectIndexNeedsReset)
+		ParallelFor(NumThreads, [this, &MarkedList, FirstObjectIndex, MaxNumberOfObjects, NumberOfObjectsPerThread](int32 ThreadIndex)
 		{
-			GObjCurrentPurgeObjectIndex = 0;
-			GObjCurrentPurgeObjectIndexNeedsReset = false;
-		}
+			const int32 StartIndex = FirstObjectIndex + ThreadIndex * NumberOfObjectsPerThread;
+			const int32 EndIndex = FMath::Min(StartIndex + NumberOfObjectsPerThread, FirstObjectIndex + MaxNumberOfObjects);
+			for (int32 ObjectIndex = StartIndex; ObjectIndex < EndIndex; ++ObjectIndex)
+			{
+				FUObjectItem* ObjectItem = &GUObjectArray.GetObjectItemArrayUnsafe()[ObjectIndex];
+				// Clustered objects and cluster roots are never queued, see MarkObject
+				if (ObjectItem->Object && IsMarked(ObjectIndex) && ObjectItem->GetOwnerIndex() <= 0 && !ObjectItem->HasAnyFlags(EInternalObjectFlags::ClusterRoot))
+				{
+					MarkedList.Push(static_cast<UObject*>(ObjectItem->Object));
+				}
+			}
+		}, bForceSingleThreaded);
 
-		while (GObjCurrentPurgeObjectIndex < GUnreachableObjects.Num())
+		// Everything queued so far is marked as well
+		GreyObjects.Reset();
+		MarkedList.PopAll(GreyObjects);
+		if (FGCObject::GGCObjectReferencer && !IsMarked(GUObjectArray.ObjectToIndex(FGCObject::GGCObjectReferencer)))
 		{
-			FUObjectItem* ObjectItem = GUnreachableObjects[GObjCurrentPurgeObjectIndex];
-			checkSlow(ObjectItem);
+			GreyObjects.Add(FGCObject::GGCObjectReferencer);
+		}
+	}
 
-			//@todo UE4 - A prefetch was removed here. Re-add it. It wasn't right anyway, since it was ten items ahead and the consoles on have 8 prefetch slots
+	/** Processes queued objects until there are none left or the time limit has been reached, returns true if there's nothing left to do */
+	bool ProcessGreyObjects(double StartTime, double TimeLimit)
+	{
+		TArray<UObject*> Barrier;
+		FProcessor Processor(*this);
+		TFastReferenceCollector<false, FProcessor, FCollector, FGCArrayPool> ReferenceCollector(Processor, FGCArrayPool::Get());
+		FGCArrayStruct* ArrayStruct = FGCArrayPool::Get().GetArrayStructFromPool();
 
-			check(ObjectItem->IsUnreachable());
+		while (true)
+		{
+			BarrierObjects.PopAll(Barrier);
+			for (UObject* Object : Barrier)
 			{
-				UObject* Object = static_cast<UObject*>(ObjectItem->Object);
-				// Object should always have had BeginDestroy called on it and never already be destroyed
-				check( Object->HasAnyFlags( RF_BeginDestroyed ) && !Object->HasAnyFlags( RF_FinishDestroyed ) );
+				MarkObject(Object);
+			}
+			Barrier.Reset();
 
-				// Only proceed with destroying the object if the asynchronous cleanup started by BeginDestroy has finished.
-				if(Object->IsReadyForFinishDestroy())
-				{
-#if PERF_DETAILED_PER_CLASS_GC_STATS
-					// Keep track of how many objects of a certain class we're purging.
-					const FName& ClassName = Object->GetClass()->GetFName();
-					int32 InstanceCount = GClassToPurgeCountMap.FindRef( ClassName );
+			if (!GreyObjects.Num())
+			{
+				break;
+			}
+
+			const int32 NumThisBatch = FMath::Min<int32>(ObjectsPerBatch, GreyObjects.Num());
+			ArrayStruct->ObjectsToSerialize.Append(GreyObjects.GetData() + GreyObjects.Num() - NumThisBatch, NumThisBatch);
+			GreyObjects.SetNum(GreyObjects.Num() - NumThisBatch, false);
+			ReferenceCollector.CollectReferences(*ArrayStruct);
+			ArrayStruct->ObjectsToSerialize.Reset();
+
+			if (TimeLimit > 0.0 && FPlatformTime::Seconds() - StartTime > TimeLimit)
+			{
+				break;
+			}
+		}
+
+		FGCArrayPool::Get().ReturnToPool(ArrayStruct);
+		return !GreyObjects.Num() && BarrierObjects.IsEmpty();
+	}
+
+	/**
+	 * Processes all queued objects and everything they lead to without a time limit, on all worker threads unless
+	 * bForceSingleThreaded is set. Used by Finish, where the rescan queues every marked object at once.
+	 */
+	void ProcessAllGreyObjects(bool bForceSingleThreaded)
+	{
+		TArray<UObject*> Barrier;
+		FFinishProcessor Processor(*this);
+		FGCArrayStruct* ArrayStruct = FGCArrayPool::Get().GetArrayStructFromPool();
+
+		// Other threads may still go through the write barrier while the game thread is finishing
+		do
+		{
+			BarrierObjects.PopAll(Barrier);
+			for (UObject* Object : Barrier)
+			{
+				MarkObject(Object);
+			}
+			Barrier.Reset();
+
+			ArrayStruct->ObjectsToSerialize.Append(GreyObjects);
+			GreyObjects.Reset();
+			if (!bForceSingleThreaded)
+			{
+				TFastReferenceCollector<true, FFinishProcessor, FFinishCollector, FGCArrayPool> ReferenceCollector(Processor, FGCArrayPool::Get());
+				ReferenceCollector.CollectReferences(*ArrayStruct);
+			}
+			else
+			{
+				TFastReferenceCollector<false, FFinishProcessor, FFinishCollector, FGCArrayPool> ReferenceCollector(Processor, FGCArrayPool::Get());
+				ReferenceCollector.CollectReferences(*ArrayStruct);
+			}
+			ArrayStruct->ObjectsToSerialize.Reset();
+		}
+		while (!BarrierObjects.IsEmpty());
+
+		FGCArrayPool::Get().ReturnToPool(ArrayStruct);
+	}
+
+	/** Discards queued objects, which may be deleted once the analysis is over */
+	void DiscardQueuedObjects()
+	{
+		TArray<UObject*> Discarded;
+		BarrierObjects.PopAll(Discarded);
+		NewObjects.PopAll(Discarded);
+		GreyObjects.Reset();
+	}
+
+	void Stop()
+	{
+		GUObjectArray.RemoveUObjectCreateListener(this);
+		DiscardQueuedObjects();
+
+		GIsIncrementalReachabilityPending = false;
+		UpdateGCWriteBarrier();
+		bReadyToFinish = false;
+		FPlatformMisc::MemoryBarrier();
+
+		// Another thread may have passed the write barrier check just before it was disabled
+		DiscardQueuedObjects();
+	}
+
+	/** MarkTime is spent marking in frames the game keeps running, FinishTime is the pause that ends the analysis */
+	void ReportStats(double MarkTime, double FinishTime)
+	{
+		const int32 Hits = BarrierHits.Exchange(0);
+		const double BarrierTime = FPlatformTime::ToMilliseconds(BarrierCycles.Exchange(0));
+		INC_FLOAT_STAT_BY(STAT_GC_IncrementalMarkTime, MarkTime * 1000.0);
+		INC_FLOAT_STAT_BY(STAT_GC_IncrementalFinishTime, FinishTime * 1000.0);
+		INC_FLOAT_STAT_BY(STAT_GC_WriteBarrierTime, BarrierTime);
+		INC_DWORD_STAT_BY(STAT_GC_WriteBarrierHits, Hits);
+		CSV_CUSTOM_STAT(GC, IncrementalMarkTime, MarkTime * 1000.0, ECsvCustomStatOp::Accumulate);
+		CSV_CUSTOM_STAT(GC, IncrementalFinishTime, FinishTime * 1000.0, ECsvCustomStatOp::Accumulate);
+		CSV_CUSTOM_STAT(GC, WriteBarrierTime, BarrierTime, ECsvCustomStatOp::Accumulate);
+		CSV_CUSTOM_STAT(GC, WriteBarrierHits, Hits, ECsvCustomStatOp::Accumulate);
+	}
+
+public:
+
+	FIncrementalReachability()
+		: KeepFlags(RF_NoFlags)
+		, bReadyToFinish(false)
+		, BarrierHits(0)
+		, BarrierCycles(0)
+	{
+	}
+
+	static FIncrementalReachability& Get()
+	{
+		static FIncrementalReachability Singleton;
+		return Singleton;
+	}
+
+	/** Starts a new analysis, must be called with the GC lock held */
+	void Start(EObjectFlags InKeepFlags, bool bForceSingleThreaded)
+	{
+		check(IsInGameThread());
+		check(!GIsIncrementalReachabilityPending);
+		const double StartTime = FPlatformTime::Seconds();
+
+		KeepFlags = InKeepFlags;
+		DiscardQueuedObjects();
+		MarkBits.Reset();
+		MarkBits.AddZeroed(GUObjectArray.GetObjectItemArrayUnsafe().Capacity() / 32 + 1);
+		GUObjectArray.AddUObjectCreateListener(this);
+		GIsIncrementalReachabilityPending = true;
+		UpdateGCWriteBarrier();
+
+		MarkRoots(bForceSingleThreaded);
+
+		ReportStats(FPlatformTime::Seconds() - StartTime, 0.0);
+		UE_LOG(LogGarbage, Log, TEXT("%f ms for starting incremental reachability analysis (%d roots)"), (FPlatformTime::Seconds() - StartTime) * 1000, GreyObjects.Num());
+	}
+
+	/** Marks objects for up to TimeLimit seconds, returns true once all reachable objects have been found. Must be called with the GC lock held. */
+	bool Tick(double TimeLimit)
+	{
+		check(GIsIncrementalReachabilityPending);
+		SCOPED_NAMED_EVENT(FIncrementalReachability_Tick, FColor::Red);
+		DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FIncrementalReachability::Tick"), STAT_FIncrementalReachability_Tick, STATGROUP_GC);
+		CSV_SCOPED_TIMING_STAT(GC, IncrementalReachability);
+
+		const double StartTime = FPlatformTime::Seconds();
+		bReadyToFinish = ProcessGreyObjects(StartTime, TimeLimit);
+		ReportStats(FPlatformTime::Seconds() - StartTime, 0.0);
+		return bReadyToFinish;
+	}
+
+	FORCEINLINE bool IsReadyToFinish() const
+	{
+		return bReadyToFinish;
+	}
+
+	/**
+	 * Marks new roots and new objects, processes all marked objects again unless gc.IncrementalReachabilityRescan
+	 * is disabled, marks everything that's left and flags all objects that haven't been reached as unreachable.
+	 * Called by CollectGarbageInternal in place of the full analysis, so all of this happens in a single pause.
+	 */
+	void Finish(bool bForceSingleThreaded)
+	{
+		check(GIsIncrementalReachabilityPending && bReadyToFinish);
+		SCOPED_NAMED_EVENT(FIncrementalReachability_Finish, FColor::Red);
+		DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FIncrementalReachability::Finish"), STAT_FIncrementalReachability_Finish, STATGROUP_GC);
+		CSV_SCOPED_TIMING_STAT(GC, FinishIncrementalReachability);
+		const double StartTime = FPlatformTime::Seconds();
+
+		GUObjectArray.RemoveUObjectCreateListener(this);
+
+		MarkRoots(bForceSingleThreaded);
+		TArray<UObject*> CreatedObjects;
+		NewObjects.PopAll(CreatedObjects);
+		GreyObjects.Append(CreatedObjects);
+		if (GIncrementalReachabilityRescan)
+		{
+			RescanMarkedObjects(bForceSingleThreaded);
+		}
+		ProcessAllGreyObjects(bForceSingleThreaded);
+
+		GObjectCountDuringLastMarkPhase.Reset();
+		if (GVerifyIncrementalReachability)
+		{
+			Verify(bForceSingleThreaded);
+		}
+		else
+		{
+			const int32 FirstObjectIndex = FMath::Max(GUObjectArray.GetFirstGCIndex(), 0);
+			const int32 MaxNumberOfObjects = GUObjectArray.GetObjectArrayNum() - FirstObjectIndex;
+			const int32 NumThreads = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+			const int32 NumberOfObjectsPerThread = (MaxNumberOfObjects / NumThreads) + 1;
+
+			ParallelFor(NumThreads, [this, FirstObjectIndex, MaxNumberOfObjects, NumberOfObjectsPerThread](int32 ThreadIndex)
+			{
+				const int32 StartIndex = FirstObjectIndex + ThreadIndex * NumberOfObjectsPerThread;
+				const int32 EndIndex = FMath::Min(StartIndex + NumberOfObjectsPerThread, FirstObjectIndex + MaxNumberOfObjects);
+				int32 ObjectCount = 0;
+				for (int32 ObjectIndex = StartIndex; ObjectIndex < EndIndex; ++ObjectIndex)
+				{
+					FUObjectItem* ObjectItem = &GUObjectArray.GetObjectItemArrayUnsafe()[ObjectIndex];
+					if (ObjectItem->Object)
+					{
+						++ObjectCount;
+						if (ObjectItem->GetOwnerIndex() > 0)
+						{
+							// Same as the full analysis: clustered objects are never unreachable, they only remember whether they're referenced from outside of their cluster
+							if (IsMarked(ObjectIndex))
+							{
+								ObjectItem->SetFlags(EInternalObjectFlags::ReachableInCluster);
+							}
+							else
+							{
+								ObjectItem->ClearFlags(EInternalObjectFlags::ReachableInCluster);
+							}
+						}
+						else if (!IsMarked(ObjectIndex))
+						{
+							ObjectItem->SetFlags(EInternalObjectFlags::Unreachable);
+						}
+					}
+				}
+				GObjectCountDuringLastMarkPhase.Add(ObjectCount);
+			}, bForceSingleThreaded);
+		}
+
+		ReportStats(0.0, FPlatformTime::Seconds() - StartTime);
+		Stop();
+		UE_LOG(LogGarbage, Log, TEXT("%f ms for finishing incremental reachability analysis"), (FPlatformTime::Seconds() - StartTime) * 1000);
+	}
+
+	/** Abandons the analysis in progress, if any. Must be called with the GC lock held. */
+	void Cancel()
+	{
+		if (GIsIncrementalReachabilityPending)
+		{
+			UE_LOG(LogGarbage, Log, TEXT("Cancelling incremental reachability analysis"));
+			Stop();
+		}
+	}
+
+	/** Runs the full analysis and reports reachable objects the incremental analysis didn't find, which usually means a missing write barrier */
+	void Verify(bool bForceSingleThreaded)
+	{
+		FRealtimeGC TagUsedRealtimeGC;
+		TagUsedRealtimeGC.PerformReachabilityAnalysis(KeepFlags, bForceSingleThreaded);
+
+		int32 NumMissed = 0;
+		for (int32 ObjectIndex = FMath::Max(GUObjectArray.GetFirstGCIndex(), 0); ObjectIndex < GUObjectArray.GetObjectArrayNum(); ++ObjectIndex)
+		{
+			FUObjectItem* ObjectItem = &GUObjectArray.GetObjectItemArrayUnsafe()[ObjectIndex];
+			if (ObjectItem->Object && ObjectItem->GetOwnerIndex() <= 0 && !ObjectItem->IsUnreachable() && !IsMarked(ObjectIndex))
+			{
+				if (NumMissed++ < 100)
+				{
+					UE_LOG(LogGarbage, Warning, TEXT("Incremental reachability analysis missed %s"), *static_cast<UObject*>(ObjectItem->Object)->GetFullName());
+				}
+			}
+		}
+		UE_CLOG(NumMissed > 0, LogGarbage, Error, TEXT("Incremental reachability analysis missed %d reachable objects, references to them were most likely written without GCWriteBarrier"), NumMissed);
+	}
+
+	/** Write barrier slow path, can be called from any thread */
+	void Shade(const UObjectBase* Object)
+	{
+		if (!GUObjectAllocator.ResidesInPermanentPool(Object))
+		{
+			const uint32 StartCycles = FPlatformTime::Cycles();
+			if (!IsMarked(GUObjectArray.ObjectToIndex(Object)))
+			{
+				BarrierObjects.Push(static_cast<UObject*>(const_cast<UObjectBase*>(Object)));
+				BarrierHits.IncrementExchange();
+			}
+			BarrierCycles.AddExchange(FPlatformTime::Cycles() - StartCycles);
+		}
+	}
+
+	//~ Begin FUObjectCreateListener Interface
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override
+	{
+		// New objects are reachable for this GC but may be given references to anything, so they're processed when finishing
+		TrySetMark(Index);
+		NewObjects.Push(static_cast<UObject*>(const_cast<UObjectBase*>(Object)));
+	}
+	virtual void OnUObjectArrayShutdown() override
+	{
+		GUObjectArray.RemoveUObjectCreateListener(this);
+	}
+	//~ End FUObjectCreateListener Interface
+};
+
+/*-----------------------------------------------------------------------------
+	Minor garbage collection.
+-----------------------------------------------------------------------------*/
+
+static int32 GMinorCollectionsPerMajor = 0;
+static FAutoConsoleVariableRef CVarMinorCollectionsPerMajor(
+	TEXT("gc.MinorCollectionsPerMajor"),
+	GMinorCollectionsPerMajor,
+	TEXT("Number of minor garbage collections, which only consider objects created since the previous collection, periodic garbage collection performs between two full ones. 0 disables tracking young objects altogether."),
+	ECVF_Default
+	);
+
+static int32 GVerifyMinorCollection = 0;
+static FAutoConsoleVariableRef CVarVerifyMinorCollection(
+	TEXT("gc.VerifyMinorCollection"),
+	GVerifyMinorCollection,
+	TEXT("If enabled, minor garbage collection is followed by a full reachability analysis and any reachable object the minor collection would have deleted is reported. The result of the full analysis is used."),
+	ECVF_Default
+	);
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Minor GC Time (ms)"), STAT_GC_MinorCollectionTime, STATGROUP_GC);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Major GC Time (ms)"), STAT_GC_MajorCollectionTime, STATGROUP_GC);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Objects Promoted"), STAT_GC_ObjectsPromoted, STATGROUP_GC);
+
+static FGarbageCollectionStats GGarbageCollectionStats;
+static int32 GNumMinorCollectionsSinceMajor = 0;
+
+/**
+ * Young object tracking for minor garbage collection.
+ *
+ * Objects created since the last garbage collection are young and are tracked in a bitmap indexed by object index.
+ * A minor collection only marks young objects as unreachable so old objects are implicitly reachable. Native reference
+ * writes don't go through GCWriteBarrier, so rather than remembering which old objects may reference young ones, the
+ * references of every old object are traced once. The reference processor never queues old objects since they're not
+ * unreachable, so unlike a full collection nothing is traced through them, and references from them to pending kill
+ * young objects are cleared the same way. Old objects that are no longer reachable keep what they reference alive until
+ * the next full collection. gc.VerifyMinorCollection reports anything a full collection would have kept.
+ * Every collection promotes all surviving young objects, i.e. there are only two generations.
+ */
+class FGCNursery : public FUObjectArray::FUObjectCreateListener, public FUObjectArray::FUObjectDeleteListener
+{
+	/** One bit per object index, set for objects created since the last garbage collection */
+	TArray<int32> YoungBits;
+
+	FORCEINLINE static bool TestBit(const TArray<int32>& Bits, int32 Index)
+	{
+		return (Bits[Index >> 5] & (1 << (Index & 31))) != 0;
+	}
+
+	FORCEINLINE static void SetBit(TArray<int32>& Bits, int32 Index)
+	{
+		FPlatformAtomics::InterlockedOr(&Bits[Index >> 5], 1 << (Index & 31));
+	}
+
+	FORCEINLINE static void ClearBit(TArray<int32>& Bits, int32 Index)
+	{
+		FPlatformAtomics::InterlockedAnd(&Bits[Index >> 5], ~(1 << (Index & 31)));
+	}
+
+	/** Calls Func with the index of each young object */
+	template <typename FuncType>
+	void ForEachYoungObjectIndex(FuncType Func) const
+	{
+		for (int32 WordIndex = 0; WordIndex < YoungBits.Num(); ++WordIndex)
+		{
+			uint32 Word = (uint32)YoungBits[WordIndex];
+			while (Word)
+			{
+				const int32 BitIndex = (int32)FMath::CountTrailingZeros(Word);
+				Word &= Word - 1;
+				Func(WordIndex * 32 + BitIndex);
+			}
+		}
+	}
+
+	/** Marks all young objects that are not roots as unreachable */
+	void MarkYoungObjectsAsUnreachable(TArray<UObject*>& ObjectsToSerialize, const EObjectFlags KeepFlags, int32& OutNumYoungObjects)
+	{
+		const EInternalObjectFlags FastKeepFlags = EInternalObjectFlags::GarbageCollectionKeepFlags;
+		TArray<FUObjectItem*> ClusterRoots;
+
+		ForEachYoungObjectIndex([this, &ObjectsToSerialize, &ClusterRoots, &OutNumYoungObjects, FastKeepFlags, KeepFlags](int32 ObjectIndex)
+		{
+			FUObjectItem* ObjectItem = GUObjectArray.IndexToObjectUnsafeForGC(ObjectIndex);
+			UObject* Object = static_cast<UObject*>(ObjectItem->Object);
+			if (!Object)
+			{
+				return;
+			}
+			checkf(!ObjectItem->IsUnreachable(), TEXT("%s"), *Object->GetFullName());
+			OutNumYoungObjects++;
+
+			// Clustered objects are kept alive by their cluster and young clusters are left to the next full collection
+			bool bIsRoot = ObjectItem->IsRootSet()
+				|| ObjectItem->GetOwnerIndex() > 0
+				|| ObjectItem->HasAnyFlags(EInternalObjectFlags::ClusterRoot);
+			if (!bIsRoot && !ObjectItem->IsPendingKill())
+			{
+				bIsRoot = ObjectItem->HasAnyFlags(FastKeepFlags) || (KeepFlags != RF_NoFlags && Object->HasAnyFlags(KeepFlags));
+			}
+
+			if (bIsRoot)
+			{
+				ObjectsToSerialize.Add(Object);
+				if (ObjectItem->HasAnyFlags(EInternalObjectFlags::ClusterRoot))
+				{
+					ClusterRoots.Add(ObjectItem);
+				}
+			}
+			else
+			{
+				ObjectItem->SetFlags(EInternalObjectFlags::Unreachable);
+			}
+		});
+
+		for (FUObjectItem* ClusterRootItem : ClusterRoots)
+		{
+			FGCReferenceProcessorSinglethreaded::MarkReferencedClustersAsReachable(ClusterRootItem->GetClusterIndex(), ObjectsToSerialize);
+		}
+	}
+
+	/**
+	 * Adds every old object whose references need to be traced, so that young objects referenced by writes the write
+	 * barrier never saw are found. Clustered objects are accounted for by their cluster root, whose mutable objects
+	 * are marked right away.
+	 */
+	void AddOldObjectsToSerialize(TArray<UObject*>& ObjectsToSerialize, bool bForceSingleThreaded, int32& OutNumOldObjects)
+	{
+		TLockFreePointerListUnordered<UObject, PLATFORM_CACHE_LINE_SIZE> OldObjectsList;
+		TLockFreePointerListUnordered<FUObjectItem, PLATFORM_CACHE_LINE_SIZE> ClusterRootsList;
+
+		const int32 FirstObjectIndex = FMath::Max(GUObjectArray.GetFirstGCIndex(), 0);
+		const int32 MaxNumberOfObjects = GUObjectArray.GetObjectArrayNum() - FirstObjectIndex;
+		const int32 NumThreads = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+		const int32 NumberOfObjectsPerThread = (MaxNumberOfObjects / NumThreads) + 1;
+
+		ParallelFor(NumThreads, [this, &OldObjectsList, &ClusterRootsList, FirstObjectIndex, MaxNumberOfObjects, NumberOfObjectsPerThread](int32 ThreadIndex)
+		{
+			const int32 StartIndex = FirstObjectIndex + ThreadIndex * NumberOfObjectsPerThread;
+			const int32 EndIndex = FMath::Min(StartIndex + NumberOfObjectsPerThread, FirstObjectIndex + MaxNumberOfObjects);
+			for (int32 ObjectIndex = StartIndex; ObjectIndex < EndIndex; ++ObjectIndex)
+			{
+				FUObjectItem* ObjectItem = &GUObjectArray.GetObjectItemArrayUnsafe()[ObjectIndex];
+				if (ObjectItem->Object && ObjectItem->GetOwnerIndex() <= 0 && !TestBit(YoungBits, ObjectIndex))
+				{
+					OldObjectsList.Push(static_cast<UObject*>(ObjectItem->Object));
+					if (ObjectItem->HasAnyFlags(EInternalObjectFlags::ClusterRoot))
+					{
+						ClusterRootsList.Push(ObjectItem);
+					}
+				}
+			}
+		}, bForceSingleThreaded);
+
+		TArray<UObject*> OldObjects;
+		OldObjectsList.PopAll(OldObjects);
+		OutNumOldObjects = OldObjects.Num();
+		ObjectsToSerialize.Append(OldObjects);
+
+		TArray<FUObjectItem*> ClusterRoots;
+		ClusterRootsList.PopAll(ClusterRoots);
+		for (FUObjectItem* ClusterRootItem : ClusterRoots)
+		{
+			FGCReferenceProcessorSinglethreaded::MarkReferencedClustersAsReachable(ClusterRootItem->GetClusterIndex(), ObjectsToSerialize);
+		}
+	}
+
+	/** Runs the full analysis and reports reachable objects the minor collection would have deleted, which usually means a missing write barrier */
+	void Verify(EObjectFlags KeepFlags, bool bForceSingleThreaded)
+	{
+		TArray<int32> UnreachableIndices;
+		ForEachYoungObjectIndex([&UnreachableIndices](int32 ObjectIndex)
+		{
+			FUObjectItem* ObjectItem = GUObjectArray.IndexToObjectUnsafeForGC(ObjectIndex);
+			if (ObjectItem->Object && ObjectItem->IsUnreachable())
+			{
+				UnreachableIndices.Add(ObjectIndex);
+				ObjectItem->ClearUnreachable();
+			}
+		});
+
+		FRealtimeGC TagUsedRealtimeGC;
+		TagUsedRealtimeGC.PerformReachabilityAnalysis(KeepFlags, bForceSingleThreaded);
+
+		int32 NumMissed = 0;
+		for (int32 ObjectIndex : UnreachableIndices)
+		{
+			FUObjectItem* ObjectItem = GUObjectArray.IndexToObjectUnsafeForGC(ObjectIndex);
+			if (!ObjectItem->IsUnreachable())
+			{
+				if (NumMissed++ < 100)
+				{
+					UE_LOG(LogGarbage, Warning, TEXT("Minor garbage collection would have deleted reachable object %s"), *static_cast<UObject*>(ObjectItem->Object)->GetFullName());
+				}
+			}
+		}
+		UE_CLOG(NumMissed > 0, LogGarbage, Error, TEXT("Minor garbage collection would have deleted %d reachable objects"), NumMissed);
+	}
+
+public:
+
+	static FGCNursery& Get()
+	{
+		static FGCNursery Singleton;
+		return Singleton;
+	}
+
+	FORCEINLINE bool IsTracking() const
+	{
+		return GIsTrackingYoungObjects;
+	}
+
+	/**
+	 * Marks unreachable young objects, called by CollectGarbageInternal in place of the full analysis.
+	 *
+	 * @return true if only young objects may have been marked as unreachable, false if gc.VerifyMinorCollection replaced the result with a full analysis
+	 */
+	bool PerformReachabilityAnalysis(EObjectFlags KeepFlags, bool bForceSingleThreaded)
+	{
+		check(IsTracking());
+		SCOPED_NAMED_EVENT(FGCNursery_PerformReachabilityAnalysis, FColor::Red);
+		DECLARE_SCOPE_CYCLE_COUNTER(TEXT("FGCNursery::PerformReachabilityAnalysis"), STAT_FGCNursery_PerformReachabilityAnalysis, STATGROUP_GC);
+
+		FGCArrayStruct* ArrayStruct = FGCArrayPool::Get().GetArrayStructFromPool();
+		TArray<UObject*>& ObjectsToSerialize = ArrayStruct->ObjectsToSerialize;
+
+		int32 NumYoungObjects = 0;
+		int32 NumOldObjects = 0;
+		{
+			CSV_SCOPED_TIMING_STAT(GC, MarkYoungObjectsAsUnreachable);
+			const double StartTime = FPlatformTime::Seconds();
+			MarkYoungObjectsAsUnreachable(ObjectsToSerialize, KeepFlags, NumYoungObjects);
+			// Young objects are marked first so that the ones among the mutable objects of old clusters are found
+			AddOldObjectsToSerialize(ObjectsToSerialize, bForceSingleThreaded, NumOldObjects);
+			UE_LOG(LogGarbage, Verbose, TEXT("%f ms for Minor Mark Phase (%d Young Objects, %d Old Objects, %d Objects To Serialize)"), (FPlatformTime::Seconds() - StartTime) * 1000, NumYoungObjects, NumOldObjects, ObjectsToSerialize.Num());
+		}
+
+		FRealtimeGC RealtimeGC;
+		{
+			CSV_SCOPED_TIMING_STAT(GC, ReachabilityAnalysis);
+			const double StartTime = FPlatformTime::Seconds();
+			RealtimeGC.PerformReachabilityAnalysisOnObjects(ArrayStruct, bForceSingleThreaded);
+			UE_LOG(LogGarbage, Verbose, TEXT("%f ms for Minor Reachability Analysis"), (FPlatformTime::Seconds() - StartTime) * 1000);
+		}
+		FCoreUObjectDelegates::TraceExternalRootsForReachabilityAnalysis.Broadcast(RealtimeGC, KeepFlags, bForceSingleThreaded);
+
+		FGCArrayPool::Get().ReturnToPool(ArrayStruct);
+
+		GObjectCountDuringLastMarkPhase.Reset();
+		GObjectCountDuringLastMarkPhase.Add(NumYoungObjects);
+		CSV_CUSTOM_STAT(GC, NumObjectsMarked, NumYoungObjects, ECsvCustomStatOp::Set);
+
+		if (GVerifyMinorCollection)
+		{
+			Verify(KeepFlags, bForceSingleThreaded);
+			return false;
+		}
+		return true;
+	}
+
+	/** Adds unreachable young objects to the list of objects to destroy */
+	void GatherUnreachableObjects(TArray<FUObjectItem*>& OutUnreachableObjects) const
+	{
+		ForEachYoungObjectIndex([&OutUnreachableObjects](int32 ObjectIndex)
+		{
+			FUObjectItem* ObjectItem = GUObjectArray.IndexToObjectUnsafeForGC(ObjectIndex);
+			if (ObjectItem->Object && ObjectItem->IsUnreachable())
+			{
+				OutUnreachableObjects.Add(ObjectItem);
+			}
+		});
+	}
+
+	/** Makes all surviving young objects old and starts or stops tracking young objects according to gc.MinorCollectionsPerMajor */
+	void Promote(bool bAfterMinorCollection)
+	{
+		if (IsTracking() && bAfterMinorCollection)
+		{
+			int32 NumPromoted = 0;
+			int32 NumCollected = 0;
+			ForEachYoungObjectIndex([&NumPromoted, &NumCollected](int32 ObjectIndex)
+			{
+				FUObjectItem* ObjectItem = GUObjectArray.IndexToObjectUnsafeForGC(ObjectIndex);
+				if (ObjectItem->Object)
+				{
+					ObjectItem->IsUnreachable() ? ++NumCollected : ++NumPromoted;
+				}
+			});
+			GGarbageCollectionStats.NumObjectsPromoted += NumPromoted;
+			GGarbageCollectionStats.NumObjectsCollectedByMinorCollections += NumCollected;
+			INC_DWORD_STAT_BY(STAT_GC_ObjectsPromoted, NumPromoted);
+		}
+
+		const bool bShouldTrack = GMinorCollectionsPerMajor > 0;
+		if (bShouldTrack != IsTracking())
+		{
+			if (bShouldTrack)
+			{
+				GUObjectArray.AddUObjectCreateListener(this);
+				GUObjectArray.AddUObjectDeleteListener(this);
+			}
+			else
+			{
+				GUObjectArray.RemoveUObjectCreateListener(this);
+				GUObjectArray.RemoveUObjectDeleteListener(this);
+			}
+			GIsTrackingYoungObjects = bShouldTrack;
+		}
+
+		if (bShouldTrack)
+		{
+			const int32 NumWords = GUObjectArray.GetObjectItemArrayUnsafe().Capacity() / 32 + 1;
+			YoungBits.Reset();
+			YoungBits.AddZeroed(NumWords);
+		}
+		else
+		{
+			YoungBits.Empty();
+		}
+	}
+
+	//~ Begin FUObjectCreateListener and FUObjectDeleteListener Interfaces
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override
+	{
+		SetBit(YoungBits, Index);
+	}
+	virtual void NotifyUObjectDeleted(const UObjectBase* Object, int32 Index) override
+	{
+		ClearBit(YoungBits, Index);
+	}
+	virtual void OnUObjectArrayShutdown() override
+	{
+		// Called once for each list we're registered with
+		if (IsTracking())
+		{
+			GUObjectArray.RemoveUObjectCreateListener(this);
+			GUObjectArray.RemoveUObjectDeleteListener(this);
+			GIsTrackingYoungObjects = false;
+		}
+	}
+	//~ End FUObjectCreateListener and FUObjectDeleteListener Interfaces
+};
+
+void GCWriteBarrierSlow(const UObjectBase* Object)
+{
+	if (GIsIncrementalReachabilityPending)
+	{
+		FIncrementalReachability::Get().Shade(Object);
+	}
+}
+
+const FGarbageCollectionStats& GetGarbageCollectionStats()
+{
+	return GGarbageCollectionStats;
+}
+
+bool ShouldCollectMinorGarbage()
+{
+	return FGCNursery::Get().IsTracking() && !GIsEditor && GNumMinorCollectionsSinceMajor < GMinorCollectionsPerMajor;
+}
+
+bool IsIncrementalReachabilityAnalysisAllowed()
+{
+	return GAllowIncrementalReachability && !GIsEditor;
+}
+
+bool IsIncrementalReachabilityAnalysisPending()
+{
+	return GIsIncrementalReachabilityPending;
+}
+
+static bool IncrementalDestroyGarbage(bool bUseTimeLimit, float TimeLimit);
+
+/**
+ * Incrementally purge garbage by deleting all unreferenced objects after routing Destroy.
+ *
+ * Calling code needs to be EXTREMELY careful when and how to call this function as 
+ * RF_Unreachable cannot change on any objects unless any pending purge has completed!
+ *
+ * @param	bUseTimeLimit	whether the time limit parameter should be used
+ * @param	TimeLimit		soft time limit for this function call
+ */
+void IncrementalPurgeGarbage(bool bUseTimeLimit, float TimeLimit)
+{
+	SCOPED_NAMED_EVENT(IncrementalPurgeGarbage, FColor::Red);
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("IncrementalPurgeGarbage"), STAT_IncrementalPurgeGarbage, STATGROUP_GC);
+	CSV_SCOPED_TIMING_STAT_EXCLUSIVE(GarbageCollection);
+	CSV_SCOPED_TIMING_STAT(GC, IncrementalPurgeGarbage);
+
+	if (GExitPurge)
+	{
+		GObjPurgeIsRequired = true;
+		GUObjectArray.DisableDisregardForGC();
+		GObjCurrentPurgeObjectIndexNeedsReset = true;
+	}
+	// Early out if there is nothing to do.
+	if (!GObjPurgeIsRequired)
+	{
+		return;
+	}
+
+	bool bCompleted = false;
+
+	struct FResetPurgeProgress
+	{
+		bool& bCompletedRef;
+		FResetPurgeProgress(bool& bInCompletedRef)
+			: bCompletedRef(bInCompletedRef)
+		{
+			// Incremental purge is now in progress.
+			GObjIncrementalPurgeIsInProgress = true;
+			FPlatformMisc::MemoryBarrier();
+		}
+		~FResetPurgeProgress()
+		{
+			if (bCompletedRef)
+			{
+				GObjIncrementalPurgeIsInProgress = false;
+				FPlatformMisc::MemoryBarrier();
+			}
+		}
+
+	} ResetPurgeProgress(bCompleted);
+
+	// Keep track of start time to enforce time limit unless bForceFullPurge is true;
+	GCStartTime = FPlatformTime::Seconds();
+
+	bool bTimeLimitReached = false;
+	if (GUnrechableObjectIndex < GUnreachableObjects.Num())
+	{
+		{
+			FConditionalGCLock ScopedGCLock;
+			bTimeLimitReached = UnhashUnreachableObjects(bUseTimeLimit, TimeLimit);
+		}
+		if (GUnrechableObjectIndex >= GUnreachableObjects.Num())
+		{
+			FScopedCBDProfile::DumpProfile();
+		}
+	}
+
+	if (!bTimeLimitReached)
+	{
+		bCompleted = IncrementalDestroyGarbage(bUseTimeLimit, TimeLimit);
+	}
+}
+
+bool IncrementalDestroyGarbage(bool bUseTimeLimit, float TimeLimit)
+{
+	const bool bMultithreadedPurge = !ShouldForceSingleThreadedGC() && GMultithreadedDestructionEnabled;
+	if (!GAsyncPurge)
+	{
+		GAsyncPurge = new FAsyncPurge(bMultithreadedPurge);
+	}
+	else if (GAsyncPurge->IsMultithreaded() != bMultithreadedPurge)
+	{
+		check(GAsyncPurge->IsFinished());
+		delete GAsyncPurge;
+		GAsyncPurge = new FAsyncPurge(bMultithreadedPurge);
+	}
+
+	bool bCompleted = false;
+	bool bTimeLimitReached = false;
+
+	// Keep track of time it took to destroy objects for stats
+	double IncrementalDestroyGarbageStartTime = FPlatformTime::Seconds();
+
+	// Depending on platform FPlatformTime::Seconds might take a noticeable amount of time if called thousands of times so we avoid
+	// enforcing the time limit too often, especially as neither Destroy nor actual deletion should take significant
+	// amounts of time.
+	const int32	TimeLimitEnforcementGranularityForDestroy = 10;
+	const int32	TimeLimitEnforcementGranularityForDeletion = 100;
+
+	// Set 'I'm garbage collecting' flag - might be checked inside UObject::Destroy etc.
+	FGCScopeLock GCLock;
+
+	if( !GObjFinishDestroyHasBeenRoutedToAllObjects && !bTimeLimitReached )
+	{
+		check(GUnrechableObjectIndex >= GUnreachableObjects.Num());
+
+		// Try to dispatch all FinishDestroy messages to unreachable objects.  We'll iterate over every
+		// single object and destroy any that are ready to be destroyed.  The objects that aren't yet
+		// ready will be added to a list to be processed afterwards.
+		int32 TimeLimitTimePollCounter = 0;
+		int32 FinishDestroyTimePollCounter = 0;
+
+		if (GObjCurrentPurgeObjectIndexNeedsReset)
+		{
+			GObjCurrentPurgeObjectIndex = 0;
+			GObjCurrentPurgeObjectIndexNeedsReset = false;
+		}
+
+		while (GObjCurrentPurgeObjectIndex < GUnreachableObjects.Num())
+		{
+			FUObjectItem* ObjectItem = GUnreachableObjects[GObjCurrentPurgeObjectIndex];
+			checkSlow(ObjectItem);
+
+			//@todo UE4 - A prefetch was removed here. Re-add it. It wasn't right anyway, since it was ten items ahead and the consoles on have 8 prefetch slots
+
+			check(ObjectItem->IsUnreachable());
+			{
+				UObject* Object = static_cast<UObject*>(ObjectItem->Object);
+				// Object should always have had BeginDestroy called on it and never already be destroyed
+				check( Object->HasAnyFlags( RF_BeginDestroyed ) && !Object->HasAnyFlags( RF_FinishDestroyed ) );
+
+				// Only proceed with destroying the object if the asynchronous cleanup started by BeginDestroy has finished.
+				if(Object->IsReadyForFinishDestroy())
+				{
+#if PERF_DETAILED_PER_CLASS_GC_STATS
+					// Keep track of how many objects of a certain class we're purging.
+					const FName& ClassName = Object->GetClass()->GetFName();
+					int32 InstanceCount = GClassToPurgeCountMap.FindRef( ClassName );
 					GClassToPurgeCountMap.Add( ClassName, ++InstanceCount );
 #endif
 					// Send FinishDestroy message.
@@ -1714,9 +2839,12 @@ void GatherUnreachableObjects(bool bForceSingleThreaded)
 	TArray<FUObjectItem*> ClusterItemsToDestroy;
 	int32 ClusterObjects = 0;
 
+	const bool bDenseSweep = !!GDenseFlagSweeps;
+	const double SweepStartTime = FPlatformTime::Seconds();
+
 	// Iterate over all objects. Note that we iterate over the UObjectArray and usually check only internal flags which
 	// are part of the array so we don't suffer from cache misses as much as we would if we were to check ObjectFlags.
-	ParallelFor(NumThreads, [&ClusterItemsToDestroy, NumberOfObjectsPerThread, NumThreads, MaxNumberOfObjects](int32 ThreadIndex)
+	ParallelFor(NumThreads, [&ClusterItemsToDestroy, NumberOfObjectsPerThread, NumThreads, MaxNumberOfObjects, bDenseSweep](int32 ThreadIndex)
 	{
 		int32 FirstObjectIndex = ThreadIndex * NumberOfObjectsPerThread + (GExitPurge ? 0 : GUObjectArray.GetFirstGCIndex());
 		int32 NumObjects = (ThreadIndex < (NumThreads - 1)) ? NumberOfObjectsPerThread : (MaxNumberOfObjects - (NumThreads - 1) * NumberOfObjectsPerThread);
@@ -1724,7 +2852,7 @@ void GatherUnreachableObjects(bool bForceSingleThreaded)
 		TArray<FUObjectItem*> ThisThreadUnreachableObjects;
 		TArray<FUObjectItem*> ThisThreadClusterItemsToDestroy;
 
-		for (int32 ObjectIndex = FirstObjectIndex; ObjectIndex <= LastObjectIndex; ++ObjectIndex)
+		auto GatherObject = [&ThisThreadUnreachableObjects, &ThisThreadClusterItemsToDestroy](int32 ObjectIndex)
 		{
 			FUObjectItem* ObjectItem = &GUObjectArray.GetObjectItemArrayUnsafe()[ObjectIndex];
 			if (ObjectItem->IsUnreachable())
@@ -1736,7 +2864,29 @@ void GatherUnreachableObjects(bool bForceSingleThreaded)
 					ThisThreadClusterItemsToDestroy.Add(ObjectItem);
 				}
 			}
+		};
+
+		int32 ObjectIndex = FirstObjectIndex;
+		if (bDenseSweep)
+		{
+			// Skip over words without unreachable objects without touching their object items
+			const uint64 UnreachableStates = FGCStateSweep::Lanes(EUObjectGCState::FromFlags(EInternalObjectFlags::Unreachable));
+			for (; ObjectIndex + FGCStateSweep::StatesPerWord - 1 <= LastObjectIndex; ObjectIndex += FGCStateSweep::StatesPerWord)
+			{
+				if (FGCStateSweep::Load(ObjectIndex) & UnreachableStates)
+				{
+					for (int32 LaneIndex = 0; LaneIndex < FGCStateSweep::StatesPerWord; ++LaneIndex)
+					{
+						GatherObject(ObjectIndex + LaneIndex);
+					}
+				}
+			}
 		}
+		for (; ObjectIndex <= LastObjectIndex; ++ObjectIndex)
+		{
+			GatherObject(ObjectIndex);
+		}
+
 		if (ThisThreadUnreachableObjects.Num())
 		{
 			FScopeLock UnreachableObjectsLock(&GUnreachableObjectsCritical);
@@ -1745,6 +2895,10 @@ void GatherUnreachableObjects(bool bForceSingleThreaded)
 		}
 	}, bForceSingleThreaded);
 
+	const double SweepTime = FPlatformTime::Seconds() - SweepStartTime;
+	INC_FLOAT_STAT_BY(STAT_GC_GatherSweepTime, SweepTime * 1000.0);
+	CSV_CUSTOM_STAT(GC, GatherSweepTime, SweepTime * 1000.0, ECsvCustomStatOp::Set);
+
 	{
 		// @todo: if GUObjectClusters.FreeCluster() was thread safe we could do this in parallel too
 		for (FUObjectItem* ClusterRootItem : ClusterItemsToDestroy)
@@ -1779,13 +2933,36 @@ void GatherUnreachableObjects(bool bForceSingleThreaded)
 		ClusterItemsToDestroy.Num());
 }
 
+static void RecordCollectionStats(bool bMinorCollection, double CollectionTime)
+{
+	if (bMinorCollection)
+	{
+		GGarbageCollectionStats.NumMinorCollections++;
+		GGarbageCollectionStats.LastMinorCollectionTime = CollectionTime;
+		GGarbageCollectionStats.TotalMinorCollectionTime += CollectionTime;
+		GNumMinorCollectionsSinceMajor++;
+		INC_FLOAT_STAT_BY(STAT_GC_MinorCollectionTime, CollectionTime * 1000.0);
+		CSV_CUSTOM_STAT(GC, MinorCollectionTime, CollectionTime * 1000.0, ECsvCustomStatOp::Set);
+	}
+	else
+	{
+		GGarbageCollectionStats.NumMajorCollections++;
+		GGarbageCollectionStats.LastMajorCollectionTime = CollectionTime;
+		GGarbageCollectionStats.TotalMajorCollectionTime += CollectionTime;
+		GNumMinorCollectionsSinceMajor = 0;
+		INC_FLOAT_STAT_BY(STAT_GC_MajorCollectionTime, CollectionTime * 1000.0);
+		CSV_CUSTOM_STAT(GC, MajorCollectionTime, CollectionTime * 1000.0, ECsvCustomStatOp::Set);
+	}
+}
+
 /** 
  * Deletes all unreferenced objects, keeping objects that have any of the passed in KeepFlags set
  *
  * @param	KeepFlags			objects with those flags will be kept regardless of being referenced or not
  * @param	bPerformFullPurge	if true, perform a full purge after the mark pass
+ * @param	bMinorCollection	if true, only consider objects created since the last garbage collection if they're being tracked
  */
-void CollectGarbageInternal(EObjectFlags KeepFlags, bool bPerformFullPurge)
+void CollectGarbageInternal(EObjectFlags KeepFlags, bool bPerformFullPurge, bool bMinorCollection = false)
 {
 	SCOPE_TIME_GUARD(TEXT("Collect Garbage"));
 	SCOPED_NAMED_EVENT(CollectGarbageInternal, FColor::Red);
@@ -1861,7 +3038,28 @@ void CollectGarbageInternal(EObjectFlags KeepFlags, bool bPerformFullPurge)
 		const bool bForceSingleThreadedGC = ShouldForceSingleThreadedGC();
 
 		// Perform reachability analysis.
+		const double CollectionStartTime = FPlatformTime::Seconds();
+		FGCNursery& Nursery = FGCNursery::Get();
+		FIncrementalReachability& IncrementalReachability = FIncrementalReachability::Get();
+		bMinorCollection = bMinorCollection && Nursery.IsTracking() && !GIsIncrementalReachabilityPending;
+		bool bOnlyYoungObjectsUnreachable = false;
+		if (bMinorCollection)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			bOnlyYoungObjectsUnreachable = Nursery.PerformReachabilityAnalysis(KeepFlags, bForceSingleThreadedGC);
+			UE_LOG(LogGarbage, Log, TEXT("%f ms for minor GC"), (FPlatformTime::Seconds() - StartTime) * 1000);
+		}
+		else if (IncrementalReachability.IsReadyToFinish())
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			IncrementalReachability.Finish(bForceSingleThreadedGC);
+			UE_LOG(LogGarbage, Log, TEXT("%f ms for GC"), (FPlatformTime::Seconds() - StartTime) * 1000);
+		}
+		else
 		{
+			// A full GC makes any incremental analysis in progress pointless
+			IncrementalReachability.Cancel();
+
 			const double StartTime = FPlatformTime::Seconds();
 			FRealtimeGC TagUsedRealtimeGC;
 			TagUsedRealtimeGC.PerformReachabilityAnalysis(KeepFlags, bForceSingleThreadedGC);
@@ -1871,6 +3069,7 @@ void CollectGarbageInternal(EObjectFlags KeepFlags, bool bPerformFullPurge)
 		// Reconstruct clusters if needed
 		if (GUObjectClusters.ClustersNeedDissolving())
 		{
+			CSV_SCOPED_TIMING_STAT(GC, DissolveClusters);
 			const double StartTime = FPlatformTime::Seconds();
 			GUObjectClusters.DissolveClusters();
 			UE_LOG(LogGarbage, Log, TEXT("%f ms for dissolving GC clusters"), (FPlatformTime::Seconds() - StartTime) * 1000);
@@ -1882,7 +3081,24 @@ void CollectGarbageInternal(EObjectFlags KeepFlags, bool bPerformFullPurge)
 		{
 			FGCArrayPool::Get().ClearWeakReferences(bPerformFullPurge);
 
-			GatherUnreachableObjects(bForceSingleThreadedGC);
+			{
+				CSV_SCOPED_TIMING_STAT(GC, GatherUnreachableObjects);
+				if (bOnlyYoungObjectsUnreachable)
+				{
+					GUnreachableObjects.Reset();
+					GUnrechableObjectIndex = 0;
+					Nursery.GatherUnreachableObjects(GUnreachableObjects);
+					UE_LOG(LogGarbage, Log, TEXT("%d young objects collected"), GUnreachableObjects.Num());
+				}
+				else
+				{
+					GatherUnreachableObjects(bForceSingleThreadedGC);
+				}
+			}
+
+			// Everything that survived is old from now on. A minor collection whose result gc.VerifyMinorCollection replaced with a full one counts as a full one.
+			Nursery.Promote(bOnlyYoungObjectsUnreachable);
+			RecordCollectionStats(bOnlyYoungObjectsUnreachable, FPlatformTime::Seconds() - CollectionStartTime);
 
 			if (bPerformFullPurge || !GIncrementalBeginDestroyEnabled)
 			{
@@ -1926,6 +3142,7 @@ bool IsIncrementalUnhashPending()
 bool UnhashUnreachableObjects(bool bUseTimeLimit, float TimeLimit)
 {
 	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("UnhashUnreachableObjects"), STAT_UnhashUnreachableObjects, STATGROUP_GC);
+	CSV_SCOPED_TIMING_STAT(GC, UnhashUnreachableObjects);
 
 	TGuardValue<bool> GuardObjUnhashUnreachableIsInProgress(GObjUnhashUnreachableIsInProgress, true);
 
@@ -1966,6 +3183,13 @@ bool UnhashUnreachableObjects(bool bUseTimeLimit, float TimeLimit)
 
 	FCoreUObjectDelegates::PostGarbageCollectConditionalBeginDestroy.Broadcast();
 
+	// Lock free hash table lookups that started before the objects got unhashed may still be looking at them, nothing
+	// unhashed by this pass can be destroyed until they're done
+	if (Items > 0)
+	{
+		WaitForUObjectHashReaders();
+	}
+
 	// Return true if time limit has been reached
 	return GUnrechableObjectIndex < GUnreachableObjects.Num();
 }
@@ -1982,7 +3206,8 @@ void CollectGarbage(EObjectFlags KeepFlags, bool bPerformFullPurge)
 	ReleaseGCLock();
 }
 
-bool TryCollectGarbage(EObjectFlags KeepFlags, bool bPerformFullPurge)
+/** Acquires the GC lock if no other thread holds it or GC has been skipped too many times already */
+static bool TryAcquireGCLockForCollection()
 {
 	// No other thread may be performing UObject operations while we're running
 	bool bCanRunGC = FGCCSyncObject::Get().TryGCLock();
@@ -1997,6 +3222,16 @@ bool TryCollectGarbage(EObjectFlags KeepFlags, bool bPerformFullPurge)
 			bCanRunGC = true;
 		}
 	}
+	if (!bCanRunGC)
+	{
+		GNumAttemptsSinceLastGC++;
+	}
+	return bCanRunGC;
+}
+
+bool TryCollectGarbage(EObjectFlags KeepFlags, bool bPerformFullPurge)
+{
+	const bool bCanRunGC = TryAcquireGCLockForCollection();
 	if (bCanRunGC)
 	{
 		// Perform actual garbage collection
@@ -2005,14 +3240,68 @@ bool TryCollectGarbage(EObjectFlags KeepFlags, bool bPerformFullPurge)
 		// Other threads are free to use UObjects
 		ReleaseGCLock();
 	}
-	else
+
+	return bCanRunGC;
+}
+
+void CollectMinorGarbage(EObjectFlags KeepFlags)
+{
+	AcquireGCLock();
+	CollectGarbageInternal(KeepFlags, false, true);
+	ReleaseGCLock();
+}
+
+bool TryCollectMinorGarbage(EObjectFlags KeepFlags)
+{
+	const bool bCanRunGC = TryAcquireGCLockForCollection();
+	if (bCanRunGC)
 	{
-		GNumAttemptsSinceLastGC++;
+		CollectGarbageInternal(KeepFlags, false, true);
+		ReleaseGCLock();
 	}
 
 	return bCanRunGC;
 }
 
+bool IncrementalCollectGarbage(EObjectFlags KeepFlags, float TimeLimit)
+{
+	FIncrementalReachability& IncrementalReachability = FIncrementalReachability::Get();
+
+	// Objects can't be marked again until the previous GC has been completely purged
+	if (!GIsIncrementalReachabilityPending && IsIncrementalPurgePending())
+	{
+		IncrementalPurgeGarbage(false);
+	}
+
+	// No other thread may be performing UObject operations while we're marking
+	if (!TryAcquireGCLockForCollection())
+	{
+		return false;
+	}
+
+	bool bReadyToFinish = false;
+	{
+		LLM_SCOPE(ELLMTag::GC);
+		FGCScopeLock GCLock;
+
+		if (!GIsIncrementalReachabilityPending)
+		{
+			IncrementalReachability.Start(KeepFlags, ShouldForceSingleThreadedGC());
+		}
+		bReadyToFinish = IncrementalReachability.Tick(TimeLimit > 0.0f ? TimeLimit : GIncrementalReachabilityTimeLimit / 1000.0f);
+		GNumAttemptsSinceLastGC = 0;
+	}
+
+	if (bReadyToFinish)
+	{
+		CollectGarbageInternal(KeepFlags, false);
+	}
+
+	ReleaseGCLock();
+
+	return bReadyToFinish;
+}
+
 void UObject::CallAddReferencedObjects(FReferenceCollector& Collector)
 {
 	GetClass()->CallAddReferencedObjects(this, Collector);
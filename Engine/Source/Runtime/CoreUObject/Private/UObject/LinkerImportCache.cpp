@@ -0,0 +1,143 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "UObject/LinkerImportCache.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/Class.h"
+#include "UObject/LinkerLoad.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+static int32 GLinkerImportCache = 1;
+static FAutoConsoleVariableRef CVarLinkerImportCache(
+	TEXT("s.LinkerImportCache"),
+	GLinkerImportCache,
+	TEXT("If non-zero, the classes and objects that imports resolve to are cached across linkers instead of searched for in the object hash every time."),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*)
+	{
+		FLinkerImportCache::Get().Reset();
+	}),
+	ECVF_Default
+	);
+
+FLinkerImportCache& FLinkerImportCache::Get()
+{
+	static FLinkerImportCache Cache;
+	return Cache;
+}
+
+FLinkerImportCache::FLinkerImportCache()
+	: TotalHits(0)
+	, TotalMisses(0)
+{
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FLinkerImportCache::RemoveStaleEntries);
+}
+
+FLinkerImportCache::~FLinkerImportCache()
+{
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+}
+
+bool FLinkerImportCache::IsEnabled() const
+{
+	return GLinkerImportCache != 0;
+}
+
+UClass* FLinkerImportCache::FindClass(FName ClassPackage, FName ClassName)
+{
+	const FLinkerImportCacheKey Key(ClassPackage, ClassPackage, ClassName);
+	const bool bEnabled = IsEnabled();
+	if (bEnabled)
+	{
+		if (UObject* Cached = FindCached(Key, UClass::StaticClass(), nullptr))
+		{
+			return static_cast<UClass*>(Cached);
+		}
+	}
+
+	UClass* Class = nullptr;
+	if (UPackage* Package = FindObjectFast<UPackage>(nullptr, ClassPackage, false, false))
+	{
+		Class = FindObjectFast<UClass>(Package, ClassName, false, false);
+		if (bEnabled && Class && Class->GetOuter() == Package)
+		{
+			AddCached(Key, Class);
+		}
+	}
+	return Class;
+}
+
+UObject* FLinkerImportCache::FindImport(UClass* ImportClass, UObject* ImportOuter, FName ObjectName)
+{
+	if (!IsEnabled())
+	{
+		return FLinkerLoad::FindImportFast(ImportClass, ImportOuter, ObjectName);
+	}
+
+	const FLinkerImportCacheKey Key(ImportOuter->GetOutermost()->GetFName(), ImportOuter->GetFName(), ObjectName);
+	if (UObject* Cached = FindCached(Key, ImportClass, ImportOuter))
+	{
+		return Cached;
+	}
+
+	UObject* Object = FLinkerLoad::FindImportFast(ImportClass, ImportOuter, ObjectName);
+	// Objects found by their legacy path or as a dynamic class don't match what was asked for and would always miss
+	if (Object && Object->GetOuter() == ImportOuter && Object->IsA(ImportClass))
+	{
+		AddCached(Key, Object);
+	}
+	return Object;
+}
+
+UObject* FLinkerImportCache::FindCached(const FLinkerImportCacheKey& Key, const UClass* ImportClass, const UObject* ImportOuter)
+{
+	FWeakObjectPtr Entry;
+	{
+		FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+		if (const FWeakObjectPtr* Found = Entries.Find(Key))
+		{
+			Entry = *Found;
+		}
+	}
+
+	// Only return what StaticFindObjectFast would have found: the same exclusions, and the class is only in its package
+	UObject* Object = Entry.Get(true);
+	const EInternalObjectFlags ExcludedInternalFlags = EInternalObjectFlags::Unreachable | (IsInAsyncLoadingThread() ? EInternalObjectFlags::None : EInternalObjectFlags::AsyncLoading);
+	if (Object
+		&& Object->GetFName() == Key.ObjectName
+		&& (ImportOuter ? Object->GetOuter() == ImportOuter : (Object->GetOuter() && Object->GetOuter()->GetFName() == Key.OuterName && !Object->GetOuter()->GetOuter()))
+		&& Object->IsA(ImportClass)
+		&& !Object->HasAnyFlags(RF_NewerVersionExists)
+		&& !Object->HasAnyInternalFlags(ExcludedInternalFlags))
+	{
+		++TotalHits;
+		return Object;
+	}
+
+	++TotalMisses;
+	return nullptr;
+}
+
+void FLinkerImportCache::AddCached(const FLinkerImportCacheKey& Key, UObject* Object)
+{
+	FRWScopeLock ScopeLock(Lock, SLT_Write);
+	Entries.Add(Key, FWeakObjectPtr(Object));
+}
+
+void FLinkerImportCache::Reset()
+{
+	FRWScopeLock ScopeLock(Lock, SLT_Write);
+	Entries.Empty();
+}
+
+void FLinkerImportCache::RemoveStaleEntries()
+{
+	FRWScopeLock ScopeLock(Lock, SLT_Write);
+	for (TMap<FLinkerImportCacheKey, FWeakObjectPtr>::TIterator It(Entries); It; ++It)
+	{
+		if (It.Value().IsStale())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
@@ -24,6 +24,7 @@
 #include "UObject/LinkerPlaceholderExportObject.h"
 #include "UObject/LinkerPlaceholderFunction.h"
 #include "UObject/LinkerManager.h"
+#include "UObject/LinkerImportCache.h"
 #include "Serialization/DeferredMessageLog.h"
 #include "UObject/UObjectThreadContext.h"
 #include "Serialization/AsyncLoading.h"
@@ -3139,54 +3140,46 @@ bool FLinkerLoad::VerifyImportInner(const int32 ImportIndex, FString& WarningSuf
 	// If not found in file, see if it's a public native transient class or field.
 	if( Import.SourceIndex==INDEX_NONE && Pkg!=NULL )
 	{
-		UObject* ClassPackage = FindObject<UPackage>( NULL, *Import.ClassPackage.ToString() );
-		if( ClassPackage )
+		UClass* FindClass = FLinkerImportCache::Get().FindClass( Import.ClassPackage, Import.ClassName );
+		if( FindClass )
 		{
-			UClass* FindClass = FindObject<UClass>( ClassPackage, *Import.ClassName.ToString() );
-			if( FindClass )
-			{
-				UObject* FindOuter			= Pkg;
+			UObject* FindOuter			= Pkg;
 
-				if ( Import.OuterIndex.IsImport() )
+			if ( Import.OuterIndex.IsImport() )
+			{
+				// if this import corresponds to an intrinsic class, OuterImport's XObject will be NULL if this import
+				// belongs to the same package that the import's class is in; in this case, the package is the correct Outer to use
+				// for finding this object
+				// otherwise, this import represents a field of an intrinsic class, and OuterImport's XObject should be non-NULL (the object
+				// that contains the field)
+				FObjectImport& OuterImport	= Imp(Import.OuterIndex);
+				if ( OuterImport.XObject != NULL )
 				{
-					// if this import corresponds to an intrinsic class, OuterImport's XObject will be NULL if this import
-					// belongs to the same package that the import's class is in; in this case, the package is the correct Outer to use
-					// for finding this object
-					// otherwise, this import represents a field of an intrinsic class, and OuterImport's XObject should be non-NULL (the object
-					// that contains the field)
-					FObjectImport& OuterImport	= Imp(Import.OuterIndex);
-					if ( OuterImport.XObject != NULL )
-					{
-						FindOuter = OuterImport.XObject;
-					}
+					FindOuter = OuterImport.XObject;
 				}
+			}
 
-				UObject* FindObject = FindImport(FindClass, FindOuter, *Import.ObjectName.ToString());
-				// Reference to in memory-only package's object, native transient class or CDO of such a class.
-				bool bIsInMemoryOnlyOrNativeTransient = bCameFromMemoryOnlyPackage || (FindObject != NULL && ((FindObject->IsNative() && FindObject->HasAllFlags(RF_Public | RF_Transient)) || (FindObject->HasAnyFlags(RF_ClassDefaultObject) && FindObject->GetClass()->IsNative() && FindObject->GetClass()->HasAllFlags(RF_Public | RF_Transient))));
-				// Check for structs which have been moved to another header (within the same class package).
-				if (!FindObject && bIsInMemoryOnlyOrNativeTransient && FindClass == UScriptStruct::StaticClass())
-				{
-					FindObject = StaticFindObject( FindClass, ANY_PACKAGE, *Import.ObjectName.ToString(), true );
-					if (FindObject && FindOuter->GetOutermost() != FindObject->GetOutermost())
-					{
-						// Limit the results to the same package.I
-						FindObject = NULL;
-					}
-				}
-				if (FindObject != NULL && ((LoadFlags & LOAD_FindIfFail) || bIsInMemoryOnlyOrNativeTransient))
-				{
-					Import.XObject = FindObject;
-					FUObjectSerializeContext* CurrentLoadContext = GetSerializeContext();
-					check(CurrentLoadContext);
-					CurrentLoadContext->IncrementImportCount();
-					FLinkerManager::Get().AddLoaderWithNewImports(this);
-				}
-				else
+			UObject* FindObject = FindImport(FindClass, FindOuter, *Import.ObjectName.ToString());
+			// Reference to in memory-only package's object, native transient class or CDO of such a class.
+			bool bIsInMemoryOnlyOrNativeTransient = bCameFromMemoryOnlyPackage || (FindObject != NULL && ((FindObject->IsNative() && FindObject->HasAllFlags(RF_Public | RF_Transient)) || (FindObject->HasAnyFlags(RF_ClassDefaultObject) && FindObject->GetClass()->IsNative() && FindObject->GetClass()->HasAllFlags(RF_Public | RF_Transient))));
+			// Check for structs which have been moved to another header (within the same class package).
+			if (!FindObject && bIsInMemoryOnlyOrNativeTransient && FindClass == UScriptStruct::StaticClass())
+			{
+				FindObject = StaticFindObject( FindClass, ANY_PACKAGE, *Import.ObjectName.ToString(), true );
+				if (FindObject && FindOuter->GetOutermost() != FindObject->GetOutermost())
 				{
-					SafeReplace = true;
+					// Limit the results to the same package.I
+					FindObject = NULL;
 				}
 			}
+			if (FindObject != NULL && ((LoadFlags & LOAD_FindIfFail) || bIsInMemoryOnlyOrNativeTransient))
+			{
+				Import.XObject = FindObject;
+				FUObjectSerializeContext* CurrentLoadContext = GetSerializeContext();
+				check(CurrentLoadContext);
+				CurrentLoadContext->IncrementImportCount();
+				FLinkerManager::Get().AddLoaderWithNewImports(this);
+			}
 			else
 			{
 				SafeReplace = true;
@@ -3598,6 +3591,7 @@ void FLinkerLoad::Preload( UObject* Object )
 	// Preload the object if necessary.
 	if (Object->HasAnyFlags(RF_NeedLoad))
 	{
+		checkf(!FUObjectThreadContext::Get().IsSerializingOnLoaderWorker, TEXT("Unable to preload %s while serializing an export on a loader worker. Classes that preload objects from Serialize must return false from IsSerializeThreadSafe."), *Object->GetFullName());
 		FUObjectSerializeContext* CurrentLoadContext = GetSerializeContext();
 
 		if (Object->GetLinker() == this)
@@ -4010,6 +4004,16 @@ bool FLinkerLoad::WillTextureBeLoaded( UClass* Class, int32 ExportIndex )
 
 UObject* FLinkerLoad::CreateExport( int32 Index )
 {
+	// Exports are looked up far more often than they are created, return the ones that already exist before setting up
+	// the serialize context and the message log, which takes a lock.
+	{
+		const FObjectExport& ExistingExport = ExportMap[ Index ];
+		if( ExistingExport.Object )
+		{
+			return ExistingExport.bExportLoadFailed ? nullptr : ExistingExport.Object;
+		}
+	}
+
 	FScopedCreateExportCounter ScopedCounter( this, Index );
 	FDeferredMessageLog LoadErrors(NAME_LoadErrors);
 
@@ -4596,6 +4600,16 @@ bool FLinkerLoad::IsImportNative(const int32 Index) const
 	return bIsImportNative;
 }
 
+/** CreatePackage for a top level import, without building the package name as a string when the package is already in memory */
+static UPackage* FindOrCreateImportPackage(FName PackageName)
+{
+	if (UPackage* Package = FindObjectFast<UPackage>(nullptr, PackageName, false, false))
+	{
+		return Package;
+	}
+	return CreatePackage(nullptr, *PackageName.ToString());
+}
+
 // Return the loaded object corresponding to an import index; any errors are fatal.
 UObject* FLinkerLoad::CreateImport( int32 Index )
 {
@@ -4626,83 +4640,80 @@ UObject* FLinkerLoad::CreateImport( int32 Index )
 		if (!GIsEditor && !IsRunningCommandlet())
 		{
 			// Try to find existing version in memory first.
-			if( UPackage* ClassPackage = FindObjectFast<UPackage>( NULL, Import.ClassPackage, false, false ) )
+			if( UClass*	FindClass = FLinkerImportCache::Get().FindClass( Import.ClassPackage, Import.ClassName ) )
 			{
-				if( UClass*	FindClass = FindObjectFast<UClass>( ClassPackage, Import.ClassName, false, false ) ) // 
+				// Make sure the class has been loaded and linked before creating a CDO.
+				// This is an edge case, but can happen if a blueprint package has not finished creating exports for a class
+				// during async loading, and another package creates the class via CreateImport while in cooked builds because
+				// we don't call preload immediately after creating a class in CreateExport like in non-cooked builds.
+				Preload( FindClass );
+
+				FindClass->GetDefaultObject(); // build the CDO if it isn't already built
+				UObject*	FindObject		= NULL;
+
+				// Import is a toplevel package.
+				if( Import.OuterIndex.IsNull() )
 				{
-					// Make sure the class has been loaded and linked before creating a CDO.
-					// This is an edge case, but can happen if a blueprint package has not finished creating exports for a class
-					// during async loading, and another package creates the class via CreateImport while in cooked builds because
-					// we don't call preload immediately after creating a class in CreateExport like in non-cooked builds.
-					Preload( FindClass );
-
-					FindClass->GetDefaultObject(); // build the CDO if it isn't already built
-					UObject*	FindObject		= NULL;
-	
-					// Import is a toplevel package.
-					if( Import.OuterIndex.IsNull() )
-					{
-						FindObject = CreatePackage(NULL, *Import.ObjectName.ToString());
-					}
-					// Import is regular import/ export.
-					else
+					FindObject = FindOrCreateImportPackage(Import.ObjectName);
+				}
+				// Import is regular import/ export.
+				else
+				{
+					// Find the imports' outer.
+					UObject* FindOuter = NULL;
+					// Import.
+					if( Import.OuterIndex.IsImport() )
 					{
-						// Find the imports' outer.
-						UObject* FindOuter = NULL;
-						// Import.
-						if( Import.OuterIndex.IsImport() )
+						FObjectImport& OuterImport = Imp(Import.OuterIndex);
+						// Outer already in memory.
+						if( OuterImport.XObject )
 						{
-							FObjectImport& OuterImport = Imp(Import.OuterIndex);
-							// Outer already in memory.
-							if( OuterImport.XObject )
-							{
-								FindOuter = OuterImport.XObject;
-							}
-							// Outer is toplevel package, create/ find it.
-							else if( OuterImport.OuterIndex.IsNull() )
-							{
-								FindOuter = CreatePackage( NULL, *OuterImport.ObjectName.ToString() );
-							}
-							// Outer is regular import/ export, use IndexToObject to potentially recursively load/ find it.
-							else
-							{
-								FindOuter = IndexToObject( Import.OuterIndex );
-							}
+							FindOuter = OuterImport.XObject;
 						}
-						// Export.
-						else 
+						// Outer is toplevel package, create/ find it.
+						else if( OuterImport.OuterIndex.IsNull() )
 						{
-							// Create/ find the object's outer.
-							FindOuter = IndexToObject( Import.OuterIndex );
+							FindOuter = FindOrCreateImportPackage(OuterImport.ObjectName);
 						}
-						if (!FindOuter)
+						// Outer is regular import/ export, use IndexToObject to potentially recursively load/ find it.
+						else
 						{
-							// This can happen when deleting native properties or restructing blueprints. If there is an actual problem it will be caught when trying to resolve the outer itself
-							FString OuterName = Import.OuterIndex.IsNull() ? LinkerRoot->GetFullName() : GetFullImpExpName(Import.OuterIndex);
-							UE_LOG(LogLinker, Verbose, TEXT("CreateImport: Failed to load Outer for resource '%s': %s"), *Import.ObjectName.ToString(), *OuterName);
-							return NULL;
+							FindOuter = IndexToObject( Import.OuterIndex );
 						}
-	
-						// Find object now that we know it's class, outer and name.
-						FindObject = FindImportFast(FindClass, FindOuter, Import.ObjectName);
-						if (UDynamicClass* FoundDynamicClass = Cast<UDynamicClass>(FindObject))
+					}
+					// Export.
+					else 
+					{
+						// Create/ find the object's outer.
+						FindOuter = IndexToObject( Import.OuterIndex );
+					}
+					if (!FindOuter)
+					{
+						// This can happen when deleting native properties or restructing blueprints. If there is an actual problem it will be caught when trying to resolve the outer itself
+						FString OuterName = Import.OuterIndex.IsNull() ? LinkerRoot->GetFullName() : GetFullImpExpName(Import.OuterIndex);
+						UE_LOG(LogLinker, Verbose, TEXT("CreateImport: Failed to load Outer for resource '%s': %s"), *Import.ObjectName.ToString(), *OuterName);
+						return NULL;
+					}
+
+					// Find object now that we know it's class, outer and name.
+					FindObject = FLinkerImportCache::Get().FindImport(FindClass, FindOuter, Import.ObjectName);
+					if (UDynamicClass* FoundDynamicClass = Cast<UDynamicClass>(FindObject))
+					{
+						if(0 == (FoundDynamicClass->ClassFlags & CLASS_Constructed))
 						{
-							if(0 == (FoundDynamicClass->ClassFlags & CLASS_Constructed))
-							{
-								// This class wasn't fully constructed yet. It will be properly constructed in CreateExport. 
-								FindObject = nullptr;
-							}
+							// This class wasn't fully constructed yet. It will be properly constructed in CreateExport. 
+							FindObject = nullptr;
 						}
 					}
+				}
 
-					if( FindObject )
-					{		
-						// Associate import and indicate that we associated an import for later cleanup.
-						Import.XObject = FindObject;
-						check(CurrentLoadContext);
-						CurrentLoadContext->IncrementImportCount();
-						FLinkerManager::Get().AddLoaderWithNewImports(this);
-					}
+				if( FindObject )
+				{		
+					// Associate import and indicate that we associated an import for later cleanup.
+					Import.XObject = FindObject;
+					check(CurrentLoadContext);
+					CurrentLoadContext->IncrementImportCount();
+					FLinkerManager::Get().AddLoaderWithNewImports(this);
 				}
 			}
 		}
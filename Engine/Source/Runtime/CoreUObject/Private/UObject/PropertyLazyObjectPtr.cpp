@@ -5,6 +5,7 @@
 #include "UObject/LazyObjectPtr.h"
 #include "UObject/UnrealType.h"
 #include "UObject/PropertyHelper.h"
+#include "UObject/GarbageCollection.h"
 
 /*-----------------------------------------------------------------------------
 	ULazyObjectProperty.
@@ -88,7 +89,10 @@ bool ULazyObjectProperty::Identical( const void* A, const void* B, uint32 PortFl
 
 UObject* ULazyObjectProperty::GetObjectPropertyValue(const void* PropertyValueAddress) const
 {
-	return GetPropertyValue(PropertyValueAddress).Get();
+	UObject* Value = GetPropertyValue(PropertyValueAddress).Get();
+	// Reflected code may store the resolved object as a strong reference the garbage collector would not see otherwise
+	GCWriteBarrier(Value);
+	return Value;
 }
 
 void ULazyObjectProperty::SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value) const
@@ -4,6 +4,7 @@
 #include "UObject/ObjectMacros.h"
 #include "UObject/SoftObjectPtr.h"
 #include "UObject/UnrealType.h"
+#include "UObject/GarbageCollection.h"
 #include "Blueprint/BlueprintSupport.h"
 #include "UObject/LinkerPlaceholderBase.h"
 #include "UObject/LinkerPlaceholderExportObject.h"
@@ -178,6 +179,7 @@ UObject* UObjectProperty::GetObjectPropertyValue(const void* PropertyValueAddres
 
 void UObjectProperty::SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value) const
 {
+	GCWriteBarrier(Value);
 	SetPropertyValue(PropertyValueAddress, Value);
 }
 
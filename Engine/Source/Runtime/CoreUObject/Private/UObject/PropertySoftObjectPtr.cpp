@@ -6,6 +6,7 @@
 #include "UObject/PropertyPortFlags.h"
 #include "UObject/UnrealType.h"
 #include "UObject/LinkerLoad.h"
+#include "UObject/GarbageCollection.h"
 
 /*-----------------------------------------------------------------------------
 	USoftObjectProperty.
@@ -185,7 +186,10 @@ UObject* USoftObjectProperty::LoadObjectPropertyValue(const void* PropertyValueA
 
 UObject* USoftObjectProperty::GetObjectPropertyValue(const void* PropertyValueAddress) const
 {
-	return GetPropertyValue(PropertyValueAddress).Get();
+	UObject* Value = GetPropertyValue(PropertyValueAddress).Get();
+	// Reflected code may store the resolved object as a strong reference the garbage collector would not see otherwise
+	GCWriteBarrier(Value);
+	return Value;
 }
 
 void USoftObjectProperty::SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value) const
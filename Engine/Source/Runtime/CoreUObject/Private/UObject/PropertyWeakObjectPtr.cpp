@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "UObject/ObjectMacros.h"
 #include "UObject/UnrealType.h"
+#include "UObject/GarbageCollection.h"
 
 /*-----------------------------------------------------------------------------
 	UWeakObjectProperty.
@@ -47,7 +48,10 @@ void UWeakObjectProperty::SerializeItem( FStructuredArchive::FSlot Slot, void* V
 
 UObject* UWeakObjectProperty::GetObjectPropertyValue(const void* PropertyValueAddress) const
 {
-	return GetPropertyValue(PropertyValueAddress).Get();
+	UObject* Value = GetPropertyValue(PropertyValueAddress).Get();
+	// Reflected code may store the resolved object as a strong reference the garbage collector would not see otherwise
+	GCWriteBarrier(Value);
+	return Value;
 }
 
 void UWeakObjectProperty::SetObjectPropertyValue(void* PropertyValueAddress, UObject* Value) const
@@ -14,6 +14,10 @@ DEFINE_LOG_CATEGORY_STATIC(LogUObjectArray, Log, All);
 
 FUObjectClusterContainer GUObjectClusters;
 
+uint16* GUObjectGCStates = nullptr;
+
+static_assert((int32(EInternalObjectFlags::AllFlags) & ~(int32(EUObjectGCState::FlagsMask) << EUObjectGCState::FlagsShift)) == 0, "All internal object flags must fit in EUObjectGCState::FlagsMask.");
+
 FUObjectArray::FUObjectArray()
 : ObjFirstGCIndex(0)
 , ObjLastNonGCIndex(INDEX_NONE)
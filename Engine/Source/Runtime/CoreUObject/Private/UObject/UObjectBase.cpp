@@ -280,11 +280,13 @@ void UObjectBase::LowLevelRename(FName NewName,UObject *NewOuter)
 	STAT(StatID = TStatId();) // reset the stat id since this thing now has a different name
 	UnhashObject(this);
 	check(InternalIndex >= 0);
+	BeginObjectRename();
 	NamePrivate = NewName;
 	if (NewOuter)
 	{
 		OuterPrivate = NewOuter;
 	}
+	EndObjectRename();
 	HashObject(this);
 }
 
@@ -817,6 +817,7 @@ UObject* StaticLoadObjectInternal(UClass* ObjectClass, UObject* InOuter, const T
 	SCOPE_CYCLE_COUNTER(STAT_LoadObject);
 	check(ObjectClass);
 	check(InName);
+	checkf(!FUObjectThreadContext::Get().IsSerializingOnLoaderWorker, TEXT("Unable to load %s while serializing an export on a loader worker. Classes that load objects from Serialize must return false from IsSerializeThreadSafe."), InName);
 
 	FScopedLoadingState ScopedLoadingState(InName);
 	FString StrName = InName;
@@ -2266,6 +2267,7 @@ UObject* StaticAllocateObject
 
 	SCOPE_CYCLE_COUNTER(STAT_AllocateObject);
 	checkSlow(InOuter != INVALID_OBJECT); // not legal
+	checkf(!FUObjectThreadContext::Get().IsSerializingOnLoaderWorker, TEXT("Unable to create %s while serializing an export on a loader worker. Classes that create objects from Serialize must return false from IsSerializeThreadSafe."), *InName.ToString());
 	check(!InClass || (InClass->ClassWithin && InClass->ClassConstructor));
 #if WITH_EDITOR
 	if (GIsEditor)
@@ -10,6 +10,8 @@
 #include "Misc/AsciiSet.h"
 #include "Misc/PackageName.h"
 #include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/Optional.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogUObjectHash, Log, All);
 
@@ -273,84 +275,523 @@ struct FHashBucketIterator
 	}
 };
 
+/**
+ * Frees memory that lock free readers of the hash tables may still be looking at, see FHashTableReadScope.
+ *
+ * Readers register with the current epoch for the duration of a lookup. Writers, which are serialized by the hash tables lock,
+ * retire unlinked memory into the current epoch and advance the epoch once nobody is reading in the previous one anymore, so
+ * anything retired in an epoch is freed when the epoch after next begins.
+ */
+class FHashTableReadEpochs
+{
+	enum { NumSlots = 3 };
+
+	struct FReaderCount
+	{
+		TAtomic<int32> Num;
+		uint8 PadToAvoidContention[PLATFORM_CACHE_LINE_SIZE - sizeof(TAtomic<int32>)];
+	};
+
+	TAtomic<uint32> Epoch;
+	FReaderCount NumReaders[NumSlots];
+	/** Memory retired in each epoch slot, only accessed by writers */
+	TArray<void*> Retired[NumSlots];
+
+	static void FreeRetired(TArray<void*>& Memory)
+	{
+		for (void* Block : Memory)
+		{
+			FMemory::Free(Block);
+		}
+		Memory.Reset();
+	}
+
+public:
+
+	FHashTableReadEpochs()
+		: Epoch(0)
+	{
+		for (FReaderCount& Count : NumReaders)
+		{
+			Count.Num = 0;
+		}
+	}
+
+	~FHashTableReadEpochs()
+	{
+		for (TArray<void*>& Memory : Retired)
+		{
+			FreeRetired(Memory);
+		}
+	}
+
+	/** Registers a reader with the current epoch, never blocks. Returns the slot to pass to ExitRead. */
+	FORCEINLINE int32 EnterRead()
+	{
+		while (true)
+		{
+			const uint32 CurrentEpoch = Epoch.Load();
+			const int32 Slot = CurrentEpoch % NumSlots;
+			++NumReaders[Slot].Num;
+			// If the epoch advanced in the meantime memory retired before we registered may already be gone
+			if (Epoch.Load() == CurrentEpoch)
+			{
+				return Slot;
+			}
+			--NumReaders[Slot].Num;
+		}
+	}
+
+	FORCEINLINE void ExitRead(int32 Slot)
+	{
+		--NumReaders[Slot].Num;
+	}
+
+	/** Frees memory allocated with FMemory::Malloc once no reader can see it anymore. Writers only. */
+	void Retire(void* Memory)
+	{
+		Retired[Epoch.Load(EMemoryOrder::Relaxed) % NumSlots].Add(Memory);
+	}
+
+	/** Advances the epoch and frees what is no longer visible if nobody is reading in the previous epoch. Writers only. */
+	bool TryAdvance()
+	{
+		const uint32 CurrentEpoch = Epoch.Load();
+		const int32 PreviousSlot = (CurrentEpoch + NumSlots - 1) % NumSlots;
+		if (NumReaders[PreviousSlot].Num.Load() != 0)
+		{
+			return false;
+		}
+		Epoch.Store(CurrentEpoch + 1);
+		// Readers of the epoch before the previous one were gone when we advanced to the current epoch
+		FreeRetired(Retired[PreviousSlot]);
+		return true;
+	}
+
+	/** Waits until all readers that may have seen anything retired or unlinked so far are done. Writers only. */
+	void Synchronize()
+	{
+		const uint32 TargetEpoch = Epoch.Load() + 2;
+		while (Epoch.Load() != TargetEpoch)
+		{
+			if (!TryAdvance())
+			{
+				FPlatformProcess::Yield();
+			}
+		}
+	}
+
+	/** Waits until there are no readers, callers need to make sure new ones don't start reading. */
+	void WaitForReaders() const
+	{
+		while (NumReaders[0].Num.Load() + NumReaders[1].Num.Load() + NumReaders[2].Num.Load() != 0)
+		{
+			FPlatformProcess::Yield();
+		}
+	}
+};
+
+/**
+ * Multimap from keys to objects that can be read while it's being modified.
+ *
+ * Keys live in an open addressing table and the objects of each key in a list whose forward links readers follow. Writers
+ * must hold the hash tables lock and never modify anything a reader may be looking at in place: removed list nodes keep
+ * pointing at their successor, removed keys are replaced by a marker and tables are replaced when they grow, and all of
+ * it is freed through FHashTableReadEpochs. Readers must be in a FHashTableReadScope.
+ * An object can only be added once, which lets writers find its node in constant time.
+ */
+template<typename KeyType>
+class TObjectHashMultiMap
+{
+public:
+
+	struct FKeyNode;
+
+	struct FValueNode
+	{
+		UObjectBase* Object;
+		TAtomic<FValueNode*> Next;
+		/** Only used by writers */
+		FValueNode* Prev;
+		FKeyNode* KeyNode;
+	};
+
+	struct FKeyNode
+	{
+		KeyType Key;
+		TAtomic<FValueNode*> Values;
+		/** Only used by writers */
+		int32 NumValues;
+	};
+
+private:
+
+	struct FKeyTable
+	{
+		uint32 NumSlots;
+
+		TAtomic<FKeyNode*>* GetSlots()
+		{
+			return reinterpret_cast<TAtomic<FKeyNode*>*>(this + 1);
+		}
+		const TAtomic<FKeyNode*>* GetSlots() const
+		{
+			return reinterpret_cast<const TAtomic<FKeyNode*>*>(this + 1);
+		}
+	};
+
+	enum { MinNumSlots = 64 };
+
+	/** Marks slots of removed keys, probing continues past them */
+	static FKeyNode RemovedKey;
+
+	FHashTableReadEpochs& Epochs;
+	TAtomic<FKeyTable*> Table;
+	/** Node of each object in the map, indexed by object index */
+	TArray<FValueNode*> ObjectNodes;
+	int32 NumKeys;
+	int32 NumRemovedKeys;
+	int32 NumValues;
+
+	static FKeyTable* AllocateTable(uint32 NumSlots)
+	{
+		const SIZE_T Size = sizeof(FKeyTable) + NumSlots * sizeof(TAtomic<FKeyNode*>);
+		FKeyTable* NewTable = (FKeyTable*)FMemory::Malloc(Size);
+		FMemory::Memzero(NewTable, Size);
+		NewTable->NumSlots = NumSlots;
+		return NewTable;
+	}
+
+	/** Replaces the key table with one that has no removed key markers and room for at least MinNumKeys keys */
+	void Rehash(int32 MinNumKeys)
+	{
+		FKeyTable* OldTable = Table.Load(EMemoryOrder::Relaxed);
+		FKeyTable* NewTable = AllocateTable(FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(MinNumKeys * 4, MinNumSlots)));
+		if (OldTable)
+		{
+			const uint32 Mask = NewTable->NumSlots - 1;
+			for (uint32 OldSlotIndex = 0; OldSlotIndex < OldTable->NumSlots; ++OldSlotIndex)
+			{
+				FKeyNode* KeyNode = OldTable->GetSlots()[OldSlotIndex].Load(EMemoryOrder::Relaxed);
+				if (KeyNode && KeyNode != &RemovedKey)
+				{
+					uint32 SlotIndex = GetTypeHash(KeyNode->Key) & Mask;
+					while (NewTable->GetSlots()[SlotIndex].Load(EMemoryOrder::Relaxed))
+					{
+						SlotIndex = (SlotIndex + 1) & Mask;
+					}
+					NewTable->GetSlots()[SlotIndex].Store(KeyNode, EMemoryOrder::Relaxed);
+				}
+			}
+			Epochs.Retire(OldTable);
+		}
+		// Publishes the filled in table
+		Table.Store(NewTable);
+		NumRemovedKeys = 0;
+	}
+
+	FKeyNode* FindOrAddKey(const KeyType& Key)
+	{
+		FKeyTable* KeyTable = Table.Load(EMemoryOrder::Relaxed);
+		if (!KeyTable || (uint32)(NumKeys + NumRemovedKeys + 1) * 2 > KeyTable->NumSlots)
+		{
+			Rehash(NumKeys + 1);
+			KeyTable = Table.Load(EMemoryOrder::Relaxed);
+		}
+
+		const uint32 Mask = KeyTable->NumSlots - 1;
+		TAtomic<FKeyNode*>* FreeSlot = nullptr;
+		for (uint32 SlotIndex = GetTypeHash(Key) & Mask; ; SlotIndex = (SlotIndex + 1) & Mask)
+		{
+			TAtomic<FKeyNode*>& Slot = KeyTable->GetSlots()[SlotIndex];
+			FKeyNode* KeyNode = Slot.Load(EMemoryOrder::Relaxed);
+			if (!KeyNode)
+			{
+				if (!FreeSlot)
+				{
+					FreeSlot = &Slot;
+				}
+				else
+				{
+					--NumRemovedKeys;
+				}
+				break;
+			}
+			else if (KeyNode == &RemovedKey)
+			{
+				FreeSlot = FreeSlot ? FreeSlot : &Slot;
+			}
+			else if (KeyNode->Key == Key)
+			{
+				return KeyNode;
+			}
+		}
+
+		FKeyNode* KeyNode = new (FMemory::Malloc(sizeof(FKeyNode))) FKeyNode();
+		KeyNode->Key = Key;
+		KeyNode->Values.Store(nullptr, EMemoryOrder::Relaxed);
+		KeyNode->NumValues = 0;
+		// Publishes the key
+		FreeSlot->Store(KeyNode);
+		++NumKeys;
+		return KeyNode;
+	}
+
+	void RemoveKey(FKeyNode* KeyNode)
+	{
+		FKeyTable* KeyTable = Table.Load(EMemoryOrder::Relaxed);
+		const uint32 Mask = KeyTable->NumSlots - 1;
+		uint32 SlotIndex = GetTypeHash(KeyNode->Key) & Mask;
+		while (KeyTable->GetSlots()[SlotIndex].Load(EMemoryOrder::Relaxed) != KeyNode)
+		{
+			SlotIndex = (SlotIndex + 1) & Mask;
+		}
+		KeyTable->GetSlots()[SlotIndex].Store(&RemovedKey);
+		Epochs.Retire(KeyNode);
+		--NumKeys;
+		++NumRemovedKeys;
+	}
+
+	FValueNode* FindNode(const KeyType& Key, const UObjectBase* Object) const
+	{
+		const int32 ObjectIndex = GUObjectArray.ObjectToIndex(Object);
+		FValueNode* Node = ObjectNodes.IsValidIndex(ObjectIndex) ? ObjectNodes[ObjectIndex] : nullptr;
+		return Node && Node->Object == Object && Node->KeyNode->Key == Key ? Node : nullptr;
+	}
+
+public:
+
+	explicit TObjectHashMultiMap(FHashTableReadEpochs& InEpochs)
+		: Epochs(InEpochs)
+		, Table(nullptr)
+		, NumKeys(0)
+		, NumRemovedKeys(0)
+		, NumValues(0)
+	{
+	}
+
+	~TObjectHashMultiMap()
+	{
+		// Only destroyed on exit when nobody's reading anymore
+		ForEachKey([](const FKeyNode& KeyNode)
+		{
+			for (FValueNode* Node = KeyNode.Values.Load(EMemoryOrder::Relaxed); Node; )
+			{
+				FValueNode* Next = Node->Next.Load(EMemoryOrder::Relaxed);
+				FMemory::Free(Node);
+				Node = Next;
+			}
+			FMemory::Free(const_cast<FKeyNode*>(&KeyNode));
+		});
+		FMemory::Free(Table.Load(EMemoryOrder::Relaxed));
+	}
+
+	/** Returns the first object of a key, follow FValueNode::Next for the others. Readers and writers. */
+	FORCEINLINE const FValueNode* FindFirst(const KeyType& Key) const
+	{
+		const FKeyTable* KeyTable = Table.Load();
+		if (KeyTable)
+		{
+			const uint32 Mask = KeyTable->NumSlots - 1;
+			for (uint32 SlotIndex = GetTypeHash(Key) & Mask; ; SlotIndex = (SlotIndex + 1) & Mask)
+			{
+				const FKeyNode* KeyNode = KeyTable->GetSlots()[SlotIndex].Load();
+				if (!KeyNode)
+				{
+					break;
+				}
+				else if (KeyNode != &RemovedKey && KeyNode->Key == Key)
+				{
+					return KeyNode->Values.Load();
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	/** Writers only */
+	bool Contains(const KeyType& Key, const UObjectBase* Object) const
+	{
+		return !!FindNode(Key, Object);
+	}
+
+	/** Adds an object that isn't in the map yet. Writers only. */
+	void Add(const KeyType& Key, UObjectBase* Object)
+	{
+		const int32 ObjectIndex = GUObjectArray.ObjectToIndex(Object);
+		if (ObjectIndex >= ObjectNodes.Num())
+		{
+			ObjectNodes.AddZeroed(ObjectIndex + 1 - ObjectNodes.Num());
+		}
+		checkSlow(!ObjectNodes[ObjectIndex]);
+
+		FKeyNode* KeyNode = FindOrAddKey(Key);
+		FValueNode* First = KeyNode->Values.Load(EMemoryOrder::Relaxed);
+		FValueNode* Node = new (FMemory::Malloc(sizeof(FValueNode))) FValueNode();
+		Node->Object = Object;
+		Node->Next.Store(First, EMemoryOrder::Relaxed);
+		Node->Prev = nullptr;
+		Node->KeyNode = KeyNode;
+		if (First)
+		{
+			First->Prev = Node;
+		}
+		// Publishes the filled in node
+		KeyNode->Values.Store(Node);
+		KeyNode->NumValues++;
+
+		ObjectNodes[ObjectIndex] = Node;
+		++NumValues;
+	}
+
+	/** Removes an object, returns the number of objects removed. Writers only. */
+	int32 Remove(const KeyType& Key, UObjectBase* Object)
+	{
+		FValueNode* Node = FindNode(Key, Object);
+		if (!Node)
+		{
+			return 0;
+		}
+
+		// Readers looking at the node can still get to the rest of the list through it
+		FKeyNode* KeyNode = Node->KeyNode;
+		FValueNode* Next = Node->Next.Load(EMemoryOrder::Relaxed);
+		if (Node->Prev)
+		{
+			Node->Prev->Next.Store(Next);
+		}
+		else
+		{
+			KeyNode->Values.Store(Next);
+		}
+		if (Next)
+		{
+			Next->Prev = Node->Prev;
+		}
+		ObjectNodes[GUObjectArray.ObjectToIndex(Object)] = nullptr;
+		Epochs.Retire(Node);
+		--NumValues;
+
+		if (--KeyNode->NumValues == 0)
+		{
+			RemoveKey(KeyNode);
+		}
+		return 1;
+	}
+
+	/** Calls Visitor with each key. Writers only. */
+	template<typename VisitorType>
+	void ForEachKey(VisitorType Visitor) const
+	{
+		if (const FKeyTable* KeyTable = Table.Load(EMemoryOrder::Relaxed))
+		{
+			for (uint32 SlotIndex = 0; SlotIndex < KeyTable->NumSlots; ++SlotIndex)
+			{
+				const FKeyNode* KeyNode = KeyTable->GetSlots()[SlotIndex].Load(EMemoryOrder::Relaxed);
+				if (KeyNode && KeyNode != &RemovedKey)
+				{
+					Visitor(*KeyNode);
+				}
+			}
+		}
+	}
+
+	/** Number of distinct keys. Writers only. */
+	int32 NumKeysInUse() const
+	{
+		return NumKeys;
+	}
+
+	/** Releases slack. Writers only. */
+	void Shrink()
+	{
+		FKeyTable* KeyTable = Table.Load(EMemoryOrder::Relaxed);
+		if (KeyTable && KeyTable->NumSlots > FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(NumKeys * 4, MinNumSlots)))
+		{
+			Rehash(NumKeys);
+		}
+		int32 NewNum = ObjectNodes.Num();
+		while (NewNum > 0 && !ObjectNodes[NewNum - 1])
+		{
+			--NewNum;
+		}
+		ObjectNodes.SetNum(NewNum, /* bAllowShrinking = */ true);
+	}
+
+	/** Writers only */
+	SIZE_T GetAllocatedSize() const
+	{
+		const FKeyTable* KeyTable = Table.Load(EMemoryOrder::Relaxed);
+		return (KeyTable ? sizeof(FKeyTable) + KeyTable->NumSlots * sizeof(TAtomic<FKeyNode*>) : 0)
+			+ NumKeys * sizeof(FKeyNode)
+			+ NumValues * sizeof(FValueNode)
+			+ ObjectNodes.GetAllocatedSize();
+	}
+};
+
+template<typename KeyType>
+typename TObjectHashMultiMap<KeyType>::FKeyNode TObjectHashMultiMap<KeyType>::RemovedKey;
+
 class FUObjectHashTables
 {
 	/** Critical section that guards against concurrent adds from multiple threads */
 	FCriticalSection CriticalSection;
 
+	/** Number of LockUObjectHashTables calls in progress, lock free readers fall back to the lock while it's non zero */
+	TAtomic<int32> NumExclusiveLocks;
+
 public:
 
-	/** Hash sets */
-	TMap<int32, FHashBucket> Hash;
-	TMultiMap<int32, class UObjectBase*> HashOuter;
+	FHashTableReadEpochs ReadEpochs;
+
+	/** Hash sets, these can be read without the lock */
+	TObjectHashMultiMap<int32> Hash;
+	TObjectHashMultiMap<int32> HashOuter;
 
 	/** Map of object to their outers, used to avoid an object iterator to find such things. **/
 	TMap<UObjectBase*, FHashBucket> ObjectOuterMap;
-	TMap<UClass*, FHashBucket > ClassToObjectListMap;
-	TMap<UClass*, TSet<UClass*> > ClassToChildListMap;
+	/** Maps from classes to their instances and child classes, these can be read without the lock */
+	TObjectHashMultiMap<const UClass*> ClassToObjectListMap;
+	TObjectHashMultiMap<const UClass*> ClassToChildListMap;
 
 	FUObjectHashTables()
+		: NumExclusiveLocks(0)
+		, Hash(ReadEpochs)
+		, HashOuter(ReadEpochs)
+		, ClassToObjectListMap(ReadEpochs)
+		, ClassToChildListMap(ReadEpochs)
 	{
 	}
 
 	void ShrinkMaps()
 	{
 		double StartTime = FPlatformTime::Seconds();
-		Hash.Compact();
-		for (auto& Pair : Hash)
-		{
-			Pair.Value.Compact();
-		}
-		HashOuter.Compact();
+		Hash.Shrink();
+		HashOuter.Shrink();
 		ObjectOuterMap.Compact();
 		for (auto& Pair : ObjectOuterMap)
 		{
 			Pair.Value.Compact();
 		}
-		ClassToObjectListMap.Compact();
-		for (auto& Pair : ClassToObjectListMap)
-		{
-			Pair.Value.Compact();
-		}
-		ClassToChildListMap.Compact();
-		for (auto& Pair : ClassToChildListMap)
-		{
-			Pair.Value.Compact();
-		}
+		ClassToObjectListMap.Shrink();
+		ClassToChildListMap.Shrink();
 		UE_LOG(LogUObjectHash, Log, TEXT("Compacting FUObjectHashTables data took %6.2fms"), 1000.0f * float(FPlatformTime::Seconds() - StartTime));
 	}
 
 	/** Checks if the Hash/Object pair exists in the FName hash table */
 	FORCEINLINE bool PairExistsInHash(int32 InHash, UObjectBase* Object)
 	{
-		bool bResult = false;
-		FHashBucket* Bucket = Hash.Find(InHash);
-		if (Bucket)
-		{
-			bResult = Bucket->Contains(Object);
-		}
-		return bResult;
+		return Hash.Contains(InHash, Object);
 	}
 	/** Adds the Hash/Object pair to the FName hash table */
 	FORCEINLINE void AddToHash(int32 InHash, UObjectBase* Object)
 	{
-		FHashBucket& Bucket = Hash.FindOrAdd(InHash);
-		Bucket.Add(Object);
+		Hash.Add(InHash, Object);
 	}
 	/** Removes the Hash/Object pair from the FName hash table */
 	FORCEINLINE int32 RemoveFromHash(int32 InHash, UObjectBase* Object)
 	{
-		int32 NumRemoved = 0;
-		FHashBucket* Bucket = Hash.Find(InHash);
-		if (Bucket)
-		{
-			NumRemoved = Bucket->Remove(Object);
-			if (Bucket->Num() == 0)
-			{
-				Hash.Remove(InHash);
-			}
-		}
-		return NumRemoved;
+		return Hash.Remove(InHash, Object);
 	}
 
 	FORCEINLINE void Lock()
@@ -363,6 +804,28 @@ public:
 		CriticalSection.Unlock();
 	}
 
+	/** Locks the hash tables for readers too, waiting for lock free readers that are already looking */
+	void LockExclusive()
+	{
+		Lock();
+		if (NumExclusiveLocks++ == 0)
+		{
+			ReadEpochs.WaitForReaders();
+		}
+	}
+
+	void UnlockExclusive()
+	{
+		--NumExclusiveLocks;
+		Unlock();
+	}
+
+	/** True if readers need to take the lock */
+	FORCEINLINE bool IsLockedExclusive() const
+	{
+		return NumExclusiveLocks.Load() > 0;
+	}
+
 	static FUObjectHashTables& Get()
 	{
 		static FUObjectHashTables Singleton;
@@ -403,6 +866,90 @@ public:
 	}
 };
 
+static int32 GLockFreeUObjectHashReads = 1;
+static FAutoConsoleVariableRef CVarLockFreeUObjectHashReads(
+	TEXT("s.LockFreeUObjectHashReads"),
+	GLockFreeUObjectHashReads,
+	TEXT("If true, finding objects by name and iterating objects of a class don't take the UObject hash tables lock so they never wait for other threads adding or removing objects."),
+	ECVF_Default
+	);
+
+/**
+ * Scope for reading the lock free parts of the hash tables (Hash, HashOuter, ClassToObjectListMap and ClassToChildListMap).
+ * Doesn't block unless the tables are locked with LockUObjectHashTables, in which case it takes the lock like FHashTableLock.
+ * Nothing that may lock the hash tables can be called from within the scope.
+ */
+class FHashTableReadScope
+{
+	FUObjectHashTables& Tables;
+	int32 EpochSlot;
+	TOptional<FHashTableLock> Lock;
+
+public:
+	FORCEINLINE explicit FHashTableReadScope(FUObjectHashTables& InTables)
+		: Tables(InTables)
+		, EpochSlot(INDEX_NONE)
+	{
+		if (GLockFreeUObjectHashReads)
+		{
+			EpochSlot = Tables.ReadEpochs.EnterRead();
+			if (!Tables.IsLockedExclusive())
+			{
+				return;
+			}
+			Tables.ReadEpochs.ExitRead(EpochSlot);
+			EpochSlot = INDEX_NONE;
+		}
+		Lock.Emplace(Tables);
+	}
+	FORCEINLINE ~FHashTableReadScope()
+	{
+		if (EpochSlot != INDEX_NONE)
+		{
+			Tables.ReadEpochs.ExitRead(EpochSlot);
+		}
+	}
+};
+
+/** Number of LowLevelRename calls currently writing an object's name and outer, see ReadObjectNameForLookup */
+static volatile int32 GNumObjectRenamesInProgress = 0;
+/** Incremented by each LowLevelRename once it's done writing */
+static volatile int32 GObjectRenameSequence = 0;
+
+void BeginObjectRename()
+{
+	FPlatformAtomics::InterlockedIncrement(&GNumObjectRenamesInProgress);
+}
+
+void EndObjectRename()
+{
+	FPlatformAtomics::InterlockedIncrement(&GObjectRenameSequence);
+	FPlatformAtomics::InterlockedDecrement(&GNumObjectRenamesInProgress);
+}
+
+/**
+ * Returns the object's name for comparing it during a lock free lookup. An object found in the hash tables may be
+ * renamed while it's being looked at, so the name is read again until no rename overlapped reading it. FName is
+ * wider than what can be read atomically, so a plain read could mix the old and new names.
+ */
+static FORCEINLINE FName ReadObjectNameForLookup(const UObjectBase* Object)
+{
+	while (true)
+	{
+		const int32 Sequence = FPlatformAtomics::AtomicRead(&GObjectRenameSequence);
+		if (FPlatformAtomics::AtomicRead(&GNumObjectRenamesInProgress) == 0)
+		{
+			const FName Name = Object->GetFName();
+			FPlatformMisc::MemoryBarrier();
+			if (FPlatformAtomics::AtomicRead(&GNumObjectRenamesInProgress) == 0 && FPlatformAtomics::AtomicRead(&GObjectRenameSequence) == Sequence)
+			{
+				return Name;
+			}
+		}
+		FPlatformProcess::Yield();
+	}
+}
+
 /**
  * Calculates the object's hash just using the object's name index
  *
@@ -433,15 +980,13 @@ UObject* StaticFindObjectFastExplicitThreadSafe(FUObjectHashTables& ThreadHash,
 
 	// Find an object with the specified name and (optional) class, in any package; if bAnyPackage is false, only matches top-level packages
 	int32 Hash = GetObjectHash(ObjectName);
-	FHashTableLock HashLock(ThreadHash);
-	FHashBucket* Bucket = ThreadHash.Hash.Find(Hash);
-	if (Bucket)
+	FHashTableReadScope ReadScope(ThreadHash);
 	{
-		for (FHashBucketIterator It(*Bucket); It; ++It)
+		for (auto* Node = ThreadHash.Hash.FindFirst(Hash); Node; Node = Node->Next.Load())
 		{
-			UObject* Object = (UObject*)*It;
+			UObject* Object = (UObject*)Node->Object;
 			if
-				((Object->GetFName() == ObjectName)
+				((ReadObjectNameForLookup(Object) == ObjectName)
 
 				/* Don't return objects that have any of the exclusive flags set */
 				&& !Object->HasAnyFlags(ExcludeFlags)
@@ -534,13 +1079,13 @@ UObject* StaticFindObjectFastInternalThreadSafe(FUObjectHashTables& ThreadHash,
 	if (ObjectPackage != nullptr)
 	{
 		int32 Hash = GetObjectOuterHash(ObjectName, (PTRINT)ObjectPackage);
-		FHashTableLock HashLock(ThreadHash);
-		for (TMultiMap<int32, class UObjectBase*>::TConstKeyIterator HashIt(ThreadHash.HashOuter, Hash); HashIt; ++HashIt)
+		FHashTableReadScope ReadScope(ThreadHash);
+		for (auto* Node = ThreadHash.HashOuter.FindFirst(Hash); Node; Node = Node->Next.Load())
 		{
-			UObject *Object = (UObject *)HashIt.Value();
+			UObject *Object = (UObject *)Node->Object;
 			if
 				/* check that the name matches the name we're searching for */
-				((Object->GetFName() == ObjectName)
+				((ReadObjectNameForLookup(Object) == ObjectName)
 
 				/* Don't return objects that have any of the exclusive flags set */
 				&& !Object->HasAnyFlags(ExcludeFlags)
@@ -576,16 +1121,14 @@ UObject* StaticFindObjectFastInternalThreadSafe(FUObjectHashTables& ThreadHash,
 		FName ActualObjectName = ExtractInnerAndOuterFromPath(ObjectName, /* out*/ VerifyOuterName);
 
 		const int32 Hash = GetObjectHash(ActualObjectName);
-		FHashTableLock HashLock(ThreadHash);
+		FHashTableReadScope ReadScope(ThreadHash);
 
-		FHashBucket* Bucket = ThreadHash.Hash.Find(Hash);
-		if (Bucket)
 		{
-			for (FHashBucketIterator It(*Bucket); It; ++It)
+			for (auto* Node = ThreadHash.Hash.FindFirst(Hash); Node; Node = Node->Next.Load())
 			{
-				UObject* Object = (UObject*)*It;
+				UObject* Object = (UObject*)Node->Object;
 				if
-					((Object->GetFName() == ActualObjectName)
+					((ReadObjectNameForLookup(Object) == ActualObjectName)
 
 					/* Don't return objects that have any of the exclusive flags set */
 					&& !Object->HasAnyFlags(ExcludeFlags)
@@ -602,7 +1145,7 @@ UObject* StaticFindObjectFastInternalThreadSafe(FUObjectHashTables& ThreadHash,
 					&& !Object->HasAnyInternalFlags(ExclusiveInternalFlags)
 
 					/** Ensure that the partial path provided matches the object found */
-					&& (VerifyOuterName.IsNone() || (Object->GetOuter() && Object->GetOuter()->GetFName() == VerifyOuterName)))
+					&& (VerifyOuterName.IsNone() || (Object->GetOuter() && ReadObjectNameForLookup(Object->GetOuter()) == VerifyOuterName)))
 				{
 					checkf(!Object->IsUnreachable(), TEXT("%s"), *Object->GetFullName());
 					if (Result)
@@ -648,8 +1191,7 @@ FORCEINLINE static void AddToClassMap(FUObjectHashTables& ThreadHash, UObjectBas
 {
 	{
 		check(Object->GetClass());
-		FHashBucket& ObjectList = ThreadHash.ClassToObjectListMap.FindOrAdd(Object->GetClass());
-		ObjectList.Add(Object);
+		ThreadHash.ClassToObjectListMap.Add(Object->GetClass(), Object);
 	}
 
 	UObjectBaseUtility* ObjectWithUtility = static_cast<UObjectBaseUtility*>(Object);
@@ -659,10 +1201,8 @@ FORCEINLINE static void AddToClassMap(FUObjectHashTables& ThreadHash, UObjectBas
 		UClass* SuperClass = Class->GetSuperClass();
 		if ( SuperClass )
 		{
-			TSet<UClass*>& ChildList = ThreadHash.ClassToChildListMap.FindOrAdd(SuperClass);
-			bool bIsAlreadyInSetPtr = false;
-			ChildList.Add(Class, &bIsAlreadyInSetPtr);
-			check(!bIsAlreadyInSetPtr); // if it already exists, something is wrong with the external code
+			check(!ThreadHash.ClassToChildListMap.Contains(SuperClass, Class)); // if it already exists, something is wrong with the external code
+			ThreadHash.ClassToChildListMap.Add(SuperClass, Class);
 		}
 	}
 }
@@ -688,17 +1228,12 @@ FORCEINLINE static void RemoveFromClassMap(FUObjectHashTables& ThreadHash, UObje
 	UObjectBaseUtility* ObjectWithUtility = static_cast<UObjectBaseUtility*>(Object);
 
 	{
-		FHashBucket& ObjectList = ThreadHash.ClassToObjectListMap.FindOrAdd(Object->GetClass());
-		int32 NumRemoved = ObjectList.Remove(Object);
+		int32 NumRemoved = ThreadHash.ClassToObjectListMap.Remove(Object->GetClass(), Object);
 		if (NumRemoved != 1)
 		{
 			UE_LOG(LogUObjectHash, Error, TEXT("Internal Error: RemoveFromClassMap NumRemoved = %d from object list for %s"), NumRemoved, *GetFullNameSafe(ObjectWithUtility));
 		}
 		check(NumRemoved == 1); // must have existed, else something is wrong with the external code
-		if (!ObjectList.Num())
-		{
-			ThreadHash.ClassToObjectListMap.Remove(Object->GetClass());
-		}
 	}
 
 	if ( ObjectWithUtility->IsA(UClass::StaticClass()) )
@@ -708,17 +1243,12 @@ FORCEINLINE static void RemoveFromClassMap(FUObjectHashTables& ThreadHash, UObje
 		if ( SuperClass )
 		{
 			// Remove the class from the SuperClass' child list
-			TSet<UClass*>& ChildList = ThreadHash.ClassToChildListMap.FindOrAdd(SuperClass);
-			int32 NumRemoved = ChildList.Remove(Class);
+			int32 NumRemoved = ThreadHash.ClassToChildListMap.Remove(SuperClass, Class);
 			if (NumRemoved != 1)
 			{
 				UE_LOG(LogUObjectHash, Error, TEXT("Internal Error: RemoveFromClassMap NumRemoved = %d from child list for %s"), NumRemoved, *GetFullNameSafe(ObjectWithUtility));
 			}
 			check(NumRemoved == 1); // must have existed, else something is wrong with the external code
-			if (!ChildList.Num())
-			{
-				ThreadHash.ClassToChildListMap.Remove(SuperClass);
-			}
 		}
 	}
 }
@@ -877,7 +1407,7 @@ UObjectBase* FindObjectWithOuter(const class UObjectBase* Outer, const class UCl
 	return Result;
 }
 
-/** Helper function that returns all the children of the specified class recursively */
+/** Helper function that returns all the children of the specified class recursively, call from within a FHashTableReadScope */
 template<typename ClassType, typename ArrayAllocator>
 static void RecursivelyPopulateDerivedClasses(FUObjectHashTables& ThreadHash, const UClass* ParentClass, TArray<ClassType, ArrayAllocator>& OutAllDerivedClass)
 {
@@ -887,13 +1417,9 @@ static void RecursivelyPopulateDerivedClasses(FUObjectHashTables& ThreadHash, co
 
 	while (1)
 	{
-		TSet<UClass*>* ChildSet = ThreadHash.ClassToChildListMap.Find(SearchClass);
-		if (ChildSet)
+		for (auto* Node = ThreadHash.ClassToChildListMap.FindFirst(SearchClass); Node; Node = Node->Next.Load())
 		{
-			for (UClass* ChildClass : *ChildSet)
-			{
-				OutAllDerivedClass.Add(ChildClass);
-			}
+			OutAllDerivedClass.Add(static_cast<UClass*>(Node->Object));
 		}
 
 		// Now search at next index, if it has been filled in by code above
@@ -937,35 +1463,41 @@ void ForEachObjectOfClass(const UClass* ClassToLookFor, TFunctionRef<void(UObjec
 	TArray<const UClass*, TInlineAllocator<16>> ClassesToSearch;
 	ClassesToSearch.Add(ClassToLookFor);
 
-	FUObjectHashTables& ThreadHash = FUObjectHashTables::Get();
-	FHashTableLock HashLock(ThreadHash);
-
-	if (bIncludeDerivedClasses)
+	// Operation may create or rename objects so it can't be called while reading the hash tables. Like with any other object
+	// pointers, threads other than the game thread need to block GC to keep the objects alive while Operation runs.
+	TArray<UObject*, TInlineAllocator<64>> Objects;
 	{
-		RecursivelyPopulateDerivedClasses(ThreadHash, ClassToLookFor, ClassesToSearch);
-	}
+		FUObjectHashTables& ThreadHash = FUObjectHashTables::Get();
+		FHashTableReadScope ReadScope(ThreadHash);
 
-	for (const UClass* SearchClass : ClassesToSearch)
-	{
-		FHashBucket* List = ThreadHash.ClassToObjectListMap.Find(SearchClass);
-		if (List)
+		if (bIncludeDerivedClasses)
 		{
-			for (FHashBucketIterator ObjectIt(*List); ObjectIt; ++ObjectIt)
+			RecursivelyPopulateDerivedClasses(ThreadHash, ClassToLookFor, ClassesToSearch);
+		}
+
+		for (const UClass* SearchClass : ClassesToSearch)
+		{
+			for (auto* Node = ThreadHash.ClassToObjectListMap.FindFirst(SearchClass); Node; Node = Node->Next.Load())
 			{
-				UObject *Object = static_cast<UObject*>(*ObjectIt);
+				UObject *Object = static_cast<UObject*>(Node->Object);
 				if (!Object->HasAnyFlags(ExclusionFlags) && !Object->HasAnyInternalFlags(ExclusionInternalFlags))
 				{
-					Operation(Object);
+					Objects.Add(Object);
 				}
 			}
 		}
 	}
+
+	for (UObject* Object : Objects)
+	{
+		Operation(Object);
+	}
 }
 
 void GetDerivedClasses(const UClass* ClassToLookFor, TArray<UClass*>& Results, bool bRecursive)
 {
 	auto& ThreadHash = FUObjectHashTables::Get();
-	FHashTableLock HashLock(ThreadHash);
+	FHashTableReadScope ReadScope(ThreadHash);
 
 	if (bRecursive)
 	{
@@ -973,10 +1505,9 @@ void GetDerivedClasses(const UClass* ClassToLookFor, TArray<UClass*>& Results, b
 	}
 	else
 	{
-		TSet<UClass*>* DerivedClasses = ThreadHash.ClassToChildListMap.Find(ClassToLookFor);
-		if ( DerivedClasses )
+		for (auto* Node = ThreadHash.ClassToChildListMap.FindFirst(ClassToLookFor); Node; Node = Node->Next.Load())
 		{
-			Results.Append( DerivedClasses->Array() );
+			Results.Add(static_cast<UClass*>(Node->Object));
 		}
 	}
 }
@@ -987,22 +1518,18 @@ bool ClassHasInstancesAsyncLoading(const UClass* ClassToLookFor)
 	ClassesToSearch.Add(ClassToLookFor);
 
 	auto& ThreadHash = FUObjectHashTables::Get();
-	FHashTableLock HashLock(ThreadHash);
+	FHashTableReadScope ReadScope(ThreadHash);
 
 	RecursivelyPopulateDerivedClasses(ThreadHash, ClassToLookFor, ClassesToSearch);
 
 	for (const UClass* SearchClass : ClassesToSearch)
 	{
-		FHashBucket* List = ThreadHash.ClassToObjectListMap.Find(SearchClass);
-		if (List)
+		for (auto* Node = ThreadHash.ClassToObjectListMap.FindFirst(SearchClass); Node; Node = Node->Next.Load())
 		{
-			for (FHashBucketIterator ObjectIt(*List); ObjectIt; ++ObjectIt)
+			UObject *Object = static_cast<UObject*>(Node->Object);
+			if (Object->HasAnyInternalFlags(EInternalObjectFlags::AsyncLoading))
 			{
-				UObject *Object = static_cast<UObject*>(*ObjectIt);
-				if (Object->HasAnyInternalFlags(EInternalObjectFlags::AsyncLoading))
-				{
-					return true;
-				}
+				return true;
 			}
 		}
 	}
@@ -1034,13 +1561,14 @@ void HashObject(UObjectBase* Object)
 		if (PTRINT Outer = (PTRINT)Object->GetOuter())
 		{
 			Hash = GetObjectOuterHash(Name, Outer);
-			checkSlow(!ThreadHash.HashOuter.FindPair(Hash, Object));  // if it already exists, something is wrong with the external code
+			checkSlow(!ThreadHash.HashOuter.Contains(Hash, Object));  // if it already exists, something is wrong with the external code
 			ThreadHash.HashOuter.Add(Hash, Object);
 
 			AddToOuterMap(ThreadHash, Object);
 		}
 
 		AddToClassMap( ThreadHash, Object );
+		ThreadHash.ReadEpochs.TryAdvance();
 	}
 }
 
@@ -1069,23 +1597,31 @@ void UnhashObject(UObjectBase* Object)
 		if (PTRINT Outer = (PTRINT)Object->GetOuter())
 		{
 			Hash = GetObjectOuterHash(Name, Outer);
-			NumRemoved = ThreadHash.HashOuter.RemoveSingle(Hash, Object);
+			NumRemoved = ThreadHash.HashOuter.Remove(Hash, Object);
 			check(NumRemoved == 1); // must have existed, else something is wrong with the external code
 
 			RemoveFromOuterMap(ThreadHash, Object);
 		}
 
 		RemoveFromClassMap( ThreadHash, Object );
+		ThreadHash.ReadEpochs.TryAdvance();
 	}
 }
 
+void WaitForUObjectHashReaders()
+{
+	auto& ThreadHash = FUObjectHashTables::Get();
+	FHashTableLock HashLock(ThreadHash);
+	ThreadHash.ReadEpochs.Synchronize();
+}
+
 /**
  * Prevents any other threads from finding/adding UObjects (e.g. while GC is running)
 */
 void LockUObjectHashTables()
 {
 #if THREADSAFE_UOBJECTS
-	FUObjectHashTables::Get().Lock();
+	FUObjectHashTables::Get().LockExclusive();
 #else
 	check(IsInGameThread());
 #endif
@@ -1097,81 +1633,16 @@ void LockUObjectHashTables()
 void UnlockUObjectHashTables()
 {
 #if THREADSAFE_UOBJECTS
-	FUObjectHashTables::Get().Unlock();
+	FUObjectHashTables::Get().UnlockExclusive();
 #else
 	check(IsInGameThread());
 #endif
 }
 
-void LogHashStatisticsInternal(TMultiMap<int32, UObjectBase*>& Hash, FOutputDevice& Ar, const bool bShowHashBucketCollisionInfo)
+void LogHashStatisticsInternal(TObjectHashMultiMap<int32>& Hash, FOutputDevice& Ar, const bool bShowHashBucketCollisionInfo)
 {
-	TArray<int32> HashBuckets;
 	// Get the set of keys in use, which is the number of hash buckets
-	int32 SlotsInUse = Hash.GetKeys(HashBuckets);
-
-	int32 TotalCollisions = 0;
-	int32 MinCollisions = MAX_int32;
-	int32 MaxCollisions = 0;
-	int32 MaxBin = 0;
-
-	// Dump how many slots are in use
-	Ar.Logf(TEXT("Slots in use %d"), SlotsInUse);
-
-	// Work through each slot and figure out how many collisions
-	for (auto HashBucket : HashBuckets)
-	{
-		int32 Collisions = 0;
-
-		for (TMultiMap<int32, UObjectBase*>::TConstKeyIterator HashIt(Hash, HashBucket); HashIt; ++HashIt)
-		{
-			// There's one collision per object in a given bucket
-			Collisions++;
-		}
-
-		// Keep the global stats
-		TotalCollisions += Collisions;
-		if (Collisions > MaxCollisions)
-		{
-			MaxBin = HashBucket;
-		}
-		MaxCollisions = FMath::Max<int32>(Collisions, MaxCollisions);
-		MinCollisions = FMath::Min<int32>(Collisions, MinCollisions);
-
-		if (bShowHashBucketCollisionInfo)
-		{
-			// Now log the output
-			Ar.Logf(TEXT("\tSlot %d has %d collisions"), HashBucket, Collisions);
-		}
-	}
-	Ar.Logf(TEXT(""));
-
-	// Dump the first 30 objects in the worst bin for inspection
-	Ar.Logf(TEXT("Worst hash bucket contains:"));
-	int32 Count = 0;
-	for (TMultiMap<int32, UObjectBase*>::TConstKeyIterator HashIt(Hash, MaxBin); HashIt && Count < 30; ++HashIt)
-	{
-		UObject* Object = (UObject*)HashIt.Value();
-		Ar.Logf(TEXT("\tObject is %s (%s)"), *Object->GetName(), *Object->GetFullName());
-		Count++;
-	}
-	Ar.Logf(TEXT(""));
-
-	// Now dump how efficient the hash is
-	Ar.Logf(TEXT("Collision Stats: Best Case (%d), Average Case (%d), Worst Case (%d)"),
-		MinCollisions,
-		FMath::FloorToInt(((float)TotalCollisions / (float)SlotsInUse)),
-		MaxCollisions);
-
-	// Calculate Hashtable size
-	const uint32 HashtableAllocatedSize = Hash.GetAllocatedSize();
-	Ar.Logf(TEXT("Total memory allocated for Object Outer Hash: %u bytes."), HashtableAllocatedSize);
-}
-
-void LogHashStatisticsInternal(TMap<int32, FHashBucket>& Hash, FOutputDevice& Ar, const bool bShowHashBucketCollisionInfo)
-{
-	TArray<int32> HashBuckets;
-	// Get the set of keys in use, which is the number of hash buckets
-	int32 SlotsInUse = Hash.Num();
+	int32 SlotsInUse = Hash.NumKeysInUse();
 
 	int32 TotalCollisions = 0;
 	int32 MinCollisions = MAX_int32;
@@ -1183,9 +1654,10 @@ void LogHashStatisticsInternal(TMap<int32, FHashBucket>& Hash, FOutputDevice& Ar
 	Ar.Logf(TEXT("Slots in use %d"), SlotsInUse);
 
 	// Work through each slot and figure out how many collisions
-	for (auto& HashPair : Hash)
+	Hash.ForEachKey([&](const TObjectHashMultiMap<int32>::FKeyNode& KeyNode)
 	{
-		int32 Collisions = HashPair.Value.Num();
+		// There's one collision per object in a given bucket
+		int32 Collisions = KeyNode.NumValues;
 		check(Collisions >= 0);
 		if (Collisions > 1)
 		{
@@ -1196,7 +1668,7 @@ void LogHashStatisticsInternal(TMap<int32, FHashBucket>& Hash, FOutputDevice& Ar
 		TotalCollisions += Collisions;
 		if (Collisions > MaxCollisions)
 		{
-			MaxBin = HashPair.Key;
+			MaxBin = KeyNode.Key;
 		}
 		MaxCollisions = FMath::Max<int32>(Collisions, MaxCollisions);
 		MinCollisions = FMath::Min<int32>(Collisions, MinCollisions);
@@ -1204,18 +1676,17 @@ void LogHashStatisticsInternal(TMap<int32, FHashBucket>& Hash, FOutputDevice& Ar
 		if (bShowHashBucketCollisionInfo)
 		{
 			// Now log the output
-			Ar.Logf(TEXT("\tSlot %d has %d collisions"), HashPair.Key, Collisions);
+			Ar.Logf(TEXT("\tSlot %d has %d collisions"), KeyNode.Key, Collisions);
 		}
-	}
+	});
 	Ar.Logf(TEXT(""));
 
 	// Dump the first 30 objects in the worst bin for inspection
 	Ar.Logf(TEXT("Worst hash bucket contains:"));
 	int32 Count = 0;
-	FHashBucket& WorstBucket = Hash.FindChecked(MaxBin);
-	for (FHashBucketIterator It(WorstBucket); It; ++It)
+	for (auto* Node = Hash.FindFirst(MaxBin); Node && Count < 30; Node = Node->Next.Load())
 	{
-		UObject* Object = (UObject*)*It;
+		UObject* Object = (UObject*)Node->Object;
 		Ar.Logf(TEXT("\tObject is %s (%s)"), *Object->GetName(), *Object->GetFullName());
 		Count++;
 	}
@@ -1224,18 +1695,13 @@ void LogHashStatisticsInternal(TMap<int32, FHashBucket>& Hash, FOutputDevice& Ar
 	// Now dump how efficient the hash is
 	Ar.Logf(TEXT("Collision Stats: Best Case (%d), Average Case (%d), Worst Case (%d), Number of buckets with more than one item (%d/%d)"),
 		MinCollisions,
-		FMath::FloorToInt(((float)TotalCollisions / (float)SlotsInUse)),
+		SlotsInUse ? FMath::FloorToInt(((float)TotalCollisions / (float)SlotsInUse)) : 0,
 		MaxCollisions,
 		NumBucketsWithMoreThanOneItem,
 		SlotsInUse);
 
-	// Calculate Hashtable size
-	uint32 HashtableAllocatedSize = Hash.GetAllocatedSize();
-	// Calculate the size of a all Allocations inside of the buckets (TSet Items)
-	for (auto& Pair : Hash)
-	{
-		HashtableAllocatedSize += Pair.Value.GetItemsSize();
-	}
+	// Calculate Hashtable size, including the key and object nodes
+	const uint32 HashtableAllocatedSize = (uint32)Hash.GetAllocatedSize();
 	Ar.Logf(TEXT("Total memory allocated for and by Object Hash: %u bytes."), HashtableAllocatedSize);
 }
 
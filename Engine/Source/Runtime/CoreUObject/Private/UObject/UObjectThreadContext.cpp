@@ -17,6 +17,7 @@ FUObjectThreadContext::FUObjectThreadContext()
 , IsInConstructor(0)
 , ConstructedObject(nullptr)
 , AsyncPackage(nullptr)
+, IsSerializingOnLoaderWorker(false)
 , SerializeContext(new FUObjectSerializeContext())
 {}
 
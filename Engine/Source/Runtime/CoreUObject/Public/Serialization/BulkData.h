@@ -80,6 +80,8 @@ enum EBulkDataLockFlags
 	LOCK_READ_WRITE								= 2,
 };
 
+class FIoBuffer;
+struct FBulkDataCacheKey;
 class IMappedFileHandle;
 class IMappedFileRegion;
 
@@ -321,11 +323,22 @@ private:
 		COREUOBJECT_API bool MapFile(const TCHAR *Filename, int64 Offset, int64 Size);
 		COREUOBJECT_API void UnmapFile();
 
+		/** Uses the memory of an IoStore chunk view instead of an allocation, the view is held on to until unmapped */
+		COREUOBJECT_API void MapIoBuffer(const FIoBuffer& View);
+
+		/** Replaces mapped memory with an allocated copy of its first Count bytes, so it can be written to or reallocated */
+		COREUOBJECT_API void CopyMapped(int64 Count, int32 Alignment);
+
+		bool IsMapped() const
+		{
+			return MappedHandle || MappedRegion;
+		}
+
 		FOwnedBulkDataPtr* StealFileMapping()
 		{
 			FOwnedBulkDataPtr* Result;
-			// make the proper kind of owner pointer info
-			if (MappedHandle && MappedRegion && Ptr && bAllocated)
+			// make the proper kind of owner pointer info, IoStore views have a region but no file handle
+			if (MappedRegion && Ptr && bAllocated)
 			{
 				Result = new FOwnedBulkDataPtr(MappedHandle, MappedRegion);
 			}
@@ -606,6 +619,14 @@ public:
 	 * Forces the bulk data to be resident in memory and detaches the archive.
 	 */
 	void ForceBulkDataResident();
+
+	/**
+	 * Keeps the payload in FBulkDataCache once it has been read from disk, so that rereading it after the bulk data has
+	 * discarded it is a copy from memory. Pins are counted per payload and shared with every other bulk data reading
+	 * the same payload, each PinInCache needs an UnpinInCache. Does nothing in editor builds, which don't use the cache.
+	 */
+	void PinInCache();
+	void UnpinInCache();
 	
 	/**
 	 * Sets whether we should store the data compressed on disk.
@@ -652,6 +673,15 @@ public:
 	 */ 
 	void SerializeBulkData( FArchive& Ar, void* Data );
 
+	/**
+	 * Points the bulk data at its payload in Ar's memory instead of loading a copy, if Ar can hand out views of the
+	 * IoStore chunk it reads from and the payload can be used as is.
+	 *
+	 * @param	Ar					Archive positioned at the inline payload
+	 * @return	true if the payload was adopted and Ar moved past it, false if it still needs serializing
+	 */
+	bool TryAdoptInlinePayload( FArchive& Ar );
+
 	/*-----------------------------------------------------------------------------
 		Async Streaming Interface.
 	-----------------------------------------------------------------------------*/
@@ -780,6 +810,14 @@ private:
 	 */
 	void LoadDataIntoMemory( void* Dest );
 
+#if !WITH_EDITOR
+	/** Points payloads that were inline in a package loaded by the EDL at the .uexp file they are read from after load */
+	void RedirectInlinePayloadToExportsFile();
+
+	/** Returns the key of the payload in FBulkDataCache */
+	FBulkDataCacheKey GetCacheKey();
+#endif
+
 	/** Create the async load task */
 	void AsyncLoadBulkData();
 
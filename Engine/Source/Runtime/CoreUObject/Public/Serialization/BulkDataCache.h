@@ -0,0 +1,101 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/SharedPointer.h"
+
+/** Identifies a bulk data payload by where it is read from */
+struct FBulkDataCacheKey
+{
+	FName Filename;
+	int64 Offset;
+	int64 Size;
+
+	FBulkDataCacheKey()
+		: Offset(INDEX_NONE)
+		, Size(0)
+	{
+	}
+
+	FBulkDataCacheKey(FName InFilename, int64 InOffset, int64 InSize)
+		: Filename(InFilename)
+		, Offset(InOffset)
+		, Size(InSize)
+	{
+	}
+
+	bool operator==(const FBulkDataCacheKey& Other) const
+	{
+		return Filename == Other.Filename && Offset == Other.Offset && Size == Other.Size;
+	}
+
+	friend uint32 GetTypeHash(const FBulkDataCacheKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.Filename), GetTypeHash(Key.Offset));
+	}
+};
+
+/**
+ * Engine wide cache of bulk data payloads that were read from disk after load, so that bulk data which is reread (GetCopy
+ * with the internal copy discarded, streamed levels loaded again, ...) is copied from memory instead. Payloads are kept
+ * uncompressed, up to a byte budget set with s.BulkDataCacheSizeMB, and the least recently used ones are evicted first.
+ * Pinned payloads are never evicted. The cache is only used in cooked builds, where package files don't change.
+ * Hits and misses show in stat BulkDataCache and in CSV profiles. Thread safe.
+ */
+class COREUOBJECT_API FBulkDataCache
+{
+public:
+	static FBulkDataCache& Get();
+
+	FBulkDataCache();
+
+	/** Returns true if payloads should be looked up and added, which needs a budget */
+	bool IsEnabled() const;
+
+	/**
+	 * Copies a cached payload to Dest and makes it the most recently used one.
+	 *
+	 * @return true on a hit, false if the payload isn't cached and has to be read
+	 */
+	bool Find(const FBulkDataCacheKey& Key, void* Dest);
+
+	/** Adds a payload that was just read, evicting the least recently used unpinned payloads to stay within budget */
+	void Add(const FBulkDataCacheKey& Key, const void* Data);
+
+	/**
+	 * Keeps a payload in the cache until it is unpinned as many times as it was pinned, even over budget. The payload
+	 * doesn't have to be cached yet, it is kept from the next time it is added. Pins are counted whether or not the
+	 * cache is enabled.
+	 */
+	void Pin(const FBulkDataCacheKey& Key);
+	void Unpin(const FBulkDataCacheKey& Key);
+
+	/** Removes every unpinned payload */
+	void Trim();
+
+private:
+	typedef TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> FPayloadPtr;
+
+	struct FPinnedPayload
+	{
+		FPayloadPtr Payload;
+		int32 PinCount = 0;
+	};
+
+	/** Evicts the least recently used unpinned payloads until the cache is within BudgetBytes and holds at most MaxPayloads unpinned ones */
+	void EvictToBudget(int64 BudgetBytes, int32 MaxPayloads);
+	void UpdateStats();
+
+	FCriticalSection CriticalSection;
+	/** Unpinned payloads, least recently used first out */
+	TLruCache<FBulkDataCacheKey, FPayloadPtr> Unpinned;
+	/** Pinned payloads, Payload is null until the payload is added */
+	TMap<FBulkDataCacheKey, FPinnedPayload> Pinned;
+	/** Size of all cached payloads, pinned ones included */
+	int64 CachedBytes;
+	int64 TotalHits;
+	int64 TotalMisses;
+};
@@ -249,10 +249,12 @@ public:
 	uint16				RepIndex;
 	ELifetimeCondition	Condition;
 	ELifetimeRepNotifyCondition RepNotifyCondition;
+	/** Only compared for changes after it's been marked dirty, see PushModel.h */
+	bool				bIsPushBased;
 
-	FLifetimeProperty() : RepIndex( 0 ), Condition( COND_None ), RepNotifyCondition(REPNOTIFY_OnChanged) {}
-	FLifetimeProperty( int32 InRepIndex ) : RepIndex( InRepIndex ), Condition( COND_None ), RepNotifyCondition(REPNOTIFY_OnChanged) { check( InRepIndex <= 65535 ); }
-	FLifetimeProperty(int32 InRepIndex, ELifetimeCondition InCondition, ELifetimeRepNotifyCondition InRepNotifyCondition=REPNOTIFY_OnChanged) : RepIndex(InRepIndex), Condition(InCondition), RepNotifyCondition(InRepNotifyCondition) { check(InRepIndex <= 65535); }
+	FLifetimeProperty() : RepIndex( 0 ), Condition( COND_None ), RepNotifyCondition(REPNOTIFY_OnChanged), bIsPushBased(false) {}
+	FLifetimeProperty( int32 InRepIndex ) : RepIndex( InRepIndex ), Condition( COND_None ), RepNotifyCondition(REPNOTIFY_OnChanged), bIsPushBased(false) { check( InRepIndex <= 65535 ); }
+	FLifetimeProperty(int32 InRepIndex, ELifetimeCondition InCondition, ELifetimeRepNotifyCondition InRepNotifyCondition=REPNOTIFY_OnChanged, bool bInIsPushBased=false) : RepIndex(InRepIndex), Condition(InCondition), RepNotifyCondition(InRepNotifyCondition), bIsPushBased(bInIsPushBased) { check(InRepIndex <= 65535); }
 
 	inline bool operator==( const FLifetimeProperty& Other ) const
 	{
@@ -260,6 +262,7 @@ public:
 		{
 			check( Condition == Other.Condition );		// Can't have different conditions if the RepIndex matches, doesn't make sense
 			check( RepNotifyCondition == Other.RepNotifyCondition);
+			check( bIsPushBased == Other.bIsPushBased);
 			return true;
 		}
 
@@ -10,6 +10,7 @@
 #include "UObject/UnrealType.h"
 #include "Misc/ScopeLock.h"
 #include "HAL/PlatformProcess.h"
+#include "Containers/WorkStealingQueue.h"
 
 struct FStackEntry;
 
@@ -245,6 +246,7 @@ private:
    {
    public:
      int32 GetMinDesiredObjectsPerSubTask() const;
+     int32 GetMaxParallelTasks() const; // 0 for no limit
 		 void HandleTokenStreamObjectReference(TArray<UObject*>& ObjectsToSerialize, UObject* ReferencingObject, UObject*& Object, const int32 TokenIndex, bool bAllowReferenceElimination);
 		 void UpdateDetailedStats(UObject* CurrentObject, uint32 DeltaCycles);
 		 void LogDetailedStatsSummary();
@@ -267,26 +269,84 @@ class TFastReferenceCollector
 {
 private:
 
+	/**
+	 * Distributes object arrays between the workers processing them.
+	 *
+	 * Each worker owns a local work stealing deque. Work produced by a worker is pushed to its own deque and
+	 * processed depth first, while workers that run dry steal the oldest (usually largest) arrays from the others.
+	 * The shared list is used for work produced outside of the workers and when a local deque is full.
+	 */
 	class FCollectorTaskQueue
 	{
+		typedef TWorkStealingQueue<FGCArrayStruct, 256> FLocalQueue;
+
 		TFastReferenceCollector*	Owner;
 		ArrayPoolType& ArrayPool;
 		TLockFreePointerListUnordered<FGCArrayStruct, PLATFORM_CACHE_LINE_SIZE> Tasks;
+		TArray<TUniquePtr<FLocalQueue>> LocalQueues;
 
 		FCriticalSection WaitingThreadsLock;
 		TArray<FEvent*> WaitingThreads;
+		/** Number of entries in WaitingThreads, readable without taking the lock */
+		TAtomic<int32> NumWaitingThreads;
 		bool bDone;
 		int32 NumThreadsStarted;
+
+		/** Checks whether there is any work left in the shared list or in any of the local deques */
+		bool HasPendingWork() const
+		{
+			if (!Tasks.IsEmpty())
+			{
+				return true;
+			}
+			for (const TUniquePtr<FLocalQueue>& LocalQueue : LocalQueues)
+			{
+				if (!LocalQueue->IsEmpty())
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/** Pops from the worker's own deque, then from the shared list, then steals from the other workers */
+		FGCArrayStruct* FindWork(int32 WorkerIndex)
+		{
+			FGCArrayStruct* ArrayStruct = LocalQueues[WorkerIndex]->Pop();
+			if (!ArrayStruct)
+			{
+				ArrayStruct = Tasks.Pop();
+			}
+			const int32 NumQueues = LocalQueues.Num();
+			for (int32 Offset = 1; !ArrayStruct && Offset < NumQueues; ++Offset)
+			{
+				ArrayStruct = LocalQueues[(WorkerIndex + Offset) % NumQueues]->Steal();
+			}
+			return ArrayStruct;
+		}
+
 	public:
 
 		FCollectorTaskQueue(TFastReferenceCollector* InOwner, ArrayPoolType& InArrayPool)
 			: Owner(InOwner)
 			, ArrayPool(InArrayPool)
+			, NumWaitingThreads(0)
 			, bDone(false)
 			, NumThreadsStarted(0)
 		{
 		}
 
+		/** Allocates the local deques, must be called before any worker is started */
+		void Initialize(int32 NumWorkers)
+		{
+			check(!NumThreadsStarted);
+			LocalQueues.Empty(NumWorkers);
+			for (int32 WorkerIndex = 0; WorkerIndex < NumWorkers; ++WorkerIndex)
+			{
+				LocalQueues.Add(MakeUnique<FLocalQueue>());
+			}
+		}
+
 		void CheckDone()
 		{
 			FScopeLock Lock(&WaitingThreadsLock);
@@ -294,43 +354,69 @@ private:
 			check(!Tasks.Pop());
 			check(!WaitingThreads.Num());
 			check(NumThreadsStarted);
+			for (const TUniquePtr<FLocalQueue>& LocalQueue : LocalQueues)
+			{
+				check(LocalQueue->IsEmpty());
+			}
 		}
 
-		FORCENOINLINE void AddTask(const TArray<UObject*>* InObjectsToSerialize, int32 StartIndex, int32 NumObjects)
+		/** Returns true if at least one worker ran out of work and is waiting for more */
+		FORCEINLINE bool HasIdleWorkers() const
+		{
+			return NumWaitingThreads.Load(EMemoryOrder::Relaxed) > 0;
+		}
+
+		/**
+		 * Queues a copy of a range of objects.
+		 *
+		 * @param WorkerIndex Index of the calling worker, or INDEX_NONE when not called from a worker.
+		 */
+		FORCENOINLINE void AddTask(const TArray<UObject*>* InObjectsToSerialize, int32 StartIndex, int32 NumObjects, int32 WorkerIndex = INDEX_NONE)
 		{
 			FGCArrayStruct* ArrayStruct = ArrayPool.GetArrayStructFromPool();
 			ArrayStruct->ObjectsToSerialize.AddUninitialized(NumObjects);
 			FMemory::Memcpy(ArrayStruct->ObjectsToSerialize.GetData(), InObjectsToSerialize->GetData() + StartIndex, NumObjects * sizeof(UObject*));
-			Tasks.Push(ArrayStruct);
+			if (WorkerIndex == INDEX_NONE || !LocalQueues[WorkerIndex]->Push(ArrayStruct))
+			{
+				Tasks.Push(ArrayStruct);
+			}
 
-			FEvent* WaitingThread = nullptr;
+			// Waiting threads increment NumWaitingThreads before checking for pending work, so either they see
+			// the work we just pushed or we see them here. This lets the common case skip the lock.
+			if (NumWaitingThreads.Load() > 0)
 			{
-				FScopeLock Lock(&WaitingThreadsLock);
-				check(!bDone);
-				if (WaitingThreads.Num())
+				FEvent* WaitingThread = nullptr;
+				{
+					FScopeLock Lock(&WaitingThreadsLock);
+					check(!bDone);
+					if (WaitingThreads.Num())
+					{
+						WaitingThread = WaitingThreads.Pop();
+						NumWaitingThreads.Store(WaitingThreads.Num());
+					}
+				}
+				if (WaitingThread)
 				{
-					WaitingThread = WaitingThreads.Pop();
+					WaitingThread->Trigger();
 				}
 			}
-			if (WaitingThread)
-			{
-				WaitingThread->Trigger();
-			}
 		}
 
 		FORCENOINLINE void DoTask()
 		{
+			int32 WorkerIndex = INDEX_NONE;
 			{
 				FScopeLock Lock(&WaitingThreadsLock);
 				if (bDone)
 				{
 					return;
 				}
-				NumThreadsStarted++;
+				WorkerIndex = NumThreadsStarted++;
+				check(LocalQueues.IsValidIndex(WorkerIndex));
 			}
 			while (true)
 			{
-				FGCArrayStruct* ArrayStruct = Tasks.Pop();
+				FGCArrayStruct* ArrayStruct = FindWork(WorkerIndex);
 				while (!ArrayStruct)
 				{
 					if (bDone)
@@ -344,41 +430,41 @@ private:
 						{
 							return;
 						}
-						ArrayStruct = Tasks.Pop();
-						if (!ArrayStruct)
+						// Announce ourselves before the final check so that AddTask can't miss us
+						NumWaitingThreads.Store(WaitingThreads.Num() + 1);
+						if (HasPendingWork())
 						{
-							if (WaitingThreads.Num() + 1 == NumThreadsStarted)
-							{
-								bDone = true;
-								FPlatformMisc::MemoryBarrier();
-								for (FEvent* WaitingThread : WaitingThreads)
-								{
-									WaitingThread->Trigger();
-								}
-								WaitingThreads.Empty();
-								return;
-							}
-							else
+							NumWaitingThreads.Store(WaitingThreads.Num());
+						}
+						else if (WaitingThreads.Num() + 1 == NumThreadsStarted)
+						{
+							// Everybody else is waiting and there's nothing left to do
+							bDone = true;
+							NumWaitingThreads.Store(0);
+							FPlatformMisc::MemoryBarrier();
+							for (FEvent* WaitingThread : WaitingThreads)
 							{
-								WaitEvent = FPlatformProcess::GetSynchEventFromPool(false);
-								WaitingThreads.Push(WaitEvent);
+								WaitingThread->Trigger();
 							}
+							WaitingThreads.Empty();
+							return;
+						}
+						else
+						{
+							WaitEvent = FPlatformProcess::GetSynchEventFromPool(false);
+							WaitingThreads.Push(WaitEvent);
 						}
 					}
-					if (ArrayStruct)
-					{
-						check(!WaitEvent);
-					}
-					else
+					if (WaitEvent)
 					{
-						check(WaitEvent);
 						WaitEvent->Wait();
 						FPlatformProcess::ReturnSynchEventToPool(WaitEvent);
-						ArrayStruct = Tasks.Pop();
-						check(!ArrayStruct || !bDone);
 					}
+					// Work may have been taken by someone else in the meantime, in which case we simply wait again
+					ArrayStruct = FindWork(WorkerIndex);
+					check(!ArrayStruct || !bDone);
 				}
-				Owner->ProcessObjectArray(*ArrayStruct, FGraphEventRef());
+				Owner->ProcessObjectArray(*ArrayStruct, FGraphEventRef(), WorkerIndex);
 				ArrayPool.ReturnToPool(ArrayStruct);
 			}
 		}
@@ -469,7 +555,7 @@ private:
 		}
 		void DoTask(ENamedThreads::Type CurrentThread, FGraphEventRef& MyCompletionGraphEvent)
 		{
-			Owner->ProcessObjectArray(*ArrayStruct, MyCompletionGraphEvent);
+			Owner->ProcessObjectArray(*ArrayStruct, MyCompletionGraphEvent, INDEX_NONE);
 		}
 	};
 
@@ -517,7 +603,7 @@ public:
 			if (!bParallel)
 			{
 				FGraphEventRef InvalidRef;
-				ProcessObjectArray(ArrayStruct, InvalidRef);
+				ProcessObjectArray(ArrayStruct, InvalidRef, INDEX_NONE);
 			}
 			else
 			{
@@ -544,8 +630,13 @@ public:
 				NumBackgroundThreads = 0; // run on single group
 #endif
 				int32 NumTasks = NumThreads + NumBackgroundThreads;
+				if (ReferenceProcessor.GetMaxParallelTasks() > 0)
+				{
+					NumTasks = FMath::Min(NumTasks, ReferenceProcessor.GetMaxParallelTasks());
+				}
 
 				check(NumTasks > 0);
+				TaskQueue.Initialize(NumTasks);
 				ChunkTasks.Empty(NumTasks);
 				int32 NumPerChunk = ObjectsToCollectReferencesFor.Num() / NumTasks;
 				int32 StartIndex = 0;
@@ -577,14 +668,18 @@ private:
 	 *
 	 * @param InObjectsToSerializeArray Objects to process
 	 * @param MyCompletionGraphEvent Task graph event
+	 * @param WorkerIndex Index of the task queue worker processing the array, INDEX_NONE if not run by a task queue worker
 	 */
-	void ProcessObjectArray(FGCArrayStruct& InObjectsToSerializeStruct, const FGraphEventRef& MyCompletionGraphEvent)
+	void ProcessObjectArray(FGCArrayStruct& InObjectsToSerializeStruct, const FGraphEventRef& MyCompletionGraphEvent, int32 WorkerIndex)
 	{
 		DECLARE_SCOPE_CYCLE_COUNTER(TEXT("TFastReferenceCollector::ProcessObjectArray"), STAT_FFastReferenceCollector_ProcessObjectArray, STATGROUP_GC);
 
 		UObject* CurrentObject = nullptr;
 
 		const int32 MinDesiredObjectsPerSubTask = ReferenceProcessor.GetMinDesiredObjectsPerSubTask(); // sometimes there will be less, a lot less
+		// Idle workers are fed much smaller batches, otherwise a deep or unbalanced graph keeps all the work on a few workers
+		const int32 MinObjectsToShareWithIdleWorkers = FMath::Max(MinDesiredObjectsPerSubTask / 8, 2);
+		const bool bCanShareWithIdleWorkers = bParallel && WorkerIndex != INDEX_NONE;
 
 		/** Growing array of objects that require serialization */
 		FGCArrayStruct&	NewObjectsToSerializeStruct = *ArrayPool.GetArrayStructFromPool();
@@ -835,11 +930,29 @@ EndLoop:
 						}
 						else
 						{
-							TaskQueue.AddTask(&NewObjectsToSerialize, StartIndex, NumThisTask);
+							TaskQueue.AddTask(&NewObjectsToSerialize, StartIndex, NumThisTask, WorkerIndex);
 						}
 						NewObjectsToSerialize.SetNumUnsafeInternal(StartIndex);
 					}
 				}
+				else if (bCanShareWithIdleWorkers && TaskQueue.HasIdleWorkers())
+				{
+					// Someone ran out of work, give away the second half of what we have left rather than waiting
+					// for MinDesiredObjectsPerSubTask new objects to accumulate
+					const int32 NumRemaining = ObjectsToSerialize.Num() - CurrentIndex;
+					if (NumRemaining >= MinObjectsToShareWithIdleWorkers)
+					{
+						const int32 StartIndex = ObjectsToSerialize.Num() - NumRemaining / 2;
+						TaskQueue.AddTask(&ObjectsToSerialize, StartIndex, ObjectsToSerialize.Num() - StartIndex, WorkerIndex);
+						ObjectsToSerialize.SetNumUnsafeInternal(StartIndex);
+					}
+					else if (NewObjectsToSerialize.Num() >= MinObjectsToShareWithIdleWorkers)
+					{
+						const int32 StartIndex = NewObjectsToSerialize.Num() / 2;
+						TaskQueue.AddTask(&NewObjectsToSerialize, StartIndex, NewObjectsToSerialize.Num() - StartIndex, WorkerIndex);
+						NewObjectsToSerialize.SetNumUnsafeInternal(StartIndex);
+					}
+				}
 
 #if PERF_DETAILED_PER_CLASS_GC_STATS
 				// Detailed per class stats should not be performed when parallel GC is running
@@ -861,7 +974,7 @@ EndLoop:
 					}
 					else
 					{
-						TaskQueue.AddTask(&NewObjectsToSerialize, StartIndex, NumThisTask);
+						TaskQueue.AddTask(&NewObjectsToSerialize, StartIndex, NumThisTask, WorkerIndex);
 					}
 					StartIndex += NumThisTask;
 				}
@@ -935,6 +1048,10 @@ public:
 		// We only support single-threaded processing at the moment.
 		return 0;
 	}
+	FORCEINLINE int32 GetMaxParallelTasks() const
+	{
+		return 0;
+	}
 	FORCEINLINE volatile bool IsRunningMultithreaded() const
 	{
 		// We only support single-threaded processing at the moment.
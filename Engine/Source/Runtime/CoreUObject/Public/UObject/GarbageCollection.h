@@ -28,6 +28,48 @@ DECLARE_STATS_GROUP(TEXT("Garbage Collection"), STATGROUP_GC, STATCAT_Advanced);
  */
 #define DO_POINTER_CHECKS_ON_GC WITH_EDITORONLY_DATA
 
+/** True while incremental reachability analysis is in progress, see IncrementalCollectGarbage */
+extern COREUOBJECT_API bool GIsIncrementalReachabilityPending;
+
+/** True while incremental reachability analysis is in progress */
+extern COREUOBJECT_API bool GIsGCWriteBarrierActive;
+
+/** Write barrier slow path, use GCWriteBarrier instead */
+COREUOBJECT_API void GCWriteBarrierSlow(const class UObjectBase* Object);
+
+/**
+ * Tells the garbage collector that a reference to Object has just been written somewhere. Incremental reachability
+ * analysis keeps the object alive even if the reference was written to an object that has already been processed.
+ * Can be called from any thread and costs a single branch unless the analysis is in progress.
+ */
+FORCEINLINE void GCWriteBarrier(const class UObjectBase* Object)
+{
+	if (GIsGCWriteBarrierActive && Object)
+	{
+		GCWriteBarrierSlow(Object);
+	}
+}
+
+/** Garbage collection counts and timings, see GetGarbageCollectionStats */
+struct FGarbageCollectionStats
+{
+	/** Number of minor collections, which only considered objects created since the previous collection */
+	int32 NumMinorCollections = 0;
+	/** Number of full collections, including the ones which finished incremental reachability analysis */
+	int32 NumMajorCollections = 0;
+	/** Time spent on reachability analysis and gathering unreachable objects, in seconds */
+	double LastMinorCollectionTime = 0.0;
+	double LastMajorCollectionTime = 0.0;
+	double TotalMinorCollectionTime = 0.0;
+	double TotalMajorCollectionTime = 0.0;
+	/** Number of young objects minor collections found unreachable and kept alive (promoted) */
+	int64 NumObjectsCollectedByMinorCollections = 0;
+	int64 NumObjectsPromoted = 0;
+};
+
+/** Returns garbage collection counts and timings since startup */
+COREUOBJECT_API const FGarbageCollectionStats& GetGarbageCollectionStats();
+
 /*-----------------------------------------------------------------------------
 	Realtime garbage collection helper classes.
 -----------------------------------------------------------------------------*/
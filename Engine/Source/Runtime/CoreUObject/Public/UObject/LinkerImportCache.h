@@ -0,0 +1,87 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Atomic.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UClass;
+class UObject;
+
+/** Identifies a resolved import by the names of its outermost package, its outer and itself */
+struct FLinkerImportCacheKey
+{
+	FName PackageName;
+	FName OuterName;
+	FName ObjectName;
+
+	FLinkerImportCacheKey(FName InPackageName, FName InOuterName, FName InObjectName)
+		: PackageName(InPackageName)
+		, OuterName(InOuterName)
+		, ObjectName(InObjectName)
+	{
+	}
+
+	bool operator==(const FLinkerImportCacheKey& Other) const
+	{
+		return ObjectName == Other.ObjectName && OuterName == Other.OuterName && PackageName == Other.PackageName;
+	}
+
+	friend uint32 GetTypeHash(const FLinkerImportCacheKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.ObjectName), GetTypeHash(Key.OuterName)), GetTypeHash(Key.PackageName));
+	}
+};
+
+/**
+ * Cache of the objects that imports resolved to, shared by all linkers so that the classes and objects imported by
+ * thousands of packages are found with one map lookup instead of searching the object hash each time. Entries are weak
+ * and every hit is checked against the name, outer and class that was asked for, so an entry that went stale is only a
+ * miss. Objects that aren't found aren't cached, they may be created later. Can be turned off with s.LinkerImportCache.
+ * Thread safe.
+ */
+class COREUOBJECT_API FLinkerImportCache
+{
+public:
+	static FLinkerImportCache& Get();
+
+	FLinkerImportCache();
+	~FLinkerImportCache();
+
+	/** Returns true if lookups should go through the cache */
+	bool IsEnabled() const;
+
+	/** Finds the class ClassName in the package ClassPackage, like FindObjectFast<UClass> on the package found with FindObjectFast<UPackage> */
+	UClass* FindClass(FName ClassPackage, FName ClassName);
+
+	/** Finds an import that is in memory, like FLinkerLoad::FindImportFast */
+	UObject* FindImport(UClass* ImportClass, UObject* ImportOuter, FName ObjectName);
+
+	/** Removes every entry */
+	void Reset();
+
+	/** Number of lookups found in the cache and not, since startup */
+	int64 GetNumHits() const
+	{
+		return TotalHits;
+	}
+	int64 GetNumMisses() const
+	{
+		return TotalMisses;
+	}
+
+private:
+	/** Returns the cached object for Key if it still is ObjectName in ImportOuter and a ImportClass, or nullptr */
+	UObject* FindCached(const FLinkerImportCacheKey& Key, const UClass* ImportClass, const UObject* ImportOuter);
+	void AddCached(const FLinkerImportCacheKey& Key, UObject* Object);
+	/** Removes the entries of objects that were garbage collected */
+	void RemoveStaleEntries();
+
+	FRWLock Lock;
+	TMap<FLinkerImportCacheKey, FWeakObjectPtr> Entries;
+	TAtomic<int64> TotalHits;
+	TAtomic<int64> TotalMisses;
+	FDelegateHandle PostGarbageCollectHandle;
+};
@@ -83,6 +83,7 @@ class FLinkerLoad
 	friend class UPackageMap;
 	friend struct FAsyncPackage;
 	friend struct FAsyncPackage2;
+	friend class FAsyncExportArchive;
 	friend struct FResolvingExportTracker;
 protected:
 	/** Linker loading status. */
@@ -795,6 +796,10 @@ private:
 #endif
 		Loader->Serialize(V, Length);
 	}
+	virtual bool SerializeIoBufferView(FIoBuffer& OutView, int64 Length, uint32 Alignment) override
+	{
+		return Loader->SerializeIoBufferView(OutView, Length, Alignment);
+	}
 	using FArchiveUObject::operator<<; // For visibility of the overloads we don't override
 	virtual FArchive& operator<<(UObject*& Object) override;
 	FORCEINLINE virtual FArchive& operator<<(FLazyObjectPtr& LazyObjectPtr) override
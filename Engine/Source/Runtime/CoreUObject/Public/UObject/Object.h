@@ -455,6 +455,18 @@ public:
 		return false;
 	}
 
+	/**
+	* Called during async load to determine if Serialize can be called on a loader worker, at the same time as other exports
+	* of the package. Serialize must then only read from the archive: no creating, finding or loading other objects, no
+	* Preload, and no touching state shared with other objects.
+	*
+	* @return	true if this object's Serialize is thread safe
+	*/
+	virtual bool IsSerializeThreadSafe() const
+	{
+		return false;
+	}
+
 	/**
 	* Called during garbage collection to determine if an object can have its destructor called on a worker thread.
 	*
@@ -20,6 +20,57 @@
 #define UE_GC_TRACK_OBJ_AVAILABLE (WITH_EDITOR)
 #endif
 
+/**
+ * Internal object flags are kept in a dense array parallel to the object items (GUObjectGCStates) rather than in
+ * FUObjectItem so that garbage collection sweeps over all objects touch two bytes per object instead of a whole item.
+ * FUObjectItem remains the interface for reading and writing them.
+ */
+namespace EUObjectGCState
+{
+	enum Type : uint16
+	{
+		/** The low byte holds EInternalObjectFlags shifted down by FlagsShift */
+		FlagsMask = 0xff,
+		/** Set while the item holds an object */
+		Allocated = 1 << 8,
+		/** Set while the object is part of a cluster, i.e. its owner index is positive */
+		ClusterMember = 1 << 9,
+	};
+
+	enum { FlagsShift = 23 };
+
+	FORCEINLINE uint16 FromFlags(EInternalObjectFlags Flags)
+	{
+		return uint16(uint32(Flags) >> FlagsShift);
+	}
+
+	FORCEINLINE EInternalObjectFlags ToFlags(uint16 State)
+	{
+		return EInternalObjectFlags(int32(State & FlagsMask) << FlagsShift);
+	}
+}
+
+/** GC state of each item in the UObject array, indexed by object index. See EUObjectGCState. */
+extern COREUOBJECT_API uint16* GUObjectGCStates;
+
+namespace EUObjectGCState
+{
+	/** Allocates the zeroed GC states of an object array with MaxElements items and publishes them in GUObjectGCStates */
+	inline void AllocateStates(int32 MaxElements)
+	{
+		check(!GUObjectGCStates);
+		const SIZE_T Size = MaxElements * sizeof(uint16);
+		GUObjectGCStates = (uint16*)FMemory::Malloc(Size, PLATFORM_CACHE_LINE_SIZE);
+		FMemory::Memzero(GUObjectGCStates, Size);
+	}
+
+	inline void FreeStates()
+	{
+		FMemory::Free(GUObjectGCStates);
+		GUObjectGCStates = nullptr;
+	}
+}
+
 /**
 * Single item in the UObject array.
 */
@@ -27,8 +78,8 @@ struct FUObjectItem
 {
 	// Pointer to the allocated object
 	class UObjectBase* Object;
-	// Internal flags
-	int32 Flags;
+	// Index of this item in the UObject array, internal flags are stored in GUObjectGCStates
+	int32 Index;
 	// UObject Owner Cluster Index
 	int32 ClusterRootIndex;	
 	// Weak Object Pointer Serial number associated with the object
@@ -36,15 +87,29 @@ struct FUObjectItem
 
 	FUObjectItem()
 		: Object(nullptr)
-		, Flags(0)
+		, Index(INDEX_NONE)
 		, ClusterRootIndex(0)
 		, SerialNumber(0)
 	{
 	}
 
+	FORCEINLINE uint16& GCState() const
+	{
+		checkSlow(Index >= 0);
+		return GUObjectGCStates[Index];
+	}
+
 	FORCEINLINE void SetOwnerIndex(int32 OwnerIndex)
 	{
 		ClusterRootIndex = OwnerIndex;
+		if (OwnerIndex > 0)
+		{
+			GCState() |= EUObjectGCState::ClusterMember;
+		}
+		else
+		{
+			GCState() &= ~EUObjectGCState::ClusterMember;
+		}
 	}
 
 	FORCEINLINE int32 GetOwnerIndex() const
@@ -56,6 +121,7 @@ struct FUObjectItem
 	FORCEINLINE void SetClusterIndex(int32 ClusterIndex)
 	{
 		ClusterRootIndex = -ClusterIndex - 1;
+		GCState() &= ~EUObjectGCState::ClusterMember;
 	}
 
 	/** Decodes the cluster index from the ClusterRootIndex variable */
@@ -73,18 +139,18 @@ struct FUObjectItem
 	FORCEINLINE void SetFlags(EInternalObjectFlags FlagsToSet)
 	{
 		check((int32(FlagsToSet) & ~int32(EInternalObjectFlags::AllFlags)) == 0);
-		Flags |= int32(FlagsToSet);
+		GCState() |= EUObjectGCState::FromFlags(FlagsToSet);
 	}
 
 	FORCEINLINE EInternalObjectFlags GetFlags() const
 	{
-		return EInternalObjectFlags(Flags);
+		return EUObjectGCState::ToFlags(GCState());
 	}
 
 	FORCEINLINE void ClearFlags(EInternalObjectFlags FlagsToClear)
 	{
 		check((int32(FlagsToClear) & ~int32(EInternalObjectFlags::AllFlags)) == 0);
-		Flags &= ~int32(FlagsToClear);
+		GCState() &= ~EUObjectGCState::FromFlags(FlagsToClear);
 	}
 
 	/**
@@ -94,18 +160,20 @@ struct FUObjectItem
 	 */
 	FORCEINLINE bool ThisThreadAtomicallyClearedFlag(EInternalObjectFlags FlagToClear)
 	{
-		static_assert(sizeof(int32) == sizeof(Flags), "Flags must be 32-bit for atomics.");
+		static_assert(sizeof(int16) == sizeof(GUObjectGCStates[0]), "GC states must be 16-bit for atomics.");
+		volatile int16* State = (volatile int16*)&GCState();
+		const int16 StateToClear = (int16)EUObjectGCState::FromFlags(FlagToClear);
 		bool bIChangedIt = false;
 		while (1)
 		{
-			int32 StartValue = int32(Flags);
-			if (!(StartValue & int32(FlagToClear)))
+			int16 StartValue = *State;
+			if (!(StartValue & StateToClear))
 			{
 				break;
 			}
-			int32 NewValue = StartValue & ~int32(FlagToClear);
+			int16 NewValue = StartValue & ~StateToClear;
 			checkSlow(NewValue != StartValue);
-			if ((int32)FPlatformAtomics::InterlockedCompareExchange((int32*)&Flags, NewValue, StartValue) == StartValue)
+			if (FPlatformAtomics::InterlockedCompareExchange(State, NewValue, StartValue) == StartValue)
 			{
 				bIChangedIt = true;
 				break;
@@ -116,18 +184,20 @@ struct FUObjectItem
 
 	FORCEINLINE bool ThisThreadAtomicallySetFlag(EInternalObjectFlags FlagToSet)
 	{
-		static_assert(sizeof(int32) == sizeof(Flags), "Flags must be 32-bit for atomics.");
+		static_assert(sizeof(int16) == sizeof(GUObjectGCStates[0]), "GC states must be 16-bit for atomics.");
+		volatile int16* State = (volatile int16*)&GCState();
+		const int16 StateToSet = (int16)EUObjectGCState::FromFlags(FlagToSet);
 		bool bIChangedIt = false;
 		while (1)
 		{
-			int32 StartValue = int32(Flags);
-			if (StartValue & int32(FlagToSet))
+			int16 StartValue = *State;
+			if (StartValue & StateToSet)
 			{
 				break;
 			}
-			int32 NewValue = StartValue | int32(FlagToSet);
+			int16 NewValue = StartValue | StateToSet;
 			checkSlow(NewValue != StartValue);
-			if ((int32)FPlatformAtomics::InterlockedCompareExchange((int32*)&Flags, NewValue, StartValue) == StartValue)
+			if (FPlatformAtomics::InterlockedCompareExchange(State, NewValue, StartValue) == StartValue)
 			{
 				bIChangedIt = true;
 				break;
@@ -138,20 +208,20 @@ struct FUObjectItem
 
 	FORCEINLINE bool HasAnyFlags(EInternalObjectFlags InFlags) const
 	{
-		return !!(Flags & int32(InFlags));
+		return !!(GCState() & EUObjectGCState::FromFlags(InFlags));
 	}
 
 	FORCEINLINE void SetUnreachable()
 	{
-		Flags |= int32(EInternalObjectFlags::Unreachable);
+		SetFlags(EInternalObjectFlags::Unreachable);
 	}
 	FORCEINLINE void ClearUnreachable()
 	{
-		Flags &= ~int32(EInternalObjectFlags::Unreachable);
+		ClearFlags(EInternalObjectFlags::Unreachable);
 	}
 	FORCEINLINE bool IsUnreachable() const
 	{
-		return !!(Flags & int32(EInternalObjectFlags::Unreachable));
+		return HasAnyFlags(EInternalObjectFlags::Unreachable);
 	}
 	FORCEINLINE bool ThisThreadAtomicallyClearedRFUnreachable()
 	{
@@ -160,33 +230,34 @@ struct FUObjectItem
 
 	FORCEINLINE void SetPendingKill()
 	{
-		Flags |= int32(EInternalObjectFlags::PendingKill);
+		SetFlags(EInternalObjectFlags::PendingKill);
 	}
 	FORCEINLINE void ClearPendingKill()
 	{
-		Flags &= ~int32(EInternalObjectFlags::PendingKill);
+		ClearFlags(EInternalObjectFlags::PendingKill);
 	}
 	FORCEINLINE bool IsPendingKill() const
 	{
-		return !!(Flags & int32(EInternalObjectFlags::PendingKill));
+		return HasAnyFlags(EInternalObjectFlags::PendingKill);
 	}
 
 	FORCEINLINE void SetRootSet()
 	{
-		Flags |= int32(EInternalObjectFlags::RootSet);
+		SetFlags(EInternalObjectFlags::RootSet);
 	}
 	FORCEINLINE void ClearRootSet()
 	{
-		Flags &= ~int32(EInternalObjectFlags::RootSet);
+		ClearFlags(EInternalObjectFlags::RootSet);
 	}
 	FORCEINLINE bool IsRootSet() const
 	{
-		return !!(Flags & int32(EInternalObjectFlags::RootSet));
+		return HasAnyFlags(EInternalObjectFlags::RootSet);
 	}
 
+	/** Resets the item after an object has been added to it or removed from it */
 	FORCEINLINE void ResetSerialNumberAndFlags()
 	{
-		Flags = 0;
+		GCState() = Object ? uint16(EUObjectGCState::Allocated) : 0;
 		ClusterRootIndex = 0;
 		SerialNumber = 0;
 	}
@@ -216,6 +287,7 @@ public:
 	~FFixedUObjectArray()
 	{
 		delete [] Objects;
+		EUObjectGCState::FreeStates();
 	}
 
 	/**
@@ -227,6 +299,11 @@ public:
 		check(!Objects);
 		Objects = new FUObjectItem[InMaxElements];
 		MaxElements = InMaxElements;
+		for (int32 Index = 0; Index < MaxElements; ++Index)
+		{
+			Objects[Index].Index = Index;
+		}
+		EUObjectGCState::AllocateStates(MaxElements);
 	}
 
 	int32 AddSingle() TSAN_SAFE
@@ -362,6 +439,10 @@ class FChunkedFixedUObjectArray
 			// add a chunk, and make sure nobody else tries
 			FUObjectItem** Chunk = &Objects[NumChunks];
 			FUObjectItem* NewChunk = new FUObjectItem[NumElementsPerChunk];
+			for (int32 WithinChunkIndex = 0; WithinChunkIndex < NumElementsPerChunk; ++WithinChunkIndex)
+			{
+				NewChunk[WithinChunkIndex].Index = NumChunks * NumElementsPerChunk + WithinChunkIndex;
+			}
 			if (FPlatformAtomics::InterlockedCompareExchangePointer((void**)Chunk, NewChunk, nullptr))
 			{
 				// someone else beat us to the add, we don't support multiple concurrent adds
@@ -403,6 +484,7 @@ public:
 			delete[] PreAllocatedObjects;
 		}
 		delete[] Objects;
+		EUObjectGCState::FreeStates();
 	}
 
 	/**
@@ -420,12 +502,17 @@ public:
 		{
 			// Fully allocate all chunks as contiguous memory
 			PreAllocatedObjects = new FUObjectItem[MaxElements];
+			for (int32 Index = 0; Index < MaxElements; ++Index)
+			{
+				PreAllocatedObjects[Index].Index = Index;
+			}
 			for (int32 ChunkIndex = 0; ChunkIndex < MaxChunks; ++ChunkIndex)
 			{
 				Objects[ChunkIndex] = PreAllocatedObjects + ChunkIndex * NumElementsPerChunk;
 			}
 			NumChunks = MaxChunks;
 		}
+		EUObjectGCState::AllocateStates(MaxElements);
 	}
 
 	/**
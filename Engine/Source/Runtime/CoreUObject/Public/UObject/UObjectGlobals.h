@@ -449,6 +449,51 @@ COREUOBJECT_API void CollectGarbage(EObjectFlags KeepFlags, bool bPerformFullPur
 */
 COREUOBJECT_API bool TryCollectGarbage(EObjectFlags KeepFlags, bool bPerformFullPurge = true);
 
+/**
+ * Performs a slice of incremental reachability analysis, starting a new one if none is in progress. Once all reachable
+ * objects have been marked the garbage collection is completed the same way TryCollectGarbage would, without a full purge.
+ * Like TryCollectGarbage, blocks on the GC lock once gc.NumRetriesBeforeForcingGC attempts have been skipped. The final
+ * pause processes all marked objects again (gc.IncrementalReachabilityRescan) so references written without GCWriteBarrier are found.
+ *
+ * @param	KeepFlags			objects with those flags will be kept regardless of being referenced or not
+ * @param	TimeLimit			soft time limit for this function call in seconds, 0 to use gc.IncrementalReachabilityTimeLimit
+ * @return	true if garbage collection has been completed by this call
+ */
+COREUOBJECT_API bool IncrementalCollectGarbage(EObjectFlags KeepFlags, float TimeLimit = 0.0f);
+
+/**
+ * Returns whether incremental reachability analysis has been started and not finished yet.
+ */
+COREUOBJECT_API bool IsIncrementalReachabilityAnalysisPending();
+
+/**
+ * Returns whether periodic garbage collection should use IncrementalCollectGarbage (gc.AllowIncrementalReachability, never in the editor).
+ */
+COREUOBJECT_API bool IsIncrementalReachabilityAnalysisAllowed();
+
+/**
+ * Deletes unreferenced objects created since the previous garbage collection, promoting the ones that survive. Objects
+ * that existed before are assumed to be reachable, their own references are traced but nothing is traced through them,
+ * so native writes don't need GCWriteBarrier. Falls back to a full collection if young objects aren't being tracked
+ * (gc.MinorCollectionsPerMajor is 0) or incremental reachability analysis is in progress. Never performs a full purge.
+ *
+ * @param	KeepFlags			objects with those flags will be kept regardless of being referenced or not
+ */
+COREUOBJECT_API void CollectMinorGarbage(EObjectFlags KeepFlags);
+
+/**
+ * Performs minor garbage collection only if no other thread holds a lock on GC, see CollectMinorGarbage
+ *
+ * @param	KeepFlags			objects with those flags will be kept regardless of being referenced or not
+ */
+COREUOBJECT_API bool TryCollectMinorGarbage(EObjectFlags KeepFlags);
+
+/**
+ * Returns whether periodic garbage collection should be a minor one, i.e. young objects are being tracked and there
+ * have been less than gc.MinorCollectionsPerMajor minor collections since the last full one. Never in the editor.
+ */
+COREUOBJECT_API bool ShouldCollectMinorGarbage();
+
 /**
 * Calls ConditionalBeginDestroy on unreachable objects
 *
@@ -125,6 +125,19 @@ void HashObject(class UObjectBase* Object);
  */
 void UnhashObject(class UObjectBase* Object);
 
+/**
+ * Waits until lookups that don't take the hash tables lock are done with objects unhashed so far, after which unhashed objects
+ * can be freed. Also frees hash table memory that is no longer in use.
+ */
+void WaitForUObjectHashReaders();
+
+/**
+ * Brackets writing an object's name and outer in LowLevelRename, so that lock free hash table lookups comparing
+ * the name of an object that is being renamed never see a partially written FName.
+ */
+void BeginObjectRename();
+void EndObjectRename();
+
 /**
 * Shrink the UObject hash tables
 */
@@ -78,6 +78,8 @@ public:
 	UObject* ConstructedObject;
 	/** Async Package currently processing objects */
 	class FGCObject* AsyncPackage;
+	/** true while this thread serializes exports on behalf of the async loading thread, when objects must not be created or loaded */
+	bool IsSerializingOnLoaderWorker;
 
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 	/** Stack to ensure that PostInitProperties is routed through Super:: calls. **/
@@ -0,0 +1,21 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Commandlets/Commandlet.h"
+#include "AsyncLoadingStressTestCommandlet.generated.h"
+
+/**
+ * Loads many packages at once with exports serialized on loader workers and checks the results against loading them one at a time.
+ */
+UCLASS()
+class UAsyncLoadingStressTestCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
@@ -0,0 +1,35 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/Object.h"
+#include "Commandlets/Commandlet.h"
+#include "GCBenchmarkCommandlet.generated.h"
+
+/** Node of the synthetic object graphs built by UGCBenchmarkCommandlet */
+UCLASS(Transient)
+class UGCBenchmarkObject : public UObject
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY()
+	TArray<UObject*> References;
+};
+
+/**
+ * Builds wide, deep and clustered object graphs and measures how long garbage collection takes
+ * to walk them with different numbers of reachability analysis tasks.
+ */
+UCLASS()
+class UGCBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
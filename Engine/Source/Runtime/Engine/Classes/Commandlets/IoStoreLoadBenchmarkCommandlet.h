@@ -0,0 +1,22 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Commandlets/Commandlet.h"
+#include "IoStoreLoadBenchmarkCommandlet.generated.h"
+
+/**
+ * Compares load time and memory use of a package (typically a map) loaded from an IoStore container with bulk data
+ * copied out of the container and with bulk data using the container's memory in place.
+ */
+UCLASS()
+class UIoStoreLoadBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
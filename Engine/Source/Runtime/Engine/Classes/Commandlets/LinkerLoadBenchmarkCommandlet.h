@@ -0,0 +1,22 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Commandlets/Commandlet.h"
+#include "LinkerLoadBenchmarkCommandlet.generated.h"
+
+/**
+ * Loads every package in a directory synchronously and reports the time spent in each phase of linker loading, with the
+ * linker import cache off and on.
+ */
+UCLASS()
+class ULinkerLoadBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
@@ -0,0 +1,22 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Commandlets/Commandlet.h"
+#include "PakIndexBenchmarkCommandlet.generated.h"
+
+/**
+ * Measures mount time, resident memory and lookup latency of pak file indices, and can rewrite a pak file
+ * with a path hash index (PakFile_Version_PathHashIndex) to compare against.
+ */
+UCLASS()
+class UPakIndexBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
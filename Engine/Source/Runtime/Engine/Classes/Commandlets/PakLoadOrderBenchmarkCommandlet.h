@@ -0,0 +1,22 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Commandlets/Commandlet.h"
+#include "PakLoadOrderBenchmarkCommandlet.generated.h"
+
+/**
+ * Compares how long a package (typically a map) takes to load from pak files with and without the pak precacher
+ * replaying a recorded load order.
+ */
+UCLASS()
+class UPakLoadOrderBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
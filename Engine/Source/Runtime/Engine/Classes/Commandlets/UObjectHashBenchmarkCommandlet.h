@@ -0,0 +1,22 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Commandlets/Commandlet.h"
+#include "UObjectHashBenchmarkCommandlet.generated.h"
+
+/**
+ * Measures how many objects reader threads can find by name while the game thread keeps renaming other objects,
+ * with and without lock free UObject hash table reads (s.LockFreeUObjectHashReads).
+ */
+UCLASS()
+class UUObjectHashBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
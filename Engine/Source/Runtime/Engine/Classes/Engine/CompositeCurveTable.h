@@ -17,6 +17,8 @@ class UCompositeCurveTable
 	//~ Begin UObject Interface.
 	ENGINE_API virtual void GetPreloadDependencies(TArray<UObject*>& OutDeps) override;
 	ENGINE_API virtual void Serialize(FArchive& Ar) override;
+	/** Serialize preloads the parent tables and rebinds their change delegates, neither of which can be done on a loader worker */
+	virtual bool IsSerializeThreadSafe() const override { return false; }
 	ENGINE_API virtual void PostLoad() override;
 	//~ End UObject Interface
 
@@ -112,6 +112,8 @@ public:
 	//~ Begin UObject Interface.
 	ENGINE_API virtual void FinishDestroy() override;
 	ENGINE_API virtual void Serialize(FStructuredArchiveRecord Record) override;
+	/** Rows only read from the archive, the row struct is loaded before the table by the event driven loader */
+	virtual bool IsSerializeThreadSafe() const override { return true; }
 	ENGINE_API static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
 	ENGINE_API virtual void GetPreloadDependencies(TArray<UObject*>& OutDeps) override;
 	ENGINE_API virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
@@ -0,0 +1,275 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/**
+ *
+ *	===================== Grid Replication Driver =====================
+ *
+ *	A UReplicationDriver that doesn't test every actor against every connection each frame.
+ *
+ *	Every replicated actor is routed once, when it's added, to one of these:
+ *		-Always relevant actors (bAlwaysRelevant), considered by every connection.
+ *		-Owner only actors (bOnlyRelevantToOwner), considered by the connection that owns them.
+ *		-Team actors (see GetActorTeam), considered by every connection on the same team.
+ *		-Owner relevancy actors (bNetUseOwnerRelevancy with an owner) and actors without a root component, tested with
+ *		 IsNetRelevantFor like the legacy path.
+ *		-Everything else goes in a 2D grid of CellSize cells, in every cell within its NetCullDistance.
+ *
+ *	Grid actors are relevant the way AActor::IsNetRelevantFor's default is, except that IsNetRelevantFor overrides aren't
+ *	called, attached actors don't use their parent's relevancy, bUseDistanceBasedRelevancy is ignored, and actors a viewer
+ *	is, owns or instigates are only found from the cells within their cull distance.
+ *
+ *	A connection only considers the actors in the cells its viewers are in. The list of actors of a cell that can
+ *	replicate this frame is built by the first connection that needs it and shared with every other connection
+ *	in that cell. Moving actors are moved between cells once per frame, before any connection gathers.
+ *
+ *	Actors are replicated to a connection at most NetUpdateFrequency times per second, counted in replication
+ *	frames of NetServerMaxTickRate. Actors that are due are sorted by how overdue they are, weighted by distance
+ *	and NetPriority, and sent in that order until the connection is saturated.
+ *
+ *	How to use it:
+ *
+ *		[/Script/OnlineSubsystemUtils.IpNetDriver]
+ *		ReplicationDriverClassName="/Script/Engine.GridReplicationDriver"
+ *
+ *		[/Script/Engine.GridReplicationDriver]
+ *		CellSize=10000.0
+ *
+ *	Net.GridReplicationBenchmark measures it against the legacy path (see GridReplicationBenchmarkActor.h).
+ */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Engine/ReplicationDriver.h"
+
+#include "GridReplicationDriver.generated.h"
+
+class AActor;
+class UNetConnection;
+class UNetDriver;
+class UWorld;
+
+struct FNetworkObjectInfo;
+struct FNetViewer;
+
+UCLASS(transient, config=Engine)
+class ENGINE_API UGridReplicationDriver : public UReplicationDriver
+{
+	GENERATED_BODY()
+
+public:
+
+	UGridReplicationDriver();
+
+	//~ Begin UReplicationDriver Interface
+	virtual void SetRepDriverWorld(UWorld* InWorld) override;
+	virtual void InitForNetDriver(UNetDriver* InNetDriver) override;
+	virtual void InitializeActorsInWorld(UWorld* InWorld) override;
+	virtual void TearDown() override;
+	virtual void ResetGameWorldState() override;
+	virtual void AddClientConnection(UNetConnection* NetConnection) override;
+	virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+	virtual void AddNetworkActor(AActor* Actor) override;
+	virtual void RemoveNetworkActor(AActor* Actor) override;
+	virtual void ForceNetUpdate(AActor* Actor) override;
+	virtual void FlushNetDormancy(AActor* Actor, bool WasDormInitial) override;
+	virtual void NotifyActorTearOff(AActor* Actor) override;
+	virtual void NotifyActorFullyDormantForConnection(AActor* Actor, UNetConnection* Connection) override;
+	virtual void NotifyActorDormancyChange(AActor* Actor, ENetDormancy OldDormancyState) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+	//~ End UReplicationDriver Interface
+
+	/** Size of a grid cell in world units. Smaller cells gather fewer actors that turn out to be too far away, but moving actors change cells more often. */
+	UPROPERTY(config)
+	float CellSize;
+
+	/** Actors whose NetCullDistance covers more cells than this aren't put in the grid, they're distance tested by every connection instead. */
+	UPROPERTY(config)
+	int32 MaxCellsPerActor;
+
+	/** How much more often close actors are sent than actors at their NetCullDistance when a connection can't send everything that is due. 0 ignores distance. */
+	UPROPERTY(config)
+	float DistancePriorityScale;
+
+	/** Channels of actors that haven't been relevant for RelevantTimeout are closed. This is how many frames apart connections are checked for them. */
+	UPROPERTY(config)
+	int32 CloseChannelsFrameInterval;
+
+	/** Returns the team whose connections Actor is always relevant to, and only to them. INDEX_NONE for actors that aren't team actors. Called once when the actor is added. */
+	virtual int32 GetActorTeam(const AActor* Actor) const { return INDEX_NONE; }
+
+	/** Returns the team of a connection, INDEX_NONE if it's not on a team. Called every frame. */
+	virtual int32 GetConnectionTeam(UNetConnection* Connection) const { return INDEX_NONE; }
+
+	/** Number of actors the driver knows about, and how many of them are in the grid. */
+	int32 GetNumActors() const { return ActorInfoMap.Num(); }
+	int32 GetNumGridActors() const;
+
+	/** Number of cells actors are in. */
+	int32 GetNumCells() const { return Cells.Num(); }
+
+	/** Whether the actor was put in the cells of the grid, rather than in one of the lists. */
+	bool IsActorInGrid(const AActor* Actor) const;
+
+	/**
+	 * Whether a connection with these viewers gathers the actor. Leaves out what's checked once per frame for every
+	 * connection (streaming levels, spawn deferral, tear off), dormancy and update frequency.
+	 */
+	bool IsActorRelevantToConnection(const AActor* Actor, UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers) const;
+
+	/** Whether a connection skips the actor because it's dormant on it. */
+	bool IsActorDormantOnConnection(const AActor* Actor, UNetConnection* Connection) const;
+
+private:
+
+	/** Where an actor was routed when it was added */
+	enum class EActorRouting : uint8
+	{
+		Grid,
+		AlwaysRelevant,
+		OwnerOnly,
+		Team,
+		OwnerRelevancy,
+	};
+
+	/** What the driver keeps for each replicated actor, shared by all connections */
+	struct FGridActorInfo
+	{
+		AActor* Actor = nullptr;
+		FNetworkObjectInfo* NetworkObjectInfo = nullptr;
+
+		EActorRouting Routing = EActorRouting::Grid;
+
+		/** Team for EActorRouting::Team */
+		int32 Team = INDEX_NONE;
+
+		/** Cells the actor is in, Min > Max when it isn't in any */
+		FIntPoint CellMin = FIntPoint(0, 0);
+		FIntPoint CellMax = FIntPoint(-1, -1);
+
+		/** Doesn't move, its cells are never updated */
+		bool bIsStatic = false;
+
+		/** Too big for the grid, distance tested by every connection */
+		bool bIsLarge = false;
+
+		/** Result of CanReplicateThisFrame for FilterFrame */
+		bool bCanReplicate = false;
+		uint32 FilterFrame = 0;
+
+		/** Frame CallPreReplication was last called */
+		uint32 PreReplicationFrame = 0;
+
+		/** Frame of the last ForceNetUpdate, connections that replicated it before that will send it again */
+		uint32 ForceNetUpdateFrame = 0;
+
+		/** Number of replication frames between two updates, from NetUpdateFrequency */
+		uint32 UpdatePeriod = 1;
+	};
+
+	/** Actors in one cell of the grid */
+	struct FGridCell
+	{
+		TArray<FGridActorInfo*> Actors;
+
+		/** Actors that can replicate this frame, built once for GatherFrame and shared by every connection in this cell */
+		TArray<FGridActorInfo*> GatherList;
+		uint32 GatherFrame = 0;
+	};
+
+	/** What a connection knows about one actor */
+	struct FGridConnectionActorInfo
+	{
+		/** Frame the actor was last sent to this connection, 0 if never */
+		uint32 LastReplicationFrame = 0;
+
+		/** Frame this connection last gathered the actor, to skip actors that several viewers gathered */
+		uint32 LastGatherFrame = 0;
+
+		/** Last time the actor was relevant to this connection */
+		double LastRelevantTime = 0.0;
+	};
+
+	/** What the driver keeps for each client connection */
+	struct FGridConnectionInfo
+	{
+		UNetConnection* Connection = nullptr;
+		TWeakObjectPtr<UNetConnection> WeakConnection;
+
+		TMap<AActor*, FGridConnectionActorInfo> ActorInfos;
+
+		/** Owner only actors owned by this connection or its children, rebuilt every frame */
+		TArray<FGridActorInfo*> OwnedActors;
+	};
+
+	/** One actor a connection could send this frame */
+	struct FPrioritizedActor
+	{
+		FGridActorInfo* ActorInfo;
+		FGridConnectionActorInfo* ConnectionActorInfo;
+		UActorChannel* Channel;
+		float Priority;
+	};
+
+	EActorRouting RouteActor(const AActor* Actor, int32& OutTeam) const;
+
+	FIntPoint GetCell(const FVector& Location) const;
+	bool GetCellRange(const AActor* Actor, FIntPoint& OutMin, FIntPoint& OutMax) const;
+	/** Moves a grid actor to the cells it covers now. Returns false if it covers too many cells for the grid now. */
+	bool UpdateActorCells(FGridActorInfo& ActorInfo);
+	void AddToCells(FGridActorInfo& ActorInfo, const FIntPoint& CellMin, const FIntPoint& CellMax);
+	void RemoveFromCells(FGridActorInfo& ActorInfo);
+
+	/** Checks everything about an actor that doesn't depend on the connection, once per frame */
+	bool CanReplicateThisFrame(FGridActorInfo& ActorInfo);
+
+	/** Returns the actors of a cell that can replicate this frame */
+	const TArray<FGridActorInfo*>& GatherCell(const FIntPoint& CellKey);
+
+	void PrepareConnections();
+	void BuildOwnedActorLists();
+
+	int32 ReplicateConnection(FGridConnectionInfo& ConnectionInfo, const TArray<FNetViewer>& ConnectionViewers);
+	void ConsiderActor(FGridConnectionInfo& ConnectionInfo, FGridActorInfo* ActorInfo, const TArray<FNetViewer>& ConnectionViewers, bool bLowNetBandwidth);
+	int32 SendDestructionInfos(UNetConnection* Connection);
+	void CloseIrrelevantChannels(FGridConnectionInfo& ConnectionInfo);
+
+	FGridConnectionInfo& FindOrAddConnectionInfo(UNetConnection* Connection);
+	void ResetActors();
+
+	UPROPERTY()
+	UNetDriver* NetDriver;
+
+	UPROPERTY()
+	UWorld* World;
+
+	TMap<AActor*, TUniquePtr<FGridActorInfo>> ActorInfoMap;
+
+	/** Actors removed this frame, freed at the start of the next one so lists built this frame can still point to them */
+	TArray<TUniquePtr<FGridActorInfo>> RemovedActorInfos;
+
+	TMap<FIntPoint, FGridCell> Cells;
+
+	/** Cells that lost their last actor, removed at the start of the next frame if they're still empty */
+	TArray<FIntPoint> EmptyCells;
+
+	/** Grid actors that move */
+	TSet<FGridActorInfo*> DynamicGridActors;
+
+	/** Grid actors whose NetCullDistance covers more than MaxCellsPerActor cells */
+	TArray<FGridActorInfo*> LargeActors;
+
+	TArray<FGridActorInfo*> AlwaysRelevantActors;
+	TArray<FGridActorInfo*> OwnerOnlyActors;
+	TArray<FGridActorInfo*> OwnerRelevancyActors;
+	TMap<int32, TArray<FGridActorInfo*>> TeamActors;
+
+	TMap<UNetConnection*, TUniquePtr<FGridConnectionInfo>> ConnectionInfoMap;
+
+	/** Actors a connection considers this frame, reused across connections */
+	TArray<FPrioritizedActor> PrioritizedActors;
+
+	/** Frames the actors with a NetUpdateFrequency are counted in */
+	float ReplicationFrameRate;
+};
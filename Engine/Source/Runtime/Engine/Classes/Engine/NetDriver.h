@@ -336,6 +336,8 @@ extern ENGINE_API TAutoConsoleVariable<int32> CVarNetAllowEncryption;
 extern ENGINE_API int32 GNumSaturatedConnections;
 extern ENGINE_API int32 GNumSharedSerializationHit;
 extern ENGINE_API int32 GNumSharedSerializationMiss;
+extern ENGINE_API int32 GNumSharedChangelistHit;
+extern ENGINE_API int32 GNumSharedChangelistMiss;
 extern ENGINE_API int32 GNumReplicateActorCalls;
 extern ENGINE_API bool GReplicateActorTimingEnabled;
 extern ENGINE_API bool GReceiveRPCTimingEnabled;
@@ -548,6 +550,25 @@ struct FCompareFActorPriority
 	}
 };
 
+/**
+ * Actors prioritized for one connection by a net.ParallelPrioritizeActors task, replicated later on the game thread in connection order.
+ * Only prioritizing runs on task graph threads, the actors are replicated to each connection one after the other.
+ */
+struct FParallelConnectionPriorities
+{
+	class UNetConnection* Connection = nullptr;
+
+	TArray<FNetViewer> ConnectionViewers;
+
+	TArray<FActorPriority> PriorityList;
+	TArray<FActorPriority*> PriorityActors;
+	int32 DeletedCount = 0;
+
+	/** Channels prioritizing closes or starts putting to sleep, which is deferred until the connection is replicated to */
+	TArray<class UActorChannel*> ChannelsToClose;
+	TArray<class UActorChannel*> ChannelsToStartBecomingDormant;
+};
+
 struct FActorDestructionInfo
 {
 public:
@@ -752,6 +773,12 @@ public:
 	/** Reference to the PacketHandler component, for managing stateless connection handshakes */
 	TWeakPtr<StatelessConnectHandlerComponent> StatelessConnectComponent;
 
+	/** Packets queued by QueueBatchedSend this tick, sent by FlushBatchedSends */
+	TUniquePtr<FSendMulti> BatchedSends;
+
+	/** The socket the packets in BatchedSends are sent through */
+	class FSocket* BatchedSendSocket;
+
 	/** The analytics provider used by the packet handler */
 	TSharedPtr<IAnalyticsProvider> AnalyticsProvider;
 
@@ -1257,6 +1284,22 @@ public:
 	ENGINE_API virtual void LowLevelSend(TSharedPtr<const FInternetAddr> Address, void* Data, int32 CountBits, FOutPacketTraits& Traits)
 		PURE_VIRTUAL(UNetDriver::LowLevelSend,);
 
+	/**
+	 * Queues a packet to be sent by FlushBatchedSends, along with every other packet sent this tick, instead of sending it now.
+	 * Socket based net drivers and connections call this from LowLevelSend, in place of FSocket::SendTo.
+	 * NOTE: Only queues packets when net.BatchSends is enabled, and the socket subsystem supports FSocket::SendMulti.
+	 *
+	 * @param Socket		The socket the packet should be sent through
+	 * @param Data			The packet data
+	 * @param CountBytes	The size of the packet data, in bytes
+	 * @param Address		The address the packet should be sent to
+	 * @return				Whether or not the packet was queued - if not, the caller should send it itself
+	 */
+	ENGINE_API bool QueueBatchedSend(class FSocket* Socket, const uint8* Data, int32 CountBytes, const FInternetAddr& Address);
+
+	/** Sends every packet queued by QueueBatchedSend. Called by TickFlush once every connection has ticked, and on Shutdown. */
+	ENGINE_API virtual void FlushBatchedSends();
+
 	/**
 	 * Process any local talker packets that need to be sent to clients
 	 */
@@ -1529,6 +1572,8 @@ protected:
 	void ServerReplicateActors_BuildConsiderList( TArray<FNetworkObjectInfo*>& OutConsiderList, const float ServerTickTime );
 	int32 ServerReplicateActors_PrioritizeActors( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const TArray<FNetworkObjectInfo*> ConsiderList, const bool bCPUSaturated, FActorPriority*& OutPriorityList, FActorPriority**& OutPriorityActors );
 	int32 ServerReplicateActors_ProcessPrioritizedActors( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, FActorPriority** PriorityActors, const int32 FinalSortedCount, int32& OutUpdated );
+	/** Same as ServerReplicateActors_PrioritizeActors, but only reads state other connections share so several connections can be prioritized at once (net.ParallelPrioritizeActors) */
+	void ServerReplicateActors_PrioritizeActorsParallel( FParallelConnectionPriorities& ConnectionPriorities, const TArray<FNetworkObjectInfo*>& ConsiderList, const bool bLowNetBandwidth ) const;
 #endif
 
 	/** Used to handle any NetDriver specific cleanup once a level has been removed from the world. */
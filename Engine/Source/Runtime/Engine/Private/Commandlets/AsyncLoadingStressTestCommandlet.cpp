@@ -0,0 +1,201 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	AsyncLoadingStressTestCommandlet.cpp: Commandlet used for validating
+	export serialization on async loading workers.
+=============================================================================*/
+
+#include "Commandlets/AsyncLoadingStressTestCommandlet.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Serialization/ArchiveObjectCrc32.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UObjectHash.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncLoadingStressTest, Log, All);
+
+/**
+ * UAsyncLoadingStressTestCommandlet
+ *
+ * Usage:
+ *	AsyncLoadingStressTest -Packages=<package name>+<package name>...
+ *	AsyncLoadingStressTest -PackageList=<file with one package name per line>
+ *
+ * Optional parameters:
+ *	-Workers=N: Value of s.AsyncLoadingSerializeWorkers for the parallel loads (default 8)
+ *	-Runs=N: Number of times all packages are loaded in parallel and checked (default 3)
+ *
+ * The packages are first loaded one at a time with every export serialized on the async loading thread, which gives the
+ * checksum of each object they contain. They are then all requested at once with exports serialized on workers, and
+ * every object must come out with the same checksum. Only cooked packages loaded by the event driven loader take the
+ * worker path.
+ */
+
+UAsyncLoadingStressTestCommandlet::UAsyncLoadingStressTestCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+/** Adds the checksum of every object in the package to OutCrcs, keyed by path name */
+static void GatherObjectCrcs(UPackage* Package, TMap<FString, uint32>& OutCrcs)
+{
+	TArray<UObject*> Objects;
+	GetObjectsWithOuter(Package, Objects, true);
+	for (UObject* Object : Objects)
+	{
+		FArchiveObjectCrc32 CrcArchive;
+		OutCrcs.Add(Object->GetPathName(), CrcArchive.Crc32(Object));
+	}
+}
+
+/** Collects garbage and returns false if any of the packages are still loaded */
+static bool UnloadPackages(const TArray<FString>& PackageNames)
+{
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+	bool bUnloaded = true;
+	for (const FString& PackageName : PackageNames)
+	{
+		if (FindPackage(nullptr, *PackageName))
+		{
+			UE_LOG(LogAsyncLoadingStressTest, Error, TEXT("%s is still loaded after garbage collection, it can't be loaded again"), *PackageName);
+			bUnloaded = false;
+		}
+	}
+	return bUnloaded;
+}
+
+int32 UAsyncLoadingStressTestCommandlet::Main(const FString& Params)
+{
+	const TCHAR* ParamStr = *Params;
+
+	FString PackagesParam;
+	FString PackageListFile;
+	int32 Workers = 8;
+	int32 Runs = 3;
+	FParse::Value(ParamStr, TEXT("Packages="), PackagesParam);
+	FParse::Value(ParamStr, TEXT("PackageList="), PackageListFile);
+	FParse::Value(ParamStr, TEXT("Workers="), Workers);
+	FParse::Value(ParamStr, TEXT("Runs="), Runs);
+	Workers = FMath::Max(Workers, 1);
+	Runs = FMath::Max(Runs, 1);
+
+	TArray<FString> PackageNames;
+	PackagesParam.ParseIntoArray(PackageNames, TEXT("+"));
+	if (!PackageListFile.IsEmpty())
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *PackageListFile))
+		{
+			UE_LOG(LogAsyncLoadingStressTest, Error, TEXT("Failed to read %s"), *PackageListFile);
+			return 1;
+		}
+		for (FString& Line : Lines)
+		{
+			Line.TrimStartAndEndInline();
+			if (!Line.IsEmpty())
+			{
+				PackageNames.Add(Line);
+			}
+		}
+	}
+	if (PackageNames.Num() == 0)
+	{
+		UE_LOG(LogAsyncLoadingStressTest, Error, TEXT("Usage: AsyncLoadingStressTest -Packages=<package>+<package>... | -PackageList=<file> [-Workers=N] [-Runs=N]"));
+		return 1;
+	}
+
+	IConsoleVariable* WorkersVar = IConsoleManager::Get().FindConsoleVariable(TEXT("s.AsyncLoadingSerializeWorkers"));
+	check(WorkersVar);
+	const int32 PreviousWorkers = WorkersVar->GetInt();
+
+	// Reference results, one package at a time on the async loading thread only
+	WorkersVar->Set(0);
+	int32 NumErrors = 0;
+	TMap<FString, uint32> ExpectedCrcs;
+	double SerialTime = 0.0;
+	for (const FString& PackageName : PackageNames)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		LoadPackageAsync(PackageName);
+		FlushAsyncLoading();
+		SerialTime += FPlatformTime::Seconds() - StartTime;
+
+		if (UPackage* Package = FindPackage(nullptr, *PackageName))
+		{
+			GatherObjectCrcs(Package, ExpectedCrcs);
+		}
+		else
+		{
+			UE_LOG(LogAsyncLoadingStressTest, Error, TEXT("Failed to load %s"), *PackageName);
+			++NumErrors;
+		}
+	}
+	UE_LOG(LogAsyncLoadingStressTest, Display, TEXT("%d packages loaded one at a time in %.3fs, %d objects"), PackageNames.Num(), SerialTime, ExpectedCrcs.Num());
+
+	WorkersVar->Set(Workers);
+	int32 NumRunsCompleted = 0;
+	for (int32 Run = 0; Run < Runs && UnloadPackages(PackageNames); ++Run)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (const FString& PackageName : PackageNames)
+		{
+			LoadPackageAsync(PackageName);
+		}
+		FlushAsyncLoading();
+		const double Time = FPlatformTime::Seconds() - StartTime;
+
+		TMap<FString, uint32> Crcs;
+		for (const FString& PackageName : PackageNames)
+		{
+			if (UPackage* Package = FindPackage(nullptr, *PackageName))
+			{
+				GatherObjectCrcs(Package, Crcs);
+			}
+		}
+
+		int32 NumMismatches = 0;
+		for (const TPair<FString, uint32>& Expected : ExpectedCrcs)
+		{
+			const uint32* Crc = Crcs.Find(Expected.Key);
+			if (!Crc)
+			{
+				UE_LOG(LogAsyncLoadingStressTest, Error, TEXT("run %d: %s is missing"), Run, *Expected.Key);
+				++NumMismatches;
+			}
+			else if (*Crc != Expected.Value)
+			{
+				UE_LOG(LogAsyncLoadingStressTest, Error, TEXT("run %d: %s differs from loading it on the async loading thread (crc %08x, expected %08x)"), Run, *Expected.Key, *Crc, Expected.Value);
+				++NumMismatches;
+			}
+		}
+		for (const TPair<FString, uint32>& Loaded : Crcs)
+		{
+			if (!ExpectedCrcs.Contains(Loaded.Key))
+			{
+				UE_LOG(LogAsyncLoadingStressTest, Error, TEXT("run %d: %s wasn't loaded on the async loading thread"), Run, *Loaded.Key);
+				++NumMismatches;
+			}
+		}
+
+		UE_LOG(LogAsyncLoadingStressTest, Display, TEXT("run %d: %d packages loaded at once with %d workers in %.3fs, %d mismatches"), Run, PackageNames.Num(), Workers, Time, NumMismatches);
+		NumErrors += NumMismatches;
+		++NumRunsCompleted;
+	}
+	WorkersVar->Set(PreviousWorkers);
+
+	if (NumRunsCompleted < Runs)
+	{
+		UE_LOG(LogAsyncLoadingStressTest, Error, TEXT("Only %d of %d runs were completed, the packages could not be unloaded"), NumRunsCompleted, Runs);
+		++NumErrors;
+	}
+
+	return NumErrors ? 1 : 0;
+}
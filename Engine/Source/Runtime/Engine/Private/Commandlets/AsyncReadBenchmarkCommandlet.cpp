@@ -0,0 +1,149 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	AsyncReadBenchmarkCommandlet.cpp: Commandlet used for measuring async file
+	read throughput at various queue depths.
+=============================================================================*/
+
+#include "Commandlets/AsyncReadBenchmarkCommandlet.h"
+#include "Async/AsyncFileHandle.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogAsyncReadBenchmark, Log, All);
+
+/**
+ * UAsyncReadBenchmarkCommandlet
+ *
+ * Usage:
+ *	AsyncReadBenchmark -File=<file>
+ *
+ * Optional parameters:
+ *	-BlockSizeKB=N: Size of each read (default 64)
+ *	-QueueDepths=1,4,16,64: Numbers of reads kept in flight to measure
+ *	-MB=N: Amount read per configuration, at most the size of the file (default 1024)
+ *	-Random: Reads blocks at random offsets instead of front to back
+ *
+ * On Unix each configuration is measured with io_uring (unix.IoUring) off and on. Reads after the first configuration
+ * come from the page cache unless the file is bigger than memory, drop it between runs for cold numbers
+ * (echo 3 > /proc/sys/vm/drop_caches).
+ */
+
+UAsyncReadBenchmarkCommandlet::UAsyncReadBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+/** Reads NumBlocks blocks keeping QueueDepth reads in flight, returns the time it took in seconds */
+static double TimeReads(IAsyncReadFileHandle& Handle, const TArray<int64>& BlockOffsets, int64 BlockSize, int32 QueueDepth)
+{
+	TArray<uint8*> Buffers;
+	TArray<IAsyncReadRequest*> Requests;
+	for (int32 Index = 0; Index < QueueDepth; ++Index)
+	{
+		Buffers.Add((uint8*)FMemory::Malloc(BlockSize));
+		Requests.Add(nullptr);
+	}
+
+	// Requests complete in any order, the oldest is waited for before its slot is reused
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 BlockIndex = 0; BlockIndex < BlockOffsets.Num() + QueueDepth; ++BlockIndex)
+	{
+		const int32 Slot = BlockIndex % QueueDepth;
+		if (IAsyncReadRequest* Request = Requests[Slot])
+		{
+			Request->WaitCompletion();
+			verify(Request->GetReadResults() == Buffers[Slot]);
+			delete Request;
+			Requests[Slot] = nullptr;
+		}
+		if (BlockIndex < BlockOffsets.Num())
+		{
+			Requests[Slot] = Handle.ReadRequest(BlockOffsets[BlockIndex], BlockSize, AIOP_Normal, nullptr, Buffers[Slot]);
+		}
+	}
+	const double Time = FPlatformTime::Seconds() - StartTime;
+
+	for (uint8* Buffer : Buffers)
+	{
+		FMemory::Free(Buffer);
+	}
+	return Time;
+}
+
+int32 UAsyncReadBenchmarkCommandlet::Main(const FString& Params)
+{
+	const TCHAR* ParamStr = *Params;
+
+	FString Filename;
+	int32 BlockSizeKB = 64;
+	FString QueueDepthsList = TEXT("1,4,16,64");
+	int32 MegaBytes = 1024;
+	FParse::Value(ParamStr, TEXT("File="), Filename);
+	FParse::Value(ParamStr, TEXT("BlockSizeKB="), BlockSizeKB);
+	FParse::Value(ParamStr, TEXT("QueueDepths="), QueueDepthsList);
+	FParse::Value(ParamStr, TEXT("MB="), MegaBytes);
+	const bool bRandom = FParse::Param(ParamStr, TEXT("Random"));
+	const int64 BlockSize = (int64)FMath::Max(BlockSizeKB, 1) * 1024;
+
+	TArray<FString> QueueDepthStrings;
+	QueueDepthsList.ParseIntoArray(QueueDepthStrings, TEXT(","));
+	TArray<int32> QueueDepths;
+	for (const FString& QueueDepthString : QueueDepthStrings)
+	{
+		QueueDepths.Add(FMath::Max(FCString::Atoi(*QueueDepthString), 1));
+	}
+
+	IPlatformFile& PlatformFile = IPlatformFile::GetPlatformPhysical();
+	const int64 FileSize = Filename.IsEmpty() ? -1 : PlatformFile.FileSize(*Filename);
+	if (FileSize < BlockSize)
+	{
+		UE_LOG(LogAsyncReadBenchmark, Error, TEXT("Usage: AsyncReadBenchmark -File=<file of at least one block> [-BlockSizeKB=N] [-QueueDepths=1,4,16,64] [-MB=N] [-Random]"));
+		return 1;
+	}
+
+	const int64 NumFileBlocks = FileSize / BlockSize;
+	const int32 NumBlocks = (int32)FMath::Min<int64>(NumFileBlocks, FMath::Max<int64>((int64)MegaBytes * 1024 * 1024 / BlockSize, 1));
+	FRandomStream Random(0);
+	TArray<int64> BlockOffsets;
+	for (int32 BlockIndex = 0; BlockIndex < NumBlocks; ++BlockIndex)
+	{
+		BlockOffsets.Add((bRandom ? (int64)(Random.GetFraction() * NumFileBlocks) : BlockIndex) * BlockSize);
+	}
+	UE_LOG(LogAsyncReadBenchmark, Display, TEXT("%s: %d %s reads of %lld KB"), *Filename, NumBlocks, bRandom ? TEXT("random") : TEXT("sequential"), BlockSize / 1024);
+
+	// Only platforms with an alternative to the generic async file handle have this
+	IConsoleVariable* IoUringVar = IConsoleManager::Get().FindConsoleVariable(TEXT("unix.IoUring"));
+	const int32 PreviousIoUring = IoUringVar ? IoUringVar->GetInt() : 0;
+
+	for (int32 QueueDepth : QueueDepths)
+	{
+		for (int32 IoUring = 0; IoUring < (IoUringVar ? 2 : 1); ++IoUring)
+		{
+			if (IoUringVar)
+			{
+				IoUringVar->Set(IoUring);
+			}
+			TUniquePtr<IAsyncReadFileHandle> Handle(PlatformFile.OpenAsyncRead(*Filename));
+			const double Time = TimeReads(*Handle, BlockOffsets, BlockSize, QueueDepth);
+			UE_LOG(LogAsyncReadBenchmark, Display, TEXT("queue depth %3d%s: %8.1f MB/s, %8.0f reads/s"),
+				QueueDepth,
+				!IoUringVar ? TEXT("") : IoUring ? TEXT(", io_uring   ") : TEXT(", thread pool"),
+				NumBlocks * BlockSize / Time / (1024.0 * 1024.0),
+				NumBlocks / Time);
+		}
+	}
+
+	if (IoUringVar)
+	{
+		IoUringVar->Set(PreviousIoUring);
+	}
+	return 0;
+}
@@ -0,0 +1,297 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	CompressionBenchmarkCommandlet.cpp: Commandlet used for measuring the
+	compression ratio and speed of compression formats on cooked content.
+=============================================================================*/
+
+#include "Commandlets/CompressionBenchmarkCommandlet.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Serialization/ArchiveLoadCompressedProxy.h"
+#include "Serialization/ArchiveSaveCompressedProxy.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogCompressionBenchmark, Log, All);
+
+/**
+ * UCompressionBenchmarkCommandlet
+ *
+ * Usage:
+ *	CompressionBenchmark -Dir=<cooked content directory>
+ *
+ * Optional parameters:
+ *	-Files=<wildcard>: Files to read from the directory and its subdirectories (default *.*)
+ *	-Formats=Zlib,Zstd,LZ4: Formats to measure, formats that aren't available are skipped
+ *	-ChunkSizeKB=N: Size the files are split into before compressing, like pak compression blocks (default 64)
+ *	-MB=N: Amount of content to read, at most (default 256)
+ *	-DictionaryKB=N: Also trains a Zstd dictionary of this size on the content and measures it as Zstd+Dict
+ *	-ProxySizes=100,500,2000: Instead measures FArchiveSaveCompressedProxy and FArchiveLoadCompressedProxy on payloads of
+ *		these sizes in MB, made by repeating the content, with each of the -ProxyChunksInFlight=0,1,2,4,8,16 settings of
+ *		Compression.ProxyChunksInFlight and the first of -Formats. Compressed payloads must stay below 2 GB.
+ *
+ * Each format is measured with no flags, COMPRESS_BiasSpeed and COMPRESS_BiasMemory. Chunks that don't get smaller are
+ * counted at their uncompressed size, as paks store them. A dictionary is measured on the same content it was trained
+ * on, which flatters it, point -Dir at a different cook of the same project to train on for a fair number.
+ */
+
+UCompressionBenchmarkCommandlet::UCompressionBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+/** Compresses and uncompresses every chunk with one format, logs ratio and speed, returns false if a chunk didn't survive */
+static bool BenchmarkFormat(FName FormatName, const TCHAR* DisplayName, ECompressionFlags Flags, const TArray<TArray<uint8>>& Chunks, int64 TotalSize)
+{
+	TArray<TArray<uint8>> CompressedChunks;
+	CompressedChunks.SetNum(Chunks.Num());
+	for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ++ChunkIndex)
+	{
+		CompressedChunks[ChunkIndex].SetNumUninitialized(FCompression::CompressMemoryBound(FormatName, Chunks[ChunkIndex].Num(), Flags));
+	}
+
+	// Buffers are allocated up front so only the compressor is timed
+	int64 CompressedTotalSize = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ++ChunkIndex)
+	{
+		TArray<uint8>& Compressed = CompressedChunks[ChunkIndex];
+		int32 CompressedSize = Compressed.Num();
+		if (!FCompression::CompressMemory(FormatName, Compressed.GetData(), CompressedSize, Chunks[ChunkIndex].GetData(), Chunks[ChunkIndex].Num(), Flags))
+		{
+			UE_LOG(LogCompressionBenchmark, Error, TEXT("%s failed to compress chunk %d"), DisplayName, ChunkIndex);
+			return false;
+		}
+		Compressed.SetNum(CompressedSize, false);
+		CompressedTotalSize += FMath::Min(CompressedSize, Chunks[ChunkIndex].Num());
+	}
+	const double CompressTime = FPlatformTime::Seconds() - StartTime;
+
+	TArray<uint8> Uncompressed;
+	double UncompressTime = 0.0;
+	for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ++ChunkIndex)
+	{
+		const TArray<uint8>& Chunk = Chunks[ChunkIndex];
+		Uncompressed.SetNumUninitialized(Chunk.Num(), false);
+
+		StartTime = FPlatformTime::Seconds();
+		const bool bUncompressed = FCompression::UncompressMemory(FormatName, Uncompressed.GetData(), Uncompressed.Num(), CompressedChunks[ChunkIndex].GetData(), CompressedChunks[ChunkIndex].Num(), Flags);
+		UncompressTime += FPlatformTime::Seconds() - StartTime;
+
+		if (!bUncompressed || Uncompressed != Chunk)
+		{
+			UE_LOG(LogCompressionBenchmark, Error, TEXT("%s failed to round trip chunk %d"), DisplayName, ChunkIndex);
+			return false;
+		}
+	}
+
+	const double MegaBytes = TotalSize / (1024.0 * 1024.0);
+	UE_LOG(LogCompressionBenchmark, Display, TEXT("%-12s %-16s ratio %6.2f%%, compress %8.1f MB/s, uncompress %8.1f MB/s"),
+		DisplayName,
+		(Flags & COMPRESS_BiasSpeed) ? TEXT("BiasSpeed") : (Flags & COMPRESS_BiasMemory) ? TEXT("BiasMemory") : TEXT("NoFlags"),
+		100.0 * CompressedTotalSize / TotalSize,
+		MegaBytes / CompressTime,
+		MegaBytes / UncompressTime);
+	return true;
+}
+
+/** Saves and loads PayloadSize bytes of the chunks repeated through the compressed proxies, logs their throughput */
+static bool BenchmarkProxy(FName FormatName, int64 PayloadSize, const TArray<TArray<uint8>>& Chunks)
+{
+	TArray<uint8> CompressedData;
+	double StartTime = FPlatformTime::Seconds();
+	{
+		FArchiveSaveCompressedProxy SaveProxy(CompressedData, FormatName);
+		for (int64 Offset = 0, ChunkIndex = 0; Offset < PayloadSize; ++ChunkIndex)
+		{
+			const TArray<uint8>& Chunk = Chunks[ChunkIndex % Chunks.Num()];
+			const int64 Size = FMath::Min<int64>(Chunk.Num(), PayloadSize - Offset);
+			SaveProxy.Serialize((void*)Chunk.GetData(), Size);
+			Offset += Size;
+		}
+	}
+	const double SaveTime = FPlatformTime::Seconds() - StartTime;
+
+	TArray<uint8> Uncompressed;
+	bool bMatches = true;
+	StartTime = FPlatformTime::Seconds();
+	{
+		FArchiveLoadCompressedProxy LoadProxy(CompressedData, FormatName);
+		for (int64 Offset = 0, ChunkIndex = 0; Offset < PayloadSize; ++ChunkIndex)
+		{
+			const TArray<uint8>& Chunk = Chunks[ChunkIndex % Chunks.Num()];
+			const int32 Size = (int32)FMath::Min<int64>(Chunk.Num(), PayloadSize - Offset);
+			Uncompressed.SetNumUninitialized(Size, false);
+			LoadProxy.Serialize(Uncompressed.GetData(), Size);
+			bMatches &= FMemory::Memcmp(Uncompressed.GetData(), Chunk.GetData(), Size) == 0;
+			Offset += Size;
+		}
+	}
+	const double LoadTime = FPlatformTime::Seconds() - StartTime;
+
+	const double MegaBytes = PayloadSize / (1024.0 * 1024.0);
+	UE_LOG(LogCompressionBenchmark, Display, TEXT("%8.0f MB, %2d chunks in flight: ratio %6.2f%%, save %8.1f MB/s, load %8.1f MB/s"),
+		MegaBytes,
+		IConsoleManager::Get().FindConsoleVariable(TEXT("Compression.ProxyChunksInFlight"))->GetInt(),
+		100.0 * CompressedData.Num() / PayloadSize,
+		MegaBytes / SaveTime,
+		MegaBytes / LoadTime);
+	UE_CLOG(!bMatches, LogCompressionBenchmark, Error, TEXT("The loaded payload doesn't match the saved one"));
+	return bMatches;
+}
+
+int32 UCompressionBenchmarkCommandlet::Main(const FString& Params)
+{
+	const TCHAR* ParamStr = *Params;
+
+	FString Directory;
+	FString Wildcard = TEXT("*.*");
+	FString FormatList = TEXT("Zlib,Zstd,LZ4");
+	int32 ChunkSizeKB = 64;
+	int32 MegaBytes = 256;
+	int32 DictionaryKB = 0;
+	FString ProxyMegaBytesList;
+	FString ProxyChunksInFlightList = TEXT("0,1,2,4,8,16");
+	FParse::Value(ParamStr, TEXT("Dir="), Directory);
+	FParse::Value(ParamStr, TEXT("Files="), Wildcard);
+	FParse::Value(ParamStr, TEXT("Formats="), FormatList);
+	FParse::Value(ParamStr, TEXT("ChunkSizeKB="), ChunkSizeKB);
+	FParse::Value(ParamStr, TEXT("MB="), MegaBytes);
+	FParse::Value(ParamStr, TEXT("DictionaryKB="), DictionaryKB);
+	FParse::Value(ParamStr, TEXT("ProxySizes="), ProxyMegaBytesList);
+	FParse::Value(ParamStr, TEXT("ProxyChunksInFlight="), ProxyChunksInFlightList);
+	const int32 ChunkSize = FMath::Max(ChunkSizeKB, 1) * 1024;
+	const int64 MaxTotalSize = (int64)FMath::Max(MegaBytes, 1) * 1024 * 1024;
+
+	TArray<FString> Filenames;
+	if (!Directory.IsEmpty())
+	{
+		IFileManager::Get().FindFilesRecursive(Filenames, *Directory, *Wildcard, true, false);
+	}
+	if (Filenames.Num() == 0)
+	{
+		UE_LOG(LogCompressionBenchmark, Error, TEXT("Usage: CompressionBenchmark -Dir=<cooked content directory> [-Files=<wildcard>] [-Formats=Zlib,Zstd,LZ4] [-ChunkSizeKB=N] [-MB=N] [-DictionaryKB=N] [-ProxySizes=N,N] [-ProxyChunksInFlight=N,N]"));
+		return 1;
+	}
+	Filenames.Sort();
+
+	// Files are split at chunk boundaries like pak entries, so the last chunk of each file is usually short
+	TArray<TArray<uint8>> Chunks;
+	int64 TotalSize = 0;
+	int32 NumFiles = 0;
+	TArray<uint8> FileData;
+	for (const FString& Filename : Filenames)
+	{
+		if (TotalSize >= MaxTotalSize)
+		{
+			break;
+		}
+		if (!FFileHelper::LoadFileToArray(FileData, *Filename) || FileData.Num() == 0)
+		{
+			continue;
+		}
+		++NumFiles;
+		for (int32 Offset = 0; Offset < FileData.Num() && TotalSize < MaxTotalSize; Offset += ChunkSize)
+		{
+			const int32 Size = (int32)FMath::Min<int64>(FMath::Min(ChunkSize, FileData.Num() - Offset), MaxTotalSize - TotalSize);
+			Chunks.Emplace(FileData.GetData() + Offset, Size);
+			TotalSize += Size;
+		}
+	}
+	if (TotalSize == 0)
+	{
+		UE_LOG(LogCompressionBenchmark, Error, TEXT("No content could be read from %s"), *Directory);
+		return 1;
+	}
+	UE_LOG(LogCompressionBenchmark, Display, TEXT("%s: %d files, %.1f MB in %d chunks of up to %d KB"), *Directory, NumFiles, TotalSize / (1024.0 * 1024.0), Chunks.Num(), ChunkSize / 1024);
+
+	TArray<FString> FormatStrings;
+	FormatList.ParseIntoArray(FormatStrings, TEXT(","));
+	TArray<TPair<FName, FString>> Formats;
+	for (const FString& FormatString : FormatStrings)
+	{
+		const FName FormatName(*FormatString);
+		if (FCompression::IsFormatValid(FormatName))
+		{
+			Formats.Emplace(FormatName, FormatString);
+		}
+		else
+		{
+			UE_LOG(LogCompressionBenchmark, Warning, TEXT("Skipping %s, the format is not available"), *FormatString);
+		}
+	}
+
+	if (!ProxyMegaBytesList.IsEmpty())
+	{
+		if (Formats.Num() == 0)
+		{
+			return 1;
+		}
+		TArray<FString> ProxyMegaBytesStrings;
+		TArray<FString> ProxyChunksInFlightStrings;
+		ProxyMegaBytesList.ParseIntoArray(ProxyMegaBytesStrings, TEXT(","));
+		ProxyChunksInFlightList.ParseIntoArray(ProxyChunksInFlightStrings, TEXT(","));
+
+		IConsoleVariable* ChunksInFlightVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Compression.ProxyChunksInFlight"));
+		const int32 PreviousChunksInFlight = ChunksInFlightVar->GetInt();
+		UE_LOG(LogCompressionBenchmark, Display, TEXT("Compressed proxies with %s"), *Formats[0].Value);
+
+		bool bAllSucceeded = true;
+		for (const FString& ProxyMegaBytesString : ProxyMegaBytesStrings)
+		{
+			const int64 PayloadSize = FMath::Max<int64>(FCString::Atoi64(*ProxyMegaBytesString), 1) * 1024 * 1024;
+			for (const FString& ChunksInFlightString : ProxyChunksInFlightStrings)
+			{
+				ChunksInFlightVar->Set(FMath::Max(FCString::Atoi(*ChunksInFlightString), 0));
+				bAllSucceeded &= BenchmarkProxy(Formats[0].Key, PayloadSize, Chunks);
+			}
+		}
+
+		ChunksInFlightVar->Set(PreviousChunksInFlight);
+		return bAllSucceeded ? 0 : 1;
+	}
+
+	if (DictionaryKB > 0)
+	{
+		// Zstd recommends about 100 times the dictionary size of samples, spread them over all the content
+		const int64 MaxSampleSize = (int64)DictionaryKB * 1024 * 100;
+		const int32 SampleStride = FMath::Max((int32)(TotalSize / FMath::Max<int64>(MaxSampleSize, 1)), 1);
+		TArray<TArray<uint8>> Samples;
+		for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ChunkIndex += SampleStride)
+		{
+			Samples.Add(Chunks[ChunkIndex]);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		TArray<uint8> Dictionary;
+		const FName DictionaryFormatName(TEXT("Zstd_CompressionBenchmark"));
+		if (FCompression::TrainZstdDictionary(Dictionary, Samples, DictionaryKB * 1024) && FCompression::RegisterZstdDictionary(DictionaryFormatName, Dictionary.GetData(), Dictionary.Num()))
+		{
+			UE_LOG(LogCompressionBenchmark, Display, TEXT("Trained a %.1f KB dictionary on %d chunks in %.2f s"), Dictionary.Num() / 1024.0, Samples.Num(), FPlatformTime::Seconds() - StartTime);
+			Formats.Emplace(DictionaryFormatName, TEXT("Zstd+Dict"));
+		}
+		else
+		{
+			UE_LOG(LogCompressionBenchmark, Warning, TEXT("Skipping Zstd+Dict, unable to train a dictionary"));
+		}
+	}
+
+	const ECompressionFlags AllFlags[] = { COMPRESS_NoFlags, COMPRESS_BiasSpeed, COMPRESS_BiasMemory };
+	bool bAllSucceeded = true;
+	for (const TPair<FName, FString>& Format : Formats)
+	{
+		for (ECompressionFlags Flags : AllFlags)
+		{
+			bAllSucceeded &= BenchmarkFormat(Format.Key, *Format.Value, Flags, Chunks, TotalSize);
+		}
+	}
+
+	return bAllSucceeded ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	GCBenchmarkCommandlet.cpp: Commandlet used for measuring garbage collection
+	scaling on synthetic object graphs.
+=============================================================================*/
+
+#include "Commandlets/GCBenchmarkCommandlet.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/GarbageCollection.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGCBenchmark, Log, All);
+
+/**
+ * UGCBenchmarkCommandlet
+ *
+ * Usage:
+ *	GCBenchmark
+ *
+ * Optional parameters:
+ *	-Objects=N: Number of objects in each graph (default 1000000)
+ *	-Iterations=N: Number of garbage collections timed per task count (default 5)
+ *	-Tasks=4,8,16,32,64: Numbers of parallel reachability analysis tasks to measure, see gc.MaxParallelMarkTasks
+ *	-Graph=Wide|Deep|Clustered: Only measure one kind of graph
+ *
+ * The number of tasks is limited by the number of task graph worker threads, use -usehyperthreading
+ * on machines with many cores to get the most out of them.
+ */
+
+namespace GCBenchmark
+{
+	UGCBenchmarkObject* NewNode()
+	{
+		return NewObject<UGCBenchmarkObject>(GetTransientPackage());
+	}
+
+	/** A shallow graph with a very high fan out: root -> hubs -> leaves */
+	UGCBenchmarkObject* BuildWideGraph(int32 NumObjects, FRandomStream& Random)
+	{
+		const int32 NumHubs = 256;
+		UGCBenchmarkObject* Root = NewNode();
+		for (int32 HubIndex = 0; HubIndex < NumHubs; ++HubIndex)
+		{
+			Root->References.Add(NewNode());
+		}
+		for (int32 Index = NumHubs + 1; Index < NumObjects; ++Index)
+		{
+			UGCBenchmarkObject* Hub = CastChecked<UGCBenchmarkObject>(Root->References[Random.RandHelper(NumHubs)]);
+			Hub->References.Add(NewNode());
+		}
+		return Root;
+	}
+
+	/** A few long chains, each link referencing a handful of leaves: root -> chains -> (next link, leaves) */
+	UGCBenchmarkObject* BuildDeepGraph(int32 NumObjects, FRandomStream& Random)
+	{
+		const int32 NumChains = 64;
+		const int32 NumLeavesPerLink = 7;
+		UGCBenchmarkObject* Root = NewNode();
+		TArray<UGCBenchmarkObject*> ChainEnds;
+		for (int32 ChainIndex = 0; ChainIndex < NumChains; ++ChainIndex)
+		{
+			UGCBenchmarkObject* Link = NewNode();
+			Root->References.Add(Link);
+			ChainEnds.Add(Link);
+		}
+		for (int32 Index = NumChains + 1; Index < NumObjects; Index += NumLeavesPerLink + 1)
+		{
+			UGCBenchmarkObject*& ChainEnd = ChainEnds[Random.RandHelper(NumChains)];
+			UGCBenchmarkObject* Link = NewNode();
+			ChainEnd->References.Add(Link);
+			for (int32 LeafIndex = 0; LeafIndex < NumLeavesPerLink; ++LeafIndex)
+			{
+				ChainEnd->References.Add(NewNode());
+			}
+			ChainEnd = Link;
+		}
+		return Root;
+	}
+
+	/** Densely connected groups with sparse links between groups, only a fraction of the groups is directly reachable from the root */
+	UGCBenchmarkObject* BuildClusteredGraph(int32 NumObjects, FRandomStream& Random)
+	{
+		const int32 ObjectsPerGroup = 64;
+		const int32 ReferencesPerObject = 8;
+		const int32 GroupsPerRootReference = 16;
+		UGCBenchmarkObject* Root = NewNode();
+		UGCBenchmarkObject* PreviousGroupHead = nullptr;
+		TArray<UGCBenchmarkObject*> Group;
+		for (int32 GroupIndex = 0; GroupIndex * ObjectsPerGroup + 1 < NumObjects; ++GroupIndex)
+		{
+			Group.Reset();
+			for (int32 Index = 0; Index < ObjectsPerGroup; ++Index)
+			{
+				Group.Add(NewNode());
+			}
+			for (UGCBenchmarkObject* Member : Group)
+			{
+				for (int32 Index = 0; Index < ReferencesPerObject; ++Index)
+				{
+					Member->References.Add(Group[Random.RandHelper(ObjectsPerGroup)]);
+				}
+			}
+			if (GroupIndex % GroupsPerRootReference == 0)
+			{
+				Root->References.Add(Group[0]);
+			}
+			else
+			{
+				PreviousGroupHead->References.Add(Group[0]);
+			}
+			PreviousGroupHead = Group[0];
+		}
+		return Root;
+	}
+
+	struct FGraphDesc
+	{
+		const TCHAR* Name;
+		UGCBenchmarkObject* (*Build)(int32, FRandomStream&);
+	};
+}
+
+UGCBenchmarkCommandlet::UGCBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGCBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace GCBenchmark;
+
+	const TCHAR* ParamStr = *Params;
+
+	int32 NumObjects = 1000000;
+	int32 NumIterations = 5;
+	FString TasksList = TEXT("4,8,16,32,64");
+	FString GraphFilter;
+	FParse::Value(ParamStr, TEXT("Objects="), NumObjects);
+	FParse::Value(ParamStr, TEXT("Iterations="), NumIterations);
+	FParse::Value(ParamStr, TEXT("Tasks="), TasksList);
+	FParse::Value(ParamStr, TEXT("Graph="), GraphFilter);
+	NumObjects = FMath::Max(NumObjects, 1024);
+	NumIterations = FMath::Max(NumIterations, 1);
+
+	TArray<FString> TasksStrings;
+	TasksList.ParseIntoArray(TasksStrings, TEXT(","));
+	TArray<int32> TaskCounts;
+	for (const FString& TasksString : TasksStrings)
+	{
+		TaskCounts.Add(FMath::Max(FCString::Atoi(*TasksString), 1));
+	}
+
+	IConsoleVariable* MaxParallelMarkTasksVar = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.MaxParallelMarkTasks"));
+	if (!MaxParallelMarkTasksVar)
+	{
+		UE_LOG(LogGCBenchmark, Error, TEXT("gc.MaxParallelMarkTasks not found"));
+		return 1;
+	}
+	const int32 PreviousMaxParallelMarkTasks = MaxParallelMarkTasksVar->GetInt();
+
+	const int32 NumWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads() * (ENamedThreads::bHasBackgroundThreads ? 2 : 1);
+	UE_LOG(LogGCBenchmark, Display, TEXT("%d objects per graph, %d iterations, %d worker threads available"), NumObjects, NumIterations, NumWorkers);
+
+	const FGraphDesc Graphs[] =
+	{
+		{ TEXT("Wide"), &BuildWideGraph },
+		{ TEXT("Deep"), &BuildDeepGraph },
+		{ TEXT("Clustered"), &BuildClusteredGraph },
+	};
+
+	for (const FGraphDesc& Graph : Graphs)
+	{
+		if (GraphFilter.Len() && GraphFilter != Graph.Name)
+		{
+			continue;
+		}
+
+		FRandomStream Random(NumObjects);
+		double StartTime = FPlatformTime::Seconds();
+		UGCBenchmarkObject* Root = Graph.Build(NumObjects, Random);
+		Root->AddToRoot();
+		UE_LOG(LogGCBenchmark, Display, TEXT("%s: built graph in %.1f ms"), Graph.Name, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+		// Warm up, this also gets rid of anything left over by the previous graph
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+		for (int32 NumTasks : TaskCounts)
+		{
+			MaxParallelMarkTasksVar->Set(NumTasks);
+
+			double MinTime = MAX_dbl;
+			double TotalTime = 0.0;
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				StartTime = FPlatformTime::Seconds();
+				CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+				const double Time = FPlatformTime::Seconds() - StartTime;
+				MinTime = FMath::Min(MinTime, Time);
+				TotalTime += Time;
+			}
+
+			UE_LOG(LogGCBenchmark, Display, TEXT("%s: %2d tasks%s, GC min %.2f ms, avg %.2f ms"),
+				Graph.Name,
+				NumTasks,
+				NumTasks > NumWorkers ? TEXT(" (capped by worker threads)") : TEXT(""),
+				MinTime * 1000.0,
+				TotalTime * 1000.0 / NumIterations);
+		}
+
+		Root->RemoveFromRoot();
+	}
+
+	MaxParallelMarkTasksVar->Set(PreviousMaxParallelMarkTasks);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+	return 0;
+}
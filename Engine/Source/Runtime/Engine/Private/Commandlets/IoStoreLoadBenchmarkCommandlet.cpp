@@ -0,0 +1,113 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	IoStoreLoadBenchmarkCommandlet.cpp: Commandlet used for measuring what
+	loading bulk data in place from IoStore containers saves.
+=============================================================================*/
+
+#include "Commandlets/IoStoreLoadBenchmarkCommandlet.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogIoStoreLoadBenchmark, Log, All);
+
+/**
+ * UIoStoreLoadBenchmarkCommandlet
+ *
+ * Usage:
+ *	IoStoreLoadBenchmark -Package=<package name> -zenloader
+ *
+ * Optional parameters:
+ *	-Runs=N: Number of times the package is loaded with bulk data copied and in place (default 3)
+ *
+ * Bulk data is loaded in place with s.AdoptIoStoreBulkData. Memory is the growth in physical memory use while the package
+ * is loaded, which counts container pages once they are touched. The process peak only ever goes up, so it is logged
+ * when a load raised it.
+ */
+
+UIoStoreLoadBenchmarkCommandlet::UIoStoreLoadBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+/** Loads the package and unloads it again, returns the time it took to load in seconds and the memory it used while loaded */
+static double TimeLoad(const FString& PackageName, int64& OutUsedPhysical, int64& OutPeakUsedPhysical)
+{
+	const FPlatformMemoryStats StatsBefore = FPlatformMemory::GetStats();
+
+	const double StartTime = FPlatformTime::Seconds();
+	UPackage* Package = LoadPackage(nullptr, *PackageName, LOAD_None);
+	const double Time = FPlatformTime::Seconds() - StartTime;
+	UE_CLOG(!Package, LogIoStoreLoadBenchmark, Error, TEXT("Failed to load %s"), *PackageName);
+
+	const FPlatformMemoryStats StatsAfter = FPlatformMemory::GetStats();
+	OutUsedPhysical = (int64)StatsAfter.UsedPhysical - (int64)StatsBefore.UsedPhysical;
+	OutPeakUsedPhysical = StatsAfter.PeakUsedPhysical > StatsBefore.PeakUsedPhysical ? (int64)StatsAfter.PeakUsedPhysical - (int64)StatsBefore.UsedPhysical : 0;
+
+	Package = nullptr;
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	UE_CLOG(FindPackage(nullptr, *PackageName) != nullptr, LogIoStoreLoadBenchmark, Warning, TEXT("%s is still loaded after garbage collection, later loads will be quicker"), *PackageName);
+	return Time;
+}
+
+int32 UIoStoreLoadBenchmarkCommandlet::Main(const FString& Params)
+{
+	const TCHAR* ParamStr = *Params;
+
+	FString PackageName;
+	int32 Runs = 3;
+	FParse::Value(ParamStr, TEXT("Package="), PackageName);
+	FParse::Value(ParamStr, TEXT("Runs="), Runs);
+	Runs = FMath::Max(Runs, 1);
+
+	if (PackageName.IsEmpty())
+	{
+		UE_LOG(LogIoStoreLoadBenchmark, Error, TEXT("Usage: IoStoreLoadBenchmark -Package=<package name> -zenloader [-Runs=N]"));
+		return 1;
+	}
+	UE_CLOG(!FParse::Param(FCommandLine::Get(), TEXT("zenloader")), LogIoStoreLoadBenchmark, Warning, TEXT("Not loading from IoStore containers (-zenloader), bulk data is copied either way."));
+
+	IConsoleVariable* AdoptVar = IConsoleManager::Get().FindConsoleVariable(TEXT("s.AdoptIoStoreBulkData"));
+	check(AdoptVar);
+	const int32 PreviousAdopt = AdoptVar->GetInt();
+
+	// Alternate between the two so neither benefits from what is left in the OS file cache by the other more often
+	double TotalTime[2] = { 0.0, 0.0 };
+	double MinTime[2] = { MAX_dbl, MAX_dbl };
+	int64 MaxUsedPhysical[2] = { 0, 0 };
+	for (int32 Run = 0; Run < Runs; ++Run)
+	{
+		for (int32 Adopt = 0; Adopt < 2; ++Adopt)
+		{
+			AdoptVar->Set(Adopt);
+			int64 UsedPhysical = 0;
+			int64 PeakUsedPhysical = 0;
+			const double Time = TimeLoad(PackageName, UsedPhysical, PeakUsedPhysical);
+			TotalTime[Adopt] += Time;
+			MinTime[Adopt] = FMath::Min(MinTime[Adopt], Time);
+			MaxUsedPhysical[Adopt] = FMath::Max(MaxUsedPhysical[Adopt], UsedPhysical);
+			UE_LOG(LogIoStoreLoadBenchmark, Display, TEXT("run %d %s: %.3fs, %.1f MB used%s"),
+				Run,
+				Adopt ? TEXT("in place") : TEXT("copied  "),
+				Time,
+				UsedPhysical / (1024.0 * 1024.0),
+				PeakUsedPhysical ? *FString::Printf(TEXT(", new process peak %.1f MB above the start of the load"), PeakUsedPhysical / (1024.0 * 1024.0)) : TEXT(""));
+		}
+	}
+	AdoptVar->Set(PreviousAdopt);
+
+	UE_LOG(LogIoStoreLoadBenchmark, Display, TEXT("%s over %d runs: copied %.3fs average %.3fs best %.1f MB, in place %.3fs average %.3fs best %.1f MB"),
+		*PackageName, Runs,
+		TotalTime[0] / Runs, MinTime[0], MaxUsedPhysical[0] / (1024.0 * 1024.0),
+		TotalTime[1] / Runs, MinTime[1], MaxUsedPhysical[1] / (1024.0 * 1024.0));
+	return 0;
+}
@@ -0,0 +1,179 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	LinkerLoadBenchmarkCommandlet.cpp: Commandlet used for measuring where
+	synchronous package loading spends its time.
+=============================================================================*/
+
+#include "Commandlets/LinkerLoadBenchmarkCommandlet.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/PackageName.h"
+#include "Misc/Parse.h"
+#include "UObject/Linker.h"
+#include "UObject/LinkerImportCache.h"
+#include "UObject/LinkerLoad.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLinkerLoadBenchmark, Log, All);
+
+/**
+ * ULinkerLoadBenchmarkCommandlet
+ *
+ * Usage:
+ *	LinkerLoadBenchmark -Directory=<long package path or directory>
+ *
+ * Optional parameters:
+ *	-Runs=N: Number of times all packages are loaded with the import cache off and on (default 1)
+ *
+ * Each package is loaded through its linker in four timed phases:
+ *	Linker: creating the linker, reading the summary, name, import and export maps
+ *	Imports: verifying imports, which includes loading the packages they are in
+ *	Exports: creating and serializing every export
+ *	PostLoad: the end of the load, mostly PostLoad
+ * Packages that another package already loaded as a dependency take next to no time themselves. Garbage is collected
+ * between runs so every run loads the same packages. Needs the linker based loader, so it can't run on cooked content
+ * loaded by the event driven loader.
+ */
+
+ULinkerLoadBenchmarkCommandlet::ULinkerLoadBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+namespace LinkerLoadBenchmark
+{
+	enum EPhase
+	{
+		Linker,
+		Imports,
+		Exports,
+		PostLoad,
+		NumPhases
+	};
+
+	static const TCHAR* const PhaseNames[NumPhases] = { TEXT("Linker"), TEXT("Imports"), TEXT("Exports"), TEXT("PostLoad") };
+
+	/** Loads one package, adding the time each phase took to PhaseTimes. Returns false if the package has no linker. */
+	static bool LoadPackageTimed(const FString& PackageName, double (&PhaseTimes)[NumPhases])
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		double LinkerTime = StartTime;
+		double ImportsTime = StartTime;
+		double ExportsTime = StartTime;
+
+		// Imports are verified separately from creating the linker, so both phases can be timed
+		FLinkerLoad* PackageLinker = LoadPackageLinker(nullptr, *PackageName, LOAD_NoVerify, nullptr, nullptr, nullptr, [&](FLinkerLoad* LoadedLinker)
+		{
+			LinkerTime = FPlatformTime::Seconds();
+			ImportsTime = LinkerTime;
+			if (LoadedLinker)
+			{
+				LoadedLinker->LoadFlags &= ~LOAD_NoVerify;
+				LoadedLinker->Verify();
+				ImportsTime = FPlatformTime::Seconds();
+				LoadedLinker->LoadAllObjects(true);
+			}
+			ExportsTime = FPlatformTime::Seconds();
+		});
+		const double EndTime = FPlatformTime::Seconds();
+
+		PhaseTimes[Linker] += LinkerTime - StartTime;
+		PhaseTimes[Imports] += ImportsTime - LinkerTime;
+		PhaseTimes[Exports] += ExportsTime - ImportsTime;
+		PhaseTimes[PostLoad] += EndTime - ExportsTime;
+		return PackageLinker != nullptr;
+	}
+}
+
+int32 ULinkerLoadBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace LinkerLoadBenchmark;
+
+	const TCHAR* ParamStr = *Params;
+
+	FString Directory;
+	int32 Runs = 1;
+	FParse::Value(ParamStr, TEXT("Directory="), Directory);
+	FParse::Value(ParamStr, TEXT("Runs="), Runs);
+	Runs = FMath::Max(Runs, 1);
+
+	if (FPlatformProperties::RequiresCookedData() && IsEventDrivenLoaderEnabled())
+	{
+		UE_LOG(LogLinkerLoadBenchmark, Error, TEXT("Cooked packages are loaded by the event driven loader, run on uncooked content instead"));
+		return 1;
+	}
+
+	FString DirectoryPath;
+	if (!FPackageName::TryConvertLongPackageNameToFilename(Directory, DirectoryPath))
+	{
+		DirectoryPath = Directory;
+	}
+	TArray<FString> Filenames;
+	if (Directory.IsEmpty() || !FPackageName::FindPackagesInDirectory(Filenames, DirectoryPath))
+	{
+		UE_LOG(LogLinkerLoadBenchmark, Error, TEXT("Usage: LinkerLoadBenchmark -Directory=<long package path or directory with packages> [-Runs=N]"));
+		return 1;
+	}
+
+	TArray<FString> PackageNames;
+	for (const FString& Filename : Filenames)
+	{
+		FString PackageName;
+		if (FPackageName::TryConvertFilenameToLongPackageName(Filename, PackageName))
+		{
+			PackageNames.Add(PackageName);
+		}
+	}
+	PackageNames.Sort();
+	UE_LOG(LogLinkerLoadBenchmark, Display, TEXT("%s: %d packages"), *Directory, PackageNames.Num());
+
+	IConsoleVariable* ImportCacheVar = IConsoleManager::Get().FindConsoleVariable(TEXT("s.LinkerImportCache"));
+	check(ImportCacheVar);
+	const int32 PreviousImportCache = ImportCacheVar->GetInt();
+	FLinkerImportCache& ImportCache = FLinkerImportCache::Get();
+
+	for (int32 Run = 0; Run < Runs; ++Run)
+	{
+		for (int32 UseImportCache = 0; UseImportCache < 2; ++UseImportCache)
+		{
+			// Setting the cvar also empties the cache, so every run starts cold
+			ImportCacheVar->Set(UseImportCache);
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+			const int64 StartHits = ImportCache.GetNumHits();
+			const int64 StartMisses = ImportCache.GetNumMisses();
+			double PhaseTimes[NumPhases] = {};
+			int32 NumFailed = 0;
+			for (const FString& PackageName : PackageNames)
+			{
+				if (!LoadPackageTimed(PackageName, PhaseTimes))
+				{
+					++NumFailed;
+				}
+			}
+
+			double TotalTime = 0.0;
+			for (double PhaseTime : PhaseTimes)
+			{
+				TotalTime += PhaseTime;
+			}
+			UE_LOG(LogLinkerLoadBenchmark, Display, TEXT("Run %d, import cache %s: %.3fs, %.1f packages/s, %d failed to load, %lld import cache hits, %lld misses"),
+				Run, UseImportCache ? TEXT("on ") : TEXT("off"), TotalTime, PackageNames.Num() / FMath::Max(TotalTime, SMALL_NUMBER), NumFailed,
+				ImportCache.GetNumHits() - StartHits, ImportCache.GetNumMisses() - StartMisses);
+			for (int32 Phase = 0; Phase < NumPhases; ++Phase)
+			{
+				UE_LOG(LogLinkerLoadBenchmark, Display, TEXT("    %-8s %9.3f ms %5.1f%% %9.3f ms/package"),
+					PhaseNames[Phase], PhaseTimes[Phase] * 1000.0, 100.0 * PhaseTimes[Phase] / FMath::Max(TotalTime, SMALL_NUMBER), PhaseTimes[Phase] * 1000.0 / FMath::Max(PackageNames.Num(), 1));
+			}
+		}
+	}
+
+	ImportCacheVar->Set(PreviousImportCache);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	return 0;
+}
@@ -0,0 +1,198 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	PakIndexBenchmarkCommandlet.cpp: Commandlet used for measuring how long pak
+	files take to mount, how much memory their index keeps resident and how long
+	finding a file takes.
+=============================================================================*/
+
+#include "Commandlets/PakIndexBenchmarkCommandlet.h"
+#include "IPlatformFilePak.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPakIndexBenchmark, Log, All);
+
+/**
+ * UPakIndexBenchmarkCommandlet
+ *
+ * Usage:
+ *	PakIndexBenchmark -Pak=<pak file>[+<pak file>...]
+ *
+ * Optional parameters:
+ *	-Lookups=N: Number of random lookups of existing files, and again of missing files (default 1000000)
+ *	-Convert=<pak file>: Copies the first pak to this file with a path hash index and measures it as well.
+ *		The source pak must be unsigned, have an unencrypted index and the latest version before path hash indices.
+ *
+ * Resident memory is the change in used physical memory of the process, pages of a memory mapped path hash index
+ * count once they have been touched.
+ */
+
+UPakIndexBenchmarkCommandlet::UPakIndexBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+static bool ConvertPakIndex(IPlatformFile& PlatformFile, const FString& SourcePath, const FString& DestPath)
+{
+	FPakFile SourcePak(&PlatformFile, *SourcePath, false);
+	if (!SourcePak.IsValid())
+	{
+		UE_LOG(LogPakIndexBenchmark, Error, TEXT("Unable to open %s"), *SourcePath);
+		return false;
+	}
+	FPakInfo PakInfo = SourcePak.GetInfo();
+	if (PakInfo.Version != FPakInfo::PakFile_Version_FNameBasedCompressionMethod || PakInfo.bEncryptedIndex)
+	{
+		UE_LOG(LogPakIndexBenchmark, Error, TEXT("%s has version %d%s, only unencrypted indices of version %d can be converted"),
+			*SourcePath, PakInfo.Version, PakInfo.bEncryptedIndex ? TEXT(" and an encrypted index") : TEXT(""), (int32)FPakInfo::PakFile_Version_FNameBasedCompressionMethod);
+		return false;
+	}
+
+	const bool bIncludeDeleted = true;
+	TArray<FPakIndexEntry> Entries;
+	for (FPakFile::FFileIterator It(SourcePak, bIncludeDeleted); It; ++It)
+	{
+		FPakIndexEntry& IndexEntry = Entries.AddDefaulted_GetRef();
+		IndexEntry.Filename = It.Filename();
+		IndexEntry.Entry = It.Info();
+	}
+
+	TUniquePtr<FArchive> SourceAr(IFileManager::Get().CreateFileReader(*SourcePath));
+	TUniquePtr<FArchive> DestAr(IFileManager::Get().CreateFileWriter(*DestPath));
+	if (!SourceAr || !DestAr)
+	{
+		UE_LOG(LogPakIndexBenchmark, Error, TEXT("Unable to copy %s to %s"), *SourcePath, *DestPath);
+		return false;
+	}
+
+	// The file data stays where it is, only the index and the trailer are rewritten
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(1024 * 1024);
+	for (int64 Copied = 0; Copied < PakInfo.IndexOffset; )
+	{
+		const int64 CopySize = FMath::Min<int64>(Buffer.Num(), PakInfo.IndexOffset - Copied);
+		SourceAr->Serialize(Buffer.GetData(), CopySize);
+		DestAr->Serialize(Buffer.GetData(), CopySize);
+		Copied += CopySize;
+	}
+
+	FString MountPoint = SourcePak.GetMountPoint();
+	if (!FPakFile::WriteIndex(*DestAr, PakInfo, MountPoint, Entries) || !DestAr->Close())
+	{
+		UE_LOG(LogPakIndexBenchmark, Error, TEXT("Unable to write the index of %s"), *DestPath);
+		return false;
+	}
+	UE_LOG(LogPakIndexBenchmark, Display, TEXT("Wrote %s, version %d, %d entries, index %.1f KB"), *DestPath, PakInfo.Version, Entries.Num(), PakInfo.IndexSize / 1024.0);
+	return true;
+}
+
+static void BenchmarkPak(IPlatformFile& PlatformFile, const FString& PakPath, int32 NumLookups)
+{
+	const uint64 UsedPhysicalBeforeMount = FPlatformMemory::GetStats().UsedPhysical;
+	double StartTime = FPlatformTime::Seconds();
+	TUniquePtr<FPakFile> PakFile = MakeUnique<FPakFile>(&PlatformFile, *PakPath, false);
+	const double MountTime = FPlatformTime::Seconds() - StartTime;
+	const int64 MountMemory = (int64)FPlatformMemory::GetStats().UsedPhysical - (int64)UsedPhysicalBeforeMount;
+	if (!PakFile->IsValid())
+	{
+		UE_LOG(LogPakIndexBenchmark, Error, TEXT("Unable to mount %s"), *PakPath);
+		return;
+	}
+
+	// Directory iteration loads the directory index of paks with a path hash index
+	StartTime = FPlatformTime::Seconds();
+	PakFile->GetIndex();
+	const double DirectoryIndexTime = FPlatformTime::Seconds() - StartTime;
+	const int64 DirectoryIndexMemory = (int64)FPlatformMemory::GetStats().UsedPhysical - (int64)UsedPhysicalBeforeMount - MountMemory;
+
+	TArray<FString> Filenames;
+	PakFile->GetFilenames(Filenames);
+	if (Filenames.Num() == 0)
+	{
+		UE_LOG(LogPakIndexBenchmark, Error, TEXT("%s has no files"), *PakPath);
+		return;
+	}
+	TArray<FString> MissingFilenames;
+	MissingFilenames.Reserve(Filenames.Num());
+	for (const FString& Filename : Filenames)
+	{
+		MissingFilenames.Add(Filename + TEXT(".missing"));
+	}
+
+	FRandomStream Random(0);
+	TArray<int32> LookupOrder;
+	LookupOrder.SetNumUninitialized(NumLookups);
+	for (int32& FilenameIndex : LookupOrder)
+	{
+		FilenameIndex = Random.RandHelper(Filenames.Num());
+	}
+
+	auto TimeLookups = [&PakFile, &LookupOrder](const TArray<FString>& LookupFilenames, FPakFile::EFindResult ExpectedResult)
+	{
+		FPakEntry Entry;
+		int32 NumUnexpected = 0;
+		const double LookupStartTime = FPlatformTime::Seconds();
+		for (int32 FilenameIndex : LookupOrder)
+		{
+			NumUnexpected += PakFile->Find(LookupFilenames[FilenameIndex], &Entry) == ExpectedResult ? 0 : 1;
+		}
+		const double LookupTime = FPlatformTime::Seconds() - LookupStartTime;
+		UE_CLOG(NumUnexpected > 0, LogPakIndexBenchmark, Error, TEXT("%d lookups had an unexpected result"), NumUnexpected);
+		return LookupTime * 1000000000.0 / LookupOrder.Num();
+	};
+	const double HitNanoseconds = TimeLookups(Filenames, FPakFile::EFindResult::Found);
+	const double MissNanoseconds = TimeLookups(MissingFilenames, FPakFile::EFindResult::NotFound);
+
+	UE_LOG(LogPakIndexBenchmark, Display, TEXT("%s: version %d, %d files"), *PakPath, PakFile->GetInfo().Version, PakFile->GetNumFiles());
+	UE_LOG(LogPakIndexBenchmark, Display, TEXT("  mount %.2f ms, %.1f KB resident"), MountTime * 1000.0, MountMemory / 1024.0);
+	UE_LOG(LogPakIndexBenchmark, Display, TEXT("  directory index %.2f ms, %.1f KB resident"), DirectoryIndexTime * 1000.0, DirectoryIndexMemory / 1024.0);
+	UE_LOG(LogPakIndexBenchmark, Display, TEXT("  find %.1f ns per existing file, %.1f ns per missing file"), HitNanoseconds, MissNanoseconds);
+}
+
+int32 UPakIndexBenchmarkCommandlet::Main(const FString& Params)
+{
+	const TCHAR* ParamStr = *Params;
+
+	FString PakList;
+	FString ConvertPath;
+	int32 NumLookups = 1000000;
+	FParse::Value(ParamStr, TEXT("Pak="), PakList);
+	FParse::Value(ParamStr, TEXT("Convert="), ConvertPath);
+	FParse::Value(ParamStr, TEXT("Lookups="), NumLookups);
+	NumLookups = FMath::Max(NumLookups, 1);
+
+	TArray<FString> PakPaths;
+	PakList.ParseIntoArray(PakPaths, TEXT("+"));
+	if (PakPaths.Num() == 0)
+	{
+		UE_LOG(LogPakIndexBenchmark, Error, TEXT("Usage: PakIndexBenchmark -Pak=<pak file>[+<pak file>...] [-Lookups=N] [-Convert=<pak file>]"));
+		return 1;
+	}
+
+	// Measure the paks without the pak platform file in between
+	IPlatformFile& PlatformFile = IPlatformFile::GetPlatformPhysical();
+
+	if (!ConvertPath.IsEmpty())
+	{
+		if (!ConvertPakIndex(PlatformFile, PakPaths[0], ConvertPath))
+		{
+			return 1;
+		}
+		PakPaths.Add(ConvertPath);
+	}
+
+	for (const FString& PakPath : PakPaths)
+	{
+		BenchmarkPak(PlatformFile, PakPath, NumLookups);
+	}
+
+	return 0;
+}
@@ -0,0 +1,121 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	PakLoadOrderBenchmarkCommandlet.cpp: Commandlet used for measuring how much
+	replaying a recorded pak load order speeds up loading a package.
+=============================================================================*/
+
+#include "Commandlets/PakLoadOrderBenchmarkCommandlet.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPakLoadOrderBenchmark, Log, All);
+
+/**
+ * UPakLoadOrderBenchmarkCommandlet
+ *
+ * Usage:
+ *	PakLoadOrderBenchmark -Package=<package name> -LoadOrder=<file>
+ *
+ * Optional parameters:
+ *	-Runs=N: Number of times the package is loaded without and with the load order (default 3)
+ *
+ * Has to be run from pak files with the pak precacher enabled. If the load order file doesn't exist it is recorded by
+ * loading the package first, the same as running with -RecordPakLoadOrder=<file>. The pak cache is emptied between
+ * loads but the OS file cache is not, drop it or use files bigger than memory for cold numbers
+ * (echo 3 > /proc/sys/vm/drop_caches).
+ */
+
+UPakLoadOrderBenchmarkCommandlet::UPakLoadOrderBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+static bool ExecPakCommand(const FString& Command)
+{
+	return IConsoleManager::Get().ProcessUserConsoleInput(*Command, *GLog, nullptr);
+}
+
+/** Loads the package from an empty pak cache and unloads it again, returns the time it took to load in seconds */
+static double TimeLoad(const FString& PackageName)
+{
+	ExecPakCommand(TEXT("pak.DiscardCache"));
+
+	const double StartTime = FPlatformTime::Seconds();
+	UPackage* Package = LoadPackage(nullptr, *PackageName, LOAD_None);
+	const double Time = FPlatformTime::Seconds() - StartTime;
+	UE_CLOG(!Package, LogPakLoadOrderBenchmark, Error, TEXT("Failed to load %s"), *PackageName);
+
+	Package = nullptr;
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	UE_CLOG(FindPackage(nullptr, *PackageName) != nullptr, LogPakLoadOrderBenchmark, Warning, TEXT("%s is still loaded after garbage collection, later loads will be quicker"), *PackageName);
+	return Time;
+}
+
+int32 UPakLoadOrderBenchmarkCommandlet::Main(const FString& Params)
+{
+	const TCHAR* ParamStr = *Params;
+
+	FString PackageName;
+	FString LoadOrderFilename;
+	int32 Runs = 3;
+	FParse::Value(ParamStr, TEXT("Package="), PackageName);
+	FParse::Value(ParamStr, TEXT("LoadOrder="), LoadOrderFilename);
+	FParse::Value(ParamStr, TEXT("Runs="), Runs);
+	Runs = FMath::Max(Runs, 1);
+
+	if (PackageName.IsEmpty() || LoadOrderFilename.IsEmpty())
+	{
+		UE_LOG(LogPakLoadOrderBenchmark, Error, TEXT("Usage: PakLoadOrderBenchmark -Package=<package name> -LoadOrder=<file> [-Runs=N]"));
+		return 1;
+	}
+	// The pak.*LoadOrder commands only exist with the pak precacher
+	if (!FPlatformFileManager::Get().FindPlatformFile(TEXT("PakFile")) || !IConsoleManager::Get().FindConsoleObject(TEXT("pak.ReplayLoadOrder")))
+	{
+		UE_LOG(LogPakLoadOrderBenchmark, Error, TEXT("PakLoadOrderBenchmark has to be run from pak files with the pak precacher."));
+		return 1;
+	}
+
+	if (!FPaths::FileExists(LoadOrderFilename))
+	{
+		ExecPakCommand(TEXT("pak.RecordLoadOrder"));
+		const double Time = TimeLoad(PackageName);
+		ExecPakCommand(FString::Printf(TEXT("pak.SaveLoadOrder %s"), *LoadOrderFilename));
+		UE_LOG(LogPakLoadOrderBenchmark, Display, TEXT("%s: recorded the load order to %s in %.3fs"), *PackageName, *LoadOrderFilename, Time);
+	}
+
+	// Alternate between the two so neither benefits from what is left in the OS file cache by the other more often
+	double TotalTime[2] = { 0.0, 0.0 };
+	double MinTime[2] = { MAX_dbl, MAX_dbl };
+	for (int32 Run = 0; Run < Runs; ++Run)
+	{
+		for (int32 Replay = 0; Replay < 2; ++Replay)
+		{
+			if (Replay)
+			{
+				ExecPakCommand(FString::Printf(TEXT("pak.ReplayLoadOrder %s"), *LoadOrderFilename));
+			}
+			const double Time = TimeLoad(PackageName);
+			if (Replay)
+			{
+				ExecPakCommand(TEXT("pak.ReplayLoadOrder"));
+			}
+			TotalTime[Replay] += Time;
+			MinTime[Replay] = FMath::Min(MinTime[Replay], Time);
+			UE_LOG(LogPakLoadOrderBenchmark, Display, TEXT("run %d %s: %.3fs"), Run, Replay ? TEXT("with load order   ") : TEXT("without load order"), Time);
+		}
+	}
+
+	UE_LOG(LogPakLoadOrderBenchmark, Display, TEXT("%s over %d runs: without load order %.3fs average %.3fs best, with load order %.3fs average %.3fs best"),
+		*PackageName, Runs, TotalTime[0] / Runs, MinTime[0], TotalTime[1] / Runs, MinTime[1]);
+	return 0;
+}
@@ -0,0 +1,153 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	UObjectHashBenchmarkCommandlet.cpp: Commandlet used for measuring UObject
+	hash table lookup throughput while another thread modifies the tables.
+=============================================================================*/
+
+#include "Commandlets/UObjectHashBenchmarkCommandlet.h"
+#include "Commandlets/GCBenchmarkCommandlet.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Parse.h"
+#include "Async/Async.h"
+#include "Templates/Atomic.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/GarbageCollection.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogUObjectHashBenchmark, Log, All);
+
+/**
+ * UUObjectHashBenchmarkCommandlet
+ *
+ * Usage:
+ *	UObjectHashBenchmark
+ *
+ * Optional parameters:
+ *	-Objects=N: Number of objects the readers look up (default 100000)
+ *	-ChurnObjects=N: Number of objects the writer keeps renaming (default 1000)
+ *	-Readers=1,2,4,8: Numbers of reader threads to measure
+ *	-Seconds=N: How long each configuration runs (default 2)
+ *
+ * Each configuration is measured with lock free reads (s.LockFreeUObjectHashReads) off and on. Renaming unhashes
+ * and rehashes the object, so the game thread is the one churning writer.
+ */
+
+UUObjectHashBenchmarkCommandlet::UUObjectHashBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UUObjectHashBenchmarkCommandlet::Main(const FString& Params)
+{
+	const TCHAR* ParamStr = *Params;
+
+	int32 NumObjects = 100000;
+	int32 NumChurnObjects = 1000;
+	FString ReadersList = TEXT("1,2,4,8");
+	float Seconds = 2.0f;
+	FParse::Value(ParamStr, TEXT("Objects="), NumObjects);
+	FParse::Value(ParamStr, TEXT("ChurnObjects="), NumChurnObjects);
+	FParse::Value(ParamStr, TEXT("Readers="), ReadersList);
+	FParse::Value(ParamStr, TEXT("Seconds="), Seconds);
+	NumObjects = FMath::Max(NumObjects, 1);
+	NumChurnObjects = FMath::Max(NumChurnObjects, 1);
+
+	TArray<FString> ReadersStrings;
+	ReadersList.ParseIntoArray(ReadersStrings, TEXT(","));
+	TArray<int32> ReaderCounts;
+	for (const FString& ReadersString : ReadersStrings)
+	{
+		ReaderCounts.Add(FMath::Max(FCString::Atoi(*ReadersString), 1));
+	}
+
+	IConsoleVariable* LockFreeReadsVar = IConsoleManager::Get().FindConsoleVariable(TEXT("s.LockFreeUObjectHashReads"));
+	if (!LockFreeReadsVar)
+	{
+		UE_LOG(LogUObjectHashBenchmark, Error, TEXT("s.LockFreeUObjectHashReads not found"));
+		return 1;
+	}
+	const int32 PreviousLockFreeReads = LockFreeReadsVar->GetInt();
+
+	UPackage* Package = NewObject<UPackage>(nullptr, TEXT("/Temp/UObjectHashBenchmark"), RF_Transient);
+	Package->AddToRoot();
+	TArray<FName> Names;
+	for (int32 Index = 0; Index < NumObjects; ++Index)
+	{
+		Names.Add(NewObject<UGCBenchmarkObject>(Package, *FString::Printf(TEXT("Object_%d"), Index))->GetFName());
+	}
+	TArray<UGCBenchmarkObject*> ChurnObjects;
+	for (int32 Index = 0; Index < NumChurnObjects; ++Index)
+	{
+		ChurnObjects.Add(NewObject<UGCBenchmarkObject>(Package, *FString::Printf(TEXT("Churn_%d"), Index)));
+	}
+	UE_LOG(LogUObjectHashBenchmark, Display, TEXT("%d objects, %d churn objects, %.1f s per configuration"), NumObjects, NumChurnObjects, Seconds);
+
+	int64 NumRenames = 0;
+	for (int32 NumReaders : ReaderCounts)
+	{
+		for (int32 LockFreeReads = 0; LockFreeReads < 2; ++LockFreeReads)
+		{
+			LockFreeReadsVar->Set(LockFreeReads);
+
+			TAtomic<bool> bStop(false);
+			TArray<TFuture<int64>> Readers;
+			for (int32 ReaderIndex = 0; ReaderIndex < NumReaders; ++ReaderIndex)
+			{
+				Readers.Add(Async(EAsyncExecution::Thread, [&bStop, &Names, Package, ReaderIndex]()
+				{
+					// Objects can't be collected while readers hold on to them
+					FGCScopeGuard GCGuard;
+					FRandomStream Random(ReaderIndex);
+					int64 NumLookups = 0;
+					while (!bStop.Load(EMemoryOrder::Relaxed))
+					{
+						const FName Name = Names[Random.RandHelper(Names.Num())];
+						UObject* Found = StaticFindObjectFast(UGCBenchmarkObject::StaticClass(), Package, Name, true);
+						check(Found && Found->GetFName() == Name);
+						++NumLookups;
+					}
+					return NumLookups;
+				}));
+			}
+
+			const double StartTime = FPlatformTime::Seconds();
+			double Time = 0.0;
+			int64 NumRenamesThisRun = 0;
+			while (Time < Seconds)
+			{
+				UGCBenchmarkObject* Object = ChurnObjects[NumRenamesThisRun % NumChurnObjects];
+				Object->Rename(*FString::Printf(TEXT("Churn_%lld"), NumRenames++), nullptr, REN_DontCreateRedirectors | REN_ForceNoResetLoaders | REN_NonTransactional | REN_DoNotDirty);
+				++NumRenamesThisRun;
+				Time = FPlatformTime::Seconds() - StartTime;
+			}
+			bStop = true;
+
+			int64 NumLookups = 0;
+			for (TFuture<int64>& Reader : Readers)
+			{
+				NumLookups += Reader.Get();
+			}
+			Time = FPlatformTime::Seconds() - StartTime;
+
+			UE_LOG(LogUObjectHashBenchmark, Display, TEXT("%2d readers, %s: %.2f M lookups/s (%.2f M per reader), %.2f K renames/s"),
+				NumReaders,
+				LockFreeReads ? TEXT("lock free") : TEXT("locked   "),
+				NumLookups / Time / 1000000.0,
+				NumLookups / Time / 1000000.0 / NumReaders,
+				NumRenamesThisRun / Time / 1000.0);
+		}
+	}
+
+	LockFreeReadsVar->Set(PreviousLockFreeReads);
+	Package->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+	return 0;
+}
@@ -0,0 +1,1173 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	GridReplicationDriver.cpp: Replication driver gathering actors from a 2D grid.
+=============================================================================*/
+
+#include "Engine/GridReplicationDriver.h"
+#include "Components/SceneComponent.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/ChildConnection.h"
+#include "Engine/Level.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetworkObjectList.h"
+#include "Engine/World.h"
+#include "EngineLogs.h"
+#include "EngineStats.h"
+#include "GameFramework/GameNetworkManager.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGridReplicationDriver, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("Grid Update Cells Time"), STAT_GridRepDriverUpdateCellsTime, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Grid Replicate Actors Time"), STAT_GridRepDriverReplicateActorsTime, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Grid Cell Gathers"), STAT_GridRepDriverCellGathers, STATGROUP_Net);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Grid Shared Cell Gathers"), STAT_GridRepDriverSharedCellGathers, STATGROUP_Net);
+
+extern int32 GSetNetDormancyEnabled;
+
+namespace GridReplicationDriver
+{
+	/** How overdue actors without a channel on a connection are considered, so new actors go before actors that are just due */
+	static const float NewActorStarvation = 2.0f;
+
+	/** Priority multiplier of the actors a connection is viewing from */
+	static const float ViewerPriorityScale = 4.0f;
+
+	/** Connections that haven't received anything for this long aren't replicated to, like in UNetDriver::ServerReplicateActors */
+	static const float ConnectionReceiveTimeout = 1.5f;
+
+	/** Whether the actor is, owns, or is instigated by one of the viewers, which makes it relevant in AActor::IsNetRelevantFor */
+	static bool IsViewerActor(const AActor* Actor, const TArray<FNetViewer>& ConnectionViewers)
+	{
+		for (const FNetViewer& Viewer : ConnectionViewers)
+		{
+			if (Actor == Viewer.ViewTarget || Actor->IsOwnedBy(Viewer.ViewTarget) || Actor->IsOwnedBy(Viewer.InViewer) || Viewer.ViewTarget == Actor->GetInstigator())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Same as the hidden test of AActor::IsNetRelevantFor, hidden actors without collision aren't sent */
+	static bool IsHiddenForNet(const AActor* Actor)
+	{
+		const USceneComponent* RootComponent = Actor->GetRootComponent();
+		return Actor->IsHidden() && (!RootComponent || !RootComponent->IsCollisionEnabled());
+	}
+
+	/** AActor::IsNetRelevantFor for grid actors: the viewers' own actors first, then hidden actors, then distance */
+	static bool IsGridActorRelevant(const AActor* Actor, const TArray<FNetViewer>& ConnectionViewers)
+	{
+		if (IsViewerActor(Actor, ConnectionViewers))
+		{
+			return true;
+		}
+
+		if (IsHiddenForNet(Actor))
+		{
+			return false;
+		}
+
+		const FVector Location = Actor->GetActorLocation();
+		for (const FNetViewer& Viewer : ConnectionViewers)
+		{
+			if (FVector::DistSquared(Location, Viewer.ViewLocation) < Actor->NetCullDistanceSquared)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Owner relevancy actors and actors without a root component are as relevant as IsNetRelevantFor says */
+	static bool IsNetRelevantToViewers(const AActor* Actor, const TArray<FNetViewer>& ConnectionViewers)
+	{
+		for (const FNetViewer& Viewer : ConnectionViewers)
+		{
+			if (Actor->IsNetRelevantFor(Viewer.InViewer, Viewer.ViewTarget, Viewer.ViewLocation))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** The parent connection owning an owner only actor */
+	static UNetConnection* GetOwningConnection(const AActor* Actor)
+	{
+		UNetConnection* OwningConnection = Actor->GetNetConnection();
+		if (OwningConnection && OwningConnection->GetUChildConnection())
+		{
+			OwningConnection = OwningConnection->GetUChildConnection()->Parent;
+		}
+		return OwningConnection;
+	}
+
+	/** Same as the dormancy test of UNetDriver::ServerReplicateActors_PrioritizeActors */
+	static bool IsDormantOn(const FNetworkObjectInfo* NetworkObjectInfo, const TWeakObjectPtr<UNetConnection>& Connection)
+	{
+		return GSetNetDormancyEnabled != 0 && NetworkObjectInfo && NetworkObjectInfo->DormantConnections.Contains(Connection);
+	}
+}
+
+UGridReplicationDriver::UGridReplicationDriver()
+	: CellSize(10000.0f)
+	, MaxCellsPerActor(64)
+	, DistancePriorityScale(1.0f)
+	, CloseChannelsFrameInterval(15)
+	, NetDriver(nullptr)
+	, World(nullptr)
+	, ReplicationFrameRate(30.0f)
+{
+}
+
+void UGridReplicationDriver::SetRepDriverWorld(UWorld* InWorld)
+{
+	if (World != InWorld)
+	{
+		// The net driver resets its network object list without removing the actors one by one
+		ResetActors();
+	}
+
+	World = InWorld;
+}
+
+void UGridReplicationDriver::InitForNetDriver(UNetDriver* InNetDriver)
+{
+	NetDriver = InNetDriver;
+
+	if (CellSize <= 0.0f)
+	{
+		UE_LOG(LogGridReplicationDriver, Warning, TEXT("CellSize must be positive (%f), using 10000."), CellSize);
+		CellSize = 10000.0f;
+	}
+
+	MaxCellsPerActor = FMath::Max(MaxCellsPerActor, 1);
+	CloseChannelsFrameInterval = FMath::Max(CloseChannelsFrameInterval, 1);
+	ReplicationFrameRate = NetDriver && NetDriver->NetServerMaxTickRate > 0 ? (float)NetDriver->NetServerMaxTickRate : 30.0f;
+
+	if (NetDriver)
+	{
+		for (UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			AddClientConnection(Connection);
+		}
+	}
+}
+
+void UGridReplicationDriver::InitializeActorsInWorld(UWorld* InWorld)
+{
+	if (!NetDriver || !InWorld)
+	{
+		return;
+	}
+
+	for (const TSharedPtr<FNetworkObjectInfo>& ObjectInfo : NetDriver->GetNetworkObjectList().GetAllObjects())
+	{
+		if (AActor* Actor = ObjectInfo->Actor)
+		{
+			AddNetworkActor(Actor);
+		}
+	}
+
+	UE_LOG(LogGridReplicationDriver, Log, TEXT("Initialized %d actors, %d in %d cells of %.0f."), GetNumActors(), GetNumGridActors(), GetNumCells(), CellSize);
+}
+
+void UGridReplicationDriver::TearDown()
+{
+	ResetActors();
+	RemovedActorInfos.Empty();
+	ConnectionInfoMap.Empty();
+
+	NetDriver = nullptr;
+	World = nullptr;
+
+	Super::TearDown();
+}
+
+void UGridReplicationDriver::ResetGameWorldState()
+{
+	for (TPair<UNetConnection*, TUniquePtr<FGridConnectionInfo>>& Pair : ConnectionInfoMap)
+	{
+		Pair.Value->ActorInfos.Reset();
+	}
+}
+
+void UGridReplicationDriver::AddClientConnection(UNetConnection* NetConnection)
+{
+	if (NetConnection)
+	{
+		FindOrAddConnectionInfo(NetConnection);
+	}
+}
+
+void UGridReplicationDriver::RemoveClientConnection(UNetConnection* NetConnection)
+{
+	ConnectionInfoMap.Remove(NetConnection);
+}
+
+void UGridReplicationDriver::AddNetworkActor(AActor* Actor)
+{
+	if (!Actor || ActorInfoMap.Contains(Actor))
+	{
+		return;
+	}
+
+	// Like UNetDriver::ServerReplicateActors_BuildConsiderList, initially dormant map actors are left out until they're flushed,
+	// which adds them again.
+	if (Actor->NetDormancy == DORM_Initial && Actor->IsNetStartupActor())
+	{
+		return;
+	}
+
+	FGridActorInfo& ActorInfo = *ActorInfoMap.Add(Actor, MakeUnique<FGridActorInfo>());
+	ActorInfo.Actor = Actor;
+	ActorInfo.NetworkObjectInfo = NetDriver ? NetDriver->FindNetworkObjectInfo(Actor) : nullptr;
+	ActorInfo.Routing = RouteActor(Actor, ActorInfo.Team);
+
+	switch (ActorInfo.Routing)
+	{
+		case EActorRouting::AlwaysRelevant:
+			AlwaysRelevantActors.Add(&ActorInfo);
+			break;
+
+		case EActorRouting::OwnerOnly:
+			OwnerOnlyActors.Add(&ActorInfo);
+			break;
+
+		case EActorRouting::Team:
+			TeamActors.FindOrAdd(ActorInfo.Team).Add(&ActorInfo);
+			break;
+
+		case EActorRouting::OwnerRelevancy:
+			OwnerRelevancyActors.Add(&ActorInfo);
+			break;
+
+		default:
+		{
+			const USceneComponent* RootComponent = Actor->GetRootComponent();
+			ActorInfo.bIsStatic = RootComponent && RootComponent->Mobility == EComponentMobility::Static;
+
+			FIntPoint CellMin, CellMax;
+			if (!GetCellRange(Actor, CellMin, CellMax))
+			{
+				ActorInfo.bIsLarge = true;
+				LargeActors.Add(&ActorInfo);
+				break;
+			}
+
+			AddToCells(ActorInfo, CellMin, CellMax);
+			if (!ActorInfo.bIsStatic)
+			{
+				DynamicGridActors.Add(&ActorInfo);
+			}
+			break;
+		}
+	}
+}
+
+void UGridReplicationDriver::RemoveNetworkActor(AActor* Actor)
+{
+	TUniquePtr<FGridActorInfo> ActorInfo;
+	if (!ActorInfoMap.RemoveAndCopyValue(Actor, ActorInfo))
+	{
+		return;
+	}
+
+	switch (ActorInfo->Routing)
+	{
+		case EActorRouting::AlwaysRelevant:
+			AlwaysRelevantActors.RemoveSingleSwap(ActorInfo.Get(), false);
+			break;
+
+		case EActorRouting::OwnerOnly:
+			OwnerOnlyActors.RemoveSingleSwap(ActorInfo.Get(), false);
+			for (TPair<UNetConnection*, TUniquePtr<FGridConnectionInfo>>& Pair : ConnectionInfoMap)
+			{
+				Pair.Value->OwnedActors.RemoveSingleSwap(ActorInfo.Get(), false);
+			}
+			break;
+
+		case EActorRouting::Team:
+			if (TArray<FGridActorInfo*>* Actors = TeamActors.Find(ActorInfo->Team))
+			{
+				Actors->RemoveSingleSwap(ActorInfo.Get(), false);
+			}
+			break;
+
+		case EActorRouting::OwnerRelevancy:
+			OwnerRelevancyActors.RemoveSingleSwap(ActorInfo.Get(), false);
+			break;
+
+		default:
+			if (ActorInfo->bIsLarge)
+			{
+				LargeActors.RemoveSingleSwap(ActorInfo.Get(), false);
+			}
+			else
+			{
+				RemoveFromCells(*ActorInfo);
+				DynamicGridActors.Remove(ActorInfo.Get());
+			}
+			break;
+	}
+
+	for (TPair<UNetConnection*, TUniquePtr<FGridConnectionInfo>>& Pair : ConnectionInfoMap)
+	{
+		Pair.Value->ActorInfos.Remove(Actor);
+	}
+
+	// This can be called while replicating, from gameplay code. Gather lists and prioritized actors of this frame may still
+	// point to the info, so it's only freed next frame and skipped until then.
+	ActorInfo->Actor = nullptr;
+	ActorInfo->NetworkObjectInfo = nullptr;
+	RemovedActorInfos.Add(MoveTemp(ActorInfo));
+}
+
+void UGridReplicationDriver::ForceNetUpdate(AActor* Actor)
+{
+	if (TUniquePtr<FGridActorInfo>* ActorInfo = ActorInfoMap.Find(Actor))
+	{
+		// Connections that replicated the actor before the next frame send it again next frame
+		(*ActorInfo)->ForceNetUpdateFrame = NetDriver ? NetDriver->ReplicationFrame + 1 : 0;
+	}
+}
+
+void UGridReplicationDriver::FlushNetDormancy(AActor* Actor, bool WasDormInitial)
+{
+	// UNetDriver::FlushActorDormancyInternal wakes the actor up on every connection, it just needs to be sent soon
+	ForceNetUpdate(Actor);
+}
+
+void UGridReplicationDriver::NotifyActorTearOff(AActor* Actor)
+{
+	ForceNetUpdate(Actor);
+}
+
+void UGridReplicationDriver::NotifyActorFullyDormantForConnection(AActor* Actor, UNetConnection* Connection)
+{
+	// UNetDriver marks the actor dormant in FNetworkObjectInfo::DormantConnections, which ConsiderActor checks
+}
+
+void UGridReplicationDriver::NotifyActorDormancyChange(AActor* Actor, ENetDormancy OldDormancyState)
+{
+	ForceNetUpdate(Actor);
+}
+
+int32 UGridReplicationDriver::GetNumGridActors() const
+{
+	int32 NumGridActors = 0;
+	for (const TPair<AActor*, TUniquePtr<FGridActorInfo>>& Pair : ActorInfoMap)
+	{
+		NumGridActors += Pair.Value->Routing == EActorRouting::Grid ? 1 : 0;
+	}
+	return NumGridActors;
+}
+
+bool UGridReplicationDriver::IsActorInGrid(const AActor* Actor) const
+{
+	const TUniquePtr<FGridActorInfo>* ActorInfo = ActorInfoMap.Find(const_cast<AActor*>(Actor));
+	return ActorInfo && (*ActorInfo)->Routing == EActorRouting::Grid && !(*ActorInfo)->bIsLarge;
+}
+
+bool UGridReplicationDriver::IsActorRelevantToConnection(const AActor* Actor, UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers) const
+{
+	const TUniquePtr<FGridActorInfo>* ActorInfoPtr = ActorInfoMap.Find(const_cast<AActor*>(Actor));
+	if (!ActorInfoPtr)
+	{
+		return false;
+	}
+
+	// The same tests as the lists ReplicateConnection goes through
+	const FGridActorInfo& ActorInfo = **ActorInfoPtr;
+	switch (ActorInfo.Routing)
+	{
+		case EActorRouting::AlwaysRelevant:
+			return true;
+
+		case EActorRouting::OwnerOnly:
+			return Connection && GridReplicationDriver::GetOwningConnection(Actor) == Connection;
+
+		case EActorRouting::Team:
+			return ActorInfo.Team == GetConnectionTeam(Connection);
+
+		case EActorRouting::OwnerRelevancy:
+			return GridReplicationDriver::IsNetRelevantToViewers(Actor, ConnectionViewers);
+
+		default:
+			if (!ActorInfo.bIsLarge)
+			{
+				// Grid actors are only gathered from the cells the viewers are in
+				const bool bInViewerCell = ConnectionViewers.ContainsByPredicate([this, &ActorInfo](const FNetViewer& Viewer)
+				{
+					const FIntPoint Cell = GetCell(Viewer.ViewLocation);
+					return Cell.X >= ActorInfo.CellMin.X && Cell.X <= ActorInfo.CellMax.X && Cell.Y >= ActorInfo.CellMin.Y && Cell.Y <= ActorInfo.CellMax.Y;
+				});
+
+				if (!bInViewerCell)
+				{
+					return false;
+				}
+			}
+			return GridReplicationDriver::IsGridActorRelevant(Actor, ConnectionViewers);
+	}
+}
+
+bool UGridReplicationDriver::IsActorDormantOnConnection(const AActor* Actor, UNetConnection* Connection) const
+{
+	const TUniquePtr<FGridActorInfo>* ActorInfo = ActorInfoMap.Find(const_cast<AActor*>(Actor));
+	return ActorInfo && GridReplicationDriver::IsDormantOn((*ActorInfo)->NetworkObjectInfo, TWeakObjectPtr<UNetConnection>(Connection));
+}
+
+UGridReplicationDriver::EActorRouting UGridReplicationDriver::RouteActor(const AActor* Actor, int32& OutTeam) const
+{
+	OutTeam = INDEX_NONE;
+
+	if (Actor->bAlwaysRelevant)
+	{
+		return EActorRouting::AlwaysRelevant;
+	}
+
+	if (Actor->bOnlyRelevantToOwner)
+	{
+		return EActorRouting::OwnerOnly;
+	}
+
+	OutTeam = GetActorTeam(Actor);
+	if (OutTeam != INDEX_NONE)
+	{
+		return EActorRouting::Team;
+	}
+
+	if (Actor->bNetUseOwnerRelevancy && Actor->GetOwner())
+	{
+		return EActorRouting::OwnerRelevancy;
+	}
+
+	// Without a root component the actor has no location to put in the grid. IsNetRelevantFor only makes it
+	// relevant to the viewers that are, own or instigate it.
+	if (!Actor->GetRootComponent())
+	{
+		return EActorRouting::OwnerRelevancy;
+	}
+
+	return EActorRouting::Grid;
+}
+
+FIntPoint UGridReplicationDriver::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+bool UGridReplicationDriver::GetCellRange(const AActor* Actor, FIntPoint& OutMin, FIntPoint& OutMax) const
+{
+	const float CullDistance = FMath::Sqrt(Actor->NetCullDistanceSquared);
+
+	// Checked before converting to cells, so huge cull distances can't overflow
+	const float CellsPerSide = 2.0f * CullDistance / CellSize + 1.0f;
+	if (CellsPerSide * CellsPerSide > (float)MaxCellsPerActor)
+	{
+		return false;
+	}
+
+	const FVector Location = Actor->GetActorLocation();
+	OutMin = GetCell(Location - FVector(CullDistance, CullDistance, 0.0f));
+	OutMax = GetCell(Location + FVector(CullDistance, CullDistance, 0.0f));
+	return true;
+}
+
+bool UGridReplicationDriver::UpdateActorCells(FGridActorInfo& ActorInfo)
+{
+	FIntPoint CellMin, CellMax;
+	if (!GetCellRange(ActorInfo.Actor, CellMin, CellMax))
+	{
+		return false;
+	}
+
+	if (CellMin != ActorInfo.CellMin || CellMax != ActorInfo.CellMax)
+	{
+		RemoveFromCells(ActorInfo);
+		AddToCells(ActorInfo, CellMin, CellMax);
+	}
+	return true;
+}
+
+void UGridReplicationDriver::AddToCells(FGridActorInfo& ActorInfo, const FIntPoint& CellMin, const FIntPoint& CellMax)
+{
+	for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+	{
+		for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+		{
+			Cells.FindOrAdd(FIntPoint(X, Y)).Actors.Add(&ActorInfo);
+		}
+	}
+
+	ActorInfo.CellMin = CellMin;
+	ActorInfo.CellMax = CellMax;
+}
+
+void UGridReplicationDriver::RemoveFromCells(FGridActorInfo& ActorInfo)
+{
+	for (int32 Y = ActorInfo.CellMin.Y; Y <= ActorInfo.CellMax.Y; ++Y)
+	{
+		for (int32 X = ActorInfo.CellMin.X; X <= ActorInfo.CellMax.X; ++X)
+		{
+			const FIntPoint CellKey(X, Y);
+			if (FGridCell* Cell = Cells.Find(CellKey))
+			{
+				Cell->Actors.RemoveSingleSwap(&ActorInfo, false);
+				if (Cell->Actors.Num() == 0)
+				{
+					// Not removed right away, a connection may be going through its gather list
+					EmptyCells.Add(CellKey);
+				}
+			}
+		}
+	}
+
+	ActorInfo.CellMin = FIntPoint(0, 0);
+	ActorInfo.CellMax = FIntPoint(-1, -1);
+}
+
+bool UGridReplicationDriver::CanReplicateThisFrame(FGridActorInfo& ActorInfo)
+{
+	const uint32 Frame = NetDriver->ReplicationFrame;
+	if (ActorInfo.FilterFrame == Frame)
+	{
+		return ActorInfo.bCanReplicate;
+	}
+
+	ActorInfo.FilterFrame = Frame;
+	ActorInfo.bCanReplicate = false;
+
+	AActor* Actor = ActorInfo.Actor;
+	if (!Actor || Actor->IsPendingKillPending() || Actor->GetRemoteRole() == ROLE_None)
+	{
+		return false;
+	}
+
+	// This actor may belong to a different net driver (this can happen when using beacon net drivers for example)
+	if (Actor->GetNetDriverName() != NetDriver->NetDriverName)
+	{
+		return false;
+	}
+
+	// Verify the actor is actually initialized (it might have been intentionally spawn deferred until a later frame)
+	if (!Actor->IsActorInitialized())
+	{
+		return false;
+	}
+
+	// Don't send actors that may still be streaming in or out
+	ULevel* Level = Actor->GetLevel();
+	if (Level->HasVisibilityChangeRequestPending() || Level->bIsAssociatingLevel)
+	{
+		return false;
+	}
+
+	const float UpdatePeriod = ReplicationFrameRate / FMath::Max(Actor->NetUpdateFrequency, KINDA_SMALL_NUMBER);
+	ActorInfo.UpdatePeriod = (uint32)FMath::Clamp(FMath::RoundToInt(UpdatePeriod), 1, MAX_int32);
+
+	ActorInfo.bCanReplicate = true;
+	return true;
+}
+
+const TArray<UGridReplicationDriver::FGridActorInfo*>& UGridReplicationDriver::GatherCell(const FIntPoint& CellKey)
+{
+	static const TArray<FGridActorInfo*> NoActors;
+
+	FGridCell* Cell = Cells.Find(CellKey);
+	if (!Cell)
+	{
+		return NoActors;
+	}
+
+	const uint32 Frame = NetDriver->ReplicationFrame;
+	if (Cell->GatherFrame == Frame)
+	{
+		INC_DWORD_STAT(STAT_GridRepDriverSharedCellGathers);
+		return Cell->GatherList;
+	}
+
+	INC_DWORD_STAT(STAT_GridRepDriverCellGathers);
+
+	Cell->GatherFrame = Frame;
+	Cell->GatherList.Reset();
+	for (FGridActorInfo* ActorInfo : Cell->Actors)
+	{
+		if (CanReplicateThisFrame(*ActorInfo))
+		{
+			Cell->GatherList.Add(ActorInfo);
+		}
+	}
+
+	return Cell->GatherList;
+}
+
+void UGridReplicationDriver::PrepareConnections()
+{
+	// Same as UNetDriver::ServerReplicateActors_PrepConnections, without throttling the number of connections
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		check(Connection);
+
+		FindOrAddConnectionInfo(Connection);
+
+		AActor* OwningActor = Connection->OwningActor;
+		if (OwningActor && Connection->State == USOCK_Open && (NetDriver->Time - Connection->LastReceiveTime < GridReplicationDriver::ConnectionReceiveTimeout))
+		{
+			// The view target is what the player controller is looking at OR the owning actor itself when using beacons
+			AActor* DesiredViewTarget = OwningActor;
+			if (Connection->PlayerController)
+			{
+				AActor* ViewTarget = Connection->PlayerController->GetViewTarget();
+				if (ViewTarget && ViewTarget->GetWorld())
+				{
+					DesiredViewTarget = ViewTarget;
+				}
+			}
+			Connection->ViewTarget = DesiredViewTarget;
+
+			for (UNetConnection* Child : Connection->Children)
+			{
+				Child->ViewTarget = Child->PlayerController ? Child->PlayerController->GetViewTarget() : nullptr;
+			}
+		}
+		else
+		{
+			Connection->ViewTarget = nullptr;
+			for (UNetConnection* Child : Connection->Children)
+			{
+				Child->ViewTarget = nullptr;
+			}
+		}
+	}
+}
+
+void UGridReplicationDriver::BuildOwnedActorLists()
+{
+	for (TPair<UNetConnection*, TUniquePtr<FGridConnectionInfo>>& Pair : ConnectionInfoMap)
+	{
+		Pair.Value->OwnedActors.Reset();
+	}
+
+	for (FGridActorInfo* ActorInfo : OwnerOnlyActors)
+	{
+		UNetConnection* OwningConnection = GridReplicationDriver::GetOwningConnection(ActorInfo->Actor);
+		if (TUniquePtr<FGridConnectionInfo>* ConnectionInfo = OwningConnection ? ConnectionInfoMap.Find(OwningConnection) : nullptr)
+		{
+			(*ConnectionInfo)->OwnedActors.Add(ActorInfo);
+		}
+	}
+}
+
+int32 UGridReplicationDriver::ServerReplicateActors(float DeltaSeconds)
+{
+	if (!NetDriver || !World)
+	{
+		return 0;
+	}
+
+	RemovedActorInfos.Reset();
+
+	// Bump the ReplicationFrame value to invalidate any properties marked as "unchanged" for this frame.
+	NetDriver->ReplicationFrame++;
+	const uint32 Frame = NetDriver->ReplicationFrame;
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GridRepDriverUpdateCellsTime);
+
+		TArray<FGridActorInfo*, TInlineAllocator<8>> GrownActors;
+		for (FGridActorInfo* ActorInfo : DynamicGridActors)
+		{
+			if (!UpdateActorCells(*ActorInfo))
+			{
+				GrownActors.Add(ActorInfo);
+			}
+		}
+
+		// Actors whose NetCullDistance grew past MaxCellsPerActor leave the grid
+		for (FGridActorInfo* ActorInfo : GrownActors)
+		{
+			RemoveFromCells(*ActorInfo);
+			DynamicGridActors.Remove(ActorInfo);
+			ActorInfo->bIsLarge = true;
+			LargeActors.Add(ActorInfo);
+		}
+
+		for (const FIntPoint& CellKey : EmptyCells)
+		{
+			const FGridCell* Cell = Cells.Find(CellKey);
+			if (Cell && Cell->Actors.Num() == 0)
+			{
+				Cells.Remove(CellKey);
+			}
+		}
+		EmptyCells.Reset();
+	}
+
+	PrepareConnections();
+	BuildOwnedActorLists();
+
+	AWorldSettings* WorldSettings = World->GetWorldSettings();
+	TArray<FNetViewer>& ConnectionViewers = WorldSettings->ReplicationViewers;
+
+	int32 Updated = 0;
+
+	for (int32 ConnectionIndex = 0; ConnectionIndex < NetDriver->ClientConnections.Num(); ++ConnectionIndex)
+	{
+		UNetConnection* Connection = NetDriver->ClientConnections[ConnectionIndex];
+		if (!Connection->ViewTarget)
+		{
+			continue;
+		}
+
+		FGridConnectionInfo& ConnectionInfo = FindOrAddConnectionInfo(Connection);
+
+		const int32 LocalNumSaturated = GNumSaturatedConnections;
+
+		// Make a list of viewers this connection should consider (this connection and children of this connection)
+		ConnectionViewers.Reset();
+		new(ConnectionViewers) FNetViewer(Connection, DeltaSeconds);
+		for (UNetConnection* Child : Connection->Children)
+		{
+			if (Child->ViewTarget)
+			{
+				new(ConnectionViewers) FNetViewer(Child, DeltaSeconds);
+			}
+		}
+
+		// Send ClientAdjustment if necessary, at most one per packet
+		if (Connection->PlayerController)
+		{
+			Connection->PlayerController->SendClientAdjustment();
+		}
+
+		for (UNetConnection* Child : Connection->Children)
+		{
+			if (Child->PlayerController)
+			{
+				Child->PlayerController->SendClientAdjustment();
+			}
+		}
+
+		Updated += ReplicateConnection(ConnectionInfo, ConnectionViewers);
+
+		ConnectionViewers.Reset();
+
+		if ((Frame + ConnectionIndex) % CloseChannelsFrameInterval == 0)
+		{
+			CloseIrrelevantChannels(ConnectionInfo);
+		}
+
+		Connection->LastProcessedFrame = Frame;
+
+		const bool bWasSaturated = GNumSaturatedConnections > LocalNumSaturated;
+		Connection->TrackReplicationForAnalytics(bWasSaturated);
+	}
+
+	return Updated;
+}
+
+int32 UGridReplicationDriver::ReplicateConnection(FGridConnectionInfo& ConnectionInfo, const TArray<FNetViewer>& ConnectionViewers)
+{
+	UNetConnection* Connection = ConnectionInfo.Connection;
+
+	if (!Connection->IsNetReady(0))
+	{
+		// Connection saturated, nothing is gathered and whatever is due stays due
+		GNumSaturatedConnections++;
+		return 0;
+	}
+
+	SendDestructionInfos(Connection);
+
+	PrioritizedActors.Reset();
+	const int32 NumActorInfos = ConnectionInfo.ActorInfos.Num();
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_NetConsiderActorsTime);
+
+		AGameNetworkManager* const NetworkManager = World->NetworkManager;
+		const bool bLowNetBandwidth = NetworkManager ? NetworkManager->IsInLowBandwidthMode() : false;
+
+		for (FGridActorInfo* ActorInfo : AlwaysRelevantActors)
+		{
+			ConsiderActor(ConnectionInfo, ActorInfo, ConnectionViewers, bLowNetBandwidth);
+		}
+
+		for (FGridActorInfo* ActorInfo : ConnectionInfo.OwnedActors)
+		{
+			ConsiderActor(ConnectionInfo, ActorInfo, ConnectionViewers, bLowNetBandwidth);
+		}
+
+		const int32 Team = GetConnectionTeam(Connection);
+		if (const TArray<FGridActorInfo*>* Actors = Team != INDEX_NONE ? TeamActors.Find(Team) : nullptr)
+		{
+			for (FGridActorInfo* ActorInfo : *Actors)
+			{
+				ConsiderActor(ConnectionInfo, ActorInfo, ConnectionViewers, bLowNetBandwidth);
+			}
+		}
+
+		for (FGridActorInfo* ActorInfo : OwnerRelevancyActors)
+		{
+			if (CanReplicateThisFrame(*ActorInfo) && GridReplicationDriver::IsNetRelevantToViewers(ActorInfo->Actor, ConnectionViewers))
+			{
+				ConsiderActor(ConnectionInfo, ActorInfo, ConnectionViewers, bLowNetBandwidth);
+			}
+		}
+
+		for (FGridActorInfo* ActorInfo : LargeActors)
+		{
+			if (CanReplicateThisFrame(*ActorInfo) && GridReplicationDriver::IsGridActorRelevant(ActorInfo->Actor, ConnectionViewers))
+			{
+				ConsiderActor(ConnectionInfo, ActorInfo, ConnectionViewers, bLowNetBandwidth);
+			}
+		}
+
+		// Actors are in every cell within their cull distance, so the cell of each viewer has every grid actor that can be relevant to it
+		for (const FNetViewer& Viewer : ConnectionViewers)
+		{
+			for (FGridActorInfo* ActorInfo : GatherCell(GetCell(Viewer.ViewLocation)))
+			{
+				if (ActorInfo->Actor && GridReplicationDriver::IsGridActorRelevant(ActorInfo->Actor, ConnectionViewers))
+				{
+					ConsiderActor(ConnectionInfo, ActorInfo, ConnectionViewers, bLowNetBandwidth);
+				}
+			}
+		}
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_NetPrioritizeActorsTime);
+
+		// Adding actors to the map may have moved the ones already gathered
+		if (ConnectionInfo.ActorInfos.Num() != NumActorInfos)
+		{
+			for (FPrioritizedActor& PrioritizedActor : PrioritizedActors)
+			{
+				AActor* Actor = PrioritizedActor.ActorInfo->Actor;
+				PrioritizedActor.ConnectionActorInfo = Actor ? ConnectionInfo.ActorInfos.Find(Actor) : nullptr;
+			}
+		}
+
+		PrioritizedActors.Sort([](const FPrioritizedActor& A, const FPrioritizedActor& B) { return A.Priority > B.Priority; });
+
+		INC_DWORD_STAT_BY(STAT_PrioritizedActors, PrioritizedActors.Num());
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GridRepDriverReplicateActorsTime);
+
+	const uint32 Frame = NetDriver->ReplicationFrame;
+	int32 Updated = 0;
+
+	for (FPrioritizedActor& PrioritizedActor : PrioritizedActors)
+	{
+		FGridActorInfo* ActorInfo = PrioritizedActor.ActorInfo;
+		AActor* Actor = ActorInfo->Actor;
+		if (!Actor)
+		{
+			// Removed while replicating an actor before it
+			continue;
+		}
+
+		if (ActorInfo->PreReplicationFrame != Frame)
+		{
+			ActorInfo->PreReplicationFrame = Frame;
+			Actor->CallPreReplication(NetDriver);
+		}
+
+		UActorChannel* Channel = PrioritizedActor.Channel;
+		if (!Channel)
+		{
+			// The package map has to support the actor's class/archetype (or the actor itself in the case of serializable actors)
+			if (!NetDriver->GuidCache->SupportsObject(Actor->GetClass()) || !NetDriver->GuidCache->SupportsObject(Actor->IsNetStartupActor() ? Actor : Actor->GetArchetype()))
+			{
+				continue;
+			}
+
+			Channel = (UActorChannel*)Connection->CreateChannelByName(NAME_Actor, EChannelCreateFlags::OpenedLocally);
+			if (!Channel)
+			{
+				continue;
+			}
+
+			Channel->SetChannelActor(Actor, ESetChannelActorFlags::None);
+		}
+
+		Channel->RelevantTime = NetDriver->Time;
+
+		if (Channel->IsNetReady(0))
+		{
+			UE_LOG(LogNetTraffic, Log, TEXT("- Replicate %s. %f"), *Actor->GetName(), PrioritizedActor.Priority);
+
+			Channel->ReplicateActor();
+			Updated++;
+
+			if (ActorInfo->Actor && PrioritizedActor.ConnectionActorInfo)
+			{
+				PrioritizedActor.ConnectionActorInfo->LastReplicationFrame = Frame;
+			}
+		}
+
+		if (ActorInfo->Actor && Actor->GetTearOff() && (!NetDriver->IsLevelInitializedForActor(Actor, Connection) || !Actor->IsNetStartupActor()))
+		{
+			UE_LOG(LogNetTraffic, Log, TEXT("- Closing channel for torn off actor %s"), *Actor->GetName());
+			Channel->Close(EChannelCloseReason::TearOff);
+		}
+
+		if (!Connection->IsNetReady(0))
+		{
+			// Actors that didn't get sent stay due and will be more overdue next frame
+			GNumSaturatedConnections++;
+			break;
+		}
+	}
+
+	return Updated;
+}
+
+void UGridReplicationDriver::ConsiderActor(FGridConnectionInfo& ConnectionInfo, FGridActorInfo* ActorInfo, const TArray<FNetViewer>& ConnectionViewers, bool bLowNetBandwidth)
+{
+	if (!CanReplicateThisFrame(*ActorInfo))
+	{
+		return;
+	}
+
+	AActor* Actor = ActorInfo->Actor;
+	UNetConnection* Connection = ConnectionInfo.Connection;
+	const uint32 Frame = NetDriver->ReplicationFrame;
+
+	FGridConnectionActorInfo& ConnectionActorInfo = ConnectionInfo.ActorInfos.FindOrAdd(Actor);
+	if (ConnectionActorInfo.LastGatherFrame == Frame)
+	{
+		// Already gathered for another viewer of this connection
+		return;
+	}
+
+	ConnectionActorInfo.LastGatherFrame = Frame;
+	ConnectionActorInfo.LastRelevantTime = NetDriver->Time;
+
+	UActorChannel* Channel = ActorInfo->NetworkObjectInfo ? Connection->FindActorChannelRef(ActorInfo->NetworkObjectInfo->WeakActor) : Connection->FindActorChannelRef(Actor);
+	if (Channel)
+	{
+		if (!Channel->Actor)
+		{
+			// Closing
+			return;
+		}
+	}
+	else
+	{
+		// Torn off actors never open a channel again, and temporary actors only get one
+		if (Actor->GetTearOff() || (Actor->bNetTemporary && Connection->SentTemporaries.Contains(Actor)))
+		{
+			return;
+		}
+
+		// If the level this actor belongs to isn't loaded on client, don't bother sending
+		if (!NetDriver->IsLevelInitializedForActor(Actor, Connection))
+		{
+			return;
+		}
+	}
+
+	// Skip the actor if it's dormant on this connection
+	if (GridReplicationDriver::IsDormantOn(ActorInfo->NetworkObjectInfo, ConnectionInfo.WeakConnection))
+	{
+		return;
+	}
+
+	if (GSetNetDormancyEnabled != 0 && ActorInfo->NetworkObjectInfo)
+	{
+		// See if the actor wants to go dormant, the channel goes dormant once all properties have been replicated
+		if (Channel && Actor->NetDormancy > DORM_Awake && !Channel->bPendingDormancy && !Channel->Dormant)
+		{
+			bool bShouldGoDormant = true;
+			if (Actor->NetDormancy == DORM_DormantPartial)
+			{
+				for (const FNetViewer& Viewer : ConnectionViewers)
+				{
+					if (!Actor->GetNetDormancy(Viewer.ViewLocation, Viewer.ViewDir, Viewer.InViewer, Viewer.ViewTarget, Channel, NetDriver->Time, bLowNetBandwidth))
+					{
+						bShouldGoDormant = false;
+						break;
+					}
+				}
+			}
+
+			if (bShouldGoDormant)
+			{
+				Channel->StartBecomingDormant();
+			}
+		}
+	}
+
+	// Frequency: an actor is due every UpdatePeriod frames, or right away after ForceNetUpdate
+	const uint32 LastReplicationFrame = ConnectionActorInfo.LastReplicationFrame;
+	const bool bIsNew = !Channel || LastReplicationFrame == 0;
+	const bool bIsForced = LastReplicationFrame < ActorInfo->ForceNetUpdateFrame;
+	const uint32 FramesSinceReplication = Frame - LastReplicationFrame;
+
+	if (!bIsNew && !bIsForced && FramesSinceReplication < ActorInfo->UpdatePeriod)
+	{
+		return;
+	}
+
+	float Priority = bIsNew ? GridReplicationDriver::NewActorStarvation : (float)FramesSinceReplication / (float)ActorInfo->UpdatePeriod;
+	if (bIsForced)
+	{
+		Priority = FMath::Max(Priority, 1.0f);
+	}
+
+	// Closer actors go first, actors that aren't culled by distance are as close as it gets
+	float DistanceAlpha = 1.0f;
+	if (ActorInfo->Routing == EActorRouting::Grid && Actor->NetCullDistanceSquared > 0.0f)
+	{
+		const FVector Location = Actor->GetActorLocation();
+		float MinDistanceSquared = Actor->NetCullDistanceSquared;
+		for (const FNetViewer& Viewer : ConnectionViewers)
+		{
+			MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(Location, Viewer.ViewLocation));
+		}
+		DistanceAlpha = 1.0f - MinDistanceSquared / Actor->NetCullDistanceSquared;
+	}
+	Priority *= 1.0f + DistancePriorityScale * DistanceAlpha;
+
+	for (const FNetViewer& Viewer : ConnectionViewers)
+	{
+		if (Actor == Viewer.InViewer || Actor == Viewer.ViewTarget)
+		{
+			Priority *= GridReplicationDriver::ViewerPriorityScale;
+			break;
+		}
+	}
+
+	Priority *= Actor->NetPriority;
+
+	FPrioritizedActor& PrioritizedActor = PrioritizedActors.AddDefaulted_GetRef();
+	PrioritizedActor.ActorInfo = ActorInfo;
+	PrioritizedActor.ConnectionActorInfo = &ConnectionActorInfo;
+	PrioritizedActor.Channel = Channel;
+	PrioritizedActor.Priority = Priority;
+}
+
+int32 UGridReplicationDriver::SendDestructionInfos(UNetConnection* Connection)
+{
+	TSet<FNetworkGUID>& DestroyedGUIDs = Connection->GetDestroyedStartupOrDormantActorGUIDs();
+	if (DestroyedGUIDs.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Sending one removes it from the set
+	const TArray<FNetworkGUID> GUIDsToSend = DestroyedGUIDs.Array();
+
+	int32 NumSent = 0;
+	for (const FNetworkGUID& NetGUID : GUIDsToSend)
+	{
+		TUniquePtr<FActorDestructionInfo>* DestructionInfoPtr = NetDriver->DestroyedStartupOrDormantActors.Find(NetGUID);
+		if (!DestructionInfoPtr)
+		{
+			continue;
+		}
+
+		FActorDestructionInfo* DestructionInfo = DestructionInfoPtr->Get();
+
+		// Make sure client has streaming level loaded
+		if (DestructionInfo->StreamingLevelName != NAME_None && !Connection->ClientVisibleLevelNames.Contains(DestructionInfo->StreamingLevelName))
+		{
+			continue;
+		}
+
+		UActorChannel* Channel = (UActorChannel*)Connection->CreateChannelByName(NAME_Actor, EChannelCreateFlags::OpenedLocally);
+		if (Channel)
+		{
+			UE_LOG(LogNetTraffic, Log, TEXT("Server replicate actor creating destroy channel for NetGUID <%s,%s>"), *DestructionInfo->NetGUID.ToString(), *DestructionInfo->PathName);
+
+			Channel->SetChannelActorForDestroy(DestructionInfo);		// Send a close bunch on the new channel
+			Connection->RemoveDestructionInfo(DestructionInfo);		// Remove from connections to-be-destroyed list (close bunch of reliable, so it will make it there)
+			NumSent++;
+		}
+
+		if (!Connection->IsNetReady(0))
+		{
+			break;
+		}
+	}
+
+	return NumSent;
+}
+
+void UGridReplicationDriver::CloseIrrelevantChannels(FGridConnectionInfo& ConnectionInfo)
+{
+	UNetConnection* Connection = ConnectionInfo.Connection;
+
+	for (auto It = ConnectionInfo.ActorInfos.CreateIterator(); It; ++It)
+	{
+		if (NetDriver->Time - It.Value().LastRelevantTime < NetDriver->RelevantTimeout)
+		{
+			continue;
+		}
+
+		AActor* Actor = It.Key();
+		UActorChannel* Channel = Connection->FindActorChannelRef(Actor);
+		if (Channel)
+		{
+			// Non startup (map) actors have their channels closed, which destroys them. Startup actors get to keep their channels open.
+			if (NetDriver->IsLevelInitializedForActor(Actor, Connection) && Actor->IsNetStartupActor())
+			{
+				continue;
+			}
+
+			UE_LOG(LogNetTraffic, Log, TEXT("- Closing channel for no longer relevant actor %s"), *Actor->GetName());
+			Channel->Close(EChannelCloseReason::Relevancy);
+		}
+
+		It.RemoveCurrent();
+	}
+}
+
+UGridReplicationDriver::FGridConnectionInfo& UGridReplicationDriver::FindOrAddConnectionInfo(UNetConnection* Connection)
+{
+	TUniquePtr<FGridConnectionInfo>& ConnectionInfo = ConnectionInfoMap.FindOrAdd(Connection);
+	if (!ConnectionInfo.IsValid())
+	{
+		ConnectionInfo = MakeUnique<FGridConnectionInfo>();
+		ConnectionInfo->Connection = Connection;
+		ConnectionInfo->WeakConnection = Connection;
+	}
+	return *ConnectionInfo;
+}
+
+void UGridReplicationDriver::ResetActors()
+{
+	for (TPair<AActor*, TUniquePtr<FGridActorInfo>>& Pair : ActorInfoMap)
+	{
+		// Lists of this frame may still point to them
+		Pair.Value->Actor = nullptr;
+		Pair.Value->NetworkObjectInfo = nullptr;
+		RemovedActorInfos.Add(MoveTemp(Pair.Value));
+	}
+
+	ActorInfoMap.Reset();
+	Cells.Reset();
+	EmptyCells.Reset();
+	DynamicGridActors.Reset();
+	LargeActors.Reset();
+	AlwaysRelevantActors.Reset();
+	OwnerOnlyActors.Reset();
+	OwnerRelevancyActors.Reset();
+	TeamActors.Reset();
+
+	for (TPair<UNetConnection*, TUniquePtr<FGridConnectionInfo>>& Pair : ConnectionInfoMap)
+	{
+		Pair.Value->ActorInfos.Reset();
+		Pair.Value->OwnedActors.Reset();
+	}
+}
@@ -136,6 +136,8 @@ DEFINE_STAT(STAT_NetReplicateDynamicPropCompareTime);
 DEFINE_STAT(STAT_NetReplicateDynamicPropSendTime);
 DEFINE_STAT(STAT_NetReplicateDynamicPropSendBackCompatTime);
 DEFINE_STAT(STAT_NetSkippedDynamicProps);
+DEFINE_STAT(STAT_NetComparedProperties);
+DEFINE_STAT(STAT_NetSkippedPushBasedProperties);
 DEFINE_STAT(STAT_NetSerializeItemDeltaTime);
 DEFINE_STAT(STAT_NetUpdateGuidToReplicatorMap);
 DEFINE_STAT(STAT_NetReplicateStaticPropTime);
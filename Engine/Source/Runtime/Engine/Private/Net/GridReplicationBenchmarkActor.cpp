@@ -0,0 +1,295 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Net/GridReplicationBenchmarkActor.h"
+
+#include "Net/UnrealNetwork.h"
+#include "Components/SceneComponent.h"
+#include "Containers/Ticker.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/ReplicationDriver.h"
+#include "Engine/World.h"
+#include "EngineLogs.h"
+#include "EngineUtils.h"
+
+//-----------------------------------------------------------------------------
+//
+AGridReplicationBenchmarkActor::AGridReplicationBenchmarkActor()
+	: MoveChance(0.0f)
+	, MoveDistance(0.0f)
+	, Extent(0.0f)
+	, MoveCount(0)
+{
+	bReplicates = true;
+	SetReplicatingMovement(true);
+
+	NetDormancy = DORM_Never;
+	NetUpdateFrequency = 10.0f;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+void AGridReplicationBenchmarkActor::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AGridReplicationBenchmarkActor, MoveCount);
+}
+
+void AGridReplicationBenchmarkActor::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!HasAuthority() || FMath::FRand() >= MoveChance)
+	{
+		return;
+	}
+
+	FVector Location = GetActorLocation();
+	Location.X = FMath::Clamp(Location.X + FMath::FRandRange(-MoveDistance, MoveDistance), -Extent, Extent);
+	Location.Y = FMath::Clamp(Location.Y + FMath::FRandRange(-MoveDistance, MoveDistance), -Extent, Extent);
+	SetActorLocation(Location);
+
+	++MoveCount;
+}
+
+//-----------------------------------------------------------------------------
+//
+namespace GridReplicationBenchmark
+{
+	/** Frames at the start that aren't measured, while every actor gets a channel on every connection */
+	static const int32 MaxWarmupFrames = 30;
+
+	/** State of the benchmark that's running, one at a time */
+	struct FBenchmark
+	{
+		TWeakObjectPtr<UWorld> World;
+		TWeakObjectPtr<UNetDriver> NetDriver;
+
+		TArray<TWeakObjectPtr<AGridReplicationBenchmarkActor>> Actors;
+		TArray<TWeakObjectPtr<UNetConnection>> Connections;
+
+		int32 NumFrames = 0;
+		int32 NumWarmupFrames = 0;
+		int32 Frame = 0;
+
+		double TotalSeconds = 0.0;
+		double MinSeconds = MAX_dbl;
+		double MaxSeconds = 0.0;
+		double WarmupSeconds = 0.0;
+		int64 TotalUpdated = 0;
+
+		FDelegateHandle TickerHandle;
+	};
+
+	static TUniquePtr<FBenchmark> RunningBenchmark;
+
+	static void StopBenchmark()
+	{
+		if (!RunningBenchmark.IsValid())
+		{
+			return;
+		}
+
+		FTicker::GetCoreTicker().RemoveTicker(RunningBenchmark->TickerHandle);
+
+		for (const TWeakObjectPtr<UNetConnection>& Connection : RunningBenchmark->Connections)
+		{
+			if (Connection.IsValid())
+			{
+				Connection->CleanUp();
+			}
+		}
+
+		for (const TWeakObjectPtr<AGridReplicationBenchmarkActor>& Actor : RunningBenchmark->Actors)
+		{
+			if (Actor.IsValid())
+			{
+				Actor->Destroy();
+			}
+		}
+
+		RunningBenchmark.Reset();
+	}
+
+	static bool TickBenchmark(float DeltaTime)
+	{
+		FBenchmark& Benchmark = *RunningBenchmark;
+
+		UNetDriver* NetDriver = Benchmark.NetDriver.Get();
+		if (!Benchmark.World.IsValid() || !NetDriver)
+		{
+			UE_LOG(LogNet, Warning, TEXT("Net.GridReplicationBenchmark: the world or net driver went away, stopping."));
+			StopBenchmark();
+			return false;
+		}
+
+		// Simulated connections never receive anything, keep them from looking timed out
+		for (const TWeakObjectPtr<UNetConnection>& Connection : Benchmark.Connections)
+		{
+			if (Connection.IsValid())
+			{
+				Connection->LastReceiveTime = NetDriver->Time;
+			}
+		}
+
+		// UNetDriver::TickFlush doesn't replicate to InternalAck connections, so the benchmark does it
+		const double StartTime = FPlatformTime::Seconds();
+		const int32 Updated = NetDriver->ServerReplicateActors(DeltaTime);
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		if (Benchmark.Frame < Benchmark.NumWarmupFrames)
+		{
+			Benchmark.WarmupSeconds += Seconds;
+		}
+		else
+		{
+			Benchmark.TotalSeconds += Seconds;
+			Benchmark.MinSeconds = FMath::Min(Benchmark.MinSeconds, Seconds);
+			Benchmark.MaxSeconds = FMath::Max(Benchmark.MaxSeconds, Seconds);
+			Benchmark.TotalUpdated += Updated;
+		}
+
+		if (++Benchmark.Frame < Benchmark.NumFrames)
+		{
+			return true;
+		}
+
+		const int32 NumMeasuredFrames = Benchmark.NumFrames - Benchmark.NumWarmupFrames;
+		UReplicationDriver* ReplicationDriver = NetDriver->GetReplicationDriver();
+
+		FString Path;
+		if (ReplicationDriver)
+		{
+			Path = ReplicationDriver->GetClass()->GetName();
+		}
+		else
+		{
+			static const IConsoleVariable* ParallelPrioritizeActorsCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("net.ParallelPrioritizeActors"));
+			Path = FString::Printf(TEXT("legacy UNetDriver path, net.ParallelPrioritizeActors=%d"), ParallelPrioritizeActorsCVar ? ParallelPrioritizeActorsCVar->GetInt() : 0);
+		}
+
+		UE_LOG(LogNet, Display, TEXT("Net.GridReplicationBenchmark: %d actors, %d connections, %s"), Benchmark.Actors.Num(), Benchmark.Connections.Num(), *Path);
+		UE_LOG(LogNet, Display, TEXT("  Warmup: %d frames, %.3f ms per frame"),
+			Benchmark.NumWarmupFrames, Benchmark.NumWarmupFrames > 0 ? Benchmark.WarmupSeconds * 1000.0 / Benchmark.NumWarmupFrames : 0.0);
+		UE_LOG(LogNet, Display, TEXT("  ServerReplicateActors: %d frames, %.3f ms average, %.3f ms min, %.3f ms max, %.1f actors replicated per frame"),
+			NumMeasuredFrames, Benchmark.TotalSeconds * 1000.0 / NumMeasuredFrames, Benchmark.MinSeconds * 1000.0, Benchmark.MaxSeconds * 1000.0, (double)Benchmark.TotalUpdated / NumMeasuredFrames);
+
+		StopBenchmark();
+		return false;
+	}
+}
+
+/**
+ *
+ */
+FAutoConsoleCommandWithWorldAndArgs GridReplicationBenchmarkCmd(TEXT("Net.GridReplicationBenchmark"),
+																TEXT("Spawns moving replicated actors and simulated connections, then logs how long replicating to them takes per frame." \
+																	 "\nRun it on a server without clients, with and without a replication driver." \
+																	 "\nUsage:" \
+																	 "\nNet.GridReplicationBenchmark NumActors NumConnections [NumFrames=300] [Extent=100000] [NetCullDistance=15000] [MoveChance=0.5]"),
+FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+{
+	using namespace GridReplicationBenchmark;
+
+	if (Args.Num() < 2)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Missing some parameters"));
+		return;
+	}
+
+	if (RunningBenchmark.IsValid())
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Net.GridReplicationBenchmark is already running"));
+		return;
+	}
+
+	UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+	if (!NetDriver || !NetDriver->IsServer())
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Net.GridReplicationBenchmark has to run on the server"));
+		return;
+	}
+
+	// Real clients would get ServerReplicateActors from UNetDriver::TickFlush as well, replicating twice per frame
+	if (NetDriver->ClientConnections.Num() > 0)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Net.GridReplicationBenchmark has to run on a server without clients"));
+		return;
+	}
+
+	int32 NumActors(0);
+	int32 NumConnections(0);
+	LexTryParseString<int32>(NumActors, *Args[0]);
+	LexTryParseString<int32>(NumConnections, *Args[1]);
+
+	int32 NumFrames(300);
+	float Extent(100000.0f);
+	float NetCullDistance(15000.0f);
+	float MoveChance(0.5f);
+	if (Args.Num() > 2)
+	{
+		LexTryParseString<int32>(NumFrames, *Args[2]);
+	}
+	if (Args.Num() > 3)
+	{
+		LexTryParseString<float>(Extent, *Args[3]);
+	}
+	if (Args.Num() > 4)
+	{
+		LexTryParseString<float>(NetCullDistance, *Args[4]);
+	}
+	if (Args.Num() > 5)
+	{
+		LexTryParseString<float>(MoveChance, *Args[5]);
+	}
+
+	if (NumActors <= 0 || NumConnections <= 0 || NumFrames <= 0)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Net.GridReplicationBenchmark needs at least one actor, connection and frame"));
+		return;
+	}
+
+	RunningBenchmark = MakeUnique<FBenchmark>();
+	FBenchmark& Benchmark = *RunningBenchmark;
+	Benchmark.World = World;
+	Benchmark.NetDriver = NetDriver;
+	Benchmark.NumFrames = NumFrames;
+	Benchmark.NumWarmupFrames = FMath::Min(MaxWarmupFrames, NumFrames / 4);
+
+	FRandomStream RandomStream(NumActors ^ NumConnections);
+
+	// Connections view from actors of their own, moving like the others
+	for (int32 Index = 0; Index < NumActors + NumConnections; ++Index)
+	{
+		const FVector Location(RandomStream.FRandRange(-Extent, Extent), RandomStream.FRandRange(-Extent, Extent), 0.0f);
+
+		AGridReplicationBenchmarkActor* Actor = World->SpawnActorDeferred<AGridReplicationBenchmarkActor>(AGridReplicationBenchmarkActor::StaticClass(), FTransform(Location));
+		check(Actor);
+		Actor->MoveChance = MoveChance;
+		Actor->MoveDistance = 100.0f;
+		Actor->Extent = Extent;
+		Actor->NetCullDistanceSquared = FMath::Square(NetCullDistance);
+		Actor->FinishSpawning(FTransform(Location));
+
+		Benchmark.Actors.Add(Actor);
+	}
+
+	for (int32 Index = 0; Index < NumConnections; ++Index)
+	{
+		USimulatedClientNetConnection* Connection = NewObject<USimulatedClientNetConnection>();
+		Connection->InitConnection(NetDriver, USOCK_Open, World->URL, 1000000);
+		Connection->InitSendBuffer();
+		NetDriver->AddClientConnection(Connection);
+		Connection->OwningActor = Benchmark.Actors[NumActors + Index].Get();
+		Connection->SetClientWorldPackageName(NetDriver->GetWorldPackage()->GetFName());
+
+		Benchmark.Connections.Add(Connection);
+	}
+
+	UE_LOG(LogConsoleResponse, Display, TEXT("Net.GridReplicationBenchmark: replicating %d actors to %d simulated connections for %d frames..."), NumActors + NumConnections, NumConnections, NumFrames);
+
+	Benchmark.TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&TickBenchmark));
+}));
@@ -0,0 +1,138 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Net/PushModelTestActor.h"
+
+#include "Net/UnrealNetwork.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+
+//-----------------------------------------------------------------------------
+//
+APushModelTestActor::APushModelTestActor()
+	: ChangeChance(0.0f)
+	, PushedInt(0)
+	, PushedFloat(0.0f)
+	, PushedVector(FVector::ZeroVector)
+	, PolledValue(0)
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	SetReplicatingMovement(false);
+
+	NetDormancy = DORM_Never;
+
+	PrimaryActorTick.bCanEverTick = true;
+
+	FMemory::Memzero(PushedStaticArray);
+}
+
+void APushModelTestActor::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams PushParams;
+	PushParams.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS(APushModelTestActor, PushedInt, PushParams);
+	DOREPLIFETIME_WITH_PARAMS(APushModelTestActor, PushedFloat, PushParams);
+	DOREPLIFETIME_WITH_PARAMS(APushModelTestActor, PushedVector, PushParams);
+	DOREPLIFETIME_WITH_PARAMS(APushModelTestActor, PushedString, PushParams);
+	DOREPLIFETIME_WITH_PARAMS(APushModelTestActor, PushedArray, PushParams);
+	DOREPLIFETIME_WITH_PARAMS(APushModelTestActor, PushedStaticArray, PushParams);
+	DOREPLIFETIME(APushModelTestActor, PolledValue);
+}
+
+void APushModelTestActor::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!HasAuthority() || FMath::FRand() >= ChangeChance)
+	{
+		return;
+	}
+
+	switch (FMath::RandHelper(6))
+	{
+	case 0:
+		++PushedInt;
+		MARK_PROPERTY_DIRTY_FROM_NAME(APushModelTestActor, PushedInt, this);
+		break;
+
+	case 1:
+		PushedFloat += 0.5f;
+		MARK_PROPERTY_DIRTY_FROM_NAME(APushModelTestActor, PushedFloat, this);
+		break;
+
+	case 2:
+		PushedVector = FMath::VRand();
+		MARK_PROPERTY_DIRTY_FROM_NAME(APushModelTestActor, PushedVector, this);
+		break;
+
+	case 3:
+		PushedString = FString::Printf(TEXT("Change %d"), ++PushedInt);
+		MARK_PROPERTY_DIRTY_FROM_NAME(APushModelTestActor, PushedString, this);
+		MARK_PROPERTY_DIRTY_FROM_NAME(APushModelTestActor, PushedInt, this);
+		break;
+
+	case 4:
+		PushedArray.SetNum(FMath::RandHelper(8));
+		MARK_PROPERTY_DIRTY_FROM_NAME(APushModelTestActor, PushedArray, this);
+		break;
+
+	default:
+		{
+			const int32 Index = FMath::RandHelper(ARRAY_COUNT(PushedStaticArray));
+			++PushedStaticArray[Index];
+			MARK_PROPERTY_DIRTY_FROM_NAME_STATIC_ARRAY_INDEX(APushModelTestActor, PushedStaticArray, Index, this);
+		}
+		break;
+	}
+}
+
+
+/**
+ *
+ */
+FAutoConsoleCommandWithWorldAndArgs SpawnPushModelTestActors(TEXT("Net.SpawnPushModelTestActors"),
+															 TEXT("Spawns replicated actors that rarely change, to measure the cost of comparing their properties." \
+																  "\nUsage:" \
+																  "\nNet.SpawnPushModelTestActors Count [ChangeChancePerTick]"),
+FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+{
+	if (Args.Num() < 1)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Missing some parameters"));
+		return;
+	}
+
+	if (!World || World->GetNetMode() == NM_Client)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Net.SpawnPushModelTestActors has to run on the server"));
+		return;
+	}
+
+	int32 Count(0);
+	LexTryParseString<int32>(Count, *Args[0]);
+
+	float ChangeChance(0.01f);
+	if (Args.Num() > 1)
+	{
+		LexTryParseString<float>(ChangeChance, *Args[1]);
+	}
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		APushModelTestActor* TestActor = Cast<APushModelTestActor>(World->SpawnActor(APushModelTestActor::StaticClass()));
+		check(TestActor);
+		TestActor->ChangeChance = ChangeChance;
+	}
+}));
+
+FAutoConsoleCommandWithWorldAndArgs DestroyPushModelTestActors(TEXT("Net.DestroyPushModelTestActors"), TEXT("Destroys the actors spawned by Net.SpawnPushModelTestActors"),
+FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray< FString >& Args, UWorld* World)
+{
+	for (TActorIterator<APushModelTestActor> It(World); It; ++It)
+	{
+		It->Destroy();
+	}
+}));
@@ -0,0 +1,152 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Net/RepLayout.h"
+#include "Net/PushModelTestActor.h"
+#include "Engine/NetDriver.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRepLayoutSharedChangelistTest, "Net.RepLayout.SharedChangelistSerialization", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FRepLayoutSharedChangelistTest::RunTest(const FString& Parameters)
+{
+	TSharedPtr<FRepLayout> RepLayout = FRepLayout::CreateFromClass(APushModelTestActor::StaticClass());
+	const APushModelTestActor* Actor = GetDefault<APushModelTestActor>();
+	const FConstRepObjectDataBuffer Data(Actor);
+
+	TSharedPtr<FRepChangedPropertyTracker> ChangedTracker = MakeShared<FRepChangedPropertyTracker>(false, false);
+	RepLayout->InitChangedTracker(ChangedTracker.Get());
+
+	TUniquePtr<FRepState> RepState = RepLayout->CreateRepState(Data, ChangedTracker, ECreateRepStateFlags::SkipCreateReceivingState);
+	FSendingRepState* SendingRepState = RepState->GetSendingRepState();
+
+	const FRepSerializationSharedInfo EmptySharedInfo;
+
+	auto GetHandle = [&RepLayout](const FName PropertyName) -> uint16
+	{
+		for (const FRepParentCmd& Parent : RepLayout->Parents)
+		{
+			if (Parent.Property->GetFName() == PropertyName && Parent.ArrayIndex == 0)
+			{
+				return RepLayout->Cmds[Parent.CmdStart].RelativeHandle;
+			}
+		}
+
+		return 0;
+	};
+
+	auto MakeChangelist = [this, &GetHandle](std::initializer_list<const TCHAR*> PropertyNames)
+	{
+		TArray<uint16> Changed;
+		for (const TCHAR* PropertyName : PropertyNames)
+		{
+			const uint16 Handle = GetHandle(PropertyName);
+			TestTrue(FString::Printf(TEXT("Found replicated property %s"), PropertyName), Handle != 0);
+			Changed.Add(Handle);
+		}
+		Changed.Sort();
+		Changed.Add(0);
+		return Changed;
+	};
+
+	// Writes PrefixBits bits first so the changelist doesn't start on a byte boundary, then returns the changelist's bits
+	auto Send = [&](TArray<uint16> Changed, FRepSerializedChangelistCache* SerializedChangelists, const int32 FirstChangelistIndex, const int32 PrefixBits, TArray<uint8>& OutBits) -> int64
+	{
+		FNetBitWriter Writer(16384);
+		for (int32 Bit = 0; Bit < PrefixBits; ++Bit)
+		{
+			Writer.WriteBit(1);
+		}
+
+		FBitWriterMark Mark(Writer);
+
+		if (SerializedChangelists)
+		{
+			RepLayout->SendProperties_SharedChangelist(SendingRepState, ChangedTracker.Get(), Data, APushModelTestActor::StaticClass(), Writer, Changed, EmptySharedInfo, FirstChangelistIndex, *SerializedChangelists);
+		}
+		else
+		{
+			RepLayout->SendProperties(SendingRepState, ChangedTracker.Get(), Data, APushModelTestActor::StaticClass(), Writer, Changed, EmptySharedInfo);
+		}
+
+		Mark.Copy(Writer, OutBits);
+		return Writer.GetNumBits() - Mark.GetNumBits();
+	};
+
+	const TArray<uint16> SharedChanged = MakeChangelist({ TEXT("PushedInt"), TEXT("PushedFloat"), TEXT("PushedVector"), TEXT("PushedString"), TEXT("PolledValue") });
+	const TArray<uint16> OtherSharedChanged = MakeChangelist({ TEXT("PushedInt") });
+	const TArray<uint16> RemoteRoleChanged = MakeChangelist({ TEXT("PushedInt"), TEXT("RemoteRole") });
+
+	TestTrue(TEXT("Changelist supports shared serialization"), RepLayout->IsSharedSerializationChangelist(SharedChanged));
+	TestFalse(TEXT("RemoteRole doesn't support shared serialization"), RepLayout->IsSharedSerializationChangelist(RemoteRoleChanged));
+
+	TArray<uint8> ExpectedBits;
+	const int64 ExpectedNumBits = Send(SharedChanged, nullptr, 0, 0, ExpectedBits);
+	TestTrue(TEXT("Changelist was serialized"), ExpectedNumBits > 0);
+
+	FRepSerializedChangelistCache SerializedChangelists;
+	SerializedChangelists.BeginFrame(1);
+
+	// First connection serializes it and shares it
+	{
+		const int32 NumMisses = GNumSharedChangelistMiss;
+
+		TArray<uint8> Bits;
+		const int64 NumBits = Send(SharedChanged, &SerializedChangelists, 10, 3, Bits);
+
+		TestEqual(TEXT("Miss serializes the same bits"), NumBits, ExpectedNumBits);
+		TestTrue(TEXT("Miss serializes the same bits"), Bits == ExpectedBits);
+		TestEqual(TEXT("Miss is counted"), GNumSharedChangelistMiss, NumMisses + 1);
+		TestEqual(TEXT("Changelist is shared"), SerializedChangelists.SerializedChangelists.Num(), 1);
+	}
+
+	// Next connections copy it, whatever bit they start on
+	for (int32 PrefixBits = 0; PrefixBits < 8; ++PrefixBits)
+	{
+		const int32 NumHits = GNumSharedChangelistHit;
+
+		TArray<uint8> Bits;
+		const int64 NumBits = Send(SharedChanged, &SerializedChangelists, 10, PrefixBits, Bits);
+
+		TestEqual(TEXT("Hit copies the same bits"), NumBits, ExpectedNumBits);
+		TestTrue(TEXT("Hit copies the same bits"), Bits == ExpectedBits);
+		TestEqual(TEXT("Hit is counted"), GNumSharedChangelistHit, NumHits + 1);
+	}
+
+	// A connection that merged a different range of history, or sends a different changelist, doesn't use it
+	{
+		const int32 NumHits = GNumSharedChangelistHit;
+
+		TArray<uint8> Bits;
+		Send(SharedChanged, &SerializedChangelists, 9, 0, Bits);
+		TestTrue(TEXT("Other history range serializes the same bits"), Bits == ExpectedBits);
+
+		TArray<uint8> OtherExpectedBits;
+		Send(OtherSharedChanged, nullptr, 0, 0, OtherExpectedBits);
+		Send(OtherSharedChanged, &SerializedChangelists, 10, 0, Bits);
+		TestTrue(TEXT("Other changelist serializes its own bits"), Bits == OtherExpectedBits);
+
+		TestEqual(TEXT("Other changelists miss"), GNumSharedChangelistHit, NumHits);
+		TestEqual(TEXT("Other changelists are shared"), SerializedChangelists.SerializedChangelists.Num(), 3);
+	}
+
+	// Changelists with properties that depend on the connection are never shared
+	{
+		TArray<uint8> RemoteRoleExpectedBits;
+		Send(RemoteRoleChanged, nullptr, 0, 0, RemoteRoleExpectedBits);
+
+		TArray<uint8> Bits;
+		Send(RemoteRoleChanged, &SerializedChangelists, 10, 0, Bits);
+		TestTrue(TEXT("Unshared changelist serializes the same bits"), Bits == RemoteRoleExpectedBits);
+		TestEqual(TEXT("Unshared changelist isn't kept"), SerializedChangelists.SerializedChangelists.Num(), 3);
+	}
+
+	// Nothing carries over to the next frame
+	SerializedChangelists.BeginFrame(2);
+	TestEqual(TEXT("Next frame starts empty"), SerializedChangelists.SerializedChangelists.Num(), 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
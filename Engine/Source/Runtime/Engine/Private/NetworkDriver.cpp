@@ -67,7 +67,9 @@
 #include "Engine/NetworkSettings.h"
 #include "Net/NetworkGranularMemoryLogging.h"
 #include "SocketSubsystem.h"
+#include "Sockets.h"
 #include "AddressInfoTypes.h"
+#include "Async/ParallelFor.h"
 
 #if USE_SERVER_PERF_COUNTERS
 #include "PerfCountersModule.h"
@@ -149,10 +151,13 @@ DECLARE_CYCLE_STAT(TEXT("Process Prioritized Actors Time"), STAT_NetProcessPrior
 DECLARE_CYCLE_STAT(TEXT("NetDriver TickFlush"), STAT_NetTickFlush, STATGROUP_Game);
 DECLARE_CYCLE_STAT(TEXT("NetDriver TickFlush GatherStats"), STAT_NetTickFlushGatherStats, STATGROUP_Game);
 DECLARE_CYCLE_STAT(TEXT("NetDriver TickFlush GatherStatsPerfCounters"), STAT_NetTickFlushGatherStatsPerfCounters, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("NetDriver FlushBatchedSends"), STAT_NetFlushBatchedSends, STATGROUP_Game);
 
 int32 GNumSaturatedConnections; // Counter for how many connections are skipped/early out due to bandwidth saturation
 int32 GNumSharedSerializationHit;
 int32 GNumSharedSerializationMiss;
+int32 GNumSharedChangelistHit;
+int32 GNumSharedChangelistMiss;
 
 extern int32 GNetRPCDebug;
 
@@ -242,6 +247,27 @@ static TAutoConsoleVariable<int32> CVarAllowReliableMulticastToNonRelevantChanne
 	1,
 	TEXT("Allow Reliable Server Multicasts to be sent to non-Relevant Actors, as long as their is an existing ActorChannel."));
 
+static TAutoConsoleVariable<int32> CVarNetParallelPrioritizeActors(
+	TEXT("net.ParallelPrioritizeActors"),
+	0,
+	TEXT("Number of tasks ServerReplicateActors splits the connections it prioritizes actors for between. 0 or 1 prioritizes them one after the other on the game thread.\n")
+	TEXT("IsNetRelevantFor, GetNetPriority and GetNetDormancy are then called from task graph threads and must not change anything. Replicating the actors still happens on the game thread."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarNetBatchSends(
+	TEXT("net.BatchSends"),
+	0,
+	TEXT("If nonzero, packets sent by net drivers that support it are queued, and sent together with FSocket::SendMulti once every connection has ticked. ")
+	TEXT("Saves a system call per packet, on socket subsystems that support it (sendmmsg on Linux)."));
+
+static TAutoConsoleVariable<int32> CVarNetBatchSendsSegmentationOffload(
+	TEXT("net.BatchSendsSegmentationOffload"),
+	0,
+	TEXT("If nonzero, batched sends also send runs of same size packets to the same address as one segmented send, on socket subsystems that support it (UDP GSO on Linux 4.18+)."));
+
+/** The most packets QueueBatchedSend queues before sending them */
+static const int32 MaxBatchedSendPackets = 256;
+
 
 /*-----------------------------------------------------------------------------
 	UNetDriver implementation.
@@ -259,6 +285,8 @@ UNetDriver::UNetDriver(const FObjectInitializer& ObjectInitializer)
 ,	RecentlyDisconnectedTrackingTime(0)
 ,	ConnectionlessHandler()
 ,	StatelessConnectComponent()
+,	BatchedSends()
+,	BatchedSendSocket(nullptr)
 ,	AnalyticsProvider()
 ,	AnalyticsAggregator()
 ,   World(nullptr)
@@ -995,6 +1023,8 @@ void UNetDriver::TickFlush(float DeltaSeconds)
 		FlushHandler();
 	}
 
+	FlushBatchedSends();
+
 	if (CVarNetDebugDraw.GetValueOnAnyThread() > 0)
 	{
 		DrawNetDriverDebug();
@@ -1494,6 +1524,72 @@ void UNetDriver::InitConnectionlessHandler()
 	}
 }
 
+bool UNetDriver::QueueBatchedSend(FSocket* Socket, const uint8* Data, int32 CountBytes, const FInternetAddr& Address)
+{
+	if (Socket == nullptr || CVarNetBatchSends.GetValueOnAnyThread() == 0)
+	{
+		// Send anything queued before batching was disabled first, to keep packets in order
+		FlushBatchedSends();
+		return false;
+	}
+
+	const ESendMultiFlags SendMultiFlags = (CVarNetBatchSendsSegmentationOffload.GetValueOnAnyThread() != 0) ? ESendMultiFlags::SegmentationOffload : ESendMultiFlags::None;
+
+	if (!BatchedSends.IsValid() || BatchedSends->InitFlags != SendMultiFlags)
+	{
+		FlushBatchedSends();
+
+		ISocketSubsystem* SocketSubsystem = GetSocketSubsystem();
+		if (SocketSubsystem == nullptr || !SocketSubsystem->IsSocketSendMultiSupported())
+		{
+			return false;
+		}
+
+		BatchedSends = SocketSubsystem->CreateSendMulti(MaxBatchedSendPackets, MAX_PACKET_SIZE, SendMultiFlags);
+		if (!BatchedSends.IsValid())
+		{
+			return false;
+		}
+	}
+
+	if (Socket != BatchedSendSocket || BatchedSends->IsFull())
+	{
+		FlushBatchedSends();
+	}
+
+	if (!BatchedSends->AddPacket(Data, CountBytes, Address))
+	{
+		// Too big to queue, send what's queued first, to keep packets in order
+		FlushBatchedSends();
+		return false;
+	}
+
+	BatchedSendSocket = Socket;
+
+	return true;
+}
+
+void UNetDriver::FlushBatchedSends()
+{
+	if (BatchedSends.IsValid() && BatchedSends->GetNumPackets() > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_NetFlushBatchedSends);
+
+		const int32 NumPackets = BatchedSends->GetNumPackets();
+		int32 NumPacketsSent = 0;
+
+		if (!BatchedSendSocket->SendMulti(*BatchedSends, NumPacketsSent))
+		{
+			ISocketSubsystem* SocketSubsystem = GetSocketSubsystem();
+
+			UE_LOG(LogNet, Log, TEXT("UNetDriver::FlushBatchedSends: Only sent %i of %i packets (%s)"), NumPacketsSent, NumPackets,
+				SocketSubsystem ? SocketSubsystem->GetSocketError(SE_GET_LAST_ERROR_CODE) : TEXT(""));
+		}
+
+		BatchedSends->Reset();
+	}
+}
+
 void UNetDriver::FlushHandler()
 {
 	BufferedPacket* QueuedPacket = ConnectionlessHandler->GetQueuedConnectionlessPacket();
@@ -1604,6 +1700,11 @@ void UNetDriver::Shutdown()
 
 	ConnectionlessHandler.Reset(nullptr);
 
+	// Send the packets queued while closing connections, before the socket goes away
+	FlushBatchedSends();
+	BatchedSends.Reset();
+	BatchedSendSocket = nullptr;
+
 	SetReplicationDriver(nullptr);
 
 	if (AnalyticsAggregator.IsValid())
@@ -2334,6 +2435,12 @@ void UNetDriver::Serialize( FArchive& Ar )
 
 		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("MappedClientConnection", MappedClientConnections.CountBytes(Ar));
 		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("RecentlyDisconnectedClients", RecentlyDisconnectedClients.CountBytes(Ar));
+		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("BatchedSends",
+			if (FSendMulti const * const LocalBatchedSends = BatchedSends.Get())
+			{
+				LocalBatchedSends->CountBytes(Ar);
+			}
+		);
 		GRANULAR_NETWORK_MEMORY_TRACKING_TRACK("GuidCache",
 			if (FNetGUIDCache const * const LocalGuidCache = GuidCache.Get())
 			{
@@ -2478,6 +2585,9 @@ void UNetDriver::FinishDestroy()
 
 void UNetDriver::LowLevelDestroy()
 {
+	FlushBatchedSends();
+	BatchedSendSocket = nullptr;
+
 	// We are closing down all our sockets and low level communications.
 	// Sever the link with UWorld to ensure we don't tick again
 	SetWorld(NULL);
@@ -4071,6 +4181,95 @@ int32 UNetDriver::ServerReplicateActors_PrioritizeActors( UNetConnection* Connec
 	return FinalSortedCount;
 }
 
+void UNetDriver::ServerReplicateActors_PrioritizeActorsParallel( FParallelConnectionPriorities& ConnectionPriorities, const TArray<FNetworkObjectInfo*>& ConsiderList, const bool bLowNetBandwidth ) const
+{
+	SCOPE_CYCLE_COUNTER( STAT_NetPrioritizeActorsTime );
+
+	// Other tasks are reading the same actors and actor infos, so this only writes to ConnectionPriorities and
+	// to state owned by this connection. NetTag is shared by all connections, sent temporaries are looked up instead.
+	UNetConnection* Connection = ConnectionPriorities.Connection;
+	const TArray<FNetViewer>& ConnectionViewers = ConnectionPriorities.ConnectionViewers;
+
+	// Make weak ptr once for IsActorDormant call
+	TWeakObjectPtr<UNetConnection> WeakConnection(Connection);
+
+	TArray<FActorPriority>& PriorityList = ConnectionPriorities.PriorityList;
+	PriorityList.Reserve( ConsiderList.Num() + Connection->GetDestroyedStartupOrDormantActorGUIDs().Num() );
+
+	for ( FNetworkObjectInfo* ActorInfo : ConsiderList )
+	{
+		AActor* Actor = ActorInfo->Actor;
+
+		if ( Actor->bNetTemporary && Connection->SentTemporaries.Contains( Actor ) )
+		{
+			continue;
+		}
+
+		UActorChannel* Channel = Connection->FindActorChannelRef( ActorInfo->WeakActor );
+
+		// Skip actor if not relevant and theres no channel already.
+		if ( !Channel )
+		{
+			if ( !IsLevelInitializedForActor( Actor, Connection ) || !IsActorRelevantToConnection( Actor, ConnectionViewers ) )
+			{
+				continue;
+			}
+		}
+
+		UNetConnection* PriorityConnection = Connection;
+
+		if ( Actor->bOnlyRelevantToOwner )
+		{
+			bool bHasNullViewTarget = false;
+
+			PriorityConnection = IsActorOwnedByAndRelevantToConnection( Actor, ConnectionViewers, bHasNullViewTarget );
+
+			if ( PriorityConnection == nullptr )
+			{
+				// Not owned by this connection, close the channel like ServerReplicateActors_PrioritizeActors does
+				if ( !bHasNullViewTarget && Channel != NULL && Time - Channel->RelevantTime >= RelevantTimeout )
+				{
+					ConnectionPriorities.ChannelsToClose.Add( Channel );
+				}
+
+				continue;
+			}
+		}
+		else if ( GSetNetDormancyEnabled != 0 )
+		{
+			if ( IsActorDormant( ActorInfo, WeakConnection ) )
+			{
+				continue;
+			}
+
+			if ( ShouldActorGoDormant( Actor, ConnectionViewers, Channel, Time, bLowNetBandwidth ) )
+			{
+				ConnectionPriorities.ChannelsToStartBecomingDormant.Add( Channel );
+			}
+		}
+
+		PriorityList.Emplace( PriorityConnection, Channel, ActorInfo, ConnectionViewers, bLowNetBandwidth );
+	}
+
+	// Add in deleted actors
+	for ( auto It = Connection->GetDestroyedStartupOrDormantActorGUIDs().CreateConstIterator(); It; ++It )
+	{
+		FActorDestructionInfo& DInfo = *DestroyedStartupOrDormantActors.FindChecked( *It );
+		PriorityList.Emplace( Connection, &DInfo, ConnectionViewers );
+		ConnectionPriorities.DeletedCount++;
+	}
+
+	// Sort by priority
+	TArray<FActorPriority*>& PriorityActors = ConnectionPriorities.PriorityActors;
+	PriorityActors.Reserve( PriorityList.Num() );
+	for ( FActorPriority& ActorPriority : PriorityList )
+	{
+		PriorityActors.Add( &ActorPriority );
+	}
+
+	Sort( PriorityActors.GetData(), PriorityActors.Num(), FCompareFActorPriority() );
+}
+
 int32 UNetDriver::ServerReplicateActors_ProcessPrioritizedActors( UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, FActorPriority** PriorityActors, const int32 FinalSortedCount, int32& OutUpdated )
 {
 	SCOPE_CYCLE_COUNTER(STAT_NetProcessPrioritizedActorsTime);
@@ -4296,6 +4495,8 @@ DECLARE_DWORD_COUNTER_STAT(TEXT("SharedSerialization RPC Miss"), STAT_SharedSeri
 
 DECLARE_DWORD_COUNTER_STAT(TEXT("SharedSerialization Property Hit"), STAT_SharedSerializationPropertyHit, STATGROUP_Net);
 DECLARE_DWORD_COUNTER_STAT(TEXT("SharedSerialization Property Miss"), STAT_SharedSerializationPropertyMiss, STATGROUP_Net);
+DECLARE_DWORD_COUNTER_STAT(TEXT("SharedSerialization Changelist Hit"), STAT_SharedSerializationChangelistHit, STATGROUP_Net);
+DECLARE_DWORD_COUNTER_STAT(TEXT("SharedSerialization Changelist Miss"), STAT_SharedSerializationChangelistMiss, STATGROUP_Net);
 
 struct FReplicationAutoCapture
 {
@@ -4399,10 +4600,14 @@ struct FScopedNetDriverStats
 
 			SET_DWORD_STAT(STAT_SharedSerializationPropertyHit, GNumSharedSerializationHit);
 			SET_DWORD_STAT(STAT_SharedSerializationPropertyMiss, GNumSharedSerializationMiss);
+			SET_DWORD_STAT(STAT_SharedSerializationChangelistHit, GNumSharedChangelistHit);
+			SET_DWORD_STAT(STAT_SharedSerializationChangelistMiss, GNumSharedChangelistMiss);
 
 			// Note: we want to reset this at the end of the frame since the RPC stats are incremented at the top (recv)
 			GNumSharedSerializationHit = 0;
 			GNumSharedSerializationMiss = 0;
+			GNumSharedChangelistHit = 0;
+			GNumSharedChangelistMiss = 0;
 			GNumClientUpdateLevelVisibility = 0;
 		}
 	}
@@ -4479,6 +4684,52 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 
 	FMemMark Mark( FMemStack::Get() );
 
+	// With net.ParallelPrioritizeActors, the connections ticked this frame are all prioritized up front on task graph threads,
+	// then replicated to one after the other in the loop below. Nothing the tasks share is written until they're all done.
+	TArray<FParallelConnectionPriorities> ParallelPriorities;
+	const int32 NumPrioritizeTasks = FMath::Min( CVarNetParallelPrioritizeActors.GetValueOnGameThread(), NumClientsToTick );
+	if ( NumPrioritizeTasks > 1 )
+	{
+		ParallelPriorities.SetNum( NumClientsToTick );
+
+		for ( int32 i = 0; i < NumClientsToTick; i++ )
+		{
+			UNetConnection* Connection = ClientConnections[i];
+			if ( Connection->ViewTarget )
+			{
+				FParallelConnectionPriorities& ConnectionPriorities = ParallelPriorities[i];
+				ConnectionPriorities.Connection = Connection;
+
+				new( ConnectionPriorities.ConnectionViewers )FNetViewer( Connection, DeltaSeconds );
+				for ( int32 ViewerIndex = 0; ViewerIndex < Connection->Children.Num(); ViewerIndex++ )
+				{
+					if ( Connection->Children[ViewerIndex]->ViewTarget != NULL )
+					{
+						new( ConnectionPriorities.ConnectionViewers )FNetViewer( Connection->Children[ViewerIndex], DeltaSeconds );
+					}
+				}
+			}
+		}
+
+		AGameNetworkManager* const NetworkManager = World->NetworkManager;
+		const bool bLowNetBandwidth = NetworkManager ? NetworkManager->IsInLowBandwidthMode() : false;
+
+		// Each task prioritizes a contiguous range of connections
+		ParallelFor( NumPrioritizeTasks, [this, &ParallelPriorities, &ConsiderList, NumClientsToTick, NumPrioritizeTasks, bLowNetBandwidth]( int32 TaskIndex )
+		{
+			const int32 FirstConnection = NumClientsToTick * TaskIndex / NumPrioritizeTasks;
+			const int32 LastConnection = NumClientsToTick * ( TaskIndex + 1 ) / NumPrioritizeTasks;
+
+			for ( int32 i = FirstConnection; i < LastConnection; i++ )
+			{
+				if ( ParallelPriorities[i].Connection )
+				{
+					ServerReplicateActors_PrioritizeActorsParallel( ParallelPriorities[i], ConsiderList, bLowNetBandwidth );
+				}
+			}
+		});
+	}
+
 	for ( int32 i=0; i < ClientConnections.Num(); i++ )
 	{
 		UNetConnection* Connection = ClientConnections[i];
@@ -4528,16 +4779,26 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 
 			const int32 LocalNumSaturated = GNumSaturatedConnections;
 
+			// Connections that got a ViewTarget since the parallel tasks started are prioritized the usual way
+			FParallelConnectionPriorities* ConnectionPriorities = ParallelPriorities.IsValidIndex( i ) && ParallelPriorities[i].Connection == Connection ? &ParallelPriorities[i] : nullptr;
+
 			// Make a list of viewers this connection should consider (this connection and children of this connection)
 			TArray<FNetViewer>& ConnectionViewers = WorldSettings->ReplicationViewers;
 
-			ConnectionViewers.Reset();
-			new( ConnectionViewers )FNetViewer( Connection, DeltaSeconds );
-			for ( int32 ViewerIndex = 0; ViewerIndex < Connection->Children.Num(); ViewerIndex++ )
+			if ( ConnectionPriorities )
+			{
+				ConnectionViewers = MoveTemp( ConnectionPriorities->ConnectionViewers );
+			}
+			else
 			{
-				if ( Connection->Children[ViewerIndex]->ViewTarget != NULL )
+				ConnectionViewers.Reset();
+				new( ConnectionViewers )FNetViewer( Connection, DeltaSeconds );
+				for ( int32 ViewerIndex = 0; ViewerIndex < Connection->Children.Num(); ViewerIndex++ )
 				{
-					new( ConnectionViewers )FNetViewer( Connection->Children[ViewerIndex], DeltaSeconds );
+					if ( Connection->Children[ViewerIndex]->ViewTarget != NULL )
+					{
+						new( ConnectionViewers )FNetViewer( Connection->Children[ViewerIndex], DeltaSeconds );
+					}
 				}
 			}
 
@@ -4561,8 +4822,43 @@ int32 UNetDriver::ServerReplicateActors(float DeltaSeconds)
 			FActorPriority* PriorityList	= NULL;
 			FActorPriority** PriorityActors = NULL;
 
-			// Get a sorted list of actors for this connection
-			const int32 FinalSortedCount = ServerReplicateActors_PrioritizeActors( Connection, ConnectionViewers, ConsiderList, bCPUSaturated, PriorityList, PriorityActors );
+			int32 FinalSortedCount = 0;
+
+			if ( ConnectionPriorities )
+			{
+				// Apply what the task deferred, before replicating like ServerReplicateActors_PrioritizeActors would have
+				for ( UActorChannel* Channel : ConnectionPriorities->ChannelsToClose )
+				{
+					Channel->Close( EChannelCloseReason::Relevancy );
+				}
+
+				for ( UActorChannel* Channel : ConnectionPriorities->ChannelsToStartBecomingDormant )
+				{
+					Channel->StartBecomingDormant();
+				}
+
+				PriorityActors = ConnectionPriorities->PriorityActors.GetData();
+				FinalSortedCount = ConnectionPriorities->PriorityActors.Num();
+
+				if ( DebugRelevantActors )
+				{
+					for ( const FActorPriority& ActorPriority : ConnectionPriorities->PriorityList )
+					{
+						if ( ActorPriority.ActorInfo )
+						{
+							LastPrioritizedActors.Add( ActorPriority.ActorInfo->Actor );
+						}
+					}
+				}
+
+				SET_DWORD_STAT( STAT_PrioritizedActors, FinalSortedCount );
+				SET_DWORD_STAT( STAT_NumRelevantDeletedActors, ConnectionPriorities->DeletedCount );
+			}
+			else
+			{
+				// Get a sorted list of actors for this connection
+				FinalSortedCount = ServerReplicateActors_PrioritizeActors( Connection, ConnectionViewers, ConsiderList, bCPUSaturated, PriorityList, PriorityActors );
+			}
 
 			// Process the sorted list of actors for this connection
 			const int32 LastProcessedActor = ServerReplicateActors_ProcessPrioritizedActors( Connection, ConnectionViewers, PriorityActors, FinalSortedCount, Updated );
@@ -21,6 +21,7 @@
 #include "Net/NetworkGranularMemoryLogging.h"
 #include "Serialization/ArchiveCountMem.h"
 #include "Templates/AndOrNot.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 DECLARE_CYCLE_STAT(TEXT("RepLayout AddPropertyCmd"), STAT_RepLayout_AddPropertyCmd, STATGROUP_Game);
 DECLARE_CYCLE_STAT(TEXT("RepLayout InitFromObjectClass"), STAT_RepLayout_InitFromObjectClass, STATGROUP_Game);
@@ -48,6 +49,9 @@ static FAutoConsoleVariableRef CVarNetShareSerializedData(TEXT("net.ShareSeriali
 int32 GNetVerifyShareSerializedData = 0;
 static FAutoConsoleVariableRef CVarNetVerifyShareSerializedData(TEXT("net.VerifyShareSerializedData"), GNetVerifyShareSerializedData, TEXT(""));
 
+int32 GNetShareSerializedChangelists = 1;
+static FAutoConsoleVariableRef CVarNetShareSerializedChangelists(TEXT("net.ShareSerializedChangelists"), GNetShareSerializedChangelists, TEXT("If true and net.ShareSerializedData is enabled, connections sending the same changelist for an object in the same frame copy the bits the first one serialized."));
+
 int32 LogSkippedRepNotifies = 0;
 static FAutoConsoleVariable CVarLogSkippedRepNotifies(TEXT("Net.LogSkippedRepNotifies"), LogSkippedRepNotifies, TEXT("Log when the networking code skips calling a repnotify clientside due to the property value not changing."), ECVF_Default);
 
@@ -65,6 +69,8 @@ int32 MaxRepArrayMemory = UNetworkSettings::DefaultMaxRepArrayMemory;
 
 extern int32 GNumSharedSerializationHit;
 extern int32 GNumSharedSerializationMiss;
+extern int32 GNumSharedChangelistHit;
+extern int32 GNumSharedChangelistMiss;
 
 extern TAutoConsoleVariable<int32> CVarNetEnableDetailedScopeCounters;
 
@@ -887,13 +893,24 @@ FRepChangelistState::FRepChangelistState(
 	HistoryStart(0),
 	HistoryEnd(0),
 	CompareIndex(0),
-	StaticBuffer(InRepLayout->CreateShadowBuffer(Source))
+	StaticBuffer(InRepLayout->CreateShadowBuffer(Source)),
+	PushModelObject(nullptr)
 {}
 
+FRepChangelistState::~FRepChangelistState()
+{
+	if (PushModelObject)
+	{
+		UEPushModelPrivate::RemoveDirtyListener(PushModelObject, &PushModelDirtyBits);
+	}
+}
+
 void FRepChangelistState::CountBytes(FArchive& Ar) const
 {
 	StaticBuffer.CountBytes(Ar);
 	SharedSerialization.CountBytes(Ar);
+	SerializedChangelists.CountBytes(Ar);
+	PushModelDirtyBits.CountBytes(Ar);
 
 	if (CustomDeltaChangelistState)
 	{
@@ -1060,6 +1077,13 @@ static void CompareParentProperties(
 
 	const bool bCheckForRole = EnumHasAnyFlags(SharedParams.Flags, ERepLayoutFlags::IsActor) && RepState != nullptr;
 
+	// Objects that started replicating while Push Model was disabled aren't tracked, and compare everything
+	const bool bUsePushModel = IS_PUSH_MODEL_ENABLED() && RepChangelistState->PushModelObject != nullptr;
+	TBitArray<>& PushModelDirtyBits = RepChangelistState->PushModelDirtyBits;
+
+	uint32 NumCompared = 0;
+	uint32 NumSkippedPushBased = 0;
+
 	for (uint16 ParentIndex = 0; ParentIndex < SharedParams.Parents.Num(); ++ParentIndex)
 	{
 		const FRepParentCmd& Parent = SharedParams.Parents[ParentIndex];
@@ -1092,12 +1116,30 @@ static void CompareParentProperties(
 				continue;
 			}
 		}
+
+		// Push based properties are left alone until they're marked dirty. The dirty bit is only cleared here, so
+		// properties that were skipped above because they're inactive still get compared once they're active again.
+		if (bUsePushModel && EnumHasAnyFlags(Parent.Flags, ERepParentFlags::IsPushBased))
+		{
+			if (!PushModelDirtyBits[ParentIndex])
+			{
+				++NumSkippedPushBased;
+				continue;
+			}
+
+			PushModelDirtyBits[ParentIndex] = false;
+		}
+
+		++NumCompared;
 		
 		// Note, Handle - 1 to account for CompareProperties_r incrementing handles.
 		const FRepLayoutCmd& Cmd = SharedParams.Cmds[Parent.CmdStart];
 		const uint16 Handle = Cmd.RelativeHandle;
 		CompareProperties_r(SharedParams, Parent.CmdStart, Parent.CmdEnd, ShadowData, Data, Changed, Handle - 1);
 	}
+
+	INC_DWORD_STAT_BY(STAT_NetComparedProperties, NumCompared);
+	INC_DWORD_STAT_BY(STAT_NetSkippedPushBasedProperties, NumSkippedPushBased);
 }
 
 static uint16 CompareProperties_r(
@@ -1252,6 +1294,7 @@ bool FRepLayout::CompareProperties(
 
 	// New changes found so clear any existing shared serialization state
 	RepChangelistState->SharedSerialization.Reset();
+	RepChangelistState->SerializedChangelists.Reset();
 
 	// If we're full, merge the oldest up, so we always have room for a new entry
 	if ((RepChangelistState->HistoryEnd - RepChangelistState->HistoryStart) == FRepChangelistState::MAX_CHANGE_HISTORY)
@@ -1383,6 +1426,8 @@ bool FRepLayout::ReplicateProperties(
 		RepState->LastChangelistIndex = RepChangelistState->HistoryStart;
 	}
 
+	const int32 FirstChangelistIndex = RepState->LastChangelistIndex;
+
 	const int32 PossibleNewHistoryIndex = RepState->HistoryEnd % FSendingRepState::MAX_CHANGE_HISTORY;
 
 	FRepChangedHistory& PossibleNewHistoryItem = RepState->ChangeHistory[PossibleNewHistoryIndex];
@@ -1480,7 +1525,15 @@ bool FRepLayout::ReplicateProperties(
 	}
 	else if (Changed.Num() > 0)
 	{
-		SendProperties(RepState, ChangeTracker, Data, ObjectClass, Writer, Changed, RepChangelistState->SharedSerialization);
+		if ((GNetSharedSerializedData != 0) && (GNetShareSerializedChangelists != 0))
+		{
+			RepChangelistState->SerializedChangelists.BeginFrame(OwningChannel->Connection->Driver->ReplicationFrame);
+			SendProperties_SharedChangelist(RepState, ChangeTracker, Data, ObjectClass, Writer, Changed, RepChangelistState->SharedSerialization, FirstChangelistIndex, RepChangelistState->SerializedChangelists);
+		}
+		else
+		{
+			SendProperties(RepState, ChangeTracker, Data, ObjectClass, Writer, Changed, RepChangelistState->SharedSerialization);
+		}
 	}
 
 	// See if something actually sent (this may be false due to conditional checks inside the send properties function
@@ -2219,6 +2272,114 @@ void FRepLayout::SendProperties(
 	}
 }
 
+void FRepLayout::SendProperties_SharedChangelist(
+	FSendingRepState* RESTRICT RepState,
+	FRepChangedPropertyTracker* ChangedTracker,
+	const FConstRepObjectDataBuffer Data,
+	UClass* ObjectClass,
+	FNetBitWriter& Writer,
+	TArray<uint16>& Changed,
+	const FRepSerializationSharedInfo& SharedInfo,
+	const int32 FirstChangelistIndex,
+	FRepSerializedChangelistCache& SerializedChangelists) const
+{
+#ifdef ENABLE_PROPERTY_CHECKSUMS
+	const bool bDoChecksum = (GDoPropertyChecksum == 1);
+#else
+	const bool bDoChecksum = false;
+#endif
+
+#if USE_NETWORK_PROFILER
+	// The profiler tracks each property that's sent, which copying a whole changelist would skip
+	if (GNetworkProfiler.IsTrackingEnabled())
+	{
+		SendProperties(RepState, ChangedTracker, Data, ObjectClass, Writer, Changed, SharedInfo);
+		return;
+	}
+#endif
+
+	if (const FRepSerializedChangelist* SerializedChangelist = SerializedChangelists.Find(FirstChangelistIndex, Changed, bDoChecksum))
+	{
+		UE_LOG(LogRepProperties, VeryVerbose, TEXT("SendProperties_SharedChangelist: Hit, Owner=%s, FirstChangelistIndex=%d, NumBits=%lld"), *Owner->GetPathName(), FirstChangelistIndex, SerializedChangelist->NumBits);
+		GNumSharedChangelistHit++;
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+		if (GNetVerifyShareSerializedData != 0)
+		{
+			FBitWriterMark BitWriterMark(Writer);
+
+			SendProperties(RepState, ChangedTracker, Data, ObjectClass, Writer, Changed, SharedInfo);
+
+			TArray<uint8> StandardBuffer;
+			BitWriterMark.Copy(Writer, StandardBuffer);
+			const int64 StandardNumBits = Writer.GetNumBits() - BitWriterMark.GetNumBits();
+			BitWriterMark.Pop(Writer);
+
+			if (StandardNumBits != SerializedChangelist->NumBits || StandardBuffer != SerializedChangelist->SerializedBits)
+			{
+				UE_LOG(LogRep, Error, TEXT("Shared changelist serialization data mismatch! Owner=%s"), *Owner->GetPathName());
+			}
+		}
+#endif
+
+		if (SerializedChangelist->NumBits > 0)
+		{
+			Writer.SerializeBits(const_cast<uint8*>(SerializedChangelist->SerializedBits.GetData()), SerializedChangelist->NumBits);
+		}
+
+		return;
+	}
+
+	GNumSharedChangelistMiss++;
+
+	FBitWriterMark BitWriterMark(Writer);
+
+	SendProperties(RepState, ChangedTracker, Data, ObjectClass, Writer, Changed, SharedInfo);
+
+	if (!Writer.IsError() && !SerializedChangelists.IsFull() && IsSharedSerializationChangelist(Changed))
+	{
+		FRepSerializedChangelist& SerializedChangelist = SerializedChangelists.SerializedChangelists.AddDefaulted_GetRef();
+		SerializedChangelist.FirstChangelistIndex = FirstChangelistIndex;
+		SerializedChangelist.Changed = Changed;
+		SerializedChangelist.bDoChecksum = bDoChecksum;
+		SerializedChangelist.NumBits = Writer.GetNumBits() - BitWriterMark.GetNumBits();
+		BitWriterMark.Copy(Writer, SerializedChangelist.SerializedBits);
+	}
+}
+
+bool FRepLayout::IsSharedSerializationChangelist(const TArray<uint16>& Changed) const
+{
+	FChangelistIterator ChangelistIterator(Changed, 0);
+	FRepHandleIterator HandleIterator(Owner, ChangelistIterator, Cmds, BaseHandleToCmdIndex, 0, 1, 0, Cmds.Num() - 1);
+
+	while (HandleIterator.NextHandle())
+	{
+		const FRepLayoutCmd& Cmd = Cmds[HandleIterator.CmdIndex];
+
+		if (Cmd.Type == ERepLayoutCmdType::DynamicArray)
+		{
+			// Elements aren't checked one by one, the array is shared if every property its elements hold is
+			for (int32 ElementCmdIndex = HandleIterator.CmdIndex + 1; ElementCmdIndex < Cmd.EndCmd - 1; ++ElementCmdIndex)
+			{
+				const FRepLayoutCmd& ElementCmd = Cmds[ElementCmdIndex];
+
+				if (ElementCmd.Type != ERepLayoutCmdType::DynamicArray && ElementCmd.Type != ERepLayoutCmdType::Return && !EnumHasAnyFlags(ElementCmd.Flags, ERepLayoutCmdFlags::IsSharedSerialization))
+				{
+					return false;
+				}
+			}
+
+			HandleIterator.JumpOverArray();
+		}
+		else if (!EnumHasAnyFlags(Cmd.Flags, ERepLayoutCmdFlags::IsSharedSerialization))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 static FORCEINLINE void WritePropertyHandle_BackwardsCompatible(
 	FNetBitWriter&	Writer,
 	uint32			NetFieldExportHandle,
@@ -5198,6 +5359,12 @@ void FRepLayout::InitFromClass(
 
 		Parents[ParentIndex].Flags |= ERepParentFlags::IsLifetime;
 
+		if (LifetimeProps[i].bIsPushBased)
+		{
+			Parents[ParentIndex].Flags |= ERepParentFlags::IsPushBased;
+			Flags |= ERepLayoutFlags::HasPushBasedProperties;
+		}
+
 		if (LifetimeProps[i].Condition == COND_None)
 		{
 			Parents[ParentIndex].Flags &= ~ERepParentFlags::IsConditional;
@@ -5988,7 +6155,18 @@ TSharedPtr<FReplicationChangelistMgr> FRepLayout::CreateReplicationChangelistMgr
 		ShadowStateSource = (const uint8*)InObject;
 	}
 
-	return MakeShareable(new FReplicationChangelistMgr(AsShared(), ShadowStateSource, DeltaChangelistState));
+	TSharedPtr<FReplicationChangelistMgr> ChangelistMgr = MakeShareable(new FReplicationChangelistMgr(AsShared(), ShadowStateSource, DeltaChangelistState));
+
+	if (IS_PUSH_MODEL_ENABLED() && EnumHasAnyFlags(Flags, ERepLayoutFlags::HasPushBasedProperties))
+	{
+		// The shadow state starts out as the archetype, so everything is dirty until it's been compared once
+		FRepChangelistState& ChangelistState = ChangelistMgr->RepChangelistState;
+		ChangelistState.PushModelObject = InObject;
+		ChangelistState.PushModelDirtyBits.Init(true, Parents.Num());
+		UEPushModelPrivate::AddDirtyListener(InObject, &ChangelistState.PushModelDirtyBits);
+	}
+
+	return ChangelistMgr;
 }
 
 TUniquePtr<FRepState> FRepLayout::CreateRepState(
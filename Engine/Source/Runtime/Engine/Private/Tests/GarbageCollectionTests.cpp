@@ -0,0 +1,243 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/GarbageCollection.h"
+#include "UObject/WeakObjectPtr.h"
+#include "Commandlets/GCBenchmarkCommandlet.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace GarbageCollectionTests
+{
+	/**
+	 * Builds a random graph of old and young objects, collects garbage and returns which of the young objects survived.
+	 * The graph only depends on Seed so a minor and a full collection can be compared.
+	 */
+	TArray<bool> CollectRandomGraph(int32 Seed, bool bMinorCollection)
+	{
+		const int32 NumOldObjects = 64;
+		const int32 NumYoungObjects = 1024;
+		const int32 NumOldToYoungReferences = 16;
+		const int32 NumPendingKillObjects = 64;
+
+		FRandomStream Random(Seed);
+
+		UGCBenchmarkObject* Anchor = NewObject<UGCBenchmarkObject>(GetTransientPackage());
+		Anchor->AddToRoot();
+		TArray<UGCBenchmarkObject*> OldObjects;
+		for (int32 Index = 0; Index < NumOldObjects; ++Index)
+		{
+			UGCBenchmarkObject* OldObject = NewObject<UGCBenchmarkObject>(Anchor);
+			Anchor->References.Add(OldObject);
+			OldObjects.Add(OldObject);
+		}
+
+		// Everything created so far becomes old
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+		// Young objects are outered to a young object so that only references keep them alive
+		UGCBenchmarkObject* Scratch = NewObject<UGCBenchmarkObject>(GetTransientPackage());
+		TArray<UGCBenchmarkObject*> YoungObjects;
+		TArray<FWeakObjectPtr> WeakYoungObjects;
+		for (int32 Index = 0; Index < NumYoungObjects; ++Index)
+		{
+			UGCBenchmarkObject* YoungObject = NewObject<UGCBenchmarkObject>(Scratch);
+			YoungObjects.Add(YoungObject);
+			WeakYoungObjects.Add(YoungObject);
+		}
+		for (UGCBenchmarkObject* YoungObject : YoungObjects)
+		{
+			const int32 NumReferences = Random.RandHelper(3);
+			for (int32 Index = 0; Index < NumReferences; ++Index)
+			{
+				if (Random.FRand() < 0.9f)
+				{
+					YoungObject->References.Add(YoungObjects[Random.RandHelper(NumYoungObjects)]);
+				}
+				else
+				{
+					YoungObject->References.Add(OldObjects[Random.RandHelper(NumOldObjects)]);
+				}
+			}
+		}
+
+		// Old to young references are the only way to reach young objects from the root set, written natively
+		for (int32 Index = 0; Index < NumOldToYoungReferences; ++Index)
+		{
+			OldObjects[Random.RandHelper(NumOldObjects)]->References.Add(YoungObjects[Random.RandHelper(NumYoungObjects)]);
+		}
+
+		for (int32 Index = 0; Index < NumPendingKillObjects; ++Index)
+		{
+			YoungObjects[Random.RandHelper(NumYoungObjects)]->MarkPendingKill();
+		}
+
+		if (bMinorCollection)
+		{
+			CollectMinorGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			IncrementalPurgeGarbage(false);
+		}
+		else
+		{
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		}
+
+		TArray<bool> Survived;
+		for (const FWeakObjectPtr& WeakYoungObject : WeakYoungObjects)
+		{
+			Survived.Add(!WeakYoungObject.IsStale(true));
+		}
+
+		Anchor->RemoveFromRoot();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+		return Survived;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinorGarbageCollectionTest, "System.Engine.GarbageCollection.Minor Collection", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMinorGarbageCollectionTest::RunTest(const FString& Parameters)
+{
+	using namespace GarbageCollectionTests;
+
+	IConsoleVariable* MinorCollectionsPerMajorVar = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.MinorCollectionsPerMajor"));
+	if (!MinorCollectionsPerMajorVar)
+	{
+		AddError(TEXT("gc.MinorCollectionsPerMajor not found"));
+		return false;
+	}
+	const int32 PreviousMinorCollectionsPerMajor = MinorCollectionsPerMajorVar->GetInt();
+	MinorCollectionsPerMajorVar->Set(1);
+
+	for (int32 Seed = 0; Seed < 4; ++Seed)
+	{
+		const int32 NumMinorCollectionsBefore = GetGarbageCollectionStats().NumMinorCollections;
+		const TArray<bool> SurvivedMinor = CollectRandomGraph(Seed, true);
+		TestEqual(TEXT("Young objects must be tracked after a full collection"), GetGarbageCollectionStats().NumMinorCollections, NumMinorCollectionsBefore + 1);
+
+		const TArray<bool> SurvivedFull = CollectRandomGraph(Seed, false);
+
+		int32 NumDeletedByMinor = 0;
+		int32 NumDeletedByFullOnly = 0;
+		bool bKeptEverythingReachable = true;
+		for (int32 Index = 0; Index < SurvivedMinor.Num(); ++Index)
+		{
+			bKeptEverythingReachable &= SurvivedMinor[Index] || !SurvivedFull[Index];
+			NumDeletedByMinor += !SurvivedMinor[Index];
+			NumDeletedByFullOnly += SurvivedMinor[Index] && !SurvivedFull[Index];
+		}
+		TestTrue(TEXT("Minor collection must not delete objects a full collection keeps"), bKeptEverythingReachable);
+		TestTrue(TEXT("Minor collection must delete unreachable young objects"), NumDeletedByMinor > 0);
+		// Every old object is reachable, so young objects are collected exactly like a full collection would
+		TestEqual(TEXT("Minor collection must delete every young object a full collection deletes"), NumDeletedByFullOnly, 0);
+	}
+
+	MinorCollectionsPerMajorVar->Set(PreviousMinorCollectionsPerMajor);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinorGarbageCollectionNativeWriteTest, "System.Engine.GarbageCollection.Minor Collection Native Writes", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMinorGarbageCollectionNativeWriteTest::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* MinorCollectionsPerMajorVar = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.MinorCollectionsPerMajor"));
+	if (!MinorCollectionsPerMajorVar)
+	{
+		AddError(TEXT("gc.MinorCollectionsPerMajor not found"));
+		return false;
+	}
+	const int32 PreviousMinorCollectionsPerMajor = MinorCollectionsPerMajorVar->GetInt();
+	MinorCollectionsPerMajorVar->Set(1);
+
+	UGCBenchmarkObject* OldObject = NewObject<UGCBenchmarkObject>(GetTransientPackage());
+	OldObject->AddToRoot();
+
+	// Everything created so far becomes old and young objects are tracked from here on
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+	// All references below are written natively, without GCWriteBarrier
+	UGCBenchmarkObject* Scratch = NewObject<UGCBenchmarkObject>(GetTransientPackage());
+	UGCBenchmarkObject* YoungOuter = NewObject<UGCBenchmarkObject>(GetTransientPackage());
+	UGCBenchmarkObject* OuteredToOld = NewObject<UGCBenchmarkObject>(OldObject);
+	UGCBenchmarkObject* OuteredToYoung = NewObject<UGCBenchmarkObject>(YoungOuter);
+	UGCBenchmarkObject* PendingKill = NewObject<UGCBenchmarkObject>(Scratch);
+	UGCBenchmarkObject* Unreferenced = NewObject<UGCBenchmarkObject>(Scratch);
+	OldObject->References.Add(OuteredToOld);
+	OldObject->References.Add(PendingKill);
+	OldObject->References.Add(OuteredToYoung);
+	PendingKill->MarkPendingKill();
+
+	FWeakObjectPtr WeakOuteredToOld(OuteredToOld);
+	FWeakObjectPtr WeakOuteredToYoung(OuteredToYoung);
+	FWeakObjectPtr WeakYoungOuter(YoungOuter);
+	FWeakObjectPtr WeakPendingKill(PendingKill);
+	FWeakObjectPtr WeakUnreferenced(Unreferenced);
+
+	const int32 NumMinorCollectionsBefore = GetGarbageCollectionStats().NumMinorCollections;
+	CollectMinorGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	IncrementalPurgeGarbage(false);
+	TestEqual(TEXT("Collection must have been a minor one"), GetGarbageCollectionStats().NumMinorCollections, NumMinorCollectionsBefore + 1);
+
+	TestFalse(TEXT("Young object outered to an old object must survive a minor collection"), WeakOuteredToOld.IsStale(true));
+	TestFalse(TEXT("Young object with a young outer referenced by an old object must survive a minor collection"), WeakOuteredToYoung.IsStale(true));
+	TestFalse(TEXT("Young outer of a reachable young object must survive a minor collection"), WeakYoungOuter.IsStale(true));
+	TestTrue(TEXT("Pending kill young object must be deleted by a minor collection"), WeakPendingKill.IsStale(true));
+	TestTrue(TEXT("Minor collection must clear the reference to the pending kill object"), OldObject->References.Num() == 3 && OldObject->References[1] == nullptr);
+	TestTrue(TEXT("Unreferenced young object must be deleted by a minor collection"), WeakUnreferenced.IsStale(true));
+
+	MinorCollectionsPerMajorVar->Set(PreviousMinorCollectionsPerMajor);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+	TestFalse(TEXT("Young object outered to an old object must survive a full collection"), WeakOuteredToOld.IsStale(true));
+	TestFalse(TEXT("Young object with a young outer must survive a full collection"), WeakOuteredToYoung.IsStale(true));
+
+	OldObject->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinorGarbageCollectionVerifyTest, "System.Engine.GarbageCollection.Minor Collection Verification", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMinorGarbageCollectionVerifyTest::RunTest(const FString& Parameters)
+{
+	IConsoleVariable* MinorCollectionsPerMajorVar = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.MinorCollectionsPerMajor"));
+	IConsoleVariable* VerifyMinorCollectionVar = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.VerifyMinorCollection"));
+	if (!MinorCollectionsPerMajorVar || !VerifyMinorCollectionVar)
+	{
+		AddError(TEXT("gc.MinorCollectionsPerMajor or gc.VerifyMinorCollection not found"));
+		return false;
+	}
+	const int32 PreviousMinorCollectionsPerMajor = MinorCollectionsPerMajorVar->GetInt();
+	const int32 PreviousVerifyMinorCollection = VerifyMinorCollectionVar->GetInt();
+	MinorCollectionsPerMajorVar->Set(1);
+	VerifyMinorCollectionVar->Set(1);
+
+	// Young objects are tracked from here on
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+	FWeakObjectPtr WeakUnreferenced(NewObject<UGCBenchmarkObject>(GetTransientPackage()));
+
+	// The full analysis replaces the result of the minor one, so the collection is a full one
+	const FGarbageCollectionStats StatsBefore = GetGarbageCollectionStats();
+	CollectMinorGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	IncrementalPurgeGarbage(false);
+	TestEqual(TEXT("Verified minor collection must not count as a minor collection"), GetGarbageCollectionStats().NumMinorCollections, StatsBefore.NumMinorCollections);
+	TestEqual(TEXT("Verified minor collection must count as a full collection"), GetGarbageCollectionStats().NumMajorCollections, StatsBefore.NumMajorCollections + 1);
+	TestTrue(TEXT("Unreferenced young object must be deleted by a verified minor collection"), WeakUnreferenced.IsStale(true));
+
+	VerifyMinorCollectionVar->Set(PreviousVerifyMinorCollection);
+	MinorCollectionsPerMajorVar->Set(PreviousMinorCollectionsPerMajor);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
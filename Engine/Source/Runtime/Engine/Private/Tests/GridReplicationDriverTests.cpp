@@ -0,0 +1,166 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/DemoNetDriver.h"
+#include "Engine/DemoNetConnection.h"
+#include "Engine/NetworkObjectList.h"
+#include "Engine/GridReplicationDriver.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+extern int32 GSetNetDormancyEnabled;
+
+namespace GridReplicationDriverTests
+{
+	/** Spawns a replicated actor, with a scene component root unless bWithRoot is false */
+	AActor* SpawnActor(UWorld* World, const FVector& Location, bool bWithRoot = true)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		if (bWithRoot)
+		{
+			USceneComponent* Root = NewObject<USceneComponent>(Actor);
+			Actor->SetRootComponent(Root);
+			Root->RegisterComponent();
+			Actor->SetActorLocation(Location);
+		}
+		Actor->SetReplicates(true);
+		return Actor;
+	}
+}
+
+/**
+ * Routes actors through the grid replication driver and checks that a connection finds the same ones relevant
+ * as AActor::IsNetRelevantFor, that dormancy is read the same way as the default path, and that actors without
+ * a root component aren't put in the grid.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridReplicationDriverRelevancyTest, "System.Engine.Networking.GridReplicationDriver.Relevancy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FGridReplicationDriverRelevancyTest::RunTest(const FString& Parameters)
+{
+	using namespace GridReplicationDriverTests;
+
+	// IsNetRelevantFor warns about the actors without a root component
+	AddExpectedError(TEXT("has no root component"), EAutomationExpectedErrorFlags::Contains, 0);
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	UDemoNetDriver* NetDriver = NewObject<UDemoNetDriver>();
+	UDemoNetConnection* Connection = NewObject<UDemoNetConnection>();
+
+	// The viewer, its connection owns what it owns
+	APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+	PlayerController->Player = Connection;
+	PlayerController->NetConnection = Connection;
+
+	TArray<FNetViewer> ConnectionViewers;
+	FNetViewer& Viewer = ConnectionViewers.AddDefaulted_GetRef();
+	Viewer.Connection = Connection;
+	Viewer.InViewer = PlayerController;
+	Viewer.ViewTarget = PlayerController;
+	Viewer.ViewLocation = FVector::ZeroVector;
+
+	struct FTestActor
+	{
+		const TCHAR* Description;
+		AActor* Actor;
+	};
+	TArray<FTestActor> TestActors;
+
+	AActor* NearActor = SpawnActor(World, FVector(1000.0f, 0.0f, 0.0f));
+	TestActors.Add({ TEXT("Near actor"), NearActor });
+
+	AActor* FarActor = SpawnActor(World, FVector(100000.0f, 0.0f, 0.0f));
+	TestActors.Add({ TEXT("Far actor"), FarActor });
+
+	AActor* HiddenActor = SpawnActor(World, FVector(1000.0f, 0.0f, 0.0f));
+	HiddenActor->SetHidden(true);
+	TestActors.Add({ TEXT("Hidden actor"), HiddenActor });
+
+	AActor* OwnedHiddenActor = SpawnActor(World, FVector(1000.0f, 0.0f, 0.0f));
+	OwnedHiddenActor->SetHidden(true);
+	OwnedHiddenActor->SetOwner(PlayerController);
+	TestActors.Add({ TEXT("Hidden actor owned by the viewer"), OwnedHiddenActor });
+
+	// Out of its cull distance, but the viewer owns it
+	AActor* OwnedActor = SpawnActor(World, FVector(5000.0f, 0.0f, 0.0f));
+	OwnedActor->NetCullDistanceSquared = FMath::Square(1000.0f);
+	OwnedActor->SetOwner(PlayerController);
+	TestActors.Add({ TEXT("Actor owned by the viewer out of its cull distance"), OwnedActor });
+
+	AActor* OwnerOnlyActor = SpawnActor(World, FVector(100000.0f, 0.0f, 0.0f));
+	OwnerOnlyActor->bOnlyRelevantToOwner = true;
+	OwnerOnlyActor->SetOwner(PlayerController);
+	TestActors.Add({ TEXT("Owner only actor owned by the viewer"), OwnerOnlyActor });
+
+	AActor* UnownedOwnerOnlyActor = SpawnActor(World, FVector(1000.0f, 0.0f, 0.0f));
+	UnownedOwnerOnlyActor->bOnlyRelevantToOwner = true;
+	TestActors.Add({ TEXT("Owner only actor without an owner"), UnownedOwnerOnlyActor });
+
+	AActor* RootlessActor = SpawnActor(World, FVector::ZeroVector, false);
+	TestActors.Add({ TEXT("Actor without a root component"), RootlessActor });
+
+	AActor* OwnedRootlessActor = SpawnActor(World, FVector::ZeroVector, false);
+	OwnedRootlessActor->SetOwner(PlayerController);
+	TestActors.Add({ TEXT("Actor without a root component owned by the viewer"), OwnedRootlessActor });
+
+	UGridReplicationDriver* Driver = NewObject<UGridReplicationDriver>();
+	Driver->CellSize = 10000.0f;
+	Driver->MaxCellsPerActor = 64;
+	Driver->SetRepDriverWorld(World);
+	Driver->InitForNetDriver(NetDriver);
+
+	for (const FTestActor& TestActor : TestActors)
+	{
+		NetDriver->FindOrAddNetworkObjectInfo(TestActor.Actor);
+		Driver->AddNetworkActor(TestActor.Actor);
+	}
+
+	TestEqual(TEXT("Every actor is added to the driver"), Driver->GetNumActors(), TestActors.Num());
+	TestTrue(TEXT("Actors with a root component are in the grid"), Driver->IsActorInGrid(NearActor) && Driver->IsActorInGrid(HiddenActor));
+	TestFalse(TEXT("Actors without a root component aren't in the grid"), Driver->IsActorInGrid(RootlessActor) || Driver->IsActorInGrid(OwnedRootlessActor));
+	TestFalse(TEXT("Owner only actors aren't in the grid"), Driver->IsActorInGrid(OwnerOnlyActor) || Driver->IsActorInGrid(UnownedOwnerOnlyActor));
+
+	for (const FTestActor& TestActor : TestActors)
+	{
+		const bool bExpected = TestActor.Actor->IsNetRelevantFor(Viewer.InViewer, Viewer.ViewTarget, Viewer.ViewLocation);
+		TestEqual(FString::Printf(TEXT("%s is relevant the same as with the default driver"), TestActor.Description), Driver->IsActorRelevantToConnection(TestActor.Actor, Connection, ConnectionViewers), bExpected);
+	}
+
+	// Owner only and grid actors are both skipped once they're dormant on the connection
+	TestFalse(TEXT("Owner only actor isn't dormant before it's marked"), Driver->IsActorDormantOnConnection(OwnerOnlyActor, Connection));
+	TestFalse(TEXT("Grid actor isn't dormant before it's marked"), Driver->IsActorDormantOnConnection(NearActor, Connection));
+
+	NetDriver->GetNetworkObjectList().MarkDormant(OwnerOnlyActor, Connection, 1, NetDriver);
+	NetDriver->GetNetworkObjectList().MarkDormant(NearActor, Connection, 1, NetDriver);
+
+	for (const FTestActor& TestActor : TestActors)
+	{
+		const FNetworkObjectInfo* NetworkObjectInfo = NetDriver->FindNetworkObjectInfo(TestActor.Actor);
+		const bool bExpected = GSetNetDormancyEnabled != 0 && NetworkObjectInfo && NetworkObjectInfo->DormantConnections.Contains(TWeakObjectPtr<UNetConnection>(Connection));
+		TestEqual(FString::Printf(TEXT("%s is dormant the same as with the default driver"), TestActor.Description), Driver->IsActorDormantOnConnection(TestActor.Actor, Connection), bExpected);
+	}
+
+	Driver->TearDown();
+
+	PlayerController->Player = nullptr;
+	PlayerController->NetConnection = nullptr;
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
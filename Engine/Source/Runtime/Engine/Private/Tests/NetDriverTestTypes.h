@@ -0,0 +1,49 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Async/ParallelFor.h"
+#include "Misc/MemStack.h"
+#include "Engine/NetDriver.h"
+#include "Engine/DemoNetDriver.h"
+#include "NetDriverTestTypes.generated.h"
+
+/**
+ * Net driver giving tests access to the steps of ServerReplicateActors without any sockets.
+ */
+UCLASS(transient)
+class UPrioritizeActorsTestNetDriver : public UDemoNetDriver
+{
+	GENERATED_BODY()
+
+public:
+
+#if WITH_SERVER_CODE
+	/** Prioritizes ConsiderList for a connection the way ServerReplicateActors does by default, in the order the actors would be sent */
+	TArray<FActorPriority> PrioritizeActors(UNetConnection* Connection, const TArray<FNetViewer>& ConnectionViewers, const TArray<FNetworkObjectInfo*>& ConsiderList)
+	{
+		FMemMark Mark(FMemStack::Get());
+		FActorPriority* PriorityList = nullptr;
+		FActorPriority** PriorityActors = nullptr;
+		const int32 FinalSortedCount = ServerReplicateActors_PrioritizeActors(Connection, ConnectionViewers, ConsiderList, false, PriorityList, PriorityActors);
+
+		TArray<FActorPriority> SortedPriorities;
+		for (int32 Index = 0; Index < FinalSortedCount; ++Index)
+		{
+			SortedPriorities.Add(*PriorityActors[Index]);
+		}
+		return SortedPriorities;
+	}
+
+	/** Prioritizes ConsiderList for all connections at once the way ServerReplicateActors does with net.ParallelPrioritizeActors */
+	void PrioritizeActorsParallel(TArray<FParallelConnectionPriorities>& ConnectionPriorities, const TArray<FNetworkObjectInfo*>& ConsiderList) const
+	{
+		ParallelFor(ConnectionPriorities.Num(), [this, &ConnectionPriorities, &ConsiderList](int32 Index)
+		{
+			ServerReplicateActors_PrioritizeActorsParallel(ConnectionPriorities[Index], ConsiderList, false);
+		});
+	}
+#endif
+};
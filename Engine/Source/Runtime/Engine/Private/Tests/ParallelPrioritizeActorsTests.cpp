@@ -0,0 +1,141 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/DemoNetConnection.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Tests/NetDriverTestTypes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_SERVER_CODE
+
+/**
+ * Prioritizes the same actors for many connections with the net.ParallelPrioritizeActors path and with the default
+ * one, and checks that every connection gets the same priorities in the same send order.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParallelPrioritizeActorsTest, "System.Engine.Networking.ParallelPrioritizeActors", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FParallelPrioritizeActorsTest::RunTest(const FString& Parameters)
+{
+	const int32 NumConnections = 64;
+	const int32 NumActors = 512;
+	const float WorldExtent = 40000.0f;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	UPrioritizeActorsTestNetDriver* NetDriver = NewObject<UPrioritizeActorsTestNetDriver>();
+	NetDriver->SetWorld(World);
+
+	FRandomStream Random(0x5eed);
+	auto RandomLocation = [&Random, WorldExtent]()
+	{
+		return FVector(Random.FRandRange(-WorldExtent, WorldExtent), Random.FRandRange(-WorldExtent, WorldExtent), 0.0f);
+	};
+
+	// One player controller per connection, looking in a random direction
+	TArray<APlayerController*> PlayerControllers;
+	TArray<FParallelConnectionPriorities> ConnectionPriorities;
+	ConnectionPriorities.SetNum(NumConnections);
+	for (int32 ConnectionIndex = 0; ConnectionIndex < NumConnections; ++ConnectionIndex)
+	{
+		UDemoNetConnection* Connection = NewObject<UDemoNetConnection>();
+		Connection->Driver = NetDriver;
+		Connection->SetClientWorldPackageName(World->GetOutermost()->GetFName());
+
+		APlayerController* PlayerController = World->SpawnActor<APlayerController>(RandomLocation(), FRotator(0.0f, Random.FRandRange(0.0f, 360.0f), 0.0f));
+		PlayerController->Player = Connection;
+		PlayerController->NetConnection = Connection;
+		Connection->PlayerController = PlayerController;
+		Connection->OwningActor = PlayerController;
+		Connection->ViewTarget = PlayerController;
+		PlayerControllers.Add(PlayerController);
+
+		FNetViewer& Viewer = ConnectionPriorities[ConnectionIndex].ConnectionViewers.AddDefaulted_GetRef();
+		Viewer.Connection = Connection;
+		Viewer.InViewer = PlayerController;
+		Viewer.ViewTarget = PlayerController;
+		Viewer.ViewLocation = PlayerController->GetActorLocation();
+		Viewer.ViewDir = PlayerController->GetActorRotation().Vector();
+		ConnectionPriorities[ConnectionIndex].Connection = Connection;
+	}
+
+	// Actors spread over the world with every kind of relevancy that changes what a connection prioritizes
+	TArray<FNetworkObjectInfo*> ConsiderList;
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		USceneComponent* Root = NewObject<USceneComponent>(Actor);
+		Actor->SetRootComponent(Root);
+		Root->RegisterComponent();
+		Actor->SetActorLocation(RandomLocation());
+		Actor->SetReplicates(true);
+		Actor->NetPriority = Random.FRandRange(0.5f, 3.0f);
+
+		switch (ActorIndex % 8)
+		{
+			case 0:
+				Actor->bAlwaysRelevant = true;
+				break;
+			case 1:
+				Actor->bOnlyRelevantToOwner = true;
+				Actor->SetOwner(PlayerControllers[Random.RandHelper(NumConnections)]);
+				break;
+			case 2:
+				Actor->SetOwner(PlayerControllers[Random.RandHelper(NumConnections)]);
+				break;
+			case 3:
+				Actor->SetHidden(true);
+				break;
+			default:
+				break;
+		}
+
+		ConsiderList.Add(NetDriver->FindOrAddNetworkObjectInfo(Actor));
+	}
+
+	NetDriver->PrioritizeActorsParallel(ConnectionPriorities, ConsiderList);
+
+	int32 NumPrioritized = 0;
+	for (int32 ConnectionIndex = 0; ConnectionIndex < NumConnections; ++ConnectionIndex)
+	{
+		const FParallelConnectionPriorities& Parallel = ConnectionPriorities[ConnectionIndex];
+		const TArray<FActorPriority> Serial = NetDriver->PrioritizeActors(Parallel.Connection, Parallel.ConnectionViewers, ConsiderList);
+
+		bool bSame = Serial.Num() == Parallel.PriorityActors.Num();
+		for (int32 Index = 0; bSame && Index < Serial.Num(); ++Index)
+		{
+			const FActorPriority& ParallelPriority = *Parallel.PriorityActors[Index];
+			bSame = Serial[Index].ActorInfo == ParallelPriority.ActorInfo
+				&& Serial[Index].DestructionInfo == ParallelPriority.DestructionInfo
+				&& Serial[Index].Channel == ParallelPriority.Channel
+				&& Serial[Index].Priority == ParallelPriority.Priority;
+		}
+		TestTrue(FString::Printf(TEXT("Connection %d gets the same priorities in the same order from both paths"), ConnectionIndex), bSame);
+		TestTrue(FString::Printf(TEXT("Connection %d has nothing to close or put to sleep"), ConnectionIndex), Parallel.ChannelsToClose.Num() == 0 && Parallel.ChannelsToStartBecomingDormant.Num() == 0);
+		NumPrioritized += Serial.Num();
+	}
+	TestTrue(TEXT("Connections prioritize some but not all of the actors"), NumPrioritized > 0 && NumPrioritized < NumConnections * NumActors);
+
+	for (APlayerController* PlayerController : PlayerControllers)
+	{
+		PlayerController->Player = nullptr;
+		PlayerController->NetConnection = nullptr;
+	}
+	NetDriver->SetWorld(nullptr);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS && WITH_SERVER_CODE
@@ -1381,8 +1381,22 @@ void UEngine::PerformGarbageCollectionAndCleanupActors()
 	// to block on loading the remaining data.
 	if (!IsAsyncLoading())
 	{
-		// Perform housekeeping.
-		if (TryCollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false))
+		// Perform housekeeping. With incremental reachability analysis each call only advances marking by one time slice
+		// and the GC timer stays expired until the collection completes.
+		bool bCollected = false;
+		if (IsIncrementalReachabilityAnalysisAllowed())
+		{
+			bCollected = IncrementalCollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+		else if (ShouldCollectMinorGarbage())
+		{
+			bCollected = TryCollectMinorGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		}
+		else
+		{
+			bCollected = TryCollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, false);
+		}
+		if (bCollected)
 		{
 			ForEachObjectOfClass(UWorld::StaticClass(), [](UObject* World)
 			{
@@ -0,0 +1,42 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "GridReplicationBenchmarkActor.generated.h"
+
+/**
+ * This AGridReplicationBenchmarkActor class is used to measure how much server CPU time replicating lots of actors to
+ * lots of connections takes, with the legacy UNetDriver path or a replication driver such as UGridReplicationDriver.
+ * On the server, each actor moves by up to MoveDistance on MoveChance of its ticks, and replicates its movement.
+ *
+ * Net.GridReplicationBenchmark spawns them, adds simulated connections viewing from other benchmark actors spread over
+ * the same area, and replicates to them every frame for a number of frames before logging the time it took.
+ * Run it on a dedicated server without clients (-nullrhi), once with the replication driver and once with
+ * -RepDriverDisable to compare both. On the legacy path, changing net.ParallelPrioritizeActors between runs measures how
+ * prioritizing connections on several tasks scales.
+ */
+UCLASS(transient, notplaceable)
+class AGridReplicationBenchmarkActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGridReplicationBenchmarkActor();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Chance for the actor to move each tick, from 0 to 1 */
+	float MoveChance;
+
+	/** Farthest the actor moves in one tick */
+	float MoveDistance;
+
+	/** Half the size of the square the actor stays in, centered on the origin */
+	float Extent;
+
+	UPROPERTY(Replicated)
+	int32 MoveCount;
+};
@@ -0,0 +1,52 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "PushModelTestActor.generated.h"
+
+/**
+ * This APushModelTestActor class is used to measure the cost of comparing replicated properties on servers with lots
+ * of replicated actors that rarely change, with and without Push Model (net.IsPushModelEnabled).
+ * Every property is push based except PolledValue, which is always compared. On the server, each actor changes one
+ * push based property on ChangeChance of its ticks, and marks it dirty.
+ *
+ * Spawn them on a listen or dedicated server with Net.SpawnPushModelTestActors, then compare "stat game" (Dynamic
+ * Property Compare Time, Compared Properties and Skipped Push Based Properties) and "stat net" with Push Model on and off.
+ */
+UCLASS(transient, notplaceable)
+class APushModelTestActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	APushModelTestActor();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Chance for the actor to change a property each tick, from 0 to 1 */
+	float ChangeChance;
+
+	UPROPERTY(Replicated)
+	int32 PushedInt;
+
+	UPROPERTY(Replicated)
+	float PushedFloat;
+
+	UPROPERTY(Replicated)
+	FVector PushedVector;
+
+	UPROPERTY(Replicated)
+	FString PushedString;
+
+	UPROPERTY(Replicated)
+	TArray<int32> PushedArray;
+
+	UPROPERTY(Replicated)
+	int32 PushedStaticArray[4];
+
+	UPROPERTY(Replicated)
+	int32 PolledValue;
+};
@@ -292,6 +292,89 @@ private:
 	bool bIsValid;
 };
 
+/** Everything SendProperties wrote for one changelist, for connections that send the exact same changelist */
+struct FRepSerializedChangelist
+{
+	FRepSerializedChangelist():
+		FirstChangelistIndex(0),
+		NumBits(0),
+		bDoChecksum(false)
+	{}
+
+	/** First changelist history index that was merged into Changed. */
+	int32 FirstChangelistIndex;
+
+	/** The changelist that was sent, after filtering. */
+	TArray<uint16> Changed;
+
+	/** The serialized changelist, starting at bit 0. */
+	TArray<uint8> SerializedBits;
+
+	/** Number of bits in SerializedBits. */
+	int64 NumBits;
+
+	/** Whether property checksums were written. */
+	bool bDoChecksum;
+};
+
+/**
+ * Changelists of one object that were serialized during a replication frame.
+ * Only changelists whose properties all support shared serialization are kept, since others depend on the connection's package map.
+ */
+struct FRepSerializedChangelistCache
+{
+	/** Most changelists kept per frame, connections that fell behind by different amounts send different changelists. */
+	static const int32 MaxChangelists = 4;
+
+	FRepSerializedChangelistCache():
+		ReplicationFrame(0)
+	{}
+
+	/** Drops changelists serialized in a different replication frame. */
+	void BeginFrame(const uint32 InReplicationFrame)
+	{
+		if (ReplicationFrame != InReplicationFrame)
+		{
+			Reset();
+			ReplicationFrame = InReplicationFrame;
+		}
+	}
+
+	void Reset()
+	{
+		SerializedChangelists.Reset();
+	}
+
+	const FRepSerializedChangelist* Find(const int32 FirstChangelistIndex, const TArray<uint16>& Changed, const bool bDoChecksum) const
+	{
+		return SerializedChangelists.FindByPredicate([&](const FRepSerializedChangelist& SerializedChangelist)
+		{
+			return SerializedChangelist.FirstChangelistIndex == FirstChangelistIndex && SerializedChangelist.bDoChecksum == bDoChecksum && SerializedChangelist.Changed == Changed;
+		});
+	}
+
+	bool IsFull() const
+	{
+		return SerializedChangelists.Num() >= MaxChangelists;
+	}
+
+	void CountBytes(FArchive& Ar) const
+	{
+		SerializedChangelists.CountBytes(Ar);
+
+		for (const FRepSerializedChangelist& SerializedChangelist : SerializedChangelists)
+		{
+			SerializedChangelist.Changed.CountBytes(Ar);
+			SerializedChangelist.SerializedBits.CountBytes(Ar);
+		}
+	}
+
+	TArray<FRepSerializedChangelist> SerializedChangelists;
+
+	/** Replication frame the changelists were serialized in. */
+	uint32 ReplicationFrame;
+};
+
 /**
  * Represents a single changelist, tracking changed properties.
  *
@@ -436,6 +519,20 @@ public:
 	/** Latest state of all shared serialization data. */
 	FRepSerializationSharedInfo SharedSerialization;
 
+	/** Changelists sent this frame, copied by connections that send the same one (see net.ShareSerializedChangelists). */
+	FRepSerializedChangelistCache SerializedChangelists;
+
+	/**
+	 * Object whose push based properties are tracked in PushModelDirtyBits, or null if every property is compared.
+	 * Only used to stop tracking, the object may already be destroyed.
+	 */
+	const UObject* PushModelObject;
+
+	/** One bit per parent command, set when a push based property is marked dirty and cleared once it's compared. */
+	TBitArray<> PushModelDirtyBits;
+
+	~FRepChangelistState();
+
 	void CountBytes(FArchive& Ar) const;
 };
 
@@ -702,6 +799,7 @@ enum class ERepParentFlags : uint32
 	IsZeroConstructible	= (1 << 6),	//! This property is ZeroConstructible.
 	IsFastArray			= (1 << 7), //! This property is a FastArraySerializer. This can't be a ERepLayoutCmdType, because
 									//! these Custom Delta structs will have their inner properties tracked.
+	IsPushBased			= (1 << 8),	//! This property is only compared after it's marked dirty, when Push Model is enabled.
 };
 
 ENUM_CLASS_FLAGS(ERepParentFlags)
@@ -996,6 +1094,7 @@ enum class ERepLayoutFlags : uint8
 {
 	None = 0,
 	IsActor = 1 << 1,	//! This RepLayout is for AActor or a subclass of AActor.
+	HasPushBasedProperties = 1 << 2,	//! At least one lifetime property is only compared after it's marked dirty.
 };
 ENUM_CLASS_FLAGS(ERepLayoutFlags);
 
@@ -1103,6 +1202,7 @@ private:
 	friend class UPackageMapClient;
 	friend class FNetSerializeCB;
 	friend struct FCustomDeltaPropertyIterator;
+	friend class FRepLayoutSharedChangelistTest;
 
 	FRepLayout();
 
@@ -1494,6 +1594,27 @@ private:
 		TArray<uint16>& Changed,
 		const FRepSerializationSharedInfo& SharedInfo) const;
 
+	/**
+	 * Same as SendProperties, but copies the serialized changelist from SerializedChangelists when another connection
+	 * already sent the same one this frame, and adds it there otherwise when every property in it supports shared serialization.
+	 *
+	 * @param FirstChangelistIndex	First changelist history index that was merged into Changed.
+	 * @param SerializedChangelists	Changelists of this object that were already serialized this frame.
+	 */
+	void SendProperties_SharedChangelist(
+		FSendingRepState* RESTRICT RepState,
+		FRepChangedPropertyTracker* ChangedTracker,
+		const FConstRepObjectDataBuffer Data,
+		UClass* ObjectClass,
+		FNetBitWriter& Writer,
+		TArray<uint16>& Changed,
+		const FRepSerializationSharedInfo& SharedInfo,
+		const int32 FirstChangelistIndex,
+		FRepSerializedChangelistCache& SerializedChangelists) const;
+
+	/** Returns whether serializing Changed doesn't depend on the connection, ie every property it can write supports shared serialization. */
+	bool IsSharedSerializationChangelist(const TArray<uint16>& Changed) const;
+
 	/**
 	 * Clamps a changelist so that it conforms to the current size of either an array, or arrays within structs/arrays.
 	 *
@@ -15,6 +15,7 @@
 #include "UObject/CoreNet.h"
 #include "EngineLogs.h"
 #include "UObject/UnrealType.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 class AActor;
 
@@ -68,6 +69,12 @@ struct ENGINE_API FDoRepLifetimeParams
 	 * properly set up to handle RepNotifies.
 	 */
 	ELifetimeRepNotifyCondition RepNotifyCondition = REPNOTIFY_OnChanged;
+
+	/**
+	 * Whether the property is only compared for changes after it's been marked dirty with MARK_PROPERTY_DIRTY,
+	 * instead of every time the object is considered for replication. See PushModel.h.
+	 */
+	bool bIsPushBased = false;
 };
 
 /*-----------------------------------------------------------------------------
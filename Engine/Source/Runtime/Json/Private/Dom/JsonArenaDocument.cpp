@@ -0,0 +1,244 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Dom/JsonArenaDocument.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Serialization/JsonUtf8Reader.h"
+
+bool FJsonArenaDocument::Parse(const ANSICHAR* Data, int32 Size)
+{
+	Reset();
+
+	FJsonUtf8Reader Reader(Data, Size);
+
+	// Every value starts at one of the reader's offsets and unescaping never makes a string longer, so neither array grows
+	Nodes.Reserve(Reader.GetNumStructurals());
+	Strings.Reserve(Size);
+
+	struct FOpenNode
+	{
+		int32 Index;
+		int32 LastChild;
+	};
+	TArray<FOpenNode, TInlineAllocator<32>> OpenNodes;
+
+	EJsonNotation Notation;
+	while (Reader.ReadNext(Notation))
+	{
+		if (Notation == EJsonNotation::Error)
+		{
+			Reset();
+			ErrorMessage = Reader.GetErrorMessage();
+			return false;
+		}
+
+		if (Notation == EJsonNotation::ObjectEnd || Notation == EJsonNotation::ArrayEnd)
+		{
+			OpenNodes.Pop(false);
+			continue;
+		}
+
+		const int32 Index = Nodes.AddUninitialized();
+		FNode& Node = Nodes[Index];
+		Node.NumChildren = 0;
+		Node.NextSibling = INDEX_NONE;
+		Node.KeyOffset = INDEX_NONE;
+		Node.KeyLen = 0;
+		Node.Number = 0.0;
+
+		if (OpenNodes.Num() > 0)
+		{
+			FOpenNode& Parent = OpenNodes.Top();
+			FNode& ParentNode = Nodes[Parent.Index];
+			++ParentNode.NumChildren;
+			if (Parent.LastChild != INDEX_NONE)
+			{
+				Nodes[Parent.LastChild].NextSibling = Index;
+			}
+			Parent.LastChild = Index;
+
+			if (ParentNode.Type == EJson::Object)
+			{
+				const FAnsiStringView Key = Reader.GetIdentifier();
+				Node.KeyOffset = AddString(Key);
+				Node.KeyLen = Key.Len();
+			}
+		}
+
+		switch (Notation)
+		{
+		case EJsonNotation::ObjectStart:
+			Node.Type = EJson::Object;
+			OpenNodes.Add({ Index, INDEX_NONE });
+			break;
+
+		case EJsonNotation::ArrayStart:
+			Node.Type = EJson::Array;
+			OpenNodes.Add({ Index, INDEX_NONE });
+			break;
+
+		case EJsonNotation::String:
+			{
+				const FAnsiStringView String = Reader.GetValueAsUtf8();
+				Node.Type = EJson::String;
+				Node.String.Offset = AddString(String);
+				Node.String.Len = String.Len();
+			}
+			break;
+
+		case EJsonNotation::Number:
+			Node.Type = EJson::Number;
+			Node.Number = Reader.GetValueAsNumber();
+			break;
+
+		case EJsonNotation::Boolean:
+			Node.Type = EJson::Boolean;
+			Node.bBool = Reader.GetValueAsBoolean();
+			break;
+
+		default:
+			Node.Type = EJson::Null;
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool FJsonArenaDocument::Parse(TArrayView<const uint8> Data)
+{
+	return Parse((const ANSICHAR*)Data.GetData(), Data.Num());
+}
+
+void FJsonArenaDocument::Reset()
+{
+	Nodes.Reset();
+	Strings.Reset();
+	ErrorMessage.Empty();
+}
+
+int32 FJsonArenaDocument::AddString(FAnsiStringView String)
+{
+	const int32 Offset = Strings.Num();
+	Strings.Append(String.Data(), String.Len());
+	return Offset;
+}
+
+EJson FJsonArenaValue::GetType() const
+{
+	return Document ? Document->Nodes[Index].Type : EJson::None;
+}
+
+double FJsonArenaValue::AsNumber() const
+{
+	return GetType() == EJson::Number ? Document->Nodes[Index].Number : 0.0;
+}
+
+bool FJsonArenaValue::AsBool() const
+{
+	return GetType() == EJson::Boolean ? Document->Nodes[Index].bBool : false;
+}
+
+FAnsiStringView FJsonArenaValue::AsUtf8() const
+{
+	if (GetType() != EJson::String)
+	{
+		return FAnsiStringView("", 0);
+	}
+
+	const FJsonArenaDocument::FNode& Node = Document->Nodes[Index];
+	return Document->GetString(Node.String.Offset, Node.String.Len);
+}
+
+FString FJsonArenaValue::AsString() const
+{
+	return FJsonUtf8Reader::Utf8ToString(AsUtf8());
+}
+
+FAnsiStringView FJsonArenaValue::GetKey() const
+{
+	if (!Document || Document->Nodes[Index].KeyOffset == INDEX_NONE)
+	{
+		return FAnsiStringView("", 0);
+	}
+
+	const FJsonArenaDocument::FNode& Node = Document->Nodes[Index];
+	return Document->GetString(Node.KeyOffset, Node.KeyLen);
+}
+
+int32 FJsonArenaValue::Num() const
+{
+	return Document ? Document->Nodes[Index].NumChildren : 0;
+}
+
+FJsonArenaValue FJsonArenaValue::GetFirstChild() const
+{
+	// Values are stored in the order they appear in, so the first child comes right after its parent
+	return FJsonArenaValue(Document, Num() > 0 ? Index + 1 : INDEX_NONE);
+}
+
+FJsonArenaValue FJsonArenaValue::GetNextSibling() const
+{
+	return FJsonArenaValue(Document, Document ? Document->Nodes[Index].NextSibling : INDEX_NONE);
+}
+
+FJsonArenaValue FJsonArenaValue::GetField(FAnsiStringView Name) const
+{
+	if (GetType() != EJson::Object)
+	{
+		return FJsonArenaValue();
+	}
+
+	// The last member with the name wins, like it does when parsing into a FJsonObject
+	FJsonArenaValue Found;
+	for (FJsonArenaValue Member = GetFirstChild(); Member.IsValid(); Member = Member.GetNextSibling())
+	{
+		if (Member.GetKey() == Name)
+		{
+			Found = Member;
+		}
+	}
+	return Found;
+}
+
+TSharedPtr<FJsonValue> FJsonArenaValue::ToJsonValue() const
+{
+	switch (GetType())
+	{
+	case EJson::Object:
+		{
+			TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+			for (FJsonArenaValue Member = GetFirstChild(); Member.IsValid(); Member = Member.GetNextSibling())
+			{
+				Object->Values.Add(FJsonUtf8Reader::Utf8ToString(Member.GetKey()), Member.ToJsonValue());
+			}
+			return MakeShared<FJsonValueObject>(Object);
+		}
+
+	case EJson::Array:
+		{
+			TArray<TSharedPtr<FJsonValue>> Array;
+			Array.Reserve(Num());
+			for (FJsonArenaValue Element = GetFirstChild(); Element.IsValid(); Element = Element.GetNextSibling())
+			{
+				Array.Add(Element.ToJsonValue());
+			}
+			return MakeShared<FJsonValueArray>(Array);
+		}
+
+	case EJson::String:
+		return MakeShared<FJsonValueString>(AsString());
+
+	case EJson::Number:
+		return MakeShared<FJsonValueNumber>(AsNumber());
+
+	case EJson::Boolean:
+		return MakeShared<FJsonValueBoolean>(AsBool());
+
+	case EJson::Null:
+		return MakeShared<FJsonValueNull>();
+
+	default:
+		return nullptr;
+	}
+}
@@ -0,0 +1,942 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Serialization/JsonUtf8Reader.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Misc/Parse.h"
+#include <string.h>
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
+
+namespace JsonUtf8Reader
+{
+	/** Bit masks of one 64 byte block, bit N is byte N */
+	struct FBlockMasks
+	{
+		uint64 Quote;
+		uint64 Backslash;
+		uint64 Structural;
+		uint64 Whitespace;
+	};
+
+	static FORCEINLINE bool IsStructural(ANSICHAR Char)
+	{
+		return Char == '{' || Char == '}' || Char == '[' || Char == ']' || Char == ':' || Char == ',';
+	}
+
+	static FORCEINLINE bool IsWhitespace(ANSICHAR Char)
+	{
+		return Char == ' ' || Char == '\t' || Char == '\n' || Char == '\r';
+	}
+
+	static FORCEINLINE bool IsDigit(ANSICHAR Char)
+	{
+		return Char >= '0' && Char <= '9';
+	}
+
+	static FORCEINLINE bool IsNonZeroDigit(ANSICHAR Char)
+	{
+		return Char >= '1' && Char <= '9';
+	}
+
+	static FORCEINLINE bool IsJsonNumber(ANSICHAR Char)
+	{
+		return IsDigit(Char) || Char == '-' || Char == '.' || Char == '+' || Char == 'e' || Char == 'E';
+	}
+
+	static FORCEINLINE bool IsAlpha(ANSICHAR Char)
+	{
+		return (Char >= 'a' && Char <= 'z') || (Char >= 'A' && Char <= 'Z');
+	}
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	static FORCEINLINE uint64 MoveMask64(__m128i A, __m128i B, __m128i C, __m128i D)
+	{
+		return (uint64)(uint32)_mm_movemask_epi8(A)
+			| ((uint64)(uint32)_mm_movemask_epi8(B) << 16)
+			| ((uint64)(uint32)_mm_movemask_epi8(C) << 32)
+			| ((uint64)(uint32)_mm_movemask_epi8(D) << 48);
+	}
+
+	static FORCEINLINE __m128i CompareAny(__m128i Chars, __m128i A, __m128i B, __m128i C)
+	{
+		return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(Chars, A), _mm_cmpeq_epi8(Chars, B)), _mm_cmpeq_epi8(Chars, C));
+	}
+
+	static FORCEINLINE void ClassifyBlock(const ANSICHAR* Block, FBlockMasks& OutMasks)
+	{
+		const __m128i Quote = _mm_set1_epi8('"');
+		const __m128i Backslash = _mm_set1_epi8('\\');
+		const __m128i CurlyOpen = _mm_set1_epi8('{');
+		const __m128i CurlyClose = _mm_set1_epi8('}');
+		const __m128i SquareOpen = _mm_set1_epi8('[');
+		const __m128i SquareClose = _mm_set1_epi8(']');
+		const __m128i Colon = _mm_set1_epi8(':');
+		const __m128i Comma = _mm_set1_epi8(',');
+		const __m128i Space = _mm_set1_epi8(' ');
+		const __m128i Tab = _mm_set1_epi8('\t');
+		const __m128i LineFeed = _mm_set1_epi8('\n');
+		const __m128i CarriageReturn = _mm_set1_epi8('\r');
+
+		__m128i QuoteBits[4];
+		__m128i BackslashBits[4];
+		__m128i StructuralBits[4];
+		__m128i WhitespaceBits[4];
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			const __m128i Chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Block + Index * 16));
+			QuoteBits[Index] = _mm_cmpeq_epi8(Chars, Quote);
+			BackslashBits[Index] = _mm_cmpeq_epi8(Chars, Backslash);
+			StructuralBits[Index] = _mm_or_si128(CompareAny(Chars, CurlyOpen, CurlyClose, SquareOpen), CompareAny(Chars, SquareClose, Colon, Comma));
+			WhitespaceBits[Index] = _mm_or_si128(CompareAny(Chars, Space, Tab, LineFeed), _mm_cmpeq_epi8(Chars, CarriageReturn));
+		}
+
+		OutMasks.Quote = MoveMask64(QuoteBits[0], QuoteBits[1], QuoteBits[2], QuoteBits[3]);
+		OutMasks.Backslash = MoveMask64(BackslashBits[0], BackslashBits[1], BackslashBits[2], BackslashBits[3]);
+		OutMasks.Structural = MoveMask64(StructuralBits[0], StructuralBits[1], StructuralBits[2], StructuralBits[3]);
+		OutMasks.Whitespace = MoveMask64(WhitespaceBits[0], WhitespaceBits[1], WhitespaceBits[2], WhitespaceBits[3]);
+	}
+#else
+	static FORCEINLINE void ClassifyBlock(const ANSICHAR* Block, FBlockMasks& OutMasks)
+	{
+		OutMasks = FBlockMasks{ 0, 0, 0, 0 };
+		for (int32 Index = 0; Index < 64; ++Index)
+		{
+			const ANSICHAR Char = Block[Index];
+			const uint64 Bit = 1ull << Index;
+			OutMasks.Quote |= Char == '"' ? Bit : 0;
+			OutMasks.Backslash |= Char == '\\' ? Bit : 0;
+			OutMasks.Structural |= IsStructural(Char) ? Bit : 0;
+			OutMasks.Whitespace |= IsWhitespace(Char) ? Bit : 0;
+		}
+	}
+#endif
+
+	/** Returns the bits of the characters escaped by a backslash. bInOutEscapeNext carries a trailing backslash to the next block. */
+	static FORCEINLINE uint64 FindEscaped(uint64 Backslash, bool& bInOutEscapeNext)
+	{
+		uint64 Escaped = 0;
+		if (bInOutEscapeNext)
+		{
+			Escaped = 1;
+			Backslash &= ~1ull;
+			bInOutEscapeNext = false;
+		}
+
+		while (Backslash)
+		{
+			const uint64 Index = FPlatformMath::CountTrailingZeros64(Backslash);
+			if (Index == 63)
+			{
+				bInOutEscapeNext = true;
+				break;
+			}
+
+			// The character after an escaping backslash is escaped, even if it's another backslash
+			Escaped |= 1ull << (Index + 1);
+			Backslash &= Index == 62 ? 0 : ~((1ull << (Index + 2)) - 1);
+		}
+		return Escaped;
+	}
+
+	/** Returns the bits from the first set bit of Mask up to the next, both included, and so on */
+	static FORCEINLINE uint64 PrefixXor(uint64 Mask)
+	{
+		Mask ^= Mask << 1;
+		Mask ^= Mask << 2;
+		Mask ^= Mask << 4;
+		Mask ^= Mask << 8;
+		Mask ^= Mask << 16;
+		Mask ^= Mask << 32;
+		return Mask;
+	}
+
+	static void EncodeUtf8(uint32 CodePoint, TArray<ANSICHAR>& Out)
+	{
+		if (CodePoint < 0x80)
+		{
+			Out.Add((ANSICHAR)CodePoint);
+		}
+		else if (CodePoint < 0x800)
+		{
+			Out.Add((ANSICHAR)(0xC0 | (CodePoint >> 6)));
+			Out.Add((ANSICHAR)(0x80 | (CodePoint & 0x3F)));
+		}
+		else if (CodePoint < 0x10000)
+		{
+			Out.Add((ANSICHAR)(0xE0 | (CodePoint >> 12)));
+			Out.Add((ANSICHAR)(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Out.Add((ANSICHAR)(0x80 | (CodePoint & 0x3F)));
+		}
+		else
+		{
+			Out.Add((ANSICHAR)(0xF0 | (CodePoint >> 18)));
+			Out.Add((ANSICHAR)(0x80 | ((CodePoint >> 12) & 0x3F)));
+			Out.Add((ANSICHAR)(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Out.Add((ANSICHAR)(0x80 | (CodePoint & 0x3F)));
+		}
+	}
+}
+
+FJsonUtf8Reader::FJsonUtf8Reader(const ANSICHAR* InData, int32 InSize)
+	: Data(InData)
+	, Size(InSize)
+	, StructuralIndex(0)
+	, UnterminatedStringOffset(INDEX_NONE)
+	, CurrentToken(EJsonToken::None)
+	, Identifier("", 0)
+	, StringValue("", 0)
+	, NumberString("", 0)
+	, NumberValue(0.0)
+	, bFinishedReadingRootObject(false)
+{
+	while (Size > 0 && Data[Size - 1] == '\0')
+	{
+		--Size;
+	}
+	if (Size >= 3 && (uint8)Data[0] == 0xEF && (uint8)Data[1] == 0xBB && (uint8)Data[2] == 0xBF)
+	{
+		Data += 3;
+		Size -= 3;
+	}
+
+	IndexStructurals();
+}
+
+FJsonUtf8Reader::FJsonUtf8Reader(TArrayView<const uint8> InData)
+	: FJsonUtf8Reader((const ANSICHAR*)InData.GetData(), InData.Num())
+{
+}
+
+void FJsonUtf8Reader::IndexStructurals()
+{
+	using namespace JsonUtf8Reader;
+
+	// Most Json has a structural every few bytes, growing from here keeps reallocation rare
+	Structurals.Reserve(Size / 4 + 64);
+
+	bool bEscapeNext = false;
+	uint64 InString = 0;
+	// The start of the buffer can start a number or literal just like whitespace can
+	uint64 PreviousEndsValue = 1;
+
+	ANSICHAR TailBlock[64];
+	for (int32 BlockStart = 0; BlockStart < Size; BlockStart += 64)
+	{
+		const ANSICHAR* Block = Data + BlockStart;
+		if (Size - BlockStart < 64)
+		{
+			FMemory::Memset(TailBlock, ' ', sizeof(TailBlock));
+			FMemory::Memcpy(TailBlock, Block, Size - BlockStart);
+			Block = TailBlock;
+		}
+
+		FBlockMasks Masks;
+		ClassifyBlock(Block, Masks);
+
+		const uint64 Escaped = (Masks.Backslash || bEscapeNext) ? FindEscaped(Masks.Backslash, bEscapeNext) : 0;
+		const uint64 Quotes = Masks.Quote & ~Escaped;
+
+		// Set from an opening quote up to but not including its closing quote
+		const uint64 StringMask = PrefixXor(Quotes) ^ InString;
+		InString = (uint64)((int64)StringMask >> 63);
+
+		const uint64 Structural = Masks.Structural & ~StringMask;
+		const uint64 Whitespace = Masks.Whitespace & ~StringMask;
+
+		// Numbers and literals start after a structural or whitespace
+		const uint64 EndsValue = Structural | Whitespace;
+		const uint64 ValueStarts = ((EndsValue << 1) | PreviousEndsValue) & ~(Masks.Whitespace | Masks.Quote | StringMask);
+		PreviousEndsValue = EndsValue >> 63;
+
+		uint64 Tokens = Structural | Quotes | ValueStarts;
+		const int32 ValidBits = FMath::Min(Size - BlockStart, 64);
+		if (ValidBits < 64)
+		{
+			Tokens &= (1ull << ValidBits) - 1;
+		}
+
+		if (Tokens)
+		{
+			int32 Count = (int32)FPlatformMath::CountBits(Tokens);
+			int32 Num = Structurals.AddUninitialized(Count);
+			int32* Out = Structurals.GetData() + Num;
+			while (Tokens)
+			{
+				*Out++ = BlockStart + (int32)FPlatformMath::CountTrailingZeros64(Tokens);
+				Tokens &= Tokens - 1;
+			}
+		}
+	}
+
+	if (InString)
+	{
+		// The last quote opened a string that never closed
+		for (int32 Index = Structurals.Num() - 1; Index >= 0; --Index)
+		{
+			if (Data[Structurals[Index]] == '"')
+			{
+				UnterminatedStringOffset = Structurals[Index];
+				break;
+			}
+		}
+	}
+}
+
+void FJsonUtf8Reader::SetErrorMessage(const TCHAR* Message, int32 Offset)
+{
+	uint32 LineNumber = 1;
+	int32 LineStart = 0;
+	for (int32 Index = 0; Index < Offset && Index < Size; ++Index)
+	{
+		if (Data[Index] == '\n')
+		{
+			++LineNumber;
+			LineStart = Index + 1;
+		}
+	}
+	ErrorMessage = FString(Message) + FString::Printf(TEXT(" Line: %u Ch: %u"), LineNumber, (uint32)(Offset - LineStart + 1));
+}
+
+bool FJsonUtf8Reader::ReadNext(EJsonNotation& Notation)
+{
+	if (!ErrorMessage.IsEmpty())
+	{
+		Notation = EJsonNotation::Error;
+		return false;
+	}
+
+	const bool bAtEnd = StructuralIndex >= Structurals.Num();
+
+	if (bAtEnd && !bFinishedReadingRootObject)
+	{
+		Notation = EJsonNotation::Error;
+		SetErrorMessage(TEXT("Improperly formatted."), Size);
+		return true;
+	}
+
+	if (bFinishedReadingRootObject && !bAtEnd)
+	{
+		Notation = EJsonNotation::Error;
+		SetErrorMessage(TEXT("Unexpected additional input found."), Structurals[StructuralIndex]);
+		return true;
+	}
+
+	if (bAtEnd)
+	{
+		return false;
+	}
+
+	Identifier = FAnsiStringView("", 0);
+
+	bool bReadWasSuccess = false;
+	if (ParseState.Num() == 0)
+	{
+		bReadWasSuccess = ReadStart();
+	}
+	else if (ParseState.Top() == EJson::Array)
+	{
+		bReadWasSuccess = ReadNextArrayValue();
+	}
+	else
+	{
+		bReadWasSuccess = ReadNextObjectValue();
+	}
+
+	switch (CurrentToken)
+	{
+	case EJsonToken::CurlyOpen:		Notation = EJsonNotation::ObjectStart; break;
+	case EJsonToken::CurlyClose:	Notation = EJsonNotation::ObjectEnd; break;
+	case EJsonToken::SquareOpen:	Notation = EJsonNotation::ArrayStart; break;
+	case EJsonToken::SquareClose:	Notation = EJsonNotation::ArrayEnd; break;
+	case EJsonToken::String:		Notation = EJsonNotation::String; break;
+	case EJsonToken::Number:		Notation = EJsonNotation::Number; break;
+	case EJsonToken::True:
+	case EJsonToken::False:			Notation = EJsonNotation::Boolean; break;
+	case EJsonToken::Null:			Notation = EJsonNotation::Null; break;
+	default:						Notation = EJsonNotation::Error; break;
+	}
+	bFinishedReadingRootObject = ParseState.Num() == 0;
+
+	if (!bReadWasSuccess || Notation == EJsonNotation::Error)
+	{
+		Notation = EJsonNotation::Error;
+
+		if (ErrorMessage.IsEmpty())
+		{
+			SetErrorMessage(TEXT("Unknown Error Occurred"), StructuralIndex > 0 ? Structurals[StructuralIndex - 1] : 0);
+		}
+	}
+
+	return true;
+}
+
+bool FJsonUtf8Reader::SkipObject()
+{
+	return ReadUntilMatching(EJsonNotation::ObjectEnd);
+}
+
+bool FJsonUtf8Reader::SkipArray()
+{
+	return ReadUntilMatching(EJsonNotation::ArrayEnd);
+}
+
+bool FJsonUtf8Reader::ReadUntilMatching(const EJsonNotation ExpectedNotation)
+{
+	uint32 ScopeCount = 0;
+	EJsonNotation Notation;
+
+	while (ReadNext(Notation))
+	{
+		if ((ScopeCount == 0) && (Notation == ExpectedNotation))
+		{
+			return true;
+		}
+
+		switch (Notation)
+		{
+		case EJsonNotation::ObjectStart:
+		case EJsonNotation::ArrayStart:
+			++ScopeCount;
+			break;
+
+		case EJsonNotation::ObjectEnd:
+		case EJsonNotation::ArrayEnd:
+			--ScopeCount;
+			break;
+
+		case EJsonNotation::Error:
+			return false;
+
+		default:
+			break;
+		}
+	}
+
+	return true;
+}
+
+TSharedPtr<FJsonValue> FJsonUtf8Reader::ReadValueAsJsonValue(EJsonNotation Notation)
+{
+	switch (Notation)
+	{
+	case EJsonNotation::String:
+		return MakeShared<FJsonValueString>(GetValueAsString());
+
+	case EJsonNotation::Number:
+		return MakeShared<FJsonValueNumber>(NumberValue);
+
+	case EJsonNotation::Boolean:
+		return MakeShared<FJsonValueBoolean>(GetValueAsBoolean());
+
+	case EJsonNotation::Null:
+		return MakeShared<FJsonValueNull>();
+
+	case EJsonNotation::ObjectStart:
+		{
+			TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+			EJsonNotation MemberNotation;
+			while (ReadNext(MemberNotation) && MemberNotation != EJsonNotation::Error)
+			{
+				if (MemberNotation == EJsonNotation::ObjectEnd)
+				{
+					return MakeShared<FJsonValueObject>(Object);
+				}
+
+				FString MemberName = GetIdentifierAsString();
+				TSharedPtr<FJsonValue> MemberValue = ReadValueAsJsonValue(MemberNotation);
+				if (!MemberValue.IsValid())
+				{
+					return nullptr;
+				}
+				Object->Values.Add(MoveTemp(MemberName), MoveTemp(MemberValue));
+			}
+			return nullptr;
+		}
+
+	case EJsonNotation::ArrayStart:
+		{
+			TArray<TSharedPtr<FJsonValue>> Array;
+			EJsonNotation ElementNotation;
+			while (ReadNext(ElementNotation) && ElementNotation != EJsonNotation::Error)
+			{
+				if (ElementNotation == EJsonNotation::ArrayEnd)
+				{
+					return MakeShared<FJsonValueArray>(Array);
+				}
+
+				TSharedPtr<FJsonValue> ElementValue = ReadValueAsJsonValue(ElementNotation);
+				if (!ElementValue.IsValid())
+				{
+					return nullptr;
+				}
+				Array.Add(MoveTemp(ElementValue));
+			}
+			return nullptr;
+		}
+
+	default:
+		return nullptr;
+	}
+}
+
+FString FJsonUtf8Reader::Utf8ToString(FAnsiStringView Utf8)
+{
+	if (Utf8.IsEmpty())
+	{
+		return FString();
+	}
+
+	FUTF8ToTCHAR Converted(Utf8.Data(), Utf8.Len());
+	return FString(Converted.Length(), Converted.Get());
+}
+
+FString FJsonUtf8Reader::GetIdentifierAsString() const
+{
+	return Utf8ToString(Identifier);
+}
+
+FString FJsonUtf8Reader::GetValueAsString() const
+{
+	check(CurrentToken == EJsonToken::String);
+	return Utf8ToString(StringValue);
+}
+
+FString FJsonUtf8Reader::GetValueAsNumberString() const
+{
+	check(CurrentToken == EJsonToken::Number);
+	return Utf8ToString(NumberString);
+}
+
+bool FJsonUtf8Reader::ReadStart()
+{
+	CurrentToken = EJsonToken::None;
+
+	if (!NextToken())
+	{
+		return false;
+	}
+
+	if ((CurrentToken != EJsonToken::CurlyOpen) && (CurrentToken != EJsonToken::SquareOpen))
+	{
+		SetErrorMessage(TEXT("Open Curly or Square Brace token expected, but not found."), Structurals[StructuralIndex - 1]);
+		return false;
+	}
+
+	return true;
+}
+
+bool FJsonUtf8Reader::ReadNextObjectValue()
+{
+	const bool bCommaPrepend = CurrentToken != EJsonToken::CurlyOpen;
+	CurrentToken = EJsonToken::None;
+
+	if (!NextToken())
+	{
+		return false;
+	}
+
+	if (CurrentToken == EJsonToken::CurlyClose)
+	{
+		return true;
+	}
+
+	if (bCommaPrepend)
+	{
+		if (CurrentToken != EJsonToken::Comma)
+		{
+			SetErrorMessage(TEXT("Comma token expected, but not found."), Structurals[StructuralIndex - 1]);
+			return false;
+		}
+
+		if (!NextToken())
+		{
+			return false;
+		}
+	}
+
+	if (CurrentToken != EJsonToken::String)
+	{
+		SetErrorMessage(TEXT("String token expected, but not found."), Structurals[StructuralIndex - 1]);
+		return false;
+	}
+
+	// Keep the identifier's unescaped characters out of the way of the value's
+	Identifier = StringValue;
+	if (StringValue.Data() == StringScratch.GetData())
+	{
+		Swap(StringScratch, IdentifierScratch);
+	}
+
+	if (!NextToken())
+	{
+		return false;
+	}
+
+	if (CurrentToken != EJsonToken::Colon)
+	{
+		SetErrorMessage(TEXT("Colon token expected, but not found."), Structurals[StructuralIndex - 1]);
+		return false;
+	}
+
+	return NextToken();
+}
+
+bool FJsonUtf8Reader::ReadNextArrayValue()
+{
+	const bool bCommaPrepend = CurrentToken != EJsonToken::SquareOpen;
+	CurrentToken = EJsonToken::None;
+
+	if (!NextToken())
+	{
+		return false;
+	}
+
+	if (CurrentToken == EJsonToken::SquareClose)
+	{
+		return true;
+	}
+
+	if (bCommaPrepend)
+	{
+		if (CurrentToken != EJsonToken::Comma)
+		{
+			SetErrorMessage(TEXT("Comma token expected, but not found."), Structurals[StructuralIndex - 1]);
+			return false;
+		}
+
+		if (!NextToken())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FJsonUtf8Reader::NextToken()
+{
+	using namespace JsonUtf8Reader;
+
+	CurrentToken = EJsonToken::None;
+
+	if (StructuralIndex >= Structurals.Num())
+	{
+		SetErrorMessage(TEXT("Invalid Json Token."), Size);
+		return false;
+	}
+
+	const int32 Offset = Structurals[StructuralIndex++];
+	const ANSICHAR Char = Data[Offset];
+
+	if (IsJsonNumber(Char))
+	{
+		if (!ParseNumberToken(Offset))
+		{
+			return false;
+		}
+
+		CurrentToken = EJsonToken::Number;
+		return true;
+	}
+
+	switch (Char)
+	{
+	case '{':
+		CurrentToken = EJsonToken::CurlyOpen;
+		ParseState.Push(EJson::Object);
+		return true;
+
+	case '}':
+		CurrentToken = EJsonToken::CurlyClose;
+		break;
+
+	case '[':
+		CurrentToken = EJsonToken::SquareOpen;
+		ParseState.Push(EJson::Array);
+		return true;
+
+	case ']':
+		CurrentToken = EJsonToken::SquareClose;
+		break;
+
+	case ':':
+		CurrentToken = EJsonToken::Colon;
+		return true;
+
+	case ',':
+		CurrentToken = EJsonToken::Comma;
+		return true;
+
+	case '"':
+		if (!ParseStringToken(Offset))
+		{
+			return false;
+		}
+
+		CurrentToken = EJsonToken::String;
+		return true;
+
+	case 't': case 'T':
+	case 'f': case 'F':
+	case 'n': case 'N':
+		return ParseLiteralToken(Offset);
+
+	default:
+		SetErrorMessage(TEXT("Invalid Json Token."), Offset);
+		return false;
+	}
+
+	// Closing a scope that was never opened
+	if (ParseState.Num() == 0)
+	{
+		SetErrorMessage(TEXT("Invalid Json Token."), Offset);
+		return false;
+	}
+	ParseState.Pop(false);
+	return true;
+}
+
+bool FJsonUtf8Reader::IsValueEnd(int32 Offset) const
+{
+	using namespace JsonUtf8Reader;
+
+	return Offset >= Size || IsWhitespace(Data[Offset]) || IsStructural(Data[Offset]) || Data[Offset] == '"';
+}
+
+bool FJsonUtf8Reader::ParseStringToken(int32 Offset)
+{
+	if (StructuralIndex >= Structurals.Num() || Offset == UnterminatedStringOffset)
+	{
+		SetErrorMessage(TEXT("String Token Abruptly Ended."), Size);
+		return false;
+	}
+
+	// Everything inside the string was skipped by the first pass, so the next offset is the closing quote
+	const int32 EndOffset = Structurals[StructuralIndex++];
+	check(Data[EndOffset] == '"');
+
+	const ANSICHAR* Start = Data + Offset + 1;
+	const ANSICHAR* End = Data + EndOffset;
+	if (!memchr(Start, '\\', End - Start))
+	{
+		StringValue = FAnsiStringView(Start, (int32)(End - Start));
+		return true;
+	}
+
+	return UnescapeString(Start, End);
+}
+
+bool FJsonUtf8Reader::UnescapeString(const ANSICHAR* Start, const ANSICHAR* End)
+{
+	StringScratch.Reset();
+	StringScratch.Reserve((int32)(End - Start));
+
+	const ANSICHAR* Char = Start;
+	while (Char < End)
+	{
+		const ANSICHAR* Backslash = (const ANSICHAR*)memchr(Char, '\\', End - Char);
+		if (!Backslash)
+		{
+			StringScratch.Append(Char, (int32)(End - Char));
+			break;
+		}
+
+		StringScratch.Append(Char, (int32)(Backslash - Char));
+		Char = Backslash + 1;
+
+		// The first pass already made sure a backslash never escapes the closing quote
+		switch (*Char++)
+		{
+		case '\"': StringScratch.Add('\"'); break;
+		case '\\': StringScratch.Add('\\'); break;
+		case '/': StringScratch.Add('/'); break;
+		case 'f': StringScratch.Add('\f'); break;
+		case 'r': StringScratch.Add('\r'); break;
+		case 'n': StringScratch.Add('\n'); break;
+		case 'b': StringScratch.Add('\b'); break;
+		case 't': StringScratch.Add('\t'); break;
+		case 'u':
+			{
+				uint32 CodePoint = 0;
+				for (int32 CodeUnit = 0; CodeUnit < 2; ++CodeUnit)
+				{
+					// 4 hex digits, like \uAB23, which is a 16 bit number that we would usually see as 0xAB23
+					if (End - Char < 4)
+					{
+						SetErrorMessage(TEXT("String Token Abruptly Ended."), (int32)(End - Data));
+						return false;
+					}
+
+					uint32 HexNum = 0;
+					for (int32 Digit = 0; Digit < 4; ++Digit, ++Char)
+					{
+						const int32 HexDigit = FParse::HexDigit(*Char);
+						if ((HexDigit == 0) && (*Char != '0'))
+						{
+							SetErrorMessage(TEXT("Invalid Hexadecimal digit parsed."), (int32)(Char - Data));
+							return false;
+						}
+						HexNum = (HexNum << 4) | HexDigit;
+					}
+
+					if (CodeUnit == 0)
+					{
+						CodePoint = HexNum;
+						// A high surrogate followed by an escaped low surrogate is one code point
+						if (HexNum < 0xD800 || HexNum > 0xDBFF || End - Char < 6 || Char[0] != '\\' || Char[1] != 'u')
+						{
+							break;
+						}
+						Char += 2;
+					}
+					else if (HexNum >= 0xDC00 && HexNum <= 0xDFFF)
+					{
+						CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (HexNum - 0xDC00);
+					}
+					else
+					{
+						// Not a pair after all, keep both code units
+						JsonUtf8Reader::EncodeUtf8(CodePoint, StringScratch);
+						CodePoint = HexNum;
+					}
+				}
+				JsonUtf8Reader::EncodeUtf8(CodePoint, StringScratch);
+			}
+			break;
+
+		default:
+			SetErrorMessage(TEXT("Bad Json escaped char."), (int32)(Char - 1 - Data));
+			return false;
+		}
+	}
+
+	StringValue = FAnsiStringView(StringScratch.GetData(), StringScratch.Num());
+	return true;
+}
+
+bool FJsonUtf8Reader::ParseNumberToken(int32 Offset)
+{
+	using namespace JsonUtf8Reader;
+
+	// Only makes sure the number is EXACTLY to specification, Atod does the conversion.
+	// This switch statement is derived from a finite state automata derived from the Json spec.
+	int32 State = 0;
+	bool bError = false;
+	int32 End = Offset;
+	for (; End < Size && IsJsonNumber(Data[End]) && !bError; ++End)
+	{
+		const ANSICHAR Char = Data[End];
+		switch (State)
+		{
+		case 0:
+			if (Char == '-') { State = 1; }
+			else if (Char == '0') { State = 2; }
+			else if (IsNonZeroDigit(Char)) { State = 3; }
+			else { bError = true; }
+			break;
+
+		case 1:
+			if (Char == '0') { State = 2; }
+			else if (IsNonZeroDigit(Char)) { State = 3; }
+			else { bError = true; }
+			break;
+
+		case 2:
+			if (Char == '.') { State = 4; }
+			else if (Char == 'e' || Char == 'E') { State = 5; }
+			else { bError = true; }
+			break;
+
+		case 3:
+			if (IsDigit(Char)) { State = 3; }
+			else if (Char == '.') { State = 4; }
+			else if (Char == 'e' || Char == 'E') { State = 5; }
+			else { bError = true; }
+			break;
+
+		case 4:
+			if (IsDigit(Char)) { State = 6; }
+			else { bError = true; }
+			break;
+
+		case 5:
+			if (Char == '-' || Char == '+') { State = 7; }
+			else if (IsDigit(Char)) { State = 8; }
+			else { bError = true; }
+			break;
+
+		case 6:
+			if (IsDigit(Char)) { State = 6; }
+			else if (Char == 'e' || Char == 'E') { State = 5; }
+			else { bError = true; }
+			break;
+
+		case 7:
+		case 8:
+			if (IsDigit(Char)) { State = 8; }
+			else { bError = true; }
+			break;
+		}
+	}
+
+	if (bError || !((State == 2) || (State == 3) || (State == 6) || (State == 8)))
+	{
+		SetErrorMessage(TEXT("Poorly formed Json Number Token."), Offset);
+		return false;
+	}
+
+	if (!IsValueEnd(End))
+	{
+		SetErrorMessage(TEXT("Invalid Json Token."), End);
+		return false;
+	}
+
+	NumberString = FAnsiStringView(Data + Offset, End - Offset);
+
+	// Atod needs a terminator the buffer doesn't have
+	TArray<ANSICHAR, TInlineAllocator<64>> Terminated;
+	Terminated.Append(NumberString.Data(), NumberString.Len());
+	Terminated.Add('\0');
+	NumberValue = FCStringAnsi::Atod(Terminated.GetData());
+	return true;
+}
+
+bool FJsonUtf8Reader::ParseLiteralToken(int32 Offset)
+{
+	using namespace JsonUtf8Reader;
+
+	int32 End = Offset;
+	while (End < Size && IsAlpha(Data[End]))
+	{
+		++End;
+	}
+
+	// Matched case insensitively, like TJsonReader does
+	const FAnsiStringView Literal(Data + Offset, End - Offset);
+	if (IsValueEnd(End))
+	{
+		if (Literal == FAnsiStringView("false", 5))
+		{
+			CurrentToken = EJsonToken::False;
+			return true;
+		}
+
+		if (Literal == FAnsiStringView("true", 4))
+		{
+			CurrentToken = EJsonToken::True;
+			return true;
+		}
+
+		if (Literal == FAnsiStringView("null", 4))
+		{
+			CurrentToken = EJsonToken::Null;
+			return true;
+		}
+	}
+
+	SetErrorMessage(TEXT("Invalid Json Token. Check that your member names have quotes around them!"), Offset);
+	return false;
+}
@@ -0,0 +1,161 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Dom/JsonArenaDocument.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonUtf8Reader.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * FJsonUtf8ReaderTest
+ * Checks that FJsonUtf8Reader and FJsonArenaDocument read the same values as TJsonReader
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJsonUtf8ReaderTest, "System.Engine.FileSystem.JSON.Utf8Reader", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+namespace JsonUtf8ReaderTest
+{
+	/** Reads Json with either reader into a string with one line per notation, or returns false on error */
+	template<typename ReaderType>
+	bool ReadAll(ReaderType& Reader, FString& OutNotations)
+	{
+		EJsonNotation Notation;
+		while (Reader.ReadNext(Notation))
+		{
+			switch (Notation)
+			{
+			case EJsonNotation::ObjectStart:	OutNotations += TEXT("{"); break;
+			case EJsonNotation::ObjectEnd:		OutNotations += TEXT("}"); break;
+			case EJsonNotation::ArrayStart:		OutNotations += TEXT("["); break;
+			case EJsonNotation::ArrayEnd:		OutNotations += TEXT("]"); break;
+			case EJsonNotation::String:			OutNotations += TEXT("s:") + Reader.GetValueAsString(); break;
+			case EJsonNotation::Number:			OutNotations += FString::Printf(TEXT("n:%s=%.17g"), *Reader.GetValueAsNumberString(), Reader.GetValueAsNumber()); break;
+			case EJsonNotation::Boolean:		OutNotations += Reader.GetValueAsBoolean() ? TEXT("true") : TEXT("false"); break;
+			case EJsonNotation::Null:			OutNotations += TEXT("null"); break;
+			default:							return false;
+			}
+			OutNotations += TEXT("\n");
+		}
+		return true;
+	}
+
+	FString ReadAllWithIdentifiers(const FString& Json, bool bUtf8, bool& bOutSuccess)
+	{
+		FString Notations;
+		if (bUtf8)
+		{
+			FTCHARToUTF8 Utf8(*Json);
+			FJsonUtf8Reader Reader(Utf8.Get(), Utf8.Length());
+			bOutSuccess = ReadAll(Reader, Notations);
+		}
+		else
+		{
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+			bOutSuccess = ReadAll(Reader.Get(), Notations);
+		}
+		return Notations;
+	}
+}
+
+bool FJsonUtf8ReaderTest::RunTest(const FString& Parameters)
+{
+	using namespace JsonUtf8ReaderTest;
+
+	TArray<FString> ValidInputs;
+	ValidInputs.Add(TEXT("{}"));
+	ValidInputs.Add(TEXT("[]"));
+	ValidInputs.Add(TEXT("  \r\n\t[ 1 , -2.5e3 ,0, 0.125 ,1E+2, true, False, null ]  \n"));
+	ValidInputs.Add(TEXT("{\"Value\":\"Some String\",\"Nested\":{\"Array\":[[],{},[{\"a\":1}]]},\"Empty\":\"\"}"));
+	ValidInputs.Add(TEXT("{\"Escapes\":\"\\\" \\\\ \\/ \\b \\f \\n \\r \\t \\u00e9 \\u20AC \\ud83d\\ude00 \\\\\", \"\\\\\\\"key\\\\\":\"\\\\\"}"));
+	ValidInputs.Add(TEXT("[\"caf\u00e9\", \"{not:[an,object]}\", \"a\\\\\"]"));
+
+	// Strings, escapes and numbers across the 64 byte blocks the reader classifies at once
+	{
+		FString Long = TEXT("{");
+		for (int32 Index = 0; Index < 200; ++Index)
+		{
+			Long += FString::Printf(TEXT("%s\"Key%d%s\":[%d,\"%s\",%d.5]"), Index ? TEXT(",") : TEXT(""), Index, *FString::ChrN(Index % 7, TEXT('\\')).Replace(TEXT("\\"), TEXT("\\\\")), Index, *FString::ChrN(Index % 70, TEXT('x')), -Index);
+		}
+		Long += TEXT("}");
+		ValidInputs.Add(Long);
+	}
+
+	for (const FString& Input : ValidInputs)
+	{
+		bool bExpectedSuccess = false;
+		bool bSuccess = false;
+		const FString Expected = ReadAllWithIdentifiers(Input, false, bExpectedSuccess);
+		const FString Actual = ReadAllWithIdentifiers(Input, true, bSuccess);
+		TestTrue(FString::Printf(TEXT("TJsonReader reads %s"), *Input.Left(64)), bExpectedSuccess);
+		TestTrue(FString::Printf(TEXT("FJsonUtf8Reader reads %s"), *Input.Left(64)), bSuccess);
+		TestEqual(FString::Printf(TEXT("FJsonUtf8Reader matches TJsonReader for %s"), *Input.Left(64)), Actual, Expected);
+
+		// The arena document holds the same values as the Json objects
+		FTCHARToUTF8 Utf8(*Input);
+		FJsonArenaDocument Document;
+		TestTrue(TEXT("FJsonArenaDocument parses"), Document.Parse((const ANSICHAR*)Utf8.Get(), Utf8.Length()));
+
+		TSharedPtr<FJsonValue> FromArena = Document.GetRoot().ToJsonValue();
+		TSharedPtr<FJsonValue> FromReader;
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Input);
+		FJsonSerializer::Deserialize(Reader, FromReader);
+		TestTrue(TEXT("FJsonArenaDocument matches FJsonSerializer"), FromArena.IsValid() && FromReader.IsValid() && FJsonValue::CompareEqual(*FromArena, *FromReader));
+	}
+
+	TArray<FString> InvalidInputs;
+	InvalidInputs.Add(TEXT(""));
+	InvalidInputs.Add(TEXT("   "));
+	InvalidInputs.Add(TEXT("1"));
+	InvalidInputs.Add(TEXT("\"String\""));
+	InvalidInputs.Add(TEXT("{\"Value\":1"));
+	InvalidInputs.Add(TEXT("{\"Value\" 1}"));
+	InvalidInputs.Add(TEXT("{Value:1}"));
+	InvalidInputs.Add(TEXT("[1 2]"));
+	InvalidInputs.Add(TEXT("[01]"));
+	InvalidInputs.Add(TEXT("[1.]"));
+	InvalidInputs.Add(TEXT("[1e]"));
+	InvalidInputs.Add(TEXT("[truth]"));
+	InvalidInputs.Add(TEXT("[\"unterminated]"));
+	InvalidInputs.Add(TEXT("[\"bad escape \\q\"]"));
+	InvalidInputs.Add(TEXT("[\"bad hex \\u12G4\"]"));
+	InvalidInputs.Add(TEXT("{} {}"));
+	InvalidInputs.Add(TEXT("}"));
+
+	for (const FString& Input : InvalidInputs)
+	{
+		bool bSuccess = true;
+		ReadAllWithIdentifiers(Input, true, bSuccess);
+		TestFalse(FString::Printf(TEXT("FJsonUtf8Reader fails to read %s"), *Input), bSuccess);
+
+		FTCHARToUTF8 Utf8(*Input);
+		FJsonArenaDocument Document;
+		TestFalse(FString::Printf(TEXT("FJsonArenaDocument fails to parse %s"), *Input), Document.Parse((const ANSICHAR*)Utf8.Get(), Utf8.Length()));
+		TestFalse(TEXT("FJsonArenaDocument has an error message"), Document.GetErrorMessage().IsEmpty());
+	}
+
+	// Looking values up in the arena document
+	{
+		const ANSICHAR* Json = "{\"Name\":\"Arena\",\"Count\":3,\"Items\":[true,null,\"x\"],\"name\":\"Last\"}";
+		FJsonArenaDocument Document;
+		TestTrue(TEXT("FJsonArenaDocument parses"), Document.Parse(Json, FCStringAnsi::Strlen(Json)));
+
+		const FJsonArenaValue Root = Document.GetRoot();
+		TestEqual(TEXT("Root has every member"), Root.Num(), 4);
+		TestEqual(TEXT("Last member wins and names are case insensitive"), Root.GetField(FAnsiStringView("NAME")).AsString(), FString(TEXT("Last")));
+		TestEqual(TEXT("Number member"), Root.GetField(FAnsiStringView("Count")).AsNumber(), 3.0);
+		TestFalse(TEXT("Missing member"), Root.GetField(FAnsiStringView("Missing")).IsValid());
+
+		const FJsonArenaValue Items = Root.GetField(FAnsiStringView("Items"));
+		TestEqual(TEXT("Array elements"), Items.Num(), 3);
+		TestTrue(TEXT("First element"), Items.GetFirstChild().AsBool());
+		TestTrue(TEXT("Second element"), Items.GetFirstChild().GetNextSibling().IsNull());
+		TestFalse(TEXT("No element after the last"), Items.GetFirstChild().GetNextSibling().GetNextSibling().GetNextSibling().IsValid());
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,149 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ArrayView.h"
+#include "Misc/StringView.h"
+#include "Serialization/JsonTypes.h"
+
+class FJsonArenaDocument;
+class FJsonValue;
+
+/**
+ * Handle to a value in a FJsonArenaDocument, only valid as long as the document is and until it parses something else.
+ * Members of objects and elements of arrays are visited with GetFirstChild and GetNextSibling.
+ */
+class JSON_API FJsonArenaValue
+{
+public:
+
+	FJsonArenaValue()
+		: Document(nullptr)
+		, Index(INDEX_NONE)
+	{
+	}
+
+	bool IsValid() const
+	{
+		return Document != nullptr;
+	}
+
+	/** Returns the type of this value, or EJson::None if it isn't valid */
+	EJson GetType() const;
+
+	bool IsNull() const
+	{
+		return GetType() == EJson::Null;
+	}
+
+	/** Returns this value as a double, or zero if it is not a number */
+	double AsNumber() const;
+
+	/** Returns this value as a boolean, or false if it is not a boolean */
+	bool AsBool() const;
+
+	/** Returns this string as UTF-8, or an empty string if it is not a string */
+	FAnsiStringView AsUtf8() const;
+	FString AsString() const;
+
+	/** Returns the name of this object member as UTF-8, or an empty string if it isn't in an object */
+	FAnsiStringView GetKey() const;
+
+	/** Returns the number of members of this object or elements of this array */
+	int32 Num() const;
+
+	FJsonArenaValue GetFirstChild() const;
+	FJsonArenaValue GetNextSibling() const;
+
+	/** Returns the member of this object called Name, compared case insensitively like FJsonObject does, or an invalid value */
+	FJsonArenaValue GetField(FAnsiStringView Name) const;
+
+	/** Copies this value and everything in it to a Json value */
+	TSharedPtr<FJsonValue> ToJsonValue() const;
+
+private:
+
+	friend class FJsonArenaDocument;
+
+	FJsonArenaValue(const FJsonArenaDocument* InDocument, int32 InIndex)
+		: Document(InIndex != INDEX_NONE ? InDocument : nullptr)
+		, Index(InIndex)
+	{
+	}
+
+	const FJsonArenaDocument* Document;
+	int32 Index;
+};
+
+/**
+ * Json document parsed into two flat arrays, one with every value in the order they appear in and one with the
+ * characters of every string and member name, instead of a shared FJsonValue per value and an FJsonObject per object.
+ * Both arrays are sized from what FJsonUtf8Reader found before any value is read, so parsing allocates a handful of
+ * times no matter how big the document is. Use when the document is only read, FJsonObject is needed to modify it.
+ */
+class JSON_API FJsonArenaDocument
+{
+public:
+
+	/** Parses Size bytes of UTF-8, replacing what was parsed before. Returns false if the Json is invalid. */
+	bool Parse(const ANSICHAR* Data, int32 Size);
+	bool Parse(TArrayView<const uint8> Data);
+
+	/** Removes everything that was parsed */
+	void Reset();
+
+	/** Returns the object or array at the root of the document, or an invalid value if nothing was parsed */
+	FJsonArenaValue GetRoot() const
+	{
+		return FJsonArenaValue(this, Nodes.Num() > 0 ? 0 : INDEX_NONE);
+	}
+
+	const FString& GetErrorMessage() const
+	{
+		return ErrorMessage;
+	}
+
+	/** Returns the memory used by the values and strings */
+	SIZE_T GetAllocatedSize() const
+	{
+		return Nodes.GetAllocatedSize() + Strings.GetAllocatedSize();
+	}
+
+private:
+
+	friend class FJsonArenaValue;
+
+	struct FNode
+	{
+		EJson Type;
+		/** Number of members or elements of an object or array */
+		int32 NumChildren;
+		/** Index of the next member or element in the same object or array, or INDEX_NONE */
+		int32 NextSibling;
+		/** Member name in Strings, KeyOffset is INDEX_NONE for values that aren't in an object */
+		int32 KeyOffset;
+		int32 KeyLen;
+		union
+		{
+			double Number;
+			bool bBool;
+			struct
+			{
+				int32 Offset;
+				int32 Len;
+			} String;
+		};
+	};
+
+	int32 AddString(FAnsiStringView String);
+
+	FAnsiStringView GetString(int32 Offset, int32 Len) const
+	{
+		return FAnsiStringView(Strings.GetData() + Offset, Len);
+	}
+
+	TArray<FNode> Nodes;
+	TArray<ANSICHAR> Strings;
+	FString ErrorMessage;
+};
@@ -0,0 +1,130 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ArrayView.h"
+#include "Misc/StringView.h"
+#include "Serialization/JsonTypes.h"
+
+class FJsonValue;
+
+/**
+ * Pull reader for Json in a UTF-8 buffer, returning the same notations as TJsonReader without converting the input to
+ * TCHAR or reading it through an archive one character at a time.
+ *
+ * The buffer is read in two passes. The first classifies 64 bytes at a time with SIMD compares into bit masks and keeps
+ * the offset of every structural character, string quote and the first character of every number and literal. The
+ * second walks those offsets, so whitespace and the contents of strings are never looked at character by character.
+ * Strings without escapes are returned as views into the buffer, which must outlive the reader.
+ */
+class JSON_API FJsonUtf8Reader
+{
+public:
+
+	/**
+	 * Creates a reader for Size bytes of UTF-8 at Data. A byte order mark at the start and null terminators at the
+	 * end are ignored.
+	 */
+	FJsonUtf8Reader(const ANSICHAR* Data, int32 Size);
+	explicit FJsonUtf8Reader(TArrayView<const uint8> Data);
+
+	/** Reads the next value, @see TJsonReader::ReadNext */
+	bool ReadNext(EJsonNotation& Notation);
+
+	/** Reads until the end of the object or array that was just started. Returns false on error. */
+	bool SkipObject();
+	bool SkipArray();
+
+	/**
+	 * Reads the value that ReadNext just returned Notation for, including everything in it if it's an object or array,
+	 * into a Json value. Returns null if the value couldn't be read.
+	 */
+	TSharedPtr<FJsonValue> ReadValueAsJsonValue(EJsonNotation Notation);
+
+	/** Name of the object member that was just read, as UTF-8. Empty for array elements. */
+	FAnsiStringView GetIdentifier() const
+	{
+		return Identifier;
+	}
+
+	/** Unescaped string that was just read, as UTF-8. Valid until the next call to ReadNext. */
+	FAnsiStringView GetValueAsUtf8() const
+	{
+		check(CurrentToken == EJsonToken::String);
+		return StringValue;
+	}
+
+	FString GetIdentifierAsString() const;
+	FString GetValueAsString() const;
+
+	double GetValueAsNumber() const
+	{
+		check(CurrentToken == EJsonToken::Number);
+		return NumberValue;
+	}
+
+	FString GetValueAsNumberString() const;
+
+	bool GetValueAsBoolean() const
+	{
+		check((CurrentToken == EJsonToken::True) || (CurrentToken == EJsonToken::False));
+		return CurrentToken == EJsonToken::True;
+	}
+
+	const FString& GetErrorMessage() const
+	{
+		return ErrorMessage;
+	}
+
+	/** Number of offsets the first pass found, an upper bound on the number of values in the buffer */
+	int32 GetNumStructurals() const
+	{
+		return Structurals.Num();
+	}
+
+	/** Converts UTF-8 to an FString */
+	static FString Utf8ToString(FAnsiStringView Utf8);
+
+private:
+
+	/** Finds the offsets of everything the second pass needs to look at */
+	void IndexStructurals();
+
+	void SetErrorMessage(const TCHAR* Message, int32 Offset);
+
+	bool ReadUntilMatching(const EJsonNotation ExpectedNotation);
+	bool ReadStart();
+	bool ReadNextObjectValue();
+	bool ReadNextArrayValue();
+	bool NextToken();
+	bool ParseStringToken(int32 Offset);
+	bool ParseNumberToken(int32 Offset);
+	bool ParseLiteralToken(int32 Offset);
+	bool UnescapeString(const ANSICHAR* Start, const ANSICHAR* End);
+
+	/** Returns true if a value that ended right before Offset isn't followed by something that can't follow it */
+	bool IsValueEnd(int32 Offset) const;
+
+	const ANSICHAR* Data;
+	int32 Size;
+
+	/** Offsets from the first pass and the next one to read */
+	TArray<int32> Structurals;
+	int32 StructuralIndex;
+	/** Offset of a string with no closing quote, or INDEX_NONE */
+	int32 UnterminatedStringOffset;
+
+	TArray<EJson> ParseState;
+	EJsonToken CurrentToken;
+	FAnsiStringView Identifier;
+	FAnsiStringView StringValue;
+	FAnsiStringView NumberString;
+	double NumberValue;
+	bool bFinishedReadingRootObject;
+	FString ErrorMessage;
+
+	/** Unescaped strings, swapped when a string becomes the identifier so both stay valid */
+	TArray<ANSICHAR> StringScratch;
+	TArray<ANSICHAR> IdentifierScratch;
+};
@@ -10,6 +10,7 @@
 #include "UObject/PropertyPortFlags.h"
 #include "UObject/Package.h"
 #include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonUtf8Reader.h"
 #include "JsonObjectWrapper.h"
 
 FString FJsonObjectConverter::StandardizeCase(const FString &StringIn)
@@ -821,6 +822,229 @@ namespace
 
 }
 
+namespace
+{
+	bool JsonUtf8ValueToUPropertyWithContainer(FJsonUtf8Reader& Reader, EJsonNotation Notation, UProperty* Property, void* OutValue, const UStruct* ContainerStruct, void* Container, int64 CheckFlags, int64 SkipFlags);
+
+	/** Reads the value the reader is at into a Json value, for the properties that are converted the same way as from Json objects */
+	TSharedPtr<FJsonValue> ReadJsonUtf8Value(FJsonUtf8Reader& Reader, EJsonNotation Notation)
+	{
+		TSharedPtr<FJsonValue> JsonValue = Reader.ReadValueAsJsonValue(Notation);
+		if (!JsonValue.IsValid())
+		{
+			UE_LOG(LogJson, Error, TEXT("JsonUtf8ToUStruct - Unable to parse JSON: %s"), *Reader.GetErrorMessage());
+		}
+		return JsonValue;
+	}
+
+	/** Reads the members of the object the reader just started into a struct */
+	bool JsonUtf8ObjectToUStructWithContainer(FJsonUtf8Reader& Reader, const UStruct* StructDefinition, void* OutStruct, const UStruct* ContainerStruct, void* Container, int64 CheckFlags, int64 SkipFlags)
+	{
+		if (StructDefinition == FJsonObjectWrapper::StaticStruct())
+		{
+			TSharedPtr<FJsonValue> JsonValue = ReadJsonUtf8Value(Reader, EJsonNotation::ObjectStart);
+			return JsonValue.IsValid() && JsonAttributesToUStructWithContainer(JsonValue->AsObject()->Values, StructDefinition, OutStruct, ContainerStruct, Container, CheckFlags, SkipFlags);
+		}
+
+		EJsonNotation Notation;
+		while (Reader.ReadNext(Notation))
+		{
+			if (Notation == EJsonNotation::ObjectEnd)
+			{
+				return true;
+			}
+
+			if (Notation == EJsonNotation::Error)
+			{
+				break;
+			}
+
+			// FName comparisons are case insensitive, like the keys of a FJsonObject
+			const FAnsiStringView Identifier = Reader.GetIdentifier();
+			FUTF8ToTCHAR PropertyName(Identifier.Data(), Identifier.Len());
+			const FName PropertyFName(PropertyName.Length(), PropertyName.Get(), FNAME_Find);
+
+			UProperty* Property = PropertyFName.IsNone() ? nullptr : FindField<UProperty>(StructDefinition, PropertyFName);
+			if (Property && ((CheckFlags != 0 && !Property->HasAnyPropertyFlags(CheckFlags)) || Property->HasAnyPropertyFlags(SkipFlags)))
+			{
+				Property = nullptr;
+			}
+
+			if (!Property || Notation == EJsonNotation::Null)
+			{
+				// we allow values to not be found since this mirrors the typical UObject mantra that all the fields are optional when deserializing
+				if ((Notation == EJsonNotation::ObjectStart && !Reader.SkipObject()) || (Notation == EJsonNotation::ArrayStart && !Reader.SkipArray()))
+				{
+					break;
+				}
+				continue;
+			}
+
+			void* Value = Property->ContainerPtrToValuePtr<uint8>(OutStruct);
+			if (!JsonUtf8ValueToUPropertyWithContainer(Reader, Notation, Property, Value, ContainerStruct, Container, CheckFlags, SkipFlags))
+			{
+				UE_LOG(LogJson, Error, TEXT("JsonObjectToUStruct - Unable to parse %s.%s from JSON"), *StructDefinition->GetName(), *Property->GetName());
+				return false;
+			}
+		}
+
+		UE_LOG(LogJson, Error, TEXT("JsonUtf8ToUStruct - Unable to parse JSON: %s"), *Reader.GetErrorMessage());
+		return false;
+	}
+
+	/** Convert the value the reader is at to a property, assuming either the property is not an array or the value is an individual array element */
+	bool ConvertScalarJsonUtf8ValueToUPropertyWithContainer(FJsonUtf8Reader& Reader, EJsonNotation Notation, UProperty* Property, void* OutValue, const UStruct* ContainerStruct, void* Container, int64 CheckFlags, int64 SkipFlags)
+	{
+		// The common cases are read straight from the reader, everything else goes through a Json value
+		switch (Notation)
+		{
+		case EJsonNotation::Number:
+			if (UNumericProperty* NumericProperty = Cast<UNumericProperty>(Property))
+			{
+				if (NumericProperty->IsFloatingPoint())
+				{
+					NumericProperty->SetFloatingPointPropertyValue(OutValue, Reader.GetValueAsNumber());
+					return true;
+				}
+				if (NumericProperty->IsInteger())
+				{
+					NumericProperty->SetIntPropertyValue(OutValue, (int64)Reader.GetValueAsNumber());
+					return true;
+				}
+			}
+			else if (UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+			{
+				EnumProperty->GetUnderlyingProperty()->SetIntPropertyValue(OutValue, (int64)Reader.GetValueAsNumber());
+				return true;
+			}
+			break;
+
+		case EJsonNotation::Boolean:
+			if (UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
+			{
+				BoolProperty->SetPropertyValue(OutValue, Reader.GetValueAsBoolean());
+				return true;
+			}
+			break;
+
+		case EJsonNotation::String:
+			if (UStrProperty* StringProperty = Cast<UStrProperty>(Property))
+			{
+				StringProperty->SetPropertyValue(OutValue, Reader.GetValueAsString());
+				return true;
+			}
+			break;
+
+		case EJsonNotation::ObjectStart:
+			if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+			{
+				if (!JsonUtf8ObjectToUStructWithContainer(Reader, StructProperty->Struct, OutValue, ContainerStruct, Container, CheckFlags & (~CPF_ParmFlags), SkipFlags))
+				{
+					UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - FJsonObjectConverter::JsonObjectToUStruct failed for property %s"), *Property->GetNameCPP());
+					return false;
+				}
+				return true;
+			}
+			break;
+
+		default:
+			break;
+		}
+
+		TSharedPtr<FJsonValue> JsonValue = ReadJsonUtf8Value(Reader, Notation);
+		return JsonValue.IsValid() && ConvertScalarJsonValueToUPropertyWithContainer(JsonValue, Property, OutValue, ContainerStruct, Container, CheckFlags, SkipFlags);
+	}
+
+	bool JsonUtf8ValueToUPropertyWithContainer(FJsonUtf8Reader& Reader, EJsonNotation Notation, UProperty* Property, void* OutValue, const UStruct* ContainerStruct, void* Container, int64 CheckFlags, int64 SkipFlags)
+	{
+		const bool bArrayOrSetProperty = Property->IsA<UArrayProperty>() || Property->IsA<USetProperty>();
+
+		if (Notation != EJsonNotation::ArrayStart)
+		{
+			if (!bArrayOrSetProperty && Property->ArrayDim == 1)
+			{
+				return ConvertScalarJsonUtf8ValueToUPropertyWithContainer(Reader, Notation, Property, OutValue, ContainerStruct, Container, CheckFlags, SkipFlags);
+			}
+		}
+		else if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+		{
+			if (Property->ArrayDim == 1)
+			{
+				// Reuse the elements that are already there like FScriptArrayHelper::Resize does, since the size isn't known up front
+				FScriptArrayHelper Helper(ArrayProperty, OutValue);
+				int32 ArrLen = 0;
+				EJsonNotation ElementNotation;
+				while (Reader.ReadNext(ElementNotation) && ElementNotation != EJsonNotation::Error)
+				{
+					if (ElementNotation == EJsonNotation::ArrayEnd)
+					{
+						if (ArrLen < Helper.Num())
+						{
+							Helper.RemoveValues(ArrLen, Helper.Num() - ArrLen);
+						}
+						return true;
+					}
+
+					if (ArrLen == Helper.Num())
+					{
+						Helper.AddValue();
+					}
+
+					if (ElementNotation != EJsonNotation::Null)
+					{
+						if (!JsonUtf8ValueToUPropertyWithContainer(Reader, ElementNotation, ArrayProperty->Inner, Helper.GetRawPtr(ArrLen), ContainerStruct, Container, CheckFlags & (~CPF_ParmFlags), SkipFlags))
+						{
+							UE_LOG(LogJson, Error, TEXT("JsonValueToUProperty - Unable to deserialize array element [%d] for property %s"), ArrLen, *Property->GetNameCPP());
+							return false;
+						}
+					}
+					++ArrLen;
+				}
+
+				UE_LOG(LogJson, Error, TEXT("JsonUtf8ToUStruct - Unable to parse JSON: %s"), *Reader.GetErrorMessage());
+				return false;
+			}
+		}
+		else if (!bArrayOrSetProperty)
+		{
+			// Read into native array
+			int32 Index = 0;
+			EJsonNotation ElementNotation;
+			while (Reader.ReadNext(ElementNotation) && ElementNotation != EJsonNotation::Error)
+			{
+				if (ElementNotation == EJsonNotation::ArrayEnd)
+				{
+					if (Index > Property->ArrayDim)
+					{
+						UE_LOG(LogJson, Warning, TEXT("Ignoring excess properties when deserializing %s"), *Property->GetName());
+					}
+					return true;
+				}
+
+				if (Index < Property->ArrayDim)
+				{
+					if (!ConvertScalarJsonUtf8ValueToUPropertyWithContainer(Reader, ElementNotation, Property, (char*)OutValue + Index * Property->ElementSize, ContainerStruct, Container, CheckFlags, SkipFlags))
+					{
+						return false;
+					}
+				}
+				else if ((ElementNotation == EJsonNotation::ObjectStart && !Reader.SkipObject()) || (ElementNotation == EJsonNotation::ArrayStart && !Reader.SkipArray()))
+				{
+					break;
+				}
+				++Index;
+			}
+
+			UE_LOG(LogJson, Error, TEXT("JsonUtf8ToUStruct - Unable to parse JSON: %s"), *Reader.GetErrorMessage());
+			return false;
+		}
+
+		// Sets, and values that don't match the kind of property, get the same conversions and errors as from Json objects
+		TSharedPtr<FJsonValue> JsonValue = ReadJsonUtf8Value(Reader, Notation);
+		return JsonValue.IsValid() && JsonValueToUPropertyWithContainer(JsonValue, Property, OutValue, ContainerStruct, Container, CheckFlags, SkipFlags);
+	}
+}
+
 bool FJsonObjectConverter::JsonValueToUProperty(const TSharedPtr<FJsonValue>& JsonValue, UProperty* Property, void* OutValue, int64 CheckFlags, int64 SkipFlags)
 {
 	return JsonValueToUPropertyWithContainer(JsonValue, Property, OutValue, nullptr, nullptr, CheckFlags, SkipFlags);
@@ -836,6 +1060,31 @@ bool FJsonObjectConverter::JsonAttributesToUStruct(const TMap< FString, TSharedP
 	return JsonAttributesToUStructWithContainer(JsonAttributes, StructDefinition, OutStruct, StructDefinition, OutStruct, CheckFlags, SkipFlags);
 }
 
+bool FJsonObjectConverter::JsonUtf8ToUStruct(TArrayView<const uint8> Utf8Json, const UStruct* StructDefinition, void* OutStruct, int64 CheckFlags, int64 SkipFlags)
+{
+	FJsonUtf8Reader Reader(Utf8Json);
+
+	EJsonNotation Notation;
+	if (!Reader.ReadNext(Notation) || Notation != EJsonNotation::ObjectStart)
+	{
+		UE_LOG(LogJson, Warning, TEXT("JsonUtf8ToUStruct - Expected a JSON object. %s"), *Reader.GetErrorMessage());
+		return false;
+	}
+
+	if (!JsonUtf8ObjectToUStructWithContainer(Reader, StructDefinition, OutStruct, StructDefinition, OutStruct, CheckFlags, SkipFlags))
+	{
+		return false;
+	}
+
+	// Nothing but whitespace may follow the object
+	if (Reader.ReadNext(Notation))
+	{
+		UE_LOG(LogJson, Warning, TEXT("JsonUtf8ToUStruct - Unable to parse JSON: %s"), *Reader.GetErrorMessage());
+		return false;
+	}
+	return true;
+}
+
 //static 
 bool FJsonObjectConverter::GetTextFromField(const FString& FieldName, const TSharedPtr<FJsonValue>& FieldValue, FText& TextOut)
 {
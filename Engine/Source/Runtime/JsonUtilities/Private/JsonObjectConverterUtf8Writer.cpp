@@ -0,0 +1,582 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "JsonObjectConverter.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/EnumProperty.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/Package.h"
+#include "UObject/TextProperty.h"
+#include "UObject/UnrealType.h"
+#include "JsonObjectWrapper.h"
+
+namespace JsonUtf8Writer
+{
+	enum class EPropertyType : uint8
+	{
+		Bool,
+		Integer,
+		FloatingPoint,
+		Enum,
+		String,
+		Name,
+		Text,
+		Struct,
+		Array,
+		/** Converted to a Json value with FJsonObjectConverter::UPropertyToJsonValue */
+		Other,
+	};
+
+	struct FStructPlan;
+
+	/** How to write one property, worked out when the plan of its struct is made */
+	struct FPropertyPlan
+	{
+		UProperty* Property;
+		EPropertyType Type;
+		/** Struct plan of a struct property, in the cache */
+		const FStructPlan* StructPlan;
+		/** Plan of the elements of an array property */
+		TUniquePtr<FPropertyPlan> Inner;
+		/** Values of an enum and their names, already written as Json strings */
+		TArray<TPair<int64, TArray<uint8>>> EnumNames;
+		/** Flags the property converts sub-properties with */
+		int64 CheckFlags;
+		int64 SkipFlags;
+	};
+
+	struct FFieldPlan
+	{
+		/** Member name, already written as a Json string followed by a colon */
+		TArray<uint8> Key;
+		FPropertyPlan Value;
+	};
+
+	/** How to write one native struct with one set of flags */
+	struct FStructPlan
+	{
+		TArray<FFieldPlan> Fields;
+	};
+
+	struct FPlanKey
+	{
+		FObjectKey Struct;
+		int64 CheckFlags;
+		int64 SkipFlags;
+
+		bool operator==(const FPlanKey& Other) const
+		{
+			return Struct == Other.Struct && CheckFlags == Other.CheckFlags && SkipFlags == Other.SkipFlags;
+		}
+
+		friend uint32 GetTypeHash(const FPlanKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.Struct), HashCombine(GetTypeHash(Key.CheckFlags), GetTypeHash(Key.SkipFlags)));
+		}
+	};
+
+	static void AppendAscii(TArray<uint8>& Out, const ANSICHAR* String, int32 Len)
+	{
+		Out.Append((const uint8*)String, Len);
+	}
+
+	/** Appends a string as a quoted Json string in UTF-8, escaped the way TJsonWriter escapes */
+	static void AppendString(TArray<uint8>& Out, const TCHAR* String, int32 Len)
+	{
+		Out.Add('\"');
+		for (int32 Index = 0; Index < Len && String[Index] != TCHAR('\0'); ++Index)
+		{
+			uint32 Char = (uint32)String[Index];
+			if (Char >= 32 && Char < 128)
+			{
+				if (Char == '\\' || Char == '\"')
+				{
+					Out.Add('\\');
+				}
+				Out.Add((uint8)Char);
+				continue;
+			}
+
+			switch (Char)
+			{
+			case '\n': AppendAscii(Out, "\\n", 2); continue;
+			case '\t': AppendAscii(Out, "\\t", 2); continue;
+			case '\b': AppendAscii(Out, "\\b", 2); continue;
+			case '\f': AppendAscii(Out, "\\f", 2); continue;
+			case '\r': AppendAscii(Out, "\\r", 2); continue;
+			default: break;
+			}
+
+			if (Char < 32)
+			{
+				ANSICHAR Escaped[8];
+				AppendAscii(Out, Escaped, FCStringAnsi::Sprintf(Escaped, "\\u%04x", Char));
+				continue;
+			}
+
+			// UTF-16 strings keep characters outside the BMP as surrogate pairs
+			if (sizeof(TCHAR) == 2 && Char >= 0xD800 && Char <= 0xDBFF && Index + 1 < Len && (uint32)String[Index + 1] >= 0xDC00 && (uint32)String[Index + 1] <= 0xDFFF)
+			{
+				Char = 0x10000 + ((Char - 0xD800) << 10) + ((uint32)String[++Index] - 0xDC00);
+			}
+
+			if (Char < 0x800)
+			{
+				Out.Add((uint8)(0xC0 | (Char >> 6)));
+				Out.Add((uint8)(0x80 | (Char & 0x3F)));
+			}
+			else if (Char < 0x10000)
+			{
+				Out.Add((uint8)(0xE0 | (Char >> 12)));
+				Out.Add((uint8)(0x80 | ((Char >> 6) & 0x3F)));
+				Out.Add((uint8)(0x80 | (Char & 0x3F)));
+			}
+			else
+			{
+				Out.Add((uint8)(0xF0 | (Char >> 18)));
+				Out.Add((uint8)(0x80 | ((Char >> 12) & 0x3F)));
+				Out.Add((uint8)(0x80 | ((Char >> 6) & 0x3F)));
+				Out.Add((uint8)(0x80 | (Char & 0x3F)));
+			}
+		}
+		Out.Add('\"');
+	}
+
+	static void AppendString(TArray<uint8>& Out, const FString& String)
+	{
+		AppendString(Out, *String, String.Len());
+	}
+
+	/** Appends a number the way TJsonWriter writes a double */
+	static void AppendNumber(TArray<uint8>& Out, double Number)
+	{
+		ANSICHAR Buffer[64];
+		AppendAscii(Out, Buffer, FCStringAnsi::Sprintf(Buffer, "%.17g", Number));
+	}
+
+	static void AppendInteger(TArray<uint8>& Out, int64 Number)
+	{
+		// Json numbers are doubles, integers too big for one have to be written the same way
+		if (Number <= -(1ll << 53) || Number >= (1ll << 53))
+		{
+			AppendNumber(Out, (double)Number);
+			return;
+		}
+
+		ANSICHAR Buffer[24];
+		ANSICHAR* End = Buffer + ARRAY_COUNT(Buffer);
+		ANSICHAR* Start = End;
+		uint64 Magnitude = Number < 0 ? (uint64)-Number : (uint64)Number;
+		do
+		{
+			*--Start = (ANSICHAR)('0' + Magnitude % 10);
+			Magnitude /= 10;
+		}
+		while (Magnitude);
+		if (Number < 0)
+		{
+			*--Start = '-';
+		}
+		AppendAscii(Out, Start, (int32)(End - Start));
+	}
+
+	/** Appends a Json value the way FJsonSerializer writes it with the condensed print policy */
+	static void AppendJsonValue(TArray<uint8>& Out, const TSharedPtr<FJsonValue>& Value)
+	{
+		switch (Value->Type)
+		{
+		case EJson::Number:
+			AppendNumber(Out, Value->AsNumber());
+			break;
+
+		case EJson::Boolean:
+			Value->AsBool() ? AppendAscii(Out, "true", 4) : AppendAscii(Out, "false", 5);
+			break;
+
+		case EJson::String:
+			AppendString(Out, Value->AsString());
+			break;
+
+		case EJson::Array:
+			{
+				Out.Add('[');
+				const TArray<TSharedPtr<FJsonValue>>& Elements = Value->AsArray();
+				for (int32 Index = 0; Index < Elements.Num(); ++Index)
+				{
+					if (Index > 0)
+					{
+						Out.Add(',');
+					}
+					AppendJsonValue(Out, Elements[Index]);
+				}
+				Out.Add(']');
+			}
+			break;
+
+		case EJson::Object:
+			{
+				Out.Add('{');
+				bool bFirst = true;
+				for (const TPair<FString, TSharedPtr<FJsonValue>>& Member : Value->AsObject()->Values)
+				{
+					if (!bFirst)
+					{
+						Out.Add(',');
+					}
+					bFirst = false;
+					AppendString(Out, Member.Key);
+					Out.Add(':');
+					AppendJsonValue(Out, Member.Value);
+				}
+				Out.Add('}');
+			}
+			break;
+
+		default:
+			AppendAscii(Out, "null", 4);
+			break;
+		}
+	}
+
+	/** Plans of native structs, which are never unloaded or changed, so a plan can be used for as long as the process runs */
+	class FPlanCache
+	{
+	public:
+		static FPlanCache& Get()
+		{
+			static FPlanCache Cache;
+			return Cache;
+		}
+
+		/** Returns the plan of a native struct, making it the first time */
+		const FStructPlan* FindOrAdd(const UStruct* Struct, int64 CheckFlags, int64 SkipFlags)
+		{
+			const FPlanKey Key{ FObjectKey(Struct), CheckFlags, SkipFlags };
+			{
+				FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+				if (const TUniquePtr<FStructPlan>* Plan = Plans.Find(Key))
+				{
+					return Plan->Get();
+				}
+			}
+
+			FRWScopeLock ScopeLock(Lock, SLT_Write);
+			return FindOrAddLocked(Struct, CheckFlags, SkipFlags);
+		}
+
+		static bool CanHavePlan(const UStruct* Struct)
+		{
+			// Blueprint structs can be recompiled in place, and the Json object wrapper writes whatever Json it holds
+			return Struct->GetOutermost()->HasAnyPackageFlags(PKG_CompiledIn) && Struct != FJsonObjectWrapper::StaticStruct();
+		}
+
+	private:
+		const FStructPlan* FindOrAddLocked(const UStruct* Struct, int64 CheckFlags, int64 SkipFlags)
+		{
+			const FPlanKey Key{ FObjectKey(Struct), CheckFlags, SkipFlags };
+			if (const TUniquePtr<FStructPlan>* Plan = Plans.Find(Key))
+			{
+				return Plan->Get();
+			}
+
+			// Added before its fields are planned, so a struct with an array of itself finds its own plan
+			FStructPlan* Plan = new FStructPlan();
+			Plans.Add(Key, TUniquePtr<FStructPlan>(Plan));
+
+			// Names of the fields, compared ignoring case like the keys of a FJsonObject
+			TArray<FString> FieldNames;
+
+			for (TFieldIterator<UProperty> It(Struct); It; ++It)
+			{
+				UProperty* Property = *It;
+
+				// Check to see if we should ignore this property
+				if (CheckFlags != 0 && !Property->HasAnyPropertyFlags(CheckFlags))
+				{
+					continue;
+				}
+				if (Property->HasAnyPropertyFlags(SkipFlags))
+				{
+					continue;
+				}
+
+				const FString FieldName = FJsonObjectConverter::StandardizeCase(Property->GetName());
+
+				FFieldPlan Field;
+				AppendString(Field.Key, FieldName);
+				Field.Key.Add(':');
+				PlanProperty(Field.Value, Property, CheckFlags, SkipFlags);
+
+				// A name that comes up again replaces the earlier key and value where they were, like adding it to a FJsonObject does
+				const int32 ExistingIndex = FieldNames.Find(FieldName);
+				if (ExistingIndex != INDEX_NONE)
+				{
+					Plan->Fields[ExistingIndex] = MoveTemp(Field);
+				}
+				else
+				{
+					FieldNames.Add(FieldName);
+					Plan->Fields.Add(MoveTemp(Field));
+				}
+			}
+
+			return Plan;
+		}
+
+		void PlanProperty(FPropertyPlan& OutPlan, UProperty* Property, int64 CheckFlags, int64 SkipFlags)
+		{
+			OutPlan.Property = Property;
+			OutPlan.Type = EPropertyType::Other;
+			OutPlan.StructPlan = nullptr;
+			OutPlan.CheckFlags = CheckFlags;
+			OutPlan.SkipFlags = SkipFlags;
+
+			UEnum* Enum = nullptr;
+			if (UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+			{
+				Enum = EnumProperty->GetEnum();
+			}
+			else if (UNumericProperty* NumericProperty = Cast<UNumericProperty>(Property))
+			{
+				Enum = NumericProperty->GetIntPropertyEnum();
+				if (!Enum)
+				{
+					OutPlan.Type = NumericProperty->IsFloatingPoint() ? EPropertyType::FloatingPoint : NumericProperty->IsInteger() ? EPropertyType::Integer : EPropertyType::Other;
+				}
+			}
+			else if (Property->IsA<UBoolProperty>())
+			{
+				OutPlan.Type = EPropertyType::Bool;
+			}
+			else if (Property->IsA<UStrProperty>())
+			{
+				OutPlan.Type = EPropertyType::String;
+			}
+			else if (Property->IsA<UNameProperty>())
+			{
+				OutPlan.Type = EPropertyType::Name;
+			}
+			else if (Property->IsA<UTextProperty>())
+			{
+				OutPlan.Type = EPropertyType::Text;
+			}
+			else if (UArrayProperty* ArrayProperty = Cast<UArrayProperty>(Property))
+			{
+				OutPlan.Type = EPropertyType::Array;
+				OutPlan.Inner = MakeUnique<FPropertyPlan>();
+				PlanProperty(*OutPlan.Inner, ArrayProperty->Inner, CheckFlags & (~CPF_ParmFlags), SkipFlags);
+			}
+			else if (UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+			{
+				// Structs that export text are written as strings
+				UScriptStruct::ICppStructOps* TheCppStructOps = StructProperty->Struct->GetCppStructOps();
+				if (CanHavePlan(StructProperty->Struct) && !(TheCppStructOps && TheCppStructOps->HasExportTextItem()))
+				{
+					OutPlan.Type = EPropertyType::Struct;
+					OutPlan.StructPlan = FindOrAddLocked(StructProperty->Struct, CheckFlags & (~CPF_ParmFlags), SkipFlags);
+				}
+			}
+
+			if (Enum)
+			{
+				// export enums as strings
+				OutPlan.Type = EPropertyType::Enum;
+				for (int32 Index = 0; Index < Enum->NumEnums(); ++Index)
+				{
+					TPair<int64, TArray<uint8>>& EnumName = OutPlan.EnumNames.AddDefaulted_GetRef();
+					EnumName.Key = Enum->GetValueByIndex(Index);
+					AppendString(EnumName.Value, Enum->GetNameStringByIndex(Index));
+				}
+			}
+		}
+
+		FRWLock Lock;
+		TMap<FPlanKey, TUniquePtr<FStructPlan>> Plans;
+	};
+
+	static bool WriteStruct(TArray<uint8>& Out, const FStructPlan& Plan, const void* Struct);
+
+	/** Writes one value of a property, or returns false if it can't be converted to Json */
+	static bool WriteScalar(TArray<uint8>& Out, const FPropertyPlan& Plan, const void* Value)
+	{
+		switch (Plan.Type)
+		{
+		case EPropertyType::Bool:
+			static_cast<UBoolProperty*>(Plan.Property)->GetPropertyValue(Value) ? AppendAscii(Out, "true", 4) : AppendAscii(Out, "false", 5);
+			return true;
+
+		case EPropertyType::Integer:
+			AppendInteger(Out, static_cast<UNumericProperty*>(Plan.Property)->GetSignedIntPropertyValue(Value));
+			return true;
+
+		case EPropertyType::FloatingPoint:
+			AppendNumber(Out, static_cast<UNumericProperty*>(Plan.Property)->GetFloatingPointPropertyValue(Value));
+			return true;
+
+		case EPropertyType::Enum:
+			{
+				UEnumProperty* EnumProperty = Cast<UEnumProperty>(Plan.Property);
+				const int64 EnumValue = EnumProperty ? EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(Value) : static_cast<UNumericProperty*>(Plan.Property)->GetSignedIntPropertyValue(Value);
+				for (const TPair<int64, TArray<uint8>>& EnumName : Plan.EnumNames)
+				{
+					if (EnumName.Key == EnumValue)
+					{
+						Out.Append(EnumName.Value);
+						return true;
+					}
+				}
+				AppendAscii(Out, "\"\"", 2);
+			}
+			return true;
+
+		case EPropertyType::String:
+			AppendString(Out, static_cast<UStrProperty*>(Plan.Property)->GetPropertyValue(Value));
+			return true;
+
+		case EPropertyType::Name:
+			{
+				TCHAR Name[NAME_SIZE];
+				const uint32 Len = static_cast<UNameProperty*>(Plan.Property)->GetPropertyValue(Value).ToString(Name);
+				AppendString(Out, Name, (int32)Len);
+			}
+			return true;
+
+		case EPropertyType::Text:
+			AppendString(Out, static_cast<UTextProperty*>(Plan.Property)->GetPropertyValue(Value).ToString());
+			return true;
+
+		case EPropertyType::Struct:
+			return WriteStruct(Out, *Plan.StructPlan, Value);
+
+		case EPropertyType::Array:
+			{
+				// Elements that can't be converted are left out, like UPropertyToJsonValue leaves them out
+				FScriptArrayHelper Helper(static_cast<UArrayProperty*>(Plan.Property), Value);
+				Out.Add('[');
+				bool bFirst = true;
+				for (int32 Index = 0, Num = Helper.Num(); Index < Num; ++Index)
+				{
+					const int32 ElementStart = Out.Num();
+					if (!bFirst)
+					{
+						Out.Add(',');
+					}
+
+					const FPropertyPlan& Inner = *Plan.Inner;
+					bool bWritten = true;
+					if (Inner.Property->ArrayDim == 1 && Inner.Type != EPropertyType::Other)
+					{
+						bWritten = WriteScalar(Out, Inner, Helper.GetRawPtr(Index));
+					}
+					else
+					{
+						TSharedPtr<FJsonValue> Element = FJsonObjectConverter::UPropertyToJsonValue(Inner.Property, Helper.GetRawPtr(Index), Inner.CheckFlags, Inner.SkipFlags);
+						bWritten = Element.IsValid();
+						if (bWritten)
+						{
+							AppendJsonValue(Out, Element);
+						}
+					}
+
+					if (bWritten)
+					{
+						bFirst = false;
+					}
+					else
+					{
+						Out.SetNum(ElementStart, false);
+					}
+				}
+				Out.Add(']');
+			}
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	static bool WriteStruct(TArray<uint8>& Out, const FStructPlan& Plan, const void* Struct)
+	{
+		Out.Add('{');
+		for (int32 FieldIndex = 0; FieldIndex < Plan.Fields.Num(); ++FieldIndex)
+		{
+			const FFieldPlan& Field = Plan.Fields[FieldIndex];
+			if (FieldIndex > 0)
+			{
+				Out.Add(',');
+			}
+			Out.Append(Field.Key);
+
+			UProperty* Property = Field.Value.Property;
+			const void* Value = Property->ContainerPtrToValuePtr<uint8>(Struct);
+			bool bWritten = true;
+			if (Field.Value.Type == EPropertyType::Other)
+			{
+				TSharedPtr<FJsonValue> JsonValue = FJsonObjectConverter::UPropertyToJsonValue(Property, Value, Field.Value.CheckFlags, Field.Value.SkipFlags);
+				bWritten = JsonValue.IsValid();
+				if (bWritten)
+				{
+					AppendJsonValue(Out, JsonValue);
+				}
+			}
+			else if (Property->ArrayDim == 1)
+			{
+				bWritten = WriteScalar(Out, Field.Value, Value);
+			}
+			else
+			{
+				Out.Add('[');
+				for (int32 Index = 0; Index < Property->ArrayDim && bWritten; ++Index)
+				{
+					if (Index > 0)
+					{
+						Out.Add(',');
+					}
+					bWritten = WriteScalar(Out, Field.Value, (const uint8*)Value + Index * Property->ElementSize);
+				}
+				Out.Add(']');
+			}
+
+			if (!bWritten)
+			{
+				UE_LOG(LogJson, Error, TEXT("UStructToJsonObject - Unhandled property type '%s': %s"), *Property->GetClass()->GetName(), *Property->GetPathName());
+				return false;
+			}
+		}
+		Out.Add('}');
+		return true;
+	}
+}
+
+bool FJsonObjectConverter::UStructToJsonUtf8(const UStruct* StructDefinition, const void* Struct, TArray<uint8>& OutUtf8Json, int64 CheckFlags, int64 SkipFlags)
+{
+	using namespace JsonUtf8Writer;
+
+	if (SkipFlags == 0)
+	{
+		// If we have no specified skip flags, skip deprecated, transient and skip serialization by default when writing
+		SkipFlags |= CPF_Deprecated | CPF_Transient;
+	}
+
+	const int32 StartNum = OutUtf8Json.Num();
+	bool bSuccess = false;
+	if (FPlanCache::CanHavePlan(StructDefinition))
+	{
+		bSuccess = WriteStruct(OutUtf8Json, *FPlanCache::Get().FindOrAdd(StructDefinition, CheckFlags, SkipFlags), Struct);
+	}
+	else
+	{
+		TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+		bSuccess = UStructToJsonObject(StructDefinition, Struct, JsonObject, CheckFlags, SkipFlags);
+		if (bSuccess)
+		{
+			AppendJsonValue(OutUtf8Json, MakeShared<FJsonValueObject>(JsonObject));
+		}
+	}
+
+	if (!bSuccess)
+	{
+		OutUtf8Json.SetNum(StartNum, false);
+	}
+	return bSuccess;
+}
@@ -0,0 +1,167 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/SoftObjectPath.h"
+#include "Misc/Guid.h"
+#include "JsonObjectConverterTestTypes.generated.h"
+
+/**
+ * Test enum written as an enum property.
+ */
+UENUM()
+enum class EJsonConverterTestEnum : uint8
+{
+	First,
+	Second,
+	Third,
+};
+
+/**
+ * Test enum written as a byte property.
+ */
+UENUM()
+namespace EJsonConverterTestByteEnum
+{
+	enum Type
+	{
+		Off,
+		On,
+	};
+}
+
+/**
+ * Test structure nested in FJsonConverterTestStruct.
+ */
+USTRUCT()
+struct FJsonConverterTestInnerStruct
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Value;
+
+	UPROPERTY()
+	FString Label;
+
+	UPROPERTY()
+	EJsonConverterTestEnum Enum;
+
+	/** Default constructor. */
+	FJsonConverterTestInnerStruct()
+		: Value(0)
+		, Enum(EJsonConverterTestEnum::First)
+	{ }
+};
+
+/**
+ * Test structure with every kind of property the Json converters handle.
+ */
+USTRUCT()
+struct FJsonConverterTestStruct
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	bool Bool;
+
+	UPROPERTY()
+	int8 Int8;
+
+	UPROPERTY()
+	int32 Int32;
+
+	UPROPERTY()
+	int64 Int64;
+
+	UPROPERTY()
+	uint8 UInt8;
+
+	UPROPERTY()
+	uint32 UInt32;
+
+	UPROPERTY()
+	float Float;
+
+	UPROPERTY()
+	double Double;
+
+	UPROPERTY()
+	EJsonConverterTestEnum Enum;
+
+	UPROPERTY()
+	TEnumAsByte<EJsonConverterTestByteEnum::Type> ByteEnum;
+
+	UPROPERTY()
+	FString String;
+
+	UPROPERTY()
+	FName Name;
+
+	UPROPERTY()
+	FText Text;
+
+	UPROPERTY()
+	int32 StaticArray[3];
+
+	UPROPERTY()
+	EJsonConverterTestEnum StaticEnumArray[2];
+
+	UPROPERTY()
+	FJsonConverterTestInnerStruct Inner;
+
+	UPROPERTY()
+	FJsonConverterTestInnerStruct StaticInnerArray[2];
+
+	UPROPERTY()
+	TArray<int32> IntArray;
+
+	UPROPERTY()
+	TArray<FString> StringArray;
+
+	UPROPERTY()
+	TArray<FJsonConverterTestInnerStruct> InnerArray;
+
+	UPROPERTY()
+	TMap<FString, int32> Map;
+
+	UPROPERTY()
+	TSet<FName> Set;
+
+	UPROPERTY()
+	FGuid Guid;
+
+	UPROPERTY()
+	FVector Vector;
+
+	UPROPERTY()
+	FSoftObjectPath SoftObjectPath;
+
+	UPROPERTY()
+	UObject* Object;
+
+	UPROPERTY(Transient)
+	int32 TransientValue;
+
+	/** Default constructor. */
+	FJsonConverterTestStruct()
+		: Bool(false)
+		, Int8(0)
+		, Int32(0)
+		, Int64(0)
+		, UInt8(0)
+		, UInt32(0)
+		, Float(0.0f)
+		, Double(0.0)
+		, Enum(EJsonConverterTestEnum::First)
+		, ByteEnum(EJsonConverterTestByteEnum::Off)
+		, Vector(FVector::ZeroVector)
+		, Object(nullptr)
+		, TransientValue(0)
+	{
+		FMemory::Memzero(StaticArray);
+		StaticEnumArray[0] = StaticEnumArray[1] = EJsonConverterTestEnum::First;
+	}
+};
@@ -0,0 +1,286 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "JsonObjectConverter.h"
+#include "Tests/JsonObjectConverterTestTypes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace JsonObjectConverterTest
+{
+	/** Appends a character the way FString stores it, as a surrogate pair where TCHAR is UTF-16 */
+	void AppendCodepoint(FString& String, uint32 Codepoint)
+	{
+		if (sizeof(TCHAR) == 2 && Codepoint >= 0x10000)
+		{
+			String.AppendChar((TCHAR)(0xD800 + ((Codepoint - 0x10000) >> 10)));
+			String.AppendChar((TCHAR)(0xDC00 + ((Codepoint - 0x10000) & 0x3FF)));
+		}
+		else
+		{
+			String.AppendChar((TCHAR)Codepoint);
+		}
+	}
+
+	/** Sets every property to something other than its default */
+	void FillTestStruct(FJsonConverterTestStruct& Struct)
+	{
+		Struct.Bool = true;
+		Struct.Int8 = -128;
+		Struct.Int32 = -2147483647;
+		Struct.Int64 = (1ll << 60) + 1;
+		Struct.UInt8 = 255;
+		Struct.UInt32 = 4294967295u;
+		Struct.Float = 0.1f;
+		Struct.Double = 1.0 / 3.0;
+		Struct.Enum = EJsonConverterTestEnum::Third;
+		Struct.ByteEnum = EJsonConverterTestByteEnum::On;
+
+		Struct.String = TEXT("Quote\" Backslash\\ Newline\n Tab\t Control");
+		Struct.String.AppendChar((TCHAR)1);
+		Struct.String += TEXT(" ");
+		AppendCodepoint(Struct.String, 0xE9);
+		Struct.String += TEXT(" ");
+		AppendCodepoint(Struct.String, 0x20AC);
+		Struct.String += TEXT(" ");
+		AppendCodepoint(Struct.String, 0x1F600);
+
+		Struct.Name = TEXT("Name_With_Number_7");
+		Struct.Text = FText::FromString(TEXT("Text \"quoted\""));
+
+		Struct.StaticArray[0] = 1;
+		Struct.StaticArray[1] = -2;
+		Struct.StaticArray[2] = 3;
+		Struct.StaticEnumArray[0] = EJsonConverterTestEnum::Second;
+		Struct.StaticEnumArray[1] = EJsonConverterTestEnum::Third;
+
+		Struct.Inner.Value = 7;
+		Struct.Inner.Label = TEXT("Inner");
+		Struct.Inner.Enum = EJsonConverterTestEnum::Second;
+		Struct.StaticInnerArray[1].Value = -7;
+		Struct.StaticInnerArray[1].Label = TEXT("Static inner");
+
+		Struct.IntArray = { 1, 2, 3 };
+		Struct.StringArray = { TEXT(""), TEXT("Two"), TEXT("Three") };
+		Struct.InnerArray.AddDefaulted(2);
+		Struct.InnerArray[1].Value = 42;
+		Struct.InnerArray[1].Enum = EJsonConverterTestEnum::Third;
+
+		Struct.Map.Add(TEXT("One"), 1);
+		Struct.Map.Add(TEXT("Two"), 2);
+		Struct.Set.Add(TEXT("First"));
+		Struct.Set.Add(TEXT("Second"));
+
+		Struct.Guid = FGuid(1, 2, 3, 4);
+		Struct.Vector = FVector(1.5f, -0.25f, 1.0e20f);
+		Struct.SoftObjectPath = FSoftObjectPath(TEXT("/Script/JsonUtilities.JsonObjectWrapper"));
+		Struct.TransientValue = 13;
+	}
+
+	FString Utf8ToString(const TArray<uint8>& Utf8, int32 Start)
+	{
+		FUTF8ToTCHAR Converted((const ANSICHAR*)Utf8.GetData() + Start, Utf8.Num() - Start);
+		return FString(Converted.Length(), Converted.Get());
+	}
+
+	bool ContainsUtf8(const TArray<uint8>& Utf8, const ANSICHAR* Expected)
+	{
+		const int32 ExpectedLen = FCStringAnsi::Strlen(Expected);
+		for (int32 Index = 0; Index + ExpectedLen <= Utf8.Num(); ++Index)
+		{
+			if (FMemory::Memcmp(Utf8.GetData() + Index, Expected, ExpectedLen) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Checks that UStructToJsonUtf8 appends exactly what UStructToJsonObjectString writes without pretty printing */
+	void TestSameAsJsonObjectString(FAutomationTestBase& Test, const TCHAR* What, const FJsonConverterTestStruct& Struct, int64 CheckFlags, int64 SkipFlags)
+	{
+		FString Expected;
+		Test.TestTrue(FString::Printf(TEXT("%s: UStructToJsonObjectString succeeds"), What), FJsonObjectConverter::UStructToJsonObjectString(Struct, Expected, CheckFlags, SkipFlags, 0, nullptr, false));
+
+		static const ANSICHAR Prefix[] = "[1,";
+		TArray<uint8> Utf8;
+		Utf8.Append((const uint8*)Prefix, ARRAY_COUNT(Prefix) - 1);
+
+		Test.TestTrue(FString::Printf(TEXT("%s: UStructToJsonUtf8 succeeds"), What), FJsonObjectConverter::UStructToJsonUtf8(Struct, Utf8, CheckFlags, SkipFlags));
+		Test.TestTrue(FString::Printf(TEXT("%s: UStructToJsonUtf8 appends"), What), Utf8.Num() >= ARRAY_COUNT(Prefix) - 1 && FMemory::Memcmp(Utf8.GetData(), Prefix, ARRAY_COUNT(Prefix) - 1) == 0);
+
+		// FString comparisons in TestEqual ignore case
+		const FString Actual = Utf8ToString(Utf8, ARRAY_COUNT(Prefix) - 1);
+		if (!Actual.Equals(Expected, ESearchCase::CaseSensitive))
+		{
+			Test.AddError(FString::Printf(TEXT("%s: UStructToJsonUtf8 wrote\n%s\ninstead of\n%s"), What, *Actual, *Expected));
+		}
+	}
+
+	bool ReadUtf8(const FString& Json, FJsonConverterTestStruct& OutStruct)
+	{
+		FTCHARToUTF8 Utf8(*Json);
+		return FJsonObjectConverter::JsonUtf8ToUStruct(TArrayView<const uint8>((const uint8*)Utf8.Get(), Utf8.Length()), &OutStruct);
+	}
+
+	/** Checks that JsonUtf8ToUStruct reads Json written by UStructToJsonObjectString into the same values as JsonObjectStringToUStruct */
+	void TestSameAsJsonObjectStringToUStruct(FAutomationTestBase& Test, const TCHAR* What, const FJsonConverterTestStruct& Struct, const FJsonConverterTestStruct& InitialStruct, bool bPrettyPrint)
+	{
+		FString Json;
+		FJsonObjectConverter::UStructToJsonObjectString(Struct, Json, 0, 0, 0, nullptr, bPrettyPrint);
+
+		FJsonConverterTestStruct Expected = InitialStruct;
+		Test.TestTrue(FString::Printf(TEXT("%s: JsonObjectStringToUStruct succeeds"), What), FJsonObjectConverter::JsonObjectStringToUStruct(Json, &Expected, 0, 0));
+
+		FJsonConverterTestStruct Actual = InitialStruct;
+		Test.TestTrue(FString::Printf(TEXT("%s: JsonUtf8ToUStruct succeeds"), What), ReadUtf8(Json, Actual));
+
+		// Compared by writing both, and with what was written first, which only differs in the properties Json doesn't keep
+		FString ExpectedJson, ActualJson;
+		FJsonObjectConverter::UStructToJsonObjectString(Expected, ExpectedJson, 0, 0, 0, nullptr, false);
+		FJsonObjectConverter::UStructToJsonObjectString(Actual, ActualJson, 0, 0, 0, nullptr, false);
+		if (!ActualJson.Equals(ExpectedJson, ESearchCase::CaseSensitive))
+		{
+			Test.AddError(FString::Printf(TEXT("%s: JsonUtf8ToUStruct read\n%s\ninstead of\n%s"), What, *ActualJson, *ExpectedJson));
+		}
+	}
+}
+
+/**
+ * FJsonObjectConverterUtf8WriterTest
+ * Checks that UStructToJsonUtf8 writes the same Json as UStructToJsonObjectString
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJsonObjectConverterUtf8WriterTest, "System.Engine.FileSystem.JSON.UStructToJsonUtf8", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FJsonObjectConverterUtf8WriterTest::RunTest(const FString& Parameters)
+{
+	using namespace JsonObjectConverterTest;
+
+	const FJsonConverterTestStruct DefaultStruct;
+	FJsonConverterTestStruct TestStruct;
+	FillTestStruct(TestStruct);
+
+	// Plans are cached per set of flags, so each set is written twice
+	for (int32 Pass = 0; Pass < 2; ++Pass)
+	{
+		TestSameAsJsonObjectString(*this, TEXT("Default values"), DefaultStruct, 0, 0);
+		TestSameAsJsonObjectString(*this, TEXT("Test values"), TestStruct, 0, 0);
+		TestSameAsJsonObjectString(*this, TEXT("Transient values"), TestStruct, 0, CPF_Deprecated);
+		TestSameAsJsonObjectString(*this, TEXT("Edit only values"), TestStruct, CPF_Edit, 0);
+	}
+
+	TArray<uint8> Utf8;
+	TestTrue(TEXT("UStructToJsonUtf8 succeeds"), FJsonObjectConverter::UStructToJsonUtf8(TestStruct, Utf8));
+
+	// Escaped like TJsonWriter, with everything else written as UTF-8 and characters outside the BMP as one character
+	TestTrue(TEXT("Strings are escaped"), ContainsUtf8(Utf8, "\"string\":\"Quote\\\" Backslash\\\\ Newline\\n Tab\\t Control\\u0001 \xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80\""));
+	TestTrue(TEXT("Text is escaped"), ContainsUtf8(Utf8, "\"text\":\"Text \\\"quoted\\\"\""));
+
+	// Numbers are written with enough digits to read back the same value
+	TestTrue(TEXT("Floats are written as doubles"), ContainsUtf8(Utf8, "\"float\":0.10000000149011612,"));
+	TestTrue(TEXT("Doubles keep 17 digits"), ContainsUtf8(Utf8, "\"double\":0.33333333333333331,"));
+	TestTrue(TEXT("Integers are written exactly"), ContainsUtf8(Utf8, "\"int32\":-2147483647,") && ContainsUtf8(Utf8, "\"uInt32\":4294967295,"));
+	TestTrue(TEXT("Integers too big for a double are written as one"), ContainsUtf8(Utf8, "\"int64\":1.152921504606847e+18,"));
+
+	// Enums are written by name, in static arrays too
+	TestTrue(TEXT("Enums are written by name"), ContainsUtf8(Utf8, "\"enum\":\"Third\",\"byteEnum\":\"On\","));
+	TestTrue(TEXT("Static arrays are written as arrays"), ContainsUtf8(Utf8, "\"staticArray\":[1,-2,3],\"staticEnumArray\":[\"Second\",\"Third\"],"));
+
+	// Nested structs, in static and dynamic arrays
+	TestTrue(TEXT("Nested structs are written as objects"), ContainsUtf8(Utf8, "\"inner\":{\"value\":7,\"label\":\"Inner\",\"enum\":\"Second\"},"));
+	TestTrue(TEXT("Static arrays of structs are written as arrays"), ContainsUtf8(Utf8, "{\"value\":-7,\"label\":\"Static inner\",\"enum\":\"First\"}],"));
+	TestTrue(TEXT("Arrays of structs are written as arrays"), ContainsUtf8(Utf8, "\"innerArray\":[{\"value\":0,\"label\":\"\",\"enum\":\"First\"},{\"value\":42,\"label\":\"\",\"enum\":\"Third\"}],"));
+
+	// Properties written through UPropertyToJsonValue
+	TestTrue(TEXT("Maps are written as objects"), ContainsUtf8(Utf8, "\"map\":{\"One\":1,\"Two\":2},"));
+	TestTrue(TEXT("Sets are written as arrays"), ContainsUtf8(Utf8, "\"set\":[\"First\",\"Second\"],"));
+	TestTrue(TEXT("Structs exporting text are written as strings"), ContainsUtf8(Utf8, "\"guid\":\"00000001000000020000000300000004\","));
+
+	TestFalse(TEXT("Transient properties are skipped"), ContainsUtf8(Utf8, "\"transientValue\""));
+
+	return true;
+}
+
+/**
+ * FJsonObjectConverterUtf8ReaderTest
+ * Checks that JsonUtf8ToUStruct reads what UStructToJsonObjectString writes, and fails on malformed Json
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJsonObjectConverterUtf8ReaderTest, "System.Engine.FileSystem.JSON.JsonUtf8ToUStruct", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FJsonObjectConverterUtf8ReaderTest::RunTest(const FString& Parameters)
+{
+	using namespace JsonObjectConverterTest;
+
+	const FJsonConverterTestStruct DefaultStruct;
+	FJsonConverterTestStruct TestStruct;
+	FillTestStruct(TestStruct);
+
+	// Read over default values and over values that have to be replaced, like arrays that have to shrink
+	for (bool bPrettyPrint : { false, true })
+	{
+		TestSameAsJsonObjectStringToUStruct(*this, TEXT("Test values"), TestStruct, DefaultStruct, bPrettyPrint);
+		TestSameAsJsonObjectStringToUStruct(*this, TEXT("Default values over test values"), DefaultStruct, TestStruct, bPrettyPrint);
+		TestSameAsJsonObjectStringToUStruct(*this, TEXT("Test values over test values"), TestStruct, TestStruct, bPrettyPrint);
+	}
+
+	FString Json;
+	FJsonObjectConverter::UStructToJsonObjectString(TestStruct, Json, 0, 0, 0, nullptr, false);
+
+	FJsonConverterTestStruct ReadStruct;
+	TestTrue(TEXT("JsonUtf8ToUStruct succeeds"), ReadUtf8(Json, ReadStruct));
+	TestTrue(TEXT("Floats read back exactly"), ReadStruct.Float == TestStruct.Float && ReadStruct.Double == TestStruct.Double);
+	TestTrue(TEXT("Escaped strings read back exactly"), ReadStruct.String.Equals(TestStruct.String, ESearchCase::CaseSensitive));
+	TestTrue(TEXT("Enums read back by name"), ReadStruct.Enum == TestStruct.Enum && ReadStruct.ByteEnum == TestStruct.ByteEnum && ReadStruct.StaticEnumArray[1] == TestStruct.StaticEnumArray[1]);
+	TestTrue(TEXT("Static arrays read back"), FMemory::Memcmp(ReadStruct.StaticArray, TestStruct.StaticArray, sizeof(TestStruct.StaticArray)) == 0);
+	TestTrue(TEXT("Nested structs read back"), ReadStruct.Inner.Value == TestStruct.Inner.Value && ReadStruct.StaticInnerArray[1].Label == TestStruct.StaticInnerArray[1].Label && ReadStruct.InnerArray.Num() == TestStruct.InnerArray.Num());
+	TestTrue(TEXT("Maps and sets read back"), ReadStruct.Map.OrderIndependentCompareEqual(TestStruct.Map) && ReadStruct.Set.Num() == TestStruct.Set.Num() && ReadStruct.Set.Contains(FName(TEXT("Second"))));
+
+	// Every message about malformed Json starts with the name of the function that gave up on it
+	AddExpectedError(TEXT("(JsonUtf8ToUStruct|JsonObjectToUStruct|JsonValueToUProperty) - "), EAutomationExpectedErrorFlags::Contains, 0);
+
+	static const TCHAR* MalformedJson[] =
+	{
+		TEXT(""),
+		TEXT("   "),
+		TEXT("[]"),
+		TEXT("\"string\""),
+		TEXT("{"),
+		TEXT("{\"int32\":1,}"),
+		TEXT("{\"int32\" 1}"),
+		TEXT("{\"int32\":1 \"bool\":true}"),
+		TEXT("{\"int32\":}"),
+		TEXT("{\"bool\":tru}"),
+		TEXT("{\"string\":\"unterminated}"),
+		TEXT("{\"string\":\"bad escape \\x\"}"),
+		TEXT("{\"intArray\":[1,2}"),
+		TEXT("{\"staticArray\":[1,2"),
+		TEXT("{\"inner\":{\"value\":1}"),
+		TEXT("{\"inner\":5}"),
+		TEXT("{\"map\":{\"One\":}}"),
+		TEXT("{\"unknown\":{\"nested\":[1,2}}"),
+		TEXT("{\"int32\":1}}"),
+		TEXT("{\"int32\":1} {}"),
+		TEXT("{\"int32\":1} x"),
+	};
+
+	for (const TCHAR* Malformed : MalformedJson)
+	{
+		FJsonConverterTestStruct MalformedStruct;
+		TestFalse(FString::Printf(TEXT("Malformed Json is read: %s"), Malformed), ReadUtf8(Malformed, MalformedStruct));
+	}
+
+	// Json cut short anywhere is malformed too
+	for (int32 Len = 0; Len < Json.Len(); ++Len)
+	{
+		FJsonConverterTestStruct TruncatedStruct;
+		if (ReadUtf8(Json.Left(Len), TruncatedStruct))
+		{
+			AddError(FString::Printf(TEXT("Json cut short is read: %s"), *Json.Left(Len)));
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
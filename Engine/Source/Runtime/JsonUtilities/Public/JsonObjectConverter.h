@@ -133,6 +133,38 @@ public: // UStruct -> JSON
 		return false;
 	}
 
+	/**
+	 * Converts from a UStruct to condensed UTF-8 Json, the same Json UStructToJsonObjectString writes without pretty
+	 * printing but without making Json objects first. How to write each native struct is worked out once and cached, so
+	 * writing into a reused array allocates nothing for structs made of numbers, bools, enums, strings, names, text,
+	 * structs and arrays of those. Other properties, and structs that aren't native, are converted through Json values.
+	 *
+	 * @param StructDefinition UStruct definition that is looked over for properties
+	 * @param Struct The UStruct instance to copy out of
+	 * @param OutUtf8Json Array the Json is appended to, left as it was on failure
+	 * @param CheckFlags Only convert properties that match at least one of these flags. If 0 check all properties.
+	 * @param SkipFlags Skip properties that match any of these flags
+	 *
+	 * @return False if any properties failed to write
+	 */
+	static bool UStructToJsonUtf8(const UStruct* StructDefinition, const void* Struct, TArray<uint8>& OutUtf8Json, int64 CheckFlags = 0, int64 SkipFlags = 0);
+
+	/**
+	 * Templated version of UStructToJsonUtf8
+	 *
+	 * @param InStruct The UStruct instance to copy out of
+	 * @param OutUtf8Json Array the Json is appended to, left as it was on failure
+	 * @param CheckFlags Only convert properties that match at least one of these flags. If 0 check all properties.
+	 * @param SkipFlags Skip properties that match any of these flags
+	 *
+	 * @return False if any properties failed to write
+	 */
+	template<typename InStructType>
+	static bool UStructToJsonUtf8(const InStructType& InStruct, TArray<uint8>& OutUtf8Json, int64 CheckFlags = 0, int64 SkipFlags = 0)
+	{
+		return UStructToJsonUtf8(InStructType::StaticStruct(), &InStruct, OutUtf8Json, CheckFlags, SkipFlags);
+	}
+
 	/**
 	 * Converts from a UStruct to a set of json attributes (possibly from within a JsonObject)
 	 *
@@ -216,6 +248,37 @@ public: // JSON -> UStruct
 	 */
 	static bool JsonValueToUProperty(const TSharedPtr<FJsonValue>& JsonValue, UProperty* Property, void* OutValue, int64 CheckFlags, int64 SkipFlags);
 
+	/**
+	 * Converts from UTF-8 Json containing an object to a UStruct, reading the Json straight into the properties instead
+	 * of parsing it into Json objects first. Properties that aren't structs, arrays, numbers, booleans or strings are
+	 * converted from a Json value of just their part of the Json, the same way JsonObjectToUStruct converts them.
+	 *
+	 * @param Utf8Json UTF-8 Json containing an object
+	 * @param StructDefinition UStruct definition that is looked over for properties
+	 * @param OutStruct The UStruct instance to copy in to
+	 * @param CheckFlags Only convert properties that match at least one of these flags. If 0 check all properties.
+	 * @param SkipFlags Skip properties that match any of these flags
+	 *
+	 * @return False if the Json is invalid or any properties matched but failed to deserialize
+	 */
+	static bool JsonUtf8ToUStruct(TArrayView<const uint8> Utf8Json, const UStruct* StructDefinition, void* OutStruct, int64 CheckFlags = 0, int64 SkipFlags = 0);
+
+	/**
+	 * Templated version of JsonUtf8ToUStruct
+	 *
+	 * @param Utf8Json UTF-8 Json containing an object
+	 * @param OutStruct The UStruct instance to copy in to
+	 * @param CheckFlags Only convert properties that match at least one of these flags. If 0 check all properties.
+	 * @param SkipFlags Skip properties that match any of these flags
+	 *
+	 * @return False if the Json is invalid or any properties matched but failed to deserialize
+	 */
+	template<typename OutStructType>
+	static bool JsonUtf8ToUStruct(TArrayView<const uint8> Utf8Json, OutStructType* OutStruct, int64 CheckFlags = 0, int64 SkipFlags = 0)
+	{
+		return JsonUtf8ToUStruct(Utf8Json, OutStructType::StaticStruct(), OutStruct, CheckFlags, SkipFlags);
+	}
+
 	/**
 	 * Converts from a json string containing an object to a UStruct
 	 *
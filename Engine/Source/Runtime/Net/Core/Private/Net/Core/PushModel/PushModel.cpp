@@ -0,0 +1,81 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Net/Core/PushModel/PushModel.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/Core/Misc/NetCoreLog.h"
+
+namespace UEPushModelPrivate
+{
+	bool bIsPushModelEnabled = false;
+
+	static FAutoConsoleVariableRef CVarIsPushModelEnabled(
+		TEXT("net.IsPushModelEnabled"),
+		bIsPushModelEnabled,
+		TEXT("When true, properties replicated with bIsPushBased are only compared after they're marked dirty. Objects that started replicating while this was false keep comparing every property."),
+		ECVF_Default);
+
+	/** Dirty bits of every net driver replicating an object, most objects are replicated by one */
+	typedef TArray<TBitArray<>*, TInlineAllocator<1>> FDirtyListeners;
+
+	static TMap<const UObject*, FDirtyListeners>& GetDirtyListenerMap()
+	{
+		static TMap<const UObject*, FDirtyListeners> DirtyListenerMap;
+		return DirtyListenerMap;
+	}
+
+	void MarkPropertyDirty(const UObject* Object, const UProperty* Property, int32 ArrayIndex)
+	{
+		if (!Object || !Property)
+		{
+			return;
+		}
+
+		FDirtyListeners* Listeners = GetDirtyListenerMap().Find(Object);
+		if (!Listeners)
+		{
+			return;
+		}
+
+		// RepIndex is only set up once the class replicates, which it does if there are listeners
+		const int32 StartRepIndex = Property->RepIndex + (ArrayIndex == INDEX_NONE ? 0 : ArrayIndex);
+		const int32 EndRepIndex = ArrayIndex == INDEX_NONE ? Property->RepIndex + Property->ArrayDim : StartRepIndex + 1;
+		checkSlow(ArrayIndex == INDEX_NONE || ArrayIndex < Property->ArrayDim);
+
+		for (TBitArray<>* DirtyBits : *Listeners)
+		{
+			if (ensureMsgf(EndRepIndex <= DirtyBits->Num(), TEXT("MarkPropertyDirty: %s is not a replicated property of %s"), *Property->GetName(), *Object->GetName()))
+			{
+				DirtyBits->SetRange(StartRepIndex, EndRepIndex - StartRepIndex, true);
+			}
+		}
+	}
+
+	void AddDirtyListener(const UObject* Object, TBitArray<>* DirtyBits)
+	{
+		GetDirtyListenerMap().FindOrAdd(Object).AddUnique(DirtyBits);
+	}
+
+	void RemoveDirtyListener(const UObject* Object, TBitArray<>* DirtyBits)
+	{
+		TMap<const UObject*, FDirtyListeners>& DirtyListenerMap = GetDirtyListenerMap();
+		if (FDirtyListeners* Listeners = DirtyListenerMap.Find(Object))
+		{
+			Listeners->RemoveSingleSwap(DirtyBits, false);
+			if (Listeners->Num() == 0)
+			{
+				DirtyListenerMap.Remove(Object);
+			}
+		}
+	}
+
+	const UProperty* FindReplicatedProperty(const UClass* Class, const FName PropertyName)
+	{
+		const UProperty* Property = FindField<UProperty>(Class, PropertyName);
+		if (!Property || !Property->HasAnyPropertyFlags(CPF_Net))
+		{
+			UE_LOG(LogNetCore, Error, TEXT("FindReplicatedProperty: %s.%s is not a replicated property, it can't be marked dirty."), *GetNameSafe(Class), *PropertyName.ToString());
+			return nullptr;
+		}
+		return Property;
+	}
+}
@@ -0,0 +1,84 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/UnrealType.h"
+
+/**
+ * Push Model
+ *
+ * By default the server finds out what to send by comparing every replicated property of an object against the copy
+ * it kept when the object was last compared, every time the object is considered for replication. That's most of the
+ * work for objects that rarely change.
+ *
+ * Properties registered with FDoRepLifetimeParams::bIsPushBased are only compared after gameplay code has marked them
+ * dirty with one of the MARK_PROPERTY_DIRTY macros below, every other property of the class is still compared as
+ * before. A push based property that changes without being marked dirty won't be sent, so every place that sets it
+ * has to mark it.
+ *
+ * Push Model is off by default. Until net.IsPushModelEnabled is set, marking properties dirty does nothing and every
+ * property is compared.
+ */
+namespace UEPushModelPrivate
+{
+	/** Whether push based properties are only compared once marked dirty, see net.IsPushModelEnabled */
+	extern NETCORE_API bool bIsPushModelEnabled;
+
+	/**
+	 * Marks a replicated property of Object dirty for every net driver replicating it.
+	 * Objects that aren't being replicated yet are skipped, they compare every property the first time.
+	 * Must be called on the game thread.
+	 *
+	 * @param Object		The object that owns the property.
+	 * @param Property		A replicated property of the object's class.
+	 * @param ArrayIndex	Element of a static array property, or INDEX_NONE for all of them.
+	 */
+	NETCORE_API void MarkPropertyDirty(const UObject* Object, const UProperty* Property, int32 ArrayIndex = INDEX_NONE);
+
+	/**
+	 * Adds bits that MarkPropertyDirty sets for Object, one per RepIndex of the object's class.
+	 * DirtyBits must stay where it is until it's removed again.
+	 */
+	NETCORE_API void AddDirtyListener(const UObject* Object, TBitArray<>* DirtyBits);
+
+	/** Removes bits added with AddDirtyListener. Object is only used as a key and may already be destroyed. */
+	NETCORE_API void RemoveDirtyListener(const UObject* Object, TBitArray<>* DirtyBits);
+
+	/** Finds a property of a class by name once, for the MARK_PROPERTY_DIRTY_FROM_NAME macros */
+	NETCORE_API const UProperty* FindReplicatedProperty(const UClass* Class, const FName PropertyName);
+}
+
+#define IS_PUSH_MODEL_ENABLED() (UEPushModelPrivate::bIsPushModelEnabled)
+
+/** Marks every element of a replicated property of Object dirty */
+#define MARK_PROPERTY_DIRTY(Object, Property) \
+do \
+{ \
+	if (IS_PUSH_MODEL_ENABLED()) \
+	{ \
+		UEPushModelPrivate::MarkPropertyDirty(Object, Property); \
+	} \
+} while (0)
+
+/** Marks a replicated property of Object dirty, where the property is declared in ClassName as PropertyName */
+#define MARK_PROPERTY_DIRTY_FROM_NAME(ClassName, PropertyName, Object) \
+do \
+{ \
+	if (IS_PUSH_MODEL_ENABLED()) \
+	{ \
+		static const UProperty* PushModelProperty = UEPushModelPrivate::FindReplicatedProperty(ClassName::StaticClass(), GET_MEMBER_NAME_CHECKED(ClassName, PropertyName)); \
+		UEPushModelPrivate::MarkPropertyDirty(Object, PushModelProperty); \
+	} \
+} while (0)
+
+/** Marks one element of a replicated static array property of Object dirty */
+#define MARK_PROPERTY_DIRTY_FROM_NAME_STATIC_ARRAY_INDEX(ClassName, PropertyName, ArrayIndex, Object) \
+do \
+{ \
+	if (IS_PUSH_MODEL_ENABLED()) \
+	{ \
+		static const UProperty* PushModelProperty = UEPushModelPrivate::FindReplicatedProperty(ClassName::StaticClass(), GET_MEMBER_NAME_CHECKED(ClassName, PropertyName)); \
+		UEPushModelPrivate::MarkPropertyDirty(Object, PushModelProperty, ArrayIndex); \
+	} \
+} while (0)
@@ -6,6 +6,7 @@
 #include "Misc/CommandLine.h"
 #include "Async/AsyncWork.h"
 #include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "HAL/IConsoleManager.h"
 #include "HAL/LowLevelMemTracker.h"
 #include "Misc/CoreDelegates.h"
@@ -32,6 +33,9 @@
 #include "Misc/Fnv.h"
 
 #include "Async/MappedFileHandle.h"
+#include "PakPathHashIndex.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
 
 DEFINE_LOG_CATEGORY(LogPakFile);
 
@@ -435,6 +439,76 @@ static FAutoConsoleVariableRef CVar_NumUnreferencedBlocksToCache(
 	TEXT("Controls the maximum number of unreferenced blocks to keep. This is a classic disk cache and the maxmimum wasted memory is pakcache.MaxRequestSizeToLowerLevellKB * pakcache.NumUnreferencedBlocksToCache.")
 );
 
+int32 GPakCache_LoadOrderBudgetMB = 64;
+static FAutoConsoleVariableRef CVar_LoadOrderBudgetMB(
+	TEXT("pakcache.LoadOrderBudgetMB"),
+	GPakCache_LoadOrderBudgetMB,
+	TEXT("Controls how much (in MB) of a replayed load order (pak.ReplayLoadOrder) is read ahead of the loader asking for it.")
+);
+
+/** A range of a pak file in a recorded load order */
+struct FPakLoadOrderEntry
+{
+	/** Clean filename of the pak, so load orders can be replayed from a different install directory */
+	FName PakFile;
+	/** Size of the pak when the load order was recorded, entries for a different build of the pak are ignored */
+	int64 PakSize;
+	int64 Offset;
+	int64 Size;
+};
+
+static const TCHAR* PakLoadOrderHeader = TEXT("PakLoadOrder,1");
+
+/** Load orders are read and written with the platform file below the pak file, as they are used while it starts up and shuts down */
+static bool SavePakLoadOrder(IPlatformFile& PlatformFile, const FString& Filename, const TArray<FPakLoadOrderEntry>& LoadOrder)
+{
+	FString Text = PakLoadOrderHeader;
+	Text += LINE_TERMINATOR;
+	for (const FPakLoadOrderEntry& Entry : LoadOrder)
+	{
+		Text += FString::Printf(TEXT("%s,%lld,%lld,%lld%s"), *Entry.PakFile.ToString(), Entry.PakSize, Entry.Offset, Entry.Size, LINE_TERMINATOR);
+	}
+
+	TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*Filename));
+	FTCHARToUTF8 Utf8Text(*Text);
+	return Handle && Handle->Write((const uint8*)Utf8Text.Get(), Utf8Text.Length());
+}
+
+static bool LoadPakLoadOrder(IPlatformFile& PlatformFile, const FString& Filename, TArray<FPakLoadOrderEntry>& OutLoadOrder)
+{
+	TUniquePtr<IFileHandle> Handle(PlatformFile.OpenRead(*Filename));
+	TArray<uint8> Bytes;
+	Bytes.SetNumUninitialized(Handle ? Handle->Size() : 0);
+	if (!Handle || !Handle->Read(Bytes.GetData(), Bytes.Num()))
+	{
+		return false;
+	}
+	FString Text;
+	FFileHelper::BufferToString(Text, Bytes.GetData(), Bytes.Num());
+
+	TArray<FString> Lines;
+	Text.ParseIntoArrayLines(Lines);
+	if (Lines.Num() == 0 || Lines[0] != PakLoadOrderHeader)
+	{
+		return false;
+	}
+	OutLoadOrder.Reset(Lines.Num() - 1);
+	TArray<FString> Fields;
+	for (int32 LineIndex = 1; LineIndex < Lines.Num(); LineIndex++)
+	{
+		if (Lines[LineIndex].ParseIntoArray(Fields, TEXT(","), false) != 4)
+		{
+			return false;
+		}
+		FPakLoadOrderEntry& Entry = OutLoadOrder.AddDefaulted_GetRef();
+		Entry.PakFile = FName(*Fields[0]);
+		Entry.PakSize = FCString::Atoi64(*Fields[1]);
+		Entry.Offset = FCString::Atoi64(*Fields[2]);
+		Entry.Size = FCString::Atoi64(*Fields[3]);
+	}
+	return true;
+}
+
 class FPakPrecacher;
 
 typedef uint64 FJoinedOffsetAndPakIndex;
@@ -1187,6 +1261,7 @@ class FPakPrecacher
 		uint32 MaxShift;
 		uint32 BytesToBitsShift;
 		FName Name;
+		FName LoadOrderName;
 
 		TIntervalTreeIndex InRequests[AIOP_NUM][(int32)EInRequestStatus::Num];
 		TIntervalTreeIndex CacheBlocks[(int32)EBlockStatus::Num];
@@ -1201,6 +1276,7 @@ class FPakPrecacher
 			, MaxShift(0)
 			, BytesToBitsShift(0)
 			, Name(InName)
+			, LoadOrderName(*FPaths::GetCleanFilename(InName.ToString()))
 			, Signatures(nullptr)
 		{
 			check(Handle && TotalSize > 0 && Name != NAME_None);
@@ -1285,6 +1361,29 @@ class FPakPrecacher
 	EAsyncIOPriorityAndFlags AsyncMinPriority;
 	FCriticalSection SetAsyncMinimumPriorityScopeLock;
 	bool bEnableSignatureChecks;
+
+	/** Holds the blocks of a replayed load order entry in the cache until the loader asks for them */
+	struct FLoadOrderRequest : public IPakRequestor
+	{
+		int32 EntryIndex;
+		int64 Size;
+	};
+
+	/** Ranges in the order they were first asked for, with adjacent ranges coalesced */
+	TArray<FPakLoadOrderEntry> RecordedLoadOrder;
+	/** PAK_CACHE_GRANULARITY blocks of each pak that are already in RecordedLoadOrder */
+	TMap<FName, TSet<int64>> RecordedLoadOrderBlocks;
+	/** Where to save RecordedLoadOrder at shutdown, from -RecordPakLoadOrder= */
+	FString LoadOrderRecordFilename;
+	bool bRecordingLoadOrder;
+
+	TArray<FPakLoadOrderEntry> LoadOrder;
+	/** Index of the load order entry for each PAK_CACHE_GRANULARITY block of each pak */
+	TMap<FName, TMap<int64, int32>> LoadOrderEntryForBlock;
+	/** Requests for the entries that have been read ahead, oldest first */
+	TArray<TUniquePtr<FLoadOrderRequest>> LoadOrderRequests;
+	int32 NextLoadOrderEntry;
+	int64 LoadOrderBytesRequested;
 public:
 
 	static void Init(IPlatformFile* InLowerLevel, bool bInEnableSignatureChecks) 
@@ -1303,6 +1402,11 @@ public:
 			FPakPrecacher* LocalPakPrecacherSingleton = PakPrecacherSingleton;
 			if (LocalPakPrecacherSingleton && LocalPakPrecacherSingleton == FPlatformAtomics::InterlockedCompareExchangePointer((void**)&PakPrecacherSingleton, nullptr, LocalPakPrecacherSingleton))
 			{
+				if (!LocalPakPrecacherSingleton->LoadOrderRecordFilename.IsEmpty())
+				{
+					LocalPakPrecacherSingleton->SaveLoadOrder(LocalPakPrecacherSingleton->LoadOrderRecordFilename);
+				}
+				LocalPakPrecacherSingleton->StopLoadOrderReplay();
 				LocalPakPrecacherSingleton->TrimCache(true);
 				double StartTime = FPlatformTime::Seconds();
 				while (!LocalPakPrecacherSingleton->IsProbablyIdle())
@@ -1339,10 +1443,23 @@ public:
 		, LoadSize(0)
 		, AsyncMinPriority(AIOP_MIN)
 		, bEnableSignatureChecks(bInEnableSignatureChecks)
+		, bRecordingLoadOrder(false)
+		, NextLoadOrderEntry(0)
+		, LoadOrderBytesRequested(0)
 	{
 		check(LowerLevel && FPlatformProcess::SupportsMultithreading());
 		GPakCache_MaxRequestsToLowerLevel = FMath::Max(FMath::Min(FPlatformMisc::NumberOfIOWorkerThreadsToSpawn(), GPakCache_MaxRequestsToLowerLevel), 1);
 		check(GPakCache_MaxRequestsToLowerLevel <= PAK_CACHE_MAX_REQUESTS);
+
+		if (FParse::Value(FCommandLine::Get(), TEXT("RecordPakLoadOrder="), LoadOrderRecordFilename))
+		{
+			StartRecordingLoadOrder();
+		}
+		FString LoadOrderReplayFilename;
+		if (FParse::Value(FCommandLine::Get(), TEXT("ReplayPakLoadOrder="), LoadOrderReplayFilename))
+		{
+			StartLoadOrderReplay(LoadOrderReplayFilename);
+		}
 	}
 
 	void StartSignatureCheck(bool bWasCanceled, IAsyncReadRequest* Request, int32 IndexToFill);
@@ -2548,6 +2665,136 @@ private: // below here we assume CachedFilesScopeLock until we get to the next s
 		return true;
 	}
 
+	TIntervalTreeIndex NewRequest(IPakRequestor* Owner, uint16 PakIndex, int64 Offset, int64 Size, EAsyncIOPriorityAndFlags PriorityAndFlags)
+	{
+		// CachedFilesScopeLock is locked
+		TIntervalTreeIndex RequestIndex = InRequestAllocator.Alloc();
+		FPakInRequest& Request = InRequestAllocator.Get(RequestIndex);
+		Request.OffsetAndPakIndex = MakeJoinedRequest(PakIndex, Offset);
+		Request.Size = Size;
+		Request.PriorityAndFlags = PriorityAndFlags;
+		Request.Status = EInRequestStatus::Waiting;
+		Request.Owner = Owner;
+		Request.UniqueID = NextUniqueID++;
+		Request.Index = RequestIndex;
+		check(Request.Next == IntervalTreeInvalidIndex);
+		Owner->OffsetAndPakIndex = Request.OffsetAndPakIndex;
+		Owner->UniqueID = Request.UniqueID;
+		Owner->InRequestIndex = RequestIndex;
+		check(!OutstandingRequests.Contains(Request.UniqueID));
+		OutstandingRequests.Add(Request.UniqueID, RequestIndex);
+		RequestCounter.Increment();
+		return RequestIndex;
+	}
+
+	void RecordLoadOrder(uint16 PakIndex, int64 Offset, int64 Size)
+	{
+		// CachedFilesScopeLock is locked
+		const FPakData& Pak = CachedPakData[PakIndex];
+		TSet<int64>& RecordedBlocks = RecordedLoadOrderBlocks.FindOrAdd(Pak.LoadOrderName);
+		bool bAnyNewBlocks = false;
+		for (int64 Block = Offset / PAK_CACHE_GRANULARITY; Block <= (Offset + Size - 1) / PAK_CACHE_GRANULARITY; Block++)
+		{
+			bool bAlreadyRecorded = false;
+			RecordedBlocks.Add(Block, &bAlreadyRecorded);
+			bAnyNewBlocks |= !bAlreadyRecorded;
+		}
+		if (!bAnyNewBlocks)
+		{
+			return;
+		}
+
+		// Coalesce with the previous range while the loader reads on through the same pak, up to the size of a read to the lower level.
+		// A gap of up to one block is bridged, it would mostly be read anyway since reads are block aligned.
+		if (RecordedLoadOrder.Num())
+		{
+			FPakLoadOrderEntry& Last = RecordedLoadOrder.Last();
+			int64 End = FMath::Max(Offset + Size, Last.Offset + Last.Size);
+			if (Last.PakFile == Pak.LoadOrderName && Offset >= Last.Offset && Offset <= Last.Offset + Last.Size + PAK_CACHE_GRANULARITY && End - Last.Offset <= GPakCache_MaxRequestSizeToLowerLevelKB * 1024)
+			{
+				Last.Size = End - Last.Offset;
+				return;
+			}
+		}
+		FPakLoadOrderEntry& Entry = RecordedLoadOrder.AddDefaulted_GetRef();
+		Entry.PakFile = Pak.LoadOrderName;
+		Entry.PakSize = Pak.TotalSize;
+		Entry.Offset = Offset;
+		Entry.Size = Size;
+	}
+
+	int32 FindPakForLoadOrder(const FPakLoadOrderEntry& Entry)
+	{
+		// CachedFilesScopeLock is locked
+		for (int32 PakIndex = 0; PakIndex < CachedPakData.Num(); PakIndex++)
+		{
+			const FPakData& Pak = CachedPakData[PakIndex];
+			if (Pak.Handle && Pak.LoadOrderName == Entry.PakFile)
+			{
+				return PakIndex;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	void RequestLoadOrder()
+	{
+		// CachedFilesScopeLock is locked
+		const int64 Budget = int64(GPakCache_LoadOrderBudgetMB) * 1024 * 1024;
+		while (NextLoadOrderEntry < LoadOrder.Num() && LoadOrderBytesRequested < Budget)
+		{
+			const FPakLoadOrderEntry& Entry = LoadOrder[NextLoadOrderEntry];
+			int32 PakIndex = FindPakForLoadOrder(Entry);
+			if (PakIndex == INDEX_NONE)
+			{
+				// paks are registered the first time they are read from, carry on from here once this one is
+				break;
+			}
+			const int32 EntryIndex = NextLoadOrderEntry++;
+			if (Entry.PakSize != CachedPakData[PakIndex].TotalSize || Entry.Offset < 0 || Entry.Size <= 0 || Entry.Offset + Entry.Size > Entry.PakSize)
+			{
+				continue; // recorded with a different build of the pak
+			}
+
+			// Replayed below normal priority, so anything the loader is waiting on goes first and neighbouring requests are merged into the same reads
+			FLoadOrderRequest* Request = LoadOrderRequests.Add_GetRef(MakeUnique<FLoadOrderRequest>()).Get();
+			Request->EntryIndex = EntryIndex;
+			Request->Size = Entry.Size;
+			LoadOrderBytesRequested += Entry.Size;
+			AddRequest(NewRequest(Request, PakIndex, Entry.Offset, Entry.Size, AIOP_Low));
+		}
+	}
+
+	void ReleaseLoadOrderRequest(int32 Index)
+	{
+		// CachedFilesScopeLock is locked
+		TUniquePtr<FLoadOrderRequest> Request = MoveTemp(LoadOrderRequests[Index]);
+		LoadOrderRequests.RemoveAt(Index);
+		LoadOrderBytesRequested -= Request->Size;
+		TIntervalTreeIndex RequestIndex = OutstandingRequests.FindRef(Request->UniqueID);
+		check(RequestIndex != IntervalTreeInvalidIndex);
+		RemoveRequest(RequestIndex);
+	}
+
+	void AdvanceLoadOrder(uint16 PakIndex, int64 Offset)
+	{
+		// CachedFilesScopeLock is locked
+		const TMap<int64, int32>* EntryForBlock = LoadOrderEntryForBlock.Find(CachedPakData[PakIndex].LoadOrderName);
+		const int32* EntryIndex = EntryForBlock ? EntryForBlock->Find(Offset / PAK_CACHE_GRANULARITY) : nullptr;
+		if (EntryIndex)
+		{
+			// The loader has moved on to this entry, so the earlier ones have been asked for or won't be. This one is held until the
+			// loader moves past it, as it may be asked for in several pieces. Inside a completion callback the requests being completed
+			// can't be removed, so they are left for the next request.
+			while (!NotifyRecursion && LoadOrderRequests.Num() && LoadOrderRequests[0]->EntryIndex < *EntryIndex)
+			{
+				ReleaseLoadOrderRequest(0);
+			}
+			NextLoadOrderEntry = FMath::Max(NextLoadOrderEntry, *EntryIndex + 1);
+		}
+		RequestLoadOrder();
+	}
+
 	///// Below here are the thread entrypoints
 
 public:
@@ -2585,37 +2832,31 @@ public:
 		FPakData& Pak = CachedPakData[PakIndex];
 		check(Pak.Name == File && Pak.TotalSize == PakFileSize && Pak.Handle);
 
-		TIntervalTreeIndex RequestIndex = InRequestAllocator.Alloc();
-		FPakInRequest& Request = InRequestAllocator.Get(RequestIndex);
 		FJoinedOffsetAndPakIndex RequestOffsetAndPakIndex = MakeJoinedRequest(PakIndex, Offset);
-		Request.OffsetAndPakIndex = RequestOffsetAndPakIndex;
-		Request.Size = Size;
-		Request.PriorityAndFlags = PriorityAndFlags;
-		Request.Status = EInRequestStatus::Waiting;
-		Request.Owner = Owner;
-		Request.UniqueID = NextUniqueID++;
-		Request.Index = RequestIndex;
-		check(Request.Next == IntervalTreeInvalidIndex);
-		Owner->OffsetAndPakIndex = Request.OffsetAndPakIndex;
-		Owner->UniqueID = Request.UniqueID;
-		Owner->InRequestIndex = RequestIndex;
-		check(!OutstandingRequests.Contains(Request.UniqueID));
-		OutstandingRequests.Add(Request.UniqueID, RequestIndex);
-		RequestCounter.Increment();
+		TIntervalTreeIndex RequestIndex = NewRequest(Owner, PakIndex, Offset, Size, PriorityAndFlags);
 
 		if (AddRequest(RequestIndex))
 		{
 #if USE_PAK_PRECACHE && CSV_PROFILER
 			FPlatformAtomics::InterlockedIncrement(&GPreCacheHotBlocksCount);
 #endif
-			UE_LOG(LogPakFile, Verbose, TEXT("FPakReadRequest[%016llX, %016llX) QueueRequest HOT"), RequestOffsetAndPakIndex, RequestOffsetAndPakIndex + Request.Size);
+			UE_LOG(LogPakFile, Verbose, TEXT("FPakReadRequest[%016llX, %016llX) QueueRequest HOT"), RequestOffsetAndPakIndex, RequestOffsetAndPakIndex + Size);
 		}
 		else
 		{
 #if USE_PAK_PRECACHE && CSV_PROFILER
 			FPlatformAtomics::InterlockedIncrement(&GPreCacheColdBlocksCount);
 #endif
-			UE_LOG(LogPakFile, Verbose, TEXT("FPakReadRequest[%016llX, %016llX) QueueRequest COLD"), RequestOffsetAndPakIndex, RequestOffsetAndPakIndex + Request.Size);
+			UE_LOG(LogPakFile, Verbose, TEXT("FPakReadRequest[%016llX, %016llX) QueueRequest COLD"), RequestOffsetAndPakIndex, RequestOffsetAndPakIndex + Size);
+		}
+
+		if (bRecordingLoadOrder)
+		{
+			RecordLoadOrder(PakIndex, Offset, Size);
+		}
+		if (LoadOrder.Num())
+		{
+			AdvanceLoadOrder(PakIndex, Offset);
 		}
 
 		TrimCache();
@@ -2691,6 +2932,13 @@ public:
 			if( It->Key->GetFilenameName() == PakFile )
 			{
 				uint16 PakIndex = It->Value;
+				for (int32 Index = LoadOrderRequests.Num() - 1; Index >= 0; Index--)
+				{
+					if (GetRequestPakIndex(LoadOrderRequests[Index]->OffsetAndPakIndex) == PakIndex)
+					{
+						ReleaseLoadOrderRequest(Index);
+					}
+				}
 				TrimCache(true);
 				FPakData& Pak = CachedPakData[PakIndex];
 				int64 Offset = MakeJoinedRequest(PakIndex, 0);
@@ -2820,6 +3068,83 @@ public:
 	}
 
 
+	void StartRecordingLoadOrder()
+	{
+		FScopeLock Lock(&CachedFilesScopeLock);
+		RecordedLoadOrder.Reset();
+		RecordedLoadOrderBlocks.Reset();
+		bRecordingLoadOrder = true;
+	}
+
+	/** Stops recording and saves what was recorded, in the format StartLoadOrderReplay reads */
+	bool SaveLoadOrder(const FString& Filename)
+	{
+		FScopeLock Lock(&CachedFilesScopeLock);
+		bRecordingLoadOrder = false;
+		if (!SavePakLoadOrder(*LowerLevel, Filename, RecordedLoadOrder))
+		{
+			UE_LOG(LogPakFile, Error, TEXT("Failed to save the pak load order to %s."), *Filename);
+			return false;
+		}
+		int64 TotalSize = 0;
+		for (const FPakLoadOrderEntry& Entry : RecordedLoadOrder)
+		{
+			TotalSize += Entry.Size;
+		}
+		UE_LOG(LogPakFile, Display, TEXT("Saved a pak load order of %d ranges totalling %lldMB to %s."), RecordedLoadOrder.Num(), TotalSize / 1024 / 1024, *Filename);
+		return true;
+	}
+
+	/** Reads ahead of the loader in the order of a load order saved by SaveLoadOrder, keeping up to pakcache.LoadOrderBudgetMB of it in the cache */
+	bool StartLoadOrderReplay(const FString& Filename)
+	{
+		TArray<FPakLoadOrderEntry> NewLoadOrder;
+		if (!LoadPakLoadOrder(*LowerLevel, Filename, NewLoadOrder))
+		{
+			UE_LOG(LogPakFile, Error, TEXT("Failed to load a pak load order from %s."), *Filename);
+			return false;
+		}
+
+		FScopeLock Lock(&CachedFilesScopeLock);
+		StopLoadOrderReplay();
+		LoadOrder = MoveTemp(NewLoadOrder);
+		for (int32 EntryIndex = 0; EntryIndex < LoadOrder.Num(); EntryIndex++)
+		{
+			const FPakLoadOrderEntry& Entry = LoadOrder[EntryIndex];
+			TMap<int64, int32>& EntryForBlock = LoadOrderEntryForBlock.FindOrAdd(Entry.PakFile);
+			for (int64 Block = Entry.Offset / PAK_CACHE_GRANULARITY; Block <= (Entry.Offset + Entry.Size - 1) / PAK_CACHE_GRANULARITY; Block++)
+			{
+				if (!EntryForBlock.Contains(Block))
+				{
+					EntryForBlock.Add(Block, EntryIndex);
+				}
+			}
+		}
+		UE_LOG(LogPakFile, Display, TEXT("Replaying a pak load order of %d ranges from %s."), LoadOrder.Num(), *Filename);
+		RequestLoadOrder();
+		return true;
+	}
+
+	void StopLoadOrderReplay()
+	{
+		FScopeLock Lock(&CachedFilesScopeLock);
+		while (LoadOrderRequests.Num())
+		{
+			ReleaseLoadOrderRequest(LoadOrderRequests.Num() - 1);
+		}
+		check(LoadOrderBytesRequested == 0);
+		LoadOrder.Empty();
+		LoadOrderEntryForBlock.Empty();
+		NextLoadOrderEntry = 0;
+	}
+
+	/** Discards the blocks nothing is using, so the next reads come from the lower level */
+	void DiscardCache()
+	{
+		FScopeLock Lock(&CachedFilesScopeLock);
+		TrimCache(true);
+	}
+
 	// these are not threadsafe and should only be used for synthetic testing
 	uint64 GetLoadSize()
 	{
@@ -2894,6 +3219,62 @@ static FAutoConsoleCommand DumpBlocksCmd(
 	FConsoleCommandWithArgsDelegate::CreateStatic(&DumpBlocks)
 );
 
+static void RecordLoadOrder(const TArray<FString>& Args)
+{
+	FPakPrecacher::Get().StartRecordingLoadOrder();
+}
+
+static FAutoConsoleCommand RecordLoadOrderCmd(
+	TEXT("pak.RecordLoadOrder"),
+	TEXT("Starts recording the order pak files are read in, for pak.SaveLoadOrder. -RecordPakLoadOrder=<file> records from startup and saves at exit."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RecordLoadOrder)
+);
+
+static void SaveLoadOrder(const TArray<FString>& Args)
+{
+	if (Args.Num() != 1)
+	{
+		UE_LOG(LogPakFile, Error, TEXT("Usage: pak.SaveLoadOrder <file>"));
+		return;
+	}
+	FPakPrecacher::Get().SaveLoadOrder(Args[0]);
+}
+
+static FAutoConsoleCommand SaveLoadOrderCmd(
+	TEXT("pak.SaveLoadOrder"),
+	TEXT("Stops recording the order pak files are read in and saves it to a file for pak.ReplayLoadOrder."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&SaveLoadOrder)
+);
+
+static void ReplayLoadOrder(const TArray<FString>& Args)
+{
+	if (Args.Num())
+	{
+		FPakPrecacher::Get().StartLoadOrderReplay(Args[0]);
+	}
+	else
+	{
+		FPakPrecacher::Get().StopLoadOrderReplay();
+	}
+}
+
+static FAutoConsoleCommand ReplayLoadOrderCmd(
+	TEXT("pak.ReplayLoadOrder"),
+	TEXT("Reads pak files ahead of the loader in the order saved by pak.SaveLoadOrder, or stops doing so without a file. -ReplayPakLoadOrder=<file> replays from startup."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ReplayLoadOrder)
+);
+
+static void DiscardCache(const TArray<FString>& Args)
+{
+	FPakPrecacher::Get().DiscardCache();
+}
+
+static FAutoConsoleCommand DiscardCacheCmd(
+	TEXT("pak.DiscardCache"),
+	TEXT("Debug command to discard the pak cache blocks that are not in use."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&DiscardCache)
+);
+
 static FCriticalSection FPakReadRequestEvent;
 
 class FPakAsyncReadFileHandle;
@@ -4657,6 +5038,10 @@ FPakFile::FPakFile(const TCHAR* Filename, bool bIsSigned)
 	, bAttemptedPakEntryShrink(false)
 	, bAttemptedPakFilenameUnload(false)
  	, MappedFileHandle(nullptr)
+	, LowerLevelPlatformFile(nullptr)
+	, DirectoryIndexOffset(0)
+	, DirectoryIndexSize(0)
+	, bDirectoryIndexLoaded(true)
 	, CacheType(FPakFile::ECacheType::Shared)
 	, CacheIndex(-1)
 	, UnderlyingCacheTrimDisabled(false)
@@ -4687,6 +5072,10 @@ FPakFile::FPakFile(IPlatformFile* LowerLevel, const TCHAR* Filename, bool bIsSig
 	, bAttemptedPakEntryShrink(false)
 	, bAttemptedPakFilenameUnload(false)
 	, MappedFileHandle(nullptr)
+	, LowerLevelPlatformFile(LowerLevel)
+	, DirectoryIndexOffset(0)
+	, DirectoryIndexSize(0)
+	, bDirectoryIndexLoaded(true)
 	, CacheType(FPakFile::ECacheType::Shared)
 	, CacheIndex(-1)
 	, UnderlyingCacheTrimDisabled(false)
@@ -4712,6 +5101,10 @@ FPakFile::FPakFile(FArchive* Archive)
 	, bFilenamesRemoved(false)
 	, ChunkID(INDEX_NONE)
 	, MappedFileHandle(nullptr)
+	, LowerLevelPlatformFile(nullptr)
+	, DirectoryIndexOffset(0)
+	, DirectoryIndexSize(0)
+	, bDirectoryIndexLoaded(true)
 	, CacheType(FPakFile::ECacheType::Shared)
 	, CacheIndex(-1)
 	, UnderlyingCacheTrimDisabled(false)
@@ -4722,6 +5115,8 @@ FPakFile::FPakFile(FArchive* Archive)
 
 FPakFile::~FPakFile()
 {
+	// The path hash index may be mapped through MappedFileHandle
+	PathHashIndex.Reset();
 	delete MappedFileHandle;
 	delete[] MiniPakEntries;
 	delete[] MiniPakEntriesOffsets;
@@ -4928,6 +5323,13 @@ void FPakFile::LoadIndex(FArchive* Reader)
 		IndexReader << NumEntries;
 
 		MakeDirectoryFromPath(MountPoint);
+
+		if (Info.Version >= FPakInfo::PakFile_Version_PathHashIndex)
+		{
+			LoadPathHashIndex(Reader, IndexReader);
+			return;
+		}
+
 		// Allocate enough memory to hold all entries (and not reallocate while they're being added to it).
 		Files.Empty(NumEntries);
 
@@ -4943,40 +5345,218 @@ void FPakFile::LoadIndex(FArchive* Reader)
 			Files.Add(Entry);
 
 			// Construct Index of all directories in pak file.
-			FString Path = FPaths::GetPath(Filename);
-			MakeDirectoryFromPath(Path);
-			FPakDirectory* Directory = Index.Find(Path);
-			if (Directory != NULL)
+			AddToDirectoryIndex(Index, MountPoint, Filename, EntryIndex);
+		}
+	}
+}
+
+void FPakFile::AddToDirectoryIndex(TMap<FString, FPakDirectory>& InIndex, const FString& InMountPoint, const FString& Filename, int32 EntryIndex)
+{
+	FString Path = FPaths::GetPath(Filename);
+	MakeDirectoryFromPath(Path);
+	FPakDirectory* Directory = InIndex.Find(Path);
+	if (Directory != NULL)
+	{
+		Directory->Add(FPaths::GetCleanFilename(Filename), EntryIndex);
+	}
+	else
+	{
+		FPakDirectory& NewDirectory = InIndex.Add(Path);
+		NewDirectory.Add(FPaths::GetCleanFilename(Filename), EntryIndex);
+
+		// add the parent directories up to the mount point
+		while (InMountPoint != Path)
+		{
+			Path = Path.Left(Path.Len() - 1);
+			int32 Offset = 0;
+			if (Path.FindLastChar('/', Offset))
 			{
-				Directory->Add(FPaths::GetCleanFilename(Filename), EntryIndex);
+				Path = Path.Left(Offset);
+				MakeDirectoryFromPath(Path);
+				if (InIndex.Find(Path) == NULL)
+				{
+					InIndex.Add(Path);
+				}
 			}
 			else
 			{
-				FPakDirectory& NewDirectory = Index.Add(Path);
-				NewDirectory.Add(FPaths::GetCleanFilename(Filename), EntryIndex);
+				Path = InMountPoint;
+			}
+		}
+	}
+}
 
-				// add the parent directories up to the mount point
-				while (MountPoint != Path)
-				{
-					Path = Path.Left(Path.Len() - 1);
-					int32 Offset = 0;
-					if (Path.FindLastChar('/', Offset))
-					{
-						Path = Path.Left(Offset);
-						MakeDirectoryFromPath(Path);
-						if (Index.Find(Path) == NULL)
-						{
-							Index.Add(Path);
-						}
-					}
-					else
-					{
-						Path = MountPoint;
-					}
-				}
+void FPakFile::LoadPathHashIndex(FArchive* Reader, FArchive& IndexReader)
+{
+	uint64 PathHashSeed = 0;
+	int32 NumBuckets = 0;
+	int32 NumDirectories = 0;
+	int64 PathHashIndexOffset = 0;
+	int64 PathHashIndexSize = 0;
+	FSHAHash PathHashIndexHash;
+	IndexReader << PathHashSeed;
+	IndexReader << NumBuckets;
+	IndexReader << NumDirectories;
+	IndexReader << PathHashIndexOffset;
+	IndexReader << PathHashIndexSize;
+	IndexReader << PathHashIndexHash;
+	IndexReader << DirectoryIndexOffset;
+	IndexReader << DirectoryIndexSize;
+	IndexReader << DirectoryIndexHash;
+
+	UE_CLOG(IndexReader.IsError() || !(PathHashIndexOffset >= 0 && PathHashIndexSize >= 0 && PathHashIndexOffset + PathHashIndexSize <= Info.IndexOffset), LogPakFile, Fatal, TEXT("Path hash index for pak file '%s' is invalid (offset %lld, size %lld)"), *PakFilename, PathHashIndexOffset, PathHashIndexSize);
+	UE_CLOG(!(DirectoryIndexOffset >= 0 && DirectoryIndexSize >= 0 && DirectoryIndexOffset + DirectoryIndexSize <= Info.IndexOffset), LogPakFile, Fatal, TEXT("Directory index for pak file '%s' is invalid (offset %lld, size %lld)"), *PakFilename, DirectoryIndexOffset, DirectoryIndexSize);
+	UE_CLOG(!FPakPathHashIndex::IsValidLayout(PathHashIndexSize, NumEntries, NumDirectories, NumBuckets), LogPakFile, Fatal, TEXT("Corrupted path hash index in pak file '%s'."), *PakFilename);
+
+	// Unencrypted path hash indices are used where they lie in the pak file if it can be mapped
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	const uint8* PathHashIndexData = nullptr;
+	if (!Info.bEncryptedIndex && LowerLevelPlatformFile && GMMIO_Enable)
+	{
+		FScopeLock Lock(&MappedFileHandleCriticalSection);
+		if (!MappedFileHandle)
+		{
+			MappedFileHandle = LowerLevelPlatformFile->OpenMapped(*PakFilename);
+		}
+		if (MappedFileHandle)
+		{
+			MappedRegion.Reset(MappedFileHandle->MapRegion(PathHashIndexOffset, PathHashIndexSize));
+			if (MappedRegion.IsValid() && MappedRegion->GetMappedSize() == PathHashIndexSize && IsAligned(MappedRegion->GetMappedPtr(), sizeof(uint64)))
+			{
+				PathHashIndexData = MappedRegion->GetMappedPtr();
 			}
+			else
+			{
+				MappedRegion.Reset();
+			}
+		}
+	}
+	if (!PathHashIndexData)
+	{
+		uint8* ReadData = (uint8*)FMemory::Malloc(FMath::Max<int64>(PathHashIndexSize, 1), sizeof(uint64));
+		Reader->Seek(PathHashIndexOffset);
+		Reader->Serialize(ReadData, PathHashIndexSize);
+		if (Info.bEncryptedIndex)
+		{
+			DecryptData(ReadData, PathHashIndexSize, Info.EncryptionKeyGuid);
 		}
+		PathHashIndexData = ReadData;
 	}
+
+	FSHAHash ComputedHash;
+	FSHA1::HashBuffer(PathHashIndexData, PathHashIndexSize, ComputedHash.Hash);
+	UE_CLOG(PathHashIndexHash != ComputedHash, LogPakFile, Fatal, TEXT("Corrupted path hash index in pak file '%s' (SHA hash mismatch)."), *PakFilename);
+
+	PathHashIndex = MakeUnique<FPakPathHashIndex>(PathHashIndexData, PathHashIndexSize, MoveTemp(MappedRegion), NumEntries, NumDirectories, NumBuckets, PathHashSeed);
+
+	// The entries are bit-encoded already and filenames are only loaded for directory iteration, there is nothing to shrink or unload
+	bAttemptedPakEntryShrink = true;
+	bAttemptedPakFilenameUnload = true;
+
+	if (PakFilename.IsEmpty())
+	{
+		// Pak files created from an archive can't be reopened to load the directory index later
+		LoadDirectoryIndex(Reader);
+	}
+	else
+	{
+		bDirectoryIndexLoaded = false;
+	}
+}
+
+void FPakFile::LoadDirectoryIndex(FArchive* Reader) const
+{
+	LLM_SCOPE(ELLMTag::FileSystem);
+
+	TArray<uint8> DirectoryIndexData;
+	DirectoryIndexData.SetNumUninitialized(DirectoryIndexSize);
+	Reader->Seek(DirectoryIndexOffset);
+	Reader->Serialize(DirectoryIndexData.GetData(), DirectoryIndexSize);
+	if (Info.bEncryptedIndex)
+	{
+		DecryptData(DirectoryIndexData.GetData(), DirectoryIndexSize, Info.EncryptionKeyGuid);
+	}
+
+	FSHAHash ComputedHash;
+	FSHA1::HashBuffer(DirectoryIndexData.GetData(), DirectoryIndexData.Num(), ComputedHash.Hash);
+	UE_CLOG(DirectoryIndexHash != ComputedHash, LogPakFile, Fatal, TEXT("Corrupted directory index in pak file '%s' (SHA hash mismatch)."), *PakFilename);
+
+	FMemoryReader DirectoryIndexReader(DirectoryIndexData);
+	DirectoryIndexReader << Index;
+}
+
+void FPakFile::LoadDirectoryIndexIfNeeded() const
+{
+	if (bDirectoryIndexLoaded)
+	{
+		return;
+	}
+
+	FScopeLock Lock(&DirectoryIndexCriticalSection);
+	if (!bDirectoryIndexLoaded)
+	{
+		UE_LOG(LogPakFile, Log, TEXT("Loading directory index for pak '%s'"), *PakFilename);
+		FArchive* Reader = const_cast<FPakFile*>(this)->GetSharedReader(LowerLevelPlatformFile);
+		UE_CLOG(!Reader, LogPakFile, Fatal, TEXT("Unable to load the directory index of pak file '%s'."), *PakFilename);
+		LoadDirectoryIndex(Reader);
+		bDirectoryIndexLoaded = true;
+	}
+}
+
+bool FPakFile::GetEntry(int32 EntryIndex, FPakEntry* OutEntry) const
+{
+	bool bDeleted = false;
+	const uint8* EncodedEntry = nullptr;
+	if (PathHashIndex)
+	{
+		bDeleted = PathHashIndex->IsDeleteRecord(EntryIndex);
+		EncodedEntry = bDeleted ? nullptr : PathHashIndex->GetEncodedEntry(EntryIndex);
+	}
+	else if (MiniPakEntries != nullptr)
+	{
+		uint32 MemoryOffset = MiniPakEntriesOffsets[EntryIndex];
+		bDeleted = (MemoryOffset == MAX_uint32); // deleted records have a magic number in the offset instead (not ideal, but there is no more space in the bit-encoded entry)
+		EncodedEntry = bDeleted ? nullptr : MiniPakEntries + MemoryOffset;
+	}
+	else
+	{
+		const FPakEntry& Entry = Files[EntryIndex];
+		if (OutEntry != nullptr)
+		{
+			*OutEntry = Entry;
+			OutEntry->Verified = true;		// Set Verified to true to avoid have a synchronous open fail comparing FPakEntry structures.
+		}
+		return !Entry.IsDeleteRecord();
+	}
+
+	if (OutEntry != nullptr)
+	{
+		if (!bDeleted)
+		{
+			// The FPakEntry structures are bit-encoded, so decode it.
+			DecodePakEntry(EncodedEntry, OutEntry);
+		}
+		else
+		{
+			// entry was deleted and original data is inaccessible- build dummy entry
+			(*OutEntry) = FPakEntry();
+			OutEntry->SetDeleteRecord(true);
+			OutEntry->Verified = true;		// Set Verified to true to avoid have a synchronous open fail comparing FPakEntry structures.
+		}
+	}
+	return !bDeleted;
+}
+
+bool FPakFile::DirectoryExists(const TCHAR* InPath) const
+{
+	if (PathHashIndex)
+	{
+		// Directories are hashed too, no need to load the directory index
+		FString Directory(InPath);
+		MakeDirectoryFromPath(Directory);
+		return Directory.StartsWith(MountPoint) && PathHashIndex->HasDirectory(*Directory + MountPoint.Len(), Directory.Len() - MountPoint.Len());
+	}
+	return !!FindDirectory(InPath);
 }
 
 bool FPakFile::Check()
@@ -5017,7 +5597,7 @@ bool FPakFile::Check()
 		const bool bIncludeDeleted = true;
 		for (FPakFile::FFileIterator It(*this, bIncludeDeleted); It; ++It, ++FileCount)
 		{
-			const FPakEntry& Entry = It.Info();
+			FPakEntry Entry = It.Info();
 			if (Entry.IsDeleteRecord())
 			{
 				UE_LOG(LogPakFile, Verbose, TEXT("\"%s\" Deleted."), *It.Filename());
@@ -5029,6 +5609,11 @@ bool FPakFile::Check()
 			uint32 SerializedCrcTest = 0;
 			FPakEntry EntryInfo;
 			EntryInfo.Serialize(PakReader, GetInfo().Version);
+			if (PathHashIndex)
+			{
+				// The path hash index doesn't keep the file hashes, check the data against the one in the file header
+				FMemory::Memcpy(Entry.Hash, EntryInfo.Hash, sizeof(Entry.Hash));
+			}
 			if (EntryInfo != Entry)
 			{
 				UE_LOG(LogPakFile, Error, TEXT("Serialized hash mismatch for \"%s\"."), *It.Filename());
@@ -5307,6 +5892,163 @@ bool FPakFile::UnloadPakEntryFilenames(TMap<uint64, FPakEntry>& CrossPakCollisio
 	return true;
 }
 
+int64 FPakFile::GetEncodedPakEntrySize(const FPakEntry& Entry, const FPakInfo& InInfo)
+{
+	bool bIsOffset32BitSafe = Entry.Offset <= MAX_uint32;
+	bool bIsSize32BitSafe = Entry.Size <= MAX_uint32;
+	bool bIsUncompressedSize32BitSafe = Entry.UncompressedSize <= MAX_uint32;
+	uint32 CompressedBlockAlignment = Entry.IsEncrypted() ? FAES::AESBlockSize : 1;
+	int64 HeaderSize = Entry.GetSerializedSize(InInfo.Version);
+
+	// This data fits into a bitfield (described in EncodePakEntry), and the data has
+	// to fit within a certain range of bits.
+	if (Entry.CompressionMethodIndex >= (1 << 6))
+	{
+		return -1;
+	}
+	if (Entry.CompressionBlocks.Num() >= (1 << 16))
+	{
+		return -1;
+	}
+	if (Entry.CompressionMethodIndex != 0)
+	{
+		if (Entry.CompressionBlockSize != Entry.UncompressedSize && ((Entry.CompressionBlockSize >> 11) > 0x3f))
+		{
+			return -1;
+		}
+		if (Entry.CompressionBlocks.Num() > 0 && ((InInfo.HasRelativeCompressedChunkOffsets() ? 0 : Entry.Offset) + HeaderSize != Entry.CompressionBlocks[0].CompressedStart))
+		{
+			return -1;
+		}
+		if (Entry.CompressionBlocks.Num() == 1)
+		{
+			uint64 Base = InInfo.HasRelativeCompressedChunkOffsets() ? 0 : Entry.Offset;
+			uint64 AlignedBlockSize = Align(Entry.CompressionBlocks[0].CompressedEnd - Entry.CompressionBlocks[0].CompressedStart, CompressedBlockAlignment);
+			if ((Base + HeaderSize + Entry.Size) != (Entry.CompressionBlocks[0].CompressedStart + AlignedBlockSize))
+			{
+				return -1;
+			}
+		}
+		if (Entry.CompressionBlocks.Num() > 1)
+		{
+			for (int i = 1; i < Entry.CompressionBlocks.Num(); ++i)
+			{
+				uint64 PrevBlockSize = Entry.CompressionBlocks[i - 1].CompressedEnd - Entry.CompressionBlocks[i - 1].CompressedStart;
+				PrevBlockSize = Align(PrevBlockSize, CompressedBlockAlignment);
+				if (Entry.CompressionBlocks[i].CompressedStart != (Entry.CompressionBlocks[i - 1].CompressedStart + PrevBlockSize))
+				{
+					return -1;
+				}
+			}
+		}
+	}
+
+	int64 EncodedSize = sizeof(uint32)
+		+ (bIsOffset32BitSafe ? sizeof(uint32) : sizeof(uint64))
+		+ (bIsUncompressedSize32BitSafe ? sizeof(uint32) : sizeof(uint64));
+	if (Entry.CompressionMethodIndex != 0)
+	{
+		EncodedSize += (bIsSize32BitSafe ? sizeof(uint32) : sizeof(uint64));
+		if (Entry.CompressionBlocks.Num() > 1 || (Entry.CompressionBlocks.Num() == 1 && Entry.IsEncrypted()))
+		{
+			EncodedSize += Entry.CompressionBlocks.Num() * sizeof(uint32);
+		}
+	}
+	return EncodedSize;
+}
+
+uint8* FPakFile::EncodePakEntry(uint8* CurrentEntryPtr, const FPakEntry& Entry)
+{
+	// Begin building the compressed memory structure.
+	//
+	// The general data format for a bit-encoded entry is this:
+	//
+	//     uint32 - Flags
+	//                Bit 31 = Offset 32-bit safe?
+	//                Bit 30 = Uncompressed size 32-bit safe?
+	//                Bit 29 = Size 32-bit safe?
+	//                Bits 28-23 = Compression method
+	//                Bit 22 = Encrypted
+	//                Bits 21-6 = Compression blocks count
+	//                Bits 5-0 = Compression block size
+	//     uint32/uint64 - Offset (either 32-bit or 64-bit depending on bIsOffset32BitSafe)
+	//     uint32/uint64 - Uncompressed Size (either 32-bit or 64-bit depending on bIsUncompressedSize32BitSafe)
+	//
+	//   If the CompressionMethod != COMPRESS_None:
+	//     uint32/uint64 - Size (either 32-bit or 64-bit depending on bIsSize32BitSafe)
+	//
+	//     If the Compression blocks count is more than 1, then an array of Compression block sizes follows of:
+	//         uint32    - Number of bytes in this Compression block.
+	//
+	bool bIsOffset32BitSafe = Entry.Offset <= MAX_uint32;
+	bool bIsSize32BitSafe = Entry.Size <= MAX_uint32;
+	bool bIsUncompressedSize32BitSafe = Entry.UncompressedSize <= MAX_uint32;
+
+	// Build the Flags field.
+	*(uint32*)CurrentEntryPtr =
+		(bIsOffset32BitSafe ? (1 << 31) : 0)
+		| (bIsUncompressedSize32BitSafe ? (1 << 30) : 0)
+		| (bIsSize32BitSafe ? (1 << 29) : 0)
+		| (Entry.CompressionMethodIndex << 23)
+		| (Entry.IsEncrypted() ? (1 << 22) : 0)
+		| (Entry.CompressionBlocks.Num() << 6)
+		| (Entry.CompressionBlockSize >> 11)
+		;
+	CurrentEntryPtr += sizeof(uint32);
+
+	// Build the Offset field.
+	if (bIsOffset32BitSafe)
+	{
+		*(uint32*)CurrentEntryPtr = (uint32)Entry.Offset;
+		CurrentEntryPtr += sizeof(uint32);
+	}
+	else
+	{
+		FMemory::Memcpy(CurrentEntryPtr, &Entry.Offset, sizeof(int64));
+		CurrentEntryPtr += sizeof(int64);
+	}
+
+	// Build the Uncompressed Size field.
+	if (bIsUncompressedSize32BitSafe)
+	{
+		*(uint32*)CurrentEntryPtr = (uint32)Entry.UncompressedSize;
+		CurrentEntryPtr += sizeof(uint32);
+	}
+	else
+	{
+		FMemory::Memcpy(CurrentEntryPtr, &Entry.UncompressedSize, sizeof(int64));
+		CurrentEntryPtr += sizeof(int64);
+	}
+
+	// Any additional data is for compressed file data.
+	if (Entry.CompressionMethodIndex != 0)
+	{
+		// Build the Compressed Size field.
+		if (bIsSize32BitSafe)
+		{
+			*(uint32*)CurrentEntryPtr = (uint32)Entry.Size;
+			CurrentEntryPtr += sizeof(uint32);
+		}
+		else
+		{
+			FMemory::Memcpy(CurrentEntryPtr, &Entry.Size, sizeof(int64));
+			CurrentEntryPtr += sizeof(int64);
+		}
+
+		// Build the Compression Blocks array.
+		if (Entry.CompressionBlocks.Num() > 1 || (Entry.CompressionBlocks.Num() == 1 && Entry.IsEncrypted()))
+		{
+			for (int CompressionBlockIndex = 0; CompressionBlockIndex < Entry.CompressionBlocks.Num(); ++CompressionBlockIndex)
+			{
+				*(uint32*)CurrentEntryPtr = Entry.CompressionBlocks[CompressionBlockIndex].CompressedEnd - Entry.CompressionBlocks[CompressionBlockIndex].CompressedStart;
+				CurrentEntryPtr += sizeof(uint32);
+			}
+		}
+	}
+
+	return CurrentEntryPtr;
+}
+
 bool FPakFile::ShrinkPakEntriesMemoryUsage()
 {
 	// If the process has already been done, get out of here.
@@ -5328,80 +6070,13 @@ bool FPakFile::ShrinkPakEntriesMemoryUsage()
 	int32 EntryIndex = 0;
 	for (EntryIndex = 0; EntryIndex < NumEntries; ++EntryIndex)
 	{
-		FPakEntry& Entry = Files[EntryIndex];
-
-		bool bIsOffset32BitSafe = Entry.Offset <= MAX_uint32;
-		bool bIsSize32BitSafe = Entry.Size <= MAX_uint32;
-		bool bIsUncompressedSize32BitSafe = Entry.UncompressedSize <= MAX_uint32;
-		uint32 CompressedBlockAlignment = Entry.IsEncrypted() ? FAES::AESBlockSize : 1;
-		int64 HeaderSize = Entry.GetSerializedSize(Info.Version);
-
-		// This data fits into a bitfield (described below), and the data has
-		// to fit within a certain range of bits.
-		if (Entry.CompressionMethodIndex >= (1 << 6))
-		{
-			bIsPossibleToShrink = false;
-			break;
-		}
-		if (Entry.CompressionBlocks.Num() >= (1 << 16))
+		const int64 EncodedSize = GetEncodedPakEntrySize(Files[EntryIndex], Info);
+		if (EncodedSize < 0)
 		{
 			bIsPossibleToShrink = false;
 			break;
 		}
-		if (Entry.CompressionMethodIndex != 0)
-		{
-			if (Entry.CompressionBlockSize != Entry.UncompressedSize && ((Entry.CompressionBlockSize >> 11) > 0x3f))
-			{
-				bIsPossibleToShrink = false;
-				break;
-			}
-			if (Entry.CompressionBlocks.Num() > 0 && ((Info.HasRelativeCompressedChunkOffsets() ? 0 : Entry.Offset) + HeaderSize != Entry.CompressionBlocks[0].CompressedStart))
-			{
-				bIsPossibleToShrink = false;
-				break;
-			}
-			if (Entry.CompressionBlocks.Num() == 1)
-			{
-				uint64 Base = Info.HasRelativeCompressedChunkOffsets() ? 0 : Entry.Offset;
-				uint64 AlignedBlockSize = Align(Entry.CompressionBlocks[0].CompressedEnd - Entry.CompressionBlocks[0].CompressedStart, CompressedBlockAlignment);
-				if ((Base + HeaderSize + Entry.Size) != (Entry.CompressionBlocks[0].CompressedStart + AlignedBlockSize))
-				{
-					bIsPossibleToShrink = false;
-					break;
-				}
-			}
-			if (Entry.CompressionBlocks.Num() > 1)
-			{
-				for (int i = 1; i < Entry.CompressionBlocks.Num(); ++i)
-				{
-					uint64 PrevBlockSize = Entry.CompressionBlocks[i - 1].CompressedEnd - Entry.CompressionBlocks[i - 1].CompressedStart;
-					PrevBlockSize = Align(PrevBlockSize, CompressedBlockAlignment);
-					if (Entry.CompressionBlocks[i].CompressedStart != (Entry.CompressionBlocks[i - 1].CompressedStart + PrevBlockSize))
-					{
-						bIsPossibleToShrink = false;
-						break;
-					}
-				}
-
-				if (!bIsPossibleToShrink)
-				{
-					break;
-				}
-			}
-		}
-
-		TotalSizeOfCompressedEntries += sizeof(uint32)
-			+ (bIsOffset32BitSafe ? sizeof(uint32) : sizeof(uint64))
-			+ (bIsUncompressedSize32BitSafe ? sizeof(uint32) : sizeof(uint64));
-		if (Entry.CompressionMethodIndex != 0)
-		{
-			TotalSizeOfCompressedEntries +=
-				(bIsSize32BitSafe ? sizeof(uint32) : sizeof(uint64));
-			if (Entry.CompressionBlocks.Num() > 1 || (Entry.CompressionBlocks.Num() == 1 && Entry.IsEncrypted()))
-			{
-				TotalSizeOfCompressedEntries += Entry.CompressionBlocks.Num() * sizeof(uint32);
-			}
-		}
+		TotalSizeOfCompressedEntries += EncodedSize;
 	}
 
 	if (!bIsPossibleToShrink)
@@ -5428,92 +6103,7 @@ bool FPakFile::ShrinkPakEntriesMemoryUsage()
 			MiniPakEntriesOffsets[EntryIndex] = MAX_uint32;
 		}
 
-		// Begin building the compressed memory structure.
-		//
-		// The general data format for a bit-encoded entry is this:
-		//
-		//     uint32 - Flags
-		//                Bit 31 = Offset 32-bit safe?
-		//                Bit 30 = Uncompressed size 32-bit safe?
-		//                Bit 29 = Size 32-bit safe?
-		//                Bits 28-23 = Compression method
-		//                Bit 22 = Encrypted
-		//                Bits 21-6 = Compression blocks count
-		//                Bits 5-0 = Compression block size
-		//     uint32/uint64 - Offset (either 32-bit or 64-bit depending on bIsOffset32BitSafe)
-		//     uint32/uint64 - Uncompressed Size (either 32-bit or 64-bit depending on bIsUncompressedSize32BitSafe)
-		//
-		//   If the CompressionMethod != COMPRESS_None:
-		//     uint32/uint64 - Size (either 32-bit or 64-bit depending on bIsSize32BitSafe)
-		//
-		//     If the Compression blocks count is more than 1, then an array of Compression block sizes follows of:
-		//         uint32    - Number of bytes in this Compression block.
-		//
-		bool bIsOffset32BitSafe = FullEntry->Offset <= MAX_uint32;
-		bool bIsSize32BitSafe = FullEntry->Size <= MAX_uint32;
-		bool bIsUncompressedSize32BitSafe = FullEntry->UncompressedSize <= MAX_uint32;
-
-		// Build the Flags field.
-		*(uint32*)CurrentEntryPtr =
-			(bIsOffset32BitSafe ? (1 << 31) : 0)
-			| (bIsUncompressedSize32BitSafe ? (1 << 30) : 0)
-			| (bIsSize32BitSafe ? (1 << 29) : 0)
-			| (FullEntry->CompressionMethodIndex << 23)
-			| (FullEntry->IsEncrypted() ? (1 << 22) : 0)
-			| (FullEntry->CompressionBlocks.Num() << 6)
-			| (FullEntry->CompressionBlockSize >> 11)
-			;
-		CurrentEntryPtr += sizeof(uint32);
-
-		// Build the Offset field.
-		if (bIsOffset32BitSafe)
-		{
-			*(uint32*)CurrentEntryPtr = (uint32)FullEntry->Offset;
-			CurrentEntryPtr += sizeof(uint32);
-		}
-		else
-		{
-			FMemory::Memcpy(CurrentEntryPtr, &FullEntry->Offset, sizeof(int64));
-			CurrentEntryPtr += sizeof(int64);
-		}
-
-		// Build the Uncompressed Size field.
-		if (bIsUncompressedSize32BitSafe)
-		{
-			*(uint32*)CurrentEntryPtr = (uint32)FullEntry->UncompressedSize;
-			CurrentEntryPtr += sizeof(uint32);
-		}
-		else
-		{
-			FMemory::Memcpy(CurrentEntryPtr, &FullEntry->UncompressedSize, sizeof(int64));
-			CurrentEntryPtr += sizeof(int64);
-		}
-
-		// Any additional data is for compressed file data.
-		if (FullEntry->CompressionMethodIndex != 0)
-		{
-			// Build the Compressed Size field.
-			if (bIsSize32BitSafe)
-			{
-				*(uint32*)CurrentEntryPtr = (uint32)FullEntry->Size;
-				CurrentEntryPtr += sizeof(uint32);
-			}
-			else
-			{
-				FMemory::Memcpy(CurrentEntryPtr, &FullEntry->Size, sizeof(int64));
-				CurrentEntryPtr += sizeof(int64);
-			}
-
-			// Build the Compression Blocks array.
-			if (FullEntry->CompressionBlocks.Num() > 1 || (FullEntry->CompressionBlocks.Num() == 1 && FullEntry->IsEncrypted()))
-			{
-				for (int CompressionBlockIndex = 0; CompressionBlockIndex < FullEntry->CompressionBlocks.Num(); ++CompressionBlockIndex)
-				{
-					*(uint32*)CurrentEntryPtr = FullEntry->CompressionBlocks[CompressionBlockIndex].CompressedEnd - FullEntry->CompressionBlocks[CompressionBlockIndex].CompressedStart;
-					CurrentEntryPtr += sizeof(uint32);
-				}
-			}
-		}
+		CurrentEntryPtr = EncodePakEntry(CurrentEntryPtr, *FullEntry);
 
 #if !UE_BUILD_SHIPPING
 		if (!FullEntry->IsDeleteRecord())
@@ -5539,6 +6129,185 @@ bool FPakFile::ShrinkPakEntriesMemoryUsage()
 	return true;
 }
 
+bool FPakFile::WriteIndex(FArchive& PakAr, FPakInfo& PakInfo, const FString& PakMountPoint, const TArray<FPakIndexEntry>& Entries, TFunction<void(uint8*, int64)> EncryptIndexData)
+{
+	check(!PakInfo.bEncryptedIndex || EncryptIndexData);
+
+	// Each part of the index is hashed before it's encrypted, the same as the index of older pak files
+	auto WriteIndexData = [&PakAr, &PakInfo, &EncryptIndexData](TArray<uint8>& IndexData, int64& OutOffset, int64& OutSize, FSHAHash& OutHash)
+	{
+		if (PakInfo.bEncryptedIndex)
+		{
+			IndexData.AddZeroed(Align(IndexData.Num(), FAES::AESBlockSize) - IndexData.Num());
+		}
+		FSHA1::HashBuffer(IndexData.GetData(), IndexData.Num(), OutHash.Hash);
+		if (PakInfo.bEncryptedIndex)
+		{
+			EncryptIndexData(IndexData.GetData(), IndexData.Num());
+		}
+		OutOffset = PakAr.Tell();
+		OutSize = IndexData.Num();
+		PakAr.Serialize(IndexData.GetData(), IndexData.Num());
+	};
+
+	FString IndexMountPoint = PakMountPoint;
+	int32 NumIndexEntries = Entries.Num();
+
+	// The path hash index needs every entry bit-encoded, with offsets of the encoded entries fitting in 32 bits
+	PakInfo.Version = FPakInfo::PakFile_Version_PathHashIndex;
+	int64 EncodedEntriesSize = 0;
+	for (const FPakIndexEntry& IndexEntry : Entries)
+	{
+		if (!IndexEntry.Entry.IsDeleteRecord())
+		{
+			const int64 EncodedSize = GetEncodedPakEntrySize(IndexEntry.Entry, PakInfo);
+			if (EncodedSize < 0)
+			{
+				EncodedEntriesSize = -1;
+				break;
+			}
+			EncodedEntriesSize += EncodedSize;
+		}
+	}
+
+	if (EncodedEntriesSize < 0 || EncodedEntriesSize >= MAX_uint32)
+	{
+		UE_LOG(LogPakFile, Display, TEXT("Some pak entries can't be bit-encoded, writing an index without path hashes."));
+
+		PakInfo.Version = FPakInfo::PakFile_Version_FNameBasedCompressionMethod;
+		TArray<uint8> IndexData;
+		FMemoryWriter IndexWriter(IndexData);
+		IndexWriter << IndexMountPoint;
+		IndexWriter << NumIndexEntries;
+		for (const FPakIndexEntry& IndexEntry : Entries)
+		{
+			FString Filename = IndexEntry.Filename;
+			FPakEntry Entry = IndexEntry.Entry;
+			IndexWriter << Filename;
+			Entry.Serialize(IndexWriter, PakInfo.Version);
+		}
+		WriteIndexData(IndexData, PakInfo.IndexOffset, PakInfo.IndexSize, PakInfo.IndexHash);
+		PakInfo.Serialize(PakAr, PakInfo.Version);
+		return !PakAr.IsError();
+	}
+
+	// Find a seed for which no two paths have the same hash and the perfect hash can be built
+	TArray<uint64> PathHashes;
+	TArray<uint32> Displacements;
+	TArray<uint32> Slots;
+	TSet<uint64> UniquePathHashes;
+	uint64 PathHashSeed = 0;
+	bool bBuilt = false;
+	const int32 MaxSeeds = 16;
+	for (int32 SeedIndex = 0; SeedIndex < MaxSeeds && !bBuilt; ++SeedIndex)
+	{
+		PathHashSeed = SeedIndex;
+		PathHashes.Reset();
+		UniquePathHashes.Reset();
+		for (const FPakIndexEntry& IndexEntry : Entries)
+		{
+			const uint64 PathHash = PakPathHashIndex::HashPath(*IndexEntry.Filename, IndexEntry.Filename.Len(), PathHashSeed);
+			bool bAlreadyInSet = false;
+			UniquePathHashes.Add(PathHash, &bAlreadyInSet);
+			if (bAlreadyInSet)
+			{
+				UE_LOG(LogPakFile, Verbose, TEXT("Path hash collision for %s with seed %llu"), *IndexEntry.Filename, PathHashSeed);
+				break;
+			}
+			PathHashes.Add(PathHash);
+		}
+		bBuilt = PathHashes.Num() == NumIndexEntries && PakPathHashIndex::Build(PathHashes, Displacements, Slots);
+	}
+	if (!bBuilt)
+	{
+		UE_LOG(LogPakFile, Error, TEXT("Unable to build a path hash index for %d files, are there duplicate filenames?"), NumIndexEntries);
+		return false;
+	}
+
+	// The directory index refers to entries by their slot
+	TMap<FString, FPakDirectory> DirectoryIndex;
+	TArray<int32> SlotEntries;
+	SlotEntries.SetNumUninitialized(NumIndexEntries);
+	for (int32 EntryIndex = 0; EntryIndex < NumIndexEntries; ++EntryIndex)
+	{
+		AddToDirectoryIndex(DirectoryIndex, IndexMountPoint, Entries[EntryIndex].Filename, Slots[EntryIndex]);
+		SlotEntries[Slots[EntryIndex]] = EntryIndex;
+	}
+	TArray<uint64> DirectoryHashes;
+	DirectoryHashes.Reserve(DirectoryIndex.Num());
+	for (const TMap<FString, FPakDirectory>::ElementType& DirectoryElement : DirectoryIndex)
+	{
+		DirectoryHashes.Add(PakPathHashIndex::HashPath(*DirectoryElement.Key, DirectoryElement.Key.Len(), PathHashSeed));
+	}
+	DirectoryHashes.Sort();
+
+	int32 NumDirectories = DirectoryHashes.Num();
+	int32 NumBuckets = (int32)PakPathHashIndex::GetNumBuckets(NumIndexEntries);
+	const FPakPathHashIndex::FLayout Layout(NumIndexEntries, NumDirectories, NumBuckets);
+	TArray<uint8> PathHashIndexData;
+	PathHashIndexData.SetNumZeroed(Layout.EncodedEntriesOffset + EncodedEntriesSize);
+	uint8* SectionPtr = PathHashIndexData.GetData();
+	uint64* SlotPathHashes = (uint64*)(SectionPtr + Layout.PathHashesOffset);
+	uint32* EntryOffsets = (uint32*)(SectionPtr + Layout.EntryOffsetsOffset);
+	uint8* const EncodedEntries = SectionPtr + Layout.EncodedEntriesOffset;
+	FMemory::Memcpy(SectionPtr + Layout.DirectoryHashesOffset, DirectoryHashes.GetData(), NumDirectories * sizeof(uint64));
+	FMemory::Memcpy(SectionPtr + Layout.DisplacementsOffset, Displacements.GetData(), NumBuckets * sizeof(uint32));
+	uint8* CurrentEntryPtr = EncodedEntries;
+	for (int32 Slot = 0; Slot < NumIndexEntries; ++Slot)
+	{
+		const int32 EntryIndex = SlotEntries[Slot];
+		const FPakEntry& Entry = Entries[EntryIndex].Entry;
+		SlotPathHashes[Slot] = PathHashes[EntryIndex];
+		if (Entry.IsDeleteRecord())
+		{
+			EntryOffsets[Slot] = MAX_uint32;
+		}
+		else
+		{
+			EntryOffsets[Slot] = CurrentEntryPtr - EncodedEntries;
+			CurrentEntryPtr = EncodePakEntry(CurrentEntryPtr, Entry);
+		}
+	}
+	check(CurrentEntryPtr == EncodedEntries + EncodedEntriesSize);
+
+	TArray<uint8> DirectoryIndexData;
+	FMemoryWriter DirectoryIndexWriter(DirectoryIndexData);
+	DirectoryIndexWriter << DirectoryIndex;
+
+	// The path hash index is used in place when the pak file is mapped, so it has to start 8 byte aligned
+	while (PakAr.Tell() % sizeof(uint64) != 0)
+	{
+		uint8 Padding = 0;
+		PakAr << Padding;
+	}
+	int64 PathHashIndexOffset = 0;
+	int64 PathHashIndexSize = 0;
+	FSHAHash PathHashIndexHash;
+	WriteIndexData(PathHashIndexData, PathHashIndexOffset, PathHashIndexSize, PathHashIndexHash);
+	int64 DirectoryOffset = 0;
+	int64 DirectorySize = 0;
+	FSHAHash DirectoryHash;
+	WriteIndexData(DirectoryIndexData, DirectoryOffset, DirectorySize, DirectoryHash);
+
+	TArray<uint8> IndexData;
+	FMemoryWriter IndexWriter(IndexData);
+	IndexWriter << IndexMountPoint;
+	IndexWriter << NumIndexEntries;
+	IndexWriter << PathHashSeed;
+	IndexWriter << NumBuckets;
+	IndexWriter << NumDirectories;
+	IndexWriter << PathHashIndexOffset;
+	IndexWriter << PathHashIndexSize;
+	IndexWriter << PathHashIndexHash;
+	IndexWriter << DirectoryOffset;
+	IndexWriter << DirectorySize;
+	IndexWriter << DirectoryHash;
+	WriteIndexData(IndexData, PakInfo.IndexOffset, PakInfo.IndexSize, PakInfo.IndexHash);
+
+	PakInfo.Serialize(PakAr, PakInfo.Version);
+	return !PakAr.IsError();
+}
+
 #if DO_CHECK
 /**
 * FThreadCheckingArchiveProxy - checks that inner archive is only used from the specified thread ID
@@ -5589,6 +6358,7 @@ public:
 
 void FPakFile::GetFilenames(TArray<FString>& OutFileList) const
 {
+	LoadDirectoryIndexIfNeeded();
 	for (const TMap<FString, FPakDirectory>::ElementType& DirectoryElement : Index)
 	{
 		const  FPakDirectory& Directory = DirectoryElement.Value;
@@ -5608,17 +6378,24 @@ void FPakFile::GetFilenamesInChunk(const TArray<int32>& InChunkIDs, TArray<FStri
 	{
 		int32 ChunkStart = LocalChunkID * FPakInfo::MaxChunkDataSize;
 		int32 ChunkEnd = ChunkStart + FPakInfo::MaxChunkDataSize;
-		int32 FileIndex = 0;
+		// Path hash index entries are in hash order rather than in file order
+		const bool bEntriesInFileOrder = !PathHashIndex.IsValid();
+		FPakEntry File;
 
-		for (const FPakEntry& File : Files)
+		for (int32 FileIndex = 0; FileIndex < NumEntries; FileIndex++)
 		{
+			GetEntry(FileIndex, &File);
 			int32 FileStart = File.Offset;
 			int32 FileEnd = File.Offset + File.Size;
 
 			// If this file is past the end of the target chunk, we're done
 			if (FileStart > ChunkEnd)
 			{
-				break;
+				if (bEntriesInFileOrder)
+				{
+					break;
+				}
+				continue;
 			}
 
 
@@ -5626,11 +6403,10 @@ void FPakFile::GetFilenamesInChunk(const TArray<int32>& InChunkIDs, TArray<FStri
 			{
 				OverlappingEntries.Add(FileIndex);
 			}
-
-			FileIndex++;
 		}
 	}
 
+	LoadDirectoryIndexIfNeeded();
 	int32 Remaining = OverlappingEntries.Num();
 	for (const TMap<FString, FPakDirectory>::ElementType& DirectoryElement : Index)
 	{
@@ -5699,6 +6475,17 @@ FPakFile::EFindResult FPakFile::Find(const FString& Filename, FPakEntry* OutEntr
 	QUICK_SCOPE_CYCLE_COUNTER(PakFileFind);
 	if (Filename.StartsWith(MountPoint))
 	{
+		if (PathHashIndex)
+		{
+			// Hash the path relative to the mount point in place, no need to split it into directory and filename
+			const int32 FoundEntryIndex = PathHashIndex->FindEntry(*Filename + MountPoint.Len(), Filename.Len() - MountPoint.Len());
+			if (FoundEntryIndex != INDEX_NONE)
+			{
+				return GetEntry(FoundEntryIndex, OutEntry) ? EFindResult::Found : EFindResult::FoundDeleted;
+			}
+			return EFindResult::NotFound;
+		}
+
 		FString Path(FPaths::GetPath(Filename));
 
 		// Handle the case where the user called FPakFile::UnloadFilenames() and the filenames
@@ -6827,7 +7614,7 @@ void FPakPlatformFile::MakeUniquePakFilesForTheseFiles(TArray<TArray<FString>> I
 					// we successfully mounted the file, find the empty pak file we just added.
 					for (int j = 0; j < PakFiles.Num(); j++)
 					{
-						if (PakFiles[j].PakFile->Files.Num() == 0 && PakFiles[j].PakFile->CachedTotalSize == PakFile->CachedTotalSize)
+						if (PakFiles[j].PakFile->Files.Num() == 0 && !PakFiles[j].PakFile->PathHashIndex.IsValid() && PakFiles[j].PakFile->CachedTotalSize == PakFile->CachedTotalSize)
 						{
 							NewPakFile = PakFiles[j].PakFile;
 							break;
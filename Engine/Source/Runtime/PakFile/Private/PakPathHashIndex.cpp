@@ -0,0 +1,126 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakPathHashIndex.h"
+#include "Async/MappedFileHandle.h"
+#include "Containers/BitArray.h"
+#include "Containers/ArrayView.h"
+#include "Algo/BinarySearch.h"
+
+bool PakPathHashIndex::Build(const TArray<uint64>& PathHashes, TArray<uint32>& OutDisplacements, TArray<uint32>& OutSlots)
+{
+	const int32 NumEntries = PathHashes.Num();
+	const uint32 NumBuckets = GetNumBuckets(NumEntries);
+
+	// Group the entries by bucket
+	TArray<uint32> BucketStarts;
+	BucketStarts.SetNumZeroed(NumBuckets + 1);
+	for (uint64 PathHash : PathHashes)
+	{
+		++BucketStarts[GetBucket(PathHash, NumBuckets) + 1];
+	}
+	for (uint32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		BucketStarts[Bucket + 1] += BucketStarts[Bucket];
+	}
+	TArray<int32> BucketEntries;
+	BucketEntries.SetNumUninitialized(NumEntries);
+	{
+		TArray<uint32> BucketEnds(BucketStarts.GetData(), NumBuckets);
+		for (int32 EntryIndex = 0; EntryIndex < NumEntries; ++EntryIndex)
+		{
+			BucketEntries[BucketEnds[GetBucket(PathHashes[EntryIndex], NumBuckets)]++] = EntryIndex;
+		}
+	}
+
+	// Place the biggest buckets first while there are plenty of free slots
+	TArray<uint32> BucketOrder;
+	BucketOrder.Reserve(NumBuckets);
+	for (uint32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		if (BucketStarts[Bucket + 1] > BucketStarts[Bucket])
+		{
+			BucketOrder.Add(Bucket);
+		}
+	}
+	BucketOrder.StableSort([&BucketStarts](uint32 A, uint32 B)
+	{
+		return BucketStarts[A + 1] - BucketStarts[A] > BucketStarts[B + 1] - BucketStarts[B];
+	});
+
+	OutDisplacements.Reset();
+	OutDisplacements.AddZeroed(NumBuckets);
+	OutSlots.Reset();
+	OutSlots.AddUninitialized(NumEntries);
+	TBitArray<> UsedSlots(false, NumEntries);
+	TArray<uint32, TInlineAllocator<16>> BucketSlots;
+
+	// The last buckets need about NumEntries / NumFreeSlots attempts each
+	const uint32 MaxDisplacement = FMath::Max<uint32>(NumEntries * 16, 1 << 16);
+	for (uint32 Bucket : BucketOrder)
+	{
+		bool bPlaced = false;
+		for (uint32 Displacement = 0; Displacement < MaxDisplacement && !bPlaced; ++Displacement)
+		{
+			BucketSlots.Reset();
+			bPlaced = true;
+			for (uint32 Index = BucketStarts[Bucket]; Index < BucketStarts[Bucket + 1]; ++Index)
+			{
+				const uint32 Slot = GetSlot(PathHashes[BucketEntries[Index]], Displacement, NumEntries);
+				if (UsedSlots[Slot] || BucketSlots.Contains(Slot))
+				{
+					bPlaced = false;
+					break;
+				}
+				BucketSlots.Add(Slot);
+			}
+			if (bPlaced)
+			{
+				OutDisplacements[Bucket] = Displacement;
+				for (uint32 Index = BucketStarts[Bucket]; Index < BucketStarts[Bucket + 1]; ++Index)
+				{
+					const uint32 Slot = BucketSlots[Index - BucketStarts[Bucket]];
+					UsedSlots[Slot] = true;
+					OutSlots[BucketEntries[Index]] = Slot;
+				}
+			}
+		}
+		if (!bPlaced)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FPakPathHashIndex::FPakPathHashIndex(const uint8* InData, int64 InDataSize, TUniquePtr<IMappedFileRegion>&& InMappedRegion, int32 InNumEntries, int32 InNumDirectories, int32 InNumBuckets, uint64 InPathHashSeed)
+	: Data(InData)
+	, DataSize(InDataSize)
+	, MappedRegion(MoveTemp(InMappedRegion))
+	, PathHashSeed(InPathHashSeed)
+	, NumEntries(InNumEntries)
+	, NumDirectories(InNumDirectories)
+	, NumBuckets(InNumBuckets)
+{
+	check(IsAligned(Data, sizeof(uint64)) && IsValidLayout(DataSize, NumEntries, NumDirectories, NumBuckets));
+	const FLayout Layout(NumEntries, NumDirectories, NumBuckets);
+	PathHashes = (const uint64*)(Data + Layout.PathHashesOffset);
+	DirectoryHashes = (const uint64*)(Data + Layout.DirectoryHashesOffset);
+	Displacements = (const uint32*)(Data + Layout.DisplacementsOffset);
+	EntryOffsets = (const uint32*)(Data + Layout.EntryOffsetsOffset);
+	EncodedEntries = Data + Layout.EncodedEntriesOffset;
+}
+
+FPakPathHashIndex::~FPakPathHashIndex()
+{
+	if (!MappedRegion.IsValid())
+	{
+		FMemory::Free(const_cast<uint8*>(Data));
+	}
+}
+
+bool FPakPathHashIndex::HasDirectory(const TCHAR* RelativePath, int32 Len) const
+{
+	const uint64 DirectoryHash = PakPathHashIndex::HashPath(RelativePath, Len, PathHashSeed);
+	TArrayView<const uint64> SortedDirectoryHashes(DirectoryHashes, NumDirectories);
+	return Algo::BinarySearch(SortedDirectoryHashes, DirectoryHash) != INDEX_NONE;
+}
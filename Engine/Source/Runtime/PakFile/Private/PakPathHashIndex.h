@@ -0,0 +1,170 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+
+class IMappedFileRegion;
+
+/**
+ * Path hash index of pak files with version PakFile_Version_PathHashIndex or later.
+ *
+ * Instead of filenames the index stores a 64 bit hash of each path relative to the mount point, together with a minimal
+ * perfect hash of those path hashes and the bit-encoded pak entries (see FPakFile::DecodePakEntry). Entries are stored in
+ * the order of their perfect hash slot so finding a file is a hash, a displacement lookup and a compare, and the whole
+ * index can be queried where it lies in memory, including straight from a memory mapped pak file.
+ *
+ * The layout of the path hash index section of a pak file, all arrays are 8 byte aligned:
+ *	uint64 PathHashes[NumEntries]			path hash of each entry
+ *	uint64 DirectoryHashes[NumDirectories]	sorted path hashes of the directories in the directory index
+ *	uint32 Displacements[NumBuckets]		perfect hash displacement of each bucket
+ *	uint32 EntryOffsets[NumEntries]			offset of each encoded entry, MAX_uint32 for delete records
+ *	uint8 EncodedEntries[]
+ *
+ * The directory index, which has the filenames, is stored in a separate section and only loaded for directory iteration.
+ */
+namespace PakPathHashIndex
+{
+	/** Hashes a path relative to the mount point, case insensitive. Directories end with a '/'. */
+	inline uint64 HashPath(const TCHAR* Path, int32 Len, uint64 Seed)
+	{
+		// FNV-1a over the lower case UTF-16 code units, the same on all platforms regardless of the size of TCHAR
+		static const uint64 Offset = 0xcbf29ce484222325;
+		static const uint64 Prime = 0x00000100000001b3;
+		uint64 Hash = Offset ^ Seed;
+		for (int32 Index = 0; Index < Len; ++Index)
+		{
+			const uint16 Char = (uint16)FChar::ToLower(Path[Index]);
+			Hash = (Hash ^ (Char & 0xff)) * Prime;
+			Hash = (Hash ^ (Char >> 8)) * Prime;
+		}
+		return Hash;
+	}
+
+	FORCEINLINE uint64 Mix(uint64 Value)
+	{
+		Value ^= Value >> 33;
+		Value *= 0xff51afd7ed558ccd;
+		Value ^= Value >> 33;
+		Value *= 0xc4ceb9fe1a85ec53;
+		Value ^= Value >> 33;
+		return Value;
+	}
+
+	FORCEINLINE uint32 GetBucket(uint64 PathHash, uint32 NumBuckets)
+	{
+		return (uint32)((Mix(PathHash) >> 32) % NumBuckets);
+	}
+
+	FORCEINLINE uint32 GetSlot(uint64 PathHash, uint32 Displacement, uint32 NumSlots)
+	{
+		return (uint32)(Mix(PathHash + ((uint64)Displacement + 1) * 0x9e3779b97f4a7c15) % NumSlots);
+	}
+
+	/**
+	 * Builds a minimal perfect hash of PathHashes, which must be unique.
+	 *
+	 * @param OutDisplacements	Displacement of each bucket
+	 * @param OutSlots			Slot of each path hash
+	 * @return false if no displacements were found within a reasonable amount of time, try again with different hashes
+	 */
+	bool Build(const TArray<uint64>& PathHashes, TArray<uint32>& OutDisplacements, TArray<uint32>& OutSlots);
+
+	/** Number of buckets used for a number of entries, four entries per bucket on average */
+	FORCEINLINE uint32 GetNumBuckets(int32 NumEntries)
+	{
+		return FMath::Max<uint32>((NumEntries + 3) / 4, 1);
+	}
+}
+
+/** Path hash index of a mounted pak, see PakPathHashIndex */
+class FPakPathHashIndex
+{
+public:
+
+	/** Where the arrays start in the section, also validates the header values against the size of the section */
+	struct FLayout
+	{
+		int64 PathHashesOffset;
+		int64 DirectoryHashesOffset;
+		int64 DisplacementsOffset;
+		int64 EntryOffsetsOffset;
+		int64 EncodedEntriesOffset;
+
+		FLayout(int32 NumEntries, int32 NumDirectories, int32 NumBuckets)
+		{
+			PathHashesOffset = 0;
+			DirectoryHashesOffset = PathHashesOffset + NumEntries * sizeof(uint64);
+			DisplacementsOffset = DirectoryHashesOffset + NumDirectories * sizeof(uint64);
+			EntryOffsetsOffset = Align(DisplacementsOffset + NumBuckets * sizeof(uint32), sizeof(uint64));
+			EncodedEntriesOffset = Align(EntryOffsetsOffset + NumEntries * sizeof(uint32), sizeof(uint64));
+		}
+	};
+
+	/**
+	 * @param InData		The path hash index section, 8 byte aligned. Either points into InMappedRegion or was allocated with FMemory::Malloc.
+	 * @param InDataSize	Size of the section
+	 */
+	FPakPathHashIndex(const uint8* InData, int64 InDataSize, TUniquePtr<IMappedFileRegion>&& InMappedRegion, int32 InNumEntries, int32 InNumDirectories, int32 InNumBuckets, uint64 InPathHashSeed);
+	~FPakPathHashIndex();
+
+	/** Returns false if the header values don't fit the section */
+	static bool IsValidLayout(int64 DataSize, int32 NumEntries, int32 NumDirectories, int32 NumBuckets)
+	{
+		return NumEntries >= 0 && NumDirectories >= 0 && NumBuckets > 0 && FLayout(NumEntries, NumDirectories, NumBuckets).EncodedEntriesOffset <= DataSize;
+	}
+
+	/** Returns the index of the entry of a path relative to the mount point, INDEX_NONE if there is none */
+	FORCEINLINE int32 FindEntry(const TCHAR* RelativePath, int32 Len) const
+	{
+		if (!NumEntries)
+		{
+			return INDEX_NONE;
+		}
+		const uint64 PathHash = PakPathHashIndex::HashPath(RelativePath, Len, PathHashSeed);
+		const uint32 Displacement = Displacements[PakPathHashIndex::GetBucket(PathHash, NumBuckets)];
+		const uint32 Slot = PakPathHashIndex::GetSlot(PathHash, Displacement, NumEntries);
+		return PathHashes[Slot] == PathHash ? (int32)Slot : INDEX_NONE;
+	}
+
+	/** Checks if a directory relative to the mount point, ending with a '/', is in the directory index */
+	bool HasDirectory(const TCHAR* RelativePath, int32 Len) const;
+
+	FORCEINLINE bool IsDeleteRecord(int32 EntryIndex) const
+	{
+		return EntryOffsets[EntryIndex] == MAX_uint32;
+	}
+
+	FORCEINLINE const uint8* GetEncodedEntry(int32 EntryIndex) const
+	{
+		return EncodedEntries + EntryOffsets[EntryIndex];
+	}
+
+	/** True if the index is read from a memory mapped pak file rather than from memory allocated for it */
+	bool IsMapped() const
+	{
+		return MappedRegion.IsValid();
+	}
+
+	/** Bytes allocated for the index, not counting memory mapped data */
+	SIZE_T GetAllocatedSize() const
+	{
+		return sizeof(*this) + (IsMapped() ? 0 : DataSize);
+	}
+
+private:
+
+	const uint8* Data;
+	int64 DataSize;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	uint64 PathHashSeed;
+	int32 NumEntries;
+	int32 NumDirectories;
+	uint32 NumBuckets;
+	const uint64* PathHashes;
+	const uint64* DirectoryHashes;
+	const uint32* Displacements;
+	const uint32* EntryOffsets;
+	const uint8* EncodedEntries;
+};
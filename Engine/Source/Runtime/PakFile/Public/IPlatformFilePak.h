@@ -8,6 +8,7 @@
 #include "Misc/Paths.h"
 #include "Misc/ScopeLock.h"
 #include "Templates/UniquePtr.h"
+#include "Templates/Atomic.h"
 #include "Math/BigInt.h"
 #include "Misc/AES.h"
 #include "RSA.h"
@@ -92,6 +93,7 @@ struct FPakInfo
 		PakFile_Version_DeleteRecords = 6,
 		PakFile_Version_EncryptionKeyGuid = 7,
 		PakFile_Version_FNameBasedCompressionMethod = 8,
+		PakFile_Version_PathHashIndex = 9,
 
 
 		PakFile_Version_Last,
@@ -498,6 +500,15 @@ struct FPakEntry
 /** Pak directory type mapping a filename to a FPakEntry index within the FPakFile.Files array or the MiniPakEntriesOffsets array depending on the bit-encoded state of the FPakEntry structures. */
 typedef TMap<FString, int32> FPakDirectory;
 
+/** A file to write to the index of a pak file, see FPakFile::WriteIndex. */
+struct FPakIndexEntry
+{
+	/** Filename relative to the mount point. */
+	FString Filename;
+	/** Location of the file in the pak, delete records included. */
+	FPakEntry Entry;
+};
+
 /**
  * Pak file.
  */
@@ -520,8 +531,8 @@ class PAKFILE_API FPakFile : FNoncopyable
 	FString MountPoint;
 	/** Info on all files stored in pak. */
 	TArray<FPakEntry> Files;	
-	/** Pak Index organized as a map of directories for faster Directory iteration. Completely valid only when bFilenamesRemoved == false, although portions may still be valid after a call to UnloadPakEntryFilenames() while utilizing DirectoryRootsToKeep. */
-	TMap<FString, FPakDirectory> Index;
+	/** Pak Index organized as a map of directories for faster Directory iteration. Completely valid only when bFilenamesRemoved == false, although portions may still be valid after a call to UnloadPakEntryFilenames() while utilizing DirectoryRootsToKeep. Loaded on first use for paks with a path hash index. */
+	mutable TMap<FString, FPakDirectory> Index;
 	/** The hash to use when generating a filename hash (CRC) to avoid collisions within the hashed filename space. */
 	uint64 FilenameStartHash;
 	/** An array of 256 + 1 size that represents the starting index of the most significant byte of a hash group within the FilenameHashes array. */
@@ -556,6 +567,19 @@ class PAKFILE_API FPakFile : FNoncopyable
 	class IMappedFileHandle* MappedFileHandle;
 	FCriticalSection MappedFileHandleCriticalSection;
 
+	/** Path hash index of pak files with version PakFile_Version_PathHashIndex or later. Files is empty for those and entry indices are path hash index slots. */
+	TUniquePtr<class FPakPathHashIndex> PathHashIndex;
+	/** Platform file the pak was opened with, used to map the path hash index. */
+	IPlatformFile* LowerLevelPlatformFile;
+	/** Location and SHA1 of the directory index of a pak with a path hash index. */
+	int64 DirectoryIndexOffset;
+	int64 DirectoryIndexSize;
+	FSHAHash DirectoryIndexHash;
+	/** True once Index can be used, always true for pak files without a path hash index. */
+	mutable TAtomic<bool> bDirectoryIndexLoaded;
+	/** Critical section for loading the directory index. */
+	mutable FCriticalSection DirectoryIndexCriticalSection;
+
 
 	static inline int32 CDECL CompareFilenameHashes(const void* Left, const void* Right)
 	{
@@ -674,6 +698,7 @@ public:
 	 */
 	const TMap<FString, FPakDirectory>& GetIndex() const
 	{
+		LoadDirectoryIndexIfNeeded();
 		return Index;
 	}
 
@@ -760,6 +785,8 @@ public:
 
 			//checkf(!bFilenamesRemoved, TEXT("FPakFile::FindFilesAtPath() can only be used before FPakPlatformFile::UnloadFilenames() is called."));
 
+			LoadDirectoryIndexIfNeeded();
+
 			TArray<FString> DirectoriesInPak; // List of all unique directories at path
 			for (TMap<FString, FPakDirectory>::TConstIterator It(Index); It; ++It)
 			{
@@ -823,6 +850,7 @@ public:
 		// Check the specified path is under the mount point of this pak file.
 		if (Directory.StartsWith(MountPoint))
 		{
+			LoadDirectoryIndexIfNeeded();
 			PakDirectory = Index.Find(Directory.Mid(MountPoint.Len()));
 		}
 		return PakDirectory;
@@ -834,10 +862,7 @@ public:
 	 * @param InPath Directory path.
 	 * @return true if the given path exists in pak file, false otherwise.
 	 */
-	bool DirectoryExists(const TCHAR* InPath) const
-	{
-		return !!FindDirectory(InPath);
-	}
+	bool DirectoryExists(const TCHAR* InPath) const;
 	
 	/**
 	 * Checks the validity of the pak data by reading out the data for every file in the pak
@@ -857,6 +882,8 @@ public:
 		FPakDirectory::TConstIterator DirectoryIt;
 		/** The cached filename for return in Filename() */
 		FString CachedFilename;
+		/** The decoded entry returned by Info() when the pak doesn't keep an FPakEntry for each file */
+		mutable FPakEntry CachedEntry;
 		/** Whether to include delete records in the iteration */
 		bool bIncludeDeleted;
 
@@ -897,7 +924,15 @@ public:
 		}
 
 		const FString& Filename() const		{ return CachedFilename; }
-		const FPakEntry& Info() const	{ return PakFile.Files[DirectoryIt.Value()]; }
+		const FPakEntry& Info() const
+		{
+			if (PakFile.Files.Num())
+			{
+				return PakFile.Files[DirectoryIt.Value()];
+			}
+			PakFile.GetEntry(DirectoryIt.Value(), &CachedEntry);
+			return CachedEntry;
+		}
 		const int32 GetIndexInPakFile() const { return DirectoryIt.Value(); }
 
 	private:
@@ -997,6 +1032,20 @@ public:
 		return bAttemptedPakEntryShrink;
 	}
 
+	/**
+	 * Writes the index and trailer of a pak file after the file data. Uses a path hash index
+	 * (PakFile_Version_PathHashIndex) unless some entry can't be bit-encoded, in which case the
+	 * index is written in the previous format.
+	 *
+	 * @param PakAr Archive to write to, positioned after the last file.
+	 * @param PakInfo Trailer to write. IndexOffset, IndexSize, IndexHash and Version are filled in.
+	 * @param PakMountPoint Mount point to store in the index.
+	 * @param Entries Files in the pak, filenames relative to the mount point.
+	 * @param EncryptIndexData Encrypts index data in place, required if Info.bEncryptedIndex is set. Sizes are multiples of FAES::AESBlockSize.
+	 * @return false if the index couldn't be written.
+	 */
+	static bool WriteIndex(FArchive& PakAr, FPakInfo& PakInfo, const FString& PakMountPoint, const TArray<FPakIndexEntry>& Entries, TFunction<void(uint8*, int64)> EncryptIndexData = nullptr);
+
 private:
 
 	/**
@@ -1009,6 +1058,52 @@ private:
 	 */
 	void LoadIndex(FArchive* Reader);
 
+	/**
+	 * Loads the path hash index of a pak file, maps it if possible.
+	 *
+	 * @param IndexReader The rest of the primary index, after the mount point and number of entries.
+	 */
+	void LoadPathHashIndex(FArchive* Reader, FArchive& IndexReader);
+
+	/**
+	 * Loads the directory index of a pak file with a path hash index into Index.
+	 */
+	void LoadDirectoryIndex(FArchive* Reader) const;
+
+	/**
+	 * Loads the directory index if the pak has a path hash index and it hasn't been loaded yet.
+	 */
+	void LoadDirectoryIndexIfNeeded() const;
+
+	/**
+	 * Gets an entry from Files, the bit-encoded entries or the path hash index, whichever this pak uses.
+	 *
+	 * @param EntryIndex Index of the entry, as stored in the directory index.
+	 * @param OutEntry The optional address of an FPakEntry instance where the entry should be stored.
+	 * @return false if the entry is a delete record.
+	 */
+	bool GetEntry(int32 EntryIndex, FPakEntry* OutEntry) const;
+
+	/**
+	 * Adds a file to a directory index, along with its parent directories up to the mount point.
+	 */
+	static void AddToDirectoryIndex(TMap<FString, FPakDirectory>& InIndex, const FString& InMountPoint, const FString& Filename, int32 EntryIndex);
+
+	/**
+	 * Gets the size of the bit-encoded form of a pak entry.
+	 *
+	 * @return The size in bytes, -1 if the entry can't be bit-encoded.
+	 */
+	static int64 GetEncodedPakEntrySize(const FPakEntry& Entry, const FPakInfo& InInfo);
+
+	/**
+	 * Bit-encodes a pak entry, see DecodePakEntry.
+	 *
+	 * @param CurrentEntryPtr Where to write the entry, GetEncodedPakEntrySize bytes.
+	 * @return Pointer to the end of the written entry.
+	 */
+	static uint8* EncodePakEntry(uint8* CurrentEntryPtr, const FPakEntry& Entry);
+
 	/**
 	 * Manually add a file to a pak file,
 	 */
@@ -1922,7 +2017,9 @@ public:
 			{
 				for (FPakDirectory::TConstIterator DirectoryIt(*PakDirectory); DirectoryIt; ++DirectoryIt)
 				{
-					if (PakFile->Files[DirectoryIt.Value()].Offset == FileEntry.Offset)
+					FPakEntry DirectoryEntry;
+					PakFile->GetEntry(DirectoryIt.Value(), &DirectoryEntry);
+					if (DirectoryEntry.Offset == FileEntry.Offset)
 					{
 						const FString& RealFilename = DirectoryIt.Key();
 						return Path / RealFilename;
@@ -175,6 +175,11 @@ public:
 		return &Addr;
 	}
 
+	const sockaddr_storage* GetRawAddr() const
+	{
+		return &Addr;
+	}
+
 	/**
 	 * Sets the port number from a host byte order int
 	 *
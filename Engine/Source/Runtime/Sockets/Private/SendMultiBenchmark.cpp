@@ -0,0 +1,272 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace SendMultiBenchmark
+{
+	/** Sockets and settings for one run of the benchmark */
+	struct FBenchmark
+	{
+		ISocketSubsystem* SocketSubsystem = nullptr;
+		FSocket* SendSocket = nullptr;
+		TArray<FSocket*> ReceiveSockets;
+		TArray<TSharedRef<FInternetAddr>> ReceiveAddresses;
+
+		int32 NumPackets = 0;
+		int32 PacketSize = 0;
+		int32 BatchSize = 0;
+		int32 PacketsPerRun = 0;
+
+		TArray<uint8> PacketData;
+		TArray<uint8> ReceiveBuffer;
+
+		~FBenchmark()
+		{
+			if (SendSocket)
+			{
+				SocketSubsystem->DestroySocket(SendSocket);
+			}
+
+			for (FSocket* ReceiveSocket : ReceiveSockets)
+			{
+				SocketSubsystem->DestroySocket(ReceiveSocket);
+			}
+		}
+	};
+
+	/** Results of sending every packet one way */
+	struct FResult
+	{
+		double SendSeconds = 0.0;
+		int64 NumSent = 0;
+		int64 NumReceived = 0;
+	};
+
+	static FSocket* CreateLoopbackSocket(ISocketSubsystem* SocketSubsystem, TSharedPtr<FInternetAddr>* OutAddress=nullptr)
+	{
+		FSocket* Socket = SocketSubsystem->CreateSocket(NAME_DGram, TEXT("SendMultiBenchmark"), FNetworkProtocolTypes::IPv4);
+		if (Socket == nullptr)
+		{
+			return nullptr;
+		}
+
+		TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+		Address->SetLoopbackAddress();
+		Address->SetPort(0);
+
+		int32 NewSize = 0;
+		if (!Socket->Bind(*Address) || !Socket->SetNonBlocking(true))
+		{
+			SocketSubsystem->DestroySocket(Socket);
+			return nullptr;
+		}
+
+		Socket->SetReceiveBufferSize(4 * 1024 * 1024, NewSize);
+		Socket->SetSendBufferSize(4 * 1024 * 1024, NewSize);
+
+		if (OutAddress)
+		{
+			Address->SetPort(Socket->GetPortNo());
+			*OutAddress = Address;
+		}
+
+		return Socket;
+	}
+
+	/** Empties the receive buffers between batches, so a full buffer doesn't drop packets, and counts what arrived */
+	static int64 DrainReceiveSockets(FBenchmark& Benchmark)
+	{
+		int64 NumReceived = 0;
+
+		for (FSocket* ReceiveSocket : Benchmark.ReceiveSockets)
+		{
+			int32 BytesRead = 0;
+			while (ReceiveSocket->Recv(Benchmark.ReceiveBuffer.GetData(), Benchmark.ReceiveBuffer.Num(), BytesRead) && BytesRead > 0)
+			{
+				NumReceived++;
+			}
+		}
+
+		return NumReceived;
+	}
+
+	static const FInternetAddr& GetDestination(const FBenchmark& Benchmark, int32 PacketIdx)
+	{
+		return *Benchmark.ReceiveAddresses[(PacketIdx / Benchmark.PacketsPerRun) % Benchmark.ReceiveAddresses.Num()];
+	}
+
+	static FResult RunSendTo(FBenchmark& Benchmark)
+	{
+		FResult Result;
+
+		for (int32 FirstPacketIdx = 0; FirstPacketIdx < Benchmark.NumPackets; FirstPacketIdx += Benchmark.BatchSize)
+		{
+			const int32 LastPacketIdx = FMath::Min(FirstPacketIdx + Benchmark.BatchSize, Benchmark.NumPackets);
+			const double StartTime = FPlatformTime::Seconds();
+
+			for (int32 PacketIdx = FirstPacketIdx; PacketIdx < LastPacketIdx; PacketIdx++)
+			{
+				int32 BytesSent = 0;
+				if (Benchmark.SendSocket->SendTo(Benchmark.PacketData.GetData(), Benchmark.PacketSize, BytesSent, GetDestination(Benchmark, PacketIdx)))
+				{
+					Result.NumSent++;
+				}
+			}
+
+			Result.SendSeconds += FPlatformTime::Seconds() - StartTime;
+			Result.NumReceived += DrainReceiveSockets(Benchmark);
+		}
+
+		return Result;
+	}
+
+	static FResult RunSendMulti(FBenchmark& Benchmark, FSendMulti& SendMulti)
+	{
+		FResult Result;
+
+		for (int32 FirstPacketIdx = 0; FirstPacketIdx < Benchmark.NumPackets; FirstPacketIdx += Benchmark.BatchSize)
+		{
+			const int32 LastPacketIdx = FMath::Min(FirstPacketIdx + Benchmark.BatchSize, Benchmark.NumPackets);
+			const double StartTime = FPlatformTime::Seconds();
+
+			// Copying the packets into the batch is part of the cost
+			for (int32 PacketIdx = FirstPacketIdx; PacketIdx < LastPacketIdx; PacketIdx++)
+			{
+				SendMulti.AddPacket(Benchmark.PacketData.GetData(), Benchmark.PacketSize, GetDestination(Benchmark, PacketIdx));
+			}
+
+			int32 NumPacketsSent = 0;
+			Benchmark.SendSocket->SendMulti(SendMulti, NumPacketsSent);
+			SendMulti.Reset();
+
+			Result.SendSeconds += FPlatformTime::Seconds() - StartTime;
+			Result.NumSent += NumPacketsSent;
+			Result.NumReceived += DrainReceiveSockets(Benchmark);
+		}
+
+		return Result;
+	}
+
+	static void LogResult(const TCHAR* Method, const FResult& Result, const FResult* Baseline=nullptr)
+	{
+		const double PacketsPerSecond = Result.SendSeconds > 0.0 ? Result.NumSent / Result.SendSeconds : 0.0;
+		const double MicrosecondsPerPacket = Result.NumSent > 0 ? Result.SendSeconds * 1000000.0 / Result.NumSent : 0.0;
+		const double Speedup = (Baseline && Result.SendSeconds > 0.0) ? Baseline->SendSeconds / Result.SendSeconds : 1.0;
+
+		UE_LOG(LogSockets, Display, TEXT("  %-16s %10.0f packets/s, %6.3f us per packet, %.2fx, %lld sent, %lld received"),
+			Method, PacketsPerSecond, MicrosecondsPerPacket, Speedup, Result.NumSent, Result.NumReceived);
+	}
+}
+
+/**
+ * Measures the throughput of sending packets one at a time with FSocket::SendTo, against batching them with FSocket::SendMulti.
+ * Loopback sends are processed synchronously by the sending thread, so its time per packet is the CPU cost of sending one, kernel included.
+ */
+FAutoConsoleCommand SendMultiBenchmarkCmd(TEXT("Sockets.SendMultiBenchmark"),
+											TEXT("Sends packets over loopback one at a time and batched, then logs packets per second and send time per packet for each." \
+												 "\nConsecutive packets go to the same receiver in runs of PacketsPerRun, like a net driver flushing each connection in turn." \
+												 "\nUsage:" \
+												 "\nSockets.SendMultiBenchmark [NumPackets=1000000] [PacketSize=1000] [BatchSize=64] [NumReceivers=8] [PacketsPerRun=2]"),
+FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+{
+	using namespace SendMultiBenchmark;
+
+	FBenchmark Benchmark;
+	Benchmark.NumPackets = 1000000;
+	Benchmark.PacketSize = 1000;
+	Benchmark.BatchSize = 64;
+	Benchmark.PacketsPerRun = 2;
+
+	int32 NumReceivers = 8;
+
+	if (Args.Num() > 0)
+	{
+		LexTryParseString<int32>(Benchmark.NumPackets, *Args[0]);
+	}
+	if (Args.Num() > 1)
+	{
+		LexTryParseString<int32>(Benchmark.PacketSize, *Args[1]);
+	}
+	if (Args.Num() > 2)
+	{
+		LexTryParseString<int32>(Benchmark.BatchSize, *Args[2]);
+	}
+	if (Args.Num() > 3)
+	{
+		LexTryParseString<int32>(NumReceivers, *Args[3]);
+	}
+	if (Args.Num() > 4)
+	{
+		LexTryParseString<int32>(Benchmark.PacketsPerRun, *Args[4]);
+	}
+
+	if (Benchmark.NumPackets <= 0 || Benchmark.PacketSize <= 0 || Benchmark.PacketSize > 65507 || Benchmark.BatchSize <= 0 || NumReceivers <= 0 || Benchmark.PacketsPerRun <= 0)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Sockets.SendMultiBenchmark needs at least one packet, receiver and packet per batch and run, and packets that fit in a datagram"));
+		return;
+	}
+
+	Benchmark.SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (Benchmark.SocketSubsystem == nullptr)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Sockets.SendMultiBenchmark: no socket subsystem"));
+		return;
+	}
+
+	Benchmark.SendSocket = CreateLoopbackSocket(Benchmark.SocketSubsystem);
+
+	for (int32 ReceiverIdx = 0; ReceiverIdx < NumReceivers && Benchmark.SendSocket != nullptr; ReceiverIdx++)
+	{
+		TSharedPtr<FInternetAddr> ReceiveAddress;
+		FSocket* ReceiveSocket = CreateLoopbackSocket(Benchmark.SocketSubsystem, &ReceiveAddress);
+		if (ReceiveSocket == nullptr)
+		{
+			break;
+		}
+
+		Benchmark.ReceiveSockets.Add(ReceiveSocket);
+		Benchmark.ReceiveAddresses.Add(ReceiveAddress.ToSharedRef());
+	}
+
+	if (Benchmark.SendSocket == nullptr || Benchmark.ReceiveSockets.Num() != NumReceivers)
+	{
+		UE_LOG(LogConsoleResponse, Display, TEXT("Sockets.SendMultiBenchmark: failed to create loopback sockets"));
+		return;
+	}
+
+	Benchmark.PacketData.SetNumUninitialized(Benchmark.PacketSize);
+	for (int32 ByteIdx = 0; ByteIdx < Benchmark.PacketSize; ByteIdx++)
+	{
+		Benchmark.PacketData[ByteIdx] = (uint8)ByteIdx;
+	}
+
+	Benchmark.ReceiveBuffer.SetNumUninitialized(Benchmark.PacketSize);
+
+	UE_LOG(LogSockets, Display, TEXT("Sockets.SendMultiBenchmark: %d packets of %d bytes, %d per batch, to %d receivers in runs of %d"),
+		Benchmark.NumPackets, Benchmark.PacketSize, Benchmark.BatchSize, NumReceivers, Benchmark.PacketsPerRun);
+
+	const FResult SendToResult = RunSendTo(Benchmark);
+	LogResult(TEXT("SendTo"), SendToResult);
+
+	if (!Benchmark.SocketSubsystem->IsSocketSendMultiSupported())
+	{
+		UE_LOG(LogSockets, Display, TEXT("  SendMulti isn't supported by the current socket subsystem."));
+		return;
+	}
+
+	TUniquePtr<FSendMulti> SendMulti = Benchmark.SocketSubsystem->CreateSendMulti(Benchmark.BatchSize, Benchmark.PacketSize);
+	const FResult SendMultiResult = RunSendMulti(Benchmark, *SendMulti);
+	LogResult(TEXT("SendMulti"), SendMultiResult, &SendToResult);
+
+	TUniquePtr<FSendMulti> SegmentedSendMulti = Benchmark.SocketSubsystem->CreateSendMulti(Benchmark.BatchSize, Benchmark.PacketSize, ESendMultiFlags::SegmentationOffload);
+	const FResult SegmentedResult = RunSendMulti(Benchmark, *SegmentedSendMulti);
+	LogResult(TEXT("SendMulti GSO"), SegmentedResult, &SendToResult);
+}));
+
+#endif // !UE_BUILD_SHIPPING
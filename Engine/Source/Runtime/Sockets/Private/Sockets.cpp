@@ -25,6 +25,46 @@ void FRecvMulti::CountBytes(FArchive& Ar) const
 	Ar.CountBytes(MaxNumPackets * sizeof(FRecvData), MaxNumPackets * sizeof(FRecvData));
 }
 
+
+/**
+ * FSendMulti
+ */
+
+FSendMulti::FSendMulti(ISocketSubsystem* SocketSubsystem, int32 InMaxNumPackets, int32 InMaxPacketSize, ESendMultiFlags InInitFlags)
+	: DataBuffer(MakeUnique<uint8[]>(InMaxNumPackets * InMaxPacketSize))
+	, PacketSizes(MakeUnique<int32[]>(InMaxNumPackets))
+	, NumPackets(0)
+	, MaxNumPackets(InMaxNumPackets)
+	, MaxPacketSize(InMaxPacketSize)
+	, InitFlags(InInitFlags)
+{
+}
+
+bool FSendMulti::AddPacket(const uint8* Data, int32 Count, const FInternetAddr& Destination)
+{
+	if (IsFull() || Count < 0 || Count > MaxPacketSize || !SetPacketDestination(NumPackets, Destination))
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(&DataBuffer[MaxPacketSize * NumPackets], Data, Count);
+	PacketSizes[NumPackets] = Count;
+	NumPackets++;
+
+	return true;
+}
+
+void FSendMulti::CountBytes(FArchive& Ar) const
+{
+	Ar.CountBytes(sizeof(*this), sizeof(*this));
+
+	// DataBuffer
+	Ar.CountBytes(MaxNumPackets * MaxPacketSize, MaxNumPackets * MaxPacketSize);
+
+	// PacketSizes
+	Ar.CountBytes(MaxNumPackets * sizeof(int32), MaxNumPackets * sizeof(int32));
+}
+
 //
 // FSocket stats implementation
 //
@@ -69,6 +109,13 @@ bool FSocket::RecvMulti(FRecvMulti& MultiData, ESocketReceiveFlags::Type Flags/*
 	return false;
 }
 
+bool FSocket::SendMulti(FSendMulti& MultiData, int32& OutNumPacketsSent)
+{
+	OutNumPacketsSent = 0;
+
+	return false;
+}
+
 bool FSocket::SetRetrieveTimestamp(bool bRetrieveTimestamp/*=true*/)
 {
 	return false;
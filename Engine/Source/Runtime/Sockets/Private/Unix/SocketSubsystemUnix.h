@@ -56,5 +56,7 @@ public:
 	virtual class FSocketBSD* InternalBSDSocketFactory( SOCKET Socket, ESocketType SocketType, const FString& SocketDescription, const FName& SocketProtocol) override;
 	virtual TUniquePtr<FRecvMulti> CreateRecvMulti(int32 MaxNumPackets, int32 MaxPacketSize, ERecvMultiFlags Flags) override;
 	virtual bool IsSocketRecvMultiSupported() const override;
+	virtual TUniquePtr<FSendMulti> CreateSendMulti(int32 MaxNumPackets, int32 MaxPacketSize, ESendMultiFlags Flags) override;
+	virtual bool IsSocketSendMultiSupported() const override;
 	virtual double TranslatePacketTimestamp(const FPacketTimestamp& Timestamp, ETimestampTranslation Translation) override;
 };
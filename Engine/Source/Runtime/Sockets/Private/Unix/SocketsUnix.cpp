@@ -4,6 +4,19 @@
 #include "SocketsUnix.h"
 #include "BSDSockets/IPAddressBSD.h"
 
+#if PLATFORM_HAS_BSD_SOCKET_FEATURE_SENDMMSG
+#include <netinet/udp.h>
+
+// Older system headers don't define UDP GSO, which is supported from kernel 4.18
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#endif
+
 
 // @todo: Add timestamp support for normal Recv/RecvFrom (not essential, there is no API for this yet)
 
@@ -115,6 +128,157 @@ void FUnixRecvMulti::CountBytes(FArchive& Ar) const
 #endif
 
 
+#if PLATFORM_HAS_BSD_SOCKET_FEATURE_SENDMMSG
+constexpr const int32 SegmentControlMsgSize		= CMSG_SPACE(sizeof(uint16));
+
+/** The most packets the kernel accepts in one segmented send (UDP_MAX_SEGMENTS) */
+constexpr const int32 MaxSegmentsPerMessage		= 64;
+
+/** The most data that fits in one UDP datagram, which a segmented send is before it's split */
+constexpr const int32 MaxSegmentedMessageSize	= 65507;
+
+
+/**
+ * FUnixSendMulti
+ */
+
+FUnixSendMulti::FUnixSendMulti(ISocketSubsystem* SocketSubsystem, int32 InMaxNumPackets, int32 InMaxPacketSize,
+								ESendMultiFlags InInitFlags)
+	: FSendMulti(SocketSubsystem, InMaxNumPackets, InMaxPacketSize, InInitFlags)
+	, Headers(MakeUnique<mmsghdr[]>(MaxNumPackets))
+	, bSegmentationOffload(EnumHasAnyFlags(InInitFlags, ESendMultiFlags::SegmentationOffload))
+	, BufferMaps(MakeUnique<iovec[]>(MaxNumPackets))
+	, Destinations(MakeUnique<sockaddr_storage[]>(MaxNumPackets))
+	, DestinationSizes(MakeUnique<SOCKLEN[]>(MaxNumPackets))
+{
+	RawSegmentData = (bSegmentationOffload ? MakeUnique<uint8[]>(SegmentControlMsgSize * MaxNumPackets) : nullptr);
+
+	for (int32 i=0; i<MaxNumPackets; i++)
+	{
+		BufferMaps[i].iov_base = &DataBuffer[MaxPacketSize*i];
+		BufferMaps[i].iov_len = 0;
+	}
+}
+
+bool FUnixSendMulti::SetPacketDestination(int32 PacketIdx, const FInternetAddr& Destination)
+{
+	const FInternetAddrBSD& BSDAddr = static_cast<const FInternetAddrBSD&>(Destination);
+	const SOCKLEN StorageSize = BSDAddr.GetStorageSize();
+
+	FMemory::Memcpy(&Destinations[PacketIdx], BSDAddr.GetRawAddr(), StorageSize);
+	DestinationSizes[PacketIdx] = StorageSize;
+
+	return true;
+}
+
+int32 FUnixSendMulti::PrepareHeaders(int32 FirstPacketIdx)
+{
+	int32 NumMessages = 0;
+	int32 PacketIdx = FirstPacketIdx;
+
+	for (int32 i=FirstPacketIdx; i<NumPackets; i++)
+	{
+		BufferMaps[i].iov_len = PacketSizes[i];
+	}
+
+	while (PacketIdx < NumPackets)
+	{
+		const int32 SegmentSize = PacketSizes[PacketIdx];
+		int32 NumSegments = 1;
+
+		// Segments all have the same size except the last one, which can be smaller
+		if (bSegmentationOffload && SegmentSize > 0)
+		{
+			const SOCKLEN DestinationSize = DestinationSizes[PacketIdx];
+			int32 MessageSize = SegmentSize;
+
+			for (int32 NextIdx=PacketIdx+1; NextIdx<NumPackets && NumSegments<MaxSegmentsPerMessage; NextIdx++)
+			{
+				const int32 NextSize = PacketSizes[NextIdx];
+
+				if (NextSize == 0 || NextSize > SegmentSize || MessageSize + NextSize > MaxSegmentedMessageSize ||
+					DestinationSizes[NextIdx] != DestinationSize ||
+					FMemory::Memcmp(&Destinations[NextIdx], &Destinations[PacketIdx], DestinationSize) != 0)
+				{
+					break;
+				}
+
+				MessageSize += NextSize;
+				NumSegments++;
+
+				if (NextSize < SegmentSize)
+				{
+					break;
+				}
+			}
+		}
+
+		mmsghdr& CurHeader = Headers[NumMessages];
+		msghdr& CurInnerHeader = CurHeader.msg_hdr;
+
+		CurHeader.msg_len = 0;
+		CurInnerHeader.msg_name = &Destinations[PacketIdx];
+		CurInnerHeader.msg_namelen = DestinationSizes[PacketIdx];
+		CurInnerHeader.msg_iov = &BufferMaps[PacketIdx];
+		CurInnerHeader.msg_iovlen = NumSegments;
+		CurInnerHeader.msg_flags = 0;
+
+		if (NumSegments > 1)
+		{
+			CurInnerHeader.msg_control = &RawSegmentData[NumMessages * SegmentControlMsgSize];
+			CurInnerHeader.msg_controllen = SegmentControlMsgSize;
+
+			cmsghdr* SegmentMsg = CMSG_FIRSTHDR(&CurInnerHeader);
+
+			SegmentMsg->cmsg_level = SOL_UDP;
+			SegmentMsg->cmsg_type = UDP_SEGMENT;
+			SegmentMsg->cmsg_len = CMSG_LEN(sizeof(uint16));
+			*(uint16*)CMSG_DATA(SegmentMsg) = (uint16)SegmentSize;
+		}
+		else
+		{
+			CurInnerHeader.msg_control = nullptr;
+			CurInnerHeader.msg_controllen = 0;
+		}
+
+		NumMessages++;
+		PacketIdx += NumSegments;
+	}
+
+	return NumMessages;
+}
+
+void FUnixSendMulti::CountBytes(FArchive& Ar) const
+{
+	FSendMulti::CountBytes(Ar);
+
+	int32 CurSize = sizeof(*this) - sizeof(FSendMulti);
+
+	Ar.CountBytes(CurSize, CurSize);
+
+	// Headers
+	CurSize = sizeof(mmsghdr) * MaxNumPackets;
+
+	Ar.CountBytes(CurSize, CurSize);
+
+	// RawSegmentData
+	CurSize = (RawSegmentData.IsValid() ? (SegmentControlMsgSize * MaxNumPackets) : 0);
+
+	Ar.CountBytes(CurSize, CurSize);
+
+	// BufferMaps
+	CurSize = sizeof(iovec) * MaxNumPackets;
+
+	Ar.CountBytes(CurSize, CurSize);
+
+	// Destinations and DestinationSizes
+	CurSize = (sizeof(sockaddr_storage) + sizeof(SOCKLEN)) * MaxNumPackets;
+
+	Ar.CountBytes(CurSize, CurSize);
+}
+#endif
+
+
 /**
  * FSocketUnix
  */
@@ -142,6 +306,77 @@ bool FSocketUnix::RecvMulti(FRecvMulti& MultiData, ESocketReceiveFlags::Type Fla
 	return bSuccess;
 }
 
+// NOTE: Does not support TCP at the moment.
+bool FSocketUnix::SendMulti(FSendMulti& MultiData, int32& OutNumPacketsSent)
+{
+	bool bSuccess = false;
+
+	OutNumPacketsSent = 0;
+
+#if PLATFORM_HAS_BSD_SOCKET_FEATURE_SENDMMSG
+	FUnixSendMulti& UnixMultiData = (FUnixSendMulti&)MultiData;
+	mmsghdr* Headers = UnixMultiData.Headers.Get();
+	int32 NumMessages = UnixMultiData.PrepareHeaders(0);
+	int32 MessageIdx = 0;
+	int32 PacketIdx = 0;
+
+	while (MessageIdx < NumMessages)
+	{
+		const int NumMessagesSent = sendmmsg(Socket, &Headers[MessageIdx], NumMessages - MessageIdx, 0);
+
+		if (NumMessagesSent > 0)
+		{
+			for (const int32 LastMessageIdx = MessageIdx + NumMessagesSent; MessageIdx < LastMessageIdx; MessageIdx++)
+			{
+				PacketIdx += Headers[MessageIdx].msg_hdr.msg_iovlen;
+				OutNumPacketsSent += Headers[MessageIdx].msg_hdr.msg_iovlen;
+			}
+
+			continue;
+		}
+
+		const int32 ErrorCode = errno;
+
+		if (ErrorCode == EINTR)
+		{
+			continue;
+		}
+		else if (ErrorCode == EAGAIN || ErrorCode == EWOULDBLOCK)
+		{
+			// The send buffer is full, the remaining packets are dropped like with SendTo
+			break;
+		}
+		else if (Headers[MessageIdx].msg_hdr.msg_iovlen > 1 &&
+				(ErrorCode == EINVAL || ErrorCode == EIO || ErrorCode == ENOPROTOOPT || ErrorCode == EOPNOTSUPP))
+		{
+			// The kernel or network device doesn't support segmentation offload, send every packet separately from now on
+			UE_LOG(LogSockets, Log, TEXT("Socket '%s' SendMulti segmentation offload is unsupported (errno %d), disabling it."), *SocketDescription, ErrorCode);
+
+			UnixMultiData.bSegmentationOffload = false;
+			NumMessages = UnixMultiData.PrepareHeaders(PacketIdx);
+			MessageIdx = 0;
+		}
+		else
+		{
+			// Skip the message that failed (e.g. an unreachable destination) and send the rest
+			PacketIdx += Headers[MessageIdx].msg_hdr.msg_iovlen;
+			MessageIdx++;
+		}
+	}
+
+	bSuccess = OutNumPacketsSent == UnixMultiData.NumPackets;
+
+	if (OutNumPacketsSent > 0)
+	{
+		LastActivityTime = FPlatformTime::Seconds();
+	}
+
+	UnixMultiData.Reset();
+#endif
+
+	return bSuccess;
+}
+
 bool FSocketUnix::SetRetrieveTimestamp(bool bRetrieveTimestamp)
 {
 	bool bSuccess = false;
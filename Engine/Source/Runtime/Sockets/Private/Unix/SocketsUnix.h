@@ -38,9 +38,57 @@ public:
 };
 #endif
 
+#if PLATFORM_HAS_BSD_SOCKET_FEATURE_SENDMMSG
+/**
+ * Implements platform specific data/buffers for SendMulti in Linux
+ */
+struct FUnixSendMulti : public FSendMulti
+{
+	friend class FSocketUnix;
+
+protected:
+	/** The mmsghdr struct values passed to sendmmsg, one per message - rebuilt for each send, from the queued packets */
+	TUniquePtr<mmsghdr[]>	Headers;
+
+	/** Buffer for the UDP_SEGMENT control message of each message, when using segmentation offload */
+	TUniquePtr<uint8[]>		RawSegmentData;
+
+	/** Whether or not runs of same size packets to the same address are sent as one message. Cleared if the kernel rejects it. */
+	bool					bSegmentationOffload;
+
+
+private:
+	/** Maps the queued packets within DataBuffer, one per packet */
+	TUniquePtr<iovec[]>		BufferMaps;
+
+	/** The destination address of each queued packet */
+	TUniquePtr<sockaddr_storage[]>	Destinations;
+
+	/** The size of each address in Destinations */
+	TUniquePtr<SOCKLEN[]>	DestinationSizes;
+
+
+public:
+	FUnixSendMulti(ISocketSubsystem* SocketSubsystem, int32 InMaxNumPackets, int32 InMaxPacketSize, ESendMultiFlags InInitFlags);
+
+	virtual void CountBytes(FArchive& Ar) const override;
+
+protected:
+	virtual bool SetPacketDestination(int32 PacketIdx, const FInternetAddr& Destination) override;
+
+	/**
+	 * Fills Headers with the messages for sending the queued packets from FirstPacketIdx onwards
+	 *
+	 * @param FirstPacketIdx	The first queued packet to send
+	 * @return					The number of messages in Headers
+	 */
+	int32 PrepareHeaders(int32 FirstPacketIdx);
+};
+#endif
+
 
 /**
- * Unix specific socket implementation - primarily, adds support for recvmmsg
+ * Unix specific socket implementation - primarily, adds support for recvmmsg and sendmmsg
  */
 class FSocketUnix : public FSocketBSD
 {
@@ -55,5 +103,6 @@ public:
 	}
 
 	virtual bool RecvMulti(FRecvMulti& MultiData, ESocketReceiveFlags::Type Flags) override;
+	virtual bool SendMulti(FSendMulti& MultiData, int32& OutNumPacketsSent) override;
 	virtual bool SetRetrieveTimestamp(bool bRetrieveTimestamp) override;
 };
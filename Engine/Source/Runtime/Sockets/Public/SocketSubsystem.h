@@ -302,6 +302,17 @@ public:
 	virtual TUniquePtr<FRecvMulti> CreateRecvMulti(int32 MaxNumPackets, int32 MaxPacketSize,
 													ERecvMultiFlags Flags=ERecvMultiFlags::None);
 
+	/**
+	 * Create a platform specific FSendMulti representation
+	 *
+	 * @param MaxNumPackets			The maximum number of packets queued at once
+	 * @param MaxPacketSize			The maximum supported packet size
+	 * @param Flags					Flags for specifying how FSendMulti should send packets (for e.g. segmentation offload)
+	 * @return						Returns the platform specific FSendMulti instance
+	 */
+	virtual TUniquePtr<FSendMulti> CreateSendMulti(int32 MaxNumPackets, int32 MaxPacketSize,
+													ESendMultiFlags Flags=ESendMultiFlags::None);
+
 	/**
 	 * @return Whether the machine has a properly configured network device or not
 	 */
@@ -409,6 +420,11 @@ public:
 	 */
 	virtual bool IsSocketRecvMultiSupported() const;
 
+	/**
+	 * Returns true if FSocket::SendMulti is supported by this socket subsystem
+	 */
+	virtual bool IsSocketSendMultiSupported() const;
+
 
 	/**
 	 * Returns true if FSocket::Wait is supported by this socket subsystem.
@@ -368,3 +368,124 @@ public:
 	 */
 	virtual void CountBytes(FArchive& Ar) const;
 };
+
+
+/**
+ * Flags for specifying how an FSendMulti instance should be initialized
+ */
+enum class ESendMultiFlags : uint32
+{
+	None				= 0x00000000,
+	SegmentationOffload	= 0x00000001	// Whether or not to send runs of same size packets to the same address, as one segmented send (UDP GSO)
+};
+
+ENUM_CLASS_FLAGS(ESendMultiFlags);
+
+
+/**
+ * Stores the persistent state and packet buffers/data, for queueing packets and sending them all at once with FSocket::SendMulti.
+ * To optimize performance, use only one instance of this struct, for the lifetime of the socket.
+ */
+struct SOCKETS_API FSendMulti : public FNoncopyable, public FVirtualDestructor
+{
+	friend struct FUnixSendMulti;
+	friend class FSocketUnix;
+
+private:
+	/** The raw data buffer where all queued packet data is stored, MaxPacketSize apart */
+	TUniquePtr<uint8[]>				DataBuffer;
+
+	/** The size of each queued packet */
+	TUniquePtr<int32[]>				PacketSizes;
+
+	/** The number of queued packets */
+	int32							NumPackets;
+
+public:
+	/** The maximum number of packets this FSendMulti instance can queue */
+	const int32						MaxNumPackets;
+
+	/** The maximum packet size this FSendMulti instance can queue */
+	const int32						MaxPacketSize;
+
+	/** The flags this FSendMulti instance was initialized with */
+	const ESendMultiFlags			InitFlags;
+
+
+protected:
+	/**
+	 * Initialize an FSendMulti instance, supporting the specified maximum packet count/sizes
+	 *
+	 * @param SocketSubsystem		The socket subsystem initializing this FSendMulti instance
+	 * @param InMaxNumPackets		The maximum number of packets queued at once
+	 * @param InMaxPacketSize		The maximum supported packet size
+	 * @param InInitFlags			Flags for specifying how the packets are sent (for e.g. segmentation offload)
+	 */
+	FSendMulti(ISocketSubsystem* SocketSubsystem, int32 InMaxNumPackets, int32 InMaxPacketSize,
+				ESendMultiFlags InInitFlags=ESendMultiFlags::None);
+
+	/**
+	 * Stores the platform specific destination of a packet being queued
+	 *
+	 * @param PacketIdx		The index of the packet being queued
+	 * @param Destination	The address the packet is sent to
+	 * @return				Whether or not the destination is supported
+	 */
+	virtual bool SetPacketDestination(int32 PacketIdx, const FInternetAddr& Destination) = 0;
+
+
+public:
+	/**
+	 * Copies a packet to the end of the queue, to be sent by the next FSocket::SendMulti call
+	 *
+	 * @param Data			The packet data
+	 * @param Count			The size of the packet, at most MaxPacketSize
+	 * @param Destination	The network byte ordered address to send to
+	 * @return				Whether or not the packet was queued - fails when the queue is full, or the packet too big
+	 */
+	bool AddPacket(const uint8* Data, int32 Count, const FInternetAddr& Destination);
+
+	/**
+	 * Retrieves the data for the specified queued packet
+	 *
+	 * @param PacketIdx		The index of the queued packet
+	 */
+	TArrayView<const uint8> GetPacketData(int32 PacketIdx) const
+	{
+		check(PacketIdx >= 0);
+		check(PacketIdx < NumPackets);
+
+		return MakeArrayView(&DataBuffer[MaxPacketSize * PacketIdx], PacketSizes[PacketIdx]);
+	}
+
+	/**
+	 * Retrieves the current number of queued packets
+	 */
+	int32 GetNumPackets() const
+	{
+		return NumPackets;
+	}
+
+	/**
+	 * Whether or not no more packets can be queued, before they are sent
+	 */
+	bool IsFull() const
+	{
+		return NumPackets >= MaxNumPackets;
+	}
+
+	/**
+	 * Discards all queued packets. FSocket::SendMulti does this after sending them.
+	 */
+	void Reset()
+	{
+		NumPackets = 0;
+	}
+
+	/**
+	 * Calculates the total memory consumption of this FSendMulti instance, including platform-specific data
+	 *
+	 * @param Ar	The archive being used to count the memory consumption
+	 */
+	virtual void CountBytes(FArchive& Ar) const;
+};
@@ -185,6 +185,17 @@ public:
 	 */
 	virtual bool Send(const uint8* Data, int32 Count, int32& BytesSent);
 
+	/**
+	 * Sends every packet queued in MultiData at once, each to its own network byte ordered address, then empties the queue.
+	 * Use ISocketSubsystem::IsSocketSendMultiSupported to check if the current socket platform supports this.
+	 * NOTE: For optimal performance, one FSendMulti instance should be used, for the lifetime of the socket.
+	 *
+	 * @param MultiData				The FSendMulti instance holding the queued packets and platform specific buffers for sending them.
+	 * @param OutNumPacketsSent		Will indicate how many of the queued packets were sent.
+	 * @return						Whether or not every queued packet was sent
+	 */
+	virtual bool SendMulti(FSendMulti& MultiData, int32& OutNumPacketsSent);
+
 	/**
 	 * Reads a chunk of data from the socket and gathers the source address.
 	 *